@@ -49,6 +49,17 @@
 #define CH_CFG_SMP_MODE                     TRUE
 #endif
 
+/**
+ * @brief   Threads migration between instances.
+ * @details If enabled then threads can be migrated between OS instances
+ *          using @p chThdMigrate() and a periodic load balancer can be
+ *          started using @p chSchBalancerStart().
+ * @note    Requires @p CH_CFG_SMP_MODE.
+ */
+#if !defined(CH_CFG_USE_MIGRATION)
+#define CH_CFG_USE_MIGRATION                FALSE
+#endif
+
 /** @} */
 
 /*===========================================================================*/
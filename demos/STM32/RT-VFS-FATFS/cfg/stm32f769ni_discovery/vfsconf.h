@@ -132,6 +132,14 @@
 #define DRV_CFG_STREAMS_FILE_NODES_NUM      2
 #endif
 
+/**
+ * @brief   Number of pipe nodes pre-allocated in the pool.
+ * @note    Pipe nodes are disabled if zero.
+ */
+#if !defined(DRV_CFG_STREAMS_PIPE_NODES_NUM) || defined(__DOXYGEN__)
+#define DRV_CFG_STREAMS_PIPE_NODES_NUM      0
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -0,0 +1,213 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "ch_test.h"
+#include "coroutines.h"
+
+#include "co_test_root.h"
+
+/*
+ * Number of concurrent activities.
+ */
+#define BENCH_ACTIVITIES        8
+
+/*
+ * Duration of each benchmark, the simulator realtime counter has a
+ * resolution of one microsecond.
+ */
+#define BENCH_DURATION          ((rtcnt_t)1000000)
+
+/*
+ * Stack size of the threads implementing an activity.
+ */
+#define BENCH_STACK_SIZE        256
+
+static THD_WORKING_AREA(wa_activities[BENCH_ACTIVITIES], BENCH_STACK_SIZE);
+static co_task_t bench_tasks[BENCH_ACTIVITIES];
+static co_executor_t bench_executor;
+static co_mailbox_t mb;
+static msg_t mb_buffer[4];
+static rtcnt_t start, end;
+static uint32_t n;
+
+static bool bench_running(void) {
+
+  return chSysIsCounterWithinX(chSysGetRealtimeCounterX(), start, end);
+}
+
+static void bench_start(void) {
+
+  n = 0U;
+  start = chSysGetRealtimeCounterX();
+  end = start + BENCH_DURATION;
+}
+
+/*
+ * Activity implemented as a thread, it yields continuously.
+ */
+static THD_FUNCTION(yield_thread, arg) {
+
+  (void)arg;
+
+  while (bench_running()) {
+    n++;
+    chThdYield();
+  }
+}
+
+/*
+ * Activity implemented as a coroutine, it yields continuously.
+ */
+static co_status_t yield_task(co_task_t *ctp) {
+
+  CO_BEGIN(ctp);
+  while (bench_running()) {
+    n++;
+    CO_YIELD(ctp);
+  }
+  CO_END(ctp);
+}
+
+/*
+ * Mailbox producer coroutine.
+ */
+static co_status_t producer_task(co_task_t *ctp) {
+
+  CO_BEGIN(ctp);
+  while (bench_running()) {
+    CO_MB_POST(ctp, &mb, (msg_t)1);
+  }
+  CO_MB_POST(ctp, &mb, (msg_t)0);
+  CO_END(ctp);
+}
+
+/*
+ * Mailbox consumer coroutine, the fetched message is stored in the
+ * task argument.
+ */
+static co_status_t consumer_task(co_task_t *ctp) {
+
+  CO_BEGIN(ctp);
+  while (true) {
+    CO_MB_FETCH(ctp, &mb, (msg_t *)ctp->arg);
+    if (*(msg_t *)ctp->arg == (msg_t)0) {
+      CO_EXIT(ctp);
+    }
+    n++;
+  }
+  CO_END(ctp);
+}
+
+/*
+ * Threads yielding round robin.
+ */
+static uint32_t bench_threads(void) {
+  thread_t *tps[BENCH_ACTIVITIES];
+  unsigned i;
+
+  bench_start();
+  for (i = 0U; i < BENCH_ACTIVITIES; i++) {
+    tps[i] = chThdCreateStatic(wa_activities[i], sizeof (wa_activities[i]),
+                               NORMALPRIO - 1, yield_thread, NULL);
+  }
+  for (i = 0U; i < BENCH_ACTIVITIES; i++) {
+    (void) chThdWait(tps[i]);
+  }
+
+  return n;
+}
+
+/*
+ * Coroutines yielding round robin on the main thread.
+ */
+static uint32_t bench_coroutines(void) {
+  unsigned i;
+
+  coExecutorObjectInit(&bench_executor);
+  bench_start();
+  for (i = 0U; i < BENCH_ACTIVITIES; i++) {
+    coTaskStart(&bench_executor, &bench_tasks[i], yield_task, NULL);
+  }
+  coExecutorRun(&bench_executor);
+
+  return n;
+}
+
+/*
+ * Coroutines exchanging messages through a mailbox.
+ */
+static uint32_t bench_mailbox(void) {
+  msg_t msg;
+
+  coMBObjectInit(&mb, mb_buffer, sizeof (mb_buffer) / sizeof (msg_t));
+  coExecutorObjectInit(&bench_executor);
+  bench_start();
+  coTaskStart(&bench_executor, &bench_tasks[0], producer_task, NULL);
+  coTaskStart(&bench_executor, &bench_tasks[1], consumer_task, &msg);
+  coExecutorRun(&bench_executor);
+
+  return n;
+}
+
+/*------------------------------------------------------------------------*
+ * Simulator main.                                                        *
+ *------------------------------------------------------------------------*/
+int main(void) {
+  uint32_t nthd, nco;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  /*
+   * Coroutines test suite, the output goes to the console.
+   */
+  if (test_execute_putchar(putchar, &co_test_suite)) {
+    return 1;
+  }
+
+  printf("*** ChibiOS/RT coroutines benchmarks\n");
+  printf("*** Kernel:     %s\n", CH_KERNEL_VERSION);
+  printf("*** Activities: %u\n\n", (unsigned)BENCH_ACTIVITIES);
+
+  printf("--- Memory per activity, thread:    %u bytes\n",
+         (unsigned)sizeof (wa_activities[0]));
+  printf("--- Memory per activity, coroutine: %u bytes\n",
+         (unsigned)sizeof (co_task_t));
+
+  nthd = bench_threads();
+  nco  = bench_coroutines();
+  printf("--- Switches, threads:              %u switches/S\n",
+         (unsigned)nthd);
+  printf("--- Switches, coroutines:           %u switches/S\n",
+         (unsigned)nco);
+
+  printf("--- Mailbox, coroutines:            %u msgs/S\n",
+         (unsigned)bench_mailbox());
+  fflush(stdout);
+
+  return 0;
+}
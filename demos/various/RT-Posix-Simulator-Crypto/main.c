@@ -0,0 +1,314 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "ch_test.h"
+
+#include "hal_crypto_queue.h"
+
+#include "cry_test_root.h"
+
+/*
+ * Duration of each measurement, the simulator realtime counter has a
+ * resolution of one microsecond.
+ */
+#define BENCH_DURATION          ((rtcnt_t)1000000)
+
+/*
+ * Size of the buffer processed by each operation.
+ */
+#define BENCH_BUFFER_SIZE       4096
+
+/*
+ * Number of threads submitting requests to the crypto queue.
+ */
+#define QUEUE_CLIENTS           4
+
+/*
+ * Data processed by the crypto queue before switching request.
+ */
+#define QUEUE_CHUNK_SIZE        1024
+
+/*
+ * Type of a benchmarked operation.
+ */
+typedef cryerror_t (*bench_op_t)(void);
+
+static uint8_t bench_in[BENCH_BUFFER_SIZE];
+static uint8_t bench_out[BENCH_BUFFER_SIZE];
+static uint8_t bench_tag[16];
+
+static uint8_t bench_cbc[BENCH_BUFFER_SIZE];
+static uint8_t bench_sha[32];
+
+static CRYQueueDriver cryq;
+static const CRYQueueConfig cryqcfg = {&CRYD1, QUEUE_CHUNK_SIZE};
+static THD_WORKING_AREA(wa_dispatcher, 4096);
+static THD_WORKING_AREA(wa_clients[QUEUE_CLIENTS], 4096);
+static uint8_t queue_out[QUEUE_CLIENTS][BENCH_BUFFER_SIZE];
+static uint32_t queue_ops[QUEUE_CLIENTS];
+static uint32_t queue_errors[QUEUE_CLIENTS];
+
+static const uint8_t bench_key[32] = {
+  0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+  0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F,
+  0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+  0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F
+};
+
+static const uint8_t bench_iv[16] = {
+  0xCA, 0xFE, 0xBA, 0xBE, 0xFA, 0xCE, 0xDB, 0xAD,
+  0xDE, 0xCA, 0xF8, 0x88, 0x00, 0x00, 0x00, 0x01
+};
+
+static cryerror_t op_aes_ecb(void) {
+
+  return cryEncryptAES_ECB(&CRYD1, 0, BENCH_BUFFER_SIZE, bench_in, bench_out);
+}
+
+static cryerror_t op_aes_cbc(void) {
+
+  return cryEncryptAES_CBC(&CRYD1, 0, BENCH_BUFFER_SIZE, bench_in, bench_out,
+                           bench_iv);
+}
+
+static cryerror_t op_aes_ctr(void) {
+
+  return cryEncryptAES_CTR(&CRYD1, 0, BENCH_BUFFER_SIZE, bench_in, bench_out,
+                           bench_iv);
+}
+
+static cryerror_t op_aes_gcm(void) {
+
+  return cryEncryptAES_GCM(&CRYD1, 0, 16U, bench_key, BENCH_BUFFER_SIZE,
+                           bench_in, bench_out, bench_iv, 16U, bench_tag);
+}
+
+static cryerror_t op_tdes_cbc(void) {
+
+  return cryEncryptDES_CBC(&CRYD1, 0, BENCH_BUFFER_SIZE, bench_in, bench_out,
+                           bench_iv);
+}
+
+static cryerror_t op_sha1(void) {
+  SHA1Context ctx;
+
+  (void) crySHA1Init(&CRYD1, &ctx);
+  (void) crySHA1Update(&CRYD1, &ctx, BENCH_BUFFER_SIZE, bench_in);
+  return crySHA1Final(&CRYD1, &ctx, bench_out);
+}
+
+static cryerror_t op_sha256(void) {
+  SHA256Context ctx;
+
+  (void) crySHA256Init(&CRYD1, &ctx);
+  (void) crySHA256Update(&CRYD1, &ctx, BENCH_BUFFER_SIZE, bench_in);
+  return crySHA256Final(&CRYD1, &ctx, bench_out);
+}
+
+static cryerror_t op_sha512(void) {
+  SHA512Context ctx;
+
+  (void) crySHA512Init(&CRYD1, &ctx);
+  (void) crySHA512Update(&CRYD1, &ctx, BENCH_BUFFER_SIZE, bench_in);
+  return crySHA512Final(&CRYD1, &ctx, bench_out);
+}
+
+static cryerror_t op_hmac_sha256(void) {
+  HMACSHA256Context ctx;
+
+  (void) cryHMACSHA256Init(&CRYD1, &ctx);
+  (void) cryHMACSHA256Update(&CRYD1, &ctx, BENCH_BUFFER_SIZE, bench_in);
+  return cryHMACSHA256Final(&CRYD1, &ctx, bench_out);
+}
+
+static cryerror_t op_hmac_sha512(void) {
+  HMACSHA512Context ctx;
+
+  (void) cryHMACSHA512Init(&CRYD1, &ctx);
+  (void) cryHMACSHA512Update(&CRYD1, &ctx, BENCH_BUFFER_SIZE, bench_in);
+  return cryHMACSHA512Final(&CRYD1, &ctx, bench_out);
+}
+
+/*
+ * Repeats an operation for the measurement duration and prints the
+ * throughput.
+ */
+static void bench(const char *name, bench_op_t op) {
+  rtcnt_t start, now;
+  uint32_t n = 0U;
+
+  start = chSysGetRealtimeCounterX();
+  do {
+    if (op() != CRY_NOERROR) {
+      printf("--- %-16s failed\n", name);
+      return;
+    }
+    n++;
+    now = chSysGetRealtimeCounterX();
+  } while ((rtcnt_t)(now - start) < BENCH_DURATION);
+
+  printf("--- %-16s %6u KB/S\n", name,
+         (unsigned)(((uint64_t)n * BENCH_BUFFER_SIZE * 1000000U) /
+                    ((uint64_t)(now - start) * 1024U)));
+}
+
+/*
+ * Crypto queue dispatcher thread.
+ */
+static THD_FUNCTION(dispatcher, arg) {
+
+  (void)arg;
+
+  chRegSetThreadName("cryq");
+  cryqDispatch(&cryq);
+}
+
+/*
+ * Crypto queue client thread, even clients encrypt using AES-128-CBC, odd
+ * clients hash using SHA256. Results are checked against the ones obtained
+ * calling the driver directly.
+ */
+static THD_FUNCTION(client, arg) {
+  unsigned n = (unsigned)(uintptr_t)arg;
+  SHA256Context ctx;
+  cryrequest_t req;
+  rtcnt_t start;
+
+  if ((n & 1U) == 0U) {
+    cryqRequestObjectInit(&req, CRYQ_ENCRYPT_AES_CBC, NULL, NULL);
+    cryqSetKeyX(&req, 0, 16U, bench_key);
+    cryqSetDataX(&req, BENCH_BUFFER_SIZE, bench_in, queue_out[n], bench_iv);
+  }
+  else {
+    cryqRequestObjectInit(&req, CRYQ_SHA256, NULL, NULL);
+    cryqSetDataX(&req, BENCH_BUFFER_SIZE, bench_in, queue_out[n], NULL);
+    cryqSetHashX(&req, &ctx, CRYQ_HASH_ONESHOT);
+  }
+
+  start = chSysGetRealtimeCounterX();
+  do {
+    if ((cryqExecute(&cryq, &req) != CRY_NOERROR) ||
+        (memcmp(queue_out[n], (n & 1U) == 0U ? bench_cbc : bench_sha,
+                (n & 1U) == 0U ? BENCH_BUFFER_SIZE : 32U) != 0)) {
+      queue_errors[n]++;
+    }
+    queue_ops[n]++;
+  } while ((rtcnt_t)(chSysGetRealtimeCounterX() - start) < BENCH_DURATION);
+}
+
+/*------------------------------------------------------------------------*
+ * Simulator main.                                                        *
+ *------------------------------------------------------------------------*/
+int main(void) {
+  thread_t *tpd, *tpc[QUEUE_CLIENTS];
+  uint32_t nops, nerrors;
+  rtcnt_t start, elapsed;
+  unsigned i;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  /*
+   * Crypto test suite, the output goes to the console.
+   */
+  (void) test_execute_putchar(putchar, &cry_test_suite);
+
+  /*
+   * Throughput of each algorithm.
+   */
+  for (i = 0U; i < BENCH_BUFFER_SIZE; i++) {
+    bench_in[i] = (uint8_t)i;
+  }
+
+  (void) cryStart(&CRYD1, NULL);
+  (void) cryLoadAESTransientKey(&CRYD1, 16U, bench_key);
+  (void) cryLoadDESTransientKey(&CRYD1, 24U, bench_key);
+  (void) cryLoadHMACTransientKey(&CRYD1, 32U, bench_key);
+
+  printf("\n*** ChibiOS/HAL crypto throughput\n");
+  printf("*** Kernel:      %s\n", CH_KERNEL_VERSION);
+#if HAL_CRY_ENFORCE_FALLBACK == TRUE
+  printf("*** Engine:      software fall-back\n");
+#else
+  printf("*** Engine:      low level driver\n");
+#endif
+  printf("*** Buffer size: %u bytes\n", (unsigned)BENCH_BUFFER_SIZE);
+  printf("*** Queue:       %u clients, %u bytes chunks\n\n",
+         (unsigned)QUEUE_CLIENTS, (unsigned)QUEUE_CHUNK_SIZE);
+
+  bench("AES-128-ECB", op_aes_ecb);
+  bench("AES-128-CBC", op_aes_cbc);
+  bench("AES-128-CTR", op_aes_ctr);
+  bench("AES-128-GCM", op_aes_gcm);
+  bench("TDES-CBC", op_tdes_cbc);
+  bench("SHA1", op_sha1);
+  bench("SHA256", op_sha256);
+  bench("SHA512", op_sha512);
+  bench("HMAC-SHA256", op_hmac_sha256);
+  bench("HMAC-SHA512", op_hmac_sha512);
+
+  /*
+   * Same driver shared by multiple threads through the requests queue.
+   */
+  (void) cryEncryptAES_CBC(&CRYD1, 0, BENCH_BUFFER_SIZE, bench_in, bench_cbc,
+                           bench_iv);
+  (void) op_sha256();
+  memcpy(bench_sha, bench_out, sizeof (bench_sha));
+
+  cryqObjectInit(&cryq);
+  cryqStart(&cryq, &cryqcfg);
+  tpd = chThdCreateStatic(wa_dispatcher, sizeof (wa_dispatcher),
+                          NORMALPRIO + 1, dispatcher, NULL);
+
+  start = chSysGetRealtimeCounterX();
+  for (i = 0U; i < QUEUE_CLIENTS; i++) {
+    tpc[i] = chThdCreateStatic(wa_clients[i], sizeof (wa_clients[i]),
+                               NORMALPRIO, client, (void *)(uintptr_t)i);
+  }
+  nops = 0U;
+  nerrors = 0U;
+  for (i = 0U; i < QUEUE_CLIENTS; i++) {
+    (void) chThdWait(tpc[i]);
+    nops += queue_ops[i];
+    nerrors += queue_errors[i];
+  }
+  elapsed = chSysGetRealtimeCounterX() - start;
+
+  cryqStop(&cryq);
+  (void) chThdWait(tpd);
+
+  printf("--- %-16s %6u KB/S, %u batches, %u errors\n", "Queue",
+         (unsigned)(((uint64_t)nops * BENCH_BUFFER_SIZE * 1000000U) /
+                    ((uint64_t)elapsed * 1024U)),
+         (unsigned)cryq.batches, (unsigned)nerrors);
+
+  cryStop(&CRYD1);
+  fflush(stdout);
+
+  return 0;
+}
@@ -0,0 +1,306 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "chprintf.h"
+#include "memstreams.h"
+#include "nullstreams.h"
+#include "dlog.h"
+
+/*
+ * Number of log calls of each benchmark.
+ */
+#define BENCH_CALLS             200000
+
+/*
+ * Number of log calls between flushes, the records must fit the ring.
+ */
+#define BENCH_BATCH             (DLOG_RING_SIZE / (DLOG_HEADER_WORDS + 6))
+
+/*
+ * Number of records verified against chsnprintf().
+ */
+#define CHECK_RECORDS           1000
+
+/*
+ * Length of the timestamp prefix of text records.
+ */
+#define PREFIX_SIZE             11
+
+/*
+ * A typical log line, about 60 characters.
+ */
+#define LINE_FORMAT             "%8U [%-6s] x=%6d y=%6d st=%08X %s\r\n"
+#define LINE_ARGS(i)                                                        \
+  (unsigned long)(i), "sensor", (int)((i) * 7U) - 1000,                     \
+  -(int)((i) & 0xFFFU), (unsigned)((i) * 2654435761U),                      \
+  (((i) & 1U) != 0U) ? "ok" : "retry"
+
+static uint8_t line[128];
+static char ref[128];
+static memory_stream_c ms;
+static null_stream_c ns;
+
+/*===========================================================================*/
+/* File stream, a sequential_stream_i sink writing to a C library file.      */
+/*===========================================================================*/
+
+typedef struct {
+  sequential_stream_i   stm;
+  FILE                  *f;
+} file_stream_t;
+
+static size_t fs_write(void *ip, const uint8_t *bp, size_t n) {
+
+  return fwrite(bp, 1U, n, ((file_stream_t *)ip)->f);
+}
+
+static size_t fs_read(void *ip, uint8_t *bp, size_t n) {
+
+  (void)ip;
+  (void)bp;
+  (void)n;
+
+  return 0;
+}
+
+static int fs_put(void *ip, uint8_t b) {
+
+  return fputc(b, ((file_stream_t *)ip)->f) == EOF ? STM_RESET : STM_OK;
+}
+
+static int fs_get(void *ip) {
+
+  (void)ip;
+
+  return STM_RESET;
+}
+
+static int fs_unget(void *ip, int b) {
+
+  (void)ip;
+  (void)b;
+
+  return STM_RESET;
+}
+
+static const struct sequential_stream_vmt fs_vmt = {
+  (size_t)0, fs_write, fs_read, fs_put, fs_get, fs_unget
+};
+
+static file_stream_t fs = {{&fs_vmt}, NULL};
+
+/*===========================================================================*/
+/* Checks.                                                                   */
+/*===========================================================================*/
+
+/*
+ * Records formatted by the drain side into a memory stream, the text is
+ * compared with the chsnprintf() output.
+ */
+static bool check_format(void) {
+  static const dlog_config_t cfg = {&ms.stm, DLOG_MODE_TEXT, LOWPRIO};
+  uint32_t i;
+
+  memstmObjectInit(&ms, line, sizeof (line) - 1U, 0U);
+  dlogStart(&cfg);
+  for (i = 0U; i < CHECK_RECORDS; i++) {
+    uint32_t n = i * 4099U;
+
+    dlogPrintf(LINE_FORMAT, LINE_ARGS(n));
+    memstmObjectInit(&ms, line, sizeof (line) - 1U, 0U);
+    if (dlogFlush() != 1U) {
+      return false;
+    }
+    line[ms.eos] = '\0';
+    (void) chsnprintf(ref, sizeof (ref), LINE_FORMAT, LINE_ARGS(n));
+    if ((ms.eos <= PREFIX_SIZE) ||
+        (strcmp((char *)line + PREFIX_SIZE, ref) != 0)) {
+      return false;
+    }
+  }
+  dlogStop();
+
+  return true;
+}
+
+/*
+ * Records exceeding the ring size are dropped and reported.
+ */
+static bool check_drops(void) {
+  static const dlog_config_t cfg = {&ns.stm, DLOG_MODE_TEXT, LOWPRIO};
+  cnt_t drops = dlogGetDropsX();
+  unsigned records;
+  uint32_t i;
+
+  for (i = 0U; i < CHECK_RECORDS; i++) {
+    dlogPrintf(LINE_FORMAT, LINE_ARGS(i));
+  }
+  dlogStart(&cfg);
+  records = dlogFlush();
+  dlogStop();
+  drops = dlogGetDropsX() - drops;
+  printf("--- Drops:      %u records kept, %u dropped\n",
+         records, (unsigned)drops);
+
+  return (records == (unsigned)BENCH_BATCH) &&
+         ((unsigned)drops == (unsigned)(CHECK_RECORDS - BENCH_BATCH));
+}
+
+/*===========================================================================*/
+/* Benchmark.                                                                */
+/*===========================================================================*/
+
+static void report(const char *name, rtcnt_t elapsed) {
+
+  printf("--- %-18s %5u nS/call\n", name,
+         (unsigned)(((uint64_t)elapsed * 1000U) / (uint64_t)BENCH_CALLS));
+}
+
+/*
+ * Log line formatted at the call site into a null stream.
+ */
+static void bench_chprintf(void) {
+  rtcnt_t start;
+  uint32_t i;
+
+  start = chSysGetRealtimeCounterX();
+  for (i = 0U; i < BENCH_CALLS; i++) {
+    (void) chprintf(&ns.stm, LINE_FORMAT, LINE_ARGS(i));
+  }
+  report("chprintf()", chSysGetRealtimeCounterX() - start);
+}
+
+/*
+ * Deferred log calls, the rings are drained into a null stream after each
+ * batch, the drain time is measured separately.
+ */
+static void bench_dlog(void) {
+  static const dlog_config_t cfg = {&ns.stm, DLOG_MODE_TEXT, LOWPRIO};
+  rtcnt_t start, logging = 0, draining = 0;
+  uint32_t i, j;
+
+  dlogStart(&cfg);
+  for (i = 0U; i < BENCH_CALLS; i += BENCH_BATCH) {
+    start = chSysGetRealtimeCounterX();
+    for (j = i; (j < i + BENCH_BATCH) && (j < BENCH_CALLS); j++) {
+      dlogPrintf(LINE_FORMAT, LINE_ARGS(j));
+    }
+    logging += chSysGetRealtimeCounterX() - start;
+    start = chSysGetRealtimeCounterX();
+    (void) dlogFlush();
+    draining += chSysGetRealtimeCounterX() - start;
+  }
+  dlogStop();
+  report("dlogPrintf()", logging);
+  report("drain thread", draining);
+}
+
+/*===========================================================================*/
+/* Output examples.                                                          */
+/*===========================================================================*/
+
+static void log_examples(void) {
+  uint32_t i;
+
+  for (i = 0U; i < 4U; i++) {
+    dlogPrintf(LINE_FORMAT, LINE_ARGS(i));
+  }
+  dlogPrintf("%s: %c%c %5D %-4x|\r\n", "misc", 'o', 'k', -123456L, 0xABU);
+}
+
+/*
+ * Records exported in binary form to a file, to be decoded on the host.
+ */
+static bool export_binary(void) {
+  static const dlog_config_t cfg = {&fs.stm, DLOG_MODE_BINARY, LOWPRIO};
+
+  fs.f = fopen("dlog.bin", "wb");
+  if (fs.f == NULL) {
+    return false;
+  }
+  dlogStart(&cfg);
+  log_examples();
+  dlogStop();
+  fclose(fs.f);
+
+  return true;
+}
+
+/*
+ * Records formatted by the drain thread on the console.
+ */
+static void print_text(void) {
+  static const dlog_config_t cfg = {&fs.stm, DLOG_MODE_TEXT, LOWPRIO};
+
+  fs.f = stdout;
+  dlogStart(&cfg);
+  log_examples();
+  chThdSleepMilliseconds(50);
+  dlogStop();
+}
+
+/*------------------------------------------------------------------------*
+ * Simulator main.                                                        *
+ *------------------------------------------------------------------------*/
+int main(void) {
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  nullstmObjectInit(&ns);
+
+  printf("*** ChibiOS/RT deferred logging benchmark\n");
+  printf("*** Kernel:     %s\n", CH_KERNEL_VERSION);
+  printf("*** Rings:      %u cores, %u words\n\n",
+         (unsigned)DLOG_CORES, (unsigned)DLOG_RING_SIZE);
+
+  if (!check_format()) {
+    printf("*** Format check failed\n");
+    return 1;
+  }
+  printf("--- Format check passed\n");
+  if (!check_drops()) {
+    printf("*** Drops check failed\n");
+    return 1;
+  }
+
+  bench_chprintf();
+  bench_dlog();
+
+  if (!export_binary()) {
+    printf("*** Export failed\n");
+    return 1;
+  }
+  printf("--- Binary records written to dlog.bin\n\n");
+  fflush(stdout);
+  print_text();
+  fflush(stdout);
+
+  return 0;
+}
@@ -0,0 +1,436 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "ff.h"
+
+/*
+ * RAM disk size in sectors.
+ */
+#define RAMDISK_SECTORS         8192
+
+/*
+ * Time spent by the RAM disk on each operation, a command phase followed
+ * by the transfer. The calling thread sleeps, like while waiting for a
+ * DMA transfer to complete.
+ */
+#define RAMDISK_OP_LATENCY      TIME_MS2I(1)
+#define RAMDISK_SECTORS_PER_MS  8
+
+/*
+ * Benchmark file size and size of each read or write call.
+ */
+#define BENCH_FILE_SIZE         (512 * 1024)
+#define BENCH_CHUNK_SIZE        512
+
+/*
+ * Processing time of each chunk in microseconds, busy waiting.
+ */
+#define BENCH_PROCESSING_TIME   200
+
+/*
+ * Number of chunks rewritten at random positions by the consistency test.
+ */
+#define CHECK_REWRITES          200
+
+static uint8_t ramdisk_data[RAMDISK_SECTORS][FF_MAX_SS];
+static uint32_t ramdisk_reads;
+static uint32_t ramdisk_writes;
+
+static FATFS fs;
+static FIL file;
+static BYTE work[FF_MAX_SS];
+static uint8_t buffer[BENCH_CHUNK_SIZE];
+static uint32_t seed = 1U;
+
+/*===========================================================================*/
+/* RAM disk, a BaseBlockDevice stand-in for the SDC and MMC drivers.         */
+/*===========================================================================*/
+
+static void ramdisk_wait(uint32_t n) {
+
+  chThdSleep(RAMDISK_OP_LATENCY + TIME_MS2I(n / RAMDISK_SECTORS_PER_MS));
+}
+
+static bool ramdisk_is_inserted(void *instance) {
+
+  (void)instance;
+
+  return true;
+}
+
+static bool ramdisk_is_protected(void *instance) {
+
+  (void)instance;
+
+  return false;
+}
+
+static bool ramdisk_connect(void *instance) {
+
+  (void)instance;
+
+  return HAL_SUCCESS;
+}
+
+static bool ramdisk_disconnect(void *instance) {
+
+  (void)instance;
+
+  return HAL_SUCCESS;
+}
+
+static bool ramdisk_read(void *instance, uint32_t startblk,
+                         uint8_t *buffer, uint32_t n) {
+
+  (void)instance;
+
+  if ((startblk >= RAMDISK_SECTORS) || (n > RAMDISK_SECTORS - startblk)) {
+    return HAL_FAILED;
+  }
+  ramdisk_wait(n);
+  memcpy(buffer, ramdisk_data[startblk], (size_t)n * FF_MAX_SS);
+  ramdisk_reads++;
+
+  return HAL_SUCCESS;
+}
+
+static bool ramdisk_write(void *instance, uint32_t startblk,
+                          const uint8_t *buffer, uint32_t n) {
+
+  (void)instance;
+
+  if ((startblk >= RAMDISK_SECTORS) || (n > RAMDISK_SECTORS - startblk)) {
+    return HAL_FAILED;
+  }
+  ramdisk_wait(n);
+  memcpy(ramdisk_data[startblk], buffer, (size_t)n * FF_MAX_SS);
+  ramdisk_writes++;
+
+  return HAL_SUCCESS;
+}
+
+static bool ramdisk_sync(void *instance) {
+
+  (void)instance;
+
+  return HAL_SUCCESS;
+}
+
+static bool ramdisk_get_info(void *instance, BlockDeviceInfo *bdip) {
+
+  (void)instance;
+
+  bdip->blk_size = FF_MAX_SS;
+  bdip->blk_num  = RAMDISK_SECTORS;
+
+  return HAL_SUCCESS;
+}
+
+static const struct BaseBlockDeviceVMT ramdisk_vmt = {
+  (size_t)0,
+  ramdisk_is_inserted,
+  ramdisk_is_protected,
+  ramdisk_connect,
+  ramdisk_disconnect,
+  ramdisk_read,
+  ramdisk_write,
+  ramdisk_sync,
+  ramdisk_get_info
+};
+
+/*
+ * Block device used by the FatFS bindings, see ffconf.h.
+ */
+BaseBlockDevice RAMD1 = {&ramdisk_vmt, BLK_READY};
+
+/*===========================================================================*/
+/* Benchmark.                                                                */
+/*===========================================================================*/
+
+/*
+ * Content of the file, a function of the position.
+ */
+static uint8_t pattern(uint32_t pos, uint32_t gen) {
+
+  return (uint8_t)((pos >> 9) ^ pos ^ (gen * 0x5BU));
+}
+
+static void fill(uint32_t pos, uint32_t gen) {
+  unsigned i;
+
+  for (i = 0U; i < BENCH_CHUNK_SIZE; i++) {
+    buffer[i] = pattern(pos + i, gen);
+  }
+}
+
+static bool check(uint32_t pos, uint32_t gen) {
+  unsigned i;
+
+  for (i = 0U; i < BENCH_CHUNK_SIZE; i++) {
+    if (buffer[i] != pattern(pos + i, gen)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/*
+ * Data processing emulation, the CPU is busy.
+ */
+static void process(void) {
+  rtcnt_t start = chSysGetRealtimeCounterX();
+
+  while ((rtcnt_t)(chSysGetRealtimeCounterX() - start) <
+         (rtcnt_t)BENCH_PROCESSING_TIME) {
+  }
+}
+
+static uint32_t rnd(void) {
+
+  seed = seed * 1103515245U + 12345U;
+
+  return seed >> 16;
+}
+
+static void report(const char *name, rtcnt_t start) {
+  rtcnt_t elapsed = chSysGetRealtimeCounterX() - start;
+
+  printf("--- %-8s %5u KB/S, %u reads, %u writes\n", name,
+         (unsigned)(((uint64_t)BENCH_FILE_SIZE * 1000000U) /
+                    ((uint64_t)elapsed * 1024U)),
+         (unsigned)ramdisk_reads, (unsigned)ramdisk_writes);
+  ramdisk_reads = 0U;
+  ramdisk_writes = 0U;
+}
+
+/*
+ * Sequential write of the whole file.
+ */
+static bool bench_write(void) {
+  rtcnt_t start;
+  uint32_t pos;
+  UINT n;
+
+  start = chSysGetRealtimeCounterX();
+  if (f_open(&file, "/bench.bin", FA_CREATE_ALWAYS | FA_WRITE) != FR_OK) {
+    return false;
+  }
+  for (pos = 0U; pos < BENCH_FILE_SIZE; pos += BENCH_CHUNK_SIZE) {
+    fill(pos, 0U);
+    process();
+    if ((f_write(&file, buffer, BENCH_CHUNK_SIZE, &n) != FR_OK) ||
+        (n != BENCH_CHUNK_SIZE)) {
+      return false;
+    }
+  }
+  if (f_close(&file) != FR_OK) {
+    return false;
+  }
+  report("Write", start);
+
+  return true;
+}
+
+/*
+ * Sequential read of the whole file, the content is verified.
+ */
+static bool bench_read(void) {
+  rtcnt_t start;
+  uint32_t pos;
+  UINT n;
+
+  start = chSysGetRealtimeCounterX();
+  if (f_open(&file, "/bench.bin", FA_READ) != FR_OK) {
+    return false;
+  }
+  for (pos = 0U; pos < BENCH_FILE_SIZE; pos += BENCH_CHUNK_SIZE) {
+    if ((f_read(&file, buffer, BENCH_CHUNK_SIZE, &n) != FR_OK) ||
+        (n != BENCH_CHUNK_SIZE) || !check(pos, 0U)) {
+      return false;
+    }
+    process();
+  }
+  if (f_close(&file) != FR_OK) {
+    return false;
+  }
+  report("Read", start);
+
+  return true;
+}
+
+/*
+ * Chunks rewritten at random positions interleaved with reads, then the
+ * whole file is verified.
+ */
+static bool check_rewrites(void) {
+  static uint8_t gens[BENCH_FILE_SIZE / BENCH_CHUNK_SIZE];
+  uint32_t pos;
+  unsigned i;
+  UINT n;
+
+  if (f_open(&file, "/bench.bin", FA_READ | FA_WRITE) != FR_OK) {
+    return false;
+  }
+  for (i = 0U; i < CHECK_REWRITES; i++) {
+    uint32_t chunk = rnd() % (BENCH_FILE_SIZE / BENCH_CHUNK_SIZE);
+
+    pos = chunk * BENCH_CHUNK_SIZE;
+    if (f_lseek(&file, pos) != FR_OK) {
+      return false;
+    }
+    if ((rnd() & 1U) != 0U) {
+      gens[chunk] = (uint8_t)(i + 1U);
+      fill(pos, gens[chunk]);
+      if ((f_write(&file, buffer, BENCH_CHUNK_SIZE, &n) != FR_OK) ||
+          (n != BENCH_CHUNK_SIZE)) {
+        return false;
+      }
+    }
+    else {
+      if ((f_read(&file, buffer, BENCH_CHUNK_SIZE, &n) != FR_OK) ||
+          (n != BENCH_CHUNK_SIZE) || !check(pos, gens[chunk])) {
+        return false;
+      }
+    }
+  }
+  if ((f_sync(&file) != FR_OK) || (f_lseek(&file, 0U) != FR_OK)) {
+    return false;
+  }
+  for (pos = 0U; pos < BENCH_FILE_SIZE; pos += BENCH_CHUNK_SIZE) {
+    if ((f_read(&file, buffer, BENCH_CHUNK_SIZE, &n) != FR_OK) ||
+        (n != BENCH_CHUNK_SIZE) ||
+        !check(pos, gens[pos / BENCH_CHUNK_SIZE])) {
+      return false;
+    }
+  }
+
+  return f_close(&file) == FR_OK;
+}
+
+/*
+ * A chunk is written and the volume unmounted without closing the file,
+ * like a medium removed while in use. The file content is then replaced
+ * on the RAM disk, like a medium written by another host, and the whole
+ * file is verified after mounting the volume again. The write left behind
+ * must not reach the new medium.
+ */
+static bool check_remount(void) {
+  LBA_t sector;
+  uint32_t pos;
+  unsigned i;
+  UINT n;
+
+  if (f_open(&file, "/bench.bin", FA_READ | FA_WRITE) != FR_OK) {
+    return false;
+  }
+  fill(0U, 0x55U);
+  if ((f_write(&file, buffer, BENCH_CHUNK_SIZE, &n) != FR_OK) ||
+      (n != BENCH_CHUNK_SIZE)) {
+    return false;
+  }
+
+  /* The file is contiguous, it was written on an empty volume.*/
+  sector = fs.database + (LBA_t)(file.obj.sclust - 2U) * fs.csize;
+  if (f_unmount("") != FR_OK) {
+    return false;
+  }
+  for (pos = 0U; pos < BENCH_FILE_SIZE; pos += FF_MAX_SS) {
+    for (i = 0U; i < FF_MAX_SS; i++) {
+      ramdisk_data[sector + pos / FF_MAX_SS][i] = pattern(pos + i, 0xFFU);
+    }
+  }
+
+  if ((f_mount(&fs, "", 1) != FR_OK) ||
+      (f_open(&file, "/bench.bin", FA_READ) != FR_OK)) {
+    return false;
+  }
+  for (pos = 0U; pos < BENCH_FILE_SIZE; pos += BENCH_CHUNK_SIZE) {
+    if ((f_read(&file, buffer, BENCH_CHUNK_SIZE, &n) != FR_OK) ||
+        (n != BENCH_CHUNK_SIZE) || !check(pos, 0xFFU)) {
+      return false;
+    }
+  }
+
+  return f_close(&file) == FR_OK;
+}
+
+/*------------------------------------------------------------------------*
+ * Simulator main.                                                        *
+ *------------------------------------------------------------------------*/
+int main(void) {
+  static const MKFS_PARM opt = {FM_FAT | FM_SFD, 0, 0, 0, 0};
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  printf("*** ChibiOS/RT FatFS benchmark\n");
+  printf("*** Kernel:     %s\n", CH_KERNEL_VERSION);
+  printf("*** RAM disk:   %u sectors, %u mS per operation, %u sectors/mS\n",
+         (unsigned)RAMDISK_SECTORS, (unsigned)TIME_I2MS(RAMDISK_OP_LATENCY),
+         (unsigned)RAMDISK_SECTORS_PER_MS);
+  printf("*** File:       %u bytes in %u bytes chunks, %u uS processing\n",
+         (unsigned)BENCH_FILE_SIZE, (unsigned)BENCH_CHUNK_SIZE,
+         (unsigned)BENCH_PROCESSING_TIME);
+#if FATFS_USE_ASYNC_IO == TRUE
+  printf("*** Bindings:   asynchronous I/O\n\n");
+#else
+  printf("*** Bindings:   synchronous I/O\n\n");
+#endif
+
+  if ((f_mkfs("", &opt, work, sizeof (work)) != FR_OK) ||
+      (f_mount(&fs, "", 1) != FR_OK)) {
+    printf("*** Format failed\n");
+    return 1;
+  }
+  ramdisk_reads = 0U;
+  ramdisk_writes = 0U;
+
+  if (!bench_write()) {
+    printf("*** Write failed\n");
+    return 1;
+  }
+  if (!bench_read()) {
+    printf("*** Read failed\n");
+    return 1;
+  }
+  if (!check_rewrites()) {
+    printf("*** Consistency check failed\n");
+    return 1;
+  }
+  printf("--- Consistency check passed\n");
+  if (!check_remount()) {
+    printf("*** Remount check failed\n");
+    return 1;
+  }
+  printf("--- Remount check passed\n");
+  fflush(stdout);
+
+  return 0;
+}
@@ -0,0 +1,547 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "lfs.h"
+#include "lfs_hal.h"
+
+/*
+ * Geometry of the RAM flash, uniform sectors.
+ */
+#define RAMFLASH_SECTOR_SIZE    4096
+#define RAMFLASH_SECTORS        256
+
+/*
+ * Emulated overhead of each read or program operation in microseconds, it
+ * models the command and address phases of a serial NOR device, zero
+ * disables it.
+ */
+#define RAMFLASH_OP_LATENCY     2
+
+/*
+ * LittleFS geometry and buffers sizes, small buffers like on a typical
+ * serial NOR setup.
+ */
+#define LFS_IO_SIZE             16
+#define LFS_CACHE_SIZE          16
+
+/*
+ * Size of the bindings read buffer.
+ */
+#define CACHE_READ_SIZE         256
+
+/*
+ * One sector every RAMFLASH_BAD_STRIDE is bad during the bad blocks test,
+ * programs into a bad sector leave the data unchanged.
+ */
+#define RAMFLASH_BAD_STRIDE     8
+
+/*
+ * Size of the benchmark file and of each write or read.
+ */
+#define BENCH_FILE_SIZE         (256 * 1024)
+#define BENCH_CHUNK_SIZE        512
+
+/*
+ * Number of mounts averaged by the mount benchmark.
+ */
+#define BENCH_MOUNTS            20
+
+/*
+ * Duration of the CRC measurement, the simulator realtime counter has a
+ * resolution of one microsecond.
+ */
+#define BENCH_DURATION          ((rtcnt_t)1000000)
+
+/*===========================================================================*/
+/* RAM flash device.                                                         */
+/*===========================================================================*/
+
+/*
+ * Flash device in RAM, programming can only clear bits like in a NOR
+ * device. Operations are counted.
+ */
+typedef struct {
+  const struct BaseFlashVMT *vmt;
+  _base_flash_data
+  bool                      bad_sectors;
+  uint32_t                  reads;
+  uint32_t                  programs;
+  uint32_t                  erases;
+  uint32_t                  corrupted;
+} RAMFlash;
+
+static uint8_t ramflash_memory[RAMFLASH_SECTOR_SIZE * RAMFLASH_SECTORS];
+
+static const flash_descriptor_t ramflash_descriptor = {
+  .attributes       = FLASH_ATTR_ERASED_IS_ONE |
+                      FLASH_ATTR_REWRITABLE,
+  .page_size        = 256U,
+  .sectors_count    = RAMFLASH_SECTORS,
+  .sectors          = NULL,
+  .sectors_size     = RAMFLASH_SECTOR_SIZE,
+  .address          = NULL,
+  .size             = sizeof (ramflash_memory)
+};
+
+static void ramflash_latency(void) {
+#if RAMFLASH_OP_LATENCY > 0
+  rtcnt_t start = chSysGetRealtimeCounterX();
+
+  while ((rtcnt_t)(chSysGetRealtimeCounterX() - start) <
+         (rtcnt_t)RAMFLASH_OP_LATENCY) {
+  }
+#endif
+}
+
+static const flash_descriptor_t *ramflash_get_descriptor(void *instance) {
+
+  (void)instance;
+
+  return &ramflash_descriptor;
+}
+
+static flash_error_t ramflash_read(void *instance, flash_offset_t offset,
+                                   size_t n, uint8_t *rp) {
+  RAMFlash *rfp = (RAMFlash *)instance;
+
+  osalDbgCheck(offset + n <= sizeof (ramflash_memory));
+
+  ramflash_latency();
+  memcpy(rp, &ramflash_memory[offset], n);
+  rfp->reads++;
+
+  return FLASH_NO_ERROR;
+}
+
+static flash_error_t ramflash_program(void *instance, flash_offset_t offset,
+                                      size_t n, const uint8_t *pp) {
+  RAMFlash *rfp = (RAMFlash *)instance;
+  size_t i;
+
+  osalDbgCheck(offset + n <= sizeof (ramflash_memory));
+
+  ramflash_latency();
+  rfp->programs++;
+  if (rfp->bad_sectors &&
+      ((offset / RAMFLASH_SECTOR_SIZE) % RAMFLASH_BAD_STRIDE ==
+       RAMFLASH_BAD_STRIDE - 1U)) {
+    /* The program operation silently fails.*/
+    rfp->corrupted++;
+    return FLASH_NO_ERROR;
+  }
+  for (i = 0U; i < n; i++) {
+    ramflash_memory[offset + i] &= pp[i];
+  }
+
+  return FLASH_NO_ERROR;
+}
+
+static flash_error_t ramflash_start_erase_all(void *instance) {
+
+  (void)instance;
+
+  memset(ramflash_memory, 0xFF, sizeof (ramflash_memory));
+
+  return FLASH_NO_ERROR;
+}
+
+static flash_error_t ramflash_start_erase_sector(void *instance,
+                                                 flash_sector_t sector) {
+  RAMFlash *rfp = (RAMFlash *)instance;
+
+  osalDbgCheck(sector < RAMFLASH_SECTORS);
+
+  memset(&ramflash_memory[sector * RAMFLASH_SECTOR_SIZE], 0xFF,
+         RAMFLASH_SECTOR_SIZE);
+  rfp->erases++;
+
+  return FLASH_NO_ERROR;
+}
+
+static flash_error_t ramflash_query_erase(void *instance, uint32_t *msec) {
+
+  (void)instance;
+
+  if (msec != NULL) {
+    *msec = 0U;
+  }
+
+  return FLASH_NO_ERROR;
+}
+
+static flash_error_t ramflash_verify_erase(void *instance,
+                                           flash_sector_t sector) {
+  size_t i;
+
+  (void)instance;
+
+  for (i = 0U; i < RAMFLASH_SECTOR_SIZE; i++) {
+    if (ramflash_memory[sector * RAMFLASH_SECTOR_SIZE + i] != 0xFFU) {
+      return FLASH_ERROR_VERIFY;
+    }
+  }
+
+  return FLASH_NO_ERROR;
+}
+
+static flash_error_t ramflash_exclusive(void *instance) {
+
+  (void)instance;
+
+  return FLASH_NO_ERROR;
+}
+
+static const struct BaseFlashVMT ramflash_vmt = {
+  .instance_offset      = 0U,
+  .get_descriptor       = ramflash_get_descriptor,
+  .read                 = ramflash_read,
+  .program              = ramflash_program,
+  .start_erase_all      = ramflash_start_erase_all,
+  .start_erase_sector   = ramflash_start_erase_sector,
+  .query_erase          = ramflash_query_erase,
+  .verify_erase         = ramflash_verify_erase,
+  .acquire_exclusive    = ramflash_exclusive,
+  .release_exclusive    = ramflash_exclusive
+};
+
+static RAMFlash ramflash = {
+  .vmt                  = &ramflash_vmt,
+  .state                = FLASH_READY
+};
+
+/*===========================================================================*/
+/* LittleFS configurations.                                                  */
+/*===========================================================================*/
+
+static uint8_t lfs_read_buffer[LFS_CACHE_SIZE];
+static uint8_t lfs_prog_buffer[LFS_CACHE_SIZE];
+static uint8_t lfs_lookahead_buffer[16];
+static uint8_t lfs_file_buffer[LFS_CACHE_SIZE];
+
+static lfs_hal_cache_t cache;
+static uint8_t cache_read_buffer[CACHE_READ_SIZE];
+
+/*
+ * Block device operations going straight to the flash driver.
+ */
+static const struct lfs_config lfscfg_direct = {
+  .context              = &ramflash,
+  .read                 = __lfs_read,
+  .prog                 = __lfs_prog,
+  .erase                = __lfs_erase,
+  .sync                 = __lfs_sync,
+  .lock                 = __lfs_lock,
+  .unlock               = __lfs_unlock,
+  .read_size            = LFS_IO_SIZE,
+  .prog_size            = LFS_IO_SIZE,
+  .block_size           = RAMFLASH_SECTOR_SIZE,
+  .block_count          = RAMFLASH_SECTORS,
+  .block_cycles         = 500,
+  .cache_size           = LFS_CACHE_SIZE,
+  .lookahead_size       = sizeof (lfs_lookahead_buffer),
+  .read_buffer          = lfs_read_buffer,
+  .prog_buffer          = lfs_prog_buffer,
+  .lookahead_buffer     = lfs_lookahead_buffer
+};
+
+/*
+ * Block device operations through the bindings cache.
+ */
+static const struct lfs_config lfscfg_cached = {
+  .context              = &cache,
+  .read                 = __lfs_cache_read,
+  .prog                 = __lfs_cache_prog,
+  .erase                = __lfs_cache_erase,
+  .sync                 = __lfs_cache_sync,
+  .lock                 = __lfs_cache_lock,
+  .unlock               = __lfs_cache_unlock,
+  .read_size            = LFS_IO_SIZE,
+  .prog_size            = LFS_IO_SIZE,
+  .block_size           = RAMFLASH_SECTOR_SIZE,
+  .block_count          = RAMFLASH_SECTORS,
+  .block_cycles         = 500,
+  .cache_size           = LFS_CACHE_SIZE,
+  .lookahead_size       = sizeof (lfs_lookahead_buffer),
+  .read_buffer          = lfs_read_buffer,
+  .prog_buffer          = lfs_prog_buffer,
+  .lookahead_buffer     = lfs_lookahead_buffer
+};
+
+static const struct lfs_file_config lfsfilecfg = {
+  .buffer               = lfs_file_buffer
+};
+
+static lfs_t lfs;
+static uint8_t bench_buffer[BENCH_CHUNK_SIZE];
+
+/*===========================================================================*/
+/* Benchmarks.                                                               */
+/*===========================================================================*/
+
+/*
+ * Throughput in KB/S.
+ */
+static unsigned kbps(uint32_t n, rtcnt_t elapsed) {
+
+  return (unsigned)(((uint64_t)n * 1000000U) / ((uint64_t)elapsed * 1024U));
+}
+
+/*
+ * Prints the flash operations performed since the last call.
+ */
+static void print_flash_ops(void) {
+
+  printf("    (%u reads, %u programs, %u erases)\n",
+         (unsigned)ramflash.reads, (unsigned)ramflash.programs,
+         (unsigned)ramflash.erases);
+  ramflash.reads    = 0U;
+  ramflash.programs = 0U;
+  ramflash.erases   = 0U;
+}
+
+/*
+ * Mount, write and read throughput using the specified configuration, the
+ * flash is formatted first.
+ */
+static void bench_lfs(const char *name, const struct lfs_config *cfgp) {
+  lfs_file_t file;
+  rtcnt_t start, elapsed;
+  unsigned i;
+  int err;
+
+  printf("\n*** Block device: %s\n", name);
+
+  (void) flashStartEraseAll(&ramflash);
+  err = lfs_format(&lfs, cfgp);
+  if (err < 0) {
+    printf("--- Format failed: %d\n", err);
+    return;
+  }
+
+  /* Mount time.*/
+  ramflash.reads = ramflash.programs = ramflash.erases = 0U;
+  start = chSysGetRealtimeCounterX();
+  for (i = 0U; i < BENCH_MOUNTS; i++) {
+    err = lfs_mount(&lfs, cfgp);
+    if (err < 0) {
+      printf("--- Mount failed: %d\n", err);
+      return;
+    }
+    (void) lfs_unmount(&lfs);
+  }
+  elapsed = chSysGetRealtimeCounterX() - start;
+  printf("--- Mount:  %6u uS\n", (unsigned)(elapsed / BENCH_MOUNTS));
+  print_flash_ops();
+
+  (void) lfs_mount(&lfs, cfgp);
+
+  /* File write.*/
+  start = chSysGetRealtimeCounterX();
+  err = lfs_file_opencfg(&lfs, &file, "bench",
+                         LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC,
+                         &lfsfilecfg);
+  for (i = 0U; (err >= 0) && (i < BENCH_FILE_SIZE / BENCH_CHUNK_SIZE); i++) {
+    memset(bench_buffer, (int)i, sizeof (bench_buffer));
+    if (lfs_file_write(&lfs, &file, bench_buffer,
+                       sizeof (bench_buffer)) != (lfs_ssize_t)sizeof (bench_buffer)) {
+      err = LFS_ERR_IO;
+    }
+  }
+  if (err >= 0) {
+    err = lfs_file_close(&lfs, &file);
+  }
+  elapsed = chSysGetRealtimeCounterX() - start;
+  if (err < 0) {
+    printf("--- Write failed: %d\n", err);
+    (void) lfs_unmount(&lfs);
+    return;
+  }
+  printf("--- Write:  %6u KB/S\n", kbps(BENCH_FILE_SIZE, elapsed));
+  print_flash_ops();
+
+  /* File read, the content is verified.*/
+  start = chSysGetRealtimeCounterX();
+  err = lfs_file_opencfg(&lfs, &file, "bench", LFS_O_RDONLY, &lfsfilecfg);
+  for (i = 0U; (err >= 0) && (i < BENCH_FILE_SIZE / BENCH_CHUNK_SIZE); i++) {
+    if ((lfs_file_read(&lfs, &file, bench_buffer,
+                       sizeof (bench_buffer)) != (lfs_ssize_t)sizeof (bench_buffer)) ||
+        (bench_buffer[0] != (uint8_t)i) ||
+        (bench_buffer[sizeof (bench_buffer) - 1U] != (uint8_t)i)) {
+      err = LFS_ERR_CORRUPT;
+    }
+  }
+  if (err >= 0) {
+    err = lfs_file_close(&lfs, &file);
+  }
+  elapsed = chSysGetRealtimeCounterX() - start;
+  if (err < 0) {
+    printf("--- Read failed: %d\n", err);
+    (void) lfs_unmount(&lfs);
+    return;
+  }
+  printf("--- Read:   %6u KB/S\n", kbps(BENCH_FILE_SIZE, elapsed));
+  print_flash_ops();
+
+  (void) lfs_unmount(&lfs);
+}
+
+/*
+ * Writes a file with some bad sectors in the flash, LittleFS must detect
+ * the failed programs and relocate the data, the file is verified after
+ * a remount.
+ */
+static void test_bad_blocks(const char *name, const struct lfs_config *cfgp) {
+  lfs_file_t file;
+  unsigned i;
+  int err;
+
+  (void) flashStartEraseAll(&ramflash);
+  err = lfs_format(&lfs, cfgp);
+  if (err >= 0) {
+    err = lfs_mount(&lfs, cfgp);
+  }
+  if (err < 0) {
+    printf("--- %-16s format failed: %d\n", name, err);
+    return;
+  }
+
+  ramflash.corrupted   = 0U;
+  ramflash.bad_sectors = true;
+  err = lfs_file_opencfg(&lfs, &file, "bad",
+                         LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC,
+                         &lfsfilecfg);
+  for (i = 0U; (err >= 0) && (i < BENCH_FILE_SIZE / BENCH_CHUNK_SIZE); i++) {
+    memset(bench_buffer, (int)i, sizeof (bench_buffer));
+    if (lfs_file_write(&lfs, &file, bench_buffer,
+                       sizeof (bench_buffer)) != (lfs_ssize_t)sizeof (bench_buffer)) {
+      err = LFS_ERR_IO;
+    }
+  }
+  if (err >= 0) {
+    err = lfs_file_close(&lfs, &file);
+  }
+  (void) lfs_unmount(&lfs);
+  ramflash.bad_sectors = false;
+  if (err < 0) {
+    printf("--- %-16s write failed: %d\n", name, err);
+    return;
+  }
+
+  err = lfs_mount(&lfs, cfgp);
+  if (err >= 0) {
+    err = lfs_file_opencfg(&lfs, &file, "bad", LFS_O_RDONLY, &lfsfilecfg);
+  }
+  for (i = 0U; (err >= 0) && (i < BENCH_FILE_SIZE / BENCH_CHUNK_SIZE); i++) {
+    unsigned j;
+
+    if (lfs_file_read(&lfs, &file, bench_buffer,
+                      sizeof (bench_buffer)) != (lfs_ssize_t)sizeof (bench_buffer)) {
+      err = LFS_ERR_IO;
+      break;
+    }
+    for (j = 0U; j < sizeof (bench_buffer); j++) {
+      if (bench_buffer[j] != (uint8_t)i) {
+        err = LFS_ERR_CORRUPT;
+        break;
+      }
+    }
+  }
+  if (err >= 0) {
+    err = lfs_file_close(&lfs, &file);
+  }
+  (void) lfs_unmount(&lfs);
+  if (err < 0) {
+    printf("--- %-16s verify failed: %d\n", name, err);
+    return;
+  }
+  printf("--- %-16s %u failed programs detected, file verified\n",
+         name, (unsigned)ramflash.corrupted);
+}
+
+/*
+ * CRC throughput on a whole block.
+ */
+static void bench_crc(void) {
+  rtcnt_t start, now;
+  uint32_t n = 0U, crc = 0xFFFFFFFFU;
+
+  start = chSysGetRealtimeCounterX();
+  do {
+    crc = lfs_crc(crc, ramflash_memory, RAMFLASH_SECTOR_SIZE);
+    n++;
+    now = chSysGetRealtimeCounterX();
+  } while ((rtcnt_t)(now - start) < BENCH_DURATION);
+
+  printf("--- CRC:    %6u KB/S (%08x)\n",
+         kbps(n * RAMFLASH_SECTOR_SIZE, now - start), (unsigned)crc);
+}
+
+/*------------------------------------------------------------------------*
+ * Simulator main.                                                        *
+ *------------------------------------------------------------------------*/
+int main(void) {
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  lfsHalCacheObjectInit(&cache, (BaseFlash *)&ramflash,
+                        cache_read_buffer, sizeof (cache_read_buffer));
+
+  printf("*** ChibiOS/RT LittleFS benchmark on RAM flash\n");
+  printf("*** Kernel:     %s\n", CH_KERNEL_VERSION);
+  printf("*** Flash:      %u sectors of %u bytes, %u uS per operation\n",
+         (unsigned)RAMFLASH_SECTORS, (unsigned)RAMFLASH_SECTOR_SIZE,
+         (unsigned)RAMFLASH_OP_LATENCY);
+  printf("*** LittleFS:   %u bytes I/O, %u bytes caches\n",
+         (unsigned)LFS_IO_SIZE, (unsigned)LFS_CACHE_SIZE);
+  printf("*** Bindings:   %u bytes read buffer\n",
+         (unsigned)CACHE_READ_SIZE);
+  printf("*** File:       %u bytes in %u bytes chunks\n",
+         (unsigned)BENCH_FILE_SIZE, (unsigned)BENCH_CHUNK_SIZE);
+#if defined(LFS_HAL_CRC_HOOK)
+  printf("*** CRC:        hook\n");
+#elif LFS_HAL_CRC_USE_SLICING8 == TRUE
+  printf("*** CRC:        slicing-by-8\n");
+#else
+  printf("*** CRC:        nibble table\n");
+#endif
+
+  printf("\n");
+  bench_crc();
+
+  bench_lfs("direct", &lfscfg_direct);
+  bench_lfs("bindings cache", &lfscfg_cached);
+
+  printf("\n*** Bad blocks, one sector every %u\n",
+         (unsigned)RAMFLASH_BAD_STRIDE);
+  test_bad_blocks("direct", &lfscfg_direct);
+  test_bad_blocks("bindings cache", &lfscfg_cached);
+  fflush(stdout);
+
+  return 0;
+}
@@ -0,0 +1,208 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "chprintf.h"
+#include "memstreams.h"
+#include "nullstreams.h"
+
+/*
+ * Number of lines printed by each benchmark.
+ */
+#define BENCH_LINES             200000
+
+/*
+ * A typical log line, about 60 characters, the reference format is used
+ * for the C library.
+ */
+#define LINE_FORMAT             "%8U [%-6s] x=%6d y=%6d st=%08X %s\r\n"
+#define LINE_REF_FORMAT         "%8lu [%-6s] x=%6d y=%6d st=%08X %s\r\n"
+#define LINE_ARGS(i)                                                        \
+  (unsigned long)(i), "sensor", (int)((i) * 7U) - 1000,                     \
+  -(int)((i) & 0xFFFU), (unsigned)((i) * 2654435761U),                      \
+  (((i) & 1U) != 0U) ? "ok" : "retry"
+
+static uint8_t line[128];
+static MemoryStream ms;
+static NullStream ns;
+
+/*===========================================================================*/
+/* Counting stream, it discards data and counts the stream calls.            */
+/*===========================================================================*/
+
+static uint32_t puts_count;
+static uint32_t writes_count;
+
+static size_t cnt_write(void *ip, const uint8_t *bp, size_t n) {
+
+  (void)ip;
+  (void)bp;
+  writes_count++;
+
+  return n;
+}
+
+static size_t cnt_read(void *ip, uint8_t *bp, size_t n) {
+
+  (void)ip;
+  (void)bp;
+  (void)n;
+
+  return 0;
+}
+
+static msg_t cnt_put(void *ip, uint8_t b) {
+
+  (void)ip;
+  (void)b;
+  puts_count++;
+
+  return MSG_OK;
+}
+
+static msg_t cnt_get(void *ip) {
+
+  (void)ip;
+
+  return MSG_RESET;
+}
+
+static const struct BaseSequentialStreamVMT cnt_vmt = {
+  (size_t)0, cnt_write, cnt_read, cnt_put, cnt_get
+};
+
+static BaseSequentialStream cs = {&cnt_vmt};
+
+/*===========================================================================*/
+/* Benchmark.                                                                */
+/*===========================================================================*/
+
+static int print_line(BaseSequentialStream *chp, uint32_t i) {
+
+  return chprintf(chp, LINE_FORMAT, LINE_ARGS(i));
+}
+
+static void report(const char *name, rtcnt_t start) {
+  rtcnt_t elapsed = chSysGetRealtimeCounterX() - start;
+
+  printf("--- %-14s %8u lines/S\n", name,
+         (unsigned)(((uint64_t)BENCH_LINES * 1000000U) / (uint64_t)elapsed));
+}
+
+/*
+ * Lines printed into a memory stream, the stream is rewound after each
+ * line like when formatting records.
+ */
+static bool bench_memory(void) {
+  rtcnt_t start;
+  uint32_t i;
+
+  start = chSysGetRealtimeCounterX();
+  for (i = 0U; i < BENCH_LINES; i++) {
+    msObjectInit(&ms, line, sizeof (line), 0U);
+    if (print_line((BaseSequentialStream *)&ms, i) != (int)ms.eos) {
+      return false;
+    }
+  }
+  report("MemoryStream", start);
+
+  return true;
+}
+
+/*
+ * Lines printed into a null stream, only the formatter cost is measured.
+ */
+static bool bench_null(void) {
+  rtcnt_t start;
+  uint32_t i;
+
+  start = chSysGetRealtimeCounterX();
+  for (i = 0U; i < BENCH_LINES; i++) {
+    (void) print_line((BaseSequentialStream *)&ns, i);
+  }
+  report("NullStream", start);
+
+  return true;
+}
+
+/*
+ * Lines printed by chsnprintf(), the result is compared with the output
+ * of the C library.
+ */
+static bool bench_snprintf(void) {
+  static char ref[128];
+  rtcnt_t start;
+  uint32_t i;
+
+  start = chSysGetRealtimeCounterX();
+  for (i = 0U; i < BENCH_LINES; i++) {
+    (void) chsnprintf((char *)line, sizeof (line), LINE_FORMAT, LINE_ARGS(i));
+  }
+  report("chsnprintf", start);
+
+  for (i = 0U; i < 1000U; i++) {
+    uint32_t n = i * 4099U;
+
+    (void) chsnprintf((char *)line, sizeof (line), LINE_FORMAT, LINE_ARGS(n));
+    (void) snprintf(ref, sizeof (ref), LINE_REF_FORMAT, LINE_ARGS(n));
+    if (strcmp((char *)line, ref) != 0) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/*------------------------------------------------------------------------*
+ * Simulator main.                                                        *
+ *------------------------------------------------------------------------*/
+int main(void) {
+  int n;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  nullObjectInit(&ns);
+
+  printf("*** ChibiOS/RT chprintf() benchmark\n");
+  printf("*** Kernel:     %s\n", CH_KERNEL_VERSION);
+  printf("*** Buffer:     %u bytes\n", (unsigned)CHPRINTF_BUFFER_SIZE);
+
+  /* Stream calls for a single line.*/
+  n = print_line(&cs, 0U);
+  printf("*** Line:       %d bytes, %u put, %u write calls\n\n",
+         n, (unsigned)puts_count, (unsigned)writes_count);
+
+  if (!bench_memory() || !bench_null() || !bench_snprintf()) {
+    printf("*** Benchmark failed\n");
+    return 1;
+  }
+  fflush(stdout);
+
+  return 0;
+}
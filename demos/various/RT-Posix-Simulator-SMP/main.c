@@ -0,0 +1,222 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "ch_test.h"
+#include "rt_test_root.h"
+
+/*
+ * Duration of each benchmark, the simulator realtime counter has a
+ * resolution of one microsecond.
+ */
+#define BENCH_DURATION          ((rtcnt_t)1000000)
+
+#define BENCH_WA_SIZE           THD_WORKING_AREA_SIZE(1024)
+
+static THD_WORKING_AREA(wa_bench1, 1024);
+static THD_WORKING_AREA(wa_bench2, 1024);
+
+static semaphore_t sem_ping, sem_pong;
+
+/*===========================================================================*/
+/* Benchmarks.                                                               */
+/*===========================================================================*/
+
+/*
+ * Pong thread, it answers to each ping until the semaphore is reset.
+ */
+static THD_FUNCTION(pong_thread, arg) {
+
+  (void)arg;
+
+  while (chSemWait(&sem_ping) == MSG_OK) {
+    chSemSignal(&sem_pong);
+  }
+}
+
+/*
+ * Counter thread, it counts loop iterations until the deadline, the
+ * simulator has no preemption so the system time cannot be used here.
+ */
+static THD_FUNCTION(count_thread, arg) {
+  uint32_t *np = (uint32_t *)arg;
+  rtcnt_t start = chSysGetRealtimeCounterX();
+  rtcnt_t end = start + BENCH_DURATION;
+
+  *np = 0U;
+  while (chSysIsCounterWithinX(chSysGetRealtimeCounterX(), start, end)) {
+    (*np)++;
+  }
+}
+
+/*
+ * Migrating thread, it bounces between the two cores until the deadline.
+ */
+static THD_FUNCTION(migrate_thread, arg) {
+  uint32_t *np = (uint32_t *)arg;
+  rtcnt_t start = chSysGetRealtimeCounterX();
+  rtcnt_t end = start + BENCH_DURATION;
+
+  *np = 0U;
+  while (chSysIsCounterWithinX(chSysGetRealtimeCounterX(), start, end)) {
+    (void) chThdMigrate(chThdGetSelfX(), &ch1);
+    (void) chThdMigrate(chThdGetSelfX(), &ch0);
+    (*np)++;
+  }
+}
+
+/*
+ * Semaphores ping-pong between the main thread and a thread running on
+ * the specified instance.
+ */
+static uint32_t bench_ping_pong(os_instance_t *oip) {
+  thread_descriptor_t td = THD_DESCRIPTOR_AFFINITY("pong",
+                                                   THD_WORKING_AREA_BASE(wa_bench1),
+                                                   THD_WORKING_AREA_END(wa_bench1),
+                                                   NORMALPRIO + 1,
+                                                   pong_thread,
+                                                   NULL,
+                                                   oip);
+  rtcnt_t start, end;
+  thread_t *tp;
+  uint32_t n = 0U;
+
+  chSemObjectInit(&sem_ping, (cnt_t)0);
+  chSemObjectInit(&sem_pong, (cnt_t)0);
+  tp = chThdCreate(&td);
+
+  start = chSysGetRealtimeCounterX();
+  end = start + BENCH_DURATION;
+  do {
+    chSemSignal(&sem_ping);
+    (void) chSemWait(&sem_pong);
+    n++;
+  } while (chSysIsCounterWithinX(chSysGetRealtimeCounterX(), start, end));
+
+  chSemReset(&sem_ping, (cnt_t)0);
+  (void) chThdWait(tp);
+
+  return n;
+}
+
+/*
+ * Counting on one or both cores at the same time.
+ */
+static uint32_t bench_count(bool smp) {
+  thread_descriptor_t td1 = THD_DESCRIPTOR_AFFINITY("count1",
+                                                    THD_WORKING_AREA_BASE(wa_bench1),
+                                                    THD_WORKING_AREA_END(wa_bench1),
+                                                    NORMALPRIO - 1,
+                                                    count_thread,
+                                                    NULL,
+                                                    &ch0);
+  thread_descriptor_t td2 = THD_DESCRIPTOR_AFFINITY("count2",
+                                                    THD_WORKING_AREA_BASE(wa_bench2),
+                                                    THD_WORKING_AREA_END(wa_bench2),
+                                                    NORMALPRIO - 1,
+                                                    count_thread,
+                                                    NULL,
+                                                    &ch1);
+  thread_t *tp1, *tp2 = NULL;
+  uint32_t n1, n2 = 0U;
+
+  td1.arg = &n1;
+  td2.arg = &n2;
+  tp1 = chThdCreate(&td1);
+  if (smp) {
+    tp2 = chThdCreate(&td2);
+  }
+
+  (void) chThdWait(tp1);
+  if (tp2 != NULL) {
+    (void) chThdWait(tp2);
+  }
+
+  return n1 + n2;
+}
+
+/*
+ * Self migrations between the two cores.
+ */
+static uint32_t bench_migrate(void) {
+  uint32_t n;
+  thread_t *tp = chThdCreateStatic(wa_bench1, sizeof (wa_bench1),
+                                   NORMALPRIO - 1, migrate_thread, &n);
+
+  (void) chThdWait(tp);
+
+  return n;
+}
+
+/*------------------------------------------------------------------------*
+ * Simulator main.                                                        *
+ *------------------------------------------------------------------------*/
+int main(void) {
+  uint32_t n1, n2;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations, the second simulated
+   *   core is started here.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  /*
+   * Waiting for the other core to become operative.
+   */
+  while (ch_system.instances[1] == NULL) {
+    chThdSleepMilliseconds(10);
+  }
+
+  printf("*** ChibiOS/RT SMP simulator tests and benchmarks\n");
+  printf("*** Kernel: %s\n", CH_KERNEL_VERSION);
+  printf("*** Port:   %s\n\n", PORT_INFO);
+
+  /*
+   * RT test suite, it includes the threads migration tests, the output
+   * goes to the console.
+   */
+  if (test_execute_putchar(putchar, &rt_test_suite)) {
+    return 1;
+  }
+
+  n1 = bench_ping_pong(&ch0);
+  n2 = bench_ping_pong(&ch1);
+  printf("--- Semaphores ping-pong, same core:  %u cycles/S\n", (unsigned)n1);
+  printf("--- Semaphores ping-pong, cross core: %u cycles/S\n", (unsigned)n2);
+
+  n1 = bench_count(false);
+  n2 = bench_count(true);
+  printf("--- Counting, one core:               %u loops/S\n", (unsigned)n1);
+  printf("--- Counting, two cores:              %u loops/S (x%u.%02u)\n",
+         (unsigned)n2,
+         (unsigned)(n2 / n1),
+         (unsigned)(((uint64_t)(n2 % n1) * 100U) / n1));
+
+  n1 = bench_migrate();
+  printf("--- Threads migration:                %u round trips/S\n",
+         (unsigned)n1);
+  fflush(stdout);
+
+  return 0;
+}
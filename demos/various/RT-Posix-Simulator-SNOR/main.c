@@ -0,0 +1,216 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "hal_serial_nor.h"
+#include "hal_mfs.h"
+#include "mfs_test_root.h"
+
+/*
+ * Flash area used by the benchmark, the first two sectors are the MFS
+ * banks.
+ */
+#define BENCH_SECTOR            2U
+#define BENCH_AREA_SIZE         65536U
+
+/*
+ * Size of each read or program operation, like a log record or a file
+ * system metadata update.
+ */
+#define BENCH_CHUNK_SIZE        16U
+
+static const SPIConfig spicfg1 = {
+  .dummy            = 0U
+};
+
+const SNORConfig snorcfg1 = {
+  .busp             = &SPID1,
+  .buscfg           = &spicfg1
+};
+
+SNORDriver snor1;
+snor_nocache_buffer_t __nocache_snor1buf;
+
+const MFSConfig mfscfg1 = {
+  .flashp           = (BaseFlash *)&snor1,
+  .erased           = 0xFFFFFFFFU,
+  .bank_size        = 65536U,
+  .bank0_start      = 0U,
+  .bank0_sectors    = 1U,
+  .bank1_start      = 1U,
+  .bank1_sectors    = 1U
+};
+
+static uint8_t buffer[BENCH_CHUNK_SIZE];
+
+/*===========================================================================*/
+/* Benchmark.                                                                */
+/*===========================================================================*/
+
+/*
+ * Content of the flash area, a function of the position.
+ */
+static uint8_t pattern(uint32_t pos) {
+
+  return (uint8_t)((pos >> 8) ^ (pos * 3U));
+}
+
+static void report(const char *name, rtcnt_t start,
+                   uint32_t commands, uint32_t transfers) {
+  rtcnt_t elapsed = chSysGetRealtimeCounterX() - start;
+
+  printf("--- %-16s %5u KB/S, %6u commands, %6u transfers\n", name,
+         (unsigned)(((uint64_t)BENCH_AREA_SIZE * 1000000U) /
+                    ((uint64_t)elapsed * 1024U)),
+         (unsigned)(SPID1.commands - commands),
+         (unsigned)(SPID1.transfers - transfers));
+}
+
+/*
+ * Programs the erased benchmark area in small chunks, optionally within
+ * a single batch.
+ */
+static bool bench_program(const char *name, bool batch) {
+  flash_offset_t base = (flash_offset_t)BENCH_SECTOR * BENCH_AREA_SIZE;
+  uint32_t commands, transfers;
+  rtcnt_t start;
+  uint32_t pos;
+  unsigned i;
+
+  if ((flashStartEraseSector(&snor1, BENCH_SECTOR) != FLASH_NO_ERROR) ||
+      (flashWaitErase((BaseFlash *)&snor1) != FLASH_NO_ERROR)) {
+    return false;
+  }
+
+  commands  = SPID1.commands;
+  transfers = SPID1.transfers;
+  start     = chSysGetRealtimeCounterX();
+  if (batch) {
+    snorStartBatch(&snor1);
+  }
+  for (pos = 0U; pos < BENCH_AREA_SIZE; pos += BENCH_CHUNK_SIZE) {
+    for (i = 0U; i < BENCH_CHUNK_SIZE; i++) {
+      buffer[i] = pattern(pos + i);
+    }
+    if (flashProgram(&snor1, base + pos, BENCH_CHUNK_SIZE,
+                     buffer) != FLASH_NO_ERROR) {
+      return false;
+    }
+  }
+  if (batch) {
+    if (snorStopBatch(&snor1) != FLASH_NO_ERROR) {
+      return false;
+    }
+  }
+  else {
+    if (snorSync(&snor1) != FLASH_NO_ERROR) {
+      return false;
+    }
+  }
+  report(name, start, commands, transfers);
+
+  return true;
+}
+
+/*
+ * Reads back the benchmark area in small chunks, optionally within a
+ * single batch, the content is verified.
+ */
+static bool bench_read(const char *name, bool batch) {
+  flash_offset_t base = (flash_offset_t)BENCH_SECTOR * BENCH_AREA_SIZE;
+  uint32_t commands, transfers;
+  rtcnt_t start;
+  uint32_t pos;
+  unsigned i;
+
+  commands  = SPID1.commands;
+  transfers = SPID1.transfers;
+  start     = chSysGetRealtimeCounterX();
+  if (batch) {
+    snorStartBatch(&snor1);
+  }
+  for (pos = 0U; pos < BENCH_AREA_SIZE; pos += BENCH_CHUNK_SIZE) {
+    if (flashRead(&snor1, base + pos, BENCH_CHUNK_SIZE,
+                  buffer) != FLASH_NO_ERROR) {
+      return false;
+    }
+    for (i = 0U; i < BENCH_CHUNK_SIZE; i++) {
+      if (buffer[i] != pattern(pos + i)) {
+        return false;
+      }
+    }
+  }
+  if (batch) {
+    (void) snorStopBatch(&snor1);
+  }
+  report(name, start, commands, transfers);
+
+  return true;
+}
+
+/*------------------------------------------------------------------------*
+ * Simulator main.                                                        *
+ *------------------------------------------------------------------------*/
+int main(void) {
+  bool failed;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  /*
+   * Serial NOR driver on the simulated SPI flash.
+   */
+  snorObjectInit(&snor1, &__nocache_snor1buf);
+  snorStart(&snor1, &snorcfg1);
+
+  /*
+   * MFS test suite over the serial NOR driver, the output goes to the
+   * console.
+   */
+  failed = test_execute_putchar(putchar, &mfs_test_suite);
+
+  printf("\n*** ChibiOS/HAL serial NOR benchmark\n");
+  printf("*** Device:     %u bytes, %u sectors\n",
+         (unsigned)flashGetDescriptor(&snor1)->size,
+         (unsigned)flashGetDescriptor(&snor1)->sectors_count);
+  printf("*** Access:     %u bytes in %u bytes chunks\n",
+         (unsigned)BENCH_AREA_SIZE, (unsigned)BENCH_CHUNK_SIZE);
+  printf("*** Caching:    %u bytes read cache, %u bytes program buffer\n\n",
+         (unsigned)SNOR_READ_CACHE_SIZE, (unsigned)SNOR_PROGRAM_BUFFER_SIZE);
+
+  if (!bench_program("Program", false) ||
+      !bench_read("Read", false) ||
+      !bench_program("Program (batch)", true) ||
+      !bench_read("Read (batch)", true)) {
+    printf("*** Benchmark failed\n");
+    return 1;
+  }
+  fflush(stdout);
+
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,38 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    legacy_scanf.h
+ * @brief   Previous chscanf() implementation.
+ */
+
+#ifndef LEGACY_SCANF_H
+#define LEGACY_SCANF_H
+
+#include <stdarg.h>
+
+#include "oop_sequential_stream.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  int legacy_chvscanf(sequential_stream_i *stmp, const char *fmt, va_list ap);
+  int legacy_chscanf(sequential_stream_i *stmp, const char *fmt, ...);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LEGACY_SCANF_H */
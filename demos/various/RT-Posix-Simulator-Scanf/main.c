@@ -0,0 +1,242 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "chprintf.h"
+#include "chscanf.h"
+#include "memstreams.h"
+
+#include "legacy_scanf.h"
+
+/*
+ * Number of lines parsed by each benchmark.
+ */
+#define BENCH_LINES             200000
+
+/*
+ * Number of different lines, they are generated once.
+ */
+#define LINES_NUMBER            256
+
+/*
+ * Number of decimal values verified against strtod().
+ */
+#define CHECK_VALUES            10000
+
+/*
+ * A typical configuration line, about 40 characters.
+ */
+#define LINE_FORMAT             "%-8s %U %d %X %d.%03d\n"
+#define LINE_SCAN_FORMAT        "%15s %U %d %X %lf"
+
+typedef struct {
+  char                  name[16];
+  unsigned long         id;
+  int                   offset;
+  unsigned long         mask;
+  double                gain;
+} record_t;
+
+static char lines[LINES_NUMBER][64];
+static record_t expected[LINES_NUMBER];
+static uint8_t buffer[64];
+static memory_stream_c ms;
+
+/*===========================================================================*/
+/* Checks.                                                                   */
+/*===========================================================================*/
+
+static void make_lines(void) {
+  unsigned i;
+
+  for (i = 0U; i < LINES_NUMBER; i++) {
+    record_t *rp = &expected[i];
+
+    (void) chsnprintf(rp->name, sizeof (rp->name), "node%u", i % 10U);
+    rp->id     = (unsigned long)i * 7919UL;
+    rp->offset = -(int)(i * 13U);
+    rp->mask   = (unsigned long)((i * 2654435761U) | 1U);
+    rp->gain   = (double)((i * 3000U) + (i % 1000U)) / 1000.0;
+    (void) chsnprintf(lines[i], sizeof (lines[i]), LINE_FORMAT,
+                      rp->name, rp->id, rp->offset, rp->mask,
+                      (int)(i * 3U), (int)(i % 1000U));
+  }
+}
+
+static bool check_record(const record_t *rp, unsigned i) {
+  const record_t *ep = &expected[i];
+
+  return (strcmp(rp->name, ep->name) == 0) && (rp->id == ep->id) &&
+         (rp->offset == ep->offset) && (rp->mask == ep->mask) &&
+         (rp->gain == ep->gain);
+}
+
+/*
+ * Short decimal values are converted exactly, the result is compared with
+ * the one of strtod(), the previous implementation is checked too. Note
+ * that the x87 FPU used by the simulator can introduce a double rounding,
+ * so the mismatches are only reported.
+ */
+static void check_values(void) {
+  static char value[32];
+  uint32_t seed = 1U;
+  unsigned i, exact = 0U, legacy_exact = 0U;
+
+  for (i = 0U; i < CHECK_VALUES; i++) {
+    double v;
+
+    seed = (seed * 1103515245U) + 12345U;
+    (void) chsnprintf(value, sizeof (value), "%u.%ue%d",
+                      (unsigned)(seed >> 20), (unsigned)(seed & 0xFFFU),
+                      (int)((seed >> 12) & 0x1FU) - 16);
+    if ((chsnscanf(value, sizeof (value), "%lf", &v) == 1) &&
+        (v == strtod(value, NULL))) {
+      exact++;
+    }
+    memstmObjectInit(&ms, (uint8_t *)value, strlen(value), strlen(value));
+    if ((legacy_chscanf(&ms.stm, "%lf", &v) == 1) &&
+        (v == strtod(value, NULL))) {
+      legacy_exact++;
+    }
+  }
+  printf("--- Exact:      %u/%u decimal values\n",
+         exact, (unsigned)CHECK_VALUES);
+  printf("--- Legacy:     %u/%u decimal values\n",
+         legacy_exact, (unsigned)CHECK_VALUES);
+}
+
+/*===========================================================================*/
+/* Benchmark.                                                                */
+/*===========================================================================*/
+
+static void report(const char *name, rtcnt_t start) {
+  rtcnt_t elapsed = chSysGetRealtimeCounterX() - start;
+
+  printf("--- %-14s %8u lines/S\n", name,
+         (unsigned)(((uint64_t)BENCH_LINES * 1000000U) / (uint64_t)elapsed));
+}
+
+/*
+ * Lines parsed from a memory stream by the previous chscanf().
+ */
+static bool bench_legacy(void) {
+  record_t r;
+  rtcnt_t start;
+  uint32_t i;
+
+  start = chSysGetRealtimeCounterX();
+  for (i = 0U; i < BENCH_LINES; i++) {
+    unsigned n = i % LINES_NUMBER;
+    size_t size = strlen(lines[n]);
+
+    memcpy(buffer, lines[n], size);
+    memstmObjectInit(&ms, buffer, size, size);
+    if ((legacy_chscanf(&ms.stm, LINE_SCAN_FORMAT,
+                        r.name, &r.id, &r.offset, &r.mask, &r.gain) != 5) ||
+        !check_record(&r, n)) {
+      return false;
+    }
+  }
+  report("legacy chscanf", start);
+
+  return true;
+}
+
+/*
+ * Lines parsed from a memory stream by chscanf().
+ */
+static bool bench_stream(void) {
+  record_t r;
+  rtcnt_t start;
+  uint32_t i;
+
+  start = chSysGetRealtimeCounterX();
+  for (i = 0U; i < BENCH_LINES; i++) {
+    unsigned n = i % LINES_NUMBER;
+    size_t size = strlen(lines[n]);
+
+    memcpy(buffer, lines[n], size);
+    memstmObjectInit(&ms, buffer, size, size);
+    if ((chscanf(&ms.stm, LINE_SCAN_FORMAT,
+                 r.name, &r.id, &r.offset, &r.mask, &r.gain) != 5) ||
+        !check_record(&r, n)) {
+      return false;
+    }
+  }
+  report("chscanf", start);
+
+  /* The final newline is left in the stream.*/
+  return ms.offset == ms.eos - 1U;
+}
+
+/*
+ * Lines parsed in place by chsnscanf().
+ */
+static bool bench_string(void) {
+  record_t r;
+  rtcnt_t start;
+  uint32_t i;
+
+  start = chSysGetRealtimeCounterX();
+  for (i = 0U; i < BENCH_LINES; i++) {
+    unsigned n = i % LINES_NUMBER;
+
+    if ((chsnscanf(lines[n], sizeof (lines[n]), LINE_SCAN_FORMAT,
+                   r.name, &r.id, &r.offset, &r.mask, &r.gain) != 5) ||
+        !check_record(&r, n)) {
+      return false;
+    }
+  }
+  report("chsnscanf", start);
+
+  return true;
+}
+
+/*------------------------------------------------------------------------*
+ * Simulator main.                                                        *
+ *------------------------------------------------------------------------*/
+int main(void) {
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  printf("*** ChibiOS/RT chscanf() benchmark\n");
+  printf("*** Kernel:     %s\n", CH_KERNEL_VERSION);
+  printf("*** Buffer:     %u bytes\n\n", (unsigned)CHSCANF_BUFFER_SIZE);
+
+  make_lines();
+  check_values();
+  if (!bench_legacy() || !bench_stream() || !bench_string()) {
+    printf("*** Benchmark failed\n");
+    return 1;
+  }
+  fflush(stdout);
+
+  return 0;
+}
@@ -0,0 +1,40 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    shellconf.h
+ * @brief   Shell configuration header.
+ */
+
+#ifndef SHELLCONF_H
+#define SHELLCONF_H
+
+/*
+ * Hashed lookup, it can be disabled with -DSHELL_USE_HASH=FALSE in UDEFS
+ * for comparison.
+ */
+#if !defined(SHELL_USE_HASH)
+#define SHELL_USE_HASH                      TRUE
+#endif
+
+#define SHELL_USE_OUTPUT_BUFFER             TRUE
+
+/*
+ * The test command requires the test suites.
+ */
+#define SHELL_CMD_TEST_ENABLED              FALSE
+
+#endif /* SHELLCONF_H */
@@ -0,0 +1,300 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "shell.h"
+#include "chprintf.h"
+#include "memstreams.h"
+
+/*
+ * Number of commands executed by each dispatch benchmark.
+ */
+#define BENCH_LINES             20000
+
+/*
+ * Number of commands executed by each output benchmark, the input is
+ * paced so these take a few seconds.
+ */
+#define OUTPUT_LINES            500
+
+/*
+ * Interval between input lines in the output benchmarks.
+ */
+#define OUTPUT_INTERVAL         TIME_MS2I(5)
+
+/*
+ * Emulated channel speed in the output benchmarks, about 115200 baud.
+ */
+#define OUTPUT_US_PER_BYTE      87U
+
+/*
+ * Shell output buffer size.
+ */
+#define OUTPUT_BUFFER_SIZE      1024U
+
+/*
+ * Shell thread working area size.
+ */
+#define SHELL_WA_SIZE           THD_WORKING_AREA_SIZE(2048)
+
+/*
+ * Script stream, the input is read from a memory stream and the output is
+ * counted, optionally emulating a slow channel.
+ */
+typedef struct {
+  const struct BaseSequentialStreamVMT *vmt;
+  MemoryStream          script;
+  sysinterval_t         interval;
+  bool                  bol;
+  uint32_t              us_per_byte;
+  uint32_t              debt;
+  size_t                out_bytes;
+} script_stream_t;
+
+static uint8_t script[BENCH_LINES * 16];
+static script_stream_t ss;
+
+static uint32_t cmd_count;
+static bool cmd_output;
+static uint64_t cmd_time;
+
+/*===========================================================================*/
+/* Script stream.                                                            */
+/*===========================================================================*/
+
+/*
+ * The emulated channel blocks the writer once the transmission time of the
+ * data written so far reaches a system tick.
+ */
+static void ss_output(script_stream_t *ssp, size_t n) {
+  uint32_t ticks;
+
+  ssp->out_bytes += n;
+  if (ssp->us_per_byte > 0U) {
+    ssp->debt += (uint32_t)n * ssp->us_per_byte;
+    ticks = ssp->debt / (1000000U / CH_CFG_ST_FREQUENCY);
+    if (ticks > 0U) {
+      ssp->debt -= ticks * (1000000U / CH_CFG_ST_FREQUENCY);
+      chThdSleep((sysinterval_t)ticks);
+    }
+  }
+}
+
+static size_t ss_write(void *ip, const uint8_t *bp, size_t n) {
+
+  (void)bp;
+
+  ss_output(ip, n);
+  return n;
+}
+
+static size_t ss_read(void *ip, uint8_t *bp, size_t n) {
+  script_stream_t *ssp = ip;
+
+  /* Lines are delivered at the configured interval.*/
+  if (ssp->bol && (ssp->interval > (sysinterval_t)0)) {
+    chThdSleep(ssp->interval);
+  }
+  n = streamRead(&ssp->script, bp, n);
+  if (n > 0U) {
+    ssp->bol = bp[n - 1U] == '\r';
+  }
+  return n;
+}
+
+static msg_t ss_put(void *ip, uint8_t b) {
+
+  (void)b;
+
+  ss_output(ip, 1U);
+  return MSG_OK;
+}
+
+static msg_t ss_get(void *ip) {
+  uint8_t b;
+
+  if (ss_read(ip, &b, 1U) == 0U) {
+    return MSG_RESET;
+  }
+  return (msg_t)b;
+}
+
+static const struct BaseSequentialStreamVMT ss_vmt = {
+  (size_t)0, ss_write, ss_read, ss_put, ss_get
+};
+
+/*===========================================================================*/
+/* Commands.                                                                 */
+/*===========================================================================*/
+
+static void cmd_bench(BaseSequentialStream *chp, int argc, char *argv[]) {
+  rtcnt_t start;
+
+  cmd_count++;
+  if (cmd_output) {
+    start = chSysGetRealtimeCounterX();
+    chprintf(chp, "%s: %d arguments, sample %08X" SHELL_NEWLINE_STR,
+             argv[0], argc, cmd_count);
+    cmd_time += (uint64_t)(chSysGetRealtimeCounterX() - start);
+  }
+}
+
+#define CMD(n)  {"cmd" #n, cmd_bench}
+
+static const ShellCommand commands[] = {
+  CMD(00), CMD(01), CMD(02), CMD(03), CMD(04),
+  CMD(05), CMD(06), CMD(07), CMD(08), CMD(09),
+  CMD(10), CMD(11), CMD(12), CMD(13), CMD(14),
+  CMD(15), CMD(16), CMD(17), CMD(18), CMD(19),
+  CMD(20), CMD(21), CMD(22), CMD(23), CMD(24),
+  CMD(25), CMD(26), CMD(27), CMD(28), CMD(29),
+  CMD(30), CMD(31), CMD(32), CMD(33), CMD(34),
+  CMD(35), CMD(36), CMD(37), CMD(38), CMD(39),
+  {NULL, NULL}
+};
+
+static const ShellConfig shell_cfg = {
+  (BaseSequentialStream *)&ss,
+  commands,
+  0U
+};
+
+static const ShellConfig shell_cfg_buffered = {
+  (BaseSequentialStream *)&ss,
+  commands,
+  OUTPUT_BUFFER_SIZE
+};
+
+/*===========================================================================*/
+/* Benchmark.                                                                */
+/*===========================================================================*/
+
+/*
+ * Runs a shell over a script repeating the specified line, the shell
+ * terminates at the end of the script. Returns the elapsed time.
+ */
+static rtcnt_t run_script(const ShellConfig *scfg, const char *line,
+                          unsigned lines) {
+  size_t len = strlen(line);
+  rtcnt_t start;
+  thread_t *tp;
+  unsigned i;
+
+  for (i = 0U; i < lines; i++) {
+    memcpy(&script[i * len], line, len);
+  }
+  msObjectInit(&ss.script, script, lines * len, lines * len);
+  ss.bol       = true;
+  ss.debt      = 0U;
+  ss.out_bytes = 0U;
+  cmd_count    = 0U;
+  cmd_time     = 0U;
+
+  start = chSysGetRealtimeCounterX();
+  tp = chThdCreateFromHeap(NULL, SHELL_WA_SIZE, "shell", NORMALPRIO + 1,
+                           shellThread, (void *)scfg);
+  if (tp == NULL) {
+    return (rtcnt_t)0;
+  }
+  (void) chThdWait(tp);
+
+  return chSysGetRealtimeCounterX() - start;
+}
+
+/*
+ * Command lookup, the first and the last user commands and an unknown
+ * command.
+ */
+static bool bench_dispatch(const char *name, const char *line,
+                           uint32_t expected) {
+  rtcnt_t elapsed;
+
+  ss.interval    = (sysinterval_t)0;
+  ss.us_per_byte = 0U;
+  cmd_output     = false;
+  elapsed = run_script(&shell_cfg, line, BENCH_LINES);
+  if ((elapsed == (rtcnt_t)0) || (cmd_count != expected)) {
+    return false;
+  }
+  printf("--- %-16s %8u commands/S\n", name,
+         (unsigned)(((uint64_t)BENCH_LINES * 1000000U) / (uint64_t)elapsed));
+
+  return true;
+}
+
+/*
+ * Commands printing a line on a slow channel, the time spent printing by
+ * the command handlers is measured.
+ */
+static bool bench_output(const char *name, const ShellConfig *scfg) {
+  rtcnt_t elapsed;
+
+  ss.interval    = OUTPUT_INTERVAL;
+  ss.us_per_byte = OUTPUT_US_PER_BYTE;
+  cmd_output     = true;
+  elapsed = run_script(scfg, "cmd20 a b\r", OUTPUT_LINES);
+  if ((elapsed == (rtcnt_t)0) || (cmd_count != OUTPUT_LINES)) {
+    return false;
+  }
+  printf("--- %-16s %8u uS/command, %u bytes in %u mS\n", name,
+         (unsigned)(cmd_time / OUTPUT_LINES), (unsigned)ss.out_bytes,
+         (unsigned)(elapsed / 1000U));
+
+  return true;
+}
+
+/*------------------------------------------------------------------------*
+ * Simulator main.                                                        *
+ *------------------------------------------------------------------------*/
+int main(void) {
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  /*
+   * Shell manager initialization.
+   */
+  shellInit();
+  ss.vmt = &ss_vmt;
+
+  printf("*** ChibiOS/RT shell benchmark\n");
+  printf("*** Kernel:     %s\n", CH_KERNEL_VERSION);
+  printf("*** Lookup:     %s\n\n", SHELL_USE_HASH == TRUE ? "hash" : "linear");
+
+  if (!bench_dispatch("first command", "cmd00 1 2\r", BENCH_LINES) ||
+      !bench_dispatch("last command", "cmd39 1 2\r", BENCH_LINES) ||
+      !bench_dispatch("unknown command", "nocmd 1 2\r", 0U) ||
+      !bench_output("unbuffered", &shell_cfg) ||
+      !bench_output("buffered", &shell_cfg_buffered)) {
+    printf("*** Benchmark failed\n");
+    return 1;
+  }
+  fflush(stdout);
+
+  return 0;
+}
@@ -0,0 +1,168 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "vfs.h"
+#include "ch_test.h"
+
+#include "vfs_test_root.h"
+
+/*
+ * Size of the blocks transferred by the benchmarks.
+ */
+#define BENCH_BLOCK_SIZE        512
+
+/*
+ * Size of the pipe buffer used by the benchmark.
+ */
+#define BENCH_PIPE_SIZE         1024
+
+/*
+ * Duration of each benchmark, the simulator realtime counter has a
+ * resolution of one microsecond.
+ */
+#define BENCH_DURATION          ((rtcnt_t)1000000)
+
+static uint8_t pipe_buffer[BENCH_PIPE_SIZE];
+static pipe_t pipe1;
+static uint8_t wrbuf[BENCH_BLOCK_SIZE], rdbuf[BENCH_BLOCK_SIZE];
+static THD_WORKING_AREA(wa_writer, 1024);
+static rtcnt_t start, end;
+
+/* VFS streams driver exposing the benchmark pipe as "/pipe".*/
+static const drv_streams_element_t streams[] = {
+  {"pipe", NULL, &pipe1},
+  {NULL, NULL, NULL}
+};
+static vfs_streams_driver_c dev_driver;
+
+/* VFS root.*/
+vfs_driver_c *vfs_root = (vfs_driver_c *)&dev_driver;
+
+static bool bench_running(void) {
+
+  return chSysIsCounterWithinX(chSysGetRealtimeCounterX(), start, end);
+}
+
+static void bench_start(void) {
+
+  start = chSysGetRealtimeCounterX();
+  end = start + BENCH_DURATION;
+}
+
+/*
+ * Writer thread, it writes blocks into the pipe node until the end of the
+ * benchmark then it resets the pipe, the reset is seen as the end of
+ * stream by the reader.
+ */
+static THD_FUNCTION(writer_thread, arg) {
+  vfs_file_node_c *fnp;
+
+  (void)arg;
+
+  if (vfsOpenFile("/pipe", VO_WRONLY, &fnp) == CH_RET_SUCCESS) {
+    while (bench_running()) {
+      (void) vfsWriteFile(fnp, wrbuf, BENCH_BLOCK_SIZE);
+    }
+    vfsClose((vfs_node_c *)fnp);
+  }
+  chPipeReset(&pipe1);
+}
+
+/*
+ * Reference copy speed.
+ */
+static uint64_t bench_memcpy(void) {
+  uint64_t n = 0U;
+
+  bench_start();
+  while (bench_running()) {
+    memcpy(rdbuf, wrbuf, BENCH_BLOCK_SIZE);
+    n += BENCH_BLOCK_SIZE;
+  }
+
+  return n;
+}
+
+/*
+ * Transfer speed between two threads through pipe nodes.
+ */
+static uint64_t bench_pipe(void) {
+  vfs_file_node_c *fnp;
+  thread_t *tp;
+  ssize_t ret;
+  uint64_t n = 0U;
+
+  chPipeObjectInit(&pipe1, pipe_buffer, sizeof (pipe_buffer));
+  if (vfsOpenFile("/pipe", VO_RDONLY, &fnp) != CH_RET_SUCCESS) {
+    return 0U;
+  }
+
+  bench_start();
+  tp = chThdCreateStatic(wa_writer, sizeof (wa_writer),
+                         chThdGetPriorityX(), writer_thread, NULL);
+  while ((ret = vfsReadFile(fnp, rdbuf, BENCH_BLOCK_SIZE)) > 0) {
+    n += (uint64_t)ret;
+  }
+  (void) chThdWait(tp);
+  vfsClose((vfs_node_c *)fnp);
+
+  return n;
+}
+
+/*------------------------------------------------------------------------*
+ * Simulator main.                                                        *
+ *------------------------------------------------------------------------*/
+int main(void) {
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   * - Virtual File System initialization.
+   */
+  halInit();
+  chSysInit();
+  vfsInit();
+
+  /*
+   * Initializing the streams VFS driver used as root.
+   */
+  (void) stmdrvObjectInit(&dev_driver, &streams[0]);
+
+  /*
+   * VFS test suite, the output goes to the console.
+   */
+  if (test_execute_putchar(putchar, &vfs_test_suite)) {
+    return 1;
+  }
+
+  printf("*** ChibiOS/VFS pipe nodes benchmark\n");
+  printf("*** Kernel:     %s\n", CH_KERNEL_VERSION);
+  printf("*** Block size: %u bytes\n\n", (unsigned)BENCH_BLOCK_SIZE);
+
+  printf("--- memcpy():   %u KB/S\n", (unsigned)(bench_memcpy() / 1024U));
+  printf("--- Pipe node:  %u KB/S\n", (unsigned)(bench_pipe() / 1024U));
+  fflush(stdout);
+
+  return 0;
+}
@@ -0,0 +1,205 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "lwipthread.h"
+
+#include <lwip/udp.h>
+#include <lwip/tcpip.h>
+
+/*
+ * Duration of each measurement, the simulator realtime counter has a
+ * resolution of one microsecond.
+ */
+#define BENCH_DURATION          ((rtcnt_t)1000000)
+
+/*
+ * Number of measurements.
+ */
+#define BENCH_ROUNDS            4
+
+/*
+ * UDP port receiving the generated datagrams.
+ */
+#define BENCH_PORT              5000
+
+/*
+ * Size of the UDP payload.
+ */
+#define BENCH_PAYLOAD_SIZE      1024
+
+/*
+ * Size of the generated frames.
+ */
+#define BENCH_FRAME_SIZE        (14 + 20 + 8 + BENCH_PAYLOAD_SIZE)
+
+static uint8_t frame[BENCH_FRAME_SIZE];
+static volatile uint32_t nrx;
+
+/*
+ * Receive callback, invoked with the lwIP core locked.
+ */
+static void udp_recv_cb(void *arg, struct udp_pcb *pcb, struct pbuf *p,
+                        const ip_addr_t *addr, u16_t port) {
+
+  (void)arg;
+  (void)pcb;
+  (void)addr;
+  (void)port;
+
+  nrx++;
+  pbuf_free(p);
+}
+
+/*
+ * Builds an Ethernet/IPv4/UDP frame addressed to the lwIP interface, the
+ * UDP checksum is left to zero.
+ */
+static void frame_init(void) {
+  static const uint8_t hdr[14 + 20 + 8] = {
+    /* Ethernet, destination, source and type.*/
+    LWIP_ETHADDR_0, LWIP_ETHADDR_1, LWIP_ETHADDR_2,
+    LWIP_ETHADDR_3, LWIP_ETHADDR_4, LWIP_ETHADDR_5,
+    0x02, 0x00, 0x00, 0x00, 0x00, 0x01,
+    0x08, 0x00,
+    /* IPv4, source 192.168.1.2, destination 192.168.1.10.*/
+    0x45, 0x00, (20 + 8 + BENCH_PAYLOAD_SIZE) >> 8,
+    (20 + 8 + BENCH_PAYLOAD_SIZE) & 0xFF,
+    0x00, 0x00, 0x00, 0x00, 0x40, 0x11, 0x00, 0x00,
+    192, 168, 1, 2,
+    192, 168, 1, 10,
+    /* UDP.*/
+    BENCH_PORT >> 8, BENCH_PORT & 0xFF, BENCH_PORT >> 8, BENCH_PORT & 0xFF,
+    (8 + BENCH_PAYLOAD_SIZE) >> 8, (8 + BENCH_PAYLOAD_SIZE) & 0xFF,
+    0x00, 0x00
+  };
+  uint32_t sum = 0U;
+  unsigned i;
+
+  memcpy(frame, hdr, sizeof (hdr));
+  memset(&frame[sizeof (hdr)], 0x55, BENCH_PAYLOAD_SIZE);
+
+  /* IPv4 header checksum.*/
+  for (i = 14U; i < 14U + 20U; i += 2U) {
+    sum += ((uint32_t)frame[i] << 8) | (uint32_t)frame[i + 1U];
+  }
+  while ((sum >> 16) != 0U) {
+    sum = (sum & 0xFFFFU) + (sum >> 16);
+  }
+  sum = ~sum & 0xFFFFU;
+  frame[14 + 10] = (uint8_t)(sum >> 8);
+  frame[14 + 11] = (uint8_t)sum;
+}
+
+/*
+ * Sends frames through the looped-back MAC for the measurement duration,
+ * the received datagrams per second are returned.
+ */
+static uint32_t bench_receive(uint32_t *ntxp) {
+  MACTransmitDescriptor td;
+  rtcnt_t start, end;
+  uint32_t ntx = 0U;
+
+  nrx = 0U;
+  start = chSysGetRealtimeCounterX();
+  end = start + BENCH_DURATION;
+  while (chSysIsCounterWithinX(chSysGetRealtimeCounterX(), start, end)) {
+    if (macWaitTransmitDescriptor(&ETHD1, &td, TIME_MS2I(100)) != MSG_OK) {
+      continue;
+    }
+    (void) macWriteTransmitDescriptor(&td, frame, sizeof (frame));
+    macReleaseTransmitDescriptorX(&td);
+    ntx++;
+
+    /* Serving the simulated MAC interrupt, the network threads
+       preempt this thread.*/
+    _sim_check_for_interrupts();
+  }
+
+  *ntxp = ntx;
+  return nrx;
+}
+
+/*------------------------------------------------------------------------*
+ * Simulator main.                                                        *
+ *------------------------------------------------------------------------*/
+int main(void) {
+  struct udp_pcb *pcb;
+  unsigned i;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  /*
+   * lwIP initialization with the static configuration.
+   */
+  lwipInit(NULL);
+
+  LOCK_TCPIP_CORE();
+  pcb = udp_new();
+  (void) udp_bind(pcb, IP_ADDR_ANY, BENCH_PORT);
+  udp_recv(pcb, udp_recv_cb, NULL);
+  UNLOCK_TCPIP_CORE();
+
+  frame_init();
+
+  printf("*** ChibiOS/RT lwIP receive benchmark\n");
+  printf("*** Kernel:     %s\n", CH_KERNEL_VERSION);
+#if (MAC_USE_ZERO_COPY == TRUE) && (LWIP_ZERO_COPY_RX_BUFFERS > 0)
+  printf("*** RX path:    zero-copy\n");
+#else
+  printf("*** RX path:    copy\n");
+#endif
+  printf("*** RX batch:   %u frames\n", (unsigned)LWIP_RX_BATCH_SIZE);
+  printf("*** Frame size: %u bytes\n\n", (unsigned)sizeof (frame));
+
+  for (i = 0U; i < BENCH_ROUNDS; i++) {
+    uint32_t ntx, n;
+
+    n = bench_receive(&ntx);
+    printf("--- Sent %u frames/S, received %u datagrams/S, %u MB/S\n",
+           (unsigned)ntx, (unsigned)n,
+           (unsigned)((n * BENCH_PAYLOAD_SIZE) / 1000000U));
+  }
+  printf("--- Frames dropped by the MAC: %u\n", (unsigned)ETHD1.rxdropped);
+#if LWIP_RX_BATCH_SIZE > 0
+  {
+    lwip_rx_stats_t stats;
+
+    lwipGetRxStats(&stats);
+    printf("--- RX batches: %u, average %u frames, max %u frames, "
+           "%u exhausted\n",
+           (unsigned)stats.batches,
+           (unsigned)(stats.batches > 0U ? stats.frames / stats.batches : 0U),
+           (unsigned)stats.max_batch, (unsigned)stats.exhausted);
+  }
+#endif
+  fflush(stdout);
+
+  return 0;
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2001-2003 Swedish Institute of Computer Science.
+ * All rights reserved. 
+ * 
+ * Redistribution and use in source and binary forms, with or without modification, 
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED 
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF 
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT 
+ * SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT 
+ * OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING 
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+ * OF SUCH DAMAGE.
+ *
+ * This file is part of the lwIP TCP/IP stack.
+ * 
+ * Author: Simon Goldschmidt
+ *
+ */
+#ifndef LWIP_HDR_LWIPOPTS_H__
+#define LWIP_HDR_LWIPOPTS_H__
+
+/* Fixed settings mandated by the ChibiOS integration.*/
+#include "static_lwipopts.h"
+
+/* Optional, application-specific settings.*/
+#if !defined(TCPIP_MBOX_SIZE)
+#define TCPIP_MBOX_SIZE                 MEMP_NUM_PBUF
+#endif
+#if !defined(TCPIP_THREAD_STACKSIZE)
+#define TCPIP_THREAD_STACKSIZE          4096
+#endif
+
+/* The BSD sockets API is not used, its declarations would clash with the
+   host socket headers included by the simulator HAL, the byte order macros
+   are taken from the host headers too.*/
+#if !defined(LWIP_SOCKET)
+#define LWIP_SOCKET                     0
+#endif
+#if !defined(LWIP_DONT_PROVIDE_BYTEORDER_FUNCTIONS)
+#define LWIP_DONT_PROVIDE_BYTEORDER_FUNCTIONS 1
+#endif
+
+/* Received frames are passed by reference in zero-copy mode.*/
+#if !defined(LWIP_SUPPORT_CUSTOM_PBUF)
+#define LWIP_SUPPORT_CUSTOM_PBUF        1
+#endif
+
+/* Use ChibiOS specific priorities, the network threads preempt the
+   TLS client and server running at NORMALPRIO.*/
+#if !defined(TCPIP_THREAD_PRIO)
+#define TCPIP_THREAD_PRIO               (NORMALPRIO + 2)
+#endif
+#if !defined(LWIP_THREAD_PRIORITY)
+#define LWIP_THREAD_PRIORITY            (NORMALPRIO + 1)
+#endif
+#if !defined(LWIP_THREAD_STACK_SIZE)
+#define LWIP_THREAD_STACK_SIZE          4096
+#endif
+
+/* Semaphores and mailboxes use the fast path of the OS.*/
+#if !defined(CH_LWIP_USE_FAST_SYS_ARCH)
+#define CH_LWIP_USE_FAST_SYS_ARCH       TRUE
+#endif
+
+/* Received frames are processed in batches by the lwIP thread.*/
+#if !defined(LWIP_RX_BATCH_SIZE)
+#define LWIP_RX_BATCH_SIZE              8
+#endif
+
+/* Client and server exchange segments through the loopback path of the
+   interface, without involving the MAC.*/
+#if !defined(LWIP_NETIF_LOOPBACK)
+#define LWIP_NETIF_LOOPBACK             1
+#endif
+
+/* TCP settings sized for full TLS records in flight.*/
+#if !defined(TCP_MSS)
+#define TCP_MSS                         1460
+#endif
+#if !defined(TCP_WND)
+#define TCP_WND                         (8 * TCP_MSS)
+#endif
+#if !defined(TCP_SND_BUF)
+#define TCP_SND_BUF                     (8 * TCP_MSS)
+#endif
+#if !defined(TCP_SND_QUEUELEN)
+#define TCP_SND_QUEUELEN                (4 * TCP_SND_BUF / TCP_MSS)
+#endif
+#if !defined(MEMP_NUM_TCP_SEG)
+#define MEMP_NUM_TCP_SEG                (2 * TCP_SND_QUEUELEN)
+#endif
+#if !defined(MEM_SIZE)
+#define MEM_SIZE                        (4 * TCP_SND_BUF)
+#endif
+
+#endif /* LWIP_HDR_LWIPOPTS_H__ */
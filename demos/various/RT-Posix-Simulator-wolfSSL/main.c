@@ -0,0 +1,295 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "lwipthread.h"
+#include "wolfssl_chibios.h"
+
+#define USE_CERT_BUFFERS_256
+#include <wolfssl/certs_test.h>
+
+/*
+ * Duration of each measurement, the simulator realtime counter has a
+ * resolution of one microsecond.
+ */
+#define BENCH_DURATION          ((rtcnt_t)1000000)
+
+/*
+ * Number of measurements.
+ */
+#define BENCH_ROUNDS            3
+
+/*
+ * TCP port of the TLS server.
+ */
+#define BENCH_PORT              4433
+
+/*
+ * Size of the application data written in a single call.
+ */
+#define BENCH_WRITE_SIZE        4096
+
+/*
+ * Size of the heap used by the reallocation benchmark.
+ */
+#define REALLOC_HEAP_SIZE       65536
+
+/*
+ * Reallocation increment, buffers grow up to REALLOC_STEP * REALLOC_STEPS
+ * bytes.
+ */
+#define REALLOC_STEP            256
+#define REALLOC_STEPS           32
+
+/*
+ * Type of a reallocation function.
+ */
+typedef void *(*realloc_t)(void *p, size_t size);
+
+static memory_heap_t realloc_heap;
+static CH_HEAP_AREA(realloc_heap_area, REALLOC_HEAP_SIZE);
+
+static uint8_t txbuf[BENCH_WRITE_SIZE];
+static uint8_t rxbuf[BENCH_WRITE_SIZE];
+static volatile uint32_t server_bytes;
+static volatile uint32_t server_errors;
+static THD_WORKING_AREA(wa_server, 32768);
+
+/*
+ * TLS server, accepts connections and discards the received data.
+ */
+static THD_FUNCTION(server, arg) {
+  sslconn *listener = (sslconn *)arg;
+
+  chRegSetThreadName("server");
+
+  while (true) {
+    sslconn *sk;
+    int n;
+
+    sk = sslconn_accept(listener);
+    if (sk == NULL) {
+      server_errors++;
+      continue;
+    }
+    while ((n = wolfSSL_read(sk->ssl, rxbuf, sizeof (rxbuf))) > 0) {
+      server_bytes += (uint32_t)n;
+    }
+    sslconn_close(sk);
+  }
+}
+
+/*
+ * Connects and disconnects for the measurement duration, the completed
+ * handshakes are returned.
+ */
+static uint32_t bench_handshakes(sslconn *client, const ip_addr_t *addr) {
+  rtcnt_t start, end;
+  uint32_t n = 0U;
+
+  start = chSysGetRealtimeCounterX();
+  end = start + BENCH_DURATION;
+  while (chSysIsCounterWithinX(chSysGetRealtimeCounterX(), start, end)) {
+    sslconn *sk = sslconn_connect(client, addr, BENCH_PORT);
+
+    if (sk != NULL) {
+      sslconn_close(sk);
+      n++;
+    }
+  }
+
+  return n;
+}
+
+/*
+ * Writes application data on a single connection for the measurement
+ * duration, the written bytes are returned.
+ */
+static uint32_t bench_throughput(sslconn *client, const ip_addr_t *addr) {
+  rtcnt_t start, end;
+  uint32_t n = 0U;
+  sslconn *sk;
+
+  sk = sslconn_connect(client, addr, BENCH_PORT);
+  if (sk == NULL) {
+    return 0U;
+  }
+
+  start = chSysGetRealtimeCounterX();
+  end = start + BENCH_DURATION;
+  while (chSysIsCounterWithinX(chSysGetRealtimeCounterX(), start, end)) {
+    if (wolfSSL_write(sk->ssl, txbuf, sizeof (txbuf)) != (int)sizeof (txbuf)) {
+      break;
+    }
+    n += sizeof (txbuf);
+  }
+  sslconn_close(sk);
+
+  return n;
+}
+
+/*
+ * Reallocation by allocating a new block and copying the data, this is
+ * what the bindings did before chHeapRealloc() was available.
+ */
+static void *realloc_copy(void *p, size_t size) {
+  void *np;
+
+  np = chHeapAlloc(&realloc_heap, size);
+  if (np != NULL) {
+    memcpy(np, p, chHeapGetSize(p));
+    chHeapFree(p);
+  }
+
+  return np;
+}
+
+/*
+ * Two buffers grown alternately step by step, like the wolfSSL input and
+ * output buffers, for the measurement duration. The completed cycles are
+ * returned, zero on failure.
+ */
+static uint32_t bench_realloc(realloc_t fn) {
+  rtcnt_t start, end;
+  uint32_t n = 0U;
+
+  start = chSysGetRealtimeCounterX();
+  end = start + BENCH_DURATION;
+  while (chSysIsCounterWithinX(chSysGetRealtimeCounterX(), start, end)) {
+    void *p[2];
+    unsigned i, j;
+
+    p[0] = chHeapAlloc(&realloc_heap, REALLOC_STEP);
+    p[1] = chHeapAlloc(&realloc_heap, REALLOC_STEP);
+    if ((p[0] == NULL) || (p[1] == NULL)) {
+      return 0U;
+    }
+    for (i = 2U; i <= REALLOC_STEPS; i++) {
+      for (j = 0U; j < 2U; j++) {
+        void *np = fn(p[j], i * REALLOC_STEP);
+
+        if (np == NULL) {
+          return 0U;
+        }
+        p[j] = np;
+      }
+    }
+    chHeapFree(p[0]);
+    chHeapFree(p[1]);
+    n++;
+  }
+
+  return n;
+}
+
+/*------------------------------------------------------------------------*
+ * Simulator main.                                                        *
+ *------------------------------------------------------------------------*/
+int main(void) {
+  sslconn *listener, *client;
+  ip_addr_t addr;
+  unsigned i;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  /*
+   * lwIP initialization with the static configuration, the client connects
+   * to the interface address and segments are looped back by lwIP.
+   */
+  lwipInit(NULL);
+  LWIP_IPADDR(&addr);
+
+  /*
+   * TLS server with an ECC certificate.
+   */
+  listener = sslconn_new(NETCONN_TCP, wolfTLSv1_2_server_method());
+  if ((listener == NULL) ||
+      (wolfSSL_CTX_use_certificate_buffer(listener->ctx, serv_ecc_der_256,
+                                          sizeof (serv_ecc_der_256),
+                                          SSL_FILETYPE_ASN1) != SSL_SUCCESS) ||
+      (wolfSSL_CTX_use_PrivateKey_buffer(listener->ctx, ecc_key_der_256,
+                                         sizeof (ecc_key_der_256),
+                                         SSL_FILETYPE_ASN1) != SSL_SUCCESS) ||
+      (netconn_bind(listener->conn, IP_ADDR_ANY, BENCH_PORT) != ERR_OK) ||
+      (netconn_listen(listener->conn) != ERR_OK)) {
+    printf("*** Server initialization failed\n");
+    return 1;
+  }
+  chThdCreateStatic(wa_server, sizeof (wa_server), NORMALPRIO,
+                    server, listener);
+
+  /*
+   * TLS client, the server certificate is not verified.
+   */
+  client = sslconn_new(NETCONN_TCP, wolfTLSv1_2_client_method());
+  if (client == NULL) {
+    printf("*** Client initialization failed\n");
+    return 1;
+  }
+  wolfSSL_CTX_set_verify(client->ctx, SSL_VERIFY_NONE, NULL);
+
+  memset(txbuf, 0x55, sizeof (txbuf));
+
+  printf("*** ChibiOS/RT wolfSSL loopback benchmark\n");
+  printf("*** Kernel:     %s\n", CH_KERNEL_VERSION);
+  printf("*** Protocol:   TLS 1.2, ECC 256 bits certificate\n");
+  printf("*** Write size: %u bytes\n\n", (unsigned)sizeof (txbuf));
+
+  for (i = 0U; i < BENCH_ROUNDS; i++) {
+    uint32_t n = bench_handshakes(client, &addr);
+
+    printf("--- Handshakes: %u/S\n", (unsigned)n);
+  }
+  for (i = 0U; i < BENCH_ROUNDS; i++) {
+    uint32_t n = bench_throughput(client, &addr);
+
+    printf("--- Throughput: %u.%02u MB/S\n",
+           (unsigned)(n / 1000000U), (unsigned)((n % 1000000U) / 10000U));
+  }
+  printf("--- Received by the server: %u bytes, %u failed accepts\n",
+         (unsigned)server_bytes, (unsigned)server_errors);
+
+  /*
+   * Growing buffers, reallocation in place against allocation and copy.
+   */
+  chHeapObjectInit(&realloc_heap, realloc_heap_area,
+                   sizeof (realloc_heap_area));
+  printf("\n*** Reallocation: 2 buffers, %u to %u bytes\n\n",
+         (unsigned)REALLOC_STEP, (unsigned)(REALLOC_STEP * REALLOC_STEPS));
+  for (i = 0U; i < BENCH_ROUNDS; i++) {
+    uint32_t n1 = bench_realloc(chHeapRealloc);
+    uint32_t n2 = bench_realloc(realloc_copy);
+
+    printf("--- In place: %u cycles/S, copy: %u cycles/S\n",
+           (unsigned)n1, (unsigned)n2);
+  }
+  fflush(stdout);
+
+  return 0;
+}
@@ -31,6 +31,8 @@
 
 #include <stdarg.h>
 
+#include "oop_sequential_stream.h"
+
 /**
  * @brief   Float type support.
  */
@@ -38,6 +40,20 @@
 #define CHSCANF_USE_FLOAT FALSE
 #endif
 
+/**
+ * @brief   Input buffer size.
+ * @details When not zero the input stream is read in blocks of this size
+ *          using @p stmRead() instead of one @p stmGet() per character.
+ * @note    The stream must return a short read when no more data is
+ *          available, like memory streams do, a blocking stream would
+ *          block the scan until the block is filled.
+ * @note    Characters read ahead are returned to the stream using
+ *          @p stmUnget(), the stream must accept multiple ungets.
+ */
+#if !defined(CHSCANF_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define CHSCANF_BUFFER_SIZE 0
+#endif
+
 #if CHSCANF_USE_FLOAT
 #include <math.h>
 #endif
@@ -28,38 +28,118 @@
  */
 
 #include <ctype.h>
+#include <string.h>
 
 #include "hal.h"
 #include "chscanf.h"
-#include "memstreams.h"
 
-static long sym_to_val(char sym, int base)
+/* Value plus one of each character as a digit, zero if not a digit.*/
+static const uint8_t sym_values[256] = {
+  ['0'] = 1,  ['1'] = 2,  ['2'] = 3,  ['3'] = 4,  ['4'] = 5,
+  ['5'] = 6,  ['6'] = 7,  ['7'] = 8,  ['8'] = 9,  ['9'] = 10,
+  ['a'] = 11, ['b'] = 12, ['c'] = 13, ['d'] = 14, ['e'] = 15, ['f'] = 16,
+  ['A'] = 11, ['B'] = 12, ['C'] = 13, ['D'] = 14, ['E'] = 15, ['F'] = 16
+};
+
+/* Input state of a scan operation. Characters are taken from a window,
+   either the string of chvsnscanf() or a block read from the stream, the
+   window is refilled from the stream when empty.*/
+typedef struct {
+  sequential_stream_i *stmp;
+  const uint8_t *start;
+  const uint8_t *p;
+  const uint8_t *end;
+#if CHSCANF_BUFFER_SIZE > 0
+  uint8_t buf[CHSCANF_BUFFER_SIZE];
+#endif
+} chscanf_input_t;
+
+static inline long sym_to_val(int c, int base)
 {
-  sym = tolower(sym);
-  if (sym <= '7' && sym >= '0') {
-    return sym - '0';
+  unsigned v;
+
+  if ((unsigned)c > 255U) {
+    return -1;
   }
-  switch (base) {
-  case 16:
-    if (sym <= 'f' && sym >= 'a') {
-      return (sym - 'a' + 0xa);
+  v = sym_values[c];
+  if ((v == 0U) || (v > (unsigned)base)) {
+    return -1;
+  }
+  return (long)v - 1;
+}
+
+static void in_init(chscanf_input_t *inp, sequential_stream_i *stmp,
+                    const uint8_t *p, size_t n)
+{
+  inp->stmp  = stmp;
+  inp->start = p;
+  inp->p     = p;
+  inp->end   = (n > 0U) ? p + n : p;
+}
+
+static int in_refill(chscanf_input_t *inp)
+{
+  if (inp->stmp == NULL) {
+    return STM_RESET;
+  }
+#if CHSCANF_BUFFER_SIZE > 0
+  {
+    size_t n = stmRead(inp->stmp, inp->buf, CHSCANF_BUFFER_SIZE);
+
+    if (n == 0U) {
+      return STM_RESET;
     }
-    /* fallthrough */
-  case 10:
-    if (sym == '8') {
-      return 8;
+    in_init(inp, inp->stmp, inp->buf, n);
+    return (int)*inp->p++;
+  }
+#else
+  return stmGet(inp->stmp);
+#endif
+}
+
+static inline int in_get(chscanf_input_t *inp)
+{
+  if (inp->p < inp->end) {
+    return (int)*inp->p++;
+  }
+  return in_refill(inp);
+}
+
+static void in_unget(chscanf_input_t *inp, int c)
+{
+  /* The last character is still in the window, if any.*/
+  if (inp->p > inp->start) {
+    if (c != STM_RESET) {
+      inp->p--;
     }
-    if (sym == '9') {
-      return 9;
+    return;
+  }
+  if (inp->stmp != NULL) {
+    (void) stmUnget(inp->stmp, c);
+  }
+}
+
+static void in_done(chscanf_input_t *inp)
+{
+  /* Read-ahead characters are returned to the stream.*/
+  if (inp->stmp != NULL) {
+    while (inp->end > inp->p) {
+      (void) stmUnget(inp->stmp, (int)*--inp->end);
     }
-    /* fallthrough */
-  default:
-    return -1;
   }
 }
 
 #if CHSCANF_USE_FLOAT
 
+/* Powers of ten exactly representable as doubles.*/
+static const double pow10_table[] = {
+  1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/* Largest significand exactly representable as a double.*/
+#define MANT_LIMIT ((uint64_t)1 << 53)
+
 /* Custom mixed-type power function. The internal promotion of the result to a double
    allows for a greater dynamic range than integral types. This function is mostly for
    simplicity, to allow us to do floating point math without either requiring any
@@ -80,35 +160,8 @@ static inline double ch_mpow(double x, unsigned long y)
 
 #endif
 
-/**
- * @brief   System formatted input function.
- * @details This function implements a minimal @p vscanf()-like functionality
- *          with input on a @p BaseSequentialStream.
- *          The general parameters format is: %[*][width][l|L]p
- *          The following parameter types (p) are supported:
- *          - <b>x</b> hexadecimal integer.
- *          - <b>X</b> hexadecimal long.
- *          - <b>o</b> octal integer.
- *          - <b>O</b> octal long.
- *          - <b>d</b> decimal signed integer.
- *          - <b>D</b> decimal signed long.
- *          - <b>u</b> decimal unsigned integer.
- *          - <b>U</b> decimal unsigned long.
- *          - <b>c</b> character.
- *          - <b>s</b> string.
- *          .
- *
- * @param[in] chp       pointer to a @p BufferedStream implementing object
- * @param[in] fmt       formatting string
- * @param[in] ap        list of parameters
- * @return              The number parameters in ap that have been successfully
- *                      filled. This does not conform to the standard in that if
- *                      a failure (either matching or input) occurs before any
- *                      parameters are assigned, the function will return 0.
- *
- * @api
- */
-int chvscanf(sequential_stream_i *stmp, const char *fmt, va_list ap)
+/* Scan operation, the input state is finalized by the caller.*/
+static int chscanf_scan(chscanf_input_t *inp, const char *fmt, va_list ap)
 {
   char  f;
   int   c;
@@ -125,6 +178,8 @@ int chvscanf(sequential_stream_i *stmp, const char *fmt, va_list ap)
   bool   exp_is_positive, initial_digit;
   char*  match;
   int    fixed_point;
+  uint64_t mant;
+  bool   mant_exact, has_exp;
 #endif
 
   /* Peek the first character of the format string. If it is null,
@@ -138,7 +193,7 @@ int chvscanf(sequential_stream_i *stmp, const char *fmt, va_list ap)
      (no peek function for the stream means an extra character is taken out every iteration of the
      loop, so each loop iteration uses the value of c from the last one. However, the first iteration
      has no value to work with, so we initialize it here) */
-  c = stmGet(stmp);
+  c = in_get(inp);
 
   while (c != STM_RESET && f != 0) {
 
@@ -150,7 +205,7 @@ int chvscanf(sequential_stream_i *stmp, const char *fmt, va_list ap)
 
     if (isspace(f)) {
       while (isspace(c)) {
-        c = stmGet(stmp);
+        c = in_get(inp);
       }
       f = *fmt++;
       continue;
@@ -160,7 +215,7 @@ int chvscanf(sequential_stream_i *stmp, const char *fmt, va_list ap)
       if (f != c) {
         break;
       } else {
-        c = stmGet(stmp);
+        c = in_get(inp);
         f = *fmt++;
         continue;
       }
@@ -173,7 +228,7 @@ int chvscanf(sequential_stream_i *stmp, const char *fmt, va_list ap)
       if (f != c) {
         break;
       } else {
-        c = stmGet(stmp);
+        c = in_get(inp);
         f = *fmt++;
         continue;
       }
@@ -220,7 +275,7 @@ int chvscanf(sequential_stream_i *stmp, const char *fmt, va_list ap)
         if (buf) {
           ((char*)buf)[i] = c;
         }
-        c = stmGet(stmp);
+        c = in_get(inp);
         if (c == STM_RESET) {
           return n;
         }
@@ -232,7 +287,7 @@ int chvscanf(sequential_stream_i *stmp, const char *fmt, va_list ap)
     case 's':
       /* S specifier discards leading whitespace */
       while (isspace(c)) {
-        c = stmGet(stmp);
+        c = in_get(inp);
         if (c == STM_RESET) {
           return n;
         }
@@ -254,7 +309,7 @@ int chvscanf(sequential_stream_i *stmp, const char *fmt, va_list ap)
         if (buf) {
           ((char*)buf)[i] = c;
         }
-        c = stmGet(stmp);
+        c = in_get(inp);
         if (c == STM_RESET) {
           return n;
         }
@@ -276,22 +331,27 @@ int chvscanf(sequential_stream_i *stmp, const char *fmt, va_list ap)
       exp_base      = 10;
       fixed_point   = 0;
       initial_digit = false;
+      mant          = 0U;
+      mant_exact    = true;
+      has_exp       = false;
+      exp_is_positive = true;
+      exp           = 0;
       while (isspace(c)) {
-        c = stmGet(stmp);
+        c = in_get(inp);
       }
 
       if (c == '+') {
         if (--width == 0) {
           return n;
         }
-        c = stmGet(stmp);
+        c = in_get(inp);
 
       } else if (c == '-') {
         if (--width == 0) {
           return n;
         }
         is_positive = false;
-        c           = stmGet(stmp);
+        c           = in_get(inp);
       }
 
       /* Special cases: a float can be INF(INITY) or NAN. As a note about this behavior:
@@ -311,20 +371,20 @@ int chvscanf(sequential_stream_i *stmp, const char *fmt, va_list ap)
       */
 
       if (tolower(c) == 'n') {
-        c = stmGet(stmp);
+        c = in_get(inp);
 
         match = "an";
         while (*match != 0) {
           if (*match != tolower(c)) {
-            stmUnget(chp, c);
+            in_unget(inp, c);
             return n;
           }
           if (--width == 0) {
-            stmUnget(chp, c);
+            in_unget(inp, c);
             return n;
           }
           ++match;
-          c = stmGet(stmp);
+          c = in_get(inp);
         }
 
         valf = NAN;
@@ -332,18 +392,18 @@ int chvscanf(sequential_stream_i *stmp, const char *fmt, va_list ap)
       }
 
       if (tolower(c) == 'i') {
-        c = stmGet(stmp);
+        c = in_get(inp);
 
         match = "nf";
         while (*match != 0) {
           if (*match != tolower(c)) {
-            stmUnget(chp, c);
+            in_unget(inp, c);
             return n;
           }
           ++match;
-          c = stmGet(stmp);
+          c = in_get(inp);
           if (--width == 0) {
-            stmUnget(chp, c);
+            in_unget(inp, c);
             return n;
           }
         }
@@ -359,14 +419,14 @@ int chvscanf(sequential_stream_i *stmp, const char *fmt, va_list ap)
           if (--width == 0) {
             break;
           }
-          c = stmGet(stmp);
+          c = in_get(inp);
         }
 
         goto float_common;
       }
 
       if (c == '0') {
-        c = stmGet(stmp);
+        c = in_get(inp);
         if (--width == 0) {
           valf = 0;
           goto float_common;
@@ -376,9 +436,9 @@ int chvscanf(sequential_stream_i *stmp, const char *fmt, va_list ap)
           base     = 16;
           exp_char = 'p';
           exp_base = 2;
-          c        = stmGet(stmp);
+          c        = in_get(inp);
           if (--width == 0) {
-            stmUnget(chp, c);
+            in_unget(inp, c);
             return n;
           }
         } else {
@@ -390,17 +450,27 @@ int chvscanf(sequential_stream_i *stmp, const char *fmt, va_list ap)
         valf = 0;
       }
 
+      /* The significand is accumulated as an integer while it is exactly
+         representable, then as a double like before.*/
       while (width--) {
         digit = sym_to_val(c, base);
         if (digit == -1) {
           break;
         }
-        valf = (valf * base) + (double)digit;
-        c    = stmGet(stmp);
+        if (mant_exact && (mant < MANT_LIMIT / 16U)) {
+          mant = (mant * (unsigned)base) + (uint64_t)digit;
+        } else {
+          if (mant_exact) {
+            valf       = (double)mant;
+            mant_exact = false;
+          }
+          valf = (valf * base) + (double)digit;
+        }
+        c = in_get(inp);
       }
 
       if (c == '.') {
-        c = stmGet(stmp);
+        c = in_get(inp);
 
         while (width--) {
           digit = sym_to_val(c, base);
@@ -410,39 +480,48 @@ int chvscanf(sequential_stream_i *stmp, const char *fmt, va_list ap)
           if (valf == -1) {
             valf = 0;
           }
-          valf = (valf * base) + (double)digit;
+          if (mant_exact && (mant < MANT_LIMIT / 16U)) {
+            mant = (mant * (unsigned)base) + (uint64_t)digit;
+          } else {
+            if (mant_exact) {
+              valf       = (double)mant;
+              mant_exact = false;
+            }
+            valf = (valf * base) + (double)digit;
+          }
           ++fixed_point;
-          c = stmGet(stmp);
+          c = in_get(inp);
         }
       }
 
       if (valf == -1.0) {
-        stmUnget(chp, c);
+        in_unget(inp, c);
         return n;
       }
 
-      valf = valf / ch_mpow(base, fixed_point);
+      if (mant_exact) {
+        valf = (double)mant;
+      }
 
       if (tolower(c) == exp_char) {
         if (width-- == 0) {
           return n;
         }
-        c               = stmGet(stmp);
-        exp_is_positive = true;
-        exp             = 0;
+        c       = in_get(inp);
+        has_exp = true;
 
         if (c == '+') {
           if (width-- == 0) {
             return n;
           }
-          c = stmGet(stmp);
+          c = in_get(inp);
 
         } else if (c == '-') {
           if (width-- == 0) {
             return n;
           }
           exp_is_positive = false;
-          c               = stmGet(stmp);
+          c               = in_get(inp);
         }
         /*
          "When parsing an incomplete floating-point value that ends in the exponent with no digits,
@@ -453,7 +532,7 @@ int chvscanf(sequential_stream_i *stmp, const char *fmt, va_list ap)
         */
         digit = sym_to_val(c, 10);
         if (digit == -1) {
-          stmUnget(chp, c);
+          in_unget(inp, c);
           return n;
         }
         while (width--) {
@@ -463,8 +542,29 @@ int chvscanf(sequential_stream_i *stmp, const char *fmt, va_list ap)
             break;
           }
           exp = (exp * 10) + digit;
-          c   = stmGet(stmp);
+          c   = in_get(inp);
+        }
+      }
+
+      /* Fast path, an exact significand scaled by an exact power of ten
+         is correctly rounded by a single operation, assuming the FPU
+         evaluates doubles in double precision.*/
+      if (mant_exact && (base == 10) &&
+          (exp <= 22) && (fixed_point <= 22)) {
+        long e = (exp_is_positive ? exp : -exp) - fixed_point;
+
+        if ((e >= 0) && (e <= 22)) {
+          valf = valf * pow10_table[e];
+          goto float_common;
+        }
+        if ((e < 0) && (e >= -22)) {
+          valf = valf / pow10_table[-e];
+          goto float_common;
         }
+      }
+
+      valf = valf / ch_mpow(base, fixed_point);
+      if (has_exp) {
         if (exp_is_positive) {
           valf = valf * (double)ch_mpow(exp_base, exp);
         } else {
@@ -494,33 +594,33 @@ int chvscanf(sequential_stream_i *stmp, const char *fmt, va_list ap)
     case 'I':
       /* I specifier discards leading whitespace */
       while (isspace(c)) {
-        c = stmGet(stmp);
+        c = in_get(inp);
       }
       /* The char might be +, might be -, might be 0, or might be something else */
       if (c == '+') {
         if (--width == 0) {
           return n;
         }
-        c = stmGet(stmp);
+        c = in_get(inp);
       } else if (c == '-') {
         if (--width == 0) {
           return n;
         }
         is_positive = false;
-        c           = stmGet(stmp);
+        c           = in_get(inp);
       }
 
       if (c == '0') {
         if (--width == 0) {
           return ++n;
         }
-        c = stmGet(stmp);
+        c = in_get(inp);
         if (c == 'x' || c == 'X') {
           base = 16;
           if (--width == 0) {
             return n;
           }
-          c = stmGet(stmp);
+          c = in_get(inp);
 
         } else {
           base = 8;
@@ -531,20 +631,20 @@ int chvscanf(sequential_stream_i *stmp, const char *fmt, va_list ap)
     case 'd':
     case 'D':
       while (isspace(c)) {
-        c = stmGet(stmp);
+        c = in_get(inp);
       }
       if (c == '+') {
         if (--width == 0) {
           return n;
         }
-        c = stmGet(stmp);
+        c = in_get(inp);
 
       } else if (c == '-') {
         if (--width == 0) {
           return n;
         }
         is_positive = false;
-        c           = stmGet(stmp);
+        c           = in_get(inp);
       }
       break;
     case 'X':
@@ -554,30 +654,30 @@ int chvscanf(sequential_stream_i *stmp, const char *fmt, va_list ap)
       is_signed = false;
       base      = 16;
       while (isspace(c)) {
-        c = stmGet(stmp);
+        c = in_get(inp);
       }
       if (c == '+') {
         if (--width == 0) {
           return n;
         }
-        c = stmGet(stmp);
+        c = in_get(inp);
       } else if (c == '-') {
         if (--width == 0) {
           return n;
         }
         is_positive = false;
-        c           = stmGet(stmp);
+        c           = in_get(inp);
       }
       if (c == '0') {
         if (--width == 0) {
           return ++n;
         }
-        c = stmGet(stmp);
+        c = in_get(inp);
         if (c == 'x' || c == 'X') {
           if (--width == 0) {
             return n;
           }
-          c = stmGet(stmp);
+          c = in_get(inp);
         }
       }
       break;
@@ -585,19 +685,19 @@ int chvscanf(sequential_stream_i *stmp, const char *fmt, va_list ap)
     case 'u':
       is_signed = false;
       while (isspace(c)) {
-        c = stmGet(stmp);
+        c = in_get(inp);
       }
       if (c == '+') {
         if (--width == 0) {
           return n;
         }
-        c = stmGet(stmp);
+        c = in_get(inp);
       } else if (c == '-') {
         if (--width == 0) {
           return n;
         }
         is_positive = false;
-        c           = stmGet(stmp);
+        c           = in_get(inp);
       }
       break;
     case 'O':
@@ -605,25 +705,25 @@ int chvscanf(sequential_stream_i *stmp, const char *fmt, va_list ap)
       is_signed = false;
       base      = 8;
       while (isspace(c)) {
-        c = stmGet(stmp);
+        c = in_get(inp);
       }
 
       if (c == '+') {
         if (--width == 0) {
           return n;
         }
-        c = stmGet(stmp);
+        c = in_get(inp);
       } else if (c == '-') {
         if (--width == 0) {
           return n;
         }
         is_positive = false;
-        c           = stmGet(stmp);
+        c           = in_get(inp);
       }
 
       break;
     default:
-      stmUnget(stmp, c);
+      in_unget(inp, c);
       return n;
     }
 
@@ -640,7 +740,7 @@ int chvscanf(sequential_stream_i *stmp, const char *fmt, va_list ap)
         break;
       }
       vall = (vall * base) + digit;
-      c    = stmGet(stmp);
+      c    = in_get(inp);
     }
 
     if (!is_positive) {
@@ -661,7 +761,51 @@ int chvscanf(sequential_stream_i *stmp, const char *fmt, va_list ap)
     f = *fmt++;
     ++n;
   }
-  stmUnget(stmp, c);
+  in_unget(inp, c);
+  return n;
+}
+
+/**
+ * @brief   System formatted input function.
+ * @details This function implements a minimal @p vscanf()-like functionality
+ *          with input on a @p BaseSequentialStream.
+ *          The general parameters format is: %[*][width][l|L]p
+ *          The following parameter types (p) are supported:
+ *          - <b>x</b> hexadecimal integer.
+ *          - <b>X</b> hexadecimal long.
+ *          - <b>o</b> octal integer.
+ *          - <b>O</b> octal long.
+ *          - <b>d</b> decimal signed integer.
+ *          - <b>D</b> decimal signed long.
+ *          - <b>u</b> decimal unsigned integer.
+ *          - <b>U</b> decimal unsigned long.
+ *          - <b>c</b> character.
+ *          - <b>s</b> string.
+ *          .
+ *
+ * @note    When @p CHSCANF_BUFFER_SIZE is not zero the input is read in
+ *          blocks, characters read ahead and not consumed are returned
+ *          to the stream using @p stmUnget().
+ *
+ * @param[in] stmp      pointer to a @p sequential_stream_i object
+ * @param[in] fmt       formatting string
+ * @param[in] ap        list of parameters
+ * @return              The number parameters in ap that have been successfully
+ *                      filled. This does not conform to the standard in that if
+ *                      a failure (either matching or input) occurs before any
+ *                      parameters are assigned, the function will return 0.
+ *
+ * @api
+ */
+int chvscanf(sequential_stream_i *stmp, const char *fmt, va_list ap)
+{
+  chscanf_input_t in;
+  int             n;
+
+  in_init(&in, stmp, NULL, 0U);
+  n = chscanf_scan(&in, fmt, ap);
+  in_done(&in);
+
   return n;
 }
 
@@ -683,7 +827,7 @@ int chvscanf(sequential_stream_i *stmp, const char *fmt, va_list ap)
  *          - <b>s</b> string.
  *          .
  *
- * @param[in] chp       pointer to a @p BufferedStream implementing object
+ * @param[in] stmp      pointer to a @p sequential_stream_i object
  * @param[in] fmt       formatting string
  * @return              The number parameters in ap that have been successfully
  *                      filled. This does not conform to the standard in that if
@@ -775,21 +919,15 @@ int chsnscanf(char *str, size_t size, const char *fmt, ...)
  */
 int chvsnscanf(char *str, size_t size, const char *fmt, va_list ap)
 {
-  memory_stream_c ms;
-  size_t          size_wo_nul;
-
-  if (size > 0)
-    size_wo_nul = size - 1;
-  else
-    size_wo_nul = 0;
+  chscanf_input_t in;
 
-  /* Memory stream object to be used as a string writer, reserving one
-     byte for the final zero.*/
-  memstmObjectInit(&ms, (uint8_t*)str, size_wo_nul, 0U);
+  /* The string is scanned in place up to the final zero or the end of
+     the buffer.*/
+  in_init(&in, NULL, (const uint8_t *)str, strnlen(str, size));
 
   /* Performing the scan operation using the common code and
      return number of receiving arguments successfully assigned.*/
-  return chvscanf(oopGetIf(&ms, stm), fmt, ap);
+  return chscanf_scan(&in, fmt, ap);
 }
 
 /** @} */
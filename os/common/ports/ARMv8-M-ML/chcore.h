@@ -196,6 +196,11 @@
  */
 #define PORT_SUPPORTS_RT                TRUE
 
+/**
+ * @brief   This port supports atomic compare-and-swap on counters.
+ */
+#define PORT_SUPPORTS_ATOMICS           TRUE
+
 /**
  * @brief   Natural alignment constant.
  * @note    It is the minimum alignment for pointer-size variables.
@@ -709,6 +714,40 @@ extern "C" {
    return DWT->CYCCNT;
  }
 
+ /**
+  * @brief   Atomic compare-and-swap on a counter.
+  * @note    Implemented using the exclusive access instructions, it can fail
+  *          spuriously so it is meant to be used in retry loops.
+  *
+  * @param[in,out] p     pointer to the counter
+  * @param[in] expected  expected counter value
+  * @param[in] desired   new counter value
+  * @return              The operation result.
+  * @retval false        if the counter did not match or the exclusive access
+  *                      has been lost.
+  * @retval true         if the counter has been updated.
+  */
+ __STATIC_FORCEINLINE bool port_atomic_cas(volatile cnt_t *p,
+                                           cnt_t expected, cnt_t desired) {
+
+   if ((cnt_t)__LDREXW((volatile uint32_t *)p) != expected) {
+     __CLREX();
+     return false;
+   }
+
+   return __STREXW((uint32_t)desired, (volatile uint32_t *)p) == 0U;
+ }
+
+ /**
+  * @brief   Full memory barrier.
+  * @details Orders memory accesses performed before the barrier with respect
+  *          to the accesses performed after it.
+  */
+ __STATIC_FORCEINLINE void port_atomic_barrier(void) {
+
+   __DMB();
+ }
+
 #endif /* !defined(_FROM_ASM_) */
 
 /*===========================================================================*/
@@ -0,0 +1,239 @@
+/*
+    ChibiOS - Copyright (C) 2006,2007,2008,2009,2010,2011,2012,2013,2014,
+              2015,2016,2017,2018,2019,2020,2021 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation version 3 of the License.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    SIMHOST/chcore.c
+ * @brief   Deterministic host port code.
+ *
+ * @addtogroup SIMHOST_GCC_CORE
+ * @{
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ch.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+#if defined(__APPLE__)
+#define SIM_SYMBOL(s)   "_" #s
+#else
+#define SIM_SYMBOL(s)   #s
+#endif
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+bool port_isr_context_flag;
+syssts_t port_irq_sts;
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Virtual realtime counter.
+ */
+static rttime_t sim_cycles;
+
+/**
+ * @brief   Realtime counter value of the next system tick.
+ */
+static rttime_t sim_next_tick = (rttime_t)PORT_SIM_CYCLES_PER_TICK;
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+#if (PORT_SIM_USE_UCONTEXT == FALSE) || defined(__DOXYGEN__)
+/*
+ * Context switch and threads entry point. The callee-saved registers are
+ * pushed on the stack of the thread being switched out, the stack pointer
+ * is stored in its context structure.
+ */
+asm (".text                                                  \n\t"
+     ".globl " SIM_SYMBOL(_port_switch) "                    \n\t"
+     SIM_SYMBOL(_port_switch) ":                             \n\t"
+     "push    %rbp                                           \n\t"
+     "push    %rbx                                           \n\t"
+     "push    %r12                                           \n\t"
+     "push    %r13                                           \n\t"
+     "push    %r14                                           \n\t"
+     "push    %r15                                           \n\t"
+     "movq    %rsp, (%rsi)                                   \n\t"
+     "movq    %rdi, %rsp                                     \n\t"
+     "pop     %r15                                           \n\t"
+     "pop     %r14                                           \n\t"
+     "pop     %r13                                           \n\t"
+     "pop     %r12                                           \n\t"
+     "pop     %rbx                                           \n\t"
+     "pop     %rbp                                           \n\t"
+     "ret                                                    \n\t"
+     ".globl " SIM_SYMBOL(_port_thread_trampoline) "         \n\t"
+     SIM_SYMBOL(_port_thread_trampoline) ":                  \n\t"
+     "movq    %r12, %rdi                                     \n\t"
+     "movq    %r13, %rsi                                     \n\t"
+     "call    " SIM_SYMBOL(_port_thread_start) "             \n\t");
+
+#else /* PORT_SIM_USE_UCONTEXT == TRUE */
+/**
+ * @brief   Entry point of threads created by @p _port_setup_context().
+ */
+static void sim_thread_entry(void) {
+  thread_t *tp = chThdGetSelfX();
+
+  _port_thread_start(tp->ctx.pf, tp->ctx.arg);
+}
+#endif /* PORT_SIM_USE_UCONTEXT == TRUE */
+
+/**
+ * @brief   Generates a system tick.
+ * @details The virtual realtime counter is moved to the tick time if it
+ *          is not already past it.
+ */
+static void sim_tick(void) {
+
+  if (sim_cycles < sim_next_tick) {
+    sim_cycles = sim_next_tick;
+  }
+  sim_next_tick += (rttime_t)PORT_SIM_CYCLES_PER_TICK;
+
+  CH_IRQ_PROLOGUE();
+
+  chSysLockFromISR();
+  chSysTimerHandlerI();
+  chSysUnlockFromISR();
+
+  CH_IRQ_EPILOGUE();
+
+  __dbg_check_lock();
+  if (chSchIsPreemptionRequired()) {
+    chSchDoPreemption();
+  }
+  __dbg_check_unlock();
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+#if (PORT_SIM_USE_UCONTEXT == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Prepares the context of a new thread.
+ *
+ * @param[out] ctxp     the thread context
+ * @param[in] wbase     base of the thread stack
+ * @param[in] wtop      top of the thread stack
+ * @param[in] pf        the thread function
+ * @param[in] arg       the thread function argument
+ */
+void _port_setup_context(struct port_context *ctxp, void *wbase, void *wtop,
+                         void (*pf)(void *p), void *arg) {
+
+  if (getcontext(&ctxp->intctx.uc) != 0) {
+    chSysHalt("getcontext failure");
+  }
+  ctxp->intctx.uc.uc_stack.ss_sp   = wbase;
+  ctxp->intctx.uc.uc_stack.ss_size = (size_t)((uint8_t *)wtop -
+                                              (uint8_t *)wbase);
+  ctxp->intctx.uc.uc_link          = NULL;
+  ctxp->pf                         = pf;
+  ctxp->arg                        = arg;
+  makecontext(&ctxp->intctx.uc, sim_thread_entry, 0);
+}
+#endif /* PORT_SIM_USE_UCONTEXT == TRUE */
+
+/**
+ * @brief   Start a thread by invoking its work function.
+ * @details If the work function returns @p chThdExit() is automatically
+ *          invoked.
+ */
+void _port_thread_start(void (*pf)(void *p), void *p) {
+
+  chSysUnlock();
+  pf(p);
+  chThdExit(0);
+  while (true) {
+  }
+}
+
+/**
+ * @brief   Returns the current value of the realtime counter.
+ * @note    Each read advances the virtual counter by one cycle so that
+ *          loops polling the counter always terminate.
+ *
+ * @return              The realtime counter value.
+ */
+rtcnt_t port_rt_get_counter_value(void) {
+
+  return (rtcnt_t)++sim_cycles;
+}
+
+/**
+ * @brief   Interrupt simulation.
+ * @details The virtual realtime counter is advanced by one cycle, a system
+ *          tick is generated when the next tick time is reached.
+ */
+void _sim_check_for_interrupts(void) {
+
+  if (++sim_cycles >= sim_next_tick) {
+    sim_tick();
+  }
+}
+
+/**
+ * @brief   Advances the virtual time.
+ * @details The specified number of system ticks is generated, the threads
+ *          made ready by each tick preempt the caller if they have higher
+ *          priority.
+ * @note    Called by the idle thread with one tick, so threads waiting for
+ *          a timeout are served without delay.
+ *
+ * @param[in] ticks     number of system ticks
+ */
+void _sim_advance_time(sysinterval_t ticks) {
+
+  while (ticks > (sysinterval_t)0) {
+    sim_tick();
+    ticks--;
+  }
+}
+
+/**
+ * @brief   Terminates the host process.
+ * @note    Meant to be invoked from @p CH_CFG_SYSTEM_HALT_HOOK().
+ *
+ * @param[in] reason    the halt reason
+ */
+void _sim_halt(const char *reason) {
+
+  fflush(stdout);
+  fprintf(stderr, "system halted: %s\n", reason != NULL ? reason : "");
+  exit(2);
+}
+
+/** @} */
@@ -0,0 +1,571 @@
+/*
+    ChibiOS - Copyright (C) 2006,2007,2008,2009,2010,2011,2012,2013,2014,
+              2015,2016,2017,2018,2019,2020,2021 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation version 3 of the License.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    SIMHOST/chcore.h
+ * @brief   Deterministic host port macros and structures.
+ * @details The kernel is compiled natively for the host, time is virtual
+ *          and only advances when interrupts are checked, when the idle
+ *          thread runs or when the application requests it using
+ *          @p _sim_advance_time(). No host signals or timers are used so
+ *          the execution is reproducible.
+ *
+ * @addtogroup SIMHOST_GCC_CORE
+ * @{
+ */
+
+#ifndef CHCORE_H
+#define CHCORE_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Port Capabilities and Constants
+ * @{
+ */
+/**
+ * @brief   This port supports a realtime counter.
+ * @note    The counter is virtual, it counts the interrupt checks.
+ */
+#define PORT_SUPPORTS_RT                TRUE
+
+/**
+ * @brief   The realtime counter is a virtual clock.
+ * @details Durations measured using the realtime counter do not reflect the
+ *          execution time, test cases measuring latencies are skipped.
+ */
+#define PORT_SIM_VIRTUAL_CLOCK          TRUE
+
+/**
+ * @brief   This port supports atomic compare-and-swap on counters.
+ */
+#define PORT_SUPPORTS_ATOMICS           TRUE
+
+/**
+ * @brief   Natural alignment constant.
+ * @note    It is the minimum alignment for pointer-size variables.
+ */
+#define PORT_NATURAL_ALIGN              sizeof (void *)
+
+/**
+ * @brief   Stack alignment constant.
+ * @note    It is the alignment required for the stack pointer.
+ */
+#define PORT_STACK_ALIGN                sizeof (stkalign_t)
+
+/**
+ * @brief   Working Areas alignment constant.
+ * @note    It is the alignment to be enforced for thread working areas.
+ */
+#define PORT_WORKING_AREA_ALIGN         sizeof (stkalign_t)
+
+/**
+ * @brief   Simulated SMP mode.
+ * @note    Not supported by this port.
+ */
+#define PORT_SIM_SMP                    FALSE
+/** @} */
+
+/**
+ * @name    Architecture and Compiler
+ * @{
+ */
+/**
+ * Macro defining the host architecture.
+ */
+#define PORT_ARCHITECTURE_SIMHOST
+
+/**
+ * Name of the implemented architecture.
+ */
+#define PORT_ARCHITECTURE_NAME          "Host"
+
+/**
+ * @brief   Name of the compiler supported by this port.
+ */
+#define PORT_COMPILER_NAME              "GCC " __VERSION__
+
+/**
+ * @brief   Port-specific information string.
+ */
+#define PORT_INFO                       "No preemption, virtual time"
+/** @} */
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Stack size for the system idle thread.
+ * @details This size depends on the idle thread implementation, usually
+ *          the idle thread should take no more space than those reserved
+ *          by @p PORT_INT_REQUIRED_STACK.
+ */
+#if !defined(PORT_IDLE_THREAD_STACK_SIZE) || defined(__DOXYGEN__)
+#define PORT_IDLE_THREAD_STACK_SIZE     256
+#endif
+
+/**
+ * @brief   Per-thread stack overhead for interrupts servicing.
+ * @details This constant is used in the calculation of the correct working
+ *          area size.
+ * @note    Host library functions are called from threads, the stack
+ *          must be large enough for them.
+ */
+#if !defined(PORT_INT_REQUIRED_STACK) || defined(__DOXYGEN__)
+#define PORT_INT_REQUIRED_STACK         32768
+#endif
+
+/**
+ * @brief   Realtime counter cycles in a system tick.
+ * @details Each interrupt check and each realtime counter read advance the
+ *          virtual realtime counter by one cycle, a system tick is
+ *          generated every @p PORT_SIM_CYCLES_PER_TICK cycles. Busy loops
+ *          polling the system time are then executed a fixed number of
+ *          times.
+ */
+#if !defined(PORT_SIM_CYCLES_PER_TICK) || defined(__DOXYGEN__)
+#define PORT_SIM_CYCLES_PER_TICK        1000
+#endif
+
+/**
+ * @brief   Context switch implementation.
+ * @details If @p TRUE the context switch uses the host @p ucontext API
+ *          else a faster assembler implementation, the assembler one is
+ *          only available on x86-64 hosts.
+ */
+#if !defined(PORT_SIM_USE_UCONTEXT) || defined(__DOXYGEN__)
+#if defined(__x86_64__)
+#define PORT_SIM_USE_UCONTEXT           FALSE
+#else
+#define PORT_SIM_USE_UCONTEXT           TRUE
+#endif
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if CH_DBG_ENABLE_STACK_CHECK
+#error "option CH_DBG_ENABLE_STACK_CHECK not supported by this port"
+#endif
+
+#if CH_CFG_ST_TIMEDELTA > 0
+#error "tick-less mode not supported by this port"
+#endif
+
+#if defined(CH_CFG_SMP_MODE) && (CH_CFG_SMP_MODE == TRUE)
+#error "SMP mode not supported by this port"
+#endif
+
+#if PORT_SIM_CYCLES_PER_TICK < 1
+#error "invalid PORT_SIM_CYCLES_PER_TICK value"
+#endif
+
+#if (PORT_SIM_USE_UCONTEXT == FALSE) && !defined(__x86_64__)
+#error "assembler context switch only available on x86-64 hosts"
+#endif
+
+/**
+ * @brief   Name of the architecture variant (optional).
+ */
+#if (PORT_SIM_USE_UCONTEXT == FALSE) || defined(__DOXYGEN__)
+#define PORT_CORE_VARIANT_NAME          "x86-64"
+#else
+#define PORT_CORE_VARIANT_NAME          "ucontext"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/* The following code is not processed when the file is included from an
+   asm module.*/
+#if !defined(_FROM_ASM_)
+
+#if PORT_SIM_USE_UCONTEXT == TRUE
+#include <ucontext.h>
+#endif
+
+/**
+ * @brief   16 bytes stack and memory alignment enforcement.
+ */
+typedef struct {
+  uint8_t a[16];
+} stkalign_t __attribute__((aligned(16)));
+
+/**
+ * @brief   Interrupt saved context.
+ * @details This structure represents the stack frame saved during a
+ *          preemption-capable interrupt handler.
+ */
+struct port_extctx {
+};
+
+#if (PORT_SIM_USE_UCONTEXT == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   System saved context.
+ * @details This structure represents the inner stack frame during a context
+ *          switch, the callee-saved registers of the host ABI.
+ */
+struct port_intctx {
+  void    *r15;
+  void    *r14;
+  void    *r13;
+  void    *r12;
+  void    *rbx;
+  void    *rbp;
+  void    *rip;
+};
+
+/**
+ * @brief   Platform dependent part of the @p thread_t structure.
+ * @details This structure usually contains just the saved stack pointer
+ *          defined as a pointer to a @p port_intctx structure.
+ */
+struct port_context {
+  struct port_intctx *sp;
+};
+#else /* PORT_SIM_USE_UCONTEXT == TRUE */
+struct port_intctx {
+  ucontext_t        uc;
+};
+
+struct port_context {
+  struct port_intctx intctx;
+  void              (*pf)(void *p);
+  void              *arg;
+};
+#endif /* PORT_SIM_USE_UCONTEXT == TRUE */
+
+#endif /* !defined(_FROM_ASM_) */
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Platform dependent part of the @p chThdCreateI() API.
+ * @details This code usually setup the context switching frame represented
+ *          by an @p port_intctx structure.
+ * @note    The thread function and its argument are kept in @p r12 and
+ *          @p r13, the frame is placed so that the stack is aligned as
+ *          required by the ABI when @p _port_thread_start() is called.
+ */
+#if (PORT_SIM_USE_UCONTEXT == FALSE) || defined(__DOXYGEN__)
+#define PORT_SETUP_CONTEXT(tp, wbase, wtop, pf, arg) {                      \
+  struct port_intctx *ctxp;                                                 \
+                                                                            \
+  ctxp = (struct port_intctx *)(void *)((uint8_t *)(wtop) - 16U -           \
+                                        sizeof (struct port_intctx));       \
+  ctxp->r15 = NULL;                                                         \
+  ctxp->r14 = NULL;                                                         \
+  ctxp->r13 = (void *)(arg);                                                \
+  ctxp->r12 = (void *)(pf);                                                 \
+  ctxp->rbx = NULL;                                                         \
+  ctxp->rbp = NULL;                                                         \
+  ctxp->rip = (void *)_port_thread_trampoline;                              \
+  (tp)->ctx.sp = ctxp;                                                      \
+}
+#else
+#define PORT_SETUP_CONTEXT(tp, wbase, wtop, pf, arg)                        \
+  _port_setup_context(&(tp)->ctx, (void *)(wbase), (void *)(wtop),          \
+                      (void (*)(void *))(pf), (void *)(arg))
+#endif
+
+/**
+ * @brief   Computes the thread working area global size.
+ * @note    There is no need to perform alignments in this macro.
+ */
+#define PORT_WA_SIZE(n) ((sizeof (void *) * 8U) + 16U +                     \
+                         ((size_t)(n)) +                                    \
+                         ((size_t)(PORT_INT_REQUIRED_STACK)))
+
+/**
+ * @brief   Static working area allocation.
+ * @details This macro is used to allocate a static thread working area
+ *          aligned as both position and size.
+ *
+ * @param[in] s         the name to be assigned to the stack array
+ * @param[in] n         the stack size to be assigned to the thread
+ */
+#define PORT_WORKING_AREA(s, n)                                             \
+  stkalign_t s[THD_WORKING_AREA_SIZE(n) / sizeof (stkalign_t)]
+
+/**
+ * @brief   Priority level verification macro.
+ */
+#define PORT_IRQ_IS_VALID_PRIORITY(n) false
+
+/**
+ * @brief   Priority level verification macro.
+ */
+#define PORT_IRQ_IS_VALID_KERNEL_PRIORITY(n) false
+
+/**
+ * @brief   IRQ prologue code.
+ * @details This macro must be inserted at the start of all IRQ handlers
+ *          enabled to invoke system APIs.
+ */
+#define PORT_IRQ_PROLOGUE() {                                               \
+  port_isr_context_flag = true;                                             \
+}
+
+/**
+ * @brief   IRQ epilogue code.
+ * @details This macro must be inserted at the end of all IRQ handlers
+ *          enabled to invoke system APIs.
+ */
+#define PORT_IRQ_EPILOGUE() {                                               \
+  port_isr_context_flag = false;                                            \
+}
+
+/**
+ * @brief   IRQ handler function declaration.
+ * @note    @p id can be a function name or a vector number depending on the
+ *          port implementation.
+ */
+#ifdef __cplusplus
+#define PORT_IRQ_HANDLER(id) extern "C" void id(void)
+#else
+#define PORT_IRQ_HANDLER(id) void id(void)
+#endif
+
+/**
+ * @brief   Fast IRQ handler function declaration.
+ * @note    @p id can be a function name or a vector number depending on the
+ *          port implementation.
+ */
+#ifdef __cplusplus
+#define PORT_FAST_IRQ_HANDLER(id) extern "C" void id(void)
+#else
+#define PORT_FAST_IRQ_HANDLER(id) void id(void)
+#endif
+
+/**
+ * @brief   Performs a context switch between two threads.
+ *
+ * @param[in] ntp       the thread to be switched in
+ * @param[in] otp       the thread to be switched out
+ */
+#if (PORT_SIM_USE_UCONTEXT == FALSE) || defined(__DOXYGEN__)
+#define port_switch(ntp, otp) _port_switch((ntp)->ctx.sp, &(otp)->ctx.sp)
+#else
+#define port_switch(ntp, otp)                                               \
+  (void)swapcontext(&(otp)->ctx.intctx.uc, &(ntp)->ctx.intctx.uc)
+#endif
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+/* The following code is not processed when the file is included from an
+   asm module.*/
+#if !defined(_FROM_ASM_)
+
+extern bool port_isr_context_flag;
+extern syssts_t port_irq_sts;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#if PORT_SIM_USE_UCONTEXT == FALSE
+  void _port_switch(struct port_intctx *nsp, struct port_intctx **osp);
+  void _port_thread_trampoline(void);
+#else
+  void _port_setup_context(struct port_context *ctxp, void *wbase, void *wtop,
+                           void (*pf)(void *p), void *arg);
+#endif
+  __attribute__((noreturn)) void _port_thread_start(void (*pf)(void *p),
+                                                    void *p);
+  rtcnt_t port_rt_get_counter_value(void);
+  void _sim_check_for_interrupts(void);
+  void _sim_advance_time(sysinterval_t ticks);
+  __attribute__((noreturn)) void _sim_halt(const char *reason);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !defined(_FROM_ASM_) */
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/* The following code is not processed when the file is included from an
+   asm module.*/
+#if !defined(_FROM_ASM_)
+
+/**
+ * @brief   Port-related initialization code.
+ */
+static inline void port_init(os_instance_t *oip) {
+
+  (void)oip;
+
+  port_isr_context_flag = false;
+  port_irq_sts = (syssts_t)0;
+}
+
+/**
+ * @brief   Returns a word encoding the current interrupts status.
+ *
+ * @return              The interrupts status.
+ */
+static inline syssts_t port_get_irq_status(void) {
+
+  return port_irq_sts;
+}
+
+/**
+ * @brief   Checks the interrupt status.
+ *
+ * @param[in] sts       the interrupt status word
+ *
+ * @return              The interrupt status.
+ * @retval false        the word specified a disabled interrupts status.
+ * @retval true         the word specified an enabled interrupts status.
+ */
+static inline bool port_irq_enabled(syssts_t sts) {
+
+  return sts == (syssts_t)0;
+}
+
+/**
+ * @brief   Determines the current execution context.
+ *
+ * @return              The execution context.
+ * @retval false        not running in ISR mode.
+ * @retval true         running in ISR mode.
+ */
+static inline bool port_is_isr_context(void) {
+
+  return port_isr_context_flag;
+}
+
+/**
+ * @brief   Kernel-lock action.
+ * @details In this port this function disables interrupts globally.
+ */
+static inline void port_lock(void) {
+
+  port_irq_sts = (syssts_t)1;
+}
+
+/**
+ * @brief   Kernel-unlock action.
+ * @details In this port this function enables interrupts globally.
+ */
+static inline void port_unlock(void) {
+
+  port_irq_sts = (syssts_t)0;
+}
+
+/**
+ * @brief   Kernel-lock action from an interrupt handler.
+ * @details In this port this function disables interrupts globally.
+ * @note    Same as @p port_lock() in this port.
+ */
+static inline void port_lock_from_isr(void) {
+
+  port_lock();
+}
+
+/**
+ * @brief   Kernel-unlock action from an interrupt handler.
+ * @details In this port this function enables interrupts globally.
+ * @note    Same as @p port_lock() in this port.
+ */
+static inline void port_unlock_from_isr(void) {
+
+  port_unlock();
+}
+
+/**
+ * @brief   Disables all the interrupt sources.
+ */
+static inline void port_disable(void) {
+
+  port_irq_sts = (syssts_t)1;
+}
+
+/**
+ * @brief   Disables the interrupt sources below kernel-level priority.
+ */
+static inline void port_suspend(void) {
+
+  port_irq_sts = (syssts_t)1;
+}
+
+/**
+ * @brief   Enables all the interrupt sources.
+ */
+static inline void port_enable(void) {
+
+  port_irq_sts = (syssts_t)0;
+}
+
+/**
+ * @brief   Enters an architecture-dependent IRQ-waiting mode.
+ * @details There is nothing to wait for in this port, the virtual time is
+ *          advanced to the next system tick.
+ */
+static inline void port_wait_for_interrupt(void) {
+
+  _sim_advance_time((sysinterval_t)1);
+}
+
+/**
+ * @brief   Atomic compare-and-swap on a counter.
+ *
+ * @param[in,out] p     pointer to the counter
+ * @param[in] expected  expected counter value
+ * @param[in] desired   new counter value
+ * @return              The operation result.
+ * @retval false        if the counter did not match.
+ * @retval true         if the counter has been updated.
+ */
+static inline bool port_atomic_cas(volatile cnt_t *p,
+                                   cnt_t expected, cnt_t desired) {
+
+  return __atomic_compare_exchange_n(p, &expected, desired, false,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief   Full memory barrier.
+ * @details Orders memory accesses performed before the barrier with respect
+ *          to the accesses performed after it.
+ */
+static inline void port_atomic_barrier(void) {
+
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+#endif /* !defined(_FROM_ASM_) */
+
+/*===========================================================================*/
+/* Module late inclusions.                                                   */
+/*===========================================================================*/
+
+#endif /* CHCORE_H */
+
+/** @} */
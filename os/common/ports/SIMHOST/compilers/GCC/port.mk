@@ -0,0 +1,13 @@
+# List of the ChibiOS/RT SIMHOST port files.
+PORTSRC = ${CHIBIOS}/os/common/ports/SIMHOST/chcore.c
+
+PORTASM = 
+
+PORTINC = $(CHIBIOS)/os/common/portability/GCC \
+          ${CHIBIOS}/os/common/ports/SIMHOST/compilers/GCC \
+          ${CHIBIOS}/os/common/ports/SIMHOST
+
+# Shared variables
+ALLXASMSRC += $(PORTASM)
+ALLCSRC    += $(PORTSRC)
+ALLINC     += $(PORTINC)
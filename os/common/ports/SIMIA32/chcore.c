@@ -29,6 +29,7 @@
 #include <windows.h>
 #else
 #include <sys/time.h>
+#include <pthread.h>
 #endif
 
 #include "ch.h"
@@ -54,21 +55,70 @@
 /* Module exported variables.                                                */
 /*===========================================================================*/
 
-bool port_isr_context_flag;
-syssts_t port_irq_sts;
+PORT_SIM_CORE_VAR bool port_isr_context_flag;
+PORT_SIM_CORE_VAR syssts_t port_irq_sts;
+
+#if (PORT_SIM_SMP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Identifier of the core simulated by the current host thread.
+ */
+PORT_SIM_CORE_VAR core_id_t port_core_id;
+
+/**
+ * @brief   Simulated kernel spinlock.
+ */
+volatile bool port_spinlock;
+
+/**
+ * @brief   Simulated inter-core interrupts, one flag for each core.
+ */
+volatile bool port_notifications[PORT_CORES_NUMBER];
+#endif
 
 /*===========================================================================*/
 /* Module local types.                                                       */
 /*===========================================================================*/
 
+#if (PORT_SIM_SMP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Simulated core start parameters.
+ */
+typedef struct {
+  core_id_t             core_id;
+  void                  (*pf)(void);
+} sim_core_start_t;
+#endif
+
 /*===========================================================================*/
 /* Module local variables.                                                   */
 /*===========================================================================*/
 
+#if PORT_SIM_SMP == TRUE
+static sim_core_start_t sim_cores[PORT_CORES_NUMBER];
+#endif
+
 /*===========================================================================*/
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (PORT_SIM_SMP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Host thread simulating a core.
+ *
+ * @param[in] p         pointer to a @p sim_core_start_t structure
+ * @return              Never returns.
+ */
+static void *sim_core_thread(void *p) {
+  sim_core_start_t *scp = (sim_core_start_t *)p;
+
+  port_core_id = scp->core_id;
+  port_irq_sts = (syssts_t)1;
+  scp->pf();
+
+  return NULL;
+}
+#endif
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -121,6 +171,44 @@ void _port_thread_start(msg_t (*pf)(void *), void *p) {
 }
 
 
+#if (PORT_SIM_SMP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a simulated core.
+ * @details A new host thread is created, the core entry function is invoked
+ *          in its context.
+ * @note    The entry function is expected to wait for the system to be
+ *          running using @p chSysWaitSystemState() then to initialize its
+ *          own OS instance.
+ *
+ * @param[in] core_id   identifier of the core to be started
+ * @param[in] pf        core entry function
+ */
+void _sim_start_core(core_id_t core_id, void (*pf)(void)) {
+  pthread_t thread;
+
+  chDbgCheck((core_id > 0U) && (core_id < (core_id_t)PORT_CORES_NUMBER));
+
+  sim_cores[core_id].core_id = core_id;
+  sim_cores[core_id].pf      = pf;
+  if (pthread_create(&thread, NULL, sim_core_thread, &sim_cores[core_id]) != 0) {
+    chSysHalt("core start failed");
+  }
+}
+
+/**
+ * @brief   Triggers an inter-core notification.
+ * @details The simulated inter-core interrupt is served by the target core
+ *          the next time it checks for interrupts.
+ *
+ * @param[in] oip       pointer to the @p os_instance_t structure
+ */
+void port_notify_instance(os_instance_t *oip) {
+
+  __atomic_store_n(&port_notifications[oip->core_id], true,
+                   __ATOMIC_RELEASE);
+}
+#endif /* PORT_SIM_SMP == TRUE */
+
 /**
  * @brief   Returns the current value of the realtime counter.
  *
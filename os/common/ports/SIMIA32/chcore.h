@@ -41,6 +41,11 @@
  */
 #define PORT_SUPPORTS_RT                TRUE
 
+/**
+ * @brief   This port supports atomic compare-and-swap on counters.
+ */
+#define PORT_SUPPORTS_ATOMICS           TRUE
+
 /**
  * @brief   Natural alignment constant.
  * @note    It is the minimum alignment for pointer-size variables.
@@ -58,6 +63,25 @@
  * @note    It is the alignment to be enforced for thread working areas.
  */
 #define PORT_WORKING_AREA_ALIGN         sizeof (stkalign_t)
+
+/**
+ * @brief   Simulated SMP mode.
+ * @note    It follows @p CH_CFG_SMP_MODE, it is always disabled when the
+ *          kernel does not have that setting.
+ */
+#if defined(CH_CFG_SMP_MODE) || defined(__DOXYGEN__)
+#define PORT_SIM_SMP                    CH_CFG_SMP_MODE
+#else
+#define PORT_SIM_SMP                    FALSE
+#endif
+
+#if (PORT_SIM_SMP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Number of cores supported.
+ * @note    In SMP mode each core is simulated by a separate host thread.
+ */
+#define PORT_CORES_NUMBER               2
+#endif
 /** @} */
 
 /**
@@ -87,7 +111,11 @@
 /**
  * @brief   Port-specific information string.
  */
+#if (PORT_SIM_SMP == TRUE) || defined(__DOXYGEN__)
+#define PORT_INFO                       "No preemption (SMP)"
+#else
 #define PORT_INFO                       "No preemption"
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -121,6 +149,10 @@
 #error "option CH_DBG_ENABLE_STACK_CHECK not supported by this port"
 #endif
 
+#if (PORT_SIM_SMP == TRUE) && defined(WIN32)
+#error "SMP mode not supported by the Win32 simulator"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -243,6 +275,17 @@ struct port_context {
  */
 #define PORT_IRQ_IS_VALID_KERNEL_PRIORITY(n) false
 
+#if (PORT_SIM_SMP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Storage class of the per-core port variables.
+ * @note    In SMP mode each simulated core is a separate host thread so
+ *          the interrupts state is kept in thread-local storage.
+ */
+#define PORT_SIM_CORE_VAR               __thread
+#else
+#define PORT_SIM_CORE_VAR
+#endif
+
 /**
  * @brief   IRQ prologue code.
  * @details This macro must be inserted at the start of all IRQ handlers
@@ -291,8 +334,13 @@ struct port_context {
    asm module.*/
 #if !defined(_FROM_ASM_)
 
-extern bool port_isr_context_flag;
-extern syssts_t port_irq_sts;
+extern PORT_SIM_CORE_VAR bool port_isr_context_flag;
+extern PORT_SIM_CORE_VAR syssts_t port_irq_sts;
+#if PORT_SIM_SMP == TRUE
+extern PORT_SIM_CORE_VAR core_id_t port_core_id;
+extern volatile bool port_spinlock;
+extern volatile bool port_notifications[PORT_CORES_NUMBER];
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -304,6 +352,10 @@ extern "C" {
   /*lint -restore*/
   rtcnt_t port_rt_get_counter_value(void);
   void _sim_check_for_interrupts(void);
+#if PORT_SIM_SMP == TRUE
+  void _sim_start_core(core_id_t core_id, void (*pf)(void));
+  void port_notify_instance(os_instance_t *oip);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -318,6 +370,34 @@ extern "C" {
    asm module.*/
 #if !defined(_FROM_ASM_)
 
+#if (PORT_SIM_SMP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Takes the kernel spinlock.
+ */
+static inline void port_spinlock_take(void) {
+
+  while (__atomic_test_and_set(&port_spinlock, __ATOMIC_ACQUIRE)) {
+  }
+}
+
+/**
+ * @brief   Releases the kernel spinlock.
+ */
+static inline void port_spinlock_release(void) {
+
+  __atomic_clear(&port_spinlock, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief   Returns a core index.
+ * @return              The core identifier from 0 to @p PORT_CORES_NUMBER - 1.
+ */
+static inline core_id_t port_get_core_id(void) {
+
+  return port_core_id;
+}
+#endif /* PORT_SIM_SMP == TRUE */
+
 /**
  * @brief   Port-related initialization code.
  */
@@ -325,8 +405,15 @@ static inline void port_init(os_instance_t *oip) {
 
   (void)oip;
 
-  port_irq_sts = (syssts_t)0;
   port_isr_context_flag = false;
+#if PORT_SIM_SMP == TRUE
+  /* The instance initialization is completed under the kernel lock, it is
+     released by the final chSysUnlock().*/
+  port_irq_sts = (syssts_t)1;
+  port_spinlock_take();
+#else
+  port_irq_sts = (syssts_t)0;
+#endif
 }
 
 /**
@@ -365,6 +452,7 @@ static inline bool port_is_isr_context(void) {
   return port_isr_context_flag;
 }
 
+#if (PORT_SIM_SMP == TRUE) || defined(__DOXYGEN__)
 /**
  * @brief   Kernel-lock action.
  * @details In this port this function disables interrupts globally.
@@ -372,6 +460,7 @@ static inline bool port_is_isr_context(void) {
 static inline void port_lock(void) {
 
   port_irq_sts = (syssts_t)1;
+  port_spinlock_take();
 }
 
 /**
@@ -380,8 +469,20 @@ static inline void port_lock(void) {
  */
 static inline void port_unlock(void) {
 
+  port_spinlock_release();
   port_irq_sts = (syssts_t)0;
 }
+#else /* PORT_SIM_SMP == FALSE */
+static inline void port_lock(void) {
+
+  port_irq_sts = (syssts_t)1;
+}
+
+static inline void port_unlock(void) {
+
+  port_irq_sts = (syssts_t)0;
+}
+#endif /* PORT_SIM_SMP == FALSE */
 
 /**
  * @brief   Kernel-lock action from an interrupt handler.
@@ -390,7 +491,7 @@ static inline void port_unlock(void) {
  */
 static inline void port_lock_from_isr(void) {
 
-  port_irq_sts = (syssts_t)1;
+  port_lock();
 }
 
 /**
@@ -400,7 +501,7 @@ static inline void port_lock_from_isr(void) {
  */
 static inline void port_unlock_from_isr(void) {
 
-  port_irq_sts = (syssts_t)0;
+  port_unlock();
 }
 
 /**
@@ -440,6 +541,33 @@ static inline void port_wait_for_interrupt(void) {
   _sim_check_for_interrupts();
 }
 
+/**
+ * @brief   Atomic compare-and-swap on a counter.
+ *
+ * @param[in,out] p     pointer to the counter
+ * @param[in] expected  expected counter value
+ * @param[in] desired   new counter value
+ * @return              The operation result.
+ * @retval false        if the counter did not match.
+ * @retval true         if the counter has been updated.
+ */
+static inline bool port_atomic_cas(volatile cnt_t *p,
+                                   cnt_t expected, cnt_t desired) {
+
+  return __atomic_compare_exchange_n(p, &expected, desired, false,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief   Full memory barrier.
+ * @details Orders memory accesses performed before the barrier with respect
+ *          to the accesses performed after it.
+ */
+static inline void port_atomic_barrier(void) {
+
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
 #endif /* !defined(_FROM_ASM_) */
 
 /*===========================================================================*/
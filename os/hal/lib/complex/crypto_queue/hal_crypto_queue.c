@@ -0,0 +1,638 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_crypto_queue.c
+ * @brief   Cryptographic requests queue code.
+ * @details Requests are submitted by any number of threads and executed
+ *          on the crypto driver by a single dispatcher thread:
+ *          - All the requests pending when the dispatcher wakes up are
+ *            taken as a batch, transient keys shared by requests in the
+ *            same batch are loaded once.
+ *          - Requests in a batch are processed one chunk at time in
+ *            round-robin order so that long requests do not delay short
+ *            ones, chaining vectors are carried between chunks.
+ *          .
+ * @note    The dispatcher thread is provided by the application, it must
+ *          invoke @p cryqDispatch() after the queue has been started.
+ *
+ * @addtogroup HAL_CRYPTO_QUEUE
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal_crypto_queue.h"
+
+#if (HAL_USE_CRY == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the algorithm of the key used by an operation.
+ * @note    Relies on the order of the @p cryqop_t enumeration.
+ */
+static cryalgorithm_t cryq_get_algorithm(cryqop_t op) {
+
+  if (op <= CRYQ_DECRYPT_AES_GCM) {
+    return cry_algo_aes;
+  }
+  if (op <= CRYQ_DECRYPT_DES_CBC) {
+    return cry_algo_des;
+  }
+  if (op >= CRYQ_HMAC_SHA256) {
+    return cry_algo_hmac;
+  }
+  return cry_algo_none;
+}
+
+/**
+ * @brief   Loads the transient key of a request, if not already loaded.
+ */
+static cryerror_t cryq_load_key(CRYQueueDriver *cqp, CRYDriver *cryp,
+                                cryrequest_t *reqp) {
+  cryalgorithm_t algo;
+  cryerror_t err;
+
+  if (reqp->keyp == NULL) {
+    return CRY_NOERROR;
+  }
+
+  algo = cryq_get_algorithm(reqp->op);
+  if ((algo == cry_algo_none) ||
+      ((cqp->keys[algo] == reqp->keyp) &&
+       (cqp->key_sizes[algo] == reqp->key_size))) {
+    return CRY_NOERROR;
+  }
+
+  switch (algo) {
+  case cry_algo_aes:
+    err = cryLoadAESTransientKey(cryp, reqp->key_size, reqp->keyp);
+    break;
+  case cry_algo_des:
+    err = cryLoadDESTransientKey(cryp, reqp->key_size, reqp->keyp);
+    break;
+  default:
+    err = cryLoadHMACTransientKey(cryp, reqp->key_size, reqp->keyp);
+    break;
+  }
+
+  if (err == CRY_NOERROR) {
+    cqp->keys[algo]      = reqp->keyp;
+    cqp->key_sizes[algo] = reqp->key_size;
+  }
+  else {
+    cqp->keys[algo]      = NULL;
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Computes the CTR counter block following @p n data blocks.
+ */
+static void cryq_ctr_advance(uint8_t *cb, const uint8_t *iv, size_t n) {
+  uint32_t ctr;
+
+  /* Only the rightmost 32 bits are a counter, see the CTR functions.*/
+  ctr = ((uint32_t)iv[12] << 24) | ((uint32_t)iv[13] << 16) |
+        ((uint32_t)iv[14] << 8)  | (uint32_t)iv[15];
+  ctr += (uint32_t)(n / 16U);
+  if (cb != iv) {
+    memcpy(cb, iv, 12U);
+  }
+  cb[12] = (uint8_t)(ctr >> 24);
+  cb[13] = (uint8_t)(ctr >> 16);
+  cb[14] = (uint8_t)(ctr >> 8);
+  cb[15] = (uint8_t)ctr;
+}
+
+/**
+ * @brief   Performs the next chunk of a request.
+ *
+ * @return              The request completion status.
+ * @retval false        if there is more data to process.
+ * @retval true         if the request has been completed or failed.
+ */
+static bool cryq_step(CRYQueueDriver *cqp, CRYDriver *cryp,
+                      size_t chunk_size, cryrequest_t *reqp) {
+  const uint8_t *in, *iv;
+  uint8_t *out;
+  uint8_t save[16];
+  bool first, last;
+  size_t n;
+  cryerror_t err;
+
+  err = cryq_load_key(cqp, cryp, reqp);
+  if (err != CRY_NOERROR) {
+    reqp->result = err;
+    return true;
+  }
+
+  /* Size of the next chunk, GCM cannot be split because the API does not
+     expose the intermediate hash state.*/
+  n = reqp->size - reqp->offset;
+  if ((chunk_size > 0U) && (n > chunk_size) &&
+      (reqp->op != CRYQ_ENCRYPT_AES_GCM) &&
+      (reqp->op != CRYQ_DECRYPT_AES_GCM)) {
+    n = chunk_size;
+  }
+  first = (bool)(reqp->offset == 0U);
+  last  = (bool)(reqp->offset + n >= reqp->size);
+  in    = reqp->in + reqp->offset;
+  out   = reqp->op < CRYQ_SHA1 ? reqp->out + reqp->offset : reqp->out;
+  iv    = first ? reqp->iv : reqp->chain;
+
+  switch (reqp->op) {
+  case CRYQ_ENCRYPT_AES_ECB:
+    err = cryEncryptAES_ECB(cryp, reqp->key_id, n, in, out);
+    break;
+  case CRYQ_DECRYPT_AES_ECB:
+    err = cryDecryptAES_ECB(cryp, reqp->key_id, n, in, out);
+    break;
+  case CRYQ_ENCRYPT_AES_CBC:
+    err = cryEncryptAES_CBC(cryp, reqp->key_id, n, in, out, iv);
+    if (!last) {
+      memcpy(reqp->chain, out + n - 16U, 16U);
+    }
+    break;
+  case CRYQ_DECRYPT_AES_CBC:
+    /* The last cipher block is saved before it is overwritten by in-place
+       operations.*/
+    if (!last) {
+      memcpy(save, in + n - 16U, 16U);
+    }
+    err = cryDecryptAES_CBC(cryp, reqp->key_id, n, in, out, iv);
+    if (!last) {
+      memcpy(reqp->chain, save, 16U);
+    }
+    break;
+  case CRYQ_ENCRYPT_AES_CFB:
+    err = cryEncryptAES_CFB(cryp, reqp->key_id, n, in, out, iv);
+    if (!last) {
+      memcpy(reqp->chain, out + n - 16U, 16U);
+    }
+    break;
+  case CRYQ_DECRYPT_AES_CFB:
+    if (!last) {
+      memcpy(save, in + n - 16U, 16U);
+    }
+    err = cryDecryptAES_CFB(cryp, reqp->key_id, n, in, out, iv);
+    if (!last) {
+      memcpy(reqp->chain, save, 16U);
+    }
+    break;
+  case CRYQ_ENCRYPT_AES_CTR:
+    err = cryEncryptAES_CTR(cryp, reqp->key_id, n, in, out, iv);
+    if (!last) {
+      cryq_ctr_advance(reqp->chain, iv, n);
+    }
+    break;
+  case CRYQ_DECRYPT_AES_CTR:
+    err = cryDecryptAES_CTR(cryp, reqp->key_id, n, in, out, iv);
+    if (!last) {
+      cryq_ctr_advance(reqp->chain, iv, n);
+    }
+    break;
+  case CRYQ_ENCRYPT_AES_GCM:
+    err = cryEncryptAES_GCM(cryp, reqp->key_id,
+                            reqp->auth_size, reqp->auth_in,
+                            n, in, out, iv,
+                            reqp->tag_size, reqp->tag_out);
+    break;
+  case CRYQ_DECRYPT_AES_GCM:
+    err = cryDecryptAES_GCM(cryp, reqp->key_id,
+                            reqp->auth_size, reqp->auth_in,
+                            n, in, out, iv,
+                            reqp->tag_size, reqp->tag_in);
+    break;
+  case CRYQ_ENCRYPT_DES_ECB:
+    err = cryEncryptDES_ECB(cryp, reqp->key_id, n, in, out);
+    break;
+  case CRYQ_DECRYPT_DES_ECB:
+    err = cryDecryptDES_ECB(cryp, reqp->key_id, n, in, out);
+    break;
+  case CRYQ_ENCRYPT_DES_CBC:
+    err = cryEncryptDES_CBC(cryp, reqp->key_id, n, in, out, iv);
+    if (!last) {
+      memcpy(reqp->chain, out + n - 8U, 8U);
+    }
+    break;
+  case CRYQ_DECRYPT_DES_CBC:
+    if (!last) {
+      memcpy(save, in + n - 8U, 8U);
+    }
+    err = cryDecryptDES_CBC(cryp, reqp->key_id, n, in, out, iv);
+    if (!last) {
+      memcpy(reqp->chain, save, 8U);
+    }
+    break;
+  case CRYQ_SHA1:
+    if (first && ((reqp->flags & CRYQ_HASH_INIT) != 0U)) {
+      err = crySHA1Init(cryp, (SHA1Context *)reqp->ctxp);
+    }
+    if ((err == CRY_NOERROR) && (n > 0U)) {
+      err = crySHA1Update(cryp, (SHA1Context *)reqp->ctxp, n, in);
+    }
+    if ((err == CRY_NOERROR) && last &&
+        ((reqp->flags & CRYQ_HASH_FINAL) != 0U)) {
+      err = crySHA1Final(cryp, (SHA1Context *)reqp->ctxp, reqp->out);
+    }
+    break;
+  case CRYQ_SHA256:
+    if (first && ((reqp->flags & CRYQ_HASH_INIT) != 0U)) {
+      err = crySHA256Init(cryp, (SHA256Context *)reqp->ctxp);
+    }
+    if ((err == CRY_NOERROR) && (n > 0U)) {
+      err = crySHA256Update(cryp, (SHA256Context *)reqp->ctxp, n, in);
+    }
+    if ((err == CRY_NOERROR) && last &&
+        ((reqp->flags & CRYQ_HASH_FINAL) != 0U)) {
+      err = crySHA256Final(cryp, (SHA256Context *)reqp->ctxp, reqp->out);
+    }
+    break;
+  case CRYQ_SHA512:
+    if (first && ((reqp->flags & CRYQ_HASH_INIT) != 0U)) {
+      err = crySHA512Init(cryp, (SHA512Context *)reqp->ctxp);
+    }
+    if ((err == CRY_NOERROR) && (n > 0U)) {
+      err = crySHA512Update(cryp, (SHA512Context *)reqp->ctxp, n, in);
+    }
+    if ((err == CRY_NOERROR) && last &&
+        ((reqp->flags & CRYQ_HASH_FINAL) != 0U)) {
+      err = crySHA512Final(cryp, (SHA512Context *)reqp->ctxp, reqp->out);
+    }
+    break;
+  case CRYQ_HMAC_SHA256:
+    if (first && ((reqp->flags & CRYQ_HASH_INIT) != 0U)) {
+      err = cryHMACSHA256Init(cryp, (HMACSHA256Context *)reqp->ctxp);
+    }
+    if ((err == CRY_NOERROR) && (n > 0U)) {
+      err = cryHMACSHA256Update(cryp, (HMACSHA256Context *)reqp->ctxp,
+                                n, in);
+    }
+    if ((err == CRY_NOERROR) && last &&
+        ((reqp->flags & CRYQ_HASH_FINAL) != 0U)) {
+      err = cryHMACSHA256Final(cryp, (HMACSHA256Context *)reqp->ctxp,
+                               reqp->out);
+    }
+    break;
+  case CRYQ_HMAC_SHA512:
+    if (first && ((reqp->flags & CRYQ_HASH_INIT) != 0U)) {
+      err = cryHMACSHA512Init(cryp, (HMACSHA512Context *)reqp->ctxp);
+    }
+    if ((err == CRY_NOERROR) && (n > 0U)) {
+      err = cryHMACSHA512Update(cryp, (HMACSHA512Context *)reqp->ctxp,
+                                n, in);
+    }
+    if ((err == CRY_NOERROR) && last &&
+        ((reqp->flags & CRYQ_HASH_FINAL) != 0U)) {
+      err = cryHMACSHA512Final(cryp, (HMACSHA512Context *)reqp->ctxp,
+                               reqp->out);
+    }
+    break;
+  default:
+    err = CRY_ERR_INV_ALGO;
+    break;
+  }
+
+  reqp->offset += n;
+  reqp->result = err;
+
+  return (bool)(last || (err != CRY_NOERROR));
+}
+
+/**
+ * @brief   Notifies the completion of a request.
+ * @details The request is marked as completed and the waiting thread is
+ *          released before invoking the callback, the result is passed
+ *          to the waiting thread because the callback could resubmit the
+ *          request.
+ */
+static void cryq_complete(CRYQueueDriver *cqp, cryrequest_t *reqp) {
+
+  osalSysLock();
+  cqp->completed++;
+  reqp->state = CRYQ_REQ_DONE;
+  osalThreadResumeI(&reqp->thread, (msg_t)reqp->result);
+  if (reqp->cb != NULL) {
+    reqp->cb(cqp, reqp);
+  }
+  osalOsRescheduleS();
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Processes a batch of requests.
+ */
+static void cryq_process(CRYQueueDriver *cqp, CRYDriver *cryp,
+                         size_t chunk_size, cryrequest_t *reqp) {
+  unsigned i;
+
+  /* Keys could have been modified by their owners since the previous
+     batch.*/
+  for (i = 0U; i < 4U; i++) {
+    cqp->keys[i] = NULL;
+  }
+
+  /* One chunk of each request per round, completed requests are removed
+     from the list.*/
+  while (reqp != NULL) {
+    cryrequest_t **rpp = &reqp;
+
+    while (*rpp != NULL) {
+      cryrequest_t *rp = *rpp;
+
+      if (cryq_step(cqp, cryp, chunk_size, rp)) {
+        *rpp = rp->next;
+        cryq_complete(cqp, rp);
+      }
+      else {
+        rpp = &rp->next;
+      }
+    }
+  }
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes an instance.
+ *
+ * @param[out] cqp      pointer to the @p CRYQueueDriver object
+ *
+ * @init
+ */
+void cryqObjectInit(CRYQueueDriver *cqp) {
+  unsigned i;
+
+  osalDbgCheck(cqp != NULL);
+
+  cqp->state      = CRYQ_STOP;
+  cqp->config     = NULL;
+  cqp->head       = NULL;
+  cqp->tail       = NULL;
+  cqp->dispatcher = NULL;
+  for (i = 0U; i < 4U; i++) {
+    cqp->keys[i]      = NULL;
+    cqp->key_sizes[i] = 0U;
+  }
+  cqp->batches    = 0U;
+  cqp->completed  = 0U;
+}
+
+/**
+ * @brief   Configures and activates a crypto requests queue.
+ *
+ * @param[in] cqp       pointer to the @p CRYQueueDriver object
+ * @param[in] config    pointer to the configuration
+ *
+ * @api
+ */
+void cryqStart(CRYQueueDriver *cqp, const CRYQueueConfig *config) {
+
+  osalDbgCheck((cqp != NULL) && (config != NULL) && (config->cryp != NULL));
+  osalDbgCheck((config->chunk_size & 15U) == 0U);
+
+  osalSysLock();
+  osalDbgAssert((cqp->state == CRYQ_STOP) || (cqp->state == CRYQ_READY),
+                "invalid state");
+  cqp->config = config;
+  cqp->state  = CRYQ_READY;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Deactivates a crypto requests queue.
+ * @details Pending requests are completed with @p CRY_ERR_OP_FAILURE and
+ *          the dispatcher returns after completing the current batch.
+ * @note    The callbacks of the discarded requests are invoked while the
+ *          queue is already stopped, they must not resubmit.
+ *
+ * @param[in] cqp       pointer to the @p CRYQueueDriver object
+ *
+ * @api
+ */
+void cryqStop(CRYQueueDriver *cqp) {
+  cryrequest_t *reqp;
+
+  osalDbgCheck(cqp != NULL);
+
+  osalSysLock();
+  osalDbgAssert((cqp->state == CRYQ_STOP) || (cqp->state == CRYQ_READY),
+                "invalid state");
+  reqp        = cqp->head;
+  cqp->head   = NULL;
+  cqp->tail   = NULL;
+  cqp->config = NULL;
+  cqp->state  = CRYQ_STOP;
+  osalThreadResumeS(&cqp->dispatcher, MSG_RESET);
+  osalSysUnlock();
+
+  while (reqp != NULL) {
+    cryrequest_t *next = reqp->next;
+
+    reqp->result = CRY_ERR_OP_FAILURE;
+    cryq_complete(cqp, reqp);
+    reqp = next;
+  }
+}
+
+/**
+ * @brief   Initializes a request.
+ * @details The request parameters are then set using the setup macros.
+ *
+ * @param[out] reqp     pointer to the @p cryrequest_t object
+ * @param[in] op        requested operation
+ * @param[in] cb        completion callback or @p NULL
+ * @param[in] arg       callback argument
+ *
+ * @init
+ */
+void cryqRequestObjectInit(cryrequest_t *reqp, cryqop_t op,
+                           cryqcallback_t cb, void *arg) {
+
+  osalDbgCheck(reqp != NULL);
+
+  memset((void *)reqp, 0, sizeof (cryrequest_t));
+  reqp->state  = CRYQ_REQ_IDLE;
+  reqp->op     = op;
+  reqp->keyp   = NULL;
+  reqp->cb     = cb;
+  reqp->arg    = arg;
+  reqp->thread = NULL;
+}
+
+/**
+ * @brief   Submits a request.
+ * @note    This function can be invoked from the completion callback in
+ *          order to resubmit the completed request.
+ *
+ * @param[in] cqp       pointer to the @p CRYQueueDriver object
+ * @param[in] reqp      pointer to the @p cryrequest_t object
+ *
+ * @iclass
+ */
+void cryqSubmitI(CRYQueueDriver *cqp, cryrequest_t *reqp) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck((cqp != NULL) && (reqp != NULL));
+  osalDbgAssert(cqp->state == CRYQ_READY, "not ready");
+  osalDbgAssert(reqp->state != CRYQ_REQ_QUEUED, "already queued");
+
+  reqp->next   = NULL;
+  reqp->state  = CRYQ_REQ_QUEUED;
+  reqp->result = CRY_NOERROR;
+  reqp->offset = 0U;
+  reqp->thread = NULL;
+
+  if (cqp->tail == NULL) {
+    cqp->head = reqp;
+  }
+  else {
+    cqp->tail->next = reqp;
+  }
+  cqp->tail = reqp;
+
+  osalThreadResumeI(&cqp->dispatcher, MSG_OK);
+}
+
+/**
+ * @brief   Submits a request.
+ *
+ * @param[in] cqp       pointer to the @p CRYQueueDriver object
+ * @param[in] reqp      pointer to the @p cryrequest_t object
+ *
+ * @api
+ */
+void cryqSubmit(CRYQueueDriver *cqp, cryrequest_t *reqp) {
+
+  osalSysLock();
+  cryqSubmitI(cqp, reqp);
+  osalOsRescheduleS();
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Waits for a request completion.
+ *
+ * @param[in] reqp      pointer to the @p cryrequest_t object
+ * @return              The operation result.
+ *
+ * @api
+ */
+cryerror_t cryqWait(cryrequest_t *reqp) {
+  cryerror_t err;
+
+  osalDbgCheck(reqp != NULL);
+
+  osalSysLock();
+  osalDbgAssert(reqp->state != CRYQ_REQ_IDLE, "not submitted");
+  if (reqp->state != CRYQ_REQ_DONE) {
+    /* The result is taken from the wakeup message, the request could
+       have been already resubmitted by its callback.*/
+    err = (cryerror_t)osalThreadSuspendS(&reqp->thread);
+  }
+  else {
+    err = reqp->result;
+  }
+  osalSysUnlock();
+
+  return err;
+}
+
+/**
+ * @brief   Submits a request and waits for its completion.
+ *
+ * @param[in] cqp       pointer to the @p CRYQueueDriver object
+ * @param[in] reqp      pointer to the @p cryrequest_t object
+ * @return              The operation result.
+ *
+ * @api
+ */
+cryerror_t cryqExecute(CRYQueueDriver *cqp, cryrequest_t *reqp) {
+
+  cryqSubmit(cqp, reqp);
+
+  return cryqWait(reqp);
+}
+
+/**
+ * @brief   Requests dispatcher.
+ * @details Executes the submitted requests, this function must be invoked
+ *          by a single dedicated thread and returns when the queue is
+ *          stopped.
+ * @note    Completion callbacks are invoked by the dispatcher thread
+ *          from within a lock zone, after the request has been marked
+ *          as completed, only I-class functions can be used there.
+ *
+ * @param[in] cqp       pointer to the @p CRYQueueDriver object
+ *
+ * @api
+ */
+void cryqDispatch(CRYQueueDriver *cqp) {
+
+  osalDbgCheck(cqp != NULL);
+
+  osalSysLock();
+  while (cqp->state == CRYQ_READY) {
+    cryrequest_t *reqp = cqp->head;
+    CRYDriver *cryp;
+    size_t chunk_size;
+
+    if (reqp == NULL) {
+      (void) osalThreadSuspendS(&cqp->dispatcher);
+      continue;
+    }
+
+    /* All the pending requests are taken as a batch.*/
+    cqp->head  = NULL;
+    cqp->tail  = NULL;
+    cqp->batches++;
+    cryp       = cqp->config->cryp;
+    chunk_size = cqp->config->chunk_size;
+    osalSysUnlock();
+
+    cryq_process(cqp, cryp, chunk_size, reqp);
+
+    osalSysLock();
+  }
+  osalSysUnlock();
+}
+
+#endif /* HAL_USE_CRY == TRUE */
+
+/** @} */
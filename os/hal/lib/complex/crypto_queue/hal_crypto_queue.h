@@ -0,0 +1,407 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_crypto_queue.h
+ * @brief   Cryptographic requests queue macros and structures.
+ *
+ * @addtogroup HAL_CRYPTO_QUEUE
+ * @{
+ */
+
+#ifndef HAL_CRYPTO_QUEUE_H
+#define HAL_CRYPTO_QUEUE_H
+
+#include "hal.h"
+
+#if (HAL_USE_CRY == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Hash requests flags
+ * @{
+ */
+/**
+ * @brief   The hash context is initialized before processing the data.
+ */
+#define CRYQ_HASH_INIT                      1U
+/**
+ * @brief   The digest is written in @p out after processing the data.
+ */
+#define CRYQ_HASH_FINAL                     2U
+/**
+ * @brief   Whole digest computation in a single request.
+ */
+#define CRYQ_HASH_ONESHOT                   (CRYQ_HASH_INIT | CRYQ_HASH_FINAL)
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Driver state machine possible states.
+ */
+typedef enum {
+  CRYQ_UNINIT = 0,                          /**< Not initialized.           */
+  CRYQ_STOP = 1,                            /**< Stopped.                   */
+  CRYQ_READY = 2                            /**< Ready.                     */
+} cryqstate_t;
+
+/**
+ * @brief   Requests state machine possible states.
+ */
+typedef enum {
+  CRYQ_REQ_IDLE = 0,                        /**< Not queued.                */
+  CRYQ_REQ_QUEUED = 1,                      /**< Queued or in progress.     */
+  CRYQ_REQ_DONE = 2                         /**< Completed.                 */
+} cryqreqstate_t;
+
+/**
+ * @brief   Requested operations.
+ */
+typedef enum {
+  CRYQ_ENCRYPT_AES_ECB = 0,
+  CRYQ_DECRYPT_AES_ECB,
+  CRYQ_ENCRYPT_AES_CBC,
+  CRYQ_DECRYPT_AES_CBC,
+  CRYQ_ENCRYPT_AES_CFB,
+  CRYQ_DECRYPT_AES_CFB,
+  CRYQ_ENCRYPT_AES_CTR,
+  CRYQ_DECRYPT_AES_CTR,
+  CRYQ_ENCRYPT_AES_GCM,
+  CRYQ_DECRYPT_AES_GCM,
+  CRYQ_ENCRYPT_DES_ECB,
+  CRYQ_DECRYPT_DES_ECB,
+  CRYQ_ENCRYPT_DES_CBC,
+  CRYQ_DECRYPT_DES_CBC,
+  CRYQ_SHA1,
+  CRYQ_SHA256,
+  CRYQ_SHA512,
+  CRYQ_HMAC_SHA256,
+  CRYQ_HMAC_SHA512
+} cryqop_t;
+
+/**
+ * @brief   Type of a structure representing a crypto requests queue.
+ */
+typedef struct CRYQueueDriver CRYQueueDriver;
+
+/**
+ * @brief   Type of a crypto request.
+ */
+typedef struct cryrequest cryrequest_t;
+
+/**
+ * @brief   Request completion callback type.
+ *
+ * @param[in] cqp       pointer to the @p CRYQueueDriver object
+ * @param[in] reqp      pointer to the completed request
+ */
+typedef void (*cryqcallback_t)(CRYQueueDriver *cqp, cryrequest_t *reqp);
+
+/**
+ * @brief   Structure representing a crypto request.
+ * @note    The buffers referred by a request, keys included, must not be
+ *          modified or released until the request is completed.
+ */
+struct cryrequest {
+  /**
+   * @brief   Next request in the queue.
+   */
+  cryrequest_t              *next;
+  /**
+   * @brief   Request state.
+   */
+  volatile cryqreqstate_t   state;
+  /**
+   * @brief   Requested operation.
+   */
+  cryqop_t                  op;
+  /**
+   * @brief   Key identifier.
+   * @note    Ignored by SHA operations.
+   */
+  crykey_t                  key_id;
+  /**
+   * @brief   Size of the transient key.
+   */
+  size_t                    key_size;
+  /**
+   * @brief   Transient key, loaded before performing the operation.
+   * @note    If @p NULL then the key identified by @p key_id is used
+   *          as-is.
+   */
+  const uint8_t             *keyp;
+  /**
+   * @brief   Size of the data to be processed.
+   */
+  size_t                    size;
+  /**
+   * @brief   Input data.
+   */
+  const uint8_t             *in;
+  /**
+   * @brief   Output data or digest.
+   */
+  uint8_t                   *out;
+  /**
+   * @brief   Initial vector.
+   */
+  const uint8_t             *iv;
+  /**
+   * @brief   Size of the GCM authenticated data.
+   */
+  size_t                    auth_size;
+  /**
+   * @brief   GCM authenticated data.
+   */
+  const uint8_t             *auth_in;
+  /**
+   * @brief   Size of the GCM tag.
+   */
+  size_t                    tag_size;
+  /**
+   * @brief   GCM tag to be verified.
+   */
+  const uint8_t             *tag_in;
+  /**
+   * @brief   GCM computed tag.
+   */
+  uint8_t                   *tag_out;
+  /**
+   * @brief   Hash context, of the type required by the operation.
+   */
+  void                      *ctxp;
+  /**
+   * @brief   Hash requests flags.
+   */
+  uint32_t                  flags;
+  /**
+   * @brief   Completion callback or @p NULL.
+   * @note    The callback is invoked from the dispatcher thread, within
+   *          a lock zone, after the request has been marked as completed
+   *          and the waiting thread released. Only I-class functions can
+   *          be used, @p cryqSubmitI() included.
+   */
+  cryqcallback_t            cb;
+  /**
+   * @brief   Callback argument, not used by the driver.
+   */
+  void                      *arg;
+  /**
+   * @brief   Operation result.
+   */
+  cryerror_t                result;
+  /**
+   * @brief   Thread waiting for completion.
+   */
+  thread_reference_t        thread;
+  /**
+   * @brief   Already processed data.
+   */
+  size_t                    offset;
+  /**
+   * @brief   Chaining vector for the next chunk.
+   */
+  uint8_t                   chain[16];
+};
+
+/**
+ * @brief   Driver configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   Crypto driver performing the requests.
+   * @note    The crypto driver must be already started and must not be
+   *          used directly while the queue is active.
+   */
+  CRYDriver                 *cryp;
+  /**
+   * @brief   Maximum data processed for a request before switching to
+   *          the next pending request.
+   * @note    Zero disables splitting, non-zero values must be multiple
+   *          of 16. GCM requests are never split.
+   */
+  size_t                    chunk_size;
+} CRYQueueConfig;
+
+/**
+ * @brief   Structure representing a crypto requests queue.
+ */
+struct CRYQueueDriver {
+  /**
+   * @brief   Driver state.
+   */
+  volatile cryqstate_t      state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const CRYQueueConfig      *config;
+  /**
+   * @brief   First pending request.
+   */
+  cryrequest_t              *head;
+  /**
+   * @brief   Last pending request.
+   */
+  cryrequest_t              *tail;
+  /**
+   * @brief   Dispatcher thread waiting for requests.
+   */
+  thread_reference_t        dispatcher;
+  /**
+   * @brief   Transient keys currently loaded, by algorithm.
+   */
+  const uint8_t             *keys[4];
+  /**
+   * @brief   Size of the transient keys currently loaded, by algorithm.
+   */
+  size_t                    key_sizes[4];
+  /**
+   * @brief   Number of processed batches.
+   */
+  uint32_t                  batches;
+  /**
+   * @brief   Number of completed requests.
+   */
+  uint32_t                  completed;
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @name    Requests setup macros
+ * @{
+ */
+/**
+ * @brief   Sets the key used by a request.
+ *
+ * @param[in] reqp      pointer to the @p cryrequest_t object
+ * @param[in] kid       key identifier
+ * @param[in] ksize     transient key size
+ * @param[in] kp        transient key or @p NULL
+ *
+ * @xclass
+ */
+#define cryqSetKeyX(reqp, kid, ksize, kp) do {                              \
+  (reqp)->key_id   = (kid);                                                 \
+  (reqp)->key_size = (ksize);                                               \
+  (reqp)->keyp     = (kp);                                                  \
+} while (false)
+
+/**
+ * @brief   Sets the data processed by a request.
+ *
+ * @param[in] reqp      pointer to the @p cryrequest_t object
+ * @param[in] n         size of the data
+ * @param[in] ip        input buffer
+ * @param[out] op       output buffer, digest buffer for hash requests
+ * @param[in] ivp       initial vector or @p NULL
+ *
+ * @xclass
+ */
+#define cryqSetDataX(reqp, n, ip, op, ivp) do {                             \
+  (reqp)->size = (n);                                                       \
+  (reqp)->in   = (ip);                                                      \
+  (reqp)->out  = (op);                                                      \
+  (reqp)->iv   = (ivp);                                                     \
+} while (false)
+
+/**
+ * @brief   Sets the GCM specific parameters of a request.
+ *
+ * @param[in] reqp      pointer to the @p cryrequest_t object
+ * @param[in] an        size of the authenticated data
+ * @param[in] ap        authenticated data
+ * @param[in] tn        size of the tag
+ * @param[in] tip       tag to be verified, for decryption
+ * @param[out] top      computed tag, for encryption
+ *
+ * @xclass
+ */
+#define cryqSetGCMX(reqp, an, ap, tn, tip, top) do {                        \
+  (reqp)->auth_size = (an);                                                 \
+  (reqp)->auth_in   = (ap);                                                 \
+  (reqp)->tag_size  = (tn);                                                 \
+  (reqp)->tag_in    = (tip);                                                \
+  (reqp)->tag_out   = (top);                                                \
+} while (false)
+
+/**
+ * @brief   Sets the hash specific parameters of a request.
+ *
+ * @param[in] reqp      pointer to the @p cryrequest_t object
+ * @param[in] cp        hash context of the type required by the operation
+ * @param[in] f         hash requests flags
+ *
+ * @xclass
+ */
+#define cryqSetHashX(reqp, cp, f) do {                                      \
+  (reqp)->ctxp  = (cp);                                                     \
+  (reqp)->flags = (f);                                                      \
+} while (false)
+/** @} */
+
+/**
+ * @brief   Returns the result of a completed request.
+ *
+ * @param[in] reqp      pointer to the @p cryrequest_t object
+ * @return              The operation result.
+ *
+ * @xclass
+ */
+#define cryqGetResultX(reqp) ((reqp)->result)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void cryqObjectInit(CRYQueueDriver *cqp);
+  void cryqStart(CRYQueueDriver *cqp, const CRYQueueConfig *config);
+  void cryqStop(CRYQueueDriver *cqp);
+  void cryqRequestObjectInit(cryrequest_t *reqp, cryqop_t op,
+                             cryqcallback_t cb, void *arg);
+  void cryqSubmitI(CRYQueueDriver *cqp, cryrequest_t *reqp);
+  void cryqSubmit(CRYQueueDriver *cqp, cryrequest_t *reqp);
+  cryerror_t cryqWait(cryrequest_t *reqp);
+  cryerror_t cryqExecute(CRYQueueDriver *cqp, cryrequest_t *reqp);
+  void cryqDispatch(CRYQueueDriver *cqp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_CRY == TRUE */
+
+#endif /* HAL_CRYPTO_QUEUE_H */
+
+/** @} */
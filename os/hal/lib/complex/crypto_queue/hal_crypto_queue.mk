@@ -0,0 +1,9 @@
+# List of all the crypto requests queue files.
+CRYQSRC := $(CHIBIOS)/os/hal/lib/complex/crypto_queue/hal_crypto_queue.c
+
+# Required include directories
+CRYQINC := $(CHIBIOS)/os/hal/lib/complex/crypto_queue
+
+# Shared variables
+ALLCSRC += $(CRYQSRC)
+ALLINC  += $(CRYQINC)
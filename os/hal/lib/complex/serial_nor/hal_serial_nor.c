@@ -22,6 +22,8 @@
  * @{
  */
 
+#include <string.h>
+
 #include "hal.h"
 #include "hal_serial_nor.h"
 
@@ -68,6 +70,274 @@ static const struct SNORDriverVMT snor_vmt = {
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+/**
+ * @brief   Bus acquisition, the bus is already owned within a batch.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ *
+ * @notapi
+ */
+static void snor_bus_acquire(SNORDriver *devp) {
+
+  if (devp->batch == 0U) {
+    bus_acquire(devp->config->busp, devp->config->buscfg);
+  }
+}
+
+/**
+ * @brief   Bus release, the bus is kept until the end of a batch.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ *
+ * @notapi
+ */
+static void snor_bus_release(SNORDriver *devp) {
+
+  if (devp->batch == 0U) {
+    bus_release(devp->config->busp);
+  }
+}
+
+#if (SNOR_PROGRAM_BUFFER_SIZE > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Limit of the data that can be buffered starting from an offset.
+ * @details The buffer does not cross the page boundary, its content is
+ *          written by a single page program command.
+ *
+ * @param[in] start     offset of the first buffered byte
+ * @return              The offset after the last byte that can be buffered.
+ *
+ * @notapi
+ */
+static flash_offset_t snor_pbuf_limit(flash_offset_t start) {
+  flash_offset_t page_end = (start | (snor_descriptor.page_size - 1U)) + 1U;
+
+  if (page_end - start > (flash_offset_t)SNOR_PROGRAM_BUFFER_SIZE) {
+    return start + (flash_offset_t)SNOR_PROGRAM_BUFFER_SIZE;
+  }
+
+  return page_end;
+}
+
+/**
+ * @brief   Writes the buffered program data.
+ * @note    The bus must be owned.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ * @return              An error code.
+ *
+ * @notapi
+ */
+static flash_error_t snor_pbuf_flush(SNORDriver *devp) {
+  flash_state_t state = devp->state;
+  flash_error_t err;
+
+  if (devp->psize == 0U) {
+    return FLASH_NO_ERROR;
+  }
+
+  devp->state = FLASH_PGM;
+  err = snor_device_program(devp, devp->poffset, devp->psize,
+                            devp->nocache->pbuf);
+  devp->state = state;
+  devp->psize = 0U;
+
+  return err;
+}
+
+/**
+ * @brief   Writes the program buffer if it overlaps the specified range.
+ * @note    The bus must be owned.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ * @param[in] offset    flash offset
+ * @param[in] n         size of the range
+ * @return              An error code.
+ *
+ * @notapi
+ */
+static flash_error_t snor_pbuf_flush_range(SNORDriver *devp,
+                                           flash_offset_t offset,
+                                           size_t n) {
+
+  if ((devp->psize > 0U) && (offset < devp->poffset + devp->psize) &&
+      (devp->poffset < offset + n)) {
+    return snor_pbuf_flush(devp);
+  }
+
+  return FLASH_NO_ERROR;
+}
+#endif /* SNOR_PROGRAM_BUFFER_SIZE > 0 */
+
+/**
+ * @brief   Read through the read cache.
+ * @note    The bus must be owned.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ * @param[in] offset    flash offset
+ * @param[in] n         number of bytes to be read
+ * @param[out] rp       pointer to the data buffer
+ * @return              An error code.
+ *
+ * @notapi
+ */
+static flash_error_t snor_cached_read(SNORDriver *devp, flash_offset_t offset,
+                                      size_t n, uint8_t *rp) {
+  flash_error_t err;
+
+#if SNOR_PROGRAM_BUFFER_SIZE > 0
+  /* Buffered data is written before reading it back.*/
+  err = snor_pbuf_flush_range(devp, offset, n);
+  if (err != FLASH_NO_ERROR) {
+    return err;
+  }
+#endif
+
+#if SNOR_READ_CACHE_SIZE > 0
+  while (n > 0U) {
+    size_t chunk;
+
+    if ((offset >= devp->roffset) &&
+        (offset < devp->roffset + devp->rsize)) {
+      /* Cache hit.*/
+      chunk = (size_t)(devp->roffset + devp->rsize - offset);
+      if (chunk > n) {
+        chunk = n;
+      }
+      memcpy(rp, &devp->nocache->rcache[offset - devp->roffset], chunk);
+    }
+    else if (n >= (size_t)SNOR_READ_CACHE_SIZE) {
+      /* Large reads bypass the cache.*/
+      return snor_device_read(devp, offset, n, rp);
+    }
+    else {
+      size_t size = (size_t)snor_descriptor.sectors_count *
+                    (size_t)snor_descriptor.sectors_size;
+
+      /* Cache miss, the line is loaded starting from the requested data,
+         the following data is prefetched for sequential reads.*/
+      chunk = size - (size_t)offset;
+      if (chunk > (size_t)SNOR_READ_CACHE_SIZE) {
+        chunk = (size_t)SNOR_READ_CACHE_SIZE;
+      }
+      devp->rsize = 0U;
+#if SNOR_PROGRAM_BUFFER_SIZE > 0
+      /* The prefetched data could be still in the program buffer.*/
+      err = snor_pbuf_flush_range(devp, offset, chunk);
+      if (err != FLASH_NO_ERROR) {
+        return err;
+      }
+#endif
+      err = snor_device_read(devp, offset, chunk, devp->nocache->rcache);
+      if (err != FLASH_NO_ERROR) {
+        return err;
+      }
+      devp->roffset = offset;
+      devp->rsize   = chunk;
+      continue;
+    }
+
+    offset += chunk;
+    rp     += chunk;
+    n      -= chunk;
+  }
+
+  return FLASH_NO_ERROR;
+#else
+  err = snor_device_read(devp, offset, n, rp);
+
+  return err;
+#endif
+}
+
+/**
+ * @brief   Program through the program buffer.
+ * @note    The bus must be owned.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ * @param[in] offset    flash offset
+ * @param[in] n         number of bytes to be programmed
+ * @param[in] pp        pointer to the data buffer
+ * @return              An error code.
+ *
+ * @notapi
+ */
+static flash_error_t snor_buffered_program(SNORDriver *devp,
+                                           flash_offset_t offset,
+                                           size_t n, const uint8_t *pp) {
+#if SNOR_PROGRAM_BUFFER_SIZE > 0
+  flash_error_t err;
+
+  while (n > 0U) {
+    flash_offset_t limit;
+    size_t chunk;
+
+    /* Non-contiguous data, the buffer is written first.*/
+    if ((devp->psize > 0U) && (offset != devp->poffset + devp->psize)) {
+      err = snor_pbuf_flush(devp);
+      if (err != FLASH_NO_ERROR) {
+        return err;
+      }
+    }
+
+    if (devp->psize == 0U) {
+      /* Large writes bypass the buffer.*/
+      if (n >= (size_t)SNOR_PROGRAM_BUFFER_SIZE) {
+        return snor_device_program(devp, offset, n, pp);
+      }
+      devp->poffset = offset;
+    }
+
+    /* Appending data up to the buffer limit.*/
+    limit = snor_pbuf_limit(devp->poffset);
+    chunk = (size_t)(limit - offset);
+    if (chunk > n) {
+      chunk = n;
+    }
+    memcpy(&devp->nocache->pbuf[devp->psize], pp, chunk);
+    devp->psize += chunk;
+    offset      += chunk;
+    pp          += chunk;
+    n           -= chunk;
+
+    /* Buffer full or page boundary reached.*/
+    if (offset == limit) {
+      err = snor_pbuf_flush(devp);
+      if (err != FLASH_NO_ERROR) {
+        return err;
+      }
+    }
+  }
+
+  return FLASH_NO_ERROR;
+#else
+  return snor_device_program(devp, offset, n, pp);
+#endif
+}
+
+/**
+ * @brief   Writes buffered data and invalidates the read cache.
+ * @note    The bus must be owned.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ * @return              An error code.
+ *
+ * @notapi
+ */
+static flash_error_t snor_cache_sync(SNORDriver *devp) {
+
+#if SNOR_READ_CACHE_SIZE > 0
+  devp->rsize = 0U;
+#endif
+#if SNOR_PROGRAM_BUFFER_SIZE > 0
+  return snor_pbuf_flush(devp);
+#else
+  (void)devp;
+
+  return FLASH_NO_ERROR;
+#endif
+}
+
 /**
  * @brief   Returns a pointer to the device descriptor.
  *
@@ -99,20 +369,29 @@ static flash_error_t snor_read(void *instance, flash_offset_t offset,
     return FLASH_BUSY_ERASING;
   }
 
+#if SNOR_READ_CACHE_SIZE > 0
+  /* Data entirely in the read cache, the bus is not accessed.*/
+  if ((offset >= devp->roffset) &&
+      ((size_t)(offset - devp->roffset) + n <= devp->rsize)) {
+    memcpy(rp, &devp->nocache->rcache[offset - devp->roffset], n);
+    return FLASH_NO_ERROR;
+  }
+#endif
+
   /* Bus acquired.*/
-  bus_acquire(devp->config->busp, devp->config->buscfg);
+  snor_bus_acquire(devp);
 
   /* FLASH_READY state while the operation is performed.*/
   devp->state = FLASH_READ;
 
   /* Actual read implementation.*/
-  err = snor_device_read(devp, offset, n, rp);
+  err = snor_cached_read(devp, offset, n, rp);
 
   /* Ready state again.*/
   devp->state = FLASH_READY;
 
   /* Bus released.*/
-  bus_release(devp->config->busp);
+  snor_bus_release(devp);
 
   return err;
 }
@@ -132,20 +411,44 @@ static flash_error_t snor_program(void *instance, flash_offset_t offset,
     return FLASH_BUSY_ERASING;
   }
 
+#if SNOR_READ_CACHE_SIZE > 0
+  /* Cached data overwritten, the cache is invalidated.*/
+  if ((offset < devp->roffset + devp->rsize) &&
+      (devp->roffset < offset + n)) {
+    devp->rsize = 0U;
+  }
+#endif
+
+#if SNOR_PROGRAM_BUFFER_SIZE > 0
+  /* Data appended to the buffer without filling it, the bus is not
+     accessed.*/
+  if (((devp->psize == 0U) && (n < (size_t)SNOR_PROGRAM_BUFFER_SIZE) &&
+       (offset + n < snor_pbuf_limit(offset))) ||
+      ((devp->psize > 0U) && (offset == devp->poffset + devp->psize) &&
+       (offset + n < snor_pbuf_limit(devp->poffset)))) {
+    if (devp->psize == 0U) {
+      devp->poffset = offset;
+    }
+    memcpy(&devp->nocache->pbuf[devp->psize], pp, n);
+    devp->psize += n;
+    return FLASH_NO_ERROR;
+  }
+#endif
+
   /* Bus acquired.*/
-  bus_acquire(devp->config->busp, devp->config->buscfg);
+  snor_bus_acquire(devp);
 
   /* FLASH_PGM state while the operation is performed.*/
   devp->state = FLASH_PGM;
 
   /* Actual program implementation.*/
-  err = snor_device_program(devp, offset, n, pp);
+  err = snor_buffered_program(devp, offset, n, pp);
 
   /* Ready state again.*/
   devp->state = FLASH_READY;
 
   /* Bus released.*/
-  bus_release(devp->config->busp);
+  snor_bus_release(devp);
 
   return err;
 }
@@ -163,16 +466,21 @@ static flash_error_t snor_start_erase_all(void *instance) {
   }
 
   /* Bus acquired.*/
-  bus_acquire(devp->config->busp, devp->config->buscfg);
+  snor_bus_acquire(devp);
 
-  /* FLASH_ERASE state while the operation is performed.*/
-  devp->state = FLASH_ERASE;
+  /* Buffered data written and cached data discarded.*/
+  err = snor_cache_sync(devp);
+  if (err == FLASH_NO_ERROR) {
+
+    /* FLASH_ERASE state while the operation is performed.*/
+    devp->state = FLASH_ERASE;
 
-  /* Actual erase implementation.*/
-  err = snor_device_start_erase_all(devp);
+    /* Actual erase implementation.*/
+    err = snor_device_start_erase_all(devp);
+  }
 
   /* Bus released.*/
-  bus_release(devp->config->busp);
+  snor_bus_release(devp);
 
   return err;
 }
@@ -192,16 +500,21 @@ static flash_error_t snor_start_erase_sector(void *instance,
   }
 
   /* Bus acquired.*/
-  bus_acquire(devp->config->busp, devp->config->buscfg);
+  snor_bus_acquire(devp);
+
+  /* Buffered data written and cached data discarded.*/
+  err = snor_cache_sync(devp);
+  if (err == FLASH_NO_ERROR) {
 
-  /* FLASH_ERASE state while the operation is performed.*/
-  devp->state = FLASH_ERASE;
+    /* FLASH_ERASE state while the operation is performed.*/
+    devp->state = FLASH_ERASE;
 
-  /* Actual erase implementation.*/
-  err = snor_device_start_erase_sector(devp, sector);
+    /* Actual erase implementation.*/
+    err = snor_device_start_erase_sector(devp, sector);
+  }
 
   /* Bus released.*/
-  bus_release(devp->config->busp);
+  snor_bus_release(devp);
 
   return err;
 }
@@ -221,19 +534,22 @@ static flash_error_t snor_verify_erase(void *instance,
   }
 
   /* Bus acquired.*/
-  bus_acquire(devp->config->busp, devp->config->buscfg);
+  snor_bus_acquire(devp);
 
   /* FLASH_READY state while the operation is performed.*/
   devp->state = FLASH_READ;
 
-  /* Actual verify erase implementation.*/
-  err = snor_device_verify_erase(devp, sector);
+  /* Buffered data written then actual verify erase implementation.*/
+  err = snor_cache_sync(devp);
+  if (err == FLASH_NO_ERROR) {
+    err = snor_device_verify_erase(devp, sector);
+  }
 
   /* Ready state again.*/
   devp->state = FLASH_READY;
 
   /* Bus released.*/
-  bus_release(devp->config->busp);
+  snor_bus_release(devp);
 
   return err;
 }
@@ -250,7 +566,7 @@ static flash_error_t snor_query_erase(void *instance, uint32_t *msec) {
   if (devp->state == FLASH_ERASE) {
 
     /* Bus acquired.*/
-    bus_acquire(devp->config->busp, devp->config->buscfg);
+    snor_bus_acquire(devp);
 
     /* Actual query erase implementation.*/
     err = snor_device_query_erase(devp, msec);
@@ -261,7 +577,7 @@ static flash_error_t snor_query_erase(void *instance, uint32_t *msec) {
     }
 
     /* Bus released.*/
-    bus_release(devp->config->busp);
+    snor_bus_release(devp);
   }
   else {
     err = FLASH_NO_ERROR;
@@ -284,7 +600,7 @@ static flash_error_t snor_read_sfdp(void *instance, flash_offset_t offset,
   }
 
   /* Bus acquired.*/
-  bus_acquire(devp->config->busp, devp->config->buscfg);
+  snor_bus_acquire(devp);
 
   /* Actual read SFDP implementation.*/
   err = snor_device_read_sfdp(devp, offset, n, rp);
@@ -295,7 +611,7 @@ static flash_error_t snor_read_sfdp(void *instance, flash_offset_t offset,
   }
 
   /* Bus released.*/
-  bus_release(devp->config->busp);
+  snor_bus_release(devp);
 
   return err;
 }
@@ -704,6 +1020,15 @@ void snorObjectInit(SNORDriver *devp, snor_nocache_buffer_t *nocache) {
   devp->state       = FLASH_STOP;
   devp->config      = NULL;
   devp->nocache     = nocache;
+  devp->batch       = 0U;
+#if SNOR_READ_CACHE_SIZE > 0
+  devp->roffset     = 0U;
+  devp->rsize       = 0U;
+#endif
+#if SNOR_PROGRAM_BUFFER_SIZE > 0
+  devp->poffset     = 0U;
+  devp->psize       = 0U;
+#endif
 #if SNOR_USE_MUTUAL_EXCLUSION == TRUE
   osalMutexObjectInit(&devp->mutex);
 #endif
@@ -740,6 +1065,14 @@ void snorStart(SNORDriver *devp, const SNORConfig *config) {
     /* Device identification and initialization.*/
     snor_device_init(devp);
 
+    /* Empty caches.*/
+#if SNOR_READ_CACHE_SIZE > 0
+    devp->rsize = 0U;
+#endif
+#if SNOR_PROGRAM_BUFFER_SIZE > 0
+    devp->psize = 0U;
+#endif
+
     /* Driver in ready state.*/
     devp->state = FLASH_READY;
 
@@ -759,12 +1092,16 @@ void snorStop(SNORDriver *devp) {
 
   osalDbgCheck(devp != NULL);
   osalDbgAssert(devp->state != FLASH_UNINIT, "invalid state");
+  osalDbgAssert(devp->batch == 0U, "within a batch");
 
   if (devp->state != FLASH_STOP) {
 
     /* Bus acquisition.*/
     bus_acquire(devp->config->busp, devp->config->buscfg);
 
+    /* Buffered data written.*/
+    (void) snor_cache_sync(devp);
+
     /* Stopping bus device.*/
     bus_stop(devp->config->busp);
 
@@ -779,6 +1116,91 @@ void snorStop(SNORDriver *devp) {
   }
 }
 
+/**
+ * @brief   Starts a batch of operations.
+ * @details The bus is acquired once and kept until the end of the batch,
+ *          the operations within the batch do not pay the bus acquisition
+ *          and release overhead. Batches can be nested.
+ * @note    Operations within a batch must be performed by the same thread,
+ *          concurrent users must be excluded using
+ *          @p flashAcquireExclusive() like for any sequence of operations.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ *
+ * @api
+ */
+void snorStartBatch(SNORDriver *devp) {
+
+  osalDbgCheck(devp != NULL);
+  osalDbgAssert((devp->state == FLASH_READY) || (devp->state == FLASH_ERASE),
+                "invalid state");
+
+  if (devp->batch == 0U) {
+    bus_acquire(devp->config->busp, devp->config->buscfg);
+  }
+  devp->batch++;
+}
+
+/**
+ * @brief   Ends a batch of operations.
+ * @details At the end of the outermost batch the buffered program data is
+ *          written and the bus is released.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ * @return              An error code.
+ * @retval FLASH_NO_ERROR           if the buffered data has been written.
+ * @retval FLASH_ERROR_PROGRAM      if a deferred program operation failed.
+ *
+ * @api
+ */
+flash_error_t snorStopBatch(SNORDriver *devp) {
+  flash_error_t err = FLASH_NO_ERROR;
+
+  osalDbgCheck(devp != NULL);
+  osalDbgAssert(devp->batch > 0U, "not within a batch");
+
+  devp->batch--;
+  if (devp->batch == 0U) {
+#if SNOR_PROGRAM_BUFFER_SIZE > 0
+    err = snor_pbuf_flush(devp);
+#endif
+    bus_release(devp->config->busp);
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Writes the buffered program data.
+ * @note    Data is written on the device before returning, it is required
+ *          before any power down when @p SNOR_PROGRAM_BUFFER_SIZE is not
+ *          zero.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ * @return              An error code.
+ * @retval FLASH_NO_ERROR           if the buffered data has been written.
+ * @retval FLASH_ERROR_PROGRAM      if a deferred program operation failed.
+ *
+ * @api
+ */
+flash_error_t snorSync(SNORDriver *devp) {
+  flash_error_t err = FLASH_NO_ERROR;
+
+  osalDbgCheck(devp != NULL);
+  osalDbgAssert((devp->state == FLASH_READY) || (devp->state == FLASH_ERASE),
+                "invalid state");
+
+#if SNOR_PROGRAM_BUFFER_SIZE > 0
+  if (devp->psize > 0U) {
+    snor_bus_acquire(devp);
+    err = snor_pbuf_flush(devp);
+    snor_bus_release(devp);
+  }
+#endif
+
+  return err;
+}
+
 #if (SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI) || defined(__DOXYGEN__)
 #if (WSPI_SUPPORTS_MEMMAP == TRUE) || defined(__DOXYGEN__)
 /**
@@ -798,6 +1220,9 @@ void snorMemoryMap(SNORDriver *devp, uint8_t **addrp) {
   /* Bus acquisition.*/
   bus_acquire(devp->config->busp, devp->config->buscfg);
 
+  /* Buffered data written before leaving the command mode.*/
+  (void) snor_cache_sync(devp);
+
 #if SNOR_DEVICE_SUPPORTS_XIP == TRUE
   /* Activating XIP mode in the device.*/
   snor_activate_xip(devp);
@@ -87,6 +87,34 @@
 #if !defined(SNOR_SPI_4BYTES_ADDRESS) || defined(__DOXYGEN__)
 #define SNOR_SPI_4BYTES_ADDRESS             FALSE
 #endif
+
+/**
+ * @brief   Size of the read cache.
+ * @details Reads smaller than the cache load a whole cache line starting
+ *          at the requested offset, following sequential reads are served
+ *          without accessing the bus.
+ * @note    Zero disables the read cache.
+ */
+#if !defined(SNOR_READ_CACHE_SIZE) || defined(__DOXYGEN__)
+#define SNOR_READ_CACHE_SIZE                0
+#endif
+
+/**
+ * @brief   Size of the program buffer.
+ * @details Contiguous program operations are accumulated and written
+ *          with a single page program command when the buffer is full,
+ *          at the page boundary, when a non-contiguous location is
+ *          programmed, before erase operations, before reading the
+ *          buffered area, on @p snorSync() and at the end of a batch.
+ * @note    Buffered data is lost on power loss, errors of deferred
+ *          program operations are returned by the operation performing
+ *          the write.
+ * @note    It must not exceed the device page size, zero disables the
+ *          program buffer.
+ */
+#if !defined(SNOR_PROGRAM_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define SNOR_PROGRAM_BUFFER_SIZE            0
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -103,6 +131,14 @@
 #error "invalid SNOR_BUS_DRIVER setting"
 #endif
 
+#if SNOR_READ_CACHE_SIZE < 0
+#error "invalid SNOR_READ_CACHE_SIZE setting"
+#endif
+
+#if SNOR_PROGRAM_BUFFER_SIZE < 0
+#error "invalid SNOR_PROGRAM_BUFFER_SIZE setting"
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -152,6 +188,18 @@ typedef struct snor_nocache_buffer {
    */
   wspi_command_t                cmd;
 #endif
+#if (SNOR_READ_CACHE_SIZE > 0) || defined(__DOXYGEN__)
+  /**
+   * @brief   Read cache line.
+   */
+  uint8_t                       rcache[SNOR_READ_CACHE_SIZE];
+#endif
+#if (SNOR_PROGRAM_BUFFER_SIZE > 0) || defined(__DOXYGEN__)
+  /**
+   * @brief   Program buffer.
+   */
+  uint8_t                       pbuf[SNOR_PROGRAM_BUFFER_SIZE];
+#endif
 } snor_nocache_buffer_t;
 
 /**
@@ -173,6 +221,30 @@ typedef struct {
    * @brief   Non-cacheable buffer associated to this instance.
    */
   snor_nocache_buffer_t         *nocache;
+  /**
+   * @brief   Batch nesting counter, the bus is owned while not zero.
+   */
+  unsigned                      batch;
+#if (SNOR_READ_CACHE_SIZE > 0) || defined(__DOXYGEN__)
+  /**
+   * @brief   Flash offset of the read cache line.
+   */
+  flash_offset_t                roffset;
+  /**
+   * @brief   Valid bytes in the read cache line, zero if invalid.
+   */
+  size_t                        rsize;
+#endif
+#if (SNOR_PROGRAM_BUFFER_SIZE > 0) || defined(__DOXYGEN__)
+  /**
+   * @brief   Flash offset of the program buffer.
+   */
+  flash_offset_t                poffset;
+  /**
+   * @brief   Bytes in the program buffer, zero if empty.
+   */
+  size_t                        psize;
+#endif
 #if (SNOR_USE_MUTUAL_EXCLUSION == TRUE) || defined(__DOXYGEN__)
   /**
    * @brief   Mutex protecting SNOR.
@@ -232,6 +304,9 @@ extern "C" {
   void snorObjectInit(SNORDriver *devp, snor_nocache_buffer_t *nocache);
   void snorStart(SNORDriver *devp, const SNORConfig *config);
   void snorStop(SNORDriver *devp);
+  void snorStartBatch(SNORDriver *devp);
+  flash_error_t snorStopBatch(SNORDriver *devp);
+  flash_error_t snorSync(SNORDriver *devp);
 #if (SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI) || defined(__DOXYGEN__)
 #if (WSPI_SUPPORTS_MEMMAP == TRUE) || defined(__DOXYGEN__)
   void snorMemoryMap(SNORDriver *devp, uint8_t ** addrp);
@@ -28,6 +28,8 @@
  * @{
  */
 
+#include <string.h>
+
 #include "hal.h"
 #include "chprintf.h"
 #include "memstreams.h"
@@ -35,31 +37,154 @@
 #define MAX_FILLER 11
 #define FLOAT_PRECISION 9
 
+/* Output state of a formatting operation, characters are accumulated and
+   written to the stream in blocks.*/
+typedef struct {
+  BaseSequentialStream *chp;
+#if CHPRINTF_BUFFER_SIZE > 0
+  size_t cnt;
+  uint8_t buf[CHPRINTF_BUFFER_SIZE];
+#endif
+} chprintf_output_t;
+
+/* Two decimal digits for each number from 0 to 99.*/
+static const char digit_pairs[201] =
+  "00010203040506070809"
+  "10111213141516171819"
+  "20212223242526272829"
+  "30313233343536373839"
+  "40414243444546474849"
+  "50515253545556575859"
+  "60616263646566676869"
+  "70717273747576777879"
+  "80818283848586878889"
+  "90919293949596979899";
+
+static void out_flush(chprintf_output_t *op) {
+
+#if CHPRINTF_BUFFER_SIZE > 0
+  if (op->cnt > 0U) {
+    (void) streamWrite(op->chp, op->buf, op->cnt);
+    op->cnt = 0U;
+  }
+#else
+  (void)op;
+#endif
+}
+
+static void out_put(chprintf_output_t *op, char c) {
+
+#if CHPRINTF_BUFFER_SIZE > 0
+  if (op->cnt >= (size_t)CHPRINTF_BUFFER_SIZE) {
+    out_flush(op);
+  }
+  op->buf[op->cnt++] = (uint8_t)c;
+#else
+  (void) streamPut(op->chp, (uint8_t)c);
+#endif
+}
+
+static void out_write(chprintf_output_t *op, const char *s, size_t n) {
+
+#if CHPRINTF_BUFFER_SIZE > 0
+  if (n > (size_t)CHPRINTF_BUFFER_SIZE - op->cnt) {
+    out_flush(op);
+
+    /* Runs not fitting the buffer are written directly.*/
+    if (n >= (size_t)CHPRINTF_BUFFER_SIZE) {
+      (void) streamWrite(op->chp, (const uint8_t *)s, n);
+      return;
+    }
+  }
+  memcpy(&op->buf[op->cnt], s, n);
+  op->cnt += n;
+#else
+  if (n > 0U) {
+    (void) streamWrite(op->chp, (const uint8_t *)s, n);
+  }
+#endif
+}
+
+static void out_fill(chprintf_output_t *op, char c, int n) {
+
+#if CHPRINTF_BUFFER_SIZE > 0
+  while (n > 0) {
+    size_t k;
+
+    if (op->cnt >= (size_t)CHPRINTF_BUFFER_SIZE) {
+      out_flush(op);
+    }
+    k = (size_t)CHPRINTF_BUFFER_SIZE - op->cnt;
+    if (k > (size_t)n) {
+      k = (size_t)n;
+    }
+    memset(&op->buf[op->cnt], c, k);
+    op->cnt += k;
+    n -= (int)k;
+  }
+#else
+  while (n-- > 0) {
+    (void) streamPut(op->chp, (uint8_t)c);
+  }
+#endif
+}
+
+static int out_done(chprintf_output_t *op, int n) {
+
+  out_flush(op);
+
+  return n;
+}
+
 static char *long_to_string_with_divisor(char *p,
                                          long num,
                                          unsigned radix,
                                          long divisor) {
   int i;
   char *q;
-  long l, ll;
+  unsigned long l, ll;
 
-  l = num;
+  l = (unsigned long)num;
   if (divisor == 0) {
-    ll = num;
+    ll = l;
   } else {
-    ll = divisor;
+    ll = (unsigned long)divisor;
   }
 
   q = p + MAX_FILLER;
-  do {
-    i = (int)(l % radix);
-    i += '0';
-    if (i > '9') {
-      i += 'A' - '0' - 10;
+  if (radix == 10U) {
+    /* Two digits for each division, the number of digits is still
+       determined by the divisor.*/
+    while (ll >= 100UL) {
+      i = (int)(l % 100UL) * 2;
+      *--q = digit_pairs[i + 1];
+      *--q = digit_pairs[i];
+      l /= 100UL;
+      ll /= 100UL;
+    }
+    if (ll >= 10UL) {
+      i = (int)(l % 100UL) * 2;
+      *--q = digit_pairs[i + 1];
+      *--q = digit_pairs[i];
     }
-    *--q = i;
-    l /= radix;
-  } while ((ll /= radix) != 0);
+    else {
+      *--q = (char)('0' + (int)(l % 10UL));
+    }
+  }
+  else {
+    /* Radixes 8 and 16, digits are extracted by shifting.*/
+    unsigned shift = (radix == 16U) ? 4U : 3U;
+
+    do {
+      i = (int)(l & ((unsigned long)radix - 1UL));
+      i += '0';
+      if (i > '9') {
+        i += 'A' - '0' - 10;
+      }
+      *--q = i;
+      l >>= shift;
+    } while ((ll >>= shift) != 0UL);
+  }
 
   i = (int)(p + MAX_FILLER - q);
   do
@@ -112,6 +237,9 @@ static char *ftoa(char *p, double num, unsigned long precision) {
  *          - <b>c</b> character.
  *          - <b>s</b> string.
  *          .
+ * @note    If @p CHPRINTF_BUFFER_SIZE is not zero then the output is
+ *          accumulated in a buffer of that size allocated on the stack and
+ *          written to the stream in blocks.
  *
  * @param[in] chp       pointer to a @p BaseSequentialStream implementing object
  * @param[in] fmt       formatting string
@@ -127,6 +255,7 @@ int chvprintf(BaseSequentialStream *chp, const char *fmt, va_list ap) {
   int n = 0;
   bool is_long, left_align, do_sign;
   long l;
+  chprintf_output_t out;
 #if CHPRINTF_USE_FLOAT
   float f;
   char tmpbuf[2*MAX_FILLER + 1];
@@ -134,15 +263,26 @@ int chvprintf(BaseSequentialStream *chp, const char *fmt, va_list ap) {
   char tmpbuf[MAX_FILLER + 1];
 #endif
 
+  out.chp = chp;
+#if CHPRINTF_BUFFER_SIZE > 0
+  out.cnt = 0U;
+#endif
+
   while (true) {
     c = *fmt++;
     if (c == 0) {
-      return n;
+      return out_done(&out, n);
     }
     
     if (c != '%') {
-      streamPut(chp, (uint8_t)c);
-      n++;
+      /* Literal characters are output as a single run.*/
+      const char *run = fmt - 1;
+
+      while ((*fmt != 0) && (*fmt != '%')) {
+        fmt++;
+      }
+      out_write(&out, run, (size_t)(fmt - run));
+      n += (int)(fmt - run);
       continue;
     }
     
@@ -181,7 +321,7 @@ int chvprintf(BaseSequentialStream *chp, const char *fmt, va_list ap) {
       while (true) {
         c = *fmt++;
         if (c == 0) {
-          return n;
+          return out_done(&out, n);
         }
         if (c >= '0' && c <= '9') {
           c -= '0';
@@ -198,7 +338,7 @@ int chvprintf(BaseSequentialStream *chp, const char *fmt, va_list ap) {
     if (c == '.') {
       c = *fmt++;
       if (c == 0) {
-        return n;
+        return out_done(&out, n);
       }
       if (c == '*') {
         precision = va_arg(ap, int);
@@ -210,7 +350,7 @@ int chvprintf(BaseSequentialStream *chp, const char *fmt, va_list ap) {
           precision = precision * 10 + c;
           c = *fmt++;
           if (c == 0) {
-            return n;
+            return out_done(&out, n);
           }
         }
       }
@@ -221,7 +361,7 @@ int chvprintf(BaseSequentialStream *chp, const char *fmt, va_list ap) {
       is_long = true;
       c = *fmt++;
       if (c == 0) {
-        return n;
+        return out_done(&out, n);
       }
     }
     else {
@@ -315,24 +455,20 @@ unsigned_common:
     }
     if (width < 0) {
       if ((*s == '-' || *s == '+') && filler == '0') {
-        streamPut(chp, (uint8_t)*s++);
+        out_put(&out, *s++);
         n++;
         i--;
       }
-      do {
-        streamPut(chp, (uint8_t)filler);
-        n++;
-      } while (++width != 0);
-    }
-    while (--i >= 0) {
-      streamPut(chp, (uint8_t)*s++);
-      n++;
+      out_fill(&out, filler, -width);
+      n -= width;
+      width = 0;
     }
+    out_write(&out, s, (size_t)i);
+    n += i;
 
-    while (width) {
-      streamPut(chp, (uint8_t)filler);
-      n++;
-      width--;
+    if (width > 0) {
+      out_fill(&out, filler, width);
+      n += width;
     }
   }
 }
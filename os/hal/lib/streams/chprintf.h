@@ -36,6 +36,19 @@
 #define CHPRINTF_USE_FLOAT          FALSE
 #endif
 
+/**
+ * @brief   Output buffer size.
+ * @details Formatted characters are accumulated in a buffer of this size,
+ *          allocated on the stack, and written to the stream in blocks.
+ *          Zero disables the buffering, characters are still written in
+ *          runs when possible.
+ * @note    The buffer adds to the stack usage of every thread calling
+ *          @p chprintf(), size the working areas accordingly.
+ */
+#if !defined(CHPRINTF_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define CHPRINTF_BUFFER_SIZE        0
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -0,0 +1,13 @@
+# List of all the host platform files.
+PLATFORMSRC = ${CHIBIOS}/os/hal/ports/simulator/host/hal_lld.c \
+              ${CHIBIOS}/os/hal/ports/simulator/console.c \
+              ${CHIBIOS}/os/hal/ports/simulator/hal_pal_lld.c \
+              ${CHIBIOS}/os/hal/ports/simulator/hal_st_lld.c
+
+# Required include directories
+PLATFORMINC = ${CHIBIOS}/os/hal/ports/simulator/host \
+              ${CHIBIOS}/os/hal/ports/simulator
+
+# Shared variables
+ALLCSRC += $(PLATFORMSRC)
+ALLINC  += $(PLATFORMINC)
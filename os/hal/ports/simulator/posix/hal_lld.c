@@ -25,6 +25,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/time.h>
+#include <sched.h>
 
 #include "hal.h"
 
@@ -36,7 +37,11 @@
 /* Driver local variables and types.                                         */
 /*===========================================================================*/
 
-static struct timeval nextcnt;
+#if PORT_SIM_SMP == TRUE
+static struct timeval nextcnt[PORT_CORES_NUMBER];
+#else
+static struct timeval nextcnt[1];
+#endif
 static struct timeval tick = {0UL, 1000000UL / OSAL_ST_FREQUENCY};
 
 /*===========================================================================*/
@@ -55,33 +60,72 @@ static struct timeval tick = {0UL, 1000000UL / OSAL_ST_FREQUENCY};
  * @brief Low level HAL driver initialization.
  */
 void hal_lld_init(void) {
+  unsigned i;
 
 #if defined(__APPLE__)
   puts("ChibiOS/RT simulator (OS X)\n");
 #else
   puts("ChibiOS/RT simulator (Linux)\n");
 #endif
-  gettimeofday(&nextcnt, NULL);
-  timeradd(&nextcnt, &tick, &nextcnt);
+  for (i = 0U; i < sizeof (nextcnt) / sizeof (nextcnt[0]); i++) {
+    gettimeofday(&nextcnt[i], NULL);
+    timeradd(&nextcnt[i], &tick, &nextcnt[i]);
+  }
+
+#if SIM_CORE1_START == TRUE
+  {
+    extern void SIM_CORE1_ENTRY_POINT(void);
+
+    /* The second core is started immediately, it is supposed to wait for
+       the system initialization on core zero.*/
+    _sim_start_core(1U, SIM_CORE1_ENTRY_POINT);
+  }
+#endif
 }
 
 /**
  * @brief   Interrupt simulation.
+ * @note    In SMP mode each core checks its own system tick and inter-core
+ *          notifications, serial, MAC and SPI interrupts are served by
+ *          core zero only.
  */
 void _sim_check_for_interrupts(void) {
   struct timeval tv;
   bool int_occurred = false;
+#if PORT_SIM_SMP == TRUE
+  core_id_t core_id = port_get_core_id();
+
+  /* Simulated inter-core interrupt.*/
+  if (__atomic_exchange_n(&port_notifications[core_id], false,
+                          __ATOMIC_ACQUIRE)) {
+    int_occurred = true;
+  }
+#else
+  core_id_t core_id = 0U;
+#endif
 
 #if HAL_USE_SERIAL
-  if (sd_lld_interrupt_pending()) {
+  if ((core_id == 0U) && sd_lld_interrupt_pending()) {
+    int_occurred = true;
+  }
+#endif
+
+#if HAL_USE_MAC
+  if ((core_id == 0U) && mac_lld_interrupt_pending()) {
+    int_occurred = true;
+  }
+#endif
+
+#if HAL_USE_SPI
+  if ((core_id == 0U) && spi_lld_interrupt_pending()) {
     int_occurred = true;
   }
 #endif
 
   gettimeofday(&tv, NULL);
-  if (timercmp(&tv, &nextcnt, >=)) {
+  if (timercmp(&tv, &nextcnt[core_id], >=)) {
     int_occurred = true;
-    timeradd(&nextcnt, &tick, &nextcnt);
+    timeradd(&nextcnt[core_id], &tick, &nextcnt[core_id]);
 
     CH_IRQ_PROLOGUE();
 
@@ -93,11 +137,24 @@ void _sim_check_for_interrupts(void) {
   }
 
   if (int_occurred) {
+#if PORT_SIM_SMP == TRUE
+    port_lock();
+#endif
     __dbg_check_lock();
     if (chSchIsPreemptionRequired())
       chSchDoPreemption();
     __dbg_check_unlock();
+#if PORT_SIM_SMP == TRUE
+    port_unlock();
+#endif
+  }
+#if PORT_SIM_SMP == TRUE
+  else {
+    /* Nothing to do on this core, giving the host CPU to the other cores,
+       the host could have less CPUs than the simulated cores.*/
+    sched_yield();
   }
+#endif
 }
 
 /** @} */
@@ -53,10 +53,29 @@
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Starts the simulated core 1 after initialization.
+ * @note    Only available in SMP mode.
+ */
+#if !defined(SIM_CORE1_START) || defined(__DOXYGEN__)
+#define SIM_CORE1_START                     FALSE
+#endif
+
+/**
+ * @brief   Symbol for core 1 entry point.
+ */
+#if !defined(SIM_CORE1_ENTRY_POINT) || defined(__DOXYGEN__)
+#define SIM_CORE1_ENTRY_POINT               c1_main
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (SIM_CORE1_START == TRUE) && (PORT_SIM_SMP == FALSE)
+#error "SIM_CORE1_START requires CH_CFG_SMP_MODE"
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -0,0 +1,523 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_mac_lld.c
+ * @brief   Posix simulator low level MAC driver code.
+ * @details The simulated MAC has a ring of receive buffers written by a
+ *          simulated wire, buffers are owned by the upper layer between
+ *          the get and release of a receive descriptor exactly like DMA
+ *          descriptors in real MACs, this allows to exercise zero-copy
+ *          receive paths.<br>
+ *          The wire is either a loopback, transmitted frames are received
+ *          back, or a TAP interface on the host.
+ *
+ * @addtogroup POSIX_MAC
+ * @{
+ */
+
+#include <string.h>
+#include <errno.h>
+
+#include "hal.h"
+
+#if (HAL_USE_MAC == TRUE) && (SIM_MAC_USE_TAP == TRUE)
+#include <sys/ioctl.h>
+#include <linux/if.h>
+#include <linux/if_tun.h>
+#endif
+
+#if HAL_USE_MAC || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Ethernet driver 1.
+ */
+MACDriver ETHD1;
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+static sim_mac_buffer_t __eth_buf_rx[SIM_MAC_RECEIVE_BUFFERS];
+static sim_mac_buffer_t __eth_buf_tx[SIM_MAC_TRANSMIT_BUFFERS];
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+#if (SIM_MAC_USE_TAP == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Loops a transmitted frame back into the receive ring.
+ * @note    Frames are dropped if the next receive buffer is still owned
+ *          by the upper layer, like a real MAC with a stalled DMA.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] txbp      pointer to the transmitted buffer
+ *
+ * @notapi
+ */
+static void mac_lld_loopback(MACDriver *macp, const sim_mac_buffer_t *txbp) {
+  sim_mac_buffer_t *rxbp = &__eth_buf_rx[macp->rxwr];
+
+  if (rxbp->state != SIM_MAC_BUF_FREE) {
+    macp->rxdropped++;
+    return;
+  }
+
+  memcpy(rxbp->data, txbp->data, txbp->size);
+  rxbp->size  = txbp->size;
+  rxbp->state = SIM_MAC_BUF_FULL;
+  macp->rxwr  = (macp->rxwr + 1U) % SIM_MAC_RECEIVE_BUFFERS;
+  macp->pending |= MAC_FLAGS_RX;
+}
+#endif
+
+#if (SIM_MAC_USE_TAP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Moves frames from the TAP interface into the receive ring.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ *
+ * @isr
+ */
+static void mac_lld_tap_poll(MACDriver *macp) {
+
+  while (true) {
+    sim_mac_buffer_t *rxbp = &__eth_buf_rx[macp->rxwr];
+    ssize_t n;
+
+    if (rxbp->state != SIM_MAC_BUF_FREE) {
+      return;
+    }
+
+    /* The buffer is owned by the wire while free, no locking required
+       for filling it.*/
+    n = read(macp->tapfd, rxbp->data, SIM_MAC_BUFFERS_SIZE);
+    if (n <= 0) {
+      return;
+    }
+
+    osalSysLockFromISR();
+    rxbp->size  = (size_t)n;
+    rxbp->state = SIM_MAC_BUF_FULL;
+    macp->rxwr  = (macp->rxwr + 1U) % SIM_MAC_RECEIVE_BUFFERS;
+    macp->pending |= MAC_FLAGS_RX;
+    osalSysUnlockFromISR();
+  }
+}
+#endif
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Simulated MAC interrupt.
+ * @details Frames transmitted or received since the previous check are
+ *          notified to the waiting threads and to the event listeners.
+ *
+ * @return              The interrupt status.
+ * @retval false        if no interrupt has been served.
+ * @retval true         if an interrupt has been served.
+ *
+ * @isr
+ */
+bool mac_lld_interrupt_pending(void) {
+  MACDriver *macp = &ETHD1;
+  eventflags_t pending;
+
+  if (macp->state != MAC_ACTIVE) {
+    return false;
+  }
+
+  OSAL_IRQ_PROLOGUE();
+
+#if SIM_MAC_USE_TAP == TRUE
+  mac_lld_tap_poll(macp);
+#endif
+
+  osalSysLockFromISR();
+  pending = macp->pending;
+  macp->pending = (eventflags_t)0;
+  osalSysUnlockFromISR();
+
+  if ((pending & MAC_FLAGS_TX) != (eventflags_t)0) {
+    __mac_tx_wakeup(macp);
+  }
+
+  if ((pending & MAC_FLAGS_RX) != (eventflags_t)0) {
+    __mac_rx_wakeup(macp);
+  }
+
+  if (pending != (eventflags_t)0) {
+    __mac_callback(macp);
+  }
+
+  OSAL_IRQ_EPILOGUE();
+
+  return pending != (eventflags_t)0;
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level MAC initialization.
+ *
+ * @notapi
+ */
+void mac_lld_init(void) {
+
+  macObjectInit(&ETHD1);
+  ETHD1.link_up = false;
+  ETHD1.tapfd   = -1;
+}
+
+/**
+ * @brief   Configures and activates the MAC peripheral.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ *
+ * @notapi
+ */
+void mac_lld_start(MACDriver *macp) {
+  unsigned i;
+
+  /* Buffers initialization, all receive buffers owned by the wire.*/
+  for (i = 0U; i < SIM_MAC_RECEIVE_BUFFERS; i++) {
+    __eth_buf_rx[i].state = SIM_MAC_BUF_FREE;
+    __eth_buf_rx[i].size  = 0U;
+  }
+  for (i = 0U; i < SIM_MAC_TRANSMIT_BUFFERS; i++) {
+    __eth_buf_tx[i].state = SIM_MAC_BUF_FREE;
+    __eth_buf_tx[i].size  = 0U;
+  }
+  macp->rxwr      = 0U;
+  macp->rxrd      = 0U;
+  macp->txnext    = 0U;
+  macp->pending   = (eventflags_t)0;
+  macp->rxdropped = 0U;
+
+#if SIM_MAC_USE_TAP == TRUE
+  if (macp->tapfd == -1) {
+    struct ifreq ifr;
+
+    macp->tapfd = open("/dev/net/tun", O_RDWR | O_NONBLOCK);
+    if (macp->tapfd == -1) {
+      printf("ETHD1: Unable to open /dev/net/tun (%d)\n", errno);
+      return;
+    }
+
+    memset(&ifr, 0, sizeof (ifr));
+    ifr.ifr_flags = IFF_TAP | IFF_NO_PI;
+    strncpy(ifr.ifr_name, SIM_MAC_TAP_NAME, IFNAMSIZ - 1);
+    if (ioctl(macp->tapfd, TUNSETIFF, &ifr) != 0) {
+      printf("ETHD1: Unable to attach to %s (%d)\n", SIM_MAC_TAP_NAME, errno);
+      close(macp->tapfd);
+      macp->tapfd = -1;
+      return;
+    }
+    printf("ETHD1: Attached to %s\n", SIM_MAC_TAP_NAME);
+  }
+#endif
+}
+
+/**
+ * @brief   Deactivates the MAC peripheral.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ *
+ * @notapi
+ */
+void mac_lld_stop(MACDriver *macp) {
+
+  macp->link_up = false;
+
+#if SIM_MAC_USE_TAP == TRUE
+  if (macp->tapfd != -1) {
+    close(macp->tapfd);
+    macp->tapfd = -1;
+  }
+#endif
+}
+
+/**
+ * @brief   Returns a transmission descriptor.
+ * @details One of the available transmission descriptors is locked and
+ *          returned.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[out] tdp      pointer to a @p MACTransmitDescriptor structure
+ * @return              The operation status.
+ * @retval MSG_OK       the descriptor has been obtained.
+ * @retval MSG_TIMEOUT  descriptor not available.
+ *
+ * @notapi
+ */
+msg_t mac_lld_get_transmit_descriptor(MACDriver *macp,
+                                      MACTransmitDescriptor *tdp) {
+  sim_mac_buffer_t *txbp;
+
+  if (!macp->link_up) {
+    return MSG_TIMEOUT;
+  }
+
+  txbp = &__eth_buf_tx[macp->txnext];
+  if (txbp->state != SIM_MAC_BUF_FREE) {
+    return MSG_TIMEOUT;
+  }
+
+  txbp->state  = SIM_MAC_BUF_LOCKED;
+  macp->txnext = (macp->txnext + 1U) % SIM_MAC_TRANSMIT_BUFFERS;
+
+  tdp->offset   = 0U;
+  tdp->size     = SIM_MAC_BUFFERS_SIZE;
+  tdp->physdesc = txbp;
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Releases a transmit descriptor and starts the transmission of the
+ *          enqueued data as a single frame.
+ * @note    The simulated wire is immediate, the transmit buffer is freed
+ *          and the transmit interrupt is raised on the next check.
+ *
+ * @param[in] tdp       the pointer to the @p MACTransmitDescriptor structure
+ *
+ * @notapi
+ */
+void mac_lld_release_transmit_descriptor(MACTransmitDescriptor *tdp) {
+  MACDriver *macp = &ETHD1;
+  sim_mac_buffer_t *txbp = tdp->physdesc;
+
+  osalDbgAssert(txbp->state == SIM_MAC_BUF_LOCKED,
+                "attempt to release a descriptor not locked");
+
+  osalSysLock();
+
+  txbp->size = tdp->offset;
+#if SIM_MAC_USE_TAP == TRUE
+  if (macp->tapfd != -1) {
+    (void)write(macp->tapfd, txbp->data, txbp->size);
+  }
+#else
+  mac_lld_loopback(macp, txbp);
+#endif
+  txbp->state = SIM_MAC_BUF_FREE;
+  macp->pending |= MAC_FLAGS_TX;
+
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Returns a receive descriptor.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[out] rdp      pointer to a @p MACReceiveDescriptor structure
+ * @return              The operation status.
+ * @retval MSG_OK       the descriptor has been obtained.
+ * @retval MSG_TIMEOUT  descriptor not available.
+ *
+ * @notapi
+ */
+msg_t mac_lld_get_receive_descriptor(MACDriver *macp,
+                                     MACReceiveDescriptor *rdp) {
+  sim_mac_buffer_t *rxbp = &__eth_buf_rx[macp->rxrd];
+
+  if (rxbp->state != SIM_MAC_BUF_FULL) {
+    return MSG_TIMEOUT;
+  }
+
+  rxbp->state = SIM_MAC_BUF_LOCKED;
+  macp->rxrd  = (macp->rxrd + 1U) % SIM_MAC_RECEIVE_BUFFERS;
+
+  rdp->offset   = 0U;
+  rdp->size     = rxbp->size;
+  rdp->physdesc = rxbp;
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Releases a receive descriptor.
+ * @details The descriptor and its buffer are made available for more incoming
+ *          frames.
+ * @note    Descriptors can be released in any order.
+ *
+ * @param[in] rdp       the pointer to the @p MACReceiveDescriptor structure
+ *
+ * @notapi
+ */
+void mac_lld_release_receive_descriptor(MACReceiveDescriptor *rdp) {
+
+  osalDbgAssert(rdp->physdesc->state == SIM_MAC_BUF_LOCKED,
+                "attempt to release a descriptor not locked");
+
+  osalSysLock();
+  rdp->physdesc->state = SIM_MAC_BUF_FREE;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Updates and returns the link status.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @return              The link status.
+ * @retval true         if the link is active.
+ * @retval false        if the link is down.
+ *
+ * @notapi
+ */
+bool mac_lld_poll_link_status(MACDriver *macp) {
+
+#if SIM_MAC_USE_TAP == TRUE
+  return macp->link_up = (macp->tapfd != -1);
+#else
+  return macp->link_up = true;
+#endif
+}
+
+/**
+ * @brief   Writes to a transmit descriptor's stream.
+ *
+ * @param[in] tdp       pointer to a @p MACTransmitDescriptor structure
+ * @param[in] buf       pointer to the buffer containing the data to be
+ *                      written
+ * @param[in] size      number of bytes to be written
+ * @return              The number of bytes written into the descriptor's
+ *                      stream, this value can be less than the amount
+ *                      specified in the parameter @p size if the maximum
+ *                      frame size is reached.
+ *
+ * @notapi
+ */
+size_t mac_lld_write_transmit_descriptor(MACTransmitDescriptor *tdp,
+                                         uint8_t *buf,
+                                         size_t size) {
+
+  if (size > tdp->size - tdp->offset)
+    size = tdp->size - tdp->offset;
+
+  if (size > 0) {
+    memcpy(tdp->physdesc->data + tdp->offset, buf, size);
+    tdp->offset += size;
+  }
+  return size;
+}
+
+/**
+ * @brief   Reads from a receive descriptor's stream.
+ *
+ * @param[in] rdp       pointer to a @p MACReceiveDescriptor structure
+ * @param[in] buf       pointer to the buffer that will receive the read data
+ * @param[in] size      number of bytes to be read
+ * @return              The number of bytes read from the descriptor's
+ *                      stream, this value can be less than the amount
+ *                      specified in the parameter @p size if there are
+ *                      no more bytes to read.
+ *
+ * @notapi
+ */
+size_t mac_lld_read_receive_descriptor(MACReceiveDescriptor *rdp,
+                                       uint8_t *buf,
+                                       size_t size) {
+
+  if (size > rdp->size - rdp->offset)
+    size = rdp->size - rdp->offset;
+
+  if (size > 0) {
+    memcpy(buf, rdp->physdesc->data + rdp->offset, size);
+    rdp->offset += size;
+  }
+  return size;
+}
+
+#if MAC_USE_ZERO_COPY || defined(__DOXYGEN__)
+/**
+ * @brief   Returns a pointer to the next transmit buffer in the descriptor
+ *          chain.
+ * @note    The API guarantees that enough buffers can be requested to fill
+ *          a whole frame.
+ *
+ * @param[in] tdp       pointer to a @p MACTransmitDescriptor structure
+ * @param[in] size      size of the requested buffer. Specify the frame size
+ *                      on the first call then scale the value down subtracting
+ *                      the amount of data already copied into the previous
+ *                      buffers.
+ * @param[out] sizep    pointer to variable receiving the buffer size, it is
+ *                      zero when the last buffer has already been returned.
+ *                      Note that a returned size lower than the amount
+ *                      requested means that more buffers must be requested
+ *                      in order to fill the frame data entirely.
+ * @return              Pointer to the returned buffer.
+ * @retval NULL         if the buffer chain has been entirely scanned.
+ *
+ * @notapi
+ */
+uint8_t *mac_lld_get_next_transmit_buffer(MACTransmitDescriptor *tdp,
+                                          size_t size,
+                                          size_t *sizep) {
+
+  if (tdp->offset == 0) {
+    *sizep      = tdp->size;
+    tdp->offset = size;
+    return tdp->physdesc->data;
+  }
+  *sizep = 0;
+  return NULL;
+}
+
+/**
+ * @brief   Returns a pointer to the next receive buffer in the descriptor
+ *          chain.
+ * @note    The API guarantees that the descriptor chain contains a whole
+ *          frame.
+ *
+ * @param[in] rdp       pointer to a @p MACReceiveDescriptor structure
+ * @param[out] sizep    pointer to variable receiving the buffer size, it is
+ *                      zero when the last buffer has already been returned.
+ * @return              Pointer to the returned buffer.
+ * @retval NULL         if the buffer chain has been entirely scanned.
+ *
+ * @notapi
+ */
+const uint8_t *mac_lld_get_next_receive_buffer(MACReceiveDescriptor *rdp,
+                                               size_t *sizep) {
+
+  if (rdp->size > 0) {
+    *sizep      = rdp->size;
+    rdp->offset = rdp->size;
+    rdp->size   = 0;
+    return rdp->physdesc->data;
+  }
+  *sizep = 0;
+  return NULL;
+}
+#endif /* MAC_USE_ZERO_COPY */
+
+#endif /* HAL_USE_MAC */
+
+/** @} */
@@ -0,0 +1,214 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_mac_lld.h
+ * @brief   Posix simulator low level MAC driver header.
+ *
+ * @addtogroup POSIX_MAC
+ * @{
+ */
+
+#ifndef HAL_MAC_LLD_H
+#define HAL_MAC_LLD_H
+
+#if HAL_USE_MAC || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   This implementation supports the zero-copy mode API.
+ */
+#define MAC_SUPPORTS_ZERO_COPY      TRUE
+
+/**
+ * @name    Simulated buffer states
+ * @{
+ */
+#define SIM_MAC_BUF_FREE            0U  /**< Owned by the simulated DMA.    */
+#define SIM_MAC_BUF_FULL            1U  /**< Frame ready to be fetched.     */
+#define SIM_MAC_BUF_LOCKED          2U  /**< Owned by a descriptor.         */
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Number of available transmit buffers.
+ */
+#if !defined(SIM_MAC_TRANSMIT_BUFFERS) || defined(__DOXYGEN__)
+#define SIM_MAC_TRANSMIT_BUFFERS            2
+#endif
+
+/**
+ * @brief   Number of available receive buffers.
+ */
+#if !defined(SIM_MAC_RECEIVE_BUFFERS) || defined(__DOXYGEN__)
+#define SIM_MAC_RECEIVE_BUFFERS             8
+#endif
+
+/**
+ * @brief   Maximum supported frame size.
+ */
+#if !defined(SIM_MAC_BUFFERS_SIZE) || defined(__DOXYGEN__)
+#define SIM_MAC_BUFFERS_SIZE                1522
+#endif
+
+/**
+ * @brief   Use a TAP interface as simulated wire.
+ * @details If enabled then frames are exchanged with the host through a
+ *          TAP interface, else transmitted frames are looped back to the
+ *          receiver.
+ * @note    The TAP interface must exist and be accessible by the user
+ *          running the simulator.
+ */
+#if !defined(SIM_MAC_USE_TAP) || defined(__DOXYGEN__)
+#define SIM_MAC_USE_TAP                     FALSE
+#endif
+
+/**
+ * @brief   Name of the TAP interface.
+ */
+#if !defined(SIM_MAC_TAP_NAME) || defined(__DOXYGEN__)
+#define SIM_MAC_TAP_NAME                    "tap0"
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (SIM_MAC_USE_TAP == TRUE) && !defined(__linux__)
+#error "SIM_MAC_USE_TAP is only supported on Linux hosts"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a simulated MAC buffer.
+ */
+typedef struct {
+  /**
+   * @brief   Buffer state.
+   */
+  volatile uint32_t             state;
+  /**
+   * @brief   Frame size.
+   */
+  size_t                        size;
+  /**
+   * @brief   Frame data.
+   */
+  uint8_t                       data[SIM_MAC_BUFFERS_SIZE];
+} sim_mac_buffer_t;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level fields of the MAC driver structure.
+ */
+#define mac_lld_driver_fields                                               \
+  /* Link status flag.*/                                                    \
+  bool                          link_up;                                    \
+  /* Next receive buffer to be written by the wire.*/                       \
+  unsigned                      rxwr;                                       \
+  /* Next receive buffer to be returned.*/                                  \
+  unsigned                      rxrd;                                       \
+  /* Next transmit buffer to be returned.*/                                 \
+  unsigned                      txnext;                                     \
+  /* Pending simulated interrupt sources.*/                                 \
+  eventflags_t                  pending;                                    \
+  /* Frames dropped because receive buffers were not available.*/           \
+  uint32_t                      rxdropped;                                  \
+  /* TAP interface file descriptor or -1.*/                                 \
+  int                           tapfd
+
+/**
+ * @brief   Low level fields of the MAC configuration structure.
+ */
+#define mac_lld_config_fields                                               \
+  /* MAC address.*/                                                         \
+  uint8_t                       *mac_address
+
+/**
+ * @brief   Low level fields of the MAC transmit descriptor structure.
+ */
+#define mac_lld_transmit_descriptor_fields                                  \
+  /* Pointer to the simulated buffer.*/                                     \
+  sim_mac_buffer_t              *physdesc
+
+/**
+ * @brief   Low level fields of the MAC receive descriptor structure.
+ */
+#define mac_lld_receive_descriptor_fields                                   \
+  /* Pointer to the simulated buffer.*/                                     \
+  sim_mac_buffer_t              *physdesc
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if !defined(__DOXYGEN__)
+extern MACDriver ETHD1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void mac_lld_init(void);
+  void mac_lld_start(MACDriver *macp);
+  void mac_lld_stop(MACDriver *macp);
+  msg_t mac_lld_get_transmit_descriptor(MACDriver *macp,
+                                        MACTransmitDescriptor *tdp);
+  void mac_lld_release_transmit_descriptor(MACTransmitDescriptor *tdp);
+  msg_t mac_lld_get_receive_descriptor(MACDriver *macp,
+                                       MACReceiveDescriptor *rdp);
+  void mac_lld_release_receive_descriptor(MACReceiveDescriptor *rdp);
+  bool mac_lld_poll_link_status(MACDriver *macp);
+  size_t mac_lld_write_transmit_descriptor(MACTransmitDescriptor *tdp,
+                                           uint8_t *buf,
+                                           size_t size);
+  size_t mac_lld_read_receive_descriptor(MACReceiveDescriptor *rdp,
+                                         uint8_t *buf,
+                                         size_t size);
+#if MAC_USE_ZERO_COPY
+  uint8_t *mac_lld_get_next_transmit_buffer(MACTransmitDescriptor *tdp,
+                                            size_t size,
+                                            size_t *sizep);
+  const uint8_t *mac_lld_get_next_receive_buffer(MACReceiveDescriptor *rdp,
+                                                 size_t *sizep);
+#endif /* MAC_USE_ZERO_COPY */
+  bool mac_lld_interrupt_pending(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_MAC */
+
+#endif /* HAL_MAC_LLD_H */
+
+/** @} */
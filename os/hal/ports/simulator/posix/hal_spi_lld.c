@@ -0,0 +1,487 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_spi_lld.c
+ * @brief   Posix simulator low level SPI driver code.
+ * @details The simulated SPI has a serial NOR flash attached, the device
+ *          understands the Micron N25Q command set in single line mode
+ *          so the serial NOR driver can be exercised unmodified.<br>
+ *          Transfers complete in background after the time required by
+ *          the simulated bit rate, page program and erase operations keep
+ *          the device busy for the configured times.
+ *
+ * @addtogroup POSIX_SPI
+ * @{
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+#include "hal.h"
+
+#if defined(SIM_SPI_NOR_FILE)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#if HAL_USE_SPI || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+#define NOR_SIZE                    (1UL << SIM_SPI_NOR_SIZE_LOG2)
+
+/**
+ * @name    Simulated NOR commands
+ * @{
+ */
+#define NOR_CMD_READ_ID             0x9FU
+#define NOR_CMD_READ                0x03U
+#define NOR_CMD_FAST_READ           0x0BU
+#define NOR_CMD_WRITE_ENABLE        0x06U
+#define NOR_CMD_WRITE_DISABLE       0x04U
+#define NOR_CMD_READ_STATUS         0x05U
+#define NOR_CMD_READ_FLAG_STATUS    0x70U
+#define NOR_CMD_CLEAR_FLAG_STATUS   0x50U
+#define NOR_CMD_PAGE_PROGRAM        0x02U
+#define NOR_CMD_SUBSECTOR_ERASE     0x20U
+#define NOR_CMD_SECTOR_ERASE        0xD8U
+#define NOR_CMD_BULK_ERASE          0xC7U
+/** @} */
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   SPI1 driver identifier.
+ */
+SPIDriver SPID1;
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Simulated NOR device state.
+ */
+static struct {
+  /* Flash array.*/
+  uint8_t                       *mem;
+  /* Bytes exchanged since the selection.*/
+  size_t                        phase;
+  /* Current command.*/
+  uint8_t                       cmd;
+  /* Current command address.*/
+  uint32_t                      addr;
+  /* Bytes programmed by the current command.*/
+  uint32_t                      nprog;
+  /* Write enable latch.*/
+  bool                          wel;
+  /* Current program or erase command accepted.*/
+  bool                          accepted;
+  /* Busy until this time.*/
+  uint64_t                      busy;
+} nor;
+
+#if !defined(SIM_SPI_NOR_FILE)
+static uint8_t nor_array[NOR_SIZE];
+#endif
+
+static const uint8_t nor_id[3] = {0x20U, 0xBAU, SIM_SPI_NOR_SIZE_LOG2};
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+static uint64_t spi_lld_time(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return ((uint64_t)ts.tv_sec * 1000000U) + ((uint64_t)ts.tv_nsec / 1000U);
+}
+
+static bool nor_is_busy(void) {
+
+  return spi_lld_time() < nor.busy;
+}
+
+static void nor_erase(uint32_t addr, uint32_t size, uint64_t duration) {
+
+  memset(&nor.mem[addr & ~(size - 1U)], 0xFF, size);
+  nor.busy = spi_lld_time() + duration;
+}
+
+/**
+ * @brief   Exchanges one byte with the simulated device.
+ *
+ * @param[in] tx        byte sent to the device
+ * @return              The byte received from the device.
+ *
+ * @notapi
+ */
+static uint8_t nor_exchange(uint8_t tx) {
+  size_t phase = nor.phase++;
+
+  /* Command phase.*/
+  if (phase == 0U) {
+    nor.cmd      = tx;
+    nor.addr     = 0U;
+    nor.nprog    = 0U;
+    nor.accepted = nor.wel && !nor_is_busy();
+    return 0xFFU;
+  }
+
+  switch (nor.cmd) {
+  case NOR_CMD_READ_ID:
+    return phase <= sizeof (nor_id) ? nor_id[phase - 1U] : 0x00U;
+  case NOR_CMD_READ_STATUS:
+    return (nor_is_busy() ? 0x01U : 0x00U) | (nor.wel ? 0x02U : 0x00U);
+  case NOR_CMD_READ_FLAG_STATUS:
+    return nor_is_busy() ? 0x00U : 0x80U;
+  case NOR_CMD_READ:
+  case NOR_CMD_FAST_READ:
+    if (phase <= 3U) {
+      nor.addr = (nor.addr << 8) | tx;
+      return 0xFFU;
+    }
+    if ((nor.cmd == NOR_CMD_FAST_READ) && (phase == 4U)) {
+      return 0xFFU;
+    }
+    if (nor_is_busy()) {
+      return 0xFFU;
+    }
+    return nor.mem[nor.addr++ & (NOR_SIZE - 1U)];
+  case NOR_CMD_PAGE_PROGRAM:
+    if (phase <= 3U) {
+      nor.addr = ((nor.addr << 8) | tx) & (NOR_SIZE - 1U);
+      return 0xFFU;
+    }
+    /* Programming wraps within the page.*/
+    if (nor.accepted) {
+      nor.mem[(nor.addr & ~0xFFU) | ((nor.addr + nor.nprog) & 0xFFU)] &= tx;
+      nor.nprog++;
+    }
+    return 0xFFU;
+  case NOR_CMD_SUBSECTOR_ERASE:
+  case NOR_CMD_SECTOR_ERASE:
+    if (phase <= 3U) {
+      nor.addr = ((nor.addr << 8) | tx) & (NOR_SIZE - 1U);
+    }
+    return 0xFFU;
+  default:
+    return 0xFFU;
+  }
+}
+
+/**
+ * @brief   End of a command, program and erase operations are started.
+ *
+ * @notapi
+ */
+static void nor_end(void) {
+
+  if (nor.phase == 0U) {
+    return;
+  }
+
+  switch (nor.cmd) {
+  case NOR_CMD_WRITE_ENABLE:
+    if (!nor_is_busy()) {
+      nor.wel = true;
+    }
+    break;
+  case NOR_CMD_WRITE_DISABLE:
+    nor.wel = false;
+    break;
+  case NOR_CMD_PAGE_PROGRAM:
+    if (nor.accepted && (nor.nprog > 0U)) {
+      nor.busy = spi_lld_time() + SIM_SPI_NOR_PROGRAM_TIME;
+      nor.wel  = false;
+    }
+    break;
+  case NOR_CMD_SUBSECTOR_ERASE:
+    if (nor.accepted && (nor.phase == 4U)) {
+      nor_erase(nor.addr, 0x1000U, SIM_SPI_NOR_ERASE_TIME);
+      nor.wel = false;
+    }
+    break;
+  case NOR_CMD_SECTOR_ERASE:
+    if (nor.accepted && (nor.phase == 4U)) {
+      nor_erase(nor.addr, 0x10000U, SIM_SPI_NOR_ERASE_TIME);
+      nor.wel = false;
+    }
+    break;
+  case NOR_CMD_BULK_ERASE:
+    if (nor.accepted) {
+      nor_erase(0U, NOR_SIZE, SIM_SPI_NOR_ERASE_TIME * 16U);
+      nor.wel = false;
+    }
+    break;
+  default:
+    break;
+  }
+}
+
+/**
+ * @brief   Starts the simulated transfer time.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of bytes transferred
+ *
+ * @notapi
+ */
+static void spi_lld_start_transfer(SPIDriver *spip, size_t n) {
+
+  spip->done   = spi_lld_time() + SIM_SPI_TRANSFER_TIME +
+                 (((uint64_t)n * 8U * 1000000U) / SIM_SPI_BITRATE);
+  spip->active = true;
+  spip->transfers++;
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Simulated SPI interrupt.
+ * @details The transfer in progress is completed when its time elapsed.
+ *
+ * @return              The interrupt status.
+ * @retval false        if no interrupt has been served.
+ * @retval true         if an interrupt has been served.
+ *
+ * @isr
+ */
+bool spi_lld_interrupt_pending(void) {
+  SPIDriver *spip = &SPID1;
+
+  if (!spip->active || (spi_lld_time() < spip->done)) {
+    return false;
+  }
+
+  OSAL_IRQ_PROLOGUE();
+
+  spip->active = false;
+  _spi_isr_code(spip);
+
+  OSAL_IRQ_EPILOGUE();
+
+  return true;
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level SPI driver initialization.
+ *
+ * @notapi
+ */
+void spi_lld_init(void) {
+
+  spiObjectInit(&SPID1);
+  SPID1.active    = false;
+  SPID1.transfers = 0U;
+  SPID1.commands  = 0U;
+
+#if defined(SIM_SPI_NOR_FILE)
+  {
+    struct stat st;
+    int fd;
+
+    fd = open(SIM_SPI_NOR_FILE, O_RDWR | O_CREAT, 0644);
+    if ((fd == -1) || (fstat(fd, &st) != 0)) {
+      printf("SPID1: Unable to open %s (%d)\n", SIM_SPI_NOR_FILE, errno);
+      exit(1);
+    }
+    if ((st.st_size != (off_t)NOR_SIZE) &&
+        (ftruncate(fd, (off_t)NOR_SIZE) != 0)) {
+      printf("SPID1: Unable to resize %s (%d)\n", SIM_SPI_NOR_FILE, errno);
+      exit(1);
+    }
+    nor.mem = mmap(NULL, NOR_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (nor.mem == MAP_FAILED) {
+      printf("SPID1: Unable to map %s (%d)\n", SIM_SPI_NOR_FILE, errno);
+      exit(1);
+    }
+
+    /* A new file is an erased device.*/
+    if (st.st_size < (off_t)NOR_SIZE) {
+      memset(&nor.mem[st.st_size], 0xFF, NOR_SIZE - (size_t)st.st_size);
+    }
+  }
+#else
+  nor.mem = nor_array;
+  memset(nor.mem, 0xFF, NOR_SIZE);
+#endif
+}
+
+/**
+ * @brief   Configures and activates the SPI peripheral.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ *
+ * @notapi
+ */
+void spi_lld_start(SPIDriver *spip) {
+
+  spip->active = false;
+}
+
+/**
+ * @brief   Deactivates the SPI peripheral.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ *
+ * @notapi
+ */
+void spi_lld_stop(SPIDriver *spip) {
+
+  spip->active = false;
+}
+
+/**
+ * @brief   Asserts the slave select signal and prepares for transfers.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ *
+ * @notapi
+ */
+void spi_lld_select(SPIDriver *spip) {
+
+  nor.phase = 0U;
+  spip->commands++;
+}
+
+/**
+ * @brief   Deasserts the slave select signal.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ *
+ * @notapi
+ */
+void spi_lld_unselect(SPIDriver *spip) {
+
+  (void)spip;
+
+  nor_end();
+  nor.phase = 0U;
+}
+
+/**
+ * @brief   Ignores data on the SPI bus.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of frames to be ignored
+ *
+ * @notapi
+ */
+void spi_lld_ignore(SPIDriver *spip, size_t n) {
+  size_t i;
+
+  for (i = 0U; i < n; i++) {
+    (void) nor_exchange(0xFFU);
+  }
+  spi_lld_start_transfer(spip, n);
+}
+
+/**
+ * @brief   Exchanges data on the SPI bus.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of frames to be exchanged
+ * @param[in] txbuf     the pointer to the transmit buffer
+ * @param[out] rxbuf    the pointer to the receive buffer
+ *
+ * @notapi
+ */
+void spi_lld_exchange(SPIDriver *spip, size_t n,
+                      const void *txbuf, void *rxbuf) {
+  const uint8_t *tp = txbuf;
+  uint8_t *rp = rxbuf;
+  size_t i;
+
+  for (i = 0U; i < n; i++) {
+    rp[i] = nor_exchange(tp[i]);
+  }
+  spi_lld_start_transfer(spip, n);
+}
+
+/**
+ * @brief   Sends data over the SPI bus.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of frames to send
+ * @param[in] txbuf     the pointer to the transmit buffer
+ *
+ * @notapi
+ */
+void spi_lld_send(SPIDriver *spip, size_t n, const void *txbuf) {
+  const uint8_t *tp = txbuf;
+  size_t i;
+
+  for (i = 0U; i < n; i++) {
+    (void) nor_exchange(tp[i]);
+  }
+  spi_lld_start_transfer(spip, n);
+}
+
+/**
+ * @brief   Receives data from the SPI bus.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of frames to receive
+ * @param[out] rxbuf    the pointer to the receive buffer
+ *
+ * @notapi
+ */
+void spi_lld_receive(SPIDriver *spip, size_t n, void *rxbuf) {
+  uint8_t *rp = rxbuf;
+  size_t i;
+
+  for (i = 0U; i < n; i++) {
+    rp[i] = nor_exchange(0xFFU);
+  }
+  spi_lld_start_transfer(spip, n);
+}
+
+/**
+ * @brief   Exchanges one frame using a polled wait.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] frame     the data frame to send over the SPI bus
+ * @return              The received data frame from the SPI bus.
+ *
+ * @notapi
+ */
+uint16_t spi_lld_polled_exchange(SPIDriver *spip, uint16_t frame) {
+
+  (void)spip;
+
+  return (uint16_t)nor_exchange((uint8_t)frame);
+}
+
+#endif /* HAL_USE_SPI */
+
+/** @} */
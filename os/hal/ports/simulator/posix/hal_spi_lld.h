@@ -0,0 +1,164 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_spi_lld.h
+ * @brief   Posix simulator low level SPI driver header.
+ *
+ * @addtogroup POSIX_SPI
+ * @{
+ */
+
+#ifndef HAL_SPI_LLD_H
+#define HAL_SPI_LLD_H
+
+#if HAL_USE_SPI || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Circular mode support flag.
+ */
+#define SPI_SUPPORTS_CIRCULAR               FALSE
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Simulated bit rate.
+ */
+#if !defined(SIM_SPI_BITRATE) || defined(__DOXYGEN__)
+#define SIM_SPI_BITRATE                     20000000
+#endif
+
+/**
+ * @brief   Fixed time of each transfer in microseconds.
+ * @details It models the DMA setup and the completion interrupt.
+ */
+#if !defined(SIM_SPI_TRANSFER_TIME) || defined(__DOXYGEN__)
+#define SIM_SPI_TRANSFER_TIME               2
+#endif
+
+/**
+ * @brief   Size of the simulated NOR flash as a power of two.
+ */
+#if !defined(SIM_SPI_NOR_SIZE_LOG2) || defined(__DOXYGEN__)
+#define SIM_SPI_NOR_SIZE_LOG2               22
+#endif
+
+/**
+ * @brief   Simulated page program time in microseconds.
+ */
+#if !defined(SIM_SPI_NOR_PROGRAM_TIME) || defined(__DOXYGEN__)
+#define SIM_SPI_NOR_PROGRAM_TIME            200
+#endif
+
+/**
+ * @brief   Simulated sector erase time in microseconds.
+ */
+#if !defined(SIM_SPI_NOR_ERASE_TIME) || defined(__DOXYGEN__)
+#define SIM_SPI_NOR_ERASE_TIME              10000
+#endif
+
+/**
+ * @brief   Backing file of the simulated NOR flash.
+ * @details If defined then the flash content is mapped from the specified
+ *          host file and it is persistent, else it is kept in RAM.
+ */
+#if defined(__DOXYGEN__)
+#define SIM_SPI_NOR_FILE                    "flash.bin"
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if SPI_SELECT_MODE != SPI_SELECT_MODE_LLD
+#error "the simulated SPI requires SPI_SELECT_MODE_LLD"
+#endif
+
+#if (SIM_SPI_NOR_SIZE_LOG2 < 16) || (SIM_SPI_NOR_SIZE_LOG2 > 24)
+#error "invalid SIM_SPI_NOR_SIZE_LOG2 setting"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level fields of the SPI driver structure.
+ */
+#define spi_lld_driver_fields                                               \
+  /* Completion time of the transfer in progress, in microseconds.*/        \
+  uint64_t                      done;                                       \
+  /* Transfer in progress flag.*/                                           \
+  bool                          active;                                     \
+  /* Number of transfers.*/                                                 \
+  uint32_t                      transfers;                                  \
+  /* Number of selections, each one is a NOR command.*/                     \
+  uint32_t                      commands
+
+/**
+ * @brief   Low level fields of the SPI configuration structure.
+ */
+#define spi_lld_config_fields                                               \
+  /* Dummy configuration, it is not needed.*/                               \
+  uint32_t                      dummy
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if !defined(__DOXYGEN__)
+extern SPIDriver SPID1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void spi_lld_init(void);
+  void spi_lld_start(SPIDriver *spip);
+  void spi_lld_stop(SPIDriver *spip);
+  void spi_lld_select(SPIDriver *spip);
+  void spi_lld_unselect(SPIDriver *spip);
+  void spi_lld_ignore(SPIDriver *spip, size_t n);
+  void spi_lld_exchange(SPIDriver *spip, size_t n,
+                        const void *txbuf, void *rxbuf);
+  void spi_lld_send(SPIDriver *spip, size_t n, const void *txbuf);
+  void spi_lld_receive(SPIDriver *spip, size_t n, void *rxbuf);
+  uint16_t spi_lld_polled_exchange(SPIDriver *spip, uint16_t frame);
+  bool spi_lld_interrupt_pending(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_SPI */
+
+#endif /* HAL_SPI_LLD_H */
+
+/** @} */
@@ -57,6 +57,8 @@ void cryInit(void) {
 
 #if HAL_CRY_ENFORCE_FALLBACK == FALSE
   cry_lld_init();
+#else
+  cry_fallback_init();
 #endif
 }
 
@@ -0,0 +1,2493 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_crypto_fallback.c
+ * @brief   Cryptographic Driver software fall-back code.
+ * @details Portable implementations of the algorithms not supported by
+ *          the low level driver:
+ *          - AES using a single T-table per direction, the other three
+ *            tables are obtained by rotation, on ARM cores the rotation
+ *            is absorbed by the data processing instructions.
+ *          - GCM using a 4 bits GHASH multiplication table computed when
+ *            the key is loaded.
+ *          - (T)DES using combined S-P tables, TDES applies the initial
+ *            and final permutations once per block.
+ *          - SHA1/SHA256/SHA512 hashing whole blocks directly from the
+ *            caller buffer.
+ *          - HMAC with the inner and outer pads absorbed when the key
+ *            is loaded.
+ *          .
+ * @note    Transient keys are kept in module storage and are shared by
+ *          all driver instances.
+ *
+ * @addtogroup CRYPTO
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+
+#if ((HAL_USE_CRY == TRUE) && (HAL_CRY_USE_FALLBACK == TRUE)) ||           \
+    defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+#define ROTL32(x, n)        (((x) << (n)) | ((x) >> (32U - (n))))
+#define ROTR32(x, n)        (((x) >> (n)) | ((x) << (32U - (n))))
+#define ROTR64(x, n)        (((x) >> (n)) | ((x) << (64U - (n))))
+
+#define GET_U32_BE(p)                                                       \
+  (((uint32_t)(p)[0] << 24) | ((uint32_t)(p)[1] << 16) |                    \
+   ((uint32_t)(p)[2] << 8)  | (uint32_t)(p)[3])
+
+#define PUT_U32_BE(p, v) do {                                               \
+  (p)[0] = (uint8_t)((v) >> 24);                                            \
+  (p)[1] = (uint8_t)((v) >> 16);                                            \
+  (p)[2] = (uint8_t)((v) >> 8);                                             \
+  (p)[3] = (uint8_t)(v);                                                    \
+} while (false)
+
+#define GET_U64_BE(p)                                                       \
+  (((uint64_t)GET_U32_BE(p) << 32) | (uint64_t)GET_U32_BE((p) + 4))
+
+#define PUT_U64_BE(p, v) do {                                               \
+  PUT_U32_BE((p), (uint32_t)((v) >> 32));                                   \
+  PUT_U32_BE((p) + 4, (uint32_t)(v));                                       \
+} while (false)
+
+/* AES round tables, tables 1..3 are rotations of table 0.*/
+#define TE0(x)              Te0[((x) >> 24) & 0xFFU]
+#define TE1(x)              ROTR32(Te0[((x) >> 16) & 0xFFU], 8U)
+#define TE2(x)              ROTR32(Te0[((x) >> 8) & 0xFFU], 16U)
+#define TE3(x)              ROTR32(Te0[(x) & 0xFFU], 24U)
+#define TD0(x)              Td0[((x) >> 24) & 0xFFU]
+#define TD1(x)              ROTR32(Td0[((x) >> 16) & 0xFFU], 8U)
+#define TD2(x)              ROTR32(Td0[((x) >> 8) & 0xFFU], 16U)
+#define TD3(x)              ROTR32(Td0[(x) & 0xFFU], 24U)
+
+/* AES last round S-box lookups.*/
+#define SB(x, sh)                                                           \
+  ((uint32_t)aes_sbox[((x) >> (sh)) & 0xFFU] << (sh))
+#define ISB(x, sh)                                                          \
+  ((uint32_t)aes_isbox[((x) >> (sh)) & 0xFFU] << (sh))
+
+/* Two DES rounds using the combined S-P tables.*/
+#define DES_ROUND(l, r, kp) do {                                            \
+  uint32_t w, f;                                                            \
+  w  = ROTR32((r), 4U) ^ (kp)[0];                                           \
+  f  = des_sp[6][w & 0x3FU] | des_sp[4][(w >> 8) & 0x3FU] |                 \
+       des_sp[2][(w >> 16) & 0x3FU] | des_sp[0][(w >> 24) & 0x3FU];         \
+  w  = (r) ^ (kp)[1];                                                       \
+  f |= des_sp[7][w & 0x3FU] | des_sp[5][(w >> 8) & 0x3FU] |                 \
+       des_sp[3][(w >> 16) & 0x3FU] | des_sp[1][(w >> 24) & 0x3FU];         \
+  (l) ^= f;                                                                 \
+} while (false)
+
+/* SHA functions.*/
+#define CH(x, y, z)         (((x) & (y)) ^ (~(x) & (z)))
+#define MAJ(x, y, z)        (((x) & (y)) | ((z) & ((x) | (y))))
+#define PARITY(x, y, z)     ((x) ^ (y) ^ (z))
+#define S256_0(x)           (ROTR32(x, 2U) ^ ROTR32(x, 13U) ^ ROTR32(x, 22U))
+#define S256_1(x)           (ROTR32(x, 6U) ^ ROTR32(x, 11U) ^ ROTR32(x, 25U))
+#define G256_0(x)           (ROTR32(x, 7U) ^ ROTR32(x, 18U) ^ ((x) >> 3))
+#define G256_1(x)           (ROTR32(x, 17U) ^ ROTR32(x, 19U) ^ ((x) >> 10))
+#define S512_0(x)           (ROTR64(x, 28U) ^ ROTR64(x, 34U) ^ ROTR64(x, 39U))
+#define S512_1(x)           (ROTR64(x, 14U) ^ ROTR64(x, 18U) ^ ROTR64(x, 41U))
+#define G512_0(x)           (ROTR64(x, 1U) ^ ROTR64(x, 8U) ^ ((x) >> 7))
+#define G512_1(x)           (ROTR64(x, 19U) ^ ROTR64(x, 61U) ^ ((x) >> 6))
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+#if (HAL_CRY_ENFORCE_FALLBACK == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   CRY1 driver identifier.
+ * @note    Only present when the fall-back is enforced, else the driver
+ *          instances are exported by the low level driver.
+ */
+CRYDriver CRYD1;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a compression function for 32 bits SHA algorithms.
+ */
+typedef void (*sha32compress_t)(uint32_t *h, const uint8_t *p, size_t n);
+
+/**
+ * @brief   AES transient key and derived data.
+ */
+static struct {
+  /**
+   * @brief   Number of rounds, zero if a key has not been loaded.
+   */
+  unsigned                  rounds;
+  /**
+   * @brief   Encryption round keys.
+   */
+  uint32_t                  ek[60];
+  /**
+   * @brief   Decryption round keys.
+   */
+  uint32_t                  dk[60];
+  /**
+   * @brief   GHASH multiplication table, high halves.
+   */
+  uint64_t                  hh[16];
+  /**
+   * @brief   GHASH multiplication table, low halves.
+   */
+  uint64_t                  hl[16];
+} aes_key;
+
+/**
+ * @brief   (T)DES transient key.
+ */
+static struct {
+  /**
+   * @brief   One for DES, three for TDES, zero if a key has not been loaded.
+   */
+  unsigned                  nkeys;
+  /**
+   * @brief   Encryption sub-keys.
+   */
+  uint32_t                  ek[3][32];
+  /**
+   * @brief   Decryption sub-keys.
+   */
+  uint32_t                  dk[3][32];
+} des_key;
+
+/**
+ * @brief   HMAC transient key as intermediate hash values.
+ */
+static struct {
+  /**
+   * @brief   A key has been loaded.
+   */
+  bool                      loaded;
+  /**
+   * @brief   SHA256 state after the inner pad block.
+   */
+  uint32_t                  inner256[8];
+  /**
+   * @brief   SHA256 state after the outer pad block.
+   */
+  uint32_t                  outer256[8];
+  /**
+   * @brief   SHA512 state after the inner pad block.
+   */
+  uint64_t                  inner512[8];
+  /**
+   * @brief   SHA512 state after the outer pad block.
+   */
+  uint64_t                  outer512[8];
+} hmac_key;
+
+static const uint8_t aes_sbox[256] = {
+  0x63U, 0x7CU, 0x77U, 0x7BU, 0xF2U, 0x6BU, 0x6FU, 0xC5U,
+  0x30U, 0x01U, 0x67U, 0x2BU, 0xFEU, 0xD7U, 0xABU, 0x76U,
+  0xCAU, 0x82U, 0xC9U, 0x7DU, 0xFAU, 0x59U, 0x47U, 0xF0U,
+  0xADU, 0xD4U, 0xA2U, 0xAFU, 0x9CU, 0xA4U, 0x72U, 0xC0U,
+  0xB7U, 0xFDU, 0x93U, 0x26U, 0x36U, 0x3FU, 0xF7U, 0xCCU,
+  0x34U, 0xA5U, 0xE5U, 0xF1U, 0x71U, 0xD8U, 0x31U, 0x15U,
+  0x04U, 0xC7U, 0x23U, 0xC3U, 0x18U, 0x96U, 0x05U, 0x9AU,
+  0x07U, 0x12U, 0x80U, 0xE2U, 0xEBU, 0x27U, 0xB2U, 0x75U,
+  0x09U, 0x83U, 0x2CU, 0x1AU, 0x1BU, 0x6EU, 0x5AU, 0xA0U,
+  0x52U, 0x3BU, 0xD6U, 0xB3U, 0x29U, 0xE3U, 0x2FU, 0x84U,
+  0x53U, 0xD1U, 0x00U, 0xEDU, 0x20U, 0xFCU, 0xB1U, 0x5BU,
+  0x6AU, 0xCBU, 0xBEU, 0x39U, 0x4AU, 0x4CU, 0x58U, 0xCFU,
+  0xD0U, 0xEFU, 0xAAU, 0xFBU, 0x43U, 0x4DU, 0x33U, 0x85U,
+  0x45U, 0xF9U, 0x02U, 0x7FU, 0x50U, 0x3CU, 0x9FU, 0xA8U,
+  0x51U, 0xA3U, 0x40U, 0x8FU, 0x92U, 0x9DU, 0x38U, 0xF5U,
+  0xBCU, 0xB6U, 0xDAU, 0x21U, 0x10U, 0xFFU, 0xF3U, 0xD2U,
+  0xCDU, 0x0CU, 0x13U, 0xECU, 0x5FU, 0x97U, 0x44U, 0x17U,
+  0xC4U, 0xA7U, 0x7EU, 0x3DU, 0x64U, 0x5DU, 0x19U, 0x73U,
+  0x60U, 0x81U, 0x4FU, 0xDCU, 0x22U, 0x2AU, 0x90U, 0x88U,
+  0x46U, 0xEEU, 0xB8U, 0x14U, 0xDEU, 0x5EU, 0x0BU, 0xDBU,
+  0xE0U, 0x32U, 0x3AU, 0x0AU, 0x49U, 0x06U, 0x24U, 0x5CU,
+  0xC2U, 0xD3U, 0xACU, 0x62U, 0x91U, 0x95U, 0xE4U, 0x79U,
+  0xE7U, 0xC8U, 0x37U, 0x6DU, 0x8DU, 0xD5U, 0x4EU, 0xA9U,
+  0x6CU, 0x56U, 0xF4U, 0xEAU, 0x65U, 0x7AU, 0xAEU, 0x08U,
+  0xBAU, 0x78U, 0x25U, 0x2EU, 0x1CU, 0xA6U, 0xB4U, 0xC6U,
+  0xE8U, 0xDDU, 0x74U, 0x1FU, 0x4BU, 0xBDU, 0x8BU, 0x8AU,
+  0x70U, 0x3EU, 0xB5U, 0x66U, 0x48U, 0x03U, 0xF6U, 0x0EU,
+  0x61U, 0x35U, 0x57U, 0xB9U, 0x86U, 0xC1U, 0x1DU, 0x9EU,
+  0xE1U, 0xF8U, 0x98U, 0x11U, 0x69U, 0xD9U, 0x8EU, 0x94U,
+  0x9BU, 0x1EU, 0x87U, 0xE9U, 0xCEU, 0x55U, 0x28U, 0xDFU,
+  0x8CU, 0xA1U, 0x89U, 0x0DU, 0xBFU, 0xE6U, 0x42U, 0x68U,
+  0x41U, 0x99U, 0x2DU, 0x0FU, 0xB0U, 0x54U, 0xBBU, 0x16U
+};
+
+static const uint8_t aes_isbox[256] = {
+  0x52U, 0x09U, 0x6AU, 0xD5U, 0x30U, 0x36U, 0xA5U, 0x38U,
+  0xBFU, 0x40U, 0xA3U, 0x9EU, 0x81U, 0xF3U, 0xD7U, 0xFBU,
+  0x7CU, 0xE3U, 0x39U, 0x82U, 0x9BU, 0x2FU, 0xFFU, 0x87U,
+  0x34U, 0x8EU, 0x43U, 0x44U, 0xC4U, 0xDEU, 0xE9U, 0xCBU,
+  0x54U, 0x7BU, 0x94U, 0x32U, 0xA6U, 0xC2U, 0x23U, 0x3DU,
+  0xEEU, 0x4CU, 0x95U, 0x0BU, 0x42U, 0xFAU, 0xC3U, 0x4EU,
+  0x08U, 0x2EU, 0xA1U, 0x66U, 0x28U, 0xD9U, 0x24U, 0xB2U,
+  0x76U, 0x5BU, 0xA2U, 0x49U, 0x6DU, 0x8BU, 0xD1U, 0x25U,
+  0x72U, 0xF8U, 0xF6U, 0x64U, 0x86U, 0x68U, 0x98U, 0x16U,
+  0xD4U, 0xA4U, 0x5CU, 0xCCU, 0x5DU, 0x65U, 0xB6U, 0x92U,
+  0x6CU, 0x70U, 0x48U, 0x50U, 0xFDU, 0xEDU, 0xB9U, 0xDAU,
+  0x5EU, 0x15U, 0x46U, 0x57U, 0xA7U, 0x8DU, 0x9DU, 0x84U,
+  0x90U, 0xD8U, 0xABU, 0x00U, 0x8CU, 0xBCU, 0xD3U, 0x0AU,
+  0xF7U, 0xE4U, 0x58U, 0x05U, 0xB8U, 0xB3U, 0x45U, 0x06U,
+  0xD0U, 0x2CU, 0x1EU, 0x8FU, 0xCAU, 0x3FU, 0x0FU, 0x02U,
+  0xC1U, 0xAFU, 0xBDU, 0x03U, 0x01U, 0x13U, 0x8AU, 0x6BU,
+  0x3AU, 0x91U, 0x11U, 0x41U, 0x4FU, 0x67U, 0xDCU, 0xEAU,
+  0x97U, 0xF2U, 0xCFU, 0xCEU, 0xF0U, 0xB4U, 0xE6U, 0x73U,
+  0x96U, 0xACU, 0x74U, 0x22U, 0xE7U, 0xADU, 0x35U, 0x85U,
+  0xE2U, 0xF9U, 0x37U, 0xE8U, 0x1CU, 0x75U, 0xDFU, 0x6EU,
+  0x47U, 0xF1U, 0x1AU, 0x71U, 0x1DU, 0x29U, 0xC5U, 0x89U,
+  0x6FU, 0xB7U, 0x62U, 0x0EU, 0xAAU, 0x18U, 0xBEU, 0x1BU,
+  0xFCU, 0x56U, 0x3EU, 0x4BU, 0xC6U, 0xD2U, 0x79U, 0x20U,
+  0x9AU, 0xDBU, 0xC0U, 0xFEU, 0x78U, 0xCDU, 0x5AU, 0xF4U,
+  0x1FU, 0xDDU, 0xA8U, 0x33U, 0x88U, 0x07U, 0xC7U, 0x31U,
+  0xB1U, 0x12U, 0x10U, 0x59U, 0x27U, 0x80U, 0xECU, 0x5FU,
+  0x60U, 0x51U, 0x7FU, 0xA9U, 0x19U, 0xB5U, 0x4AU, 0x0DU,
+  0x2DU, 0xE5U, 0x7AU, 0x9FU, 0x93U, 0xC9U, 0x9CU, 0xEFU,
+  0xA0U, 0xE0U, 0x3BU, 0x4DU, 0xAEU, 0x2AU, 0xF5U, 0xB0U,
+  0xC8U, 0xEBU, 0xBBU, 0x3CU, 0x83U, 0x53U, 0x99U, 0x61U,
+  0x17U, 0x2BU, 0x04U, 0x7EU, 0xBAU, 0x77U, 0xD6U, 0x26U,
+  0xE1U, 0x69U, 0x14U, 0x63U, 0x55U, 0x21U, 0x0CU, 0x7DU
+};
+
+static const uint32_t Te0[256] = {
+  0xC66363A5U, 0xF87C7C84U, 0xEE777799U, 0xF67B7B8DU, 0xFFF2F20DU, 0xD66B6BBDU,
+  0xDE6F6FB1U, 0x91C5C554U, 0x60303050U, 0x02010103U, 0xCE6767A9U, 0x562B2B7DU,
+  0xE7FEFE19U, 0xB5D7D762U, 0x4DABABE6U, 0xEC76769AU, 0x8FCACA45U, 0x1F82829DU,
+  0x89C9C940U, 0xFA7D7D87U, 0xEFFAFA15U, 0xB25959EBU, 0x8E4747C9U, 0xFBF0F00BU,
+  0x41ADADECU, 0xB3D4D467U, 0x5FA2A2FDU, 0x45AFAFEAU, 0x239C9CBFU, 0x53A4A4F7U,
+  0xE4727296U, 0x9BC0C05BU, 0x75B7B7C2U, 0xE1FDFD1CU, 0x3D9393AEU, 0x4C26266AU,
+  0x6C36365AU, 0x7E3F3F41U, 0xF5F7F702U, 0x83CCCC4FU, 0x6834345CU, 0x51A5A5F4U,
+  0xD1E5E534U, 0xF9F1F108U, 0xE2717193U, 0xABD8D873U, 0x62313153U, 0x2A15153FU,
+  0x0804040CU, 0x95C7C752U, 0x46232365U, 0x9DC3C35EU, 0x30181828U, 0x379696A1U,
+  0x0A05050FU, 0x2F9A9AB5U, 0x0E070709U, 0x24121236U, 0x1B80809BU, 0xDFE2E23DU,
+  0xCDEBEB26U, 0x4E272769U, 0x7FB2B2CDU, 0xEA75759FU, 0x1209091BU, 0x1D83839EU,
+  0x582C2C74U, 0x341A1A2EU, 0x361B1B2DU, 0xDC6E6EB2U, 0xB45A5AEEU, 0x5BA0A0FBU,
+  0xA45252F6U, 0x763B3B4DU, 0xB7D6D661U, 0x7DB3B3CEU, 0x5229297BU, 0xDDE3E33EU,
+  0x5E2F2F71U, 0x13848497U, 0xA65353F5U, 0xB9D1D168U, 0x00000000U, 0xC1EDED2CU,
+  0x40202060U, 0xE3FCFC1FU, 0x79B1B1C8U, 0xB65B5BEDU, 0xD46A6ABEU, 0x8DCBCB46U,
+  0x67BEBED9U, 0x7239394BU, 0x944A4ADEU, 0x984C4CD4U, 0xB05858E8U, 0x85CFCF4AU,
+  0xBBD0D06BU, 0xC5EFEF2AU, 0x4FAAAAE5U, 0xEDFBFB16U, 0x864343C5U, 0x9A4D4DD7U,
+  0x66333355U, 0x11858594U, 0x8A4545CFU, 0xE9F9F910U, 0x04020206U, 0xFE7F7F81U,
+  0xA05050F0U, 0x783C3C44U, 0x259F9FBAU, 0x4BA8A8E3U, 0xA25151F3U, 0x5DA3A3FEU,
+  0x804040C0U, 0x058F8F8AU, 0x3F9292ADU, 0x219D9DBCU, 0x70383848U, 0xF1F5F504U,
+  0x63BCBCDFU, 0x77B6B6C1U, 0xAFDADA75U, 0x42212163U, 0x20101030U, 0xE5FFFF1AU,
+  0xFDF3F30EU, 0xBFD2D26DU, 0x81CDCD4CU, 0x180C0C14U, 0x26131335U, 0xC3ECEC2FU,
+  0xBE5F5FE1U, 0x359797A2U, 0x884444CCU, 0x2E171739U, 0x93C4C457U, 0x55A7A7F2U,
+  0xFC7E7E82U, 0x7A3D3D47U, 0xC86464ACU, 0xBA5D5DE7U, 0x3219192BU, 0xE6737395U,
+  0xC06060A0U, 0x19818198U, 0x9E4F4FD1U, 0xA3DCDC7FU, 0x44222266U, 0x542A2A7EU,
+  0x3B9090ABU, 0x0B888883U, 0x8C4646CAU, 0xC7EEEE29U, 0x6BB8B8D3U, 0x2814143CU,
+  0xA7DEDE79U, 0xBC5E5EE2U, 0x160B0B1DU, 0xADDBDB76U, 0xDBE0E03BU, 0x64323256U,
+  0x743A3A4EU, 0x140A0A1EU, 0x924949DBU, 0x0C06060AU, 0x4824246CU, 0xB85C5CE4U,
+  0x9FC2C25DU, 0xBDD3D36EU, 0x43ACACEFU, 0xC46262A6U, 0x399191A8U, 0x319595A4U,
+  0xD3E4E437U, 0xF279798BU, 0xD5E7E732U, 0x8BC8C843U, 0x6E373759U, 0xDA6D6DB7U,
+  0x018D8D8CU, 0xB1D5D564U, 0x9C4E4ED2U, 0x49A9A9E0U, 0xD86C6CB4U, 0xAC5656FAU,
+  0xF3F4F407U, 0xCFEAEA25U, 0xCA6565AFU, 0xF47A7A8EU, 0x47AEAEE9U, 0x10080818U,
+  0x6FBABAD5U, 0xF0787888U, 0x4A25256FU, 0x5C2E2E72U, 0x381C1C24U, 0x57A6A6F1U,
+  0x73B4B4C7U, 0x97C6C651U, 0xCBE8E823U, 0xA1DDDD7CU, 0xE874749CU, 0x3E1F1F21U,
+  0x964B4BDDU, 0x61BDBDDCU, 0x0D8B8B86U, 0x0F8A8A85U, 0xE0707090U, 0x7C3E3E42U,
+  0x71B5B5C4U, 0xCC6666AAU, 0x904848D8U, 0x06030305U, 0xF7F6F601U, 0x1C0E0E12U,
+  0xC26161A3U, 0x6A35355FU, 0xAE5757F9U, 0x69B9B9D0U, 0x17868691U, 0x99C1C158U,
+  0x3A1D1D27U, 0x279E9EB9U, 0xD9E1E138U, 0xEBF8F813U, 0x2B9898B3U, 0x22111133U,
+  0xD26969BBU, 0xA9D9D970U, 0x078E8E89U, 0x339494A7U, 0x2D9B9BB6U, 0x3C1E1E22U,
+  0x15878792U, 0xC9E9E920U, 0x87CECE49U, 0xAA5555FFU, 0x50282878U, 0xA5DFDF7AU,
+  0x038C8C8FU, 0x59A1A1F8U, 0x09898980U, 0x1A0D0D17U, 0x65BFBFDAU, 0xD7E6E631U,
+  0x844242C6U, 0xD06868B8U, 0x824141C3U, 0x299999B0U, 0x5A2D2D77U, 0x1E0F0F11U,
+  0x7BB0B0CBU, 0xA85454FCU, 0x6DBBBBD6U, 0x2C16163AU
+};
+
+static const uint32_t Td0[256] = {
+  0x51F4A750U, 0x7E416553U, 0x1A17A4C3U, 0x3A275E96U, 0x3BAB6BCBU, 0x1F9D45F1U,
+  0xACFA58ABU, 0x4BE30393U, 0x2030FA55U, 0xAD766DF6U, 0x88CC7691U, 0xF5024C25U,
+  0x4FE5D7FCU, 0xC52ACBD7U, 0x26354480U, 0xB562A38FU, 0xDEB15A49U, 0x25BA1B67U,
+  0x45EA0E98U, 0x5DFEC0E1U, 0xC32F7502U, 0x814CF012U, 0x8D4697A3U, 0x6BD3F9C6U,
+  0x038F5FE7U, 0x15929C95U, 0xBF6D7AEBU, 0x955259DAU, 0xD4BE832DU, 0x587421D3U,
+  0x49E06929U, 0x8EC9C844U, 0x75C2896AU, 0xF48E7978U, 0x99583E6BU, 0x27B971DDU,
+  0xBEE14FB6U, 0xF088AD17U, 0xC920AC66U, 0x7DCE3AB4U, 0x63DF4A18U, 0xE51A3182U,
+  0x97513360U, 0x62537F45U, 0xB16477E0U, 0xBB6BAE84U, 0xFE81A01CU, 0xF9082B94U,
+  0x70486858U, 0x8F45FD19U, 0x94DE6C87U, 0x527BF8B7U, 0xAB73D323U, 0x724B02E2U,
+  0xE31F8F57U, 0x6655AB2AU, 0xB2EB2807U, 0x2FB5C203U, 0x86C57B9AU, 0xD33708A5U,
+  0x302887F2U, 0x23BFA5B2U, 0x02036ABAU, 0xED16825CU, 0x8ACF1C2BU, 0xA779B492U,
+  0xF307F2F0U, 0x4E69E2A1U, 0x65DAF4CDU, 0x0605BED5U, 0xD134621FU, 0xC4A6FE8AU,
+  0x342E539DU, 0xA2F355A0U, 0x058AE132U, 0xA4F6EB75U, 0x0B83EC39U, 0x4060EFAAU,
+  0x5E719F06U, 0xBD6E1051U, 0x3E218AF9U, 0x96DD063DU, 0xDD3E05AEU, 0x4DE6BD46U,
+  0x91548DB5U, 0x71C45D05U, 0x0406D46FU, 0x605015FFU, 0x1998FB24U, 0xD6BDE997U,
+  0x894043CCU, 0x67D99E77U, 0xB0E842BDU, 0x07898B88U, 0xE7195B38U, 0x79C8EEDBU,
+  0xA17C0A47U, 0x7C420FE9U, 0xF8841EC9U, 0x00000000U, 0x09808683U, 0x322BED48U,
+  0x1E1170ACU, 0x6C5A724EU, 0xFD0EFFFBU, 0x0F853856U, 0x3DAED51EU, 0x362D3927U,
+  0x0A0FD964U, 0x685CA621U, 0x9B5B54D1U, 0x24362E3AU, 0x0C0A67B1U, 0x9357E70FU,
+  0xB4EE96D2U, 0x1B9B919EU, 0x80C0C54FU, 0x61DC20A2U, 0x5A774B69U, 0x1C121A16U,
+  0xE293BA0AU, 0xC0A02AE5U, 0x3C22E043U, 0x121B171DU, 0x0E090D0BU, 0xF28BC7ADU,
+  0x2DB6A8B9U, 0x141EA9C8U, 0x57F11985U, 0xAF75074CU, 0xEE99DDBBU, 0xA37F60FDU,
+  0xF701269FU, 0x5C72F5BCU, 0x44663BC5U, 0x5BFB7E34U, 0x8B432976U, 0xCB23C6DCU,
+  0xB6EDFC68U, 0xB8E4F163U, 0xD731DCCAU, 0x42638510U, 0x13972240U, 0x84C61120U,
+  0x854A247DU, 0xD2BB3DF8U, 0xAEF93211U, 0xC729A16DU, 0x1D9E2F4BU, 0xDCB230F3U,
+  0x0D8652ECU, 0x77C1E3D0U, 0x2BB3166CU, 0xA970B999U, 0x119448FAU, 0x47E96422U,
+  0xA8FC8CC4U, 0xA0F03F1AU, 0x567D2CD8U, 0x223390EFU, 0x87494EC7U, 0xD938D1C1U,
+  0x8CCAA2FEU, 0x98D40B36U, 0xA6F581CFU, 0xA57ADE28U, 0xDAB78E26U, 0x3FADBFA4U,
+  0x2C3A9DE4U, 0x5078920DU, 0x6A5FCC9BU, 0x547E4662U, 0xF68D13C2U, 0x90D8B8E8U,
+  0x2E39F75EU, 0x82C3AFF5U, 0x9F5D80BEU, 0x69D0937CU, 0x6FD52DA9U, 0xCF2512B3U,
+  0xC8AC993BU, 0x10187DA7U, 0xE89C636EU, 0xDB3BBB7BU, 0xCD267809U, 0x6E5918F4U,
+  0xEC9AB701U, 0x834F9AA8U, 0xE6956E65U, 0xAAFFE67EU, 0x21BCCF08U, 0xEF15E8E6U,
+  0xBAE79BD9U, 0x4A6F36CEU, 0xEA9F09D4U, 0x29B07CD6U, 0x31A4B2AFU, 0x2A3F2331U,
+  0xC6A59430U, 0x35A266C0U, 0x744EBC37U, 0xFC82CAA6U, 0xE090D0B0U, 0x33A7D815U,
+  0xF104984AU, 0x41ECDAF7U, 0x7FCD500EU, 0x1791F62FU, 0x764DD68DU, 0x43EFB04DU,
+  0xCCAA4D54U, 0xE49604DFU, 0x9ED1B5E3U, 0x4C6A881BU, 0xC12C1FB8U, 0x4665517FU,
+  0x9D5EEA04U, 0x018C355DU, 0xFA877473U, 0xFB0B412EU, 0xB3671D5AU, 0x92DBD252U,
+  0xE9105633U, 0x6DD64713U, 0x9AD7618CU, 0x37A10C7AU, 0x59F8148EU, 0xEB133C89U,
+  0xCEA927EEU, 0xB761C935U, 0xE11CE5EDU, 0x7A47B13CU, 0x9CD2DF59U, 0x55F2733FU,
+  0x1814CE79U, 0x73C737BFU, 0x53F7CDEAU, 0x5FFDAA5BU, 0xDF3D6F14U, 0x7844DB86U,
+  0xCAAFF381U, 0xB968C43EU, 0x3824342CU, 0xC2A3405FU, 0x161DC372U, 0xBCE2250CU,
+  0x283C498BU, 0xFF0D9541U, 0x39A80171U, 0x080CB3DEU, 0xD8B4E49CU, 0x6456C190U,
+  0x7BCB8461U, 0xD532B670U, 0x486C5C74U, 0xD0B85742U
+};
+
+/* GHASH reduction constants for 4 bits shifts.*/
+static const uint64_t gcm_last4[16] = {
+  0x0000U, 0x1C20U, 0x3840U, 0x2460U, 0x7080U, 0x6CA0U, 0x48C0U, 0x54E0U,
+  0xE100U, 0xFD20U, 0xD940U, 0xC560U, 0x9180U, 0x8DA0U, 0xA9C0U, 0xB5E0U
+};
+
+/* DES S-boxes combined with the P permutation, the outputs are rotated
+   left by one bit as the internal representation of the halves.*/
+static const uint32_t des_sp[8][64] = {
+  {
+    0x01010400U, 0x00000000U, 0x00010000U, 0x01010404U, 0x01010004U,
+    0x00010404U, 0x00000004U, 0x00010000U, 0x00000400U, 0x01010400U,
+    0x01010404U, 0x00000400U, 0x01000404U, 0x01010004U, 0x01000000U,
+    0x00000004U, 0x00000404U, 0x01000400U, 0x01000400U, 0x00010400U,
+    0x00010400U, 0x01010000U, 0x01010000U, 0x01000404U, 0x00010004U,
+    0x01000004U, 0x01000004U, 0x00010004U, 0x00000000U, 0x00000404U,
+    0x00010404U, 0x01000000U, 0x00010000U, 0x01010404U, 0x00000004U,
+    0x01010000U, 0x01010400U, 0x01000000U, 0x01000000U, 0x00000400U,
+    0x01010004U, 0x00010000U, 0x00010400U, 0x01000004U, 0x00000400U,
+    0x00000004U, 0x01000404U, 0x00010404U, 0x01010404U, 0x00010004U,
+    0x01010000U, 0x01000404U, 0x01000004U, 0x00000404U, 0x00010404U,
+    0x01010400U, 0x00000404U, 0x01000400U, 0x01000400U, 0x00000000U,
+    0x00010004U, 0x00010400U, 0x00000000U, 0x01010004U
+  },
+  {
+    0x80108020U, 0x80008000U, 0x00008000U, 0x00108020U, 0x00100000U,
+    0x00000020U, 0x80100020U, 0x80008020U, 0x80000020U, 0x80108020U,
+    0x80108000U, 0x80000000U, 0x80008000U, 0x00100000U, 0x00000020U,
+    0x80100020U, 0x00108000U, 0x00100020U, 0x80008020U, 0x00000000U,
+    0x80000000U, 0x00008000U, 0x00108020U, 0x80100000U, 0x00100020U,
+    0x80000020U, 0x00000000U, 0x00108000U, 0x00008020U, 0x80108000U,
+    0x80100000U, 0x00008020U, 0x00000000U, 0x00108020U, 0x80100020U,
+    0x00100000U, 0x80008020U, 0x80100000U, 0x80108000U, 0x00008000U,
+    0x80100000U, 0x80008000U, 0x00000020U, 0x80108020U, 0x00108020U,
+    0x00000020U, 0x00008000U, 0x80000000U, 0x00008020U, 0x80108000U,
+    0x00100000U, 0x80000020U, 0x00100020U, 0x80008020U, 0x80000020U,
+    0x00100020U, 0x00108000U, 0x00000000U, 0x80008000U, 0x00008020U,
+    0x80000000U, 0x80100020U, 0x80108020U, 0x00108000U
+  },
+  {
+    0x00000208U, 0x08020200U, 0x00000000U, 0x08020008U, 0x08000200U,
+    0x00000000U, 0x00020208U, 0x08000200U, 0x00020008U, 0x08000008U,
+    0x08000008U, 0x00020000U, 0x08020208U, 0x00020008U, 0x08020000U,
+    0x00000208U, 0x08000000U, 0x00000008U, 0x08020200U, 0x00000200U,
+    0x00020200U, 0x08020000U, 0x08020008U, 0x00020208U, 0x08000208U,
+    0x00020200U, 0x00020000U, 0x08000208U, 0x00000008U, 0x08020208U,
+    0x00000200U, 0x08000000U, 0x08020200U, 0x08000000U, 0x00020008U,
+    0x00000208U, 0x00020000U, 0x08020200U, 0x08000200U, 0x00000000U,
+    0x00000200U, 0x00020008U, 0x08020208U, 0x08000200U, 0x08000008U,
+    0x00000200U, 0x00000000U, 0x08020008U, 0x08000208U, 0x00020000U,
+    0x08000000U, 0x08020208U, 0x00000008U, 0x00020208U, 0x00020200U,
+    0x08000008U, 0x08020000U, 0x08000208U, 0x00000208U, 0x08020000U,
+    0x00020208U, 0x00000008U, 0x08020008U, 0x00020200U
+  },
+  {
+    0x00802001U, 0x00002081U, 0x00002081U, 0x00000080U, 0x00802080U,
+    0x00800081U, 0x00800001U, 0x00002001U, 0x00000000U, 0x00802000U,
+    0x00802000U, 0x00802081U, 0x00000081U, 0x00000000U, 0x00800080U,
+    0x00800001U, 0x00000001U, 0x00002000U, 0x00800000U, 0x00802001U,
+    0x00000080U, 0x00800000U, 0x00002001U, 0x00002080U, 0x00800081U,
+    0x00000001U, 0x00002080U, 0x00800080U, 0x00002000U, 0x00802080U,
+    0x00802081U, 0x00000081U, 0x00800080U, 0x00800001U, 0x00802000U,
+    0x00802081U, 0x00000081U, 0x00000000U, 0x00000000U, 0x00802000U,
+    0x00002080U, 0x00800080U, 0x00800081U, 0x00000001U, 0x00802001U,
+    0x00002081U, 0x00002081U, 0x00000080U, 0x00802081U, 0x00000081U,
+    0x00000001U, 0x00002000U, 0x00800001U, 0x00002001U, 0x00802080U,
+    0x00800081U, 0x00002001U, 0x00002080U, 0x00800000U, 0x00802001U,
+    0x00000080U, 0x00800000U, 0x00002000U, 0x00802080U
+  },
+  {
+    0x00000100U, 0x02080100U, 0x02080000U, 0x42000100U, 0x00080000U,
+    0x00000100U, 0x40000000U, 0x02080000U, 0x40080100U, 0x00080000U,
+    0x02000100U, 0x40080100U, 0x42000100U, 0x42080000U, 0x00080100U,
+    0x40000000U, 0x02000000U, 0x40080000U, 0x40080000U, 0x00000000U,
+    0x40000100U, 0x42080100U, 0x42080100U, 0x02000100U, 0x42080000U,
+    0x40000100U, 0x00000000U, 0x42000000U, 0x02080100U, 0x02000000U,
+    0x42000000U, 0x00080100U, 0x00080000U, 0x42000100U, 0x00000100U,
+    0x02000000U, 0x40000000U, 0x02080000U, 0x42000100U, 0x40080100U,
+    0x02000100U, 0x40000000U, 0x42080000U, 0x02080100U, 0x40080100U,
+    0x00000100U, 0x02000000U, 0x42080000U, 0x42080100U, 0x00080100U,
+    0x42000000U, 0x42080100U, 0x02080000U, 0x00000000U, 0x40080000U,
+    0x42000000U, 0x00080100U, 0x02000100U, 0x40000100U, 0x00080000U,
+    0x00000000U, 0x40080000U, 0x02080100U, 0x40000100U
+  },
+  {
+    0x20000010U, 0x20400000U, 0x00004000U, 0x20404010U, 0x20400000U,
+    0x00000010U, 0x20404010U, 0x00400000U, 0x20004000U, 0x00404010U,
+    0x00400000U, 0x20000010U, 0x00400010U, 0x20004000U, 0x20000000U,
+    0x00004010U, 0x00000000U, 0x00400010U, 0x20004010U, 0x00004000U,
+    0x00404000U, 0x20004010U, 0x00000010U, 0x20400010U, 0x20400010U,
+    0x00000000U, 0x00404010U, 0x20404000U, 0x00004010U, 0x00404000U,
+    0x20404000U, 0x20000000U, 0x20004000U, 0x00000010U, 0x20400010U,
+    0x00404000U, 0x20404010U, 0x00400000U, 0x00004010U, 0x20000010U,
+    0x00400000U, 0x20004000U, 0x20000000U, 0x00004010U, 0x20000010U,
+    0x20404010U, 0x00404000U, 0x20400000U, 0x00404010U, 0x20404000U,
+    0x00000000U, 0x20400010U, 0x00000010U, 0x00004000U, 0x20400000U,
+    0x00404010U, 0x00004000U, 0x00400010U, 0x20004010U, 0x00000000U,
+    0x20404000U, 0x20000000U, 0x00400010U, 0x20004010U
+  },
+  {
+    0x00200000U, 0x04200002U, 0x04000802U, 0x00000000U, 0x00000800U,
+    0x04000802U, 0x00200802U, 0x04200800U, 0x04200802U, 0x00200000U,
+    0x00000000U, 0x04000002U, 0x00000002U, 0x04000000U, 0x04200002U,
+    0x00000802U, 0x04000800U, 0x00200802U, 0x00200002U, 0x04000800U,
+    0x04000002U, 0x04200000U, 0x04200800U, 0x00200002U, 0x04200000U,
+    0x00000800U, 0x00000802U, 0x04200802U, 0x00200800U, 0x00000002U,
+    0x04000000U, 0x00200800U, 0x04000000U, 0x00200800U, 0x00200000U,
+    0x04000802U, 0x04000802U, 0x04200002U, 0x04200002U, 0x00000002U,
+    0x00200002U, 0x04000000U, 0x04000800U, 0x00200000U, 0x04200800U,
+    0x00000802U, 0x00200802U, 0x04200800U, 0x00000802U, 0x04000002U,
+    0x04200802U, 0x04200000U, 0x00200800U, 0x00000000U, 0x00000002U,
+    0x04200802U, 0x00000000U, 0x00200802U, 0x04200000U, 0x00000800U,
+    0x04000002U, 0x04000800U, 0x00000800U, 0x00200002U
+  },
+  {
+    0x10001040U, 0x00001000U, 0x00040000U, 0x10041040U, 0x10000000U,
+    0x10001040U, 0x00000040U, 0x10000000U, 0x00040040U, 0x10040000U,
+    0x10041040U, 0x00041000U, 0x10041000U, 0x00041040U, 0x00001000U,
+    0x00000040U, 0x10040000U, 0x10000040U, 0x10001000U, 0x00001040U,
+    0x00041000U, 0x00040040U, 0x10040040U, 0x10041000U, 0x00001040U,
+    0x00000000U, 0x00000000U, 0x10040040U, 0x10000040U, 0x10001000U,
+    0x00041040U, 0x00040000U, 0x00041040U, 0x00040000U, 0x10041000U,
+    0x00001000U, 0x00000040U, 0x10040040U, 0x00001000U, 0x00041040U,
+    0x10001000U, 0x00000040U, 0x10000040U, 0x10040000U, 0x10040040U,
+    0x10000000U, 0x00040000U, 0x10001040U, 0x00000000U, 0x10041040U,
+    0x00040040U, 0x10000040U, 0x10040000U, 0x10001000U, 0x10001040U,
+    0x00000000U, 0x10041040U, 0x00041000U, 0x00041000U, 0x00001040U,
+    0x00001040U, 0x00040040U, 0x10000000U, 0x10041000U
+  }
+};
+
+static const uint8_t des_pc1[56] = {
+  57U, 49U, 41U, 33U, 25U, 17U,  9U,  1U, 58U, 50U, 42U, 34U, 26U, 18U,
+  10U,  2U, 59U, 51U, 43U, 35U, 27U, 19U, 11U,  3U, 60U, 52U, 44U, 36U,
+  63U, 55U, 47U, 39U, 31U, 23U, 15U,  7U, 62U, 54U, 46U, 38U, 30U, 22U,
+  14U,  6U, 61U, 53U, 45U, 37U, 29U, 21U, 13U,  5U, 28U, 20U, 12U,  4U
+};
+
+static const uint8_t des_pc2[48] = {
+  14U, 17U, 11U, 24U,  1U,  5U,  3U, 28U, 15U,  6U, 21U, 10U,
+  23U, 19U, 12U,  4U, 26U,  8U, 16U,  7U, 27U, 20U, 13U,  2U,
+  41U, 52U, 31U, 37U, 47U, 55U, 30U, 40U, 51U, 45U, 33U, 48U,
+  44U, 49U, 39U, 56U, 34U, 53U, 46U, 42U, 50U, 36U, 29U, 32U
+};
+
+static const uint8_t des_shifts[16] = {
+  1U, 1U, 2U, 2U, 2U, 2U, 2U, 2U, 1U, 2U, 2U, 2U, 2U, 2U, 2U, 1U
+};
+
+static const uint32_t sha1_h0[5] = {
+  0x67452301U, 0xEFCDAB89U, 0x98BADCFEU, 0x10325476U, 0xC3D2E1F0U
+};
+
+static const uint32_t sha256_h0[8] = {
+  0x6A09E667U, 0xBB67AE85U, 0x3C6EF372U, 0xA54FF53AU,
+  0x510E527FU, 0x9B05688CU, 0x1F83D9ABU, 0x5BE0CD19U
+};
+
+static const uint32_t sha256_k[64] = {
+  0x428A2F98U, 0x71374491U, 0xB5C0FBCFU, 0xE9B5DBA5U, 0x3956C25BU, 0x59F111F1U,
+  0x923F82A4U, 0xAB1C5ED5U, 0xD807AA98U, 0x12835B01U, 0x243185BEU, 0x550C7DC3U,
+  0x72BE5D74U, 0x80DEB1FEU, 0x9BDC06A7U, 0xC19BF174U, 0xE49B69C1U, 0xEFBE4786U,
+  0x0FC19DC6U, 0x240CA1CCU, 0x2DE92C6FU, 0x4A7484AAU, 0x5CB0A9DCU, 0x76F988DAU,
+  0x983E5152U, 0xA831C66DU, 0xB00327C8U, 0xBF597FC7U, 0xC6E00BF3U, 0xD5A79147U,
+  0x06CA6351U, 0x14292967U, 0x27B70A85U, 0x2E1B2138U, 0x4D2C6DFCU, 0x53380D13U,
+  0x650A7354U, 0x766A0ABBU, 0x81C2C92EU, 0x92722C85U, 0xA2BFE8A1U, 0xA81A664BU,
+  0xC24B8B70U, 0xC76C51A3U, 0xD192E819U, 0xD6990624U, 0xF40E3585U, 0x106AA070U,
+  0x19A4C116U, 0x1E376C08U, 0x2748774CU, 0x34B0BCB5U, 0x391C0CB3U, 0x4ED8AA4AU,
+  0x5B9CCA4FU, 0x682E6FF3U, 0x748F82EEU, 0x78A5636FU, 0x84C87814U, 0x8CC70208U,
+  0x90BEFFFAU, 0xA4506CEBU, 0xBEF9A3F7U, 0xC67178F2U
+};
+
+static const uint64_t sha512_h0[8] = {
+  0x6A09E667F3BCC908U, 0xBB67AE8584CAA73BU,
+  0x3C6EF372FE94F82BU, 0xA54FF53A5F1D36F1U,
+  0x510E527FADE682D1U, 0x9B05688C2B3E6C1FU,
+  0x1F83D9ABFB41BD6BU, 0x5BE0CD19137E2179U
+};
+
+static const uint64_t sha512_k[80] = {
+  0x428A2F98D728AE22U, 0x7137449123EF65CDU, 0xB5C0FBCFEC4D3B2FU,
+  0xE9B5DBA58189DBBCU, 0x3956C25BF348B538U, 0x59F111F1B605D019U,
+  0x923F82A4AF194F9BU, 0xAB1C5ED5DA6D8118U, 0xD807AA98A3030242U,
+  0x12835B0145706FBEU, 0x243185BE4EE4B28CU, 0x550C7DC3D5FFB4E2U,
+  0x72BE5D74F27B896FU, 0x80DEB1FE3B1696B1U, 0x9BDC06A725C71235U,
+  0xC19BF174CF692694U, 0xE49B69C19EF14AD2U, 0xEFBE4786384F25E3U,
+  0x0FC19DC68B8CD5B5U, 0x240CA1CC77AC9C65U, 0x2DE92C6F592B0275U,
+  0x4A7484AA6EA6E483U, 0x5CB0A9DCBD41FBD4U, 0x76F988DA831153B5U,
+  0x983E5152EE66DFABU, 0xA831C66D2DB43210U, 0xB00327C898FB213FU,
+  0xBF597FC7BEEF0EE4U, 0xC6E00BF33DA88FC2U, 0xD5A79147930AA725U,
+  0x06CA6351E003826FU, 0x142929670A0E6E70U, 0x27B70A8546D22FFCU,
+  0x2E1B21385C26C926U, 0x4D2C6DFC5AC42AEDU, 0x53380D139D95B3DFU,
+  0x650A73548BAF63DEU, 0x766A0ABB3C77B2A8U, 0x81C2C92E47EDAEE6U,
+  0x92722C851482353BU, 0xA2BFE8A14CF10364U, 0xA81A664BBC423001U,
+  0xC24B8B70D0F89791U, 0xC76C51A30654BE30U, 0xD192E819D6EF5218U,
+  0xD69906245565A910U, 0xF40E35855771202AU, 0x106AA07032BBD1B8U,
+  0x19A4C116B8D2D0C8U, 0x1E376C085141AB53U, 0x2748774CDF8EEB99U,
+  0x34B0BCB5E19B48A8U, 0x391C0CB3C5C95A63U, 0x4ED8AA4AE3418ACBU,
+  0x5B9CCA4F7763E373U, 0x682E6FF3D6B2B8A3U, 0x748F82EE5DEFB2FCU,
+  0x78A5636F43172F60U, 0x84C87814A1F0AB72U, 0x8CC702081A6439ECU,
+  0x90BEFFFA23631E28U, 0xA4506CEBDE82BDE9U, 0xBEF9A3F7B2C67915U,
+  0xC67178F2E372532BU, 0xCA273ECEEA26619CU, 0xD186B8C721C0C207U,
+  0xEADA7DD6CDE0EB1EU, 0xF57D4F7FEE6ED178U, 0x06F067AA72176FBAU,
+  0x0A637DC5A2C898A6U, 0x113F9804BEF90DAEU, 0x1B710B35131C471BU,
+  0x28DB77F523047D84U, 0x32CAAB7B40C72493U, 0x3C9EBE0A15C9BEBCU,
+  0x431D67C49C100D4CU, 0x4CC5D4BECB3E42B6U, 0x597F299CFC657E2AU,
+  0x5FCB6FAB3AD6FAECU, 0x6C44198C4A475817U
+};
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+static void aes_encrypt_block(const uint8_t *in, uint8_t *out) {
+  const uint32_t *rk = aes_key.ek;
+  uint32_t s0, s1, s2, s3, t0, t1, t2, t3;
+  unsigned r;
+
+  s0 = GET_U32_BE(in)      ^ rk[0];
+  s1 = GET_U32_BE(in + 4)  ^ rk[1];
+  s2 = GET_U32_BE(in + 8)  ^ rk[2];
+  s3 = GET_U32_BE(in + 12) ^ rk[3];
+  rk += 4;
+
+  for (r = aes_key.rounds - 1U; r > 0U; r--) {
+    t0 = TE0(s0) ^ TE1(s1) ^ TE2(s2) ^ TE3(s3) ^ rk[0];
+    t1 = TE0(s1) ^ TE1(s2) ^ TE2(s3) ^ TE3(s0) ^ rk[1];
+    t2 = TE0(s2) ^ TE1(s3) ^ TE2(s0) ^ TE3(s1) ^ rk[2];
+    t3 = TE0(s3) ^ TE1(s0) ^ TE2(s1) ^ TE3(s2) ^ rk[3];
+    s0 = t0;
+    s1 = t1;
+    s2 = t2;
+    s3 = t3;
+    rk += 4;
+  }
+
+  t0 = SB(s0, 24) ^ SB(s1, 16) ^ SB(s2, 8) ^ SB(s3, 0) ^ rk[0];
+  t1 = SB(s1, 24) ^ SB(s2, 16) ^ SB(s3, 8) ^ SB(s0, 0) ^ rk[1];
+  t2 = SB(s2, 24) ^ SB(s3, 16) ^ SB(s0, 8) ^ SB(s1, 0) ^ rk[2];
+  t3 = SB(s3, 24) ^ SB(s0, 16) ^ SB(s1, 8) ^ SB(s2, 0) ^ rk[3];
+  PUT_U32_BE(out,      t0);
+  PUT_U32_BE(out + 4,  t1);
+  PUT_U32_BE(out + 8,  t2);
+  PUT_U32_BE(out + 12, t3);
+}
+
+static void aes_decrypt_block(const uint8_t *in, uint8_t *out) {
+  const uint32_t *rk = aes_key.dk;
+  uint32_t s0, s1, s2, s3, t0, t1, t2, t3;
+  unsigned r;
+
+  s0 = GET_U32_BE(in)      ^ rk[0];
+  s1 = GET_U32_BE(in + 4)  ^ rk[1];
+  s2 = GET_U32_BE(in + 8)  ^ rk[2];
+  s3 = GET_U32_BE(in + 12) ^ rk[3];
+  rk += 4;
+
+  for (r = aes_key.rounds - 1U; r > 0U; r--) {
+    t0 = TD0(s0) ^ TD1(s3) ^ TD2(s2) ^ TD3(s1) ^ rk[0];
+    t1 = TD0(s1) ^ TD1(s0) ^ TD2(s3) ^ TD3(s2) ^ rk[1];
+    t2 = TD0(s2) ^ TD1(s1) ^ TD2(s0) ^ TD3(s3) ^ rk[2];
+    t3 = TD0(s3) ^ TD1(s2) ^ TD2(s1) ^ TD3(s0) ^ rk[3];
+    s0 = t0;
+    s1 = t1;
+    s2 = t2;
+    s3 = t3;
+    rk += 4;
+  }
+
+  t0 = ISB(s0, 24) ^ ISB(s3, 16) ^ ISB(s2, 8) ^ ISB(s1, 0) ^ rk[0];
+  t1 = ISB(s1, 24) ^ ISB(s0, 16) ^ ISB(s3, 8) ^ ISB(s2, 0) ^ rk[1];
+  t2 = ISB(s2, 24) ^ ISB(s1, 16) ^ ISB(s0, 8) ^ ISB(s3, 0) ^ rk[2];
+  t3 = ISB(s3, 24) ^ ISB(s2, 16) ^ ISB(s1, 8) ^ ISB(s0, 0) ^ rk[3];
+  PUT_U32_BE(out,      t0);
+  PUT_U32_BE(out + 4,  t1);
+  PUT_U32_BE(out + 8,  t2);
+  PUT_U32_BE(out + 12, t3);
+}
+
+static void aes_expand_key(const uint8_t *keyp, size_t size) {
+  unsigned i, j, nk, nw, rounds;
+  uint32_t rcon = 1U;
+
+  nk     = (unsigned)size / 4U;
+  rounds = nk + 6U;
+  nw     = (rounds + 1U) * 4U;
+
+  /* Encryption schedule.*/
+  for (i = 0U; i < nk; i++) {
+    aes_key.ek[i] = GET_U32_BE(keyp + (i * 4U));
+  }
+  for (i = nk; i < nw; i++) {
+    uint32_t t = aes_key.ek[i - 1U];
+
+    if ((i % nk) == 0U) {
+      /* SubWord(RotWord(t)) xor Rcon.*/
+      t = ((uint32_t)aes_sbox[(t >> 16) & 0xFFU] << 24) |
+          ((uint32_t)aes_sbox[(t >> 8) & 0xFFU] << 16) |
+          ((uint32_t)aes_sbox[t & 0xFFU] << 8) |
+          (uint32_t)aes_sbox[t >> 24];
+      t ^= rcon << 24;
+      rcon = (rcon << 1) ^ ((rcon >> 7) * 0x11BU);
+    }
+    else if ((nk > 6U) && ((i % nk) == 4U)) {
+      t = SB(t, 24) | SB(t, 16) | SB(t, 8) | SB(t, 0);
+    }
+    aes_key.ek[i] = aes_key.ek[i - nk] ^ t;
+  }
+
+  /* Decryption schedule for the equivalent inverse cipher, round keys in
+     reverse order with InvMixColumns applied to the inner ones.*/
+  for (i = 0U; i < 4U; i++) {
+    aes_key.dk[i]                 = aes_key.ek[(rounds * 4U) + i];
+    aes_key.dk[(rounds * 4U) + i] = aes_key.ek[i];
+  }
+  for (j = 1U; j < rounds; j++) {
+    for (i = 0U; i < 4U; i++) {
+      uint32_t t = aes_key.ek[((rounds - j) * 4U) + i];
+
+      aes_key.dk[(j * 4U) + i] = TD0(SB(t, 24)) ^ TD1(SB(t, 16)) ^
+                                 TD2(SB(t, 8))  ^ TD3(SB(t, 0));
+    }
+  }
+
+  aes_key.rounds = rounds;
+}
+
+static void gcm_init_table(void) {
+  uint8_t h[16];
+  uint64_t vh, vl;
+  unsigned i, j;
+
+  memset(h, 0, sizeof h);
+  aes_encrypt_block(h, h);
+  vh = GET_U64_BE(h);
+  vl = GET_U64_BE(h + 8);
+
+  aes_key.hh[0] = 0U;
+  aes_key.hl[0] = 0U;
+  aes_key.hh[8] = vh;
+  aes_key.hl[8] = vl;
+  for (i = 4U; i > 0U; i >>= 1) {
+    uint64_t t = (vl & 1U) * 0xE1000000U;
+
+    vl = (vh << 63) | (vl >> 1);
+    vh = (vh >> 1) ^ (t << 32);
+    aes_key.hh[i] = vh;
+    aes_key.hl[i] = vl;
+  }
+  for (i = 2U; i <= 8U; i <<= 1) {
+    vh = aes_key.hh[i];
+    vl = aes_key.hl[i];
+    for (j = 1U; j < i; j++) {
+      aes_key.hh[i + j] = vh ^ aes_key.hh[j];
+      aes_key.hl[i + j] = vl ^ aes_key.hl[j];
+    }
+  }
+}
+
+static void gcm_mult(uint8_t *x) {
+  uint64_t zh, zl;
+  unsigned i, lo, hi, rem;
+
+  lo = x[15] & 0x0FU;
+  zh = aes_key.hh[lo];
+  zl = aes_key.hl[lo];
+  for (i = 16U; i > 0U; i--) {
+    lo = x[i - 1U] & 0x0FU;
+    hi = x[i - 1U] >> 4;
+    if (i != 16U) {
+      rem = (unsigned)zl & 0x0FU;
+      zl  = (zh << 60) | (zl >> 4);
+      zh  = (zh >> 4) ^ (gcm_last4[rem] << 48);
+      zh ^= aes_key.hh[lo];
+      zl ^= aes_key.hl[lo];
+    }
+    rem = (unsigned)zl & 0x0FU;
+    zl  = (zh << 60) | (zl >> 4);
+    zh  = (zh >> 4) ^ (gcm_last4[rem] << 48);
+    zh ^= aes_key.hh[hi];
+    zl ^= aes_key.hl[hi];
+  }
+  PUT_U64_BE(x, zh);
+  PUT_U64_BE(x + 8, zl);
+}
+
+static void gcm_ghash(uint8_t *y, const uint8_t *in, size_t size) {
+
+  while (size > 0U) {
+    size_t i, n = size < 16U ? size : 16U;
+
+    for (i = 0U; i < n; i++) {
+      y[i] ^= in[i];
+    }
+    gcm_mult(y);
+    in   += n;
+    size -= n;
+  }
+}
+
+static void ctr_increment(uint8_t *cb) {
+  uint32_t ctr = GET_U32_BE(cb + 12) + 1U;
+
+  PUT_U32_BE(cb + 12, ctr);
+}
+
+static void aes_ctr(uint8_t *cb, size_t size,
+                    const uint8_t *in, uint8_t *out) {
+  uint8_t ks[16];
+
+  while (size > 0U) {
+    size_t i, n = size < 16U ? size : 16U;
+
+    aes_encrypt_block(cb, ks);
+    ctr_increment(cb);
+    for (i = 0U; i < n; i++) {
+      out[i] = in[i] ^ ks[i];
+    }
+    in   += n;
+    out  += n;
+    size -= n;
+  }
+}
+
+static void gcm_final(uint8_t *y, size_t auth_size, size_t text_size,
+                      const uint8_t *iv) {
+  uint8_t b[16];
+  unsigned i;
+
+  PUT_U64_BE(b, (uint64_t)auth_size << 3);
+  PUT_U64_BE(b + 8, (uint64_t)text_size << 3);
+  gcm_ghash(y, b, 16U);
+  aes_encrypt_block(iv, b);
+  for (i = 0U; i < 16U; i++) {
+    y[i] ^= b[i];
+  }
+}
+
+static void des_expand_key(const uint8_t *keyp, uint32_t *ek, uint32_t *dk) {
+  uint64_t k, cd;
+  uint32_t c, d;
+  unsigned i, r;
+
+  k  = GET_U64_BE(keyp);
+  cd = 0U;
+  for (i = 0U; i < 56U; i++) {
+    cd = (cd << 1) | ((k >> (64U - des_pc1[i])) & 1U);
+  }
+  c = (uint32_t)(cd >> 28) & 0x0FFFFFFFU;
+  d = (uint32_t)cd & 0x0FFFFFFFU;
+
+  for (r = 0U; r < 16U; r++) {
+    unsigned s = des_shifts[r];
+    uint64_t sk = 0U;
+
+    c  = ((c << s) | (c >> (28U - s))) & 0x0FFFFFFFU;
+    d  = ((d << s) | (d >> (28U - s))) & 0x0FFFFFFFU;
+    cd = ((uint64_t)c << 28) | (uint64_t)d;
+    for (i = 0U; i < 48U; i++) {
+      sk = (sk << 1) | ((cd >> (56U - des_pc2[i])) & 1U);
+    }
+
+    /* Six bits groups arranged as expected by DES_ROUND().*/
+    ek[(r * 2U)]      = ((uint32_t)(sk >> 42) & 0x3FU) << 24 |
+                        ((uint32_t)(sk >> 30) & 0x3FU) << 16 |
+                        ((uint32_t)(sk >> 18) & 0x3FU) << 8  |
+                        ((uint32_t)(sk >> 6)  & 0x3FU);
+    ek[(r * 2U) + 1U] = ((uint32_t)(sk >> 36) & 0x3FU) << 24 |
+                        ((uint32_t)(sk >> 24) & 0x3FU) << 16 |
+                        ((uint32_t)(sk >> 12) & 0x3FU) << 8  |
+                        ((uint32_t)sk & 0x3FU);
+  }
+
+  for (r = 0U; r < 16U; r++) {
+    dk[(r * 2U)]      = ek[30U - (r * 2U)];
+    dk[(r * 2U) + 1U] = ek[31U - (r * 2U)];
+  }
+}
+
+static void des_block(const uint32_t *const *ks, const uint8_t *in,
+                      uint8_t *out) {
+  uint32_t l, r, w;
+  unsigned i, j;
+
+  l = GET_U32_BE(in);
+  r = GET_U32_BE(in + 4);
+
+  /* Initial permutation.*/
+  w = ((l >> 4) ^ r) & 0x0F0F0F0FU;
+  r ^= w;
+  l ^= w << 4;
+  w = ((l >> 16) ^ r) & 0x0000FFFFU;
+  r ^= w;
+  l ^= w << 16;
+  w = ((r >> 2) ^ l) & 0x33333333U;
+  l ^= w;
+  r ^= w << 2;
+  w = ((r >> 8) ^ l) & 0x00FF00FFU;
+  l ^= w;
+  r ^= w << 8;
+  r = ROTL32(r, 1U);
+  w = (l ^ r) & 0xAAAAAAAAU;
+  l ^= w;
+  r ^= w;
+  l = ROTL32(l, 1U);
+
+  /* One or three passes of 16 rounds, for TDES the final permutation of
+     a pass and the initial permutation of the next one cancel out.*/
+  for (i = 0U; i < des_key.nkeys; i++) {
+    const uint32_t *kp = ks[i];
+
+    if (i > 0U) {
+      w = l;
+      l = r;
+      r = w;
+    }
+    for (j = 0U; j < 8U; j++) {
+      DES_ROUND(l, r, kp);
+      DES_ROUND(r, l, kp + 2);
+      kp += 4;
+    }
+  }
+
+  /* Final permutation.*/
+  r = ROTR32(r, 1U);
+  w = (l ^ r) & 0xAAAAAAAAU;
+  l ^= w;
+  r ^= w;
+  l = ROTR32(l, 1U);
+  w = ((l >> 8) ^ r) & 0x00FF00FFU;
+  r ^= w;
+  l ^= w << 8;
+  w = ((l >> 2) ^ r) & 0x33333333U;
+  r ^= w;
+  l ^= w << 2;
+  w = ((r >> 16) ^ l) & 0x0000FFFFU;
+  l ^= w;
+  r ^= w << 16;
+  w = ((r >> 4) ^ l) & 0x0F0F0F0FU;
+  l ^= w;
+  r ^= w << 4;
+
+  PUT_U32_BE(out, r);
+  PUT_U32_BE(out + 4, l);
+}
+
+static void des_encrypt_block(const uint8_t *in, uint8_t *out) {
+  const uint32_t *ks[3] = {des_key.ek[0], des_key.dk[1], des_key.ek[2]};
+
+  des_block(ks, in, out);
+}
+
+static void des_decrypt_block(const uint8_t *in, uint8_t *out) {
+  const uint32_t *ks[3] = {des_key.dk[2], des_key.ek[1], des_key.dk[0]};
+
+  if (des_key.nkeys == 1U) {
+    ks[0] = des_key.dk[0];
+  }
+  des_block(ks, in, out);
+}
+
+static void sha1_compress(uint32_t *h, const uint8_t *p, size_t n) {
+
+  while (n > 0U) {
+    uint32_t w[16], a, b, c, d, e, t;
+    unsigned i;
+
+    a = h[0];
+    b = h[1];
+    c = h[2];
+    d = h[3];
+    e = h[4];
+    for (i = 0U; i < 80U; i++) {
+      if (i < 16U) {
+        w[i] = GET_U32_BE(p + (i * 4U));
+      }
+      else {
+        t = w[(i + 13U) & 15U] ^ w[(i + 8U) & 15U] ^
+            w[(i + 2U) & 15U] ^ w[i & 15U];
+        w[i & 15U] = ROTL32(t, 1U);
+      }
+      if (i < 20U) {
+        t = CH(b, c, d) + 0x5A827999U;
+      }
+      else if (i < 40U) {
+        t = PARITY(b, c, d) + 0x6ED9EBA1U;
+      }
+      else if (i < 60U) {
+        t = MAJ(b, c, d) + 0x8F1BBCDCU;
+      }
+      else {
+        t = PARITY(b, c, d) + 0xCA62C1D6U;
+      }
+      t += ROTL32(a, 5U) + e + w[i & 15U];
+      e = d;
+      d = c;
+      c = ROTL32(b, 30U);
+      b = a;
+      a = t;
+    }
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+    p += CRY_FALLBACK_SHA1_BLOCK_SIZE;
+    n--;
+  }
+}
+
+static void sha256_compress(uint32_t *h, const uint8_t *p, size_t n) {
+
+  while (n > 0U) {
+    uint32_t w[16], s[8], t1, t2;
+    unsigned i;
+
+    memcpy(s, h, sizeof s);
+    for (i = 0U; i < 64U; i++) {
+      if (i < 16U) {
+        w[i] = GET_U32_BE(p + (i * 4U));
+      }
+      else {
+        w[i & 15U] += G256_1(w[(i + 14U) & 15U]) + w[(i + 9U) & 15U] +
+                      G256_0(w[(i + 1U) & 15U]);
+      }
+      t1 = s[7] + S256_1(s[4]) + CH(s[4], s[5], s[6]) + sha256_k[i] +
+           w[i & 15U];
+      t2 = S256_0(s[0]) + MAJ(s[0], s[1], s[2]);
+      s[7] = s[6];
+      s[6] = s[5];
+      s[5] = s[4];
+      s[4] = s[3] + t1;
+      s[3] = s[2];
+      s[2] = s[1];
+      s[1] = s[0];
+      s[0] = t1 + t2;
+    }
+    for (i = 0U; i < 8U; i++) {
+      h[i] += s[i];
+    }
+    p += CRY_FALLBACK_SHA256_BLOCK_SIZE;
+    n--;
+  }
+}
+
+static void sha512_compress(uint64_t *h, const uint8_t *p, size_t n) {
+
+  while (n > 0U) {
+    uint64_t w[16], s[8], t1, t2;
+    unsigned i;
+
+    memcpy(s, h, sizeof s);
+    for (i = 0U; i < 80U; i++) {
+      if (i < 16U) {
+        w[i] = GET_U64_BE(p + (i * 8U));
+      }
+      else {
+        w[i & 15U] += G512_1(w[(i + 14U) & 15U]) + w[(i + 9U) & 15U] +
+                      G512_0(w[(i + 1U) & 15U]);
+      }
+      t1 = s[7] + S512_1(s[4]) + CH(s[4], s[5], s[6]) + sha512_k[i] +
+           w[i & 15U];
+      t2 = S512_0(s[0]) + MAJ(s[0], s[1], s[2]);
+      s[7] = s[6];
+      s[6] = s[5];
+      s[5] = s[4];
+      s[4] = s[3] + t1;
+      s[3] = s[2];
+      s[2] = s[1];
+      s[1] = s[0];
+      s[0] = t1 + t2;
+    }
+    for (i = 0U; i < 8U; i++) {
+      h[i] += s[i];
+    }
+    p += CRY_FALLBACK_SHA512_BLOCK_SIZE;
+    n--;
+  }
+}
+
+/* Common update for the 64 bytes block algorithms, whole blocks are
+   compressed directly from the input buffer.*/
+static void sha32_update(uint32_t *h, uint64_t *lengthp, uint8_t *buffer,
+                         sha32compress_t compress,
+                         size_t size, const uint8_t *in) {
+  size_t used = (size_t)(*lengthp & 63U);
+
+  *lengthp += (uint64_t)size;
+  if (used > 0U) {
+    size_t n = 64U - used;
+
+    if (size < n) {
+      memcpy(&buffer[used], in, size);
+      return;
+    }
+    memcpy(&buffer[used], in, n);
+    compress(h, buffer, 1U);
+    in   += n;
+    size -= n;
+  }
+  if (size >= 64U) {
+    compress(h, in, size / 64U);
+    in   += size & ~(size_t)63U;
+    size &= 63U;
+  }
+  if (size > 0U) {
+    memcpy(buffer, in, size);
+  }
+}
+
+static void sha32_final(uint32_t *h, uint64_t length, uint8_t *buffer,
+                        sha32compress_t compress) {
+  size_t used = (size_t)(length & 63U);
+
+  buffer[used++] = 0x80U;
+  if (used > 56U) {
+    memset(&buffer[used], 0, 64U - used);
+    compress(h, buffer, 1U);
+    used = 0U;
+  }
+  memset(&buffer[used], 0, 56U - used);
+  PUT_U64_BE(&buffer[56], length << 3);
+  compress(h, buffer, 1U);
+}
+
+static void sha512_update(crysha512state_t *sp, size_t size,
+                          const uint8_t *in) {
+  size_t used = (size_t)(sp->length & 127U);
+
+  sp->length += (uint64_t)size;
+  if (used > 0U) {
+    size_t n = 128U - used;
+
+    if (size < n) {
+      memcpy(&sp->buffer[used], in, size);
+      return;
+    }
+    memcpy(&sp->buffer[used], in, n);
+    sha512_compress(sp->h, sp->buffer, 1U);
+    in   += n;
+    size -= n;
+  }
+  if (size >= 128U) {
+    sha512_compress(sp->h, in, size / 128U);
+    in   += size & ~(size_t)127U;
+    size &= 127U;
+  }
+  if (size > 0U) {
+    memcpy(sp->buffer, in, size);
+  }
+}
+
+static void sha512_final(crysha512state_t *sp, uint8_t *out) {
+  size_t used = (size_t)(sp->length & 127U);
+  unsigned i;
+
+  sp->buffer[used++] = 0x80U;
+  if (used > 112U) {
+    memset(&sp->buffer[used], 0, 128U - used);
+    sha512_compress(sp->h, sp->buffer, 1U);
+    used = 0U;
+  }
+  memset(&sp->buffer[used], 0, 112U - used);
+  PUT_U64_BE(&sp->buffer[112], sp->length >> 61);
+  PUT_U64_BE(&sp->buffer[120], sp->length << 3);
+  sha512_compress(sp->h, sp->buffer, 1U);
+  for (i = 0U; i < 8U; i++) {
+    PUT_U64_BE(out + (i * 8U), sp->h[i]);
+  }
+}
+
+static void sha256_digest(crysha256state_t *sp, uint8_t *out) {
+  unsigned i;
+
+  sha32_final(sp->h, sp->length, sp->buffer, sha256_compress);
+  for (i = 0U; i < 8U; i++) {
+    PUT_U32_BE(out + (i * 4U), sp->h[i]);
+  }
+}
+
+static void sha256_start(crysha256state_t *sp) {
+
+  memcpy(sp->h, sha256_h0, sizeof sp->h);
+  sp->length = 0U;
+}
+
+static void sha512_start(crysha512state_t *sp) {
+
+  memcpy(sp->h, sha512_h0, sizeof sp->h);
+  sp->length = 0U;
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Fall-back initialization.
+ * @note    Initializes the driver instance when the fall-back is enforced.
+ *
+ * @notapi
+ */
+void cry_fallback_init(void) {
+
+#if HAL_CRY_ENFORCE_FALLBACK == TRUE
+  cryObjectInit(&CRYD1);
+#endif
+}
+
+/**
+ * @brief   Initializes the AES transient key.
+ * @note    The GHASH table used by AES-GCM is also computed here.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] size              key size in bytes, 16, 24 or 32
+ * @param[in] keyp              pointer to the key data
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_SIZE if the specified key size is invalid.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_aes_loadkey(CRYDriver *cryp,
+                                    size_t size,
+                                    const uint8_t *keyp) {
+
+  (void)cryp;
+
+  if ((size != 16U) && (size != 24U) && (size != 32U)) {
+    return CRY_ERR_INV_KEY_SIZE;
+  }
+
+  aes_expand_key(keyp, size);
+  gcm_init_table();
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Encryption of a single block using AES.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, only
+ *                              the transient key zero is supported
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output ciphertext
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_AES(CRYDriver *cryp,
+                                    crykey_t key_id,
+                                    const uint8_t *in,
+                                    uint8_t *out) {
+
+  (void)cryp;
+
+  if ((key_id != (crykey_t)0) || (aes_key.rounds == 0U)) {
+    return CRY_ERR_INV_KEY_ID;
+  }
+
+  aes_encrypt_block(in, out);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Decryption of a single block using AES.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, only
+ *                              the transient key zero is supported
+ * @param[in] in                buffer containing the input ciphertext
+ * @param[out] out              buffer for the output plaintext
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_AES(CRYDriver *cryp,
+                                    crykey_t key_id,
+                                    const uint8_t *in,
+                                    uint8_t *out) {
+
+  (void)cryp;
+
+  if ((key_id != (crykey_t)0) || (aes_key.rounds == 0U)) {
+    return CRY_ERR_INV_KEY_ID;
+  }
+
+  aes_decrypt_block(in, out);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Encryption operation using AES-ECB.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, only
+ *                              the transient key zero is supported
+ * @param[in] size              size of both buffers, this number must be a
+ *                              multiple of 16
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output ciphertext
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_AES_ECB(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out) {
+
+  (void)cryp;
+
+  if ((key_id != (crykey_t)0) || (aes_key.rounds == 0U)) {
+    return CRY_ERR_INV_KEY_ID;
+  }
+
+  while (size >= 16U) {
+    aes_encrypt_block(in, out);
+    in   += 16;
+    out  += 16;
+    size -= 16U;
+  }
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Decryption operation using AES-ECB.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, only
+ *                              the transient key zero is supported
+ * @param[in] size              size of both buffers, this number must be a
+ *                              multiple of 16
+ * @param[in] in                buffer containing the input ciphertext
+ * @param[out] out              buffer for the output plaintext
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_AES_ECB(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out) {
+
+  (void)cryp;
+
+  if ((key_id != (crykey_t)0) || (aes_key.rounds == 0U)) {
+    return CRY_ERR_INV_KEY_ID;
+  }
+
+  while (size >= 16U) {
+    aes_decrypt_block(in, out);
+    in   += 16;
+    out  += 16;
+    size -= 16U;
+  }
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Encryption operation using AES-CBC.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, only
+ *                              the transient key zero is supported
+ * @param[in] size              size of both buffers, this number must be a
+ *                              multiple of 16
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output ciphertext
+ * @param[in] iv                128 bits initial vector
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_AES_CBC(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out,
+                                        const uint8_t *iv) {
+  const uint8_t *chain = iv;
+
+  (void)cryp;
+
+  if ((key_id != (crykey_t)0) || (aes_key.rounds == 0U)) {
+    return CRY_ERR_INV_KEY_ID;
+  }
+
+  while (size >= 16U) {
+    unsigned i;
+
+    for (i = 0U; i < 16U; i++) {
+      out[i] = in[i] ^ chain[i];
+    }
+    aes_encrypt_block(out, out);
+    chain = out;
+    in   += 16;
+    out  += 16;
+    size -= 16U;
+  }
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Decryption operation using AES-CBC.
+ * @note    The buffers can overlap exactly, in-place operations are
+ *          supported.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, only
+ *                              the transient key zero is supported
+ * @param[in] size              size of both buffers, this number must be a
+ *                              multiple of 16
+ * @param[in] in                buffer containing the input ciphertext
+ * @param[out] out              buffer for the output plaintext
+ * @param[in] iv                128 bits initial vector
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_AES_CBC(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out,
+                                        const uint8_t *iv) {
+  uint8_t chain[16], next[16];
+
+  (void)cryp;
+
+  if ((key_id != (crykey_t)0) || (aes_key.rounds == 0U)) {
+    return CRY_ERR_INV_KEY_ID;
+  }
+
+  memcpy(chain, iv, 16U);
+  while (size >= 16U) {
+    unsigned i;
+
+    memcpy(next, in, 16U);
+    aes_decrypt_block(in, out);
+    for (i = 0U; i < 16U; i++) {
+      out[i] ^= chain[i];
+    }
+    memcpy(chain, next, 16U);
+    in   += 16;
+    out  += 16;
+    size -= 16U;
+  }
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Encryption operation using AES-CFB.
+ * @note    This is a stream cipher, there are no size restrictions.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, only
+ *                              the transient key zero is supported
+ * @param[in] size              size of both buffers
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output ciphertext
+ * @param[in] iv                128 bits initial vector
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_AES_CFB(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out,
+                                        const uint8_t *iv) {
+  uint8_t ks[16];
+  const uint8_t *chain = iv;
+
+  (void)cryp;
+
+  if ((key_id != (crykey_t)0) || (aes_key.rounds == 0U)) {
+    return CRY_ERR_INV_KEY_ID;
+  }
+
+  while (size > 0U) {
+    size_t i, n = size < 16U ? size : 16U;
+
+    aes_encrypt_block(chain, ks);
+    for (i = 0U; i < n; i++) {
+      out[i] = in[i] ^ ks[i];
+    }
+    chain = out;
+    in   += n;
+    out  += n;
+    size -= n;
+  }
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Decryption operation using AES-CFB.
+ * @note    This is a stream cipher, there are no size restrictions.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, only
+ *                              the transient key zero is supported
+ * @param[in] size              size of both buffers
+ * @param[in] in                buffer containing the input ciphertext
+ * @param[out] out              buffer for the output plaintext
+ * @param[in] iv                128 bits initial vector
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_AES_CFB(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out,
+                                        const uint8_t *iv) {
+  uint8_t ks[16];
+
+  (void)cryp;
+
+  if ((key_id != (crykey_t)0) || (aes_key.rounds == 0U)) {
+    return CRY_ERR_INV_KEY_ID;
+  }
+
+  aes_encrypt_block(iv, ks);
+  while (size > 0U) {
+    size_t i, n = size < 16U ? size : 16U;
+
+    /* Next key stream block computed before the ciphertext is
+       overwritten by an in-place operation.*/
+    if (size > 16U) {
+      uint8_t next[16];
+
+      aes_encrypt_block(in, next);
+      for (i = 0U; i < 16U; i++) {
+        out[i] = in[i] ^ ks[i];
+      }
+      memcpy(ks, next, 16U);
+    }
+    else {
+      for (i = 0U; i < n; i++) {
+        out[i] = in[i] ^ ks[i];
+      }
+    }
+    in   += n;
+    out  += n;
+    size -= n;
+  }
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Encryption operation using AES-CTR.
+ * @note    This is a stream cipher, there are no size restrictions.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, only
+ *                              the transient key zero is supported
+ * @param[in] size              size of both buffers
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output ciphertext
+ * @param[in] iv                128 bits input vector + counter, it contains
+ *                              a 96 bits IV and a 32 bits counter
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_AES_CTR(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out,
+                                        const uint8_t *iv) {
+  uint8_t cb[16];
+
+  (void)cryp;
+
+  if ((key_id != (crykey_t)0) || (aes_key.rounds == 0U)) {
+    return CRY_ERR_INV_KEY_ID;
+  }
+
+  memcpy(cb, iv, 16U);
+  aes_ctr(cb, size, in, out);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Decryption operation using AES-CTR.
+ * @note    This is a stream cipher, there are no size restrictions.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, only
+ *                              the transient key zero is supported
+ * @param[in] size              size of both buffers
+ * @param[in] in                buffer containing the input ciphertext
+ * @param[out] out              buffer for the output plaintext
+ * @param[in] iv                128 bits input vector + counter, it contains
+ *                              a 96 bits IV and a 32 bits counter
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_AES_CTR(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out,
+                                        const uint8_t *iv) {
+
+  return cry_fallback_encrypt_AES_CTR(cryp, key_id, size, in, out, iv);
+}
+
+/**
+ * @brief   Encryption operation using AES-GCM.
+ * @note    This is a stream cipher, there are no size restrictions.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, only
+ *                              the transient key zero is supported
+ * @param[in] auth_size         size of the data buffer to be authenticated
+ * @param[in] auth_in           buffer containing the data to be authenticated
+ * @param[in] text_size         size of the text buffer
+ * @param[in] text_in           buffer containing the input plaintext
+ * @param[out] text_out         buffer for the output ciphertext
+ * @param[in] iv                128 bits initial counter block
+ * @param[in] tag_size          size of the authentication tag, this number
+ *                              must be between 1 and 16
+ * @param[out] tag_out          buffer for the generated authentication tag
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_ALGO     if the tag size is not between 1 and 16.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_AES_GCM(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t auth_size,
+                                        const uint8_t *auth_in,
+                                        size_t text_size,
+                                        const uint8_t *text_in,
+                                        uint8_t *text_out,
+                                        const uint8_t *iv,
+                                        size_t tag_size,
+                                        uint8_t *tag_out) {
+  uint8_t y[16], cb[16];
+
+  (void)cryp;
+
+  if ((tag_size == 0U) || (tag_size > sizeof y)) {
+    return CRY_ERR_INV_ALGO;
+  }
+
+  if ((key_id != (crykey_t)0) || (aes_key.rounds == 0U)) {
+    return CRY_ERR_INV_KEY_ID;
+  }
+
+  memset(y, 0, sizeof y);
+  gcm_ghash(y, auth_in, auth_size);
+
+  memcpy(cb, iv, 16U);
+  ctr_increment(cb);
+  aes_ctr(cb, text_size, text_in, text_out);
+  gcm_ghash(y, text_out, text_size);
+
+  gcm_final(y, auth_size, text_size, iv);
+  memcpy(tag_out, y, tag_size);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Decryption operation using AES-GCM.
+ * @note    This is a stream cipher, there are no size restrictions.
+ * @note    The output buffer is cleared if the authentication fails.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, only
+ *                              the transient key zero is supported
+ * @param[in] auth_size         size of the data buffer to be authenticated
+ * @param[in] auth_in           buffer containing the data to be authenticated
+ * @param[in] text_size         size of the text buffer
+ * @param[in] text_in           buffer containing the input ciphertext
+ * @param[out] text_out         buffer for the output plaintext
+ * @param[in] iv                128 bits initial counter block
+ * @param[in] tag_size          size of the authentication tag, this number
+ *                              must be between 1 and 16
+ * @param[in] tag_in            buffer containing the authentication tag
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_ALGO     if the tag size is not between 1 and 16.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ * @retval CRY_ERR_AUTH_FAILED  authentication failed
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_AES_GCM(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t auth_size,
+                                        const uint8_t *auth_in,
+                                        size_t text_size,
+                                        const uint8_t *text_in,
+                                        uint8_t *text_out,
+                                        const uint8_t *iv,
+                                        size_t tag_size,
+                                        const uint8_t *tag_in) {
+  uint8_t y[16], cb[16], diff;
+  size_t i;
+
+  (void)cryp;
+
+  if ((tag_size == 0U) || (tag_size > sizeof y)) {
+    return CRY_ERR_INV_ALGO;
+  }
+
+  if ((key_id != (crykey_t)0) || (aes_key.rounds == 0U)) {
+    return CRY_ERR_INV_KEY_ID;
+  }
+
+  /* The ciphertext is hashed before being decrypted because the buffers
+     could overlap.*/
+  memset(y, 0, sizeof y);
+  gcm_ghash(y, auth_in, auth_size);
+  gcm_ghash(y, text_in, text_size);
+
+  memcpy(cb, iv, 16U);
+  ctr_increment(cb);
+  aes_ctr(cb, text_size, text_in, text_out);
+
+  gcm_final(y, auth_size, text_size, iv);
+
+  /* Constant time tag comparison.*/
+  diff = 0U;
+  for (i = 0U; i < tag_size; i++) {
+    diff |= y[i] ^ tag_in[i];
+  }
+  if (diff != 0U) {
+    memset(text_out, 0, text_size);
+    return CRY_ERR_AUTH_FAILED;
+  }
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Initializes the DES transient key.
+ * @note    A 8 bytes key selects DES, 16 bytes keys select two keys TDES,
+ *          24 bytes keys select three keys TDES.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] size              key size in bytes
+ * @param[in] keyp              pointer to the key data
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_SIZE if the specified key size is invalid.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_des_loadkey(CRYDriver *cryp,
+                                    size_t size,
+                                    const uint8_t *keyp) {
+
+  (void)cryp;
+
+  if (size == 8U) {
+    des_expand_key(keyp, des_key.ek[0], des_key.dk[0]);
+    des_key.nkeys = 1U;
+  }
+  else if ((size == 16U) || (size == 24U)) {
+    des_expand_key(keyp, des_key.ek[0], des_key.dk[0]);
+    des_expand_key(keyp + 8, des_key.ek[1], des_key.dk[1]);
+    des_expand_key(size == 24U ? keyp + 16 : keyp,
+                   des_key.ek[2], des_key.dk[2]);
+    des_key.nkeys = 3U;
+  }
+  else {
+    return CRY_ERR_INV_KEY_SIZE;
+  }
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Encryption of a single block using (T)DES.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, only
+ *                              the transient key zero is supported
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output ciphertext
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_DES(CRYDriver *cryp,
+                                    crykey_t key_id,
+                                    const uint8_t *in,
+                                    uint8_t *out) {
+
+  (void)cryp;
+
+  if ((key_id != (crykey_t)0) || (des_key.nkeys == 0U)) {
+    return CRY_ERR_INV_KEY_ID;
+  }
+
+  des_encrypt_block(in, out);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Decryption of a single block using (T)DES.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, only
+ *                              the transient key zero is supported
+ * @param[in] in                buffer containing the input ciphertext
+ * @param[out] out              buffer for the output plaintext
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_DES(CRYDriver *cryp,
+                                    crykey_t key_id,
+                                    const uint8_t *in,
+                                    uint8_t *out) {
+
+  (void)cryp;
+
+  if ((key_id != (crykey_t)0) || (des_key.nkeys == 0U)) {
+    return CRY_ERR_INV_KEY_ID;
+  }
+
+  des_decrypt_block(in, out);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Encryption operation using (T)DES-ECB.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, only
+ *                              the transient key zero is supported
+ * @param[in] size              size of both buffers, this number must be a
+ *                              multiple of 8
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output ciphertext
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_DES_ECB(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out) {
+
+  (void)cryp;
+
+  if ((key_id != (crykey_t)0) || (des_key.nkeys == 0U)) {
+    return CRY_ERR_INV_KEY_ID;
+  }
+
+  while (size >= 8U) {
+    des_encrypt_block(in, out);
+    in   += 8;
+    out  += 8;
+    size -= 8U;
+  }
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Decryption operation using (T)DES-ECB.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, only
+ *                              the transient key zero is supported
+ * @param[in] size              size of both buffers, this number must be a
+ *                              multiple of 8
+ * @param[in] in                buffer containing the input ciphertext
+ * @param[out] out              buffer for the output plaintext
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_DES_ECB(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out) {
+
+  (void)cryp;
+
+  if ((key_id != (crykey_t)0) || (des_key.nkeys == 0U)) {
+    return CRY_ERR_INV_KEY_ID;
+  }
+
+  while (size >= 8U) {
+    des_decrypt_block(in, out);
+    in   += 8;
+    out  += 8;
+    size -= 8U;
+  }
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Encryption operation using (T)DES-CBC.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, only
+ *                              the transient key zero is supported
+ * @param[in] size              size of both buffers, this number must be a
+ *                              multiple of 8
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output ciphertext
+ * @param[in] iv                64 bits input vector
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_DES_CBC(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out,
+                                        const uint8_t *iv) {
+  const uint8_t *chain = iv;
+
+  (void)cryp;
+
+  if ((key_id != (crykey_t)0) || (des_key.nkeys == 0U)) {
+    return CRY_ERR_INV_KEY_ID;
+  }
+
+  while (size >= 8U) {
+    unsigned i;
+
+    for (i = 0U; i < 8U; i++) {
+      out[i] = in[i] ^ chain[i];
+    }
+    des_encrypt_block(out, out);
+    chain = out;
+    in   += 8;
+    out  += 8;
+    size -= 8U;
+  }
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Decryption operation using (T)DES-CBC.
+ * @note    The buffers can overlap exactly, in-place operations are
+ *          supported.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, only
+ *                              the transient key zero is supported
+ * @param[in] size              size of both buffers, this number must be a
+ *                              multiple of 8
+ * @param[in] in                buffer containing the input ciphertext
+ * @param[out] out              buffer for the output plaintext
+ * @param[in] iv                64 bits input vector
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_DES_CBC(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out,
+                                        const uint8_t *iv) {
+  uint8_t chain[8], next[8];
+
+  (void)cryp;
+
+  if ((key_id != (crykey_t)0) || (des_key.nkeys == 0U)) {
+    return CRY_ERR_INV_KEY_ID;
+  }
+
+  memcpy(chain, iv, 8U);
+  while (size >= 8U) {
+    unsigned i;
+
+    memcpy(next, in, 8U);
+    des_decrypt_block(in, out);
+    for (i = 0U; i < 8U; i++) {
+      out[i] ^= chain[i];
+    }
+    memcpy(chain, next, 8U);
+    in   += 8;
+    out  += 8;
+    size -= 8U;
+  }
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash initialization using SHA1.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[out] sha1ctxp         pointer to a SHA1 context to be initialized
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA1_init(CRYDriver *cryp, SHA1Context *sha1ctxp) {
+
+  (void)cryp;
+
+  memcpy(sha1ctxp->sha.h, sha1_h0, sizeof sha1ctxp->sha.h);
+  sha1ctxp->sha.length = 0U;
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash update using SHA1.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] sha1ctxp          pointer to a SHA1 context
+ * @param[in] size              size of input buffer
+ * @param[in] in                buffer containing the input text
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA1_update(CRYDriver *cryp, SHA1Context *sha1ctxp,
+                                    size_t size, const uint8_t *in) {
+
+  (void)cryp;
+
+  sha32_update(sha1ctxp->sha.h, &sha1ctxp->sha.length, sha1ctxp->sha.buffer,
+               sha1_compress, size, in);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash finalization using SHA1.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] sha1ctxp          pointer to a SHA1 context
+ * @param[out] out              160 bits output buffer
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA1_final(CRYDriver *cryp, SHA1Context *sha1ctxp,
+                                   uint8_t *out) {
+  unsigned i;
+
+  (void)cryp;
+
+  sha32_final(sha1ctxp->sha.h, sha1ctxp->sha.length, sha1ctxp->sha.buffer,
+              sha1_compress);
+  for (i = 0U; i < 5U; i++) {
+    PUT_U32_BE(out + (i * 4U), sha1ctxp->sha.h[i]);
+  }
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash initialization using SHA256.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[out] sha256ctxp       pointer to a SHA256 context to be initialized
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA256_init(CRYDriver *cryp,
+                                    SHA256Context *sha256ctxp) {
+
+  (void)cryp;
+
+  sha256_start(&sha256ctxp->sha);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash update using SHA256.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] sha256ctxp        pointer to a SHA256 context
+ * @param[in] size              size of input buffer
+ * @param[in] in                buffer containing the input text
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA256_update(CRYDriver *cryp,
+                                      SHA256Context *sha256ctxp,
+                                      size_t size, const uint8_t *in) {
+
+  (void)cryp;
+
+  sha32_update(sha256ctxp->sha.h, &sha256ctxp->sha.length,
+               sha256ctxp->sha.buffer, sha256_compress, size, in);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash finalization using SHA256.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] sha256ctxp        pointer to a SHA256 context
+ * @param[out] out              256 bits output buffer
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA256_final(CRYDriver *cryp,
+                                     SHA256Context *sha256ctxp,
+                                     uint8_t *out) {
+
+  (void)cryp;
+
+  sha256_digest(&sha256ctxp->sha, out);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash initialization using SHA512.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[out] sha512ctxp       pointer to a SHA512 context to be initialized
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA512_init(CRYDriver *cryp,
+                                    SHA512Context *sha512ctxp) {
+
+  (void)cryp;
+
+  sha512_start(&sha512ctxp->sha);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash update using SHA512.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] sha512ctxp        pointer to a SHA512 context
+ * @param[in] size              size of input buffer
+ * @param[in] in                buffer containing the input text
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA512_update(CRYDriver *cryp,
+                                      SHA512Context *sha512ctxp,
+                                      size_t size, const uint8_t *in) {
+
+  (void)cryp;
+
+  sha512_update(&sha512ctxp->sha, size, in);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash finalization using SHA512.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] sha512ctxp        pointer to a SHA512 context
+ * @param[out] out              512 bits output buffer
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA512_final(CRYDriver *cryp,
+                                     SHA512Context *sha512ctxp,
+                                     uint8_t *out) {
+
+  (void)cryp;
+
+  sha512_final(&sha512ctxp->sha, out);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Initializes the HMAC transient key.
+ * @details The key is absorbed in the inner and outer pad blocks of both
+ *          SHA256 and SHA512 so that each message only costs the hashing
+ *          of the message itself and of the inner digest.
+ * @note    Keys longer than the hash block size are hashed as required
+ *          by the HMAC specification.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] size              key size in bytes
+ * @param[in] keyp              pointer to the key data
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_hmac_loadkey(CRYDriver *cryp,
+                                     size_t size,
+                                     const uint8_t *keyp) {
+  uint8_t pad[CRY_FALLBACK_SHA512_BLOCK_SIZE];
+  union {
+    crysha256state_t        s256;
+    crysha512state_t        s512;
+  } u;
+  unsigned i;
+
+  (void)cryp;
+
+  /* SHA256 pads.*/
+  memset(pad, 0, CRY_FALLBACK_SHA256_BLOCK_SIZE);
+  if (size > CRY_FALLBACK_SHA256_BLOCK_SIZE) {
+    sha256_start(&u.s256);
+    sha32_update(u.s256.h, &u.s256.length, u.s256.buffer, sha256_compress,
+                 size, keyp);
+    sha256_digest(&u.s256, pad);
+  }
+  else {
+    memcpy(pad, keyp, size);
+  }
+  for (i = 0U; i < CRY_FALLBACK_SHA256_BLOCK_SIZE; i++) {
+    pad[i] ^= 0x36U;
+  }
+  memcpy(hmac_key.inner256, sha256_h0, sizeof hmac_key.inner256);
+  sha256_compress(hmac_key.inner256, pad, 1U);
+  for (i = 0U; i < CRY_FALLBACK_SHA256_BLOCK_SIZE; i++) {
+    pad[i] ^= 0x36U ^ 0x5CU;
+  }
+  memcpy(hmac_key.outer256, sha256_h0, sizeof hmac_key.outer256);
+  sha256_compress(hmac_key.outer256, pad, 1U);
+
+  /* SHA512 pads.*/
+  memset(pad, 0, CRY_FALLBACK_SHA512_BLOCK_SIZE);
+  if (size > CRY_FALLBACK_SHA512_BLOCK_SIZE) {
+    sha512_start(&u.s512);
+    sha512_update(&u.s512, size, keyp);
+    sha512_final(&u.s512, pad);
+  }
+  else {
+    memcpy(pad, keyp, size);
+  }
+  for (i = 0U; i < CRY_FALLBACK_SHA512_BLOCK_SIZE; i++) {
+    pad[i] ^= 0x36U;
+  }
+  memcpy(hmac_key.inner512, sha512_h0, sizeof hmac_key.inner512);
+  sha512_compress(hmac_key.inner512, pad, 1U);
+  for (i = 0U; i < CRY_FALLBACK_SHA512_BLOCK_SIZE; i++) {
+    pad[i] ^= 0x36U ^ 0x5CU;
+  }
+  memcpy(hmac_key.outer512, sha512_h0, sizeof hmac_key.outer512);
+  sha512_compress(hmac_key.outer512, pad, 1U);
+
+  /* Not leaving key material on the stack.*/
+  memset(pad, 0, sizeof pad);
+  memset(&u, 0, sizeof u);
+
+  hmac_key.loaded = true;
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash initialization using HMAC_SHA256.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[out] hmacsha256ctxp   pointer to a HMAC_SHA256 context to be
+ *                              initialized
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_OP_FAILURE   if a key has not been loaded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_HMACSHA256_init(CRYDriver *cryp,
+                                        HMACSHA256Context *hmacsha256ctxp) {
+
+  (void)cryp;
+
+  if (!hmac_key.loaded) {
+    return CRY_ERR_OP_FAILURE;
+  }
+
+  memcpy(hmacsha256ctxp->sha.h, hmac_key.inner256,
+         sizeof hmacsha256ctxp->sha.h);
+  hmacsha256ctxp->sha.length = (uint64_t)CRY_FALLBACK_SHA256_BLOCK_SIZE;
+  memcpy(hmacsha256ctxp->outer, hmac_key.outer256,
+         sizeof hmacsha256ctxp->outer);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash update using HMAC.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] hmacsha256ctxp    pointer to a HMAC_SHA256 context
+ * @param[in] size              size of input buffer
+ * @param[in] in                buffer containing the input text
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_HMACSHA256_update(CRYDriver *cryp,
+                                          HMACSHA256Context *hmacsha256ctxp,
+                                          size_t size,
+                                          const uint8_t *in) {
+
+  (void)cryp;
+
+  sha32_update(hmacsha256ctxp->sha.h, &hmacsha256ctxp->sha.length,
+               hmacsha256ctxp->sha.buffer, sha256_compress, size, in);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash finalization using HMAC.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] hmacsha256ctxp    pointer to a HMAC_SHA256 context
+ * @param[out] out              256 bits output buffer
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_HMACSHA256_final(CRYDriver *cryp,
+                                         HMACSHA256Context *hmacsha256ctxp,
+                                         uint8_t *out) {
+  crysha256state_t *sp = &hmacsha256ctxp->sha;
+  uint8_t digest[32];
+
+  (void)cryp;
+
+  sha256_digest(sp, digest);
+
+  /* Outer hash, the outer pad block has already been hashed.*/
+  memcpy(sp->h, hmacsha256ctxp->outer, sizeof sp->h);
+  sp->length = (uint64_t)CRY_FALLBACK_SHA256_BLOCK_SIZE;
+  sha32_update(sp->h, &sp->length, sp->buffer, sha256_compress,
+               sizeof digest, digest);
+  sha256_digest(sp, out);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash initialization using HMAC_SHA512.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[out] hmacsha512ctxp   pointer to a HMAC_SHA512 context to be
+ *                              initialized
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_OP_FAILURE   if a key has not been loaded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_HMACSHA512_init(CRYDriver *cryp,
+                                        HMACSHA512Context *hmacsha512ctxp) {
+
+  (void)cryp;
+
+  if (!hmac_key.loaded) {
+    return CRY_ERR_OP_FAILURE;
+  }
+
+  memcpy(hmacsha512ctxp->sha.h, hmac_key.inner512,
+         sizeof hmacsha512ctxp->sha.h);
+  hmacsha512ctxp->sha.length = (uint64_t)CRY_FALLBACK_SHA512_BLOCK_SIZE;
+  memcpy(hmacsha512ctxp->outer, hmac_key.outer512,
+         sizeof hmacsha512ctxp->outer);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash update using HMAC.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] hmacsha512ctxp    pointer to a HMAC_SHA512 context
+ * @param[in] size              size of input buffer
+ * @param[in] in                buffer containing the input text
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_HMACSHA512_update(CRYDriver *cryp,
+                                          HMACSHA512Context *hmacsha512ctxp,
+                                          size_t size,
+                                          const uint8_t *in) {
+
+  (void)cryp;
+
+  sha512_update(&hmacsha512ctxp->sha, size, in);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash finalization using HMAC.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] hmacsha512ctxp    pointer to a HMAC_SHA512 context
+ * @param[out] out              512 bits output buffer
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_HMACSHA512_final(CRYDriver *cryp,
+                                         HMACSHA512Context *hmacsha512ctxp,
+                                         uint8_t *out) {
+  crysha512state_t *sp = &hmacsha512ctxp->sha;
+  uint8_t digest[64];
+
+  (void)cryp;
+
+  sha512_final(sp, digest);
+
+  /* Outer hash, the outer pad block has already been hashed.*/
+  memcpy(sp->h, hmacsha512ctxp->outer, sizeof sp->h);
+  sp->length = (uint64_t)CRY_FALLBACK_SHA512_BLOCK_SIZE;
+  sha512_update(sp, sizeof digest, digest);
+  sha512_final(sp, out);
+
+  return CRY_NOERROR;
+}
+
+#endif /* (HAL_USE_CRY == TRUE) && (HAL_CRY_USE_FALLBACK == TRUE) */
+
+/** @} */
@@ -178,7 +178,7 @@ void *flashGetOffsetAddress(BaseFlash *devp, flash_offset_t offset) {
 
   osalDbgAssert(offset < descriptor->size, "invalid offset");
 
-  return (void *)((flash_offset_t)descriptor->address + offset);
+  return (void *)((uintptr_t)descriptor->address + offset);
 }
 
 /**
@@ -193,12 +193,12 @@ void *flashGetOffsetAddress(BaseFlash *devp, flash_offset_t offset) {
 flash_offset_t flashGetAddressOffset(BaseFlash *devp, void *addr) {
   const flash_descriptor_t *descriptor = flashGetDescriptor(devp);
 
-  osalDbgAssert(((flash_offset_t)addr >= (flash_offset_t)descriptor->address) &&
-                ((flash_offset_t)addr <= (flash_offset_t)descriptor->address +
-                                         descriptor->size),
+  osalDbgAssert(((uintptr_t)addr >= (uintptr_t)descriptor->address) &&
+                ((uintptr_t)addr <= (uintptr_t)descriptor->address +
+                                    descriptor->size),
                 "invalid address");
 
-  return (flash_offset_t)addr - (flash_offset_t)descriptor->address;
+  return (flash_offset_t)((uintptr_t)addr - (uintptr_t)descriptor->address);
 }
 
 /** @} */
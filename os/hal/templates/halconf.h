@@ -318,9 +318,12 @@
 
 /**
  * @brief   Enables the zero-copy API.
+ * @note    Buffers obtained through the zero-copy API are owned by the
+ *          application until released, on MACs with a ring of receive
+ *          descriptors a buffer held for long stops the reception.
  */
 #if !defined(MAC_USE_ZERO_COPY) || defined(__DOXYGEN__)
-#define MAC_USE_ZERO_COPY                   TRUE
+#define MAC_USE_ZERO_COPY                   FALSE
 #endif
 
 /**
@@ -198,6 +198,12 @@
 #error "CH_CFG_AUTOSTART_THREADS not defined in chconf.h"
 #endif
 
+/* Options added after the configuration file version 4.0, defaulted if not
+   specified.*/
+#if !defined(CH_CFG_USE_FAST_SCHEDULER) || defined(__DOXYGEN__)
+#define CH_CFG_USE_FAST_SCHEDULER           FALSE
+#endif
+
 #if !defined(CH_CFG_ST_RESOLUTION) || defined(__DOXYGEN__)
 #error "CH_CFG_ST_RESOLUTION not defined in chconf.h"
 #endif
@@ -331,9 +337,13 @@
 #error "at least one thread must be defined"
 #endif
 
-#if CH_CFG_MAX_THREADS > 16
+#if (CH_CFG_USE_FAST_SCHEDULER == FALSE) && (CH_CFG_MAX_THREADS > 16)
 #error "ChibiOS/NIL is not recommended for thread-intensive applications,"  \
-       "consider ChibiOS/RT instead"
+       "consider ChibiOS/RT or CH_CFG_USE_FAST_SCHEDULER instead"
+#endif
+
+#if (CH_CFG_USE_FAST_SCHEDULER == TRUE) && (CH_CFG_MAX_THREADS > 32)
+#error "CH_CFG_USE_FAST_SCHEDULER allows up to 32 threads"
 #endif
 
 #if (CH_CFG_ST_RESOLUTION != 16) && (CH_CFG_ST_RESOLUTION != 32)
@@ -538,8 +548,17 @@ struct nil_thread {
     eventmask_t         ewmask;     /**< @brief Enabled events mask.        */
 #endif
   } u1;
+#if (CH_CFG_USE_FAST_SCHEDULER == FALSE) || defined(__DOXYGEN__)
   volatile sysinterval_t timeout;   /**< @brief Timeout counter, zero
                                                 if disabled.                */
+#endif
+#if (CH_CFG_USE_FAST_SCHEDULER == TRUE) || defined(__DOXYGEN__)
+  systime_t             wakeup;     /**< @brief Timeout deadline.           */
+  ucnt_t                tmidx;      /**< @brief Position in the timeouts
+                                                heap plus one, zero if
+                                                not waiting with a
+                                                timeout.                    */
+#endif
 #if (CH_CFG_USE_EVENTS == TRUE) || defined(__DOXYGEN__)
   eventmask_t           epmask;     /**< @brief Pending events mask.        */
 #endif
@@ -585,6 +604,24 @@ struct nil_os_instance {
    */
   systime_t             nexttime;
 #endif
+#if (CH_CFG_USE_FAST_SCHEDULER == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Ready threads bitmap.
+   * @note    The idle thread is not included, the thread with priority
+   *          zero is the most significant bit so the next thread is found
+   *          by counting the leading zeros.
+   */
+  uint32_t              readymap;
+  /**
+   * @brief   Number of threads in the timeouts heap.
+   */
+  ucnt_t                tmcnt;
+  /**
+   * @brief   Heap of the threads waiting with a timeout.
+   * @note    The thread with the nearest deadline is on top.
+   */
+  thread_t              *tmheap[CH_CFG_MAX_THREADS];
+#endif
 #if (CH_DBG_SYSTEM_STATE_CHECK == TRUE) || defined(__DOXYGEN__)
   /**
    * @brief   ISR nesting level.
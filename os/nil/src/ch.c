@@ -31,6 +31,41 @@
 /* Module local definitions.                                                 */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_FAST_SCHEDULER == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Bit of a thread in the ready threads bitmap.
+ */
+#define NIL_READY_BIT(tp)                                                   \
+  ((uint32_t)0x80000000U >> (uint32_t)((tp) - nil.threads))
+
+/**
+ * @brief   Mask of the user threads in the ready threads bitmap.
+ */
+#define NIL_THREADS_MASK                                                    \
+  ((uint32_t)0xFFFFFFFFU << (32U - (uint32_t)CH_CFG_MAX_THREADS))
+
+/**
+ * @brief   Key of a thread in the timeouts heap.
+ * @note    Deadlines are compared as intervals from the time of the last
+ *          processed tick event so the counter wrapping is handled.
+ */
+#if (CH_CFG_ST_TIMEDELTA == 0) || defined(__DOXYGEN__)
+#define NIL_TM_KEY(tp)      chTimeDiffX(nil.systime, (tp)->wakeup)
+#else
+#define NIL_TM_KEY(tp)      chTimeDiffX(nil.lasttime, (tp)->wakeup)
+#endif
+
+/**
+ * @brief   Number of leading zeros of a non-zero 32 bits word.
+ * @note    A port can provide an optimized @p port_clz32() macro.
+ */
+#if defined(port_clz32) || defined(__DOXYGEN__)
+#define nil_clz32(x)        port_clz32(x)
+#elif defined(__GNUC__) && (__SIZEOF_INT__ == 4)
+#define nil_clz32(x)        ((unsigned)__builtin_clz(x))
+#endif
+#endif /* CH_CFG_USE_FAST_SCHEDULER == TRUE */
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -48,6 +83,137 @@ os_instance_t nil;
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_FAST_SCHEDULER == TRUE) || defined(__DOXYGEN__)
+#if !defined(nil_clz32)
+static unsigned nil_clz32(uint32_t x) {
+  unsigned n = 0U;
+
+  if ((x & 0xFFFF0000U) == 0U) {
+    n += 16U;
+    x <<= 16;
+  }
+  if ((x & 0xFF000000U) == 0U) {
+    n += 8U;
+    x <<= 8;
+  }
+  if ((x & 0xF0000000U) == 0U) {
+    n += 4U;
+    x <<= 4;
+  }
+  if ((x & 0xC0000000U) == 0U) {
+    n += 2U;
+    x <<= 2;
+  }
+  if ((x & 0x80000000U) == 0U) {
+    n += 1U;
+  }
+
+  return n;
+}
+#endif
+
+/**
+ * @brief   Stores a thread in a position of the timeouts heap.
+ *
+ * @param[in] tp        pointer to the thread
+ * @param[in] i         heap position
+ */
+static void nil_tm_place(thread_t *tp, ucnt_t i) {
+
+  nil.tmheap[i] = tp;
+  tp->tmidx = i + (ucnt_t)1;
+}
+
+/**
+ * @brief   Moves a thread toward the top of the timeouts heap.
+ *
+ * @param[in] tp        pointer to the thread
+ * @param[in] i         initial heap position
+ */
+static void nil_tm_up(thread_t *tp, ucnt_t i) {
+  sysinterval_t key = NIL_TM_KEY(tp);
+
+  while (i > (ucnt_t)0) {
+    ucnt_t parent = (i - (ucnt_t)1) / (ucnt_t)2;
+
+    if (NIL_TM_KEY(nil.tmheap[parent]) <= key) {
+      break;
+    }
+    nil_tm_place(nil.tmheap[parent], i);
+    i = parent;
+  }
+  nil_tm_place(tp, i);
+}
+
+/**
+ * @brief   Moves a thread toward the bottom of the timeouts heap.
+ *
+ * @param[in] tp        pointer to the thread
+ * @param[in] i         initial heap position
+ */
+static void nil_tm_down(thread_t *tp, ucnt_t i) {
+  sysinterval_t key = NIL_TM_KEY(tp);
+
+  while (true) {
+    ucnt_t child = (i * (ucnt_t)2) + (ucnt_t)1;
+
+    if (child >= nil.tmcnt) {
+      break;
+    }
+    if ((child + (ucnt_t)1 < nil.tmcnt) &&
+        (NIL_TM_KEY(nil.tmheap[child + (ucnt_t)1]) <
+         NIL_TM_KEY(nil.tmheap[child]))) {
+      child++;
+    }
+    if (key <= NIL_TM_KEY(nil.tmheap[child])) {
+      break;
+    }
+    nil_tm_place(nil.tmheap[child], i);
+    i = child;
+  }
+  nil_tm_place(tp, i);
+}
+
+/**
+ * @brief   Inserts a thread in the timeouts heap.
+ *
+ * @param[in] tp        pointer to the thread
+ * @param[in] wakeup    deadline of the timeout
+ */
+static void nil_tm_insert(thread_t *tp, systime_t wakeup) {
+
+  tp->wakeup = wakeup;
+  nil.tmcnt++;
+  nil_tm_up(tp, nil.tmcnt - (ucnt_t)1);
+}
+
+/**
+ * @brief   Removes a thread from the timeouts heap.
+ *
+ * @param[in] tp        pointer to the thread
+ */
+static void nil_tm_remove(thread_t *tp) {
+  ucnt_t i = tp->tmidx - (ucnt_t)1;
+
+  tp->tmidx = (ucnt_t)0;
+  nil.tmcnt--;
+
+  /* The last element fills the hole.*/
+  if (i < nil.tmcnt) {
+    thread_t *ltp = nil.tmheap[nil.tmcnt];
+
+    if ((i > (ucnt_t)0) &&
+        (NIL_TM_KEY(ltp) <
+         NIL_TM_KEY(nil.tmheap[(i - (ucnt_t)1) / (ucnt_t)2]))) {
+      nil_tm_up(ltp, i);
+    }
+    else {
+      nil_tm_down(ltp, i);
+    }
+  }
+}
+#endif /* CH_CFG_USE_FAST_SCHEDULER == TRUE */
+
 /*===========================================================================*/
 /* Module interrupt handlers.                                                */
 /*===========================================================================*/
@@ -68,6 +234,20 @@ os_instance_t nil;
  * @notapi
  */
 thread_t *nil_find_thread(tstate_t state, void *p) {
+#if CH_CFG_USE_FAST_SCHEDULER == TRUE
+  /* Only the threads not in the ready bitmap are scanned.*/
+  uint32_t map = ~nil.readymap & NIL_THREADS_MASK;
+
+  while (map != 0U) {
+    thread_t *tp = &nil.threads[nil_clz32(map)];
+
+    /* Is this thread matching?*/
+    if ((tp->state == state) && (tp->u1.p == p)) {
+      return tp;
+    }
+    map &= ~NIL_READY_BIT(tp);
+  }
+#else
   thread_t *tp = nil.threads;
 
   while (tp < &nil.threads[CH_CFG_MAX_THREADS]) {
@@ -77,6 +257,7 @@ thread_t *nil_find_thread(tstate_t state, void *p) {
     }
     tp++;
   }
+#endif
   return NULL;
 }
 
@@ -93,6 +274,25 @@ thread_t *nil_find_thread(tstate_t state, void *p) {
  * @notapi
  */
 cnt_t nil_ready_all(void *p, cnt_t cnt, msg_t msg) {
+#if CH_CFG_USE_FAST_SCHEDULER == TRUE
+  /* Only the threads not in the ready bitmap are scanned.*/
+  uint32_t map = ~nil.readymap & NIL_THREADS_MASK;
+
+  while (cnt < (cnt_t)0) {
+    thread_t *tp;
+
+    chDbgAssert(map != 0U, "thread not found");
+
+    tp = &nil.threads[nil_clz32(map)];
+    map &= ~NIL_READY_BIT(tp);
+
+    /* Is this thread waiting on this queue?*/
+    if ((tp->state == NIL_STATE_WTQUEUE) && (tp->u1.p == p)) {
+      cnt++;
+      (void) chSchReadyI(tp, msg);
+    }
+  }
+#else
   thread_t *tp = nil.threads;;
 
   while (cnt < (cnt_t)0) {
@@ -107,6 +307,7 @@ cnt_t nil_ready_all(void *p, cnt_t cnt, msg_t msg) {
     }
     tp++;
   }
+#endif
 
   return cnt;
 }
@@ -356,7 +557,57 @@ void chSysTimerHandlerI(void) {
 
   chDbgCheckClassI();
 
+#if CH_CFG_USE_FAST_SCHEDULER == TRUE
 #if CH_CFG_ST_TIMEDELTA == 0
+  /* Deadlines are relative to the system time, expired ones are zero.*/
+  sysinterval_t elapsed = (sysinterval_t)0;
+  nil.systime++;
+#else
+  /* Deadlines are relative to the last tick event.*/
+  sysinterval_t elapsed = chTimeDiffX(nil.lasttime, nil.nexttime);
+
+  chDbgAssert(nil.nexttime == port_timer_get_alarm(), "time mismatch");
+#endif
+
+  /* Only the expired threads on top of the heap are processed.*/
+  while ((nil.tmcnt > (ucnt_t)0) &&
+         (NIL_TM_KEY(nil.tmheap[0]) <= elapsed)) {
+    thread_t *tp = nil.tmheap[0];
+
+    chDbgAssert(!NIL_THD_IS_READY(tp), "is ready");
+
+    /* Timeout on thread queues requires a special handling because the
+       counter must be incremented.*/
+    if (NIL_THD_IS_WTQUEUE(tp)) {
+      tp->u1.tqp->cnt++;
+    }
+    else {
+      if (NIL_THD_IS_SUSPENDED(tp)) {
+        *tp->u1.trp = NULL;
+      }
+    }
+
+    /* The thread is also removed from the heap.*/
+    (void) chSchReadyI(tp, MSG_TIMEOUT);
+
+    /* Lock released in order to give a preemption chance on those
+       architectures supporting IRQ preemption.*/
+    chSysUnlockFromISR();
+    chSysLockFromISR();
+  }
+
+#if CH_CFG_ST_TIMEDELTA > 0
+  nil.lasttime = nil.nexttime;
+  if (nil.tmcnt > (ucnt_t)0) {
+    nil.nexttime = nil.tmheap[0]->wakeup;
+    port_timer_set_alarm(nil.nexttime);
+  }
+  else {
+    /* No tick event needed.*/
+    port_timer_stop_alarm();
+  }
+#endif
+#elif CH_CFG_ST_TIMEDELTA == 0
   thread_t *tp = &nil.threads[0];
   nil.systime++;
   do {
@@ -587,7 +838,14 @@ thread_t *chSchReadyI(thread_t *tp, msg_t msg) {
 
   tp->u1.msg = msg;
   tp->state = NIL_STATE_READY;
+#if CH_CFG_USE_FAST_SCHEDULER == TRUE
+  if (tp->tmidx > (ucnt_t)0) {
+    nil_tm_remove(tp);
+  }
+  nil.readymap |= NIL_READY_BIT(tp);
+#else
   tp->timeout = (sysinterval_t)0;
+#endif
   if (tp < nil.next) {
     nil.next = tp;
   }
@@ -670,6 +928,9 @@ msg_t chSchGoSleepTimeoutS(tstate_t newstate, sysinterval_t timeout) {
 
   /* Storing the wait object for the current thread.*/
   otp->state = newstate;
+#if CH_CFG_USE_FAST_SCHEDULER == TRUE
+  nil.readymap &= ~NIL_READY_BIT(otp);
+#endif
 
 #if CH_CFG_ST_TIMEDELTA > 0
   if (timeout != TIME_INFINITE) {
@@ -699,14 +960,39 @@ msg_t chSchGoSleepTimeoutS(tstate_t newstate, sysinterval_t timeout) {
     }
 
     /* Timeout settings.*/
+#if CH_CFG_USE_FAST_SCHEDULER == TRUE
+    nil_tm_insert(otp, abstime);
+#else
     otp->timeout = abstime - nil.lasttime;
+#endif
   }
 #else
 
   /* Timeout settings.*/
+#if CH_CFG_USE_FAST_SCHEDULER == TRUE
+  if (timeout != TIME_INFINITE) {
+    nil_tm_insert(otp, chTimeAddX(nil.systime, timeout));
+  }
+#else
   otp->timeout = timeout;
 #endif
+#endif
 
+#if CH_CFG_USE_FAST_SCHEDULER == TRUE
+  /* The highest priority ready thread is the first bit set, the idle
+     thread if none.*/
+  if (nil.readymap != 0U) {
+    ntp = &nil.threads[nil_clz32(nil.readymap)];
+    nil.current = nil.next = ntp;
+  }
+  else {
+    ntp = &nil.threads[CH_CFG_MAX_THREADS];
+    nil.current = nil.next = ntp;
+    CH_CFG_IDLE_ENTER_HOOK();
+  }
+  port_switch(ntp, otp);
+  return nil.current->u1.msg;
+#else
   /* Scanning the whole threads array.*/
   ntp = nil.threads;
   while (true) {
@@ -725,6 +1011,7 @@ msg_t chSchGoSleepTimeoutS(tstate_t newstate, sysinterval_t timeout) {
     chDbgAssert(ntp <= &nil.threads[CH_CFG_MAX_THREADS],
                 "pointer out of range");
   }
+#endif
 }
 
 /**
@@ -58,6 +58,19 @@
 #define CH_CFG_AUTOSTART_THREADS            TRUE
 #endif
 
+/**
+ * @brief   Scalable scheduler.
+ * @details If enabled then the ready threads are tracked in a bitmap and
+ *          the threads waiting with a timeout are kept in a heap ordered
+ *          by deadline, the cost of threads selection and of the tick
+ *          processing no more depends on the number of threads.
+ * @note    Up to 32 threads are allowed when enabled.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_FAST_SCHEDULER)
+#define CH_CFG_USE_FAST_SCHEDULER           FALSE
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -249,6 +262,17 @@
 #define CH_CFG_USE_OBJ_FIFOS                TRUE
 #endif
 
+/**
+ * @brief   Lock-free rings APIs.
+ * @details If enabled then the lock-free SPSC/MPSC rings APIs are included
+ *          in the kernel.
+ *
+ * @note    The default is @p TRUE.
+ */
+#if !defined(CH_CFG_USE_RINGS)
+#define CH_CFG_USE_RINGS                    TRUE
+#endif
+
 /**
  * @brief   Pipes APIs.
  * @details If enabled then the pipes APIs are included
@@ -76,6 +76,17 @@ typedef struct ch_binary_semaphore {
   semaphore_t           sem;
 } binary_semaphore_t;
 
+#if defined(__CHIBIOS_RT__) || defined(__DOXYGEN__)
+/**
+ * @extends fast_semaphore_t
+ *
+ * @brief   Fast binary semaphore type.
+ */
+typedef struct ch_fast_binary_semaphore {
+  fast_semaphore_t      fsem;
+} fast_binary_semaphore_t;
+#endif
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -102,6 +113,30 @@ typedef struct ch_binary_semaphore {
 #define BSEMAPHORE_DECL(name, taken)                                        \
   binary_semaphore_t name = __BSEMAPHORE_DATA(name, taken)
 
+#if defined(__CHIBIOS_RT__) || defined(__DOXYGEN__)
+/**
+ * @brief   Data part of a static fast binary semaphore initializer.
+ * @details This macro should be used when statically initializing a fast
+ *          binary semaphore that is part of a bigger structure.
+ *
+ * @param[in] name      the name of the semaphore variable
+ * @param[in] taken     the semaphore initial state
+ */
+#define __FAST_BSEMAPHORE_DATA(name, taken)                                 \
+  {__FAST_SEMAPHORE_DATA(name.fsem, ((taken) ? 0 : 1))}
+
+/**
+ * @brief   Static fast binary semaphore initializer.
+ * @details Statically initialized semaphores require no explicit
+ *          initialization using @p chFBSemObjectInit().
+ *
+ * @param[in] name      the name of the semaphore variable
+ * @param[in] taken     the semaphore initial state
+ */
+#define FAST_BSEMAPHORE_DECL(name, taken)                                   \
+  fast_binary_semaphore_t name = __FAST_BSEMAPHORE_DATA(name, taken)
+#endif
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -304,6 +339,131 @@ static inline bool chBSemGetStateI(const binary_semaphore_t *bsp) {
   return (bsp->sem.cnt > (cnt_t)0) ? false : true;
 }
 
+#if defined(__CHIBIOS_RT__) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes a fast binary semaphore.
+ *
+ * @param[out] fbsp     pointer to a @p fast_binary_semaphore_t structure
+ * @param[in] taken     initial state of the binary semaphore:
+ *                      - @a false, the initial state is not taken.
+ *                      - @a true, the initial state is taken.
+ *                      .
+ *
+ * @init
+ */
+static inline void chFBSemObjectInit(fast_binary_semaphore_t *fbsp,
+                                     bool taken) {
+
+  chFSemObjectInit(&fbsp->fsem, taken ? (cnt_t)0 : (cnt_t)1);
+}
+
+/**
+ * @brief   Wait operation on the fast binary semaphore.
+ *
+ * @param[in] fbsp      pointer to a @p fast_binary_semaphore_t structure
+ * @return              A message specifying how the invoking thread has been
+ *                      released from the semaphore.
+ * @retval MSG_OK       if the binary semaphore has been successfully taken.
+ *
+ * @api
+ */
+static inline msg_t chFBSemWait(fast_binary_semaphore_t *fbsp) {
+
+  return chFSemWait(&fbsp->fsem);
+}
+
+/**
+ * @brief   Wait operation on the fast binary semaphore.
+ *
+ * @param[in] fbsp      pointer to a @p fast_binary_semaphore_t structure
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              A message specifying how the invoking thread has been
+ *                      released from the semaphore.
+ * @retval MSG_OK       if the binary semaphore has been successfully taken.
+ * @retval MSG_TIMEOUT  if the binary semaphore has not been signaled
+ *                      within the specified timeout.
+ *
+ * @api
+ */
+static inline msg_t chFBSemWaitTimeout(fast_binary_semaphore_t *fbsp,
+                                       sysinterval_t timeout) {
+
+  return chFSemWaitTimeout(&fbsp->fsem, timeout);
+}
+
+/**
+ * @brief   Performs a signal operation on a fast binary semaphore.
+ * @details The counter is increased atomically only if the semaphore is
+ *          taken, the kernel is entered only if there are waiting threads.
+ *
+ * @param[in] fbsp      pointer to a @p fast_binary_semaphore_t structure
+ *
+ * @api
+ */
+static inline void chFBSemSignal(fast_binary_semaphore_t *fbsp) {
+  cnt_t cnt;
+
+  do {
+    cnt = fbsp->fsem.cnt;
+    if (cnt >= (cnt_t)1) {
+      return;
+    }
+  } while (!__sem_cas(&fbsp->fsem.cnt, cnt, cnt + (cnt_t)1));
+
+  if (cnt < (cnt_t)0) {
+    chSemSignal(&fbsp->fsem.sem);
+  }
+}
+
+/**
+ * @brief   Performs a signal operation on a fast binary semaphore.
+ * @details This variant can be invoked from any context, thread, ISR or
+ *          critical zone, the kernel lock is taken only if there are
+ *          waiting threads.
+ *
+ * @param[in] fbsp      pointer to a @p fast_binary_semaphore_t structure
+ *
+ * @xclass
+ */
+static inline void chFBSemSignalX(fast_binary_semaphore_t *fbsp) {
+  cnt_t cnt;
+
+  do {
+    cnt = fbsp->fsem.cnt;
+    if (cnt >= (cnt_t)1) {
+      return;
+    }
+  } while (!__sem_cas(&fbsp->fsem.cnt, cnt, cnt + (cnt_t)1));
+
+  if (cnt < (cnt_t)0) {
+    syssts_t sts = chSysGetStatusAndLockX();
+    chSemSignalI(&fbsp->fsem.sem);
+    chSysRestoreStatusX(sts);
+  }
+}
+
+/**
+ * @brief   Returns the fast binary semaphore current state.
+ * @note    The state can change at any time, it is meant for diagnostic
+ *          purposes.
+ *
+ * @param[in] fbsp      pointer to a @p fast_binary_semaphore_t structure
+ * @return              The binary semaphore current state.
+ * @retval false        if the binary semaphore is not taken.
+ * @retval true         if the binary semaphore is taken.
+ *
+ * @xclass
+ */
+static inline bool chFBSemGetStateX(const fast_binary_semaphore_t *fbsp) {
+
+  return (chFSemGetCounterX(&fbsp->fsem) > (cnt_t)0) ? false : true;
+}
+#endif /* defined(__CHIBIOS_RT__) */
+
 #endif /* CH_CFG_USE_SEMAPHORES == TRUE */
 
 #endif /* CHBSEM_H */
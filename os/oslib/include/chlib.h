@@ -238,6 +238,7 @@
 #include "chmemheaps.h"
 #include "chmempools.h"
 #include "chobjfifos.h"
+#include "chrings.h"
 #include "chpipes.h"
 #include "chobjcaches.h"
 #include "chdelegates.h"
@@ -38,7 +38,9 @@
  * @brief   Minimum alignment used for heap.
  * @note    Cannot use the sizeof operator in this macro.
  */
-#if (SIZEOF_PTR == 4) || defined(__DOXYGEN__)
+#if (SIZEOF_PTR == 8)
+#define CH_HEAP_ALIGNMENT   16U
+#elif (SIZEOF_PTR == 4) || defined(__DOXYGEN__)
 #define CH_HEAP_ALIGNMENT   8U
 #elif (SIZEOF_PTR == 2)
 #define CH_HEAP_ALIGNMENT   4U
@@ -159,6 +161,7 @@ extern "C" {
   void chHeapObjectInit(memory_heap_t *heapp, void *buf, size_t size);
   void *chHeapAllocAligned(memory_heap_t *heapp, size_t size, unsigned align);
   void chHeapFree(void *p);
+  void *chHeapRealloc(void *p, size_t size);
   size_t chHeapStatus(memory_heap_t *heapp, size_t *totalp, size_t *largestp);
   bool chHeapIntegrityCheck(memory_heap_t *heapp);
 #ifdef __cplusplus
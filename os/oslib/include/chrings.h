@@ -0,0 +1,504 @@
+/*
+    ChibiOS - Copyright (C) 2006,2007,2008,2009,2010,2011,2012,2013,2014,
+              2015,2016,2017,2018,2019,2020,2021 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation version 3 of the License.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    oslib/include/chrings.h
+ * @brief   Lock-free rings structures and macros.
+ * @details This module implements lock-free ring queues of messages meant
+ *          for handing data from ISRs to threads without entering the
+ *          kernel.<br>
+ *          Rings defined in this module:
+ *          - <b>SPSC ring</b>: Single producer, single consumer. Producer
+ *            and consumer only share two counters, no atomic
+ *            read-modify-write operations are required.
+ *          - <b>MPSC ring</b>: Multiple producers, single consumer. Slots
+ *            are reserved using a compare-and-swap on the write position,
+ *            each slot carries a sequence number telling the consumer when
+ *            its content has been published.
+ *          - <b>Ring queue</b>: An MPSC ring coupled with a fast binary
+ *            semaphore, the consumer can wait for messages and the kernel
+ *            is entered only when the consumer actually has to sleep.
+ *            Ring queues are only available in RT when semaphores are
+ *            enabled.
+ *          .
+ *          Ring operations are never blocking except the ring queue fetch
+ *          operation, put operations can be invoked from any context.
+ * @pre     Rings sizes must be powers of two.
+ * @note    The port atomics are used if available, else short critical
+ *          zones are used for the compare-and-swap and barrier
+ *          operations.
+ *
+ * @addtogroup oslib_rings
+ * @{
+ */
+
+#ifndef CHRINGS_H
+#define CHRINGS_H
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Lock-free rings APIs.
+ * @details If enabled then the lock-free rings APIs are included in the
+ *          kernel.
+ */
+#if !defined(CH_CFG_USE_RINGS) || defined(__DOXYGEN__)
+#define CH_CFG_USE_RINGS                    TRUE
+#endif
+
+#if (CH_CFG_USE_RINGS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a single producer single consumer ring.
+ */
+typedef struct ch_spsc_ring {
+  /**
+   * @brief   Pointer to the messages buffer.
+   */
+  msg_t                     *buffer;
+  /**
+   * @brief   Ring size mask, size minus one.
+   */
+  ucnt_t                    mask;
+  /**
+   * @brief   Messages written so far, only written by the producer.
+   */
+  volatile ucnt_t           wrcnt;
+  /**
+   * @brief   Messages read so far, only written by the consumer.
+   */
+  volatile ucnt_t           rdcnt;
+} spsc_ring_t;
+
+/**
+ * @brief   Type of an MPSC ring slot.
+ */
+typedef struct ch_ring_slot {
+  /**
+   * @brief   Slot sequence number.
+   */
+  volatile ucnt_t           seq;
+  /**
+   * @brief   Slot message.
+   */
+  msg_t                     msg;
+} ring_slot_t;
+
+/**
+ * @brief   Type of a multiple producers single consumer ring.
+ */
+typedef struct ch_mpsc_ring {
+  /**
+   * @brief   Pointer to the slots buffer.
+   */
+  ring_slot_t               *slots;
+  /**
+   * @brief   Ring size mask, size minus one.
+   */
+  ucnt_t                    mask;
+  /**
+   * @brief   Next write position, shared among producers.
+   */
+  volatile cnt_t            wrpos;
+  /**
+   * @brief   Next read position, only used by the consumer.
+   */
+  ucnt_t                    rdpos;
+} mpsc_ring_t;
+
+#if (defined(__CHIBIOS_RT__) && (CH_CFG_USE_SEMAPHORES == TRUE)) ||          \
+    defined(__DOXYGEN__)
+/**
+ * @brief   Type of a ring queue.
+ */
+typedef struct ch_ring_queue {
+  /**
+   * @brief   Messages ring.
+   */
+  mpsc_ring_t               ring;
+  /**
+   * @brief   Consumer wake-up semaphore.
+   */
+  fast_binary_semaphore_t   bsem;
+} ring_queue_t;
+#endif /* defined(__CHIBIOS_RT__) && (CH_CFG_USE_SEMAPHORES == TRUE) */
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Compare-and-swap on a ring counter.
+ *
+ * @param[in,out] p     pointer to the counter
+ * @param[in] expected  expected counter value
+ * @param[in] desired   new counter value
+ * @return              The operation result.
+ *
+ * @notapi
+ */
+static inline bool __ring_cas(volatile cnt_t *p,
+                              cnt_t expected, cnt_t desired) {
+
+#if defined(PORT_SUPPORTS_ATOMICS) && (PORT_SUPPORTS_ATOMICS == TRUE)
+  return port_atomic_cas(p, expected, desired);
+#else
+  syssts_t sts;
+  bool result = false;
+
+  sts = chSysGetStatusAndLockX();
+  if (*p == expected) {
+    *p = desired;
+    result = true;
+  }
+  chSysRestoreStatusX(sts);
+
+  return result;
+#endif
+}
+
+/**
+ * @brief   Memory barrier between ring data and ring counters accesses.
+ *
+ * @notapi
+ */
+static inline void __ring_barrier(void) {
+
+#if defined(PORT_SUPPORTS_ATOMICS) && (PORT_SUPPORTS_ATOMICS == TRUE)
+  port_atomic_barrier();
+#else
+  /* Entering and leaving a critical zone is a barrier in all ports.*/
+  chSysRestoreStatusX(chSysGetStatusAndLockX());
+#endif
+}
+
+/**
+ * @brief   Initializes a @p spsc_ring_t object.
+ *
+ * @param[out] rp       pointer to a @p spsc_ring_t structure
+ * @param[in] buf       pointer to the messages buffer
+ * @param[in] n         number of elements in the buffer, it must be a
+ *                      power of two
+ *
+ * @init
+ */
+static inline void chSpscRingObjectInit(spsc_ring_t *rp,
+                                        msg_t *buf, size_t n) {
+
+  chDbgCheck((rp != NULL) && (buf != NULL) &&
+             (n > (size_t)0) && ((n & (n - (size_t)1)) == (size_t)0));
+
+  rp->buffer = buf;
+  rp->mask   = (ucnt_t)n - (ucnt_t)1;
+  rp->wrcnt  = (ucnt_t)0;
+  rp->rdcnt  = (ucnt_t)0;
+}
+
+/**
+ * @brief   Returns the number of messages in a SPSC ring.
+ * @note    The value can change at any time, it is exact only when invoked
+ *          by the producer or by the consumer.
+ *
+ * @param[in] rp        pointer to a @p spsc_ring_t structure
+ * @return              The number of queued messages.
+ *
+ * @xclass
+ */
+static inline size_t chSpscRingGetUsedCountX(const spsc_ring_t *rp) {
+
+  return (size_t)(rp->wrcnt - rp->rdcnt);
+}
+
+/**
+ * @brief   Puts a message in a SPSC ring.
+ * @note    Only a single producer is allowed, it can be a thread or an ISR.
+ *
+ * @param[in] rp        pointer to a @p spsc_ring_t structure
+ * @param[in] msg       the message to be put
+ * @return              The operation status.
+ * @retval MSG_OK       if the message has been put.
+ * @retval MSG_TIMEOUT  if the ring is full.
+ *
+ * @xclass
+ */
+static inline msg_t chSpscRingPutX(spsc_ring_t *rp, msg_t msg) {
+  ucnt_t wr = rp->wrcnt;
+
+  if ((wr - rp->rdcnt) > rp->mask) {
+    return MSG_TIMEOUT;
+  }
+
+  rp->buffer[wr & rp->mask] = msg;
+
+  /* The message must be visible before the counter is published.*/
+  __ring_barrier();
+  rp->wrcnt = wr + (ucnt_t)1;
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Gets a message from a SPSC ring.
+ * @note    Only a single consumer is allowed, it can be a thread or an ISR.
+ *
+ * @param[in] rp        pointer to a @p spsc_ring_t structure
+ * @param[out] msgp     pointer to a message variable for the received
+ *                      message
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been retrieved.
+ * @retval MSG_TIMEOUT  if the ring is empty.
+ *
+ * @xclass
+ */
+static inline msg_t chSpscRingGetX(spsc_ring_t *rp, msg_t *msgp) {
+  ucnt_t rd = rp->rdcnt;
+
+  if (rp->wrcnt == rd) {
+    return MSG_TIMEOUT;
+  }
+
+  /* The message must be read after the counter and before the slot is
+     released to the producer.*/
+  __ring_barrier();
+  *msgp = rp->buffer[rd & rp->mask];
+  __ring_barrier();
+  rp->rdcnt = rd + (ucnt_t)1;
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Initializes a @p mpsc_ring_t object.
+ *
+ * @param[out] rp       pointer to a @p mpsc_ring_t structure
+ * @param[in] slots     pointer to the slots buffer
+ * @param[in] n         number of elements in the buffer, it must be a
+ *                      power of two
+ *
+ * @init
+ */
+static inline void chMpscRingObjectInit(mpsc_ring_t *rp,
+                                        ring_slot_t *slots, size_t n) {
+  size_t i;
+
+  chDbgCheck((rp != NULL) && (slots != NULL) &&
+             (n > (size_t)0) && ((n & (n - (size_t)1)) == (size_t)0));
+
+  for (i = (size_t)0; i < n; i++) {
+    slots[i].seq = (ucnt_t)i;
+  }
+  rp->slots = slots;
+  rp->mask  = (ucnt_t)n - (ucnt_t)1;
+  rp->wrpos = (cnt_t)0;
+  rp->rdpos = (ucnt_t)0;
+}
+
+/**
+ * @brief   Puts a message in a MPSC ring.
+ * @note    Any number of producers is allowed, threads or ISRs, also on
+ *          different cores.
+ *
+ * @param[in] rp        pointer to a @p mpsc_ring_t structure
+ * @param[in] msg       the message to be put
+ * @return              The operation status.
+ * @retval MSG_OK       if the message has been put.
+ * @retval MSG_TIMEOUT  if the ring is full.
+ *
+ * @xclass
+ */
+static inline msg_t chMpscRingPutX(mpsc_ring_t *rp, msg_t msg) {
+  ring_slot_t *sp;
+  ucnt_t pos;
+
+  while (true) {
+    cnt_t dif;
+
+    pos = (ucnt_t)rp->wrpos;
+    sp  = &rp->slots[pos & rp->mask];
+    dif = (cnt_t)(sp->seq - pos);
+    if (dif == (cnt_t)0) {
+      /* Slot free, trying to reserve it.*/
+      if (__ring_cas(&rp->wrpos, (cnt_t)pos, (cnt_t)(pos + (ucnt_t)1))) {
+        break;
+      }
+    }
+    else if (dif < (cnt_t)0) {
+      /* Slot still not released by the consumer, ring full.*/
+      return MSG_TIMEOUT;
+    }
+    else {
+      /* Another producer reserved the slot, retrying.*/
+    }
+  }
+
+  /* The message must be visible before the slot is published.*/
+  sp->msg = msg;
+  __ring_barrier();
+  sp->seq = pos + (ucnt_t)1;
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Gets a message from a MPSC ring.
+ * @note    Only a single consumer is allowed, it can be a thread or an ISR.
+ * @note    A slot reserved but not yet published by a producer makes the
+ *          ring appear empty until the producer completes its operation.
+ *
+ * @param[in] rp        pointer to a @p mpsc_ring_t structure
+ * @param[out] msgp     pointer to a message variable for the received
+ *                      message
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been retrieved.
+ * @retval MSG_TIMEOUT  if the ring is empty.
+ *
+ * @xclass
+ */
+static inline msg_t chMpscRingGetX(mpsc_ring_t *rp, msg_t *msgp) {
+  ucnt_t pos = rp->rdpos;
+  ring_slot_t *sp = &rp->slots[pos & rp->mask];
+
+  if ((cnt_t)(sp->seq - (pos + (ucnt_t)1)) < (cnt_t)0) {
+    return MSG_TIMEOUT;
+  }
+
+  /* The message must be read after the sequence number and before the
+     slot is released to the producers.*/
+  __ring_barrier();
+  *msgp = sp->msg;
+  __ring_barrier();
+  sp->seq = pos + rp->mask + (ucnt_t)1;
+  rp->rdpos = pos + (ucnt_t)1;
+
+  return MSG_OK;
+}
+
+#if (defined(__CHIBIOS_RT__) && (CH_CFG_USE_SEMAPHORES == TRUE)) ||          \
+    defined(__DOXYGEN__)
+/**
+ * @brief   Initializes a @p ring_queue_t object.
+ *
+ * @param[out] rqp      pointer to a @p ring_queue_t structure
+ * @param[in] slots     pointer to the slots buffer
+ * @param[in] n         number of elements in the buffer, it must be a
+ *                      power of two
+ *
+ * @init
+ */
+static inline void chRingQueueObjectInit(ring_queue_t *rqp,
+                                         ring_slot_t *slots, size_t n) {
+
+  chMpscRingObjectInit(&rqp->ring, slots, n);
+  chFBSemObjectInit(&rqp->bsem, true);
+}
+
+/**
+ * @brief   Posts a message in a ring queue.
+ * @details The kernel is entered only if the consumer is waiting.
+ *
+ * @param[in] rqp       pointer to a @p ring_queue_t structure
+ * @param[in] msg       the message to be posted
+ * @return              The operation status.
+ * @retval MSG_OK       if the message has been posted.
+ * @retval MSG_TIMEOUT  if the ring is full.
+ *
+ * @xclass
+ */
+static inline msg_t chRingQueuePostX(ring_queue_t *rqp, msg_t msg) {
+
+  if (chMpscRingPutX(&rqp->ring, msg) != MSG_OK) {
+    return MSG_TIMEOUT;
+  }
+
+  chFBSemSignalX(&rqp->bsem);
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Fetches a message from a ring queue.
+ * @details Queued messages are fetched without entering the kernel, the
+ *          invoking thread sleeps only if the ring is empty.
+ * @note    Only a single consumer thread is allowed.
+ * @note    The timeout is applied to each wait, a wake-up not followed by
+ *          a message restarts the wait.
+ *
+ * @param[in] rqp       pointer to a @p ring_queue_t structure
+ * @param[out] msgp     pointer to a message variable for the received
+ *                      message
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly fetched.
+ * @retval MSG_TIMEOUT  if the operation has timed out.
+ *
+ * @api
+ */
+static inline msg_t chRingQueueFetchTimeout(ring_queue_t *rqp, msg_t *msgp,
+                                            sysinterval_t timeout) {
+
+  while (chMpscRingGetX(&rqp->ring, msgp) != MSG_OK) {
+    msg_t msg = chFBSemWaitTimeout(&rqp->bsem, timeout);
+    if (msg != MSG_OK) {
+      return msg;
+    }
+  }
+
+  return MSG_OK;
+}
+#endif /* defined(__CHIBIOS_RT__) && (CH_CFG_USE_SEMAPHORES == TRUE) */
+
+#endif /* CH_CFG_USE_RINGS == TRUE */
+
+#endif /* CHRINGS_H */
+
+/** @} */
@@ -99,6 +99,46 @@ static memory_heap_t default_heap;
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+/**
+ * @brief   Inserts a block in the free blocks list.
+ * @details The block is inserted in address order and merged with the
+ *          adjacent free blocks, if any.
+ * @note    The heap mutex must be already taken.
+ *
+ * @param[in] heapp     pointer to the heap descriptor
+ * @param[in] hp        pointer to the header of the block to be inserted,
+ *                      the size in pages must be already set
+ *
+ * @notapi
+ */
+static void heap_insert_free(memory_heap_t *heapp, heap_header_t *hp) {
+  heap_header_t *qp = &heapp->header;
+
+  while (true) {
+    chDbgAssert((hp < qp) || (hp >= H_FREE_LIMIT(qp)), "within free block");
+
+    if (((qp == &heapp->header) || (hp > qp)) &&
+        ((H_FREE_NEXT(qp) == NULL) || (hp < H_FREE_NEXT(qp)))) {
+      /* Insertion after qp.*/
+      H_FREE_NEXT(hp) = H_FREE_NEXT(qp);
+      H_FREE_NEXT(qp) = hp;
+      /* Verifies if the newly inserted block should be merged.*/
+      if (H_FREE_LIMIT(hp) == H_FREE_NEXT(hp)) {
+        /* Merge with the next block.*/
+        H_FREE_PAGES(hp) += H_FREE_PAGES(H_FREE_NEXT(hp)) + 1U;
+        H_FREE_NEXT(hp) = H_FREE_NEXT(H_FREE_NEXT(hp));
+      }
+      if ((H_FREE_LIMIT(qp) == hp)) {
+        /* Merge with the previous block.*/
+        H_FREE_PAGES(qp) += H_FREE_PAGES(hp) + 1U;
+        H_FREE_NEXT(qp) = H_FREE_NEXT(hp);
+      }
+      break;
+    }
+    qp = H_FREE_NEXT(qp);
+  }
+}
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -298,7 +338,7 @@ void *chHeapAllocAligned(memory_heap_t *heapp, size_t size, unsigned align) {
  * @api
  */
 void chHeapFree(void *p) {
-  heap_header_t *qp, *hp;
+  heap_header_t *hp;
   memory_heap_t *heapp;
 
   chDbgCheck((p != NULL) && MEM_IS_ALIGNED(p, CH_HEAP_ALIGNMENT));
@@ -307,7 +347,6 @@ void chHeapFree(void *p) {
   hp = (heap_header_t *)p - 1U;
   /*lint -restore*/
   heapp = H_USED_HEAP(hp);
-  qp = &heapp->header;
 
 #if CH_CFG_HARDENING_LEVEL > 0
   memset((void *)p, 0, MEM_ALIGN_NEXT(H_USED_SIZE(hp), CH_HEAP_ALIGNMENT));
@@ -320,34 +359,122 @@ void chHeapFree(void *p) {
   /* Taking heap mutex.*/
   H_LOCK(heapp);
 
-  while (true) {
-    chDbgAssert((hp < qp) || (hp >= H_FREE_LIMIT(qp)), "within free block");
+  /* Returning the block to the free list.*/
+  heap_insert_free(heapp, hp);
 
-    if (((qp == &heapp->header) || (hp > qp)) &&
-        ((H_FREE_NEXT(qp) == NULL) || (hp < H_FREE_NEXT(qp)))) {
-      /* Insertion after qp.*/
-      H_FREE_NEXT(hp) = H_FREE_NEXT(qp);
-      H_FREE_NEXT(qp) = hp;
-      /* Verifies if the newly inserted block should be merged.*/
-      if (H_FREE_LIMIT(hp) == H_FREE_NEXT(hp)) {
-        /* Merge with the next block.*/
-        H_FREE_PAGES(hp) += H_FREE_PAGES(H_FREE_NEXT(hp)) + 1U;
-        H_FREE_NEXT(hp) = H_FREE_NEXT(H_FREE_NEXT(hp));
-      }
-      if ((H_FREE_LIMIT(qp) == hp)) {
-        /* Merge with the previous block.*/
-        H_FREE_PAGES(qp) += H_FREE_PAGES(hp) + 1U;
-        H_FREE_NEXT(qp) = H_FREE_NEXT(hp);
-      }
-      break;
+  /* Releasing heap mutex.*/
+  H_UNLOCK(heapp);
+
+  return;
+}
+
+/**
+ * @brief   Resizes a previously allocated memory block.
+ * @details The block is resized in place when possible:
+ *          - When shrinking, the excess pages are returned to the heap.
+ *          - When growing, the block is extended into the free block
+ *            immediately following it, if large enough.
+ *          .
+ *          Otherwise a new block is allocated from the same heap, the
+ *          content is copied and the old block is freed.
+ * @note    A moved block is aligned to @p CH_HEAP_ALIGNMENT, any larger
+ *          alignment requested on allocation is not preserved.
+ *
+ * @param[in] p         pointer to the memory block to be resized
+ * @param[in] size      the new size of the block
+ * @return              A pointer to the resized block, it can be different
+ *                      from @p p if the block has been moved.
+ * @retval NULL         if the block cannot be resized, in this case the
+ *                      original block is left unchanged.
+ *
+ * @api
+ */
+void *chHeapRealloc(void *p, size_t size) {
+  heap_header_t *qp, *hp, *fp;
+  memory_heap_t *heapp;
+  size_t curpages, pages, cursize;
+  void *np;
+
+  chDbgCheck((p != NULL) && (size > 0U) &&
+             MEM_IS_ALIGNED(p, CH_HEAP_ALIGNMENT));
+
+  /*lint -save -e9087 [11.3] Safe cast.*/
+  hp = (heap_header_t *)p - 1U;
+  /*lint -restore*/
+  heapp = H_USED_HEAP(hp);
+
+  /* Sizes are converted in number of elementary allocation units.*/
+  pages = MEM_ALIGN_NEXT(size, CH_HEAP_ALIGNMENT) / CH_HEAP_ALIGNMENT;
+
+  /* Taking heap mutex.*/
+  H_LOCK(heapp);
+
+  cursize = H_USED_SIZE(hp);
+  curpages = MEM_ALIGN_NEXT(cursize, CH_HEAP_ALIGNMENT) / CH_HEAP_ALIGNMENT;
+
+  if (pages <= curpages) {
+    /* Shrinking, the excess pages, if any, become a free block.*/
+    if (pages < curpages) {
+      fp = H_BLOCK(hp) + pages;
+#if CH_CFG_HARDENING_LEVEL > 0
+      memset((void *)fp, 0, (curpages - pages) * CH_HEAP_ALIGNMENT);
+#endif
+      H_FREE_PAGES(fp) = (curpages - pages) - 1U;
+      heap_insert_free(heapp, fp);
     }
+    H_USED_SIZE(hp) = size;
+
+    /* Releasing heap mutex.*/
+    H_UNLOCK(heapp);
+
+    return p;
+  }
+
+  /* Growing, searching for a free block adjacent to the current one, the
+     free list is ordered by address.*/
+  qp = &heapp->header;
+  while ((H_FREE_NEXT(qp) != NULL) &&
+         (H_FREE_NEXT(qp) < (H_BLOCK(hp) + curpages))) {
     qp = H_FREE_NEXT(qp);
   }
+  fp = H_FREE_NEXT(qp);
+  if ((fp == (H_BLOCK(hp) + curpages)) &&
+      ((H_FREE_PAGES(fp) + 1U) >= (pages - curpages))) {
+    /* The adjacent free block is large enough, pages not used by the
+       resized block remain in the free list.*/
+    size_t fpages = (H_FREE_PAGES(fp) + 1U) - (pages - curpages);
+    heap_header_t *nextp = H_FREE_NEXT(fp);
+
+    if (fpages == 0U) {
+      /* Exact size, getting the whole free block.*/
+      H_FREE_NEXT(qp) = nextp;
+    }
+    else {
+      /* Moving the free block header after the resized block.*/
+      fp = H_BLOCK(hp) + pages;
+      H_FREE_NEXT(fp) = nextp;
+      H_FREE_PAGES(fp) = fpages - 1U;
+      H_FREE_NEXT(qp) = fp;
+    }
+    H_USED_SIZE(hp) = size;
+
+    /* Releasing heap mutex.*/
+    H_UNLOCK(heapp);
+
+    return p;
+  }
 
   /* Releasing heap mutex.*/
   H_UNLOCK(heapp);
 
-  return;
+  /* Cannot grow in place, moving the block.*/
+  np = chHeapAllocAligned(heapp, size, CH_HEAP_ALIGNMENT);
+  if (np != NULL) {
+    memcpy(np, p, cursize);
+    chHeapFree(p);
+  }
+
+  return np;
 }
 
 /**
@@ -295,8 +295,15 @@ size_t chPipeWriteTimeout(pipe_t *pp, const uint8_t *bp,
     if (done == (size_t)0) {
       msg_t msg;
 
+      /* The reset state is checked again within the critical zone, a
+         reset could have happened after this thread has been resumed.*/
       chSysLock();
-      msg = chThdSuspendTimeoutS(&pp->wtr, timeout);
+      if (pp->reset) {
+        msg = MSG_RESET;
+      }
+      else {
+        msg = chThdSuspendTimeoutS(&pp->wtr, timeout);
+      }
       chSysUnlock();
 
       /* Anything except MSG_OK causes the operation to stop.*/
@@ -360,8 +367,15 @@ size_t chPipeReadTimeout(pipe_t *pp, uint8_t *bp,
     if (done == (size_t)0) {
       msg_t msg;
 
+      /* The reset state is checked again within the critical zone, a
+         reset could have happened after this thread has been resumed.*/
       chSysLock();
-      msg = chThdSuspendTimeoutS(&pp->rtr, timeout);
+      if (pp->reset) {
+        msg = MSG_RESET;
+      }
+      else {
+        msg = chThdSuspendTimeoutS(&pp->rtr, timeout);
+      }
       chSysUnlock();
 
       /* Anything except MSG_OK causes the operation to stop.*/
@@ -53,6 +53,14 @@
 #error "CH_CFG_SMP_MODE not defined in chconf.h"
 #endif
 
+#if !defined(CH_CFG_USE_MIGRATION)
+#error "CH_CFG_USE_MIGRATION not defined in chconf.h"
+#endif
+
+#if (CH_CFG_USE_MIGRATION == TRUE) && (CH_CFG_SMP_MODE == FALSE)
+#error "CH_CFG_USE_MIGRATION requires CH_CFG_SMP_MODE"
+#endif
+
 #if !defined(CH_CFG_HARDENING_LEVEL)
 #error "CH_CFG_HARDENING_LEVEL not defined in chconf.h"
 #endif
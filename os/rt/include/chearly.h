@@ -127,6 +127,12 @@ typedef uint8_t         ucnt_t;             /**< Generic unsigned counter.  */
  */
 typedef unsigned core_id_t;
 
+/**
+ * @brief   Type of a mask of cores.
+ * @note    Bit @p n of the mask represents the core with identifier @p n.
+ */
+typedef unsigned core_mask_t;
+
 /**
  * @brief   Type of a thread structure.
  */
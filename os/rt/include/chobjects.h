@@ -185,6 +185,13 @@ struct ch_thread {
    * @brief   OS instance owner of this thread.
    */
   os_instance_t                 *owner;
+#if (CH_CFG_USE_MIGRATION == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Mask of the cores this thread is allowed to run on.
+   * @note    A zero mask means that the thread can run on any core.
+   */
+  core_mask_t                   cores;
+#endif
 #if (CH_CFG_USE_REGISTRY == TRUE) || defined(__DOXYGEN__)
   /**
    * @brief   Thread name or @p NULL.
@@ -489,6 +496,13 @@ typedef struct ch_system {
    */
   rfcu_t                        rfcu;
 #endif
+#if (CH_CFG_USE_MIGRATION == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Load balancer virtual timer.
+   * @note    This field is present only if threads migration is enabled.
+   */
+  virtual_timer_t               balancer;
+#endif
 #if defined(PORT_SYSTEM_EXTRA_FIELDS) || defined(__DOXYGEN__)
   /* Extra fields from port layer.*/
   PORT_SYSTEM_EXTRA_FIELDS
@@ -126,6 +126,10 @@
 #define PORT_CORES_NUMBER                   1
 #endif
 
+#if !defined(PORT_SUPPORTS_ATOMICS)
+#define PORT_SUPPORTS_ATOMICS               FALSE
+#endif
+
 #if (PORT_CORES_NUMBER < 1) || (PORT_CORES_NUMBER > 64)
 #error "invalid PORT_CORES_NUMBER value"
 #endif
@@ -104,6 +104,8 @@
                                                  from a Memory Pool.        */
 #define CH_FLAG_TERMINATE   (tmode_t)4U     /**< @brief Termination requested
                                                  flag.                      */
+#define CH_FLAG_PINNED      (tmode_t)8U     /**< @brief Thread temporarily
+                                                 bound to its instance.     */
 /** @} */
 
 /*===========================================================================*/
@@ -158,6 +160,13 @@ extern "C" {
   void chSchPreemption(void);
   void chSchDoYieldS(void);
   thread_t *chSchSelectFirst(void);
+#if CH_CFG_USE_MIGRATION == TRUE
+  msg_t chSchMigrateI(thread_t *tp, os_instance_t *oip);
+  msg_t chSchMigrateCurrentS(os_instance_t *oip);
+  void chSchBalanceI(void);
+  void chSchBalancerStart(sysinterval_t interval);
+  void chSchBalancerStop(void);
+#endif
 #if CH_CFG_OPTIMIZE_SPEED == FALSE
   void ch_sch_prio_insert(ch_queue_t *qp, ch_queue_t *tp);
 #endif /* CH_CFG_OPTIMIZE_SPEED == FALSE */
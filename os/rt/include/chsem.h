@@ -55,6 +55,21 @@ typedef struct ch_semaphore {
   cnt_t                 cnt;        /**< @brief The semaphore counter.      */
 } semaphore_t;
 
+/**
+ * @brief   Fast semaphore structure.
+ * @details A fast semaphore keeps its counter outside the kernel, wait and
+ *          signal operations are performed using an atomic operation on the
+ *          counter and the kernel is only entered when a thread has to be
+ *          suspended or awakened.
+ */
+typedef struct ch_fast_semaphore {
+  volatile cnt_t        cnt;        /**< @brief The semaphore counter, a
+                                                negative value is the number
+                                                of waiting threads.         */
+  semaphore_t           sem;        /**< @brief Kernel semaphore used in
+                                                the contended case.         */
+} fast_semaphore_t;
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -81,6 +96,29 @@ typedef struct ch_semaphore {
  */
 #define SEMAPHORE_DECL(name, n) semaphore_t name = __SEMAPHORE_DATA(name, n)
 
+/**
+ * @brief   Data part of a static fast semaphore initializer.
+ * @details This macro should be used when statically initializing a fast
+ *          semaphore that is part of a bigger structure.
+ *
+ * @param[in] name      the name of the fast semaphore variable
+ * @param[in] n         the counter initial value, this value must be
+ *                      non-negative
+ */
+#define __FAST_SEMAPHORE_DATA(name, n) {n, __SEMAPHORE_DATA(name.sem, 0)}
+
+/**
+ * @brief   Static fast semaphore initializer.
+ * @details Statically initialized fast semaphores require no explicit
+ *          initialization using @p chFSemObjectInit().
+ *
+ * @param[in] name      the name of the fast semaphore variable
+ * @param[in] n         the counter initial value, this value must be
+ *                      non-negative
+ */
+#define FAST_SEMAPHORE_DECL(name, n)                                        \
+  fast_semaphore_t name = __FAST_SEMAPHORE_DATA(name, n)
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -100,6 +138,10 @@ extern "C" {
   void chSemSignalI(semaphore_t *sp);
   void chSemAddCounterI(semaphore_t *sp, cnt_t n);
   msg_t chSemSignalWait(semaphore_t *sps, semaphore_t *spw);
+  void chFSemObjectInit(fast_semaphore_t *fsp, cnt_t n);
+  msg_t chFSemWaitTimeout(fast_semaphore_t *fsp, sysinterval_t timeout);
+  void chFSemSignal(fast_semaphore_t *fsp);
+  void chFSemSignalI(fast_semaphore_t *fsp);
 #ifdef __cplusplus
 }
 #endif
@@ -194,6 +236,71 @@ static inline cnt_t chSemGetCounterI(const semaphore_t *sp) {
   return sp->cnt;
 }
 
+/**
+ * @brief   Atomic compare-and-swap on a semaphore counter.
+ * @note    If the port does not support atomic operations then the
+ *          operation is performed in a critical zone.
+ *
+ * @param[in,out] p     pointer to the counter
+ * @param[in] expected  expected counter value
+ * @param[in] desired   new counter value
+ * @return              The operation result.
+ * @retval false        if the counter has been changed meanwhile.
+ * @retval true         if the counter has been updated.
+ *
+ * @notapi
+ */
+static inline bool __sem_cas(volatile cnt_t *p,
+                             cnt_t expected, cnt_t desired) {
+
+#if PORT_SUPPORTS_ATOMICS == TRUE
+  return port_atomic_cas(p, expected, desired);
+#else
+  syssts_t sts;
+  bool result;
+
+  sts = chSysGetStatusAndLockX();
+  result = (bool)(*p == expected);
+  if (result) {
+    *p = desired;
+  }
+  chSysRestoreStatusX(sts);
+
+  return result;
+#endif
+}
+
+/**
+ * @brief   Performs a wait operation on a fast semaphore.
+ *
+ * @param[in] fsp       pointer to a @p fast_semaphore_t structure
+ * @return              A message specifying how the invoking thread has been
+ *                      released from the semaphore.
+ * @retval MSG_OK       if the thread has not stopped on the semaphore or the
+ *                      semaphore has been signaled.
+ *
+ * @api
+ */
+static inline msg_t chFSemWait(fast_semaphore_t *fsp) {
+
+  return chFSemWaitTimeout(fsp, TIME_INFINITE);
+}
+
+/**
+ * @brief   Returns the fast semaphore counter current value.
+ * @note    The value can change at any time, it is meant for diagnostic
+ *          purposes.
+ *
+ * @param[in] fsp       pointer to a @p fast_semaphore_t structure
+ * @return              The semaphore counter value.
+ *
+ * @xclass
+ */
+static inline cnt_t chFSemGetCounterX(const fast_semaphore_t *fsp) {
+
+  return fsp->cnt;
+}
+
 #endif /* CH_CFG_USE_SEMAPHORES == TRUE */
 
 #endif /* CHSEM_H */
@@ -34,6 +34,23 @@
 /* Module constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @name    Cores masks
+ * @{
+ */
+/**
+ * @brief   Mask allowing a thread to run on any core.
+ */
+#define THD_CORES_ANY           ((core_mask_t)0)
+
+/**
+ * @brief   Mask bit of a core.
+ *
+ * @param[in] n         the core identifier
+ */
+#define THD_CORE(n)             ((core_mask_t)1U << (n))
+/** @} */
+
 /*===========================================================================*/
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -85,6 +102,13 @@ typedef struct {
    */
   os_instance_t     *instance;
 #endif
+#if (CH_CFG_USE_MIGRATION == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief         Mask of the cores the thread can be migrated to or
+   *                @p THD_CORES_ANY.
+   */
+  core_mask_t       cores;
+#endif
 } thread_descriptor_t;
 
 /*===========================================================================*/
@@ -174,7 +198,7 @@ typedef struct {
  * @name    Threads initializers
  * @{
  */
-#if (CH_CFG_SMP_MODE != FALSE) || defined(__DOXYGEN__)
+#if (CH_CFG_USE_MIGRATION == TRUE) || defined(__DOXYGEN__)
 /**
  * @brief   Thread descriptor initializer with no affinity.
  *
@@ -185,6 +209,17 @@ typedef struct {
  * @param[in] funcp     thread function pointer
  * @param[in] arg       thread argument
  */
+#define THD_DESCRIPTOR(name, wbase, wend, prio, funcp, arg) {               \
+  (name),                                                                   \
+  (wbase),                                                                  \
+  (wend),                                                                   \
+  (prio),                                                                   \
+  (funcp),                                                                  \
+  (arg),                                                                    \
+  NULL,                                                                     \
+  THD_CORES_ANY                                                             \
+}
+#elif CH_CFG_SMP_MODE != FALSE
 #define THD_DESCRIPTOR(name, wbase, wend, prio, funcp, arg) {               \
   (name),                                                                   \
   (wbase),                                                                  \
@@ -216,6 +251,42 @@ typedef struct {
  * @param[in] arg       thread argument
  * @param[in] oip       instance affinity
  */
+#if (CH_CFG_USE_MIGRATION == TRUE) || defined(__DOXYGEN__)
+#define THD_DESCRIPTOR_AFFINITY(name, wbase, wend, prio, funcp, arg, oip) { \
+  (name),                                                                   \
+  (wbase),                                                                  \
+  (wend),                                                                   \
+  (prio),                                                                   \
+  (funcp),                                                                  \
+  (arg),                                                                    \
+  (oip),                                                                    \
+  THD_CORES_ANY                                                             \
+}
+
+/**
+ * @brief   Thread descriptor initializer with affinity and cores mask.
+ *
+ * @param[in] name      thread name
+ * @param[in] wbase     pointer to the working area base
+ * @param[in] wend      pointer to the working area end
+ * @param[in] prio      thread priority
+ * @param[in] funcp     thread function pointer
+ * @param[in] arg       thread argument
+ * @param[in] oip       instance affinity
+ * @param[in] cores     mask of the cores the thread can be migrated to
+ */
+#define THD_DESCRIPTOR_CORES(name, wbase, wend, prio, funcp, arg, oip,      \
+                             cores) {                                       \
+  (name),                                                                   \
+  (wbase),                                                                  \
+  (wend),                                                                   \
+  (prio),                                                                   \
+  (funcp),                                                                  \
+  (arg),                                                                    \
+  (oip),                                                                    \
+  (cores)                                                                   \
+}
+#else
 #define THD_DESCRIPTOR_AFFINITY(name, wbase, wend, prio, funcp, arg, oip) { \
   (name),                                                                   \
   (wbase),                                                                  \
@@ -225,6 +296,7 @@ typedef struct {
   (arg),                                                                    \
   (oip)                                                                     \
 }
+#endif
 /** @} */
 
 /**
@@ -325,6 +397,9 @@ extern "C" {
   void chThdSleepUntil(systime_t time);
   systime_t chThdSleepUntilWindowed(systime_t prev, systime_t next);
   void chThdYield(void);
+#if CH_CFG_USE_MIGRATION == TRUE
+  msg_t chThdMigrate(thread_t *tp, os_instance_t *oip);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -48,6 +48,66 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_MIGRATION == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Checks if a thread is allowed to run on the core of an instance.
+ *
+ * @param[in] tp        the thread to be checked
+ * @param[in] oip       the target OS instance
+ * @return              The check result.
+ * @retval true         if the thread can run on the instance core.
+ * @retval false        if the thread affinity mask excludes the core.
+ *
+ * @notapi
+ */
+static inline bool __sch_core_allowed(thread_t *tp, os_instance_t *oip) {
+
+  return (tp->cores == THD_CORES_ANY) ||
+         ((tp->cores & THD_CORE(oip->core_id)) != (core_mask_t)0);
+}
+
+/**
+ * @brief   Returns the load of an instance.
+ * @details The load is the number of non-idle threads either running or
+ *          ready on the instance.
+ *
+ * @param[in] oip       pointer to the OS instance
+ * @return              The instance load.
+ *
+ * @notapi
+ */
+static cnt_t __sch_get_load(os_instance_t *oip) {
+  ch_priority_queue_t *pqp = oip->rlist.pqueue.next;
+  cnt_t n = (cnt_t)0;
+
+  if (oip->rlist.current->hdr.pqueue.prio > IDLEPRIO) {
+    n++;
+  }
+
+  /* The scan stops on the idle thread or on the header, both have a
+     priority not greater than IDLEPRIO.*/
+  while (pqp->prio > IDLEPRIO) {
+    n++;
+    pqp = pqp->next;
+  }
+
+  return n;
+}
+
+/*
+ * Load balancer callback.
+ */
+static void __sch_balancer(virtual_timer_t *vtp, void *p) {
+
+  (void)vtp;
+  (void)p;
+
+  chSysLockFromISR();
+  chSchBalanceI();
+  chSysUnlockFromISR();
+}
+#endif /* CH_CFG_USE_MIGRATION == TRUE */
+
 /**
  * @brief   Inserts a thread in the Ready List placing it behind its peers.
  * @details The thread is positioned behind all threads with higher or equal
@@ -364,11 +424,19 @@ msg_t chSchGoSleepTimeoutS(tstate_t newstate, sysinterval_t timeout) {
   if (TIME_INFINITE != timeout) {
     virtual_timer_t vt;
 
+#if CH_CFG_USE_MIGRATION == TRUE
+    /* The timer belongs to this instance, the thread cannot be migrated
+       until the timer has been handled.*/
+    tp->flags |= CH_FLAG_PINNED;
+#endif
     chVTDoSetI(&vt, timeout, __sch_wakeup, (void *)tp);
     chSchGoSleepS(newstate);
     if (chVTIsArmedI(&vt)) {
       chVTDoResetI(&vt);
     }
+#if CH_CFG_USE_MIGRATION == TRUE
+    tp->flags &= (tmode_t)~CH_FLAG_PINNED;
+#endif
   }
   else {
     chSchGoSleepS(newstate);
@@ -645,4 +713,205 @@ thread_t *chSchSelectFirst(void) {
   return ntp;
 }
 
+#if (CH_CFG_USE_MIGRATION == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Migrates a thread to another OS instance.
+ * @details Ready threads are moved in the ready list of the target instance
+ *          which is notified in order to reschedule, threads in any other
+ *          state are simply assigned to the new instance and will be made
+ *          ready there when woken.
+ * @note    The current thread cannot be migrated using this function, use
+ *          @p chSchMigrateCurrentS() instead.
+ *
+ * @param[in] tp        the thread to be migrated
+ * @param[in] oip       the target OS instance
+ * @return              The operation result.
+ * @retval MSG_OK       if the thread has been migrated.
+ * @retval MSG_RESET    if the thread is running on another core, is
+ *                      terminated, is bound to its instance by a pending
+ *                      timeout or its cores mask excludes the target core.
+ *
+ * @iclass
+ */
+msg_t chSchMigrateI(thread_t *tp, os_instance_t *oip) {
+
+  chDbgCheckClassI();
+  chDbgCheck((tp != NULL) && (oip != NULL));
+  chDbgAssert(tp->hdr.pqueue.prio != IDLEPRIO, "idle thread");
+
+  if (tp->owner == oip) {
+    return MSG_OK;
+  }
+
+  if ((tp->state == CH_STATE_CURRENT) ||
+      (tp->state == CH_STATE_FINAL) ||
+      ((tp->flags & CH_FLAG_PINNED) != (tmode_t)0) ||
+      !__sch_core_allowed(tp, oip)) {
+    return MSG_RESET;
+  }
+
+  if (tp->state == CH_STATE_READY) {
+    /* Moving the thread from the old ready list to the new one, no need
+       to reschedule locally because the old instance just lost a thread.*/
+    (void) ch_queue_dequeue(&tp->hdr.queue);
+    tp->owner = oip;
+    (void) ch_pqueue_insert_behind(&oip->rlist.pqueue, &tp->hdr.pqueue);
+    chSysNotifyInstance(oip);
+  }
+  else {
+    tp->owner = oip;
+  }
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Migrates the current thread to another OS instance.
+ * @details The current thread is placed in the ready list of the target
+ *          instance, behind its peers, and the next ready thread of the
+ *          current instance is made running.
+ * @note    The function returns when the thread resumes execution on the
+ *          target core.
+ *
+ * @param[in] oip       the target OS instance
+ * @return              The operation result.
+ * @retval MSG_OK       if the thread has been migrated.
+ * @retval MSG_RESET    if the thread cores mask excludes the target core.
+ *
+ * @sclass
+ */
+msg_t chSchMigrateCurrentS(os_instance_t *oip) {
+  os_instance_t *ooip = currcore;
+  thread_t *otp = __instance_get_currthread(ooip);
+  thread_t *ntp;
+
+  chDbgCheckClassS();
+  chDbgCheck(oip != NULL);
+  chDbgAssert(otp != chSysGetIdleThreadX(), "migrating idle thread");
+
+  if (oip == ooip) {
+    return MSG_OK;
+  }
+
+  if (!__sch_core_allowed(otp, oip)) {
+    return MSG_RESET;
+  }
+
+  /* The thread now belongs to the target instance.*/
+  otp->owner = oip;
+
+#if CH_CFG_TIME_QUANTUM > 0
+  /* It goes behind peers on the new instance so it gets a new time
+     quantum.*/
+  otp->ticks = (tslices_t)CH_CFG_TIME_QUANTUM;
+#endif
+
+  /* Next thread in the local ready list becomes current.*/
+  ntp = threadref(ch_pqueue_remove_highest(&ooip->rlist.pqueue));
+  ntp->state = CH_STATE_CURRENT;
+  __instance_set_currthread(ooip, ntp);
+
+  /* Handling idle-enter hook.*/
+  if (ntp->hdr.pqueue.prio == IDLEPRIO) {
+    CH_CFG_IDLE_ENTER_HOOK();
+  }
+
+  /* Placing in the target ready list, the target instance cannot pick the
+     thread before the kernel lock is released, after the context switch.*/
+  otp = __sch_ready_behind(otp);
+  chSysNotifyInstance(oip);
+
+  /* Swap operation.*/
+  chSysSwitch(ntp, otp);
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Performs a load balancing step.
+ * @details The instances having the highest and the lowest load are
+ *          determined, if the difference is at least two threads then
+ *          the lowest priority eligible ready thread is moved from the
+ *          busiest instance to the idlest one.
+ * @note    At most one thread is migrated for each invocation in order to
+ *          keep the execution time bounded.
+ *
+ * @iclass
+ */
+void chSchBalanceI(void) {
+  os_instance_t *srcp = NULL, *dstp = NULL;
+  cnt_t maxload = (cnt_t)0, minload = (cnt_t)0;
+  ch_priority_queue_t *pqp;
+  core_id_t i;
+
+  chDbgCheckClassI();
+
+  for (i = 0U; i < (core_id_t)PORT_CORES_NUMBER; i++) {
+    os_instance_t *oip = ch_system.instances[i];
+
+    if (oip != NULL) {
+      cnt_t load = __sch_get_load(oip);
+
+      if ((srcp == NULL) || (load > maxload)) {
+        srcp    = oip;
+        maxload = load;
+      }
+      if ((dstp == NULL) || (load < minload)) {
+        dstp    = oip;
+        minload = load;
+      }
+    }
+  }
+
+  /* Moving a thread would not improve the balance.*/
+  if ((srcp == NULL) || ((maxload - minload) < (cnt_t)2)) {
+    return;
+  }
+
+  /* Scanning the ready list backward, from the lowest priority threads.*/
+  pqp = srcp->rlist.pqueue.prev;
+  while (pqp != &srcp->rlist.pqueue) {
+    thread_t *tp = threadref(pqp);
+
+    if ((pqp->prio > IDLEPRIO) &&
+        ((tp->flags & CH_FLAG_PINNED) == (tmode_t)0) &&
+        __sch_core_allowed(tp, dstp)) {
+      (void) chSchMigrateI(tp, dstp);
+      return;
+    }
+    pqp = pqp->prev;
+  }
+}
+
+/**
+ * @brief   Starts the periodic load balancer.
+ * @details A continuous virtual timer invoking @p chSchBalanceI() is
+ *          started on the current instance, if the balancer is already
+ *          running then it is restarted using the new interval.
+ * @note    The balancer must be stopped from the same instance that
+ *          started it.
+ *
+ * @param[in] interval  the balancing interval, it must not be
+ *                      @p TIME_IMMEDIATE or @p TIME_INFINITE
+ *
+ * @api
+ */
+void chSchBalancerStart(sysinterval_t interval) {
+
+  chDbgCheck((interval != TIME_IMMEDIATE) && (interval != TIME_INFINITE));
+
+  chVTSetContinuous(&ch_system.balancer, interval, __sch_balancer, NULL);
+}
+
+/**
+ * @brief   Stops the periodic load balancer.
+ *
+ * @api
+ */
+void chSchBalancerStop(void) {
+
+  chVTReset(&ch_system.balancer);
+}
+#endif /* CH_CFG_USE_MIGRATION == TRUE */
+
 /** @} */
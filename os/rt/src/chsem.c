@@ -49,7 +49,12 @@
  *          also have other uses, queues guards and counters for example.<br>
  *          Semaphores usually use a FIFO queuing strategy but it is possible
  *          to make them order threads by priority by enabling
- *          @p CH_CFG_USE_SEMAPHORES_PRIORITY in @p chconf.h.
+ *          @p CH_CFG_USE_SEMAPHORES_PRIORITY in @p chconf.h.<br>
+ *          Fast semaphores are a lightweight variant keeping the counter
+ *          outside the kernel, the uncontended wait and signal operations
+ *          are a single atomic operation on the counter, the kernel is
+ *          entered only when a thread needs to be suspended or awakened.
+ *          Fast semaphores do not support the reset operation.
  * @pre     In order to use the semaphore APIs the @p CH_CFG_USE_SEMAPHORES
  *          option must be enabled in @p chconf.h.
  * @{
@@ -430,6 +435,136 @@ msg_t chSemSignalWait(semaphore_t *sps, semaphore_t *spw) {
   return msg;
 }
 
+/**
+ * @brief   Initializes a fast semaphore with the specified counter value.
+ *
+ * @param[out] fsp      pointer to a @p fast_semaphore_t structure
+ * @param[in] n         initial value of the semaphore counter. Must be
+ *                      non-negative.
+ *
+ * @init
+ */
+void chFSemObjectInit(fast_semaphore_t *fsp, cnt_t n) {
+
+  chDbgCheck((fsp != NULL) && (n >= (cnt_t)0));
+
+  fsp->cnt = n;
+  chSemObjectInit(&fsp->sem, (cnt_t)0);
+}
+
+/**
+ * @brief   Performs a wait operation on a fast semaphore.
+ * @details If the counter is positive it is decreased atomically without
+ *          entering the kernel, else the thread is suspended on the
+ *          underlying kernel semaphore.
+ *
+ * @param[in] fsp       pointer to a @p fast_semaphore_t structure
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              A message specifying how the invoking thread has been
+ *                      released from the semaphore.
+ * @retval MSG_OK       if the thread has not stopped on the semaphore or the
+ *                      semaphore has been signaled.
+ * @retval MSG_TIMEOUT  if the semaphore has not been signaled within the
+ *                      specified timeout.
+ *
+ * @api
+ */
+msg_t chFSemWaitTimeout(fast_semaphore_t *fsp, sysinterval_t timeout) {
+  cnt_t cnt;
+  msg_t msg;
+
+  chDbgCheck(fsp != NULL);
+
+  /* Fast path, the counter is decreased atomically, if it was positive
+     then there is no need to enter the kernel.*/
+  do {
+    cnt = fsp->cnt;
+    if ((cnt <= (cnt_t)0) && (timeout == TIME_IMMEDIATE)) {
+      return MSG_TIMEOUT;
+    }
+  } while (!__sem_cas(&fsp->cnt, cnt, cnt - (cnt_t)1));
+
+  if (cnt > (cnt_t)0) {
+    return MSG_OK;
+  }
+
+  /* Contended case, the thread has been accounted as waiting in the
+     counter so a signal is going to be posted on the kernel semaphore,
+     it could have been posted already.*/
+  chSysLock();
+  msg = chSemWaitTimeoutS(&fsp->sem, timeout);
+  if (msg == MSG_TIMEOUT) {
+    /* Timeout, removing this thread from the counter, this is only possible
+       if the counter is still negative.*/
+    do {
+      cnt = fsp->cnt;
+    } while ((cnt < (cnt_t)0) &&
+             !__sem_cas(&fsp->cnt, cnt, cnt + (cnt_t)1));
+
+    if (cnt >= (cnt_t)0) {
+      /* A signal targeting this thread is already on its way and must
+         be consumed, it is going to arrive shortly.*/
+      msg = chSemWaitS(&fsp->sem);
+    }
+  }
+  chSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Performs a signal operation on a fast semaphore.
+ * @details The counter is increased atomically, the kernel is entered only
+ *          if there are waiting threads.
+ *
+ * @param[in] fsp       pointer to a @p fast_semaphore_t structure
+ *
+ * @api
+ */
+void chFSemSignal(fast_semaphore_t *fsp) {
+  cnt_t cnt;
+
+  chDbgCheck(fsp != NULL);
+
+  do {
+    cnt = fsp->cnt;
+  } while (!__sem_cas(&fsp->cnt, cnt, cnt + (cnt_t)1));
+
+  if (cnt < (cnt_t)0) {
+    chSemSignal(&fsp->sem);
+  }
+}
+
+/**
+ * @brief   Performs a signal operation on a fast semaphore.
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel. Note that
+ *          interrupt handlers always reschedule on exit so an explicit
+ *          reschedule must not be performed in ISRs.
+ *
+ * @param[in] fsp       pointer to a @p fast_semaphore_t structure
+ *
+ * @iclass
+ */
+void chFSemSignalI(fast_semaphore_t *fsp) {
+  cnt_t cnt;
+
+  chDbgCheckClassI();
+  chDbgCheck(fsp != NULL);
+
+  do {
+    cnt = fsp->cnt;
+  } while (!__sem_cas(&fsp->cnt, cnt, cnt + (cnt_t)1));
+
+  if (cnt < (cnt_t)0) {
+    chSemSignalI(&fsp->sem);
+  }
+}
+
 #endif /* CH_CFG_USE_SEMAPHORES == TRUE */
 
 /** @} */
@@ -135,7 +135,9 @@ const os_instance_config_t ch_core1_cfg = {
  */
 void chSysWaitSystemState(system_state_t state) {
 
-  while (ch_system.state != state) {
+  /* The state is changed by another core, it must be re-read on each
+     iteration.*/
+  while (*(volatile system_state_t *)&ch_system.state != state) {
   }
 }
 
@@ -174,6 +176,11 @@ void chSysInit(void) {
   __rfcu_object_init(&ch_system.rfcu);
 #endif
 
+#if CH_CFG_USE_MIGRATION == TRUE
+  /* Load balancer timer, not armed until explicitly started.*/
+  chVTObjectInit(&ch_system.balancer);
+#endif
+
   /* User system initialization hook.*/
   CH_CFG_SYSTEM_INIT_HOOK();
 
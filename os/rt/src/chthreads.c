@@ -97,6 +97,9 @@ thread_t *__thd_object_init(os_instance_t *oip,
   tp->state             = CH_STATE_WTSTART;
   tp->flags             = CH_FLAG_MODE_STATIC;
   tp->owner             = oip;
+#if CH_CFG_USE_MIGRATION == TRUE
+  tp->cores             = THD_CORES_ANY;
+#endif
 #if CH_CFG_TIME_QUANTUM > 0
   tp->ticks             = (tslices_t)CH_CFG_TIME_QUANTUM;
 #endif
@@ -199,11 +202,21 @@ thread_t *chThdCreateSuspendedI(const thread_descriptor_t *tdp) {
   /* The thread object is initialized but not started.*/
 #if CH_CFG_SMP_MODE != FALSE
   if (tdp->instance != NULL) {
-    return __thd_object_init(tdp->instance, tp, tdp->name, tdp->prio);
+    tp = __thd_object_init(tdp->instance, tp, tdp->name, tdp->prio);
+  }
+  else {
+    tp = __thd_object_init(currcore, tp, tdp->name, tdp->prio);
   }
+#else
+  tp = __thd_object_init(currcore, tp, tdp->name, tdp->prio);
 #endif
 
-  return __thd_object_init(currcore, tp, tdp->name, tdp->prio);
+#if CH_CFG_USE_MIGRATION == TRUE
+  /* Cores the thread is allowed to be migrated to.*/
+  tp->cores = tdp->cores;
+#endif
+
+  return tp;
 }
 
 /**
@@ -730,6 +743,41 @@ void chThdYield(void) {
   chSysUnlock();
 }
 
+#if (CH_CFG_USE_MIGRATION == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Migrates a thread to another OS instance.
+ * @details The thread is moved to the specified instance, if the thread is
+ *          the current one then the function returns when it resumes
+ *          execution on the target core.
+ * @note    Threads running on other cores, terminated threads and threads
+ *          waiting with a timeout cannot be migrated.
+ *
+ * @param[in] tp        pointer to the thread
+ * @param[in] oip       pointer to the target OS instance
+ * @return              The operation result.
+ * @retval MSG_OK       if the thread has been migrated.
+ * @retval MSG_RESET    if the thread cannot be migrated.
+ *
+ * @api
+ */
+msg_t chThdMigrate(thread_t *tp, os_instance_t *oip) {
+  msg_t msg;
+
+  chDbgCheck((tp != NULL) && (oip != NULL));
+
+  chSysLock();
+  if (tp == chThdGetSelfX()) {
+    msg = chSchMigrateCurrentS(oip);
+  }
+  else {
+    msg = chSchMigrateI(tp, oip);
+  }
+  chSysUnlock();
+
+  return msg;
+}
+#endif /* CH_CFG_USE_MIGRATION == TRUE */
+
 /**
  * @brief   Sends the current thread sleeping and sets a reference variable.
  * @note    This function must reschedule, it can only be called from thread
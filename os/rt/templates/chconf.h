@@ -49,6 +49,17 @@
 #define CH_CFG_SMP_MODE                     FALSE
 #endif
 
+/**
+ * @brief   Threads migration between instances.
+ * @details If enabled then threads can be migrated between OS instances
+ *          using @p chThdMigrate() and a periodic load balancer can be
+ *          started using @p chSchBalancerStart().
+ * @note    Requires @p CH_CFG_SMP_MODE.
+ */
+#if !defined(CH_CFG_USE_MIGRATION)
+#define CH_CFG_USE_MIGRATION                FALSE
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -445,6 +456,17 @@
 #define CH_CFG_USE_OBJ_FIFOS                TRUE
 #endif
 
+/**
+ * @brief   Lock-free rings APIs.
+ * @details If enabled then the lock-free SPSC/MPSC rings APIs are included
+ *          in the kernel.
+ *
+ * @note    The default is @p TRUE.
+ */
+#if !defined(CH_CFG_USE_RINGS)
+#define CH_CFG_USE_RINGS                    TRUE
+#endif
+
 /**
  * @brief   Pipes APIs.
  * @details If enabled then the pipes APIs are included
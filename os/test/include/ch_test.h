@@ -46,6 +46,15 @@
 #define TRUE                                (!FALSE)
 #endif
 
+/**
+ * @name    Benchmark results formats
+ * @{
+ */
+#define TEST_BENCH_FORMAT_NONE              0
+#define TEST_BENCH_FORMAT_JSON              1
+#define TEST_BENCH_FORMAT_CSV               2
+/** @} */
+
 /*===========================================================================*/
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -94,6 +103,53 @@
 #define TEST_CFG_SIZE_REPORT                TRUE
 #endif
 
+/**
+ * @brief   Benchmark results format.
+ * @details When not @p TEST_BENCH_FORMAT_NONE the test cases reporting
+ *          scores using @p test_score() are executed
+ *          @p TEST_CFG_BENCH_SAMPLES times, the output of the runs after
+ *          the first one is suppressed, then a JSON or CSV record is
+ *          emitted for each score with its minimum, median and 99th
+ *          percentile values.
+ */
+#if !defined(TEST_CFG_BENCH_FORMAT) || defined(__DOXYGEN__)
+#define TEST_CFG_BENCH_FORMAT               TEST_BENCH_FORMAT_NONE
+#endif
+
+/**
+ * @brief   Number of executions of each benchmark test case.
+ */
+#if !defined(TEST_CFG_BENCH_SAMPLES) || defined(__DOXYGEN__)
+#define TEST_CFG_BENCH_SAMPLES              5
+#endif
+
+/**
+ * @brief   Maximum number of scores reported by a test case.
+ * @note    Scores in excess are ignored.
+ */
+#if !defined(TEST_CFG_BENCH_MAX_SCORES) || defined(__DOXYGEN__)
+#define TEST_CFG_BENCH_MAX_SCORES           4
+#endif
+
+/**
+ * @brief   Enables the comparison against a baseline.
+ * @details The application provides the @p test_bench_baseline[] array,
+ *          the median of each score is compared with the baseline value.
+ */
+#if !defined(TEST_CFG_BENCH_USE_BASELINE) || defined(__DOXYGEN__)
+#define TEST_CFG_BENCH_USE_BASELINE         FALSE
+#endif
+
+/**
+ * @brief   Regression threshold in percent.
+ * @details A score whose median is lower than the baseline value by more
+ *          than this threshold is a regression and fails the test case.
+ * @note    Scores are rates, higher values are better.
+ */
+#if !defined(TEST_CFG_BENCH_THRESHOLD) || defined(__DOXYGEN__)
+#define TEST_CFG_BENCH_THRESHOLD            5
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -114,6 +170,20 @@
 #error "TEST_CFG_DELAY_BETWEEN_TESTS requires TEST_CFG_CHIBIOS_SUPPORT"
 #endif
 
+#if (TEST_CFG_BENCH_FORMAT != TEST_BENCH_FORMAT_NONE) &&                    \
+    (TEST_CFG_BENCH_FORMAT != TEST_BENCH_FORMAT_JSON) &&                    \
+    (TEST_CFG_BENCH_FORMAT != TEST_BENCH_FORMAT_CSV)
+#error "invalid TEST_CFG_BENCH_FORMAT value"
+#endif
+
+#if (TEST_CFG_BENCH_SAMPLES < 1) || (TEST_CFG_BENCH_MAX_SCORES < 1)
+#error "invalid TEST_CFG_BENCH_SAMPLES or TEST_CFG_BENCH_MAX_SCORES value"
+#endif
+
+#if (TEST_CFG_BENCH_THRESHOLD < 0) || (TEST_CFG_BENCH_THRESHOLD > 100)
+#error "invalid TEST_CFG_BENCH_THRESHOLD value"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -162,6 +232,24 @@ typedef struct {
    */
   BaseSequentialStream *stream;
 #endif
+#if (TEST_CFG_BENCH_FORMAT != TEST_BENCH_FORMAT_NONE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Benchmark sample being executed.
+   */
+  unsigned          bench_sample;
+  /**
+   * @brief   Number of scores reported in the current sample.
+   */
+  unsigned          bench_nscores;
+  /**
+   * @brief   Units of the reported scores.
+   */
+  const char        *bench_units[TEST_CFG_BENCH_MAX_SCORES];
+  /**
+   * @brief   Scores of each sample.
+   */
+  uint32_t          bench_values[TEST_CFG_BENCH_MAX_SCORES][TEST_CFG_BENCH_SAMPLES];
+#endif
 } ch_test_context_t;
 
 /**
@@ -190,6 +278,17 @@ typedef struct {
   const testsequence_t * const * sequences; /**< @brief Test sequences array.           */
 } testsuite_t;
 
+/**
+ * @brief   Type of a benchmark baseline entry.
+ */
+typedef struct {
+  const char        *suite;         /**< @brief Name of the test suite.     */
+  unsigned          sequence;       /**< @brief Test sequence number.       */
+  unsigned          tcase;          /**< @brief Test case number.           */
+  unsigned          score;          /**< @brief Score index in the case.    */
+  uint32_t          value;          /**< @brief Reference median value.     */
+} test_bench_baseline_t;
+
 /**
  * @brief   Type of a test suite.
  */
@@ -295,6 +394,9 @@ typedef struct {
 
 #if !defined(__DOXYGEN__)
 extern ch_test_context_t chtest;
+#if TEST_CFG_BENCH_USE_BASELINE == TRUE
+extern const test_bench_baseline_t test_bench_baseline[];
+#endif
 #endif
 
 #ifdef __cplusplus
@@ -312,6 +414,7 @@ extern "C" {
   int test_vprintf(const char *fmt, va_list ap);
   int test_printf(const char *fmt, ...);
   void test_emit_token(char token);
+  void test_score(uint32_t value, const char *unit);
   bool test_execute_putchar(test_putchar_t putfunc,
                             const testsuite_t *tsp);
 #if TEST_CFG_CHIBIOS_SUPPORT == TRUE
@@ -116,6 +116,202 @@ static void test_print_fat_line(void) {
   test_print_string(TEST_CFG_EOL_STRING);
 }
 
+#if (TEST_CFG_BENCH_FORMAT != TEST_BENCH_FORMAT_NONE) || defined(__DOXYGEN__)
+static void test_print_quoted(const char *s) {
+  char c;
+
+  test_putchar('"');
+  while ((c = *s) != '\0') {
+    if (c == '"') {
+#if TEST_CFG_BENCH_FORMAT == TEST_BENCH_FORMAT_JSON
+      test_putchar('\\');
+#else
+      test_putchar('"');
+#endif
+    }
+    test_putchar(c);
+    s++;
+  }
+  test_putchar('"');
+}
+
+static void test_bench_sort(uint32_t *values, unsigned n) {
+  unsigned i, j;
+
+  for (i = 1U; i < n; i++) {
+    uint32_t v = values[i];
+
+    for (j = i; (j > 0U) && (values[j - 1U] > v); j--) {
+      values[j] = values[j - 1U];
+    }
+    values[j] = v;
+  }
+}
+
+#if (TEST_CFG_BENCH_USE_BASELINE == TRUE) || defined(__DOXYGEN__)
+static bool test_str_equal(const char *s1, const char *s2) {
+
+  while (*s1 == *s2) {
+    if (*s1 == '\0') {
+      return true;
+    }
+    s1++;
+    s2++;
+  }
+
+  return false;
+}
+
+static const test_bench_baseline_t *test_bench_find(const char *suite,
+                                                    unsigned tseq,
+                                                    unsigned tcase,
+                                                    unsigned score) {
+  const test_bench_baseline_t *bp = test_bench_baseline;
+
+  while (bp->suite != NULL) {
+    if ((bp->sequence == tseq) && (bp->tcase == tcase) &&
+        (bp->score == score) && test_str_equal(bp->suite, suite)) {
+      return bp;
+    }
+    bp++;
+  }
+
+  return NULL;
+}
+#endif
+
+static void test_bench_header(void) {
+
+#if TEST_CFG_BENCH_FORMAT == TEST_BENCH_FORMAT_CSV
+  test_printf("record,suite,case,name,score,unit,samples,min,median,p99,"
+              "baseline,delta,status"TEST_CFG_EOL_STRING);
+#endif
+}
+
+/**
+ * @brief   Benchmark samples and records.
+ * @details The test case has already been executed once, if it reported
+ *          scores it is executed again with the output suppressed until
+ *          all the samples are collected, then a record is emitted for
+ *          each score.
+ *
+ * @param[in] tsp       test suite being executed
+ * @param[in] tseq      test sequence index
+ * @param[in] tcase     test case index
+ */
+static void test_bench_case(const testsuite_t *tsp,
+                            unsigned tseq, unsigned tcase) {
+  const testcase_t *tcp = tsp->sequences[tseq]->cases[tcase];
+  const char *suite = tsp->name != NULL ? tsp->name : "";
+  test_putchar_t putfunc;
+  unsigned nscores, nsamples, i;
+
+  nscores = chtest.bench_nscores;
+  if (nscores == 0U) {
+    return;
+  }
+
+  /* Further samples, output suppressed.*/
+  putfunc        = chtest.putchar;
+  chtest.putchar = NULL;
+  for (nsamples = 1U; nsamples < (unsigned)TEST_CFG_BENCH_SAMPLES; nsamples++) {
+    if (chtest.local_fail || (chtest.bench_nscores < nscores)) {
+      break;
+    }
+    chtest.bench_sample  = nsamples;
+    chtest.bench_nscores = 0U;
+    test_execute_case(tcp);
+  }
+  chtest.putchar = putfunc;
+  if (chtest.local_fail) {
+    return;
+  }
+  if (chtest.bench_nscores < nscores) {
+    /* Last sample incomplete.*/
+    nsamples--;
+  }
+
+  for (i = 0U; i < nscores; i++) {
+    uint32_t *values = chtest.bench_values[i];
+    uint32_t median, baseline = 0U;
+    const char *status = "new";
+    int delta = 0;
+
+    test_bench_sort(values, nsamples);
+    if ((nsamples & 1U) != 0U) {
+      median = values[nsamples / 2U];
+    }
+    else {
+      median = (uint32_t)(((uint64_t)values[(nsamples / 2U) - 1U] +
+                           (uint64_t)values[nsamples / 2U]) / 2U);
+    }
+
+#if TEST_CFG_BENCH_USE_BASELINE == TRUE
+    {
+      const test_bench_baseline_t *bp = test_bench_find(suite, tseq + 1U,
+                                                        tcase + 1U, i);
+
+      if ((bp != NULL) && (bp->value > 0U)) {
+        baseline = bp->value;
+        delta    = (int)((((int64_t)median - (int64_t)baseline) * 1000) /
+                         (int64_t)baseline);
+        if (((uint64_t)median * 100U) <
+            ((uint64_t)baseline * (100U - TEST_CFG_BENCH_THRESHOLD))) {
+          status = "regression";
+          __test_fail("benchmark regression");
+        }
+        else {
+          status = "ok";
+        }
+      }
+    }
+#endif
+
+#if TEST_CFG_BENCH_FORMAT == TEST_BENCH_FORMAT_JSON
+    test_printf("{\"suite\":");
+    test_print_quoted(suite);
+    test_printf(",\"case\":\"%u.%u\",\"name\":", tseq + 1U, tcase + 1U);
+    test_print_quoted(tcp->name);
+    test_printf(",\"score\":%u,\"unit\":", i);
+    test_print_quoted(chtest.bench_units[i]);
+    test_printf(",\"samples\":%u,\"min\":%u,\"median\":%u,\"p99\":%u,",
+                nsamples, (unsigned)values[0], (unsigned)median,
+                (unsigned)values[(((nsamples * 99U) + 99U) / 100U) - 1U]);
+    if (baseline > 0U) {
+      test_printf("\"baseline\":%u,\"delta\":%s%d.%d,",
+                  (unsigned)baseline, delta < 0 ? "-" : "",
+                  (delta < 0 ? -delta : delta) / 10,
+                  (delta < 0 ? -delta : delta) % 10);
+    }
+    else {
+      test_printf("\"baseline\":null,\"delta\":null,");
+    }
+    test_printf("\"status\":\"%s\"}"TEST_CFG_EOL_STRING, status);
+#else
+    test_printf("score,");
+    test_print_quoted(suite);
+    test_printf(",%u.%u,", tseq + 1U, tcase + 1U);
+    test_print_quoted(tcp->name);
+    test_printf(",%u,", i);
+    test_print_quoted(chtest.bench_units[i]);
+    test_printf(",%u,%u,%u,%u,",
+                nsamples, (unsigned)values[0], (unsigned)median,
+                (unsigned)values[(((nsamples * 99U) + 99U) / 100U) - 1U]);
+    if (baseline > 0U) {
+      test_printf("%u,%s%d.%d,",
+                  (unsigned)baseline, delta < 0 ? "-" : "",
+                  (delta < 0 ? -delta : delta) / 10,
+                  (delta < 0 ? -delta : delta) % 10);
+    }
+    else {
+      test_printf(",,");
+    }
+    test_printf("%s"TEST_CFG_EOL_STRING, status);
+#endif
+  }
+}
+#endif /* TEST_CFG_BENCH_FORMAT != TEST_BENCH_FORMAT_NONE */
+
 /**
  * @brief   Test execution.
  *
@@ -160,6 +356,9 @@ static bool test_execute_inner(const testsuite_t *tsp) {
   TEST_REPORT_HOOK_HEADER();
 #endif
   test_printf(TEST_CFG_EOL_STRING);
+#if TEST_CFG_BENCH_FORMAT != TEST_BENCH_FORMAT_NONE
+  test_bench_header();
+#endif
 
   chtest.global_fail = false;
   tseq = 0U;
@@ -180,8 +379,15 @@ static bool test_execute_inner(const testsuite_t *tsp) {
 #endif
 #if defined(TEST_REPORT_HOOK_TESTCASE)
       TEST_REPORT_HOOK_TESTCASE(tsp->sequences[tseq]->cases[tcase]);
+#endif
+#if TEST_CFG_BENCH_FORMAT != TEST_BENCH_FORMAT_NONE
+      chtest.bench_sample  = 0U;
+      chtest.bench_nscores = 0U;
 #endif
       test_execute_case(tsp->sequences[tseq]->cases[tcase]);
+#if TEST_CFG_BENCH_FORMAT != TEST_BENCH_FORMAT_NONE
+      test_bench_case(tsp, tseq, tcase);
+#endif
       if (chtest.local_fail) {
         test_printf("--- Result: FAILURE (#%u [", chtest.current_step, "", chtest.failure_message);
         test_print_tokens();
@@ -267,6 +473,31 @@ void test_emit_token(char token) {
   }
 }
 
+/**
+ * @brief   Reports a benchmark score.
+ * @details In benchmark mode the score is recorded for the current sample,
+ *          else the function does nothing, the score is normally also
+ *          printed by the test case.
+ *
+ * @param[in] value     score value, higher values are better
+ * @param[in] unit      score unit as string
+ *
+ * @api
+ */
+void test_score(uint32_t value, const char *unit) {
+
+#if TEST_CFG_BENCH_FORMAT != TEST_BENCH_FORMAT_NONE
+  if (chtest.bench_nscores < (unsigned)TEST_CFG_BENCH_MAX_SCORES) {
+    chtest.bench_units[chtest.bench_nscores] = unit;
+    chtest.bench_values[chtest.bench_nscores][chtest.bench_sample] = value;
+    chtest.bench_nscores++;
+  }
+#else
+  (void)value;
+  (void)unit;
+#endif
+}
+
 /**
  * @brief   Test execution with char output.
  *
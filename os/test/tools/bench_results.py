@@ -0,0 +1,120 @@
+#!/usr/bin/env python
+
+"""Benchmark results of the test framework.
+
+Extracts the JSON or CSV benchmark records from a test log, compares two
+logs or generates the C baseline array used by TEST_CFG_BENCH_USE_BASELINE.
+"""
+
+import argparse
+import csv
+import json
+import sys
+
+CSV_FIELDS = ['record', 'suite', 'case', 'name', 'score', 'unit', 'samples',
+              'min', 'median', 'p99', 'baseline', 'delta', 'status']
+
+
+def parse(path):
+    """Returns the records of a log as a dictionary keyed by score."""
+    records = {}
+    f = sys.stdin if path == '-' else open(path)
+    with f:
+        for line in f:
+            line = line.strip()
+            if line.startswith('{"suite"'):
+                rec = json.loads(line)
+            elif line.startswith('score,'):
+                rec = dict(zip(CSV_FIELDS, next(csv.reader([line]))))
+                for field in ('score', 'samples', 'min', 'median', 'p99'):
+                    rec[field] = int(rec[field])
+            else:
+                continue
+            records[(rec['suite'], rec['case'], rec['score'])] = rec
+    return records
+
+
+def case_key(key):
+    suite, case, score = key
+    return (suite, [int(n) for n in case.split('.')], score)
+
+
+def cmd_show(args):
+    records = parse(args.log)
+    for key in sorted(records, key=case_key):
+        rec = records[key]
+        print('{:6} {:40.40} {:>12} {:>12} {:>12}  {}'.format(
+            rec['case'], rec['name'], rec['min'], rec['median'], rec['p99'],
+            rec['unit']))
+    return 0
+
+
+def cmd_compare(args):
+    base = parse(args.baseline)
+    new = parse(args.log)
+    regressions = 0
+    for key in sorted(new, key=case_key):
+        rec = new[key]
+        if key not in base or base[key]['median'] == 0:
+            status, delta = 'new', ''
+        else:
+            ref = base[key]['median']
+            change = (rec['median'] - ref) * 100.0 / ref
+            delta = '{:+.1f}%'.format(change)
+            if change < -args.threshold:
+                status = 'REGRESSION'
+                regressions += 1
+            else:
+                status = 'ok'
+        print('{:6} {:40.40} {:>12} {:>8}  {:10} {}'.format(
+            rec['case'], rec['name'], rec['median'], delta, status,
+            rec['unit']))
+    for key in sorted(set(base) - set(new), key=case_key):
+        print('{:6} {:40.40} {:>12} {:>8}  {:10} {}'.format(
+            base[key]['case'], base[key]['name'], '', '', 'missing',
+            base[key]['unit']))
+    print('{} scores, {} regressions'.format(len(new), regressions))
+    return 1 if regressions else 0
+
+
+def cmd_baseline(args):
+    records = parse(args.log)
+    out = sys.stdout if args.output == '-' else open(args.output, 'w')
+    with out:
+        out.write('/* Generated by bench_results.py, do not edit.*/\n\n')
+        out.write('#include "ch_test.h"\n\n')
+        out.write('const test_bench_baseline_t test_bench_baseline[] = {\n')
+        for key in sorted(records, key=case_key):
+            rec = records[key]
+            seq, case = rec['case'].split('.')
+            out.write('  {{{}, {}U, {}U, {}U, {}U}}, /* {} */\n'.format(
+                json.dumps(rec['suite']), seq, case, rec['score'],
+                rec['median'], rec['unit']))
+        out.write('  {NULL, 0U, 0U, 0U, 0U}\n')
+        out.write('};\n')
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    sub = parser.add_subparsers(dest='command')
+    sub.required = True
+    p = sub.add_parser('show', help='list the records of a log')
+    p.add_argument('log', help='test log, - for stdin')
+    p.set_defaults(func=cmd_show)
+    p = sub.add_parser('compare', help='compare a log with a baseline log')
+    p.add_argument('baseline', help='baseline test log')
+    p.add_argument('log', help='test log, - for stdin')
+    p.add_argument('-t', '--threshold', type=float, default=5.0,
+                   help='regression threshold in percent (default 5)')
+    p.set_defaults(func=cmd_compare)
+    p = sub.add_parser('baseline', help='generate the C baseline array')
+    p.add_argument('log', help='test log, - for stdin')
+    p.add_argument('-o', '--output', default='-', help='output C file')
+    p.set_defaults(func=cmd_baseline)
+    args = parser.parse_args()
+    sys.exit(args.func(args))
+
+
+if __name__ == '__main__':
+    main()
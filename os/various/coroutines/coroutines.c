@@ -0,0 +1,608 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    coroutines.c
+ * @brief   Stackless coroutines code.
+ *
+ * @addtogroup COROUTINES
+ * @{
+ */
+
+#include "ch.h"
+#include "coroutines.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Inserts a task in the ready queue and wakes up the executor.
+ *
+ * @param[in] ctp       pointer to the @p co_task_t structure
+ */
+static void co_ready_i(co_task_t *ctp) {
+  co_executor_t *cxp = ctp->executor;
+
+  ch_queue_insert(&cxp->ready, &ctp->queue);
+  if (cxp->thread != NULL) {
+    chEvtSignalI(cxp->thread, CO_WAKEUP_EVENT);
+  }
+}
+
+/**
+ * @brief   Moves all the elements of a queue at the end of another queue.
+ *
+ * @param[in] qp        pointer to the destination queue header
+ * @param[in] from      pointer to the source queue header, it is left empty
+ */
+static void co_queue_move_all(ch_queue_t *qp, ch_queue_t *from) {
+
+  if (ch_queue_notempty(from)) {
+    from->next->prev = qp->prev;
+    qp->prev->next   = from->next;
+    from->prev->next = qp;
+    qp->prev         = from->prev;
+    ch_queue_init(from);
+  }
+}
+
+/**
+ * @brief   Tasks timer callback.
+ *
+ * @param[in] vtp       pointer to the @p virtual_timer_t structure
+ * @param[in] p         pointer to the @p co_task_t structure
+ */
+static void co_wakeup(virtual_timer_t *vtp, void *p) {
+
+  (void)vtp;
+
+  chSysLockFromISR();
+  co_ready_i((co_task_t *)p);
+  chSysUnlockFromISR();
+}
+
+/**
+ * @brief   Delivers the pending events to a task, if any.
+ *
+ * @param[in] cxp       pointer to the @p co_executor_t structure
+ * @param[in] ctp       pointer to the @p co_task_t structure
+ * @return              The delivery result.
+ * @retval false        if none of the awaited events is pending.
+ * @retval true         if events have been delivered to the task.
+ */
+static bool co_deliver(co_executor_t *cxp, co_task_t *ctp) {
+  eventmask_t m = cxp->events & ctp->ewmask;
+
+  if (m == (eventmask_t)0) {
+    return false;
+  }
+
+  ctp->events = m;
+  cxp->events &= ~m;
+
+  return true;
+}
+
+/**
+ * @brief   Fetches the events signaled to the executor thread.
+ *
+ * @param[in] cxp       pointer to the @p co_executor_t structure
+ * @param[in] events    events already fetched
+ */
+static void co_fetch_events(co_executor_t *cxp, eventmask_t events) {
+
+  events |= chEvtGetAndClearEvents(ALL_EVENTS);
+  cxp->events |= events & ~CO_WAKEUP_EVENT;
+}
+
+/**
+ * @brief   Runs a task until its next suspension point.
+ *
+ * @param[in] cxp       pointer to the @p co_executor_t structure
+ * @param[in] ctp       pointer to the @p co_task_t structure
+ * @return              The progress state.
+ * @retval false        if the task is still polling the same condition.
+ * @retval true         if the task made progress.
+ */
+static bool co_run(co_executor_t *cxp, co_task_t *ctp) {
+  co_lc_t lc = ctp->lc;
+  co_status_t sts = ctp->func(ctp);
+
+  switch (sts) {
+  case CO_READY:
+    /* Yielded tasks are run again in the next pass.*/
+    ch_queue_insert(&cxp->deferred, &ctp->queue);
+    break;
+  case CO_SLEEPING:
+    /* The timer callback is going to make it ready again.*/
+    break;
+  case CO_WAITING:
+    co_fetch_events(cxp, (eventmask_t)0);
+    if (co_deliver(cxp, ctp)) {
+      chSysLock();
+      ch_queue_insert(&cxp->ready, &ctp->queue);
+      chSysUnlock();
+    }
+    else {
+      ch_queue_insert(&cxp->waiting, &ctp->queue);
+    }
+    break;
+  case CO_POLLING:
+    ch_queue_insert(&cxp->deferred, &ctp->queue);
+    break;
+  case CO_SUSPENDED:
+    /* The object signal is going to make it ready again.*/
+    break;
+  default:
+    chSysLock();
+    cxp->tasks--;
+    chSysUnlock();
+    break;
+  }
+
+  return (bool)((sts != CO_POLLING) || (ctp->lc != lc));
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Suspends a task for the specified time interval.
+ *
+ * @param[in] ctp       pointer to the @p co_task_t structure
+ * @param[in] delay     the delay in system ticks
+ * @return              The task status.
+ *
+ * @notapi
+ */
+co_status_t __co_sleep(co_task_t *ctp, sysinterval_t delay) {
+
+  if (delay == TIME_IMMEDIATE) {
+    return CO_READY;
+  }
+
+  chVTSet(&ctp->vt, delay, co_wakeup, (void *)ctp);
+
+  return CO_SLEEPING;
+}
+
+/**
+ * @brief   Waits on a coroutine semaphore.
+ *
+ * @param[in] ctp       pointer to the @p co_task_t structure
+ * @param[in] csp       pointer to a @p co_semaphore_t structure
+ * @return              The wait state.
+ * @retval false        if the semaphore has been taken immediately.
+ * @retval true         if the task has been queued on the semaphore.
+ *
+ * @notapi
+ */
+bool __co_sem_wait(co_task_t *ctp, co_semaphore_t *csp) {
+  bool queued;
+
+  chSysLock();
+  queued = (bool)(--csp->cnt < (cnt_t)0);
+  if (queued) {
+    ch_queue_insert(&csp->queue, &ctp->queue);
+  }
+  chSysUnlock();
+
+  return queued;
+}
+
+/**
+ * @brief   Removes a message from a coroutine mailbox.
+ * @pre     A message slot has been taken by waiting on @p fullsem.
+ *
+ * @param[in] cmbp      pointer to a @p co_mailbox_t structure
+ * @return              The fetched message.
+ *
+ * @notapi
+ */
+msg_t __co_mb_fetch(co_mailbox_t *cmbp) {
+  msg_t msg;
+
+  chSysLock();
+  msg = *cmbp->rdptr++;
+  if (cmbp->rdptr >= cmbp->top) {
+    cmbp->rdptr = cmbp->buffer;
+  }
+  coSemSignalI(&cmbp->emptysem);
+  chSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Inserts a message into a coroutine mailbox.
+ * @pre     A free slot has been taken by waiting on @p emptysem.
+ *
+ * @param[in] cmbp      pointer to a @p co_mailbox_t structure
+ * @param[in] msg       the message to be posted
+ *
+ * @notapi
+ */
+void __co_mb_post(co_mailbox_t *cmbp, msg_t msg) {
+
+  chSysLock();
+  *cmbp->wrptr++ = msg;
+  if (cmbp->wrptr >= cmbp->top) {
+    cmbp->wrptr = cmbp->buffer;
+  }
+  coSemSignalI(&cmbp->fullsem);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Initializes a coroutine executor.
+ *
+ * @param[out] cxp      pointer to a @p co_executor_t structure
+ *
+ * @init
+ */
+void coExecutorObjectInit(co_executor_t *cxp) {
+
+  cxp->thread = NULL;
+  cxp->tasks  = (ucnt_t)0;
+  ch_queue_init(&cxp->ready);
+  ch_queue_init(&cxp->waiting);
+  ch_queue_init(&cxp->deferred);
+  cxp->events = (eventmask_t)0;
+}
+
+/**
+ * @brief   Runs the executor in the context of the calling thread.
+ * @details The function returns when all the started tasks have terminated.
+ *
+ * @param[in] cxp       pointer to a @p co_executor_t structure
+ *
+ * @api
+ */
+void coExecutorRun(co_executor_t *cxp) {
+
+  chDbgCheck(cxp != NULL);
+
+  chSysLock();
+  cxp->thread = chThdGetSelfX();
+  while (cxp->tasks > (ucnt_t)0) {
+    eventmask_t events;
+    sysinterval_t timeout;
+    bool progress = false;
+
+    /* Running all the ready tasks.*/
+    while (ch_queue_notempty(&cxp->ready)) {
+      co_task_t *ctp = (co_task_t *)ch_queue_fifo_remove(&cxp->ready);
+
+      chSysUnlock();
+      progress |= co_run(cxp, ctp);
+      chSysLock();
+    }
+    chSysUnlock();
+
+    /* Nothing to do, waiting for events or for the next polling. If some
+       task made progress then the polled conditions could have changed
+       and the polling is repeated immediately.*/
+    if (progress) {
+      timeout = TIME_IMMEDIATE;
+    }
+    else if (ch_queue_notempty(&cxp->deferred)) {
+      timeout = CO_POLL_INTERVAL;
+    }
+    else {
+      timeout = TIME_INFINITE;
+    }
+    events = chEvtWaitAnyTimeout(ALL_EVENTS, timeout);
+    co_fetch_events(cxp, events);
+
+    /* Delivering the received events to the waiting tasks, the waiting
+       and deferred queues are only accessed by the executor so the scan
+       is performed outside the kernel lock.*/
+    if (cxp->events != (eventmask_t)0) {
+      ch_queue_t *qp = cxp->waiting.next;
+
+      while (qp != &cxp->waiting) {
+        co_task_t *ctp = (co_task_t *)qp;
+
+        qp = qp->next;
+        if (co_deliver(cxp, ctp)) {
+          ch_queue_insert(&cxp->deferred, ch_queue_dequeue(&ctp->queue));
+        }
+      }
+    }
+
+    /* Awakened, yielded and polling tasks get another chance.*/
+    chSysLock();
+    co_queue_move_all(&cxp->ready, &cxp->deferred);
+  }
+  cxp->thread = NULL;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Awakens the executor.
+ * @details Tasks polling a condition are evaluated again, this function can
+ *          be used by producers in order to reduce the polling latency.
+ *
+ * @param[in] cxp       pointer to a @p co_executor_t structure
+ *
+ * @iclass
+ */
+void coExecutorNotifyI(co_executor_t *cxp) {
+
+  chDbgCheckClassI();
+
+  if (cxp->thread != NULL) {
+    chEvtSignalI(cxp->thread, CO_WAKEUP_EVENT);
+  }
+}
+
+/**
+ * @brief   Awakens the executor.
+ * @details Tasks polling a condition are evaluated again, this function can
+ *          be used by producers in order to reduce the polling latency.
+ *
+ * @param[in] cxp       pointer to a @p co_executor_t structure
+ *
+ * @api
+ */
+void coExecutorNotify(co_executor_t *cxp) {
+
+  chSysLock();
+  coExecutorNotifyI(cxp);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Starts a task on an executor.
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel. Note that
+ *          interrupt handlers always reschedule on exit so an explicit
+ *          reschedule must not be performed in ISRs.
+ *
+ * @param[in] cxp       pointer to a @p co_executor_t structure
+ * @param[out] ctp      pointer to a @p co_task_t structure
+ * @param[in] func      the coroutine function
+ * @param[in] arg       an argument passed to the coroutine
+ *
+ * @iclass
+ */
+void coTaskStartI(co_executor_t *cxp, co_task_t *ctp,
+                  co_function_t func, void *arg) {
+
+  chDbgCheckClassI();
+  chDbgCheck((cxp != NULL) && (ctp != NULL) && (func != NULL));
+
+  ctp->executor = cxp;
+  ctp->func     = func;
+  ctp->arg      = arg;
+  ctp->lc       = (co_lc_t)0;
+  ctp->ewmask   = (eventmask_t)0;
+  ctp->events   = (eventmask_t)0;
+  chVTObjectInit(&ctp->vt);
+  cxp->tasks++;
+  co_ready_i(ctp);
+}
+
+/**
+ * @brief   Starts a task on an executor.
+ *
+ * @param[in] cxp       pointer to a @p co_executor_t structure
+ * @param[out] ctp      pointer to a @p co_task_t structure
+ * @param[in] func      the coroutine function
+ * @param[in] arg       an argument passed to the coroutine
+ *
+ * @api
+ */
+void coTaskStart(co_executor_t *cxp, co_task_t *ctp,
+                 co_function_t func, void *arg) {
+
+  chSysLock();
+  coTaskStartI(cxp, ctp, func, arg);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Initializes a coroutine semaphore.
+ *
+ * @param[out] csp      pointer to a @p co_semaphore_t structure
+ * @param[in] n         initial value of the semaphore counter, must be
+ *                      non-negative
+ *
+ * @init
+ */
+void coSemObjectInit(co_semaphore_t *csp, cnt_t n) {
+
+  chDbgCheck((csp != NULL) && (n >= (cnt_t)0));
+
+  ch_queue_init(&csp->queue);
+  csp->cnt = n;
+}
+
+/**
+ * @brief   Signals a coroutine semaphore.
+ * @details The first waiting task, if any, is made ready on its executor.
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel. Note that
+ *          interrupt handlers always reschedule on exit so an explicit
+ *          reschedule must not be performed in ISRs.
+ *
+ * @param[in] csp       pointer to a @p co_semaphore_t structure
+ *
+ * @iclass
+ */
+void coSemSignalI(co_semaphore_t *csp) {
+
+  chDbgCheckClassI();
+  chDbgCheck(csp != NULL);
+
+  if (++csp->cnt <= (cnt_t)0) {
+    co_ready_i((co_task_t *)ch_queue_fifo_remove(&csp->queue));
+  }
+}
+
+/**
+ * @brief   Signals a coroutine semaphore.
+ * @details The first waiting task, if any, is made ready on its executor.
+ *
+ * @param[in] csp       pointer to a @p co_semaphore_t structure
+ *
+ * @api
+ */
+void coSemSignal(co_semaphore_t *csp) {
+
+  chSysLock();
+  coSemSignalI(csp);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Initializes a coroutine mailbox.
+ *
+ * @param[out] cmbp     pointer to a @p co_mailbox_t structure
+ * @param[in] buf       pointer to the messages buffer as an array of
+ *                      @p msg_t
+ * @param[in] n         number of elements in the buffer array
+ *
+ * @init
+ */
+void coMBObjectInit(co_mailbox_t *cmbp, msg_t *buf, size_t n) {
+
+  chDbgCheck((cmbp != NULL) && (buf != NULL) && (n > (size_t)0));
+
+  cmbp->buffer = buf;
+  cmbp->top    = &buf[n];
+  cmbp->wrptr  = buf;
+  cmbp->rdptr  = buf;
+  coSemObjectInit(&cmbp->fullsem, (cnt_t)0);
+  coSemObjectInit(&cmbp->emptysem, (cnt_t)n);
+}
+
+/**
+ * @brief   Posts a message into a coroutine mailbox.
+ * @details This function does not wait, it fails if the mailbox is full.
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel. Note that
+ *          interrupt handlers always reschedule on exit so an explicit
+ *          reschedule must not be performed in ISRs.
+ *
+ * @param[in] cmbp      pointer to a @p co_mailbox_t structure
+ * @param[in] msg       the message to be posted
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly posted.
+ * @retval MSG_TIMEOUT  if the mailbox is full.
+ *
+ * @iclass
+ */
+msg_t coMBPostI(co_mailbox_t *cmbp, msg_t msg) {
+
+  chDbgCheckClassI();
+  chDbgCheck(cmbp != NULL);
+
+  if (cmbp->emptysem.cnt <= (cnt_t)0) {
+    return MSG_TIMEOUT;
+  }
+
+  cmbp->emptysem.cnt--;
+  *cmbp->wrptr++ = msg;
+  if (cmbp->wrptr >= cmbp->top) {
+    cmbp->wrptr = cmbp->buffer;
+  }
+  coSemSignalI(&cmbp->fullsem);
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Posts a message into a coroutine mailbox.
+ * @details This function does not wait, it fails if the mailbox is full.
+ *
+ * @param[in] cmbp      pointer to a @p co_mailbox_t structure
+ * @param[in] msg       the message to be posted
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly posted.
+ * @retval MSG_TIMEOUT  if the mailbox is full.
+ *
+ * @api
+ */
+msg_t coMBPost(co_mailbox_t *cmbp, msg_t msg) {
+  msg_t rdymsg;
+
+  chSysLock();
+  rdymsg = coMBPostI(cmbp, msg);
+  chSchRescheduleS();
+  chSysUnlock();
+
+  return rdymsg;
+}
+
+/**
+ * @brief   Fetches a message from a coroutine mailbox.
+ * @details This function does not wait, it fails if the mailbox is empty.
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel. Note that
+ *          interrupt handlers always reschedule on exit so an explicit
+ *          reschedule must not be performed in ISRs.
+ *
+ * @param[in] cmbp      pointer to a @p co_mailbox_t structure
+ * @param[out] msgp     pointer to a message variable for the received
+ *                      message
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly fetched.
+ * @retval MSG_TIMEOUT  if the mailbox is empty.
+ *
+ * @iclass
+ */
+msg_t coMBFetchI(co_mailbox_t *cmbp, msg_t *msgp) {
+
+  chDbgCheckClassI();
+  chDbgCheck((cmbp != NULL) && (msgp != NULL));
+
+  if (cmbp->fullsem.cnt <= (cnt_t)0) {
+    return MSG_TIMEOUT;
+  }
+
+  cmbp->fullsem.cnt--;
+  *msgp = *cmbp->rdptr++;
+  if (cmbp->rdptr >= cmbp->top) {
+    cmbp->rdptr = cmbp->buffer;
+  }
+  coSemSignalI(&cmbp->emptysem);
+
+  return MSG_OK;
+}
+
+/** @} */
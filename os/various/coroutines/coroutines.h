@@ -0,0 +1,464 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    coroutines.h
+ * @brief   Stackless coroutines header.
+ * @details Stackless coroutines are small state machines written as
+ *          sequential code, many coroutines are multiplexed by an executor
+ *          running on a single RT thread.<br>
+ *          A coroutine is a function returning a @p co_status_t, its body
+ *          must be enclosed between @p CO_BEGIN() and @p CO_END() and it
+ *          can suspend itself using the @p CO_ macros.
+ * @note    Local variables are not preserved across suspension points,
+ *          the coroutine state must be kept in the structure pointed by
+ *          the task argument.
+ * @note    The @p CO_ macros cannot be used inside @p switch statements.
+ *
+ * @addtogroup COROUTINES
+ * @{
+ */
+
+#ifndef COROUTINES_H
+#define COROUTINES_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Event flag used internally for executor wake-ups.
+ * @note    This flag cannot be used by tasks.
+ */
+#if !defined(CO_WAKEUP_EVENT) || defined(__DOXYGEN__)
+#define CO_WAKEUP_EVENT             EVENT_MASK(31)
+#endif
+
+/**
+ * @brief   Polling interval for tasks waiting in @p CO_WAIT_UNTIL().
+ * @note    Those tasks are also polled each time the executor is awakened,
+ *          see @p coExecutorNotify().
+ * @note    Tasks waiting on coroutine semaphores or mailboxes are not
+ *          polled, they are made ready by the object signal.
+ */
+#if !defined(CO_POLL_INTERVAL) || defined(__DOXYGEN__)
+#define CO_POLL_INTERVAL            ((sysinterval_t)1)
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*
+ * Module dependencies check.
+ */
+#if !CH_CFG_USE_EVENTS
+#error "Coroutines require CH_CFG_USE_EVENTS"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a coroutine status.
+ */
+typedef enum {
+  CO_TERMINATED = 0,                /**< Task terminated.                   */
+  CO_READY = 1,                     /**< Task yielded, still ready.         */
+  CO_SLEEPING = 2,                  /**< Task waiting for its timer.        */
+  CO_WAITING = 3,                   /**< Task waiting for events.           */
+  CO_POLLING = 4,                   /**< Task polling a condition.          */
+  CO_SUSPENDED = 5                  /**< Task queued on an object.          */
+} co_status_t;
+
+/**
+ * @brief   Type of a coroutine local continuation.
+ */
+typedef unsigned co_lc_t;
+
+/**
+ * @brief   Type of a coroutine task.
+ */
+typedef struct co_task co_task_t;
+
+/**
+ * @brief   Type of a coroutine executor.
+ */
+typedef struct co_executor co_executor_t;
+
+/**
+ * @brief   Type of a coroutine function.
+ */
+typedef co_status_t (*co_function_t)(co_task_t *ctp);
+
+/**
+ * @brief   Structure representing a coroutine task.
+ */
+struct co_task {
+  /**
+   * @brief   Executor or object queues element, must be the first field.
+   */
+  ch_queue_t            queue;
+  /**
+   * @brief   Executor this task belongs to.
+   */
+  co_executor_t         *executor;
+  /**
+   * @brief   Coroutine function.
+   */
+  co_function_t         func;
+  /**
+   * @brief   Coroutine argument.
+   */
+  void                  *arg;
+  /**
+   * @brief   Local continuation, zero when starting.
+   */
+  co_lc_t               lc;
+  /**
+   * @brief   Events the task is waiting for.
+   */
+  eventmask_t           ewmask;
+  /**
+   * @brief   Events received by the last @p CO_WAIT_EVENTS().
+   */
+  eventmask_t           events;
+  /**
+   * @brief   Timer used by @p CO_SLEEP().
+   */
+  virtual_timer_t       vt;
+};
+
+/**
+ * @brief   Structure representing a coroutine executor.
+ */
+struct co_executor {
+  /**
+   * @brief   Thread running the executor, @p NULL if not running.
+   */
+  thread_t              *thread;
+  /**
+   * @brief   Number of tasks not yet terminated.
+   */
+  ucnt_t                tasks;
+  /**
+   * @brief   Ready tasks queue.
+   * @note    Accessed from ISR context, it is protected by the kernel lock.
+   */
+  ch_queue_t            ready;
+  /**
+   * @brief   Tasks waiting for events.
+   */
+  ch_queue_t            waiting;
+  /**
+   * @brief   Tasks to be run again in the next pass, yielded tasks and
+   *          tasks polling a condition.
+   */
+  ch_queue_t            deferred;
+  /**
+   * @brief   Events received and not yet delivered to tasks.
+   */
+  eventmask_t           events;
+};
+
+/**
+ * @brief   Type of a coroutine semaphore.
+ * @note    Coroutine semaphores can be waited only by tasks, threads and
+ *          ISRs can signal them.
+ */
+typedef struct {
+  /**
+   * @brief   Queue of the waiting tasks.
+   */
+  ch_queue_t            queue;
+  /**
+   * @brief   Semaphore counter, negative values are the number of waiting
+   *          tasks.
+   */
+  cnt_t                 cnt;
+} co_semaphore_t;
+
+/**
+ * @brief   Type of a coroutine mailbox.
+ * @note    Coroutine mailboxes can be waited only by tasks, threads and
+ *          ISRs can use the non-blocking functions.
+ */
+typedef struct {
+  /**
+   * @brief   Pointer to the mailbox buffer.
+   */
+  msg_t                 *buffer;
+  /**
+   * @brief   Pointer to the location after the buffer.
+   */
+  msg_t                 *top;
+  /**
+   * @brief   Write pointer.
+   */
+  msg_t                 *wrptr;
+  /**
+   * @brief   Read pointer.
+   */
+  msg_t                 *rdptr;
+  /**
+   * @brief   Messages in the mailbox.
+   */
+  co_semaphore_t        fullsem;
+  /**
+   * @brief   Free slots in the mailbox.
+   */
+  co_semaphore_t        emptysem;
+} co_mailbox_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @name    Coroutine body macros
+ * @{
+ */
+/**
+ * @brief   Coroutine body start.
+ *
+ * @param[in] ctp       pointer to the @p co_task_t structure
+ */
+#define CO_BEGIN(ctp)                                                       \
+  switch ((ctp)->lc) {                                                      \
+  case 0U:
+
+/**
+ * @brief   Coroutine body end, the task terminates.
+ *
+ * @param[in] ctp       pointer to the @p co_task_t structure
+ */
+#define CO_END(ctp)                                                         \
+  default:                                                                  \
+    break;                                                                  \
+  }                                                                         \
+  (ctp)->lc = 0U;                                                           \
+  return CO_TERMINATED
+
+/**
+ * @brief   Terminates the task.
+ *
+ * @param[in] ctp       pointer to the @p co_task_t structure
+ */
+#define CO_EXIT(ctp)                                                        \
+  do {                                                                      \
+    (ctp)->lc = 0U;                                                         \
+    return CO_TERMINATED;                                                   \
+  } while (false)
+
+/**
+ * @brief   Yields to the other ready tasks.
+ *
+ * @param[in] ctp       pointer to the @p co_task_t structure
+ */
+#define CO_YIELD(ctp)                                                       \
+  do {                                                                      \
+    (ctp)->lc = (co_lc_t)__LINE__;                                          \
+    return CO_READY;                                                        \
+  case (co_lc_t)__LINE__:;                                                  \
+  } while (false)
+
+/**
+ * @brief   Waits until a condition becomes true.
+ * @details The condition is polled by the executor, see
+ *          @p CO_POLL_INTERVAL.
+ *
+ * @param[in] ctp       pointer to the @p co_task_t structure
+ * @param[in] cond      the condition to be waited for
+ */
+#define CO_WAIT_UNTIL(ctp, cond)                                            \
+  do {                                                                      \
+    (ctp)->lc = (co_lc_t)__LINE__;                                          \
+    if (false) {                                                            \
+  case (co_lc_t)__LINE__:;                                                  \
+    }                                                                       \
+    if (!(cond)) {                                                          \
+      return CO_POLLING;                                                    \
+    }                                                                       \
+  } while (false)
+
+/**
+ * @brief   Suspends the task for the specified time interval.
+ *
+ * @param[in] ctp       pointer to the @p co_task_t structure
+ * @param[in] delay     the delay in system ticks
+ */
+#define CO_SLEEP(ctp, delay)                                                \
+  do {                                                                      \
+    (ctp)->lc = (co_lc_t)__LINE__;                                          \
+    return __co_sleep(ctp, delay);                                          \
+  case (co_lc_t)__LINE__:;                                                  \
+  } while (false)
+
+/**
+ * @brief   Waits for any of the specified events.
+ * @details Events are signaled to the executor thread, the received events
+ *          are cleared and made available in the @p events field of the
+ *          task.
+ *
+ * @param[in] ctp       pointer to the @p co_task_t structure
+ * @param[in] mask      mask of the events to be waited for
+ */
+#define CO_WAIT_EVENTS(ctp, mask)                                           \
+  do {                                                                      \
+    (ctp)->ewmask = (mask);                                                 \
+    (ctp)->lc = (co_lc_t)__LINE__;                                          \
+    return CO_WAITING;                                                      \
+  case (co_lc_t)__LINE__:;                                                  \
+  } while (false)
+
+/**
+ * @brief   Waits on a coroutine semaphore.
+ * @details If the counter is not positive the task is queued on the
+ *          semaphore and it is made ready again by the signal, it is not
+ *          polled.
+ *
+ * @param[in] ctp       pointer to the @p co_task_t structure
+ * @param[in] csp       pointer to a @p co_semaphore_t structure
+ */
+#define CO_SEM_WAIT(ctp, csp)                                               \
+  do {                                                                      \
+    (ctp)->lc = (co_lc_t)__LINE__;                                          \
+    if (__co_sem_wait(ctp, csp)) {                                          \
+      return CO_SUSPENDED;                                                  \
+  case (co_lc_t)__LINE__:;                                                  \
+    }                                                                       \
+  } while (false)
+
+/**
+ * @brief   Fetches a message from a coroutine mailbox.
+ * @details If the mailbox is empty the task waits for a message to be
+ *          posted.
+ *
+ * @param[in] ctp       pointer to the @p co_task_t structure
+ * @param[in] cmbp      pointer to a @p co_mailbox_t structure
+ * @param[out] msgp     pointer to a message variable for the received
+ *                      message
+ */
+#define CO_MB_FETCH(ctp, cmbp, msgp)                                        \
+  do {                                                                      \
+    CO_SEM_WAIT(ctp, &(cmbp)->fullsem);                                     \
+    *(msgp) = __co_mb_fetch(cmbp);                                          \
+  } while (false)
+
+/**
+ * @brief   Posts a message into a coroutine mailbox.
+ * @details If the mailbox is full the task waits for a slot to be freed.
+ * @note    The message expression is evaluated after the wait, local
+ *          variables cannot be used in it.
+ *
+ * @param[in] ctp       pointer to the @p co_task_t structure
+ * @param[in] cmbp      pointer to a @p co_mailbox_t structure
+ * @param[in] m         message to be posted
+ */
+#define CO_MB_POST(ctp, cmbp, m)                                            \
+  do {                                                                      \
+    CO_SEM_WAIT(ctp, &(cmbp)->emptysem);                                    \
+    __co_mb_post(cmbp, m);                                                  \
+  } while (false)
+/** @} */
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  co_status_t __co_sleep(co_task_t *ctp, sysinterval_t delay);
+  bool __co_sem_wait(co_task_t *ctp, co_semaphore_t *csp);
+  msg_t __co_mb_fetch(co_mailbox_t *cmbp);
+  void __co_mb_post(co_mailbox_t *cmbp, msg_t msg);
+  void coExecutorObjectInit(co_executor_t *cxp);
+  void coExecutorRun(co_executor_t *cxp);
+  void coExecutorNotifyI(co_executor_t *cxp);
+  void coExecutorNotify(co_executor_t *cxp);
+  void coTaskStartI(co_executor_t *cxp, co_task_t *ctp,
+                    co_function_t func, void *arg);
+  void coTaskStart(co_executor_t *cxp, co_task_t *ctp,
+                   co_function_t func, void *arg);
+  void coSemObjectInit(co_semaphore_t *csp, cnt_t n);
+  void coSemSignalI(co_semaphore_t *csp);
+  void coSemSignal(co_semaphore_t *csp);
+  void coMBObjectInit(co_mailbox_t *cmbp, msg_t *buf, size_t n);
+  msg_t coMBPostI(co_mailbox_t *cmbp, msg_t msg);
+  msg_t coMBPost(co_mailbox_t *cmbp, msg_t msg);
+  msg_t coMBFetchI(co_mailbox_t *cmbp, msg_t *msgp);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the thread running the executor.
+ * @note    Events to be received by tasks must be signaled to this thread.
+ *
+ * @param[in] cxp       pointer to a @p co_executor_t structure
+ * @return              The executor thread or @p NULL if not running.
+ *
+ * @xclass
+ */
+static inline thread_t *coExecutorGetThreadX(co_executor_t *cxp) {
+
+  return cxp->thread;
+}
+
+/**
+ * @brief   Returns the semaphore counter current value.
+ *
+ * @param[in] csp       pointer to a @p co_semaphore_t structure
+ * @return              The semaphore counter value.
+ *
+ * @iclass
+ */
+static inline cnt_t coSemGetCounterI(const co_semaphore_t *csp) {
+
+  chDbgCheckClassI();
+
+  return csp->cnt;
+}
+
+/**
+ * @brief   Returns the number of used message slots into a mailbox.
+ *
+ * @param[in] cmbp      pointer to a @p co_mailbox_t structure
+ * @return              The number of queued messages.
+ *
+ * @iclass
+ */
+static inline size_t coMBGetUsedCountI(const co_mailbox_t *cmbp) {
+
+  chDbgCheckClassI();
+
+  return (cmbp->fullsem.cnt > (cnt_t)0) ? (size_t)cmbp->fullsem.cnt :
+                                          (size_t)0;
+}
+
+#endif /* COROUTINES_H */
+
+/** @} */
@@ -0,0 +1,8 @@
+# RT stackless coroutines files.
+COROUTINESSRC = $(CHIBIOS)/os/various/coroutines/coroutines.c
+
+COROUTINESINC = $(CHIBIOS)/os/various/coroutines
+
+# Shared variables
+ALLCSRC += $(COROUTINESSRC)
+ALLINC  += $(COROUTINESINC)
@@ -0,0 +1,714 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    dlog.c
+ * @brief   Deferred logging code.
+ *
+ * @addtogroup DLOG
+ * @{
+ */
+
+#include "ch.h"
+#include "chprintf.h"
+#include "dlog.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Mask of the ring positions.
+ */
+#define DLOG_RING_MASK              ((ucnt_t)DLOG_RING_SIZE - (ucnt_t)1)
+
+/**
+ * @brief   Mask of the position bits stored in a record header.
+ */
+#define DLOG_TAG_MASK               ((ucnt_t)0xFFFFFF)
+
+/**
+ * @brief   Maximum size of a record in words.
+ */
+#define DLOG_MAX_RECORD             (DLOG_HEADER_WORDS + DLOG_MAX_ARGUMENTS)
+
+/**
+ * @brief   Size of the buffer of a single conversion specification.
+ */
+#define DLOG_SPEC_SIZE              32U
+
+/**
+ * @brief   Header word of a record.
+ * @note    Consumed words are cleared so a valid header cannot be found
+ *          at a position before the producer writes it.
+ *
+ * @param[in] pos       position of the record
+ * @param[in] n         size of the record in words
+ */
+#define DLOG_HEADER(pos, n)                                                 \
+  ((((dlog_word_t)(pos) & (dlog_word_t)DLOG_TAG_MASK) << 8) | (dlog_word_t)(n))
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/**
+ * @brief   Decoded conversion specification.
+ */
+typedef struct {
+  /**
+   * @brief   Conversion character.
+   */
+  char                      conv;
+  /**
+   * @brief   Long argument.
+   */
+  bool                      is_long;
+  /**
+   * @brief   Number of @p * fields.
+   */
+  unsigned                  stars;
+} dlog_spec_t;
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Per-core rings.
+ */
+static dlog_ring_t dlog_rings[DLOG_CORES];
+
+/**
+ * @brief   Logger configuration, @p NULL if stopped.
+ */
+static const dlog_config_t *dlog_config;
+
+/**
+ * @brief   Drain thread.
+ */
+static thread_t *dlog_thread;
+
+/**
+ * @brief   Mutex serializing the consumers.
+ */
+static MUTEX_DECL(dlog_mtx);
+
+/**
+ * @brief   Drain thread working area.
+ */
+static THD_WORKING_AREA(dlog_wa, DLOG_DRAIN_STACK_SIZE);
+
+/**
+ * @brief   String exported in the binary stream.
+ * @details The decoder finds this string in the ELF file, its run time
+ *          address gives the load offset of the application.
+ */
+static const char dlog_marker[] = "ChibiOS/DLOG marker";
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the ring of the current core.
+ */
+static inline dlog_ring_t *dlog_get_ring(void) {
+
+#if DLOG_CORES > 1
+  return &dlog_rings[port_get_core_id()];
+#else
+  return &dlog_rings[0];
+#endif
+}
+
+/**
+ * @brief   Decodes a conversion specification like @p chvprintf() does.
+ *
+ * @param[in] fmt       pointer to the character following the @p %
+ * @param[out] sp       decoded specification
+ * @return              Pointer to the character following the
+ *                      specification or @p NULL if the format ends
+ *                      prematurely.
+ */
+static const char *dlog_scan(const char *fmt, dlog_spec_t *sp) {
+  char c;
+
+  sp->stars = 0U;
+  if (*fmt == '-') {
+    fmt++;
+  }
+  if (*fmt == '+') {
+    fmt++;
+  }
+  if (*fmt == '0') {
+    fmt++;
+  }
+
+  /* Width.*/
+  if (*fmt == '*') {
+    sp->stars++;
+    fmt++;
+    c = *fmt++;
+  }
+  else {
+    do {
+      c = *fmt++;
+    } while ((c >= '0') && (c <= '9'));
+  }
+  if (c == '\0') {
+    return NULL;
+  }
+
+  /* Precision.*/
+  if (c == '.') {
+    c = *fmt++;
+    if (c == '*') {
+      sp->stars++;
+      c = *fmt++;
+    }
+    else {
+      while ((c >= '0') && (c <= '9')) {
+        c = *fmt++;
+      }
+    }
+    if (c == '\0') {
+      return NULL;
+    }
+  }
+
+  /* Long modifier.*/
+  if ((c == 'l') || (c == 'L')) {
+    sp->is_long = true;
+    c = *fmt++;
+    if (c == '\0') {
+      return NULL;
+    }
+  }
+  else {
+    sp->is_long = (c >= 'A') && (c <= 'Z');
+  }
+  sp->conv = c;
+
+  return fmt;
+}
+
+/**
+ * @brief   Checks if a conversion takes an argument.
+ *
+ * @param[in] c         conversion character
+ * @return              The check result.
+ */
+static bool dlog_has_argument(char c) {
+
+  switch (c) {
+  case 'c':
+  case 's':
+  case 'D':
+  case 'd':
+  case 'I':
+  case 'i':
+#if CHPRINTF_USE_FLOAT
+  case 'f':
+#endif
+  case 'X':
+  case 'x':
+  case 'P':
+  case 'p':
+  case 'U':
+  case 'u':
+  case 'O':
+  case 'o':
+    return true;
+  default:
+    return false;
+  }
+}
+
+/**
+ * @brief   Records a lost record.
+ *
+ * @param[in] rp        pointer to the ring
+ */
+static void dlog_drop(dlog_ring_t *rp) {
+  cnt_t drops;
+
+  do {
+    drops = rp->drops;
+  } while (!__ring_cas(&rp->drops, drops, (cnt_t)((ucnt_t)drops + 1U)));
+}
+
+/**
+ * @brief   Writes a decimal number into a buffer.
+ *
+ * @param[out] p        pointer to the buffer
+ * @param[in] v         value, negative values are written as zero
+ * @return              Pointer after the last written character.
+ */
+static char *dlog_itoa(char *p, int v) {
+  char tmp[10];
+  unsigned i = 0U;
+  unsigned u = v > 0 ? (unsigned)v : 0U;
+
+  do {
+    tmp[i++] = (char)('0' + (u % 10U));
+    u /= 10U;
+  } while (u > 0U);
+  while (i > 0U) {
+    *p++ = tmp[--i];
+  }
+
+  return p;
+}
+
+/**
+ * @brief   Formats a record.
+ * @details Literal runs are written directly, each conversion is performed
+ *          by @p chprintf() with the recorded argument.
+ *
+ * @param[in] stmp      pointer to the sink
+ * @param[in] fmt       format string
+ * @param[in] ap        recorded arguments
+ * @param[in] n         number of recorded arguments
+ */
+static void dlog_format(sequential_stream_i *stmp, const char *fmt,
+                        const dlog_word_t *ap, unsigned n) {
+  char spec[DLOG_SPEC_SIZE];
+
+  while (true) {
+    const char *start = fmt;
+    dlog_spec_t ds;
+    dlog_word_t w;
+    char *p;
+
+    while ((*fmt != '\0') && (*fmt != '%')) {
+      fmt++;
+    }
+    if (fmt > start) {
+      (void) stmWrite(stmp, (const uint8_t *)start, (size_t)(fmt - start));
+    }
+    if (*fmt == '\0') {
+      return;
+    }
+
+    /* The specification is copied with the "*" fields replaced by the
+       recorded values.*/
+    start = fmt;
+    fmt = dlog_scan(fmt + 1, &ds);
+    if (fmt == NULL) {
+      return;
+    }
+    p = spec;
+    while (start < fmt) {
+      if ((size_t)(p - spec) > DLOG_SPEC_SIZE - 12U) {
+        /* Not representable, skipped.*/
+        p = NULL;
+        break;
+      }
+      if (*start == '*') {
+        p = dlog_itoa(p, (n > 0U) ? (int)*ap : 0);
+        if (n > 0U) {
+          ap++;
+          n--;
+        }
+      }
+      else {
+        *p++ = *start;
+      }
+      start++;
+    }
+    if (p == NULL) {
+      continue;
+    }
+    *p = '\0';
+
+    if (!dlog_has_argument(ds.conv)) {
+      (void) chprintf(stmp, spec);
+      continue;
+    }
+    w = (n > 0U) ? *ap : (dlog_word_t)0;
+    if (n > 0U) {
+      ap++;
+      n--;
+    }
+    switch (ds.conv) {
+    case 's':
+      (void) chprintf(stmp, spec, (const char *)w);
+      break;
+#if CHPRINTF_USE_FLOAT
+    case 'f':
+      {
+        union {
+          uint32_t  u;
+          float     f;
+        } v;
+
+        v.u = (uint32_t)w;
+        (void) chprintf(stmp, spec, (double)v.f);
+      }
+      break;
+#endif
+    case 'c':
+    case 'D':
+    case 'd':
+    case 'I':
+    case 'i':
+      if (ds.is_long) {
+        (void) chprintf(stmp, spec, (long)w);
+      }
+      else {
+        (void) chprintf(stmp, spec, (int)w);
+      }
+      break;
+    default:
+      if (ds.is_long) {
+        (void) chprintf(stmp, spec, (unsigned long)w);
+      }
+      else {
+        (void) chprintf(stmp, spec, (unsigned)w);
+      }
+      break;
+    }
+  }
+}
+
+/**
+ * @brief   Writes a record to the sink.
+ *
+ * @param[in] rec       the record, the header word is overwritten
+ * @param[in] size      size of the record in words
+ * @param[in] core      core of the record
+ */
+static void dlog_output(dlog_word_t *rec, unsigned size, unsigned core) {
+  sequential_stream_i *stmp = dlog_config->stmp;
+
+  if (dlog_config->mode == DLOG_MODE_BINARY) {
+    rec[0] = (dlog_word_t)DLOG_EXPORT_MARKER | ((dlog_word_t)core << 16) |
+             (dlog_word_t)size;
+    (void) stmWrite(stmp, (const uint8_t *)rec,
+                    (size_t)size * sizeof (dlog_word_t));
+    return;
+  }
+
+#if DLOG_CORES > 1
+  (void) chprintf(stmp, "%10U %u ", (unsigned long)rec[2], core);
+#else
+  (void) chprintf(stmp, "%10U ", (unsigned long)rec[2]);
+#endif
+  if (rec[1] == (dlog_word_t)0) {
+    (void) chprintf(stmp, "*** %U records dropped\r\n", (unsigned long)rec[3]);
+  }
+  else {
+    dlog_format(stmp, (const char *)rec[1], &rec[DLOG_HEADER_WORDS],
+                size - DLOG_HEADER_WORDS);
+  }
+}
+
+/**
+ * @brief   Drains a ring.
+ *
+ * @param[in] rp        pointer to the ring
+ * @param[in] core      core of the ring
+ * @return              The number of drained records.
+ */
+static unsigned dlog_drain_ring(dlog_ring_t *rp, unsigned core) {
+  dlog_word_t rec[DLOG_MAX_RECORD];
+  ucnt_t pos = (ucnt_t)rp->rdpos;
+  unsigned records = 0U;
+  cnt_t drops;
+
+  while (true) {
+    dlog_word_t h = rp->words[pos & DLOG_RING_MASK];
+    unsigned i, size = (unsigned)(h & (dlog_word_t)0xFF);
+
+    /* The record is valid if the header matches the position.*/
+    if ((size < DLOG_HEADER_WORDS) || (h != DLOG_HEADER(pos, size))) {
+      break;
+    }
+    __ring_barrier();
+
+    /* Copying and clearing the record, the words are released to the
+       producers after the barrier.*/
+    for (i = 0U; i < size; i++) {
+      rec[i] = rp->words[(pos + i) & DLOG_RING_MASK];
+      rp->words[(pos + i) & DLOG_RING_MASK] = (dlog_word_t)0;
+    }
+    __ring_barrier();
+    pos += (ucnt_t)size;
+    rp->rdpos = (cnt_t)pos;
+
+    dlog_output(rec, size, core);
+    records++;
+  }
+
+  /* Lost records are reported as a record without format.*/
+  drops = rp->drops;
+  if (drops != rp->reported) {
+    rec[1] = (dlog_word_t)0;
+    rec[2] = (dlog_word_t)(uint32_t)DLOG_TIMESTAMP();
+    rec[3] = (dlog_word_t)(ucnt_t)(drops - rp->reported);
+    rp->reported = drops;
+    dlog_output(rec, DLOG_HEADER_WORDS + 1U, core);
+  }
+
+  return records;
+}
+
+/**
+ * @brief   Drain thread.
+ */
+static THD_FUNCTION(dlog_drain, arg) {
+
+  (void)arg;
+  chRegSetThreadName("dlog");
+
+  while (!chThdShouldTerminateX()) {
+    if (dlogFlush() == 0U) {
+      chThdSleep(DLOG_DRAIN_INTERVAL);
+    }
+  }
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Starts the deferred logger.
+ * @details The drain thread is created, in binary mode the stream header is
+ *          written to the sink.
+ * @note    Records can be logged before starting, they are kept in the
+ *          rings.
+ *
+ * @param[in] cfgp      pointer to the @p dlog_config_t structure
+ *
+ * @api
+ */
+void dlogStart(const dlog_config_t *cfgp) {
+
+  chDbgCheck((cfgp != NULL) && (cfgp->stmp != NULL));
+  chDbgAssert(dlog_thread == NULL, "already started");
+
+  chMtxLock(&dlog_mtx);
+  dlog_config = cfgp;
+  if (cfgp->mode == DLOG_MODE_BINARY) {
+    static const uint8_t header[8] = {
+      'D', 'L', 'O', 'G', (uint8_t)sizeof (dlog_word_t), 0U, 0U, 0U
+    };
+    dlog_word_t marker = (dlog_word_t)dlog_marker;
+
+    (void) stmWrite(cfgp->stmp, header, sizeof (header));
+    (void) stmWrite(cfgp->stmp, (const uint8_t *)&marker, sizeof (marker));
+  }
+  chMtxUnlock(&dlog_mtx);
+
+  dlog_thread = chThdCreateStatic(dlog_wa, sizeof (dlog_wa), cfgp->prio,
+                                  dlog_drain, NULL);
+}
+
+/**
+ * @brief   Stops the deferred logger.
+ * @details The drain thread is terminated and the pending records are
+ *          written to the sink.
+ *
+ * @api
+ */
+void dlogStop(void) {
+
+  chDbgAssert(dlog_thread != NULL, "not started");
+
+  chThdTerminate(dlog_thread);
+  (void) chThdWait(dlog_thread);
+  dlog_thread = NULL;
+
+  (void) dlogFlush();
+  chMtxLock(&dlog_mtx);
+  dlog_config = NULL;
+  chMtxUnlock(&dlog_mtx);
+}
+
+/**
+ * @brief   Writes the pending records to the sink.
+ * @note    Records being written by preempted producers, and the
+ *          following records of the same core, are left in the ring.
+ *
+ * @return              The number of written records.
+ *
+ * @api
+ */
+unsigned dlogFlush(void) {
+  unsigned core, records = 0U;
+
+  chMtxLock(&dlog_mtx);
+  if (dlog_config != NULL) {
+    for (core = 0U; core < (unsigned)DLOG_CORES; core++) {
+      records += dlog_drain_ring(&dlog_rings[core], core);
+    }
+  }
+  chMtxUnlock(&dlog_mtx);
+
+  return records;
+}
+
+/**
+ * @brief   Logs a record.
+ * @details The format pointer, a timestamp and the arguments are recorded
+ *          in the ring of the current core, formatting is deferred. If
+ *          the ring is full the record is dropped and counted.
+ * @note    This function can be called from any context, including ISRs,
+ *          it does not enter critical zones if the port supports atomic
+ *          operations.
+ *
+ * @param[in] fmt       formatting string, it must be persistent
+ * @param[in] ap        list of parameters
+ *
+ * @xclass
+ */
+void dlogVPrintf(const char *fmt, va_list ap) {
+  dlog_word_t args[DLOG_MAX_ARGUMENTS];
+  dlog_ring_t *rp = dlog_get_ring();
+  dlog_word_t ts = (dlog_word_t)(uint32_t)DLOG_TIMESTAMP();
+  const char *p = fmt;
+  unsigned i, n = 0U, size;
+  ucnt_t pos;
+
+  /* Arguments are fetched with the types expected by chvprintf().*/
+  while (true) {
+    dlog_spec_t ds;
+    char c = *p++;
+
+    if (c == '\0') {
+      break;
+    }
+    if (c != '%') {
+      continue;
+    }
+    p = dlog_scan(p, &ds);
+    if ((p == NULL) ||
+        (n + ds.stars + 1U > (unsigned)DLOG_MAX_ARGUMENTS)) {
+      break;
+    }
+    for (i = 0U; i < ds.stars; i++) {
+      args[n++] = (dlog_word_t)va_arg(ap, int);
+    }
+    if (!dlog_has_argument(ds.conv)) {
+      continue;
+    }
+    switch (ds.conv) {
+    case 's':
+      args[n++] = (dlog_word_t)va_arg(ap, char *);
+      break;
+#if CHPRINTF_USE_FLOAT
+    case 'f':
+      {
+        union {
+          uint32_t  u;
+          float     f;
+        } v;
+
+        v.f = (float)va_arg(ap, double);
+        args[n++] = (dlog_word_t)v.u;
+      }
+      break;
+#endif
+    case 'c':
+    case 'D':
+    case 'd':
+    case 'I':
+    case 'i':
+      if (ds.is_long) {
+        args[n++] = (dlog_word_t)va_arg(ap, long);
+      }
+      else {
+        args[n++] = (dlog_word_t)va_arg(ap, int);
+      }
+      break;
+    default:
+      if (ds.is_long) {
+        args[n++] = (dlog_word_t)va_arg(ap, unsigned long);
+      }
+      else {
+        args[n++] = (dlog_word_t)va_arg(ap, unsigned int);
+      }
+      break;
+    }
+  }
+
+  /* Space reservation, producers on the same core are serialized by the
+     CAS, there is no contention between cores.*/
+  size = DLOG_HEADER_WORDS + n;
+  while (true) {
+    pos = (ucnt_t)rp->wrpos;
+    if ((ucnt_t)(pos - (ucnt_t)rp->rdpos) >
+        (ucnt_t)DLOG_RING_SIZE - (ucnt_t)size) {
+      dlog_drop(rp);
+      return;
+    }
+    if (__ring_cas(&rp->wrpos, (cnt_t)pos, (cnt_t)(pos + (ucnt_t)size))) {
+      break;
+    }
+  }
+
+  /* The record body must be visible before the header publishes it.*/
+  rp->words[(pos + 1U) & DLOG_RING_MASK] = (dlog_word_t)fmt;
+  rp->words[(pos + 2U) & DLOG_RING_MASK] = ts;
+  for (i = 0U; i < n; i++) {
+    rp->words[(pos + DLOG_HEADER_WORDS + i) & DLOG_RING_MASK] = args[i];
+  }
+  __ring_barrier();
+  rp->words[pos & DLOG_RING_MASK] = DLOG_HEADER(pos, size);
+}
+
+/**
+ * @brief   Logs a record.
+ * @see     dlogVPrintf()
+ *
+ * @param[in] fmt       formatting string, it must be persistent
+ * @param[in] ...       parameters
+ *
+ * @xclass
+ */
+void dlogPrintf(const char *fmt, ...) {
+  va_list ap;
+
+  va_start(ap, fmt);
+  dlogVPrintf(fmt, ap);
+  va_end(ap);
+}
+
+/**
+ * @brief   Returns the number of records lost since startup.
+ *
+ * @return              The number of lost records.
+ *
+ * @xclass
+ */
+cnt_t dlogGetDropsX(void) {
+  ucnt_t drops = 0U;
+  unsigned core;
+
+  for (core = 0U; core < (unsigned)DLOG_CORES; core++) {
+    drops += (ucnt_t)dlog_rings[core].drops;
+  }
+
+  return (cnt_t)drops;
+}
+
+/** @} */
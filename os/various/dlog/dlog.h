@@ -0,0 +1,240 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    dlog.h
+ * @brief   Deferred logging header.
+ * @details The deferred logger records the format string pointer, a
+ *          timestamp and the raw arguments of each log call into a
+ *          per-core lock-free ring, formatting is performed later by a
+ *          low priority drain thread which writes to a
+ *          @p sequential_stream_i sink.<br>
+ *          In binary mode the records are exported unformatted, the
+ *          @p dlog_decode.py script formats them on the host using the
+ *          strings contained in the application ELF file.
+ * @note    Arguments of @p %s conversions are recorded as pointers, the
+ *          strings must still be valid when the record is formatted,
+ *          string literals and constant tables are fine.
+ * @note    The format syntax is the one of @p chprintf(), @p %f arguments
+ *          are recorded in single precision and negative @p * values are
+ *          formatted as zero.
+ *
+ * @addtogroup DLOG
+ * @{
+ */
+
+#ifndef DLOG_H
+#define DLOG_H
+
+#include <stdarg.h>
+
+#include "oop_sequential_stream.h"
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Binary export format
+ * @{
+ */
+/**
+ * @brief   Marker in the header word of exported records.
+ */
+#define DLOG_EXPORT_MARKER          0xA5000000U
+
+/**
+ * @brief   Magic bytes at the beginning of an exported stream.
+ */
+#define DLOG_EXPORT_MAGIC           "DLOG"
+/** @} */
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Size of each per-core ring in words.
+ * @note    Must be a power of two.
+ */
+#if !defined(DLOG_RING_SIZE) || defined(__DOXYGEN__)
+#define DLOG_RING_SIZE              256
+#endif
+
+/**
+ * @brief   Maximum number of arguments recorded by a log call.
+ * @note    Arguments in excess are ignored and formatted as zero.
+ */
+#if !defined(DLOG_MAX_ARGUMENTS) || defined(__DOXYGEN__)
+#define DLOG_MAX_ARGUMENTS          8
+#endif
+
+/**
+ * @brief   Drain thread polling interval.
+ */
+#if !defined(DLOG_DRAIN_INTERVAL) || defined(__DOXYGEN__)
+#define DLOG_DRAIN_INTERVAL         TIME_MS2I(10)
+#endif
+
+/**
+ * @brief   Drain thread stack size.
+ */
+#if !defined(DLOG_DRAIN_STACK_SIZE) || defined(__DOXYGEN__)
+#define DLOG_DRAIN_STACK_SIZE       1024
+#endif
+
+/**
+ * @brief   Timestamp of log records.
+ * @details The default is the realtime counter when supported by the port
+ *          else the system time, timestamps are recorded on 32 bits.
+ */
+#if !defined(DLOG_TIMESTAMP) || defined(__DOXYGEN__)
+#if (PORT_SUPPORTS_RT == TRUE) || defined(__DOXYGEN__)
+#define DLOG_TIMESTAMP()            ((dlog_word_t)chSysGetRealtimeCounterX())
+#else
+#define DLOG_TIMESTAMP()            ((dlog_word_t)chVTGetSystemTimeX())
+#endif
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if CH_CFG_USE_RINGS != TRUE
+#error "DLOG requires CH_CFG_USE_RINGS"
+#endif
+
+#if CH_CFG_USE_MUTEXES != TRUE
+#error "DLOG requires CH_CFG_USE_MUTEXES"
+#endif
+
+#if CH_CFG_USE_WAITEXIT != TRUE
+#error "DLOG requires CH_CFG_USE_WAITEXIT"
+#endif
+
+#if (DLOG_RING_SIZE < 16) || (DLOG_RING_SIZE > 0x800000) ||                 \
+    ((DLOG_RING_SIZE & (DLOG_RING_SIZE - 1)) != 0)
+#error "invalid DLOG_RING_SIZE value"
+#endif
+
+#if (DLOG_MAX_ARGUMENTS < 1) || (DLOG_MAX_ARGUMENTS > 32)
+#error "invalid DLOG_MAX_ARGUMENTS value"
+#endif
+
+/**
+ * @brief   Number of per-core rings.
+ */
+#define DLOG_CORES                  PORT_CORES_NUMBER
+
+/**
+ * @brief   Number of words in a record header.
+ * @details Header word, format pointer and timestamp.
+ */
+#define DLOG_HEADER_WORDS           3U
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a ring word.
+ * @note    It is large enough for pointers and @p long arguments.
+ */
+typedef uintptr_t dlog_word_t;
+
+/**
+ * @brief   Output modes of the drain thread.
+ */
+typedef enum {
+  DLOG_MODE_TEXT = 0,                       /**< Records formatted as text. */
+  DLOG_MODE_BINARY = 1                      /**< Records exported raw.      */
+} dlog_mode_t;
+
+/**
+ * @brief   Type of a deferred logger configuration.
+ */
+typedef struct {
+  /**
+   * @brief   Sink of the drained records.
+   */
+  sequential_stream_i       *stmp;
+  /**
+   * @brief   Output mode.
+   */
+  dlog_mode_t               mode;
+  /**
+   * @brief   Drain thread priority.
+   */
+  tprio_t                   prio;
+} dlog_config_t;
+
+/**
+ * @brief   Type of a per-core ring.
+ * @details Records are sequences of words, the header word contains the
+ *          record size and the low bits of the record position, it is
+ *          written last and publishes the record.
+ */
+typedef struct {
+  /**
+   * @brief   Producers position, records are reserved by CAS.
+   */
+  volatile cnt_t            wrpos;
+  /**
+   * @brief   Consumer position.
+   */
+  volatile cnt_t            rdpos;
+  /**
+   * @brief   Number of records lost because the ring was full.
+   */
+  volatile cnt_t            drops;
+  /**
+   * @brief   Number of lost records already reported.
+   */
+  cnt_t                     reported;
+  /**
+   * @brief   Ring words.
+   */
+  volatile dlog_word_t      words[DLOG_RING_SIZE];
+} dlog_ring_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void dlogStart(const dlog_config_t *cfgp);
+  void dlogStop(void);
+  unsigned dlogFlush(void);
+  void dlogPrintf(const char *fmt, ...);
+  void dlogVPrintf(const char *fmt, va_list ap);
+  cnt_t dlogGetDropsX(void);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* DLOG_H */
+
+/** @} */
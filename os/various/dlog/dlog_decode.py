@@ -0,0 +1,255 @@
+#!/usr/bin/env python
+
+"""Decode a deferred log binary stream.
+
+The stream is produced by the drain thread in DLOG_MODE_BINARY, format
+strings and string arguments are read from the application ELF file.
+"""
+
+import argparse
+import io
+import struct
+import sys
+
+MAGIC = b'DLOG'
+MARKER = b'ChibiOS/DLOG marker\0'
+RECORD_MARKER = 0xA5000000
+HEADER_WORDS = 3
+FLOAT_PRECISION = 9
+
+
+class Image(object):
+    """Loadable segments of an ELF file."""
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.data = f.read()
+        if self.data[:4] != b'\x7fELF':
+            raise ValueError('{} is not an ELF file'.format(path))
+        bits = {1: 32, 2: 64}[self.data[4]]
+        self.endian = '<' if self.data[5] == 1 else '>'
+        if bits == 32:
+            phoff, = struct.unpack_from(self.endian + 'I', self.data, 0x1C)
+            phentsize, phnum = struct.unpack_from(self.endian + 'HH',
+                                                  self.data, 0x2A)
+            phfmt = 'IIIIII'
+        else:
+            phoff, = struct.unpack_from(self.endian + 'Q', self.data, 0x20)
+            phentsize, phnum = struct.unpack_from(self.endian + 'HH',
+                                                  self.data, 0x36)
+            phfmt = 'IIQQQQ'
+        self.segments = []
+        for i in range(phnum):
+            fields = struct.unpack_from(self.endian + phfmt, self.data,
+                                        phoff + i * phentsize)
+            if bits == 32:
+                ptype, offset, vaddr, _, filesz, _ = fields
+            else:
+                ptype, _, offset, vaddr, _, filesz = fields
+            if ptype == 1:
+                self.segments.append((vaddr, offset, filesz))
+        self.bias = 0
+
+    def offset_to_vaddr(self, offset):
+        for vaddr, start, size in self.segments:
+            if start <= offset < start + size:
+                return vaddr + offset - start
+        return None
+
+    def vaddr_to_offset(self, addr):
+        addr -= self.bias
+        for vaddr, start, size in self.segments:
+            if vaddr <= addr < vaddr + size:
+                return start + addr - vaddr
+        return None
+
+    def set_marker(self, addr):
+        """Computes the load offset from the run time marker address."""
+        offset = self.data.find(MARKER)
+        vaddr = self.offset_to_vaddr(offset) if offset >= 0 else None
+        if vaddr is None:
+            raise ValueError('marker not found, wrong ELF file?')
+        self.bias = addr - vaddr
+
+    def string(self, addr):
+        offset = self.vaddr_to_offset(addr)
+        if offset is None:
+            return None
+        end = self.data.find(b'\0', offset)
+        return self.data[offset:end].decode('latin-1')
+
+
+def to_signed(value, bits):
+    value &= (1 << bits) - 1
+    if value >= 1 << (bits - 1):
+        value -= 1 << bits
+    return value
+
+
+def ftoa(value, precision):
+    """Same algorithm as the chprintf() one, digits are truncated."""
+    if precision == 0 or precision > FLOAT_PRECISION:
+        precision = FLOAT_PRECISION
+    ipart = int(value)
+    fpart = int((value - ipart) * 10 ** precision)
+    return '{}.{:0{}d}'.format(ipart, fpart, precision)
+
+
+def format_record(image, fmt, args, wordbits):
+    """Formats a record like chvprintf() does."""
+    out = []
+    args = list(args)
+
+    def arg():
+        return args.pop(0) if args else 0
+
+    i = 0
+    while i < len(fmt):
+        c = fmt[i]
+        i += 1
+        if c != '%':
+            out.append(c)
+            continue
+
+        left_align = do_sign = False
+        filler = ' '
+        if fmt[i:i + 1] == '-':
+            left_align = True
+            i += 1
+        if fmt[i:i + 1] == '+':
+            do_sign = True
+            i += 1
+        if fmt[i:i + 1] == '0':
+            filler = '0'
+            i += 1
+        width = 0
+        if fmt[i:i + 1] == '*':
+            width = max(to_signed(arg(), 32), 0)
+            i += 1
+        else:
+            while fmt[i:i + 1].isdigit():
+                width = width * 10 + int(fmt[i])
+                i += 1
+        precision = 0
+        if fmt[i:i + 1] == '.':
+            i += 1
+            if fmt[i:i + 1] == '*':
+                precision = max(to_signed(arg(), 32), 0)
+                i += 1
+            else:
+                while fmt[i:i + 1].isdigit():
+                    precision = precision * 10 + int(fmt[i])
+                    i += 1
+        if i >= len(fmt):
+            break
+        c = fmt[i]
+        i += 1
+        if c in 'lL':
+            is_long = True
+            if i >= len(fmt):
+                break
+            c = fmt[i]
+            i += 1
+        else:
+            is_long = c.isupper()
+        bits = wordbits if is_long else 32
+
+        if c == 'c':
+            filler = ' '
+            s = chr(arg() & 0xFF)
+        elif c == 's':
+            filler = ' '
+            addr = arg()
+            if addr == 0:
+                s = '(null)'
+            else:
+                s = image.string(addr)
+                if s is None:
+                    s = '<0x{:X}>'.format(addr)
+            if precision > 0:
+                s = s[:precision]
+        elif c in 'dDiI':
+            v = to_signed(arg(), bits)
+            s = ('-' if v < 0 else '+' if do_sign else '') + str(abs(v))
+        elif c == 'f':
+            v, = struct.unpack('<f', struct.pack('<I', arg() & 0xFFFFFFFF))
+            sign = '-' if v < 0 else '+' if do_sign else ''
+            s = sign + ftoa(abs(v), precision)
+        elif c in 'xXpP':
+            s = '{:X}'.format(arg() & ((1 << bits) - 1))
+        elif c in 'uU':
+            s = '{:d}'.format(arg() & ((1 << bits) - 1))
+        elif c in 'oO':
+            s = '{:o}'.format(arg() & ((1 << bits) - 1))
+        else:
+            s = c
+
+        fill = max(width - len(s), 0)
+        if left_align:
+            out.append(s + filler * fill)
+        elif filler == '0' and s[:1] in ('-', '+'):
+            out.append(s[0] + filler * fill + s[1:])
+        else:
+            out.append(filler * fill + s)
+
+    return ''.join(out)
+
+
+def decode(image, data, output):
+    pos = data.find(MAGIC)
+    if pos < 0:
+        raise ValueError('stream header not found')
+    wordsize = data[pos + 4]
+    wordfmt = image.endian + {4: 'I', 8: 'Q'}[wordsize]
+    pos += 8
+    marker, = struct.unpack_from(wordfmt, data, pos)
+    image.set_marker(marker)
+    pos += wordsize
+
+    while pos + wordsize <= len(data):
+        header, = struct.unpack_from(wordfmt, data, pos)
+        size = header & 0xFF
+        if ((header & 0xFF000000) != RECORD_MARKER or size < HEADER_WORDS or
+                pos + size * wordsize > len(data)):
+            # Garbage or a new stream header, resynchronizing.
+            if data[pos:pos + 4] == MAGIC:
+                return decode(image, data[pos:], output)
+            pos += 1
+            continue
+        words = struct.unpack_from(image.endian + wordfmt[1] * size, data, pos)
+        pos += size * wordsize
+        core = (header >> 16) & 0xFF
+        fmt, timestamp = words[1], words[2]
+        if fmt == 0:
+            text = '*** {} records dropped\r\n'.format(words[3])
+        else:
+            string = image.string(fmt)
+            if string is None:
+                text = '<unknown format 0x{:X}>\r\n'.format(fmt)
+            else:
+                text = format_record(image, string, words[HEADER_WORDS:],
+                                     wordsize * 8)
+        output.write('{:10d} {} {}'.format(timestamp, core, text))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('elf', help='application ELF file')
+    parser.add_argument('stream', help='binary log stream, - for stdin')
+    args = parser.parse_args()
+
+    image = Image(args.elf)
+    if args.stream == '-':
+        data = sys.stdin.buffer.read()
+    else:
+        with open(args.stream, 'rb') as f:
+            data = f.read()
+    # Characters are bytes on the target side.
+    output = io.TextIOWrapper(sys.stdout.buffer, encoding='latin-1',
+                              newline='')
+    decode(image, data, output)
+    output.flush()
+
+
+if __name__ == '__main__':
+    main()
@@ -10,6 +10,8 @@
 #include "ff.h"
 #include "diskio.h"
 
+#include <string.h>
+
 #if !defined(FATFS_HAL_DEVICE)
 #if HAL_USE_SDC
 #define FATFS_HAL_DEVICE SDCD1
@@ -18,7 +20,10 @@
 #endif
 #endif
 
-#if HAL_USE_MMC_SPI
+/* Any other block device can be used by specifying its type.*/
+#if defined(FATFS_HAL_DEVICE_TYPE)
+extern FATFS_HAL_DEVICE_TYPE FATFS_HAL_DEVICE;
+#elif HAL_USE_MMC_SPI
 extern MMCDriver FATFS_HAL_DEVICE;
 #elif HAL_USE_SDC
 extern SDCDriver FATFS_HAL_DEVICE;
@@ -30,6 +35,430 @@ extern SDCDriver FATFS_HAL_DEVICE;
 extern RTCDriver RTCD1;
 #endif
 
+/*-----------------------------------------------------------------------*/
+/* Asynchronous I/O settings.                                            */
+
+/* Enables the I/O thread, writes are queued and merged, sequential reads
+   are served from read-ahead buffers loaded in background.*/
+#if !defined(FATFS_USE_ASYNC_IO)
+#define FATFS_USE_ASYNC_IO              FALSE
+#endif
+
+/* Size in sectors of each of the two read-ahead buffers.*/
+#if !defined(FATFS_ASYNC_READ_SECTORS)
+#define FATFS_ASYNC_READ_SECTORS        8
+#endif
+
+/* Size in sectors of each of the two write buffers.*/
+#if !defined(FATFS_ASYNC_WRITE_SECTORS)
+#define FATFS_ASYNC_WRITE_SECTORS       8
+#endif
+
+/* I/O thread priority, it should be higher than the file system users.*/
+#if !defined(FATFS_ASYNC_THREAD_PRIORITY)
+#define FATFS_ASYNC_THREAD_PRIORITY     (NORMALPRIO + 1)
+#endif
+
+/* I/O thread stack size.*/
+#if !defined(FATFS_ASYNC_THREAD_STACK_SIZE)
+#define FATFS_ASYNC_THREAD_STACK_SIZE   512
+#endif
+
+#if FATFS_USE_ASYNC_IO
+#if FF_MAX_SS != FF_MIN_SS
+#error "FATFS_USE_ASYNC_IO requires a fixed sector size"
+#endif
+#if (CH_CFG_USE_MUTEXES == FALSE) || (CH_CFG_USE_CONDVARS == FALSE)
+#error "FATFS_USE_ASYNC_IO requires CH_CFG_USE_MUTEXES and CH_CFG_USE_CONDVARS"
+#endif
+#endif
+
+/*-----------------------------------------------------------------------*/
+/* Asynchronous I/O.                                                     */
+
+#if FATFS_USE_ASYNC_IO
+
+#define AIO_DEVICE      ((BaseBlockDevice *)&FATFS_HAL_DEVICE)
+
+/* Buffer states, a BUSY buffer is owned by the I/O thread.*/
+typedef enum {
+  AIO_IDLE = 0,
+  AIO_READY = 1,
+  AIO_BUSY = 2
+} aio_state_t;
+
+typedef struct {
+  aio_state_t   state;
+  bool          stale;          /* Overwritten while loading.            */
+  DWORD         sector;
+  UINT          count;
+  BYTE          *data;
+} aio_buffer_t;
+
+static struct {
+  mutex_t               mtx;    /* Protects the buffers state.           */
+  mutex_t               dmtx;   /* Serializes the device accesses.       */
+  condition_variable_t  cond;
+  thread_t              *thread;
+  DWORD                 sectors;
+  bool                  error;  /* A queued write failed.                */
+  aio_buffer_t          rbuf[2];
+  aio_buffer_t          wbuf[2];
+} aio;
+
+static BYTE aio_rdata[2][FATFS_ASYNC_READ_SECTORS * FF_MAX_SS];
+static BYTE aio_wdata[2][FATFS_ASYNC_WRITE_SECTORS * FF_MAX_SS];
+static THD_WORKING_AREA(aio_wa, FATFS_ASYNC_THREAD_STACK_SIZE);
+
+static bool aio_overlaps(const aio_buffer_t *bp, DWORD sector, UINT count) {
+
+  return (bp->state != AIO_IDLE) &&
+         (sector < bp->sector + bp->count) && (bp->sector < sector + count);
+}
+
+static bool aio_device_read(DWORD sector, BYTE *buff, UINT count) {
+  bool err;
+
+  chMtxLock(&aio.dmtx);
+  err = blkRead(AIO_DEVICE, sector, buff, count);
+  chMtxUnlock(&aio.dmtx);
+
+  return err;
+}
+
+static bool aio_device_write(DWORD sector, const BYTE *buff, UINT count) {
+  bool err;
+
+  chMtxLock(&aio.dmtx);
+  err = blkWrite(AIO_DEVICE, sector, buff, count);
+  chMtxUnlock(&aio.dmtx);
+
+  return err;
+}
+
+/* Writes are processed before loads, a load queued after a write then
+   reads the new data.*/
+static THD_FUNCTION(aio_thread, arg) {
+
+  (void)arg;
+
+  chRegSetThreadName("fatfs_aio");
+
+  chMtxLock(&aio.mtx);
+  while (true) {
+    aio_buffer_t *bp;
+    bool err;
+
+    if (aio.wbuf[0].state == AIO_BUSY) {
+      bp = &aio.wbuf[0];
+    }
+    else if (aio.wbuf[1].state == AIO_BUSY) {
+      bp = &aio.wbuf[1];
+    }
+    else if (aio.rbuf[0].state == AIO_BUSY) {
+      bp = &aio.rbuf[0];
+    }
+    else if (aio.rbuf[1].state == AIO_BUSY) {
+      bp = &aio.rbuf[1];
+    }
+    else {
+      chCondWait(&aio.cond);
+      continue;
+    }
+    chMtxUnlock(&aio.mtx);
+
+    if ((bp == &aio.wbuf[0]) || (bp == &aio.wbuf[1])) {
+      err = aio_device_write(bp->sector, bp->data, bp->count);
+
+      chMtxLock(&aio.mtx);
+      if (err) {
+        aio.error = true;
+      }
+      bp->state = AIO_IDLE;
+    }
+    else {
+      err = aio_device_read(bp->sector, bp->data, bp->count);
+
+      chMtxLock(&aio.mtx);
+      bp->state = (err || bp->stale) ? AIO_IDLE : AIO_READY;
+    }
+    chCondBroadcast(&aio.cond);
+  }
+}
+
+/* Queues a filled write buffer, writes are queued one at time in order to
+   preserve their order.*/
+static void aio_submit_write(aio_buffer_t *bp) {
+  aio_buffer_t *op = bp == &aio.wbuf[0] ? &aio.wbuf[1] : &aio.wbuf[0];
+
+  while (op->state == AIO_BUSY) {
+    chCondWait(&aio.cond);
+  }
+  bp->state = AIO_BUSY;
+  chCondBroadcast(&aio.cond);
+}
+
+/* Queues the pending writes and waits for their completion.*/
+static void aio_flush_writes(void) {
+  unsigned i;
+
+  for (i = 0U; i < 2U; i++) {
+    if (aio.wbuf[i].state == AIO_READY) {
+      aio_submit_write(&aio.wbuf[i]);
+    }
+  }
+  while ((aio.wbuf[0].state != AIO_IDLE) || (aio.wbuf[1].state != AIO_IDLE)) {
+    chCondWait(&aio.cond);
+  }
+}
+
+/* Read-ahead of the sectors following a sequential access, the buffer
+   just consumed, if any, is not reused.*/
+static void aio_prefetch(DWORD sector, const aio_buffer_t *used) {
+  aio_buffer_t *bp;
+  unsigned i;
+  UINT count;
+
+  if (sector >= aio.sectors) {
+    return;
+  }
+  count = aio.sectors - sector < FATFS_ASYNC_READ_SECTORS ?
+          (UINT)(aio.sectors - sector) : FATFS_ASYNC_READ_SECTORS;
+
+  /* Already loaded or loading, or having pending writes.*/
+  for (i = 0U; i < 2U; i++) {
+    if (aio_overlaps(&aio.rbuf[i], sector, 1U) ||
+        aio_overlaps(&aio.wbuf[i], sector, count)) {
+      return;
+    }
+  }
+
+  if ((aio.rbuf[0].state != AIO_BUSY) && (&aio.rbuf[0] != used)) {
+    bp = &aio.rbuf[0];
+  }
+  else if ((aio.rbuf[1].state != AIO_BUSY) && (&aio.rbuf[1] != used)) {
+    bp = &aio.rbuf[1];
+  }
+  else {
+    return;
+  }
+
+  bp->sector = sector;
+  bp->count  = count;
+  bp->stale  = false;
+  bp->state  = AIO_BUSY;
+  chCondBroadcast(&aio.cond);
+}
+
+/* The medium could have been replaced since the previous initialization,
+   read-ahead data and queued writes are discarded, the operations already
+   in progress are completed first.*/
+static void aio_init(void) {
+  BlockDeviceInfo bdi;
+  unsigned i;
+
+  if (aio.thread == NULL) {
+    chMtxObjectInit(&aio.mtx);
+    chMtxObjectInit(&aio.dmtx);
+    chCondObjectInit(&aio.cond);
+    for (i = 0U; i < 2U; i++) {
+      aio.rbuf[i].state = AIO_IDLE;
+      aio.rbuf[i].data  = aio_rdata[i];
+      aio.wbuf[i].state = AIO_IDLE;
+      aio.wbuf[i].data  = aio_wdata[i];
+    }
+    aio.thread = chThdCreateStatic(aio_wa, sizeof (aio_wa),
+                                   FATFS_ASYNC_THREAD_PRIORITY,
+                                   aio_thread, NULL);
+  }
+
+  chMtxLock(&aio.mtx);
+  while ((aio.rbuf[0].state == AIO_BUSY) || (aio.rbuf[1].state == AIO_BUSY) ||
+         (aio.wbuf[0].state == AIO_BUSY) || (aio.wbuf[1].state == AIO_BUSY)) {
+    chCondWait(&aio.cond);
+  }
+  for (i = 0U; i < 2U; i++) {
+    aio.rbuf[i].state = AIO_IDLE;
+    aio.wbuf[i].state = AIO_IDLE;
+  }
+  aio.sectors = blkGetInfo(AIO_DEVICE, &bdi) ? 0U : bdi.blk_num;
+  aio.error   = false;
+  chMtxUnlock(&aio.mtx);
+}
+
+static bool aio_read(BYTE *buff, DWORD sector, UINT count) {
+  unsigned i;
+
+  chMtxLock(&aio.mtx);
+
+  /* Pending writes of the same sectors are completed first.*/
+  for (i = 0U; i < 2U; i++) {
+    if (aio_overlaps(&aio.wbuf[i], sector, count)) {
+      aio_flush_writes();
+      break;
+    }
+  }
+
+  while (count > 0U) {
+    aio_buffer_t *bp = NULL;
+
+    for (i = 0U; i < 2U; i++) {
+      if (aio_overlaps(&aio.rbuf[i], sector, 1U)) {
+        bp = &aio.rbuf[i];
+      }
+    }
+
+    if (bp != NULL) {
+      UINT n;
+
+      /* Still loading.*/
+      if (bp->state == AIO_BUSY) {
+        chCondWait(&aio.cond);
+        continue;
+      }
+
+      /* Hit, copying and starting the read-ahead of the following
+         sectors.*/
+      n = bp->sector + bp->count - sector;
+      if (n > count) {
+        n = count;
+      }
+      memcpy(buff, &bp->data[(sector - bp->sector) * FF_MAX_SS],
+             (size_t)n * FF_MAX_SS);
+      buff   += (size_t)n * FF_MAX_SS;
+      sector += n;
+      count  -= n;
+      aio_prefetch(bp->sector + bp->count, bp);
+      continue;
+    }
+
+    if (count >= FATFS_ASYNC_READ_SECTORS) {
+      /* Large reads go directly to the caller buffer, the following
+         sectors are loaded meanwhile the caller processes the data.*/
+      chMtxUnlock(&aio.mtx);
+      if (aio_device_read(sector, buff, count)) {
+        return true;
+      }
+      chMtxLock(&aio.mtx);
+      aio_prefetch(sector + count, NULL);
+      break;
+    }
+
+    /* Miss, loading a whole buffer.*/
+    if (aio.rbuf[0].state != AIO_BUSY) {
+      bp = &aio.rbuf[0];
+    }
+    else if (aio.rbuf[1].state != AIO_BUSY) {
+      bp = &aio.rbuf[1];
+    }
+    else {
+      chCondWait(&aio.cond);
+      continue;
+    }
+    bp->sector = sector;
+    bp->count  = aio.sectors - sector < FATFS_ASYNC_READ_SECTORS ?
+                 (UINT)(aio.sectors - sector) : FATFS_ASYNC_READ_SECTORS;
+    bp->stale  = false;
+    bp->state  = AIO_BUSY;
+    chCondBroadcast(&aio.cond);
+    while (bp->state == AIO_BUSY) {
+      chCondWait(&aio.cond);
+    }
+    if ((bp->state != AIO_READY) && !bp->stale) {
+      chMtxUnlock(&aio.mtx);
+      return true;
+    }
+  }
+
+  chMtxUnlock(&aio.mtx);
+
+  return false;
+}
+
+#if !FF_FS_READONLY
+static bool aio_write(const BYTE *buff, DWORD sector, UINT count) {
+  aio_buffer_t *bp = NULL;
+  unsigned i;
+
+  chMtxLock(&aio.mtx);
+
+  /* Errors of queued writes are reported by the next write.*/
+  if (aio.error) {
+    aio.error = false;
+    chMtxUnlock(&aio.mtx);
+    return true;
+  }
+
+  /* Read-ahead data of the same sectors is discarded.*/
+  for (i = 0U; i < 2U; i++) {
+    if (aio_overlaps(&aio.rbuf[i], sector, count)) {
+      if (aio.rbuf[i].state == AIO_BUSY) {
+        aio.rbuf[i].stale = true;
+      }
+      else {
+        aio.rbuf[i].state = AIO_IDLE;
+      }
+    }
+  }
+
+  /* Buffer being filled, queued if the new data is not adjacent or does
+     not fit.*/
+  for (i = 0U; i < 2U; i++) {
+    if (aio.wbuf[i].state == AIO_READY) {
+      bp = &aio.wbuf[i];
+      if ((sector != bp->sector + bp->count) ||
+          (bp->count + count > FATFS_ASYNC_WRITE_SECTORS)) {
+        aio_submit_write(bp);
+        bp = NULL;
+      }
+    }
+  }
+
+  if (count >= FATFS_ASYNC_WRITE_SECTORS) {
+    /* Large writes go directly to the device after the queued ones.*/
+    aio_flush_writes();
+    chMtxUnlock(&aio.mtx);
+    return aio_device_write(sector, buff, count);
+  }
+
+  if (bp == NULL) {
+    /* There is always a free buffer, only one write at time is queued.*/
+    bp = aio.wbuf[0].state == AIO_IDLE ? &aio.wbuf[0] : &aio.wbuf[1];
+    bp->sector = sector;
+    bp->count  = 0U;
+    bp->state  = AIO_READY;
+  }
+  memcpy(&bp->data[(size_t)bp->count * FF_MAX_SS], buff,
+         (size_t)count * FF_MAX_SS);
+  bp->count += count;
+  if (bp->count >= FATFS_ASYNC_WRITE_SECTORS) {
+    aio_submit_write(bp);
+  }
+
+  chMtxUnlock(&aio.mtx);
+
+  return false;
+}
+
+static bool aio_sync(void) {
+  bool err;
+
+  chMtxLock(&aio.mtx);
+  aio_flush_writes();
+  err = aio.error;
+  aio.error = false;
+  chMtxUnlock(&aio.mtx);
+
+  chMtxLock(&aio.dmtx);
+  err = blkSync(AIO_DEVICE) || err;
+  chMtxUnlock(&aio.dmtx);
+
+  return err;
+}
+#endif /* !FF_FS_READONLY */
+
+#endif /* FATFS_USE_ASYNC_IO */
+
 /*-----------------------------------------------------------------------*/
 /* Correspondence between physical drive number and physical drive.      */
 
@@ -51,6 +480,10 @@ DSTATUS disk_initialize (
       stat |= STA_NOINIT;
     if (blkIsWriteProtected(&FATFS_HAL_DEVICE))
       stat |= STA_PROTECT;
+#if FATFS_USE_ASYNC_IO
+    if (!(stat & STA_NOINIT))
+      aio_init();
+#endif
     return stat;
   }
   return STA_NOINIT;
@@ -96,8 +529,13 @@ DRESULT disk_read (
   case 0:
     if (blkGetDriverState(&FATFS_HAL_DEVICE) != BLK_READY)
       return RES_NOTRDY;
+#if FATFS_USE_ASYNC_IO
+    if (aio_read(buff, sector, count))
+      return RES_ERROR;
+#else
     if (blkRead(&FATFS_HAL_DEVICE, sector, buff, count))
       return RES_ERROR;
+#endif
     return RES_OK;
   }
   return RES_PARERR;
@@ -120,8 +558,13 @@ DRESULT disk_write (
   case 0:
     if (blkGetDriverState(&FATFS_HAL_DEVICE) != BLK_READY)
       return RES_NOTRDY;
+#if FATFS_USE_ASYNC_IO
+    if (aio_write(buff, sector, count))
+      return RES_ERROR;
+#else
     if (blkWrite(&FATFS_HAL_DEVICE, sector, buff, count))
       return RES_ERROR;
+#endif
     return RES_OK;
   }
   return RES_PARERR;
@@ -147,6 +590,11 @@ DRESULT disk_ioctl (
   case 0:
     switch (cmd) {
     case CTRL_SYNC:
+#if FATFS_USE_ASYNC_IO && !FF_FS_READONLY
+      /* Queued writes are completed before returning.*/
+      if (aio_sync())
+        return RES_ERROR;
+#endif
       return RES_OK;
     case GET_SECTOR_COUNT:
       if (blkGetInfo(&FATFS_HAL_DEVICE, &bdi)) {
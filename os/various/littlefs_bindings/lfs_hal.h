@@ -42,6 +42,27 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Slicing-by-8 CRC calculation.
+ * @details If enabled the CRC-32 is calculated eight bytes at time using
+ *          8kB of constant tables, else a 64 bytes table is used and the
+ *          data is processed one nibble at time.
+ */
+#if !defined(LFS_HAL_CRC_USE_SLICING8) || defined(__DOXYGEN__)
+#define LFS_HAL_CRC_USE_SLICING8            TRUE
+#endif
+
+/**
+ * @brief   CRC calculation hook.
+ * @details If defined then the CRC-32 calculation is delegated to this
+ *          macro, for example in order to use a CRC unit. The macro must
+ *          return the reflected CRC-32 (polynomial 0x04C11DB7) of the
+ *          buffer starting from @p crc, without final inversion.
+ */
+#if defined(__DOXYGEN__)
+#define LFS_HAL_CRC_HOOK(crc, buffer, size)
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -50,6 +71,43 @@
 /* Module data structures and types.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Type of a flash cache object.
+ * @details A cache object sits between LittleFS and the flash driver, reads
+ *          are performed by whole lines and kept in a read buffer.
+ * @note    Program operations are written immediately and invalidate the
+ *          cached data they overlap, LittleFS already coalesces programs
+ *          in its own program cache and verifies them by reading back the
+ *          flash, delaying them would hide program errors.
+ */
+typedef struct {
+  /**
+   * @brief   Flash device.
+   */
+  BaseFlash                 *flp;
+  /**
+   * @brief   Read buffer or @p NULL.
+   */
+  uint8_t                   *rbuf;
+  /**
+   * @brief   Size of the read buffer, it must be a multiple of the
+   *          @p read_size and a divider of the @p block_size.
+   */
+  lfs_size_t                rsize;
+  /**
+   * @brief   Block of the data in the read buffer.
+   */
+  lfs_block_t               rblock;
+  /**
+   * @brief   Offset of the data in the read buffer.
+   */
+  lfs_off_t                 roff;
+  /**
+   * @brief   The read buffer contains valid data.
+   */
+  bool                      rvalid;
+} lfs_hal_cache_t;
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -69,6 +127,16 @@ extern "C" {
   int __lfs_sync(const struct lfs_config *c);
   int __lfs_lock(const struct lfs_config *c);
   int __lfs_unlock(const struct lfs_config *c);
+  void lfsHalCacheObjectInit(lfs_hal_cache_t *cp, BaseFlash *flp,
+                             uint8_t *rbuf, lfs_size_t rsize);
+  int __lfs_cache_read(const struct lfs_config *c, lfs_block_t block,
+                       lfs_off_t off, void *buffer, lfs_size_t size);
+  int __lfs_cache_prog(const struct lfs_config *c, lfs_block_t block,
+                       lfs_off_t off, const void *buffer, lfs_size_t size);
+  int __lfs_cache_erase(const struct lfs_config *c, lfs_block_t block);
+  int __lfs_cache_sync(const struct lfs_config *c);
+  int __lfs_cache_lock(const struct lfs_config *c);
+  int __lfs_cache_unlock(const struct lfs_config *c);
 #ifdef __cplusplus
 }
 #endif
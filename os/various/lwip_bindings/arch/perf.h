@@ -51,7 +51,43 @@
 #ifndef __PERF_H__
 #define __PERF_H__
 
+#include <hal.h>
+
+/*
+ * Number of distinct measurement points recorded by PERF_STOP(), further
+ * points are ignored.
+ */
+#ifndef LWIP_PERF_ENTRIES
+#define LWIP_PERF_ENTRIES 16
+#endif
+
+#if PORT_SUPPORTS_RT == TRUE
+/*
+ * Accumulated measurements of a point, times are realtime counter cycles.
+ */
+typedef struct {
+  const char    *name;
+  uint32_t      count;
+  rtcnt_t       last;
+  rtcnt_t       max;
+  uint64_t      total;
+} sys_perf_entry_t;
+
+#define PERF_START      rtcnt_t lwip_perf_start = chSysGetRealtimeCounterX()
+#define PERF_STOP(x)    sys_perf_record(x, lwip_perf_start)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void sys_perf_record(const char *name, rtcnt_t start);
+  const sys_perf_entry_t *sys_perf_get_entries(unsigned *np);
+  void sys_perf_reset(void);
+#ifdef __cplusplus
+}
+#endif
+#else
 #define PERF_START
 #define PERF_STOP(x)
+#endif
 
 #endif /* __PERF_H__ */
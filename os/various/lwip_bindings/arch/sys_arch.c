@@ -63,20 +63,220 @@
 #include "arch/sys_arch.h"
 #include "lwipopts.h"
 
+#include <string.h>
+
+#if LWIP_PERF
+#include "arch/perf.h"
+#endif
+
 #ifndef CH_LWIP_USE_MEM_POOLS 
 #define CH_LWIP_USE_MEM_POOLS FALSE
 #endif
 
 #if CH_LWIP_USE_MEM_POOLS 
+#if !CH_LWIP_USE_FAST_SYS_ARCH
 static MEMORYPOOL_DECL(lwip_sys_arch_sem_pool, sizeof(semaphore_t), 4, chCoreAllocAlignedI);
 static MEMORYPOOL_DECL(lwip_sys_arch_mbox_pool, sizeof(mailbox_t) + sizeof(msg_t) * TCPIP_MBOX_SIZE, 4, chCoreAllocAlignedI);
+#endif
 static MEMORYPOOL_DECL(lwip_sys_arch_thread_pool, THD_WORKING_AREA_SIZE(TCPIP_THREAD_STACKSIZE), PORT_WORKING_AREA_ALIGN, chCoreAllocAlignedI);
 #endif
 
+#if LWIP_PERF && (PORT_SUPPORTS_RT == TRUE)
+static sys_perf_entry_t perf_entries[LWIP_PERF_ENTRIES];
+static unsigned perf_n;
+#endif
+
 void sys_init(void) {
 
 }
 
+#if CH_LWIP_USE_FAST_SYS_ARCH
+/*
+ * Returns the milliseconds elapsed since the specified time.
+ */
+static u32_t sys_arch_elapsed(systime_t start) {
+
+  return (u32_t)TIME_I2MS(chTimeDiffX(start, chVTGetSystemTimeX()));
+}
+
+#if CH_DBG_ENABLE_ASSERTS == TRUE
+/*
+ * Marks the calling thread as the consumer of a fast mailbox for the
+ * duration of a fetch, a second thread fetching at the same time is an
+ * error.
+ */
+static void sys_mbox_enter(sys_mbox_t *mbox) {
+
+  chSysLock();
+  chDbgAssert(mbox->consumer == NULL, "concurrent fetch");
+  mbox->consumer = chThdGetSelfX();
+  chSysUnlock();
+}
+
+static void sys_mbox_leave(sys_mbox_t *mbox) {
+
+  chSysLock();
+  mbox->consumer = NULL;
+  chSysUnlock();
+}
+#else
+#define sys_mbox_enter(mbox) (void)(mbox)
+#define sys_mbox_leave(mbox) (void)(mbox)
+#endif
+
+err_t sys_sem_new(sys_sem_t *sem, u8_t count) {
+
+  chFSemObjectInit(&sem->sem, (cnt_t)count);
+  sem->valid = true;
+  SYS_STATS_INC_USED(sem);
+  return ERR_OK;
+}
+
+void sys_sem_free(sys_sem_t *sem) {
+
+  sem->valid = false;
+  SYS_STATS_DEC(sem.used);
+}
+
+void sys_sem_signal(sys_sem_t *sem) {
+
+  chFSemSignal(&sem->sem);
+}
+
+/* CHIBIOS FIX: specific variant of this call to be called from within
+   a lock.*/
+void sys_sem_signal_S(sys_sem_t *sem) {
+
+  chFSemSignalI(&sem->sem);
+  chSchRescheduleS();
+}
+
+u32_t sys_arch_sem_wait(sys_sem_t *sem, u32_t timeout) {
+  systime_t start;
+  sysinterval_t tmo;
+
+  tmo = timeout > 0 ? TIME_MS2I((time_msecs_t)timeout) : TIME_INFINITE;
+  start = chVTGetSystemTimeX();
+  if (chFSemWaitTimeout(&sem->sem, tmo) != MSG_OK) {
+    return SYS_ARCH_TIMEOUT;
+  }
+  return sys_arch_elapsed(start);
+}
+
+int sys_sem_valid(sys_sem_t *sem) {
+  return sem->valid;
+}
+
+void sys_sem_set_invalid(sys_sem_t *sem) {
+  sem->valid = false;
+}
+
+err_t sys_mbox_new(sys_mbox_t *mbox, int size) {
+
+  /* Zero means the default size, the full capacity.*/
+  if (size <= 0)
+    size = CH_LWIP_MBOX_SLOTS;
+  if (size > CH_LWIP_MBOX_SLOTS) {
+    SYS_STATS_INC(mbox.err);
+    return ERR_MEM;
+  }
+  chRingQueueObjectInit(&mbox->rq, mbox->slots, CH_LWIP_MBOX_SLOTS);
+  chFSemObjectInit(&mbox->free, (cnt_t)size);
+#if CH_DBG_ENABLE_ASSERTS == TRUE
+  mbox->consumer = NULL;
+#endif
+  mbox->valid = true;
+  SYS_STATS_INC(mbox.used);
+  return ERR_OK;
+}
+
+void sys_mbox_free(sys_mbox_t *mbox) {
+  msg_t msg;
+
+  if (chMpscRingGetX(&mbox->rq.ring, &msg) == MSG_OK) {
+    // If there are messages still present in the mailbox when the mailbox
+    // is deallocated, it is an indication of a programming error in lwIP
+    // and the developer should be notified.
+    SYS_STATS_INC(mbox.err);
+  }
+  mbox->valid = false;
+  SYS_STATS_DEC(mbox.used);
+}
+
+void sys_mbox_post(sys_mbox_t *mbox, void *msg) {
+
+  /* Reserving a slot, a reserved slot is always available in the ring.*/
+  (void) chFSemWait(&mbox->free);
+  (void) chRingQueuePostX(&mbox->rq, (msg_t)msg);
+}
+
+err_t sys_mbox_trypost(sys_mbox_t *mbox, void *msg) {
+
+  if (chFSemWaitTimeout(&mbox->free, TIME_IMMEDIATE) != MSG_OK) {
+    SYS_STATS_INC(mbox.err);
+    return ERR_MEM;
+  }
+  (void) chRingQueuePostX(&mbox->rq, (msg_t)msg);
+  return ERR_OK;
+}
+
+/*
+ * The ring queue wait can return without a message, the semaphore can be
+ * left signaled by a message already fetched, so the wait is repeated with
+ * the remaining time instead of the whole timeout.
+ */
+u32_t sys_arch_mbox_fetch(sys_mbox_t *mbox, void **msg, u32_t timeout) {
+  systime_t start;
+  sysinterval_t tmo, elapsed;
+  msg_t wmsg;
+
+  sys_mbox_enter(mbox);
+  tmo = timeout > 0 ? TIME_MS2I((time_msecs_t)timeout) : TIME_INFINITE;
+  start = chVTGetSystemTimeX();
+  while (chMpscRingGetX(&mbox->rq.ring, (msg_t *)msg) != MSG_OK) {
+    if (tmo == TIME_INFINITE) {
+      wmsg = chFBSemWaitTimeout(&mbox->rq.bsem, TIME_INFINITE);
+    }
+    else {
+      elapsed = chTimeDiffX(start, chVTGetSystemTimeX());
+      if (elapsed >= tmo) {
+        wmsg = MSG_TIMEOUT;
+      }
+      else {
+        wmsg = chFBSemWaitTimeout(&mbox->rq.bsem, tmo - elapsed);
+      }
+    }
+    if (wmsg != MSG_OK) {
+      sys_mbox_leave(mbox);
+      return SYS_ARCH_TIMEOUT;
+    }
+  }
+  sys_mbox_leave(mbox);
+  chFSemSignal(&mbox->free);
+  return sys_arch_elapsed(start);
+}
+
+u32_t sys_arch_mbox_tryfetch(sys_mbox_t *mbox, void **msg) {
+  msg_t rmsg;
+
+  sys_mbox_enter(mbox);
+  rmsg = chRingQueueFetchTimeout(&mbox->rq, (msg_t *)msg, TIME_IMMEDIATE);
+  sys_mbox_leave(mbox);
+  if (rmsg != MSG_OK)
+    return SYS_MBOX_EMPTY;
+  chFSemSignal(&mbox->free);
+  return 0;
+}
+
+int sys_mbox_valid(sys_mbox_t *mbox) {
+  return mbox->valid;
+}
+
+void sys_mbox_set_invalid(sys_mbox_t *mbox) {
+  mbox->valid = false;
+}
+
+#else /* !CH_LWIP_USE_FAST_SYS_ARCH */
 err_t sys_sem_new(sys_sem_t *sem, u8_t count) {
 
 #if !CH_LWIP_USE_MEM_POOLS
@@ -234,6 +434,8 @@ void sys_mbox_set_invalid(sys_mbox_t *mbox) {
   *mbox = SYS_MBOX_NULL;
 }
 
+#endif /* !CH_LWIP_USE_FAST_SYS_ARCH */
+
 sys_thread_t sys_thread_new(const char *name, lwip_thread_fn thread,
                             void *arg, int stacksize, int prio) {
   thread_t *tp;
@@ -271,3 +473,50 @@ u32_t sys_now(void) {
   return (u32_t)(((u64_t)(chVTGetSystemTimeX() - 1) * 1000) / OSAL_ST_FREQUENCY) + 1;
 #endif
 }
+
+#if LWIP_PERF && (PORT_SUPPORTS_RT == TRUE)
+/* Records a measurement started by PERF_START, the point is identified
+   by its name.*/
+void sys_perf_record(const char *name, rtcnt_t start) {
+  rtcnt_t cycles = chSysGetRealtimeCounterX() - start;
+  sys_perf_entry_t *ep;
+  syssts_t sts;
+  unsigned i;
+
+  sts = chSysGetStatusAndLockX();
+  for (i = 0; i < perf_n; i++) {
+    ep = &perf_entries[i];
+    if ((ep->name == name) || (strcmp(ep->name, name) == 0))
+      break;
+  }
+  if (i == perf_n) {
+    if (perf_n >= LWIP_PERF_ENTRIES) {
+      chSysRestoreStatusX(sts);
+      return;
+    }
+    ep = &perf_entries[perf_n++];
+    ep->name = name;
+  }
+  ep->count++;
+  ep->last = cycles;
+  if (cycles > ep->max)
+    ep->max = cycles;
+  ep->total += (uint64_t)cycles;
+  chSysRestoreStatusX(sts);
+}
+
+const sys_perf_entry_t *sys_perf_get_entries(unsigned *np) {
+
+  *np = perf_n;
+  return perf_entries;
+}
+
+void sys_perf_reset(void) {
+  syssts_t sts;
+
+  sts = chSysGetStatusAndLockX();
+  memset(perf_entries, 0, sizeof (perf_entries));
+  perf_n = 0;
+  chSysRestoreStatusX(sts);
+}
+#endif
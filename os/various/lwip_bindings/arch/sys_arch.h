@@ -53,8 +53,65 @@
 #ifndef __SYS_ARCH_H__
 #define __SYS_ARCH_H__
 
+/*
+ * If enabled then semaphores and mailboxes are stored inline in the lwIP
+ * objects and use the fast semaphores and rings of the OS, the kernel is
+ * entered only when a thread has to sleep or to be awakened.
+ * Note, a mailbox must not be fetched by two threads at the same time,
+ * this is true for the tcpip thread mailbox and for netconns read by a
+ * single thread, the netconn mailboxes are drained by the tcpip thread
+ * only after the reader is done. Concurrent fetches are detected when
+ * CH_DBG_ENABLE_ASSERTS is enabled.
+ */
+#ifndef CH_LWIP_USE_FAST_SYS_ARCH
+#define CH_LWIP_USE_FAST_SYS_ARCH FALSE
+#endif
+
+/*
+ * Capacity of fast mailboxes, it must be a power of two not lower than
+ * the largest mailbox size requested by lwIP.
+ */
+#ifndef CH_LWIP_MBOX_SLOTS
+#define CH_LWIP_MBOX_SLOTS 16
+#endif
+
+#if CH_LWIP_USE_FAST_SYS_ARCH
+#if (CH_CFG_USE_SEMAPHORES == FALSE) || (CH_CFG_USE_RINGS == FALSE)
+#error "CH_LWIP_USE_FAST_SYS_ARCH requires CH_CFG_USE_SEMAPHORES and CH_CFG_USE_RINGS"
+#endif
+
+#if (CH_LWIP_MBOX_SLOTS & (CH_LWIP_MBOX_SLOTS - 1)) != 0
+#error "CH_LWIP_MBOX_SLOTS must be a power of two"
+#endif
+
+typedef struct {
+  fast_semaphore_t      sem;
+  bool                  valid;
+} sys_sem_t;
+
+/*
+ * Fast mailbox, producers reserve a slot on the "free" semaphore then put
+ * the message in the ring, the consumer sleeps on the ring queue only when
+ * the ring is empty.
+ */
+typedef struct {
+  ring_queue_t          rq;
+  fast_semaphore_t      free;
+  bool                  valid;
+#if (CH_DBG_ENABLE_ASSERTS == TRUE) || defined(__DOXYGEN__)
+  thread_t              *consumer;
+#endif
+  ring_slot_t           slots[CH_LWIP_MBOX_SLOTS];
+} sys_mbox_t;
+
+#define sys_sem_valid_val(sem)          ((sem).valid)
+#define sys_sem_set_invalid_val(sem)    ((sem).valid = false)
+#define sys_mbox_valid_val(mbox)        ((mbox).valid)
+#define sys_mbox_set_invalid_val(mbox)  ((mbox).valid = false)
+#else
 typedef semaphore_t *   sys_sem_t;
 typedef mailbox_t *     sys_mbox_t;
+#endif
 typedef thread_t *      sys_thread_t;
 typedef syssts_t        sys_prot_t;
 
@@ -82,6 +82,17 @@
 #define PERIODIC_TIMER_ID       1
 #define FRAME_RECEIVED_ID       2
 
+/*
+ * Zero-copy receive is possible only if frames can be passed by reference
+ * without the leading padding.
+ */
+#if (MAC_USE_ZERO_COPY == TRUE) && (ETH_PAD_SIZE == 0) &&                   \
+    (LWIP_SUPPORT_CUSTOM_PBUF == 1) && (LWIP_ZERO_COPY_RX_BUFFERS > 0)
+#define LWIP_USE_ZERO_COPY_RX   TRUE
+#else
+#define LWIP_USE_ZERO_COPY_RX   FALSE
+#endif
+
 /*
  * Suspension point for initialization procedure.
  */
@@ -92,6 +103,27 @@ thread_reference_t lwip_trp = NULL;
  */
 static THD_WORKING_AREA(wa_lwip_thread, LWIP_THREAD_STACK_SIZE);
 
+#if LWIP_USE_ZERO_COPY_RX == TRUE
+/*
+ * Custom pbuf referencing a MAC receive buffer, the descriptor is held
+ * until the pbuf is freed.
+ */
+typedef struct {
+  struct pbuf_custom    pc;
+  MACReceiveDescriptor  rd;
+} rx_pbuf_t;
+
+static rx_pbuf_t rx_pbufs[LWIP_ZERO_COPY_RX_BUFFERS];
+static memory_pool_t rx_pbufs_pool;
+#endif
+
+#if LWIP_RX_BATCH_SIZE > 0
+/*
+ * Receive batches statistics, updated under the core lock.
+ */
+static lwip_rx_stats_t rx_stats;
+#endif
+
 /*
  * Initialization.
  */
@@ -161,10 +193,54 @@ static err_t low_level_output(struct netif *netif, struct pbuf *p) {
   return ERR_OK;
 }
 
+#if LWIP_USE_ZERO_COPY_RX == TRUE
+/*
+ * Returns a received frame to the MAC, invoked by lwIP when the pbuf
+ * referencing the MAC buffer is freed.
+ */
+static void rx_pbuf_free(struct pbuf *p) {
+  rx_pbuf_t *rpp = (rx_pbuf_t *)(void *)p;
+
+  macReleaseReceiveDescriptorX(&rpp->rd);
+  chPoolFree(&rx_pbufs_pool, rpp);
+}
+
+/*
+ * Wraps a received frame in a pbuf referencing the MAC buffer.
+ * Returns NULL if the frame cannot be passed by reference, in that case
+ * the descriptor is left untouched and must be read normally.
+ */
+static struct pbuf *low_level_input_ref(MACReceiveDescriptor *rdp,
+                                        u16_t len) {
+  rx_pbuf_t *rpp;
+  const uint8_t *buf;
+  size_t size;
+
+  rpp = chPoolAlloc(&rx_pbufs_pool);
+  if (rpp == NULL) {
+    return NULL;
+  }
+
+  /* Frames spanning multiple buffers are copied, the descriptor copy is
+     used for scanning so that the original is still readable.*/
+  rpp->rd = *rdp;
+  buf = macGetNextReceiveBuffer(&rpp->rd, &size);
+  if ((buf == NULL) || (size != (size_t)len)) {
+    chPoolFree(&rx_pbufs_pool, rpp);
+    return NULL;
+  }
+
+  rpp->pc.custom_free_function = rx_pbuf_free;
+  return pbuf_alloced_custom(PBUF_RAW, len, PBUF_REF, &rpp->pc,
+                             (void *)buf, len);
+}
+#endif
+
 /*
  * Receives a frame.
  * Allocates a pbuf and transfers the bytes of the incoming
- * packet from the interface into the pbuf.
+ * packet from the interface into the pbuf. In zero-copy mode the pbuf
+ * references the MAC buffer directly if possible.
  *
  * @param netif the lwip network interface structure for this ethernetif
  * @return a pbuf filled with the received packet (including MAC header)
@@ -174,6 +250,7 @@ static bool low_level_input(struct netif *netif, struct pbuf **pbuf) {
   MACReceiveDescriptor rd;
   struct pbuf *q;
   u16_t len;
+  bool copy = true;
 
   (void)netif;
 
@@ -184,22 +261,32 @@ static bool low_level_input(struct netif *netif, struct pbuf **pbuf) {
 
   len = (u16_t)rd.size;
 
+#if LWIP_USE_ZERO_COPY_RX == TRUE
+  /* Trying to pass the frame by reference first.*/
+  *pbuf = low_level_input_ref(&rd, len);
+  copy = (bool)(*pbuf == NULL);
+  if (copy)
+#endif
+  {
 #if ETH_PAD_SIZE
-  len += ETH_PAD_SIZE;        /* allow room for Ethernet padding */
+    len += ETH_PAD_SIZE;        /* allow room for Ethernet padding */
 #endif
 
-  /* We allocate a pbuf chain of pbufs from the pool. */
-  *pbuf = pbuf_alloc(PBUF_RAW, len, PBUF_POOL);
+    /* We allocate a pbuf chain of pbufs from the pool. */
+    *pbuf = pbuf_alloc(PBUF_RAW, len, PBUF_POOL);
+  }
 
   if (*pbuf != NULL) {
 #if ETH_PAD_SIZE
     pbuf_header(*pbuf, -ETH_PAD_SIZE); /* drop the padding word */
 #endif
 
-    /* Iterates through the pbuf chain. */
-    for(q = *pbuf; q != NULL; q = q->next)
-      macReadReceiveDescriptor(&rd, (uint8_t *)q->payload, (size_t)q->len);
-    macReleaseReceiveDescriptorX(&rd);
+    if (copy) {
+      /* Iterates through the pbuf chain. */
+      for(q = *pbuf; q != NULL; q = q->next)
+        macReadReceiveDescriptor(&rd, (uint8_t *)q->payload, (size_t)q->len);
+      macReleaseReceiveDescriptorX(&rd);
+    }
 
     MIB2_STATS_NETIF_ADD(netif, ifinoctets, (*pbuf)->tot_len);
 
@@ -228,6 +315,61 @@ static bool low_level_input(struct netif *netif, struct pbuf **pbuf) {
   return true;
 }
 
+#if LWIP_RX_BATCH_SIZE > 0
+/*
+ * Receives a batch of frames.
+ * Up to LWIP_RX_BATCH_SIZE frames are fetched from the MAC and fed to
+ * the stack while holding the core lock once for the whole batch.
+ *
+ * @param netif the lwip network interface structure for this ethernetif
+ * @return true if the MAC has been drained, false if the budget has been
+ *         exhausted and more frames could be pending.
+ */
+static bool low_level_input_batch(struct netif *netif) {
+  struct pbuf *p;
+  uint32_t n = 0U;
+  bool drained = false;
+
+  LOCK_TCPIP_CORE();
+  while (n < (uint32_t)LWIP_RX_BATCH_SIZE) {
+    if (!low_level_input(netif, &p)) {
+      drained = true;
+      break;
+    }
+    n++;
+    if (p != NULL) {
+      struct eth_hdr *ethhdr = p->payload;
+      switch (htons(ethhdr->type)) {
+        /* IP or ARP packet? */
+        case ETHTYPE_IP:
+        case ETHTYPE_ARP:
+          /* full packet processed here, the core is already locked */
+          if (ethernet_input(p, netif) == ERR_OK)
+            break;
+          LWIP_DEBUGF(NETIF_DEBUG, ("ethernetif_input: IP input error\n"));
+      /* Falls through */
+        default:
+          pbuf_free(p);
+      }
+    }
+  }
+
+  if (n > 0U) {
+    rx_stats.batches++;
+    rx_stats.frames += n;
+    if (n > rx_stats.max_batch) {
+      rx_stats.max_batch = n;
+    }
+    if (!drained) {
+      rx_stats.exhausted++;
+    }
+  }
+  UNLOCK_TCPIP_CORE();
+
+  return drained;
+}
+#endif
+
 /*
  * Called at the beginning of the program to set up the
  * network interface. It calls the function low_level_init() to do the
@@ -366,6 +508,11 @@ static THD_FUNCTION(lwip_thread, p) {
     thisif.hostname = LWIP_NETIF_HOSTNAME_STRING;
 #endif
 
+#if LWIP_USE_ZERO_COPY_RX == TRUE
+  chPoolObjectInit(&rx_pbufs_pool, sizeof (rx_pbuf_t), NULL);
+  chPoolLoadArray(&rx_pbufs_pool, rx_pbufs, LWIP_ZERO_COPY_RX_BUFFERS);
+#endif
+
   macStart(&ETHD1, &mac_config);
 
   MIB2_INIT_NETIF(&thisif, snmp_ifType_ethernet_csmacd, 0);
@@ -412,6 +559,12 @@ static THD_FUNCTION(lwip_thread, p) {
     }
 
     if (mask & FRAME_RECEIVED_ID) {
+#if LWIP_RX_BATCH_SIZE > 0
+      /* If the budget has been exhausted then the event is re-armed, the
+         next batch is served after the other pending events.*/
+      if (!low_level_input_batch(&thisif))
+        chEvtAddEvents(FRAME_RECEIVED_ID);
+#else
       struct pbuf *p;
       while (low_level_input(&thisif, &p)) {
         if (p != NULL) {
@@ -430,6 +583,7 @@ static THD_FUNCTION(lwip_thread, p) {
           }
         }
       }
+#endif
     }
   }
 }
@@ -528,4 +682,18 @@ void lwipReconfigure(const lwipreconf_opts_t *opts)
   chSemWait(&params.completion);
 }
 
+#if (LWIP_RX_BATCH_SIZE > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the receive batches statistics.
+ *
+ * @param[out] statsp   pointer to the statistics structure to be filled
+ */
+void lwipGetRxStats(lwip_rx_stats_t *statsp) {
+
+  LOCK_TCPIP_CORE();
+  *statsp = rx_stats;
+  UNLOCK_TCPIP_CORE();
+}
+#endif
+
 /** @} */
@@ -96,6 +96,43 @@
 #define LWIP_SEND_TIMEOUT                   50
 #endif
 
+/**
+ * @brief   Number of receive buffers that can be lent to the stack.
+ * @details If greater than zero then received frames are passed to lwIP
+ *          as references to the MAC buffers, the buffers are returned to
+ *          the MAC when the pbufs are freed. This setting limits the
+ *          number of buffers held by the stack at any time, further
+ *          frames are copied and their buffers released immediately.
+ *          If zero then all frames are copied.
+ * @note    Only effective if @p MAC_USE_ZERO_COPY is enabled, it must
+ *          be lower than the number of receive buffers of the MAC.
+ * @note    MACs with a ring of receive descriptors, STM32 MACv1 and the
+ *          simulator included, fill the descriptors in order. A lent
+ *          buffer stops reception when the DMA wraps around to it and
+ *          frames are dropped until the pbuf is freed. Enable only if
+ *          received pbufs are freed quickly, pbufs held by TCP
+ *          out-of-sequence queues or by IP reassembly stall the MAC
+ *          until those are released or expired.
+ */
+#if !defined(LWIP_ZERO_COPY_RX_BUFFERS) || defined(__DOXYGEN__)
+#define LWIP_ZERO_COPY_RX_BUFFERS           0
+#endif
+
+/**
+ * @brief   Receive batch size.
+ * @details If greater than zero then the lwIP thread drains up to this
+ *          number of frames from the MAC on each receive event and feeds
+ *          them to the stack under a single core lock, if more frames are
+ *          pending then the event is re-armed and served again after the
+ *          other events. If zero then each frame is posted to the tcpip
+ *          thread.
+ * @note    In batch mode the frames are processed by the lwIP thread, its
+ *          stack size and priority must be adequate.
+ */
+#if !defined(LWIP_RX_BATCH_SIZE) || defined(__DOXYGEN__)
+#define LWIP_RX_BATCH_SIZE                  0
+#endif
+
 /**
  * @brief   Link speed.
  */
@@ -259,6 +296,30 @@ typedef struct lwipreconf_opts {
   net_addr_mode_t addrMode;
 } lwipreconf_opts_t;
 
+#if (LWIP_RX_BATCH_SIZE > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Receive batches statistics.
+ */
+typedef struct lwip_rx_stats {
+  /**
+   * @brief   Number of non-empty batches.
+   */
+  uint32_t        batches;
+  /**
+   * @brief   Number of frames fetched from the MAC.
+   */
+  uint32_t        frames;
+  /**
+   * @brief   Largest batch.
+   */
+  uint32_t        max_batch;
+  /**
+   * @brief   Number of batches terminated by the budget.
+   */
+  uint32_t        exhausted;
+} lwip_rx_stats_t;
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -266,6 +327,9 @@ extern "C" {
   void lwipDefaultLinkDownCB(void *p);
   void lwipInit(const lwipthread_opts_t *opts);
   void lwipReconfigure(const lwipreconf_opts_t *opts);
+#if (LWIP_RX_BATCH_SIZE > 0) || defined(__DOXYGEN__)
+  void lwipGetRxStats(lwip_rx_stats_t *statsp);
+#endif
 #ifdef __cplusplus
 }
 #endif
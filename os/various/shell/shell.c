@@ -22,6 +22,7 @@
  * @{
  */
 
+#include <limits.h>
 #include <string.h>
 
 #include "ch.h"
@@ -49,10 +50,57 @@ event_source_t shell_terminated;
 /* Module local types.                                                       */
 /*===========================================================================*/
 
+#if (SHELL_USE_HASH == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Commands hash table type.
+ * @details Slots contain the index plus one of a command in the sequence
+ *          of the built-in commands followed by the user commands, zero
+ *          marks an empty slot.
+ */
+typedef struct {
+  const ShellCommand    *local;             /**< @brief Built-in commands.  */
+  const ShellCommand    *user;              /**< @brief User commands.      */
+  unsigned              nlocal;             /**< @brief Number of built-in
+                                                 commands.                  */
+  uint32_t              seed;               /**< @brief Hash seed.          */
+  bool                  valid;              /**< @brief Table in use.       */
+  uint8_t               slots[SHELL_HASH_SIZE];
+} shell_hash_t;
+#endif
+
+#if (SHELL_USE_OUTPUT_BUFFER == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Buffered output stream type.
+ * @details It is allocated on the shell thread stack, writes go into the
+ *          queue and the flush thread moves the data to the shell channel,
+ *          reads are forwarded to the shell channel.
+ */
+typedef struct shell_output {
+  const struct BaseSequentialStreamVMT *vmt;/**< @brief Virtual Methods
+                                                 Table.                     */
+  struct shell_output   *next;              /**< @brief Next active buffered
+                                                 output.                    */
+  thread_t              *owner;             /**< @brief Shell thread.       */
+  BaseSequentialStream  *sink;              /**< @brief Shell channel.      */
+  output_queue_t        queue;              /**< @brief Output buffer.      */
+  binary_semaphore_t    sem;                /**< @brief Data available or
+                                                 stop request.              */
+  volatile bool         stop;               /**< @brief Stop request.       */
+  thread_t              *tp;                /**< @brief Flush thread.       */
+} shell_output_t;
+#endif
+
 /*===========================================================================*/
 /* Module local variables.                                                   */
 /*===========================================================================*/
 
+#if (SHELL_USE_OUTPUT_BUFFER == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   List of the active buffered outputs.
+ */
+static shell_output_t *shell_outputs;
+#endif
+
 /*===========================================================================*/
 /* Module local functions.                                                   */
 /*===========================================================================*/
@@ -98,19 +146,285 @@ static void list_commands(BaseSequentialStream *chp, const ShellCommand *scp) {
   }
 }
 
-static bool cmdexec(const ShellCommand *scp, BaseSequentialStream *chp,
-                      char *name, int argc, char *argv[]) {
+static const ShellCommand *cmdfind(const ShellCommand *scp,
+                                   const char *name) {
 
   while (scp->sc_name != NULL) {
     if (strcmp(scp->sc_name, name) == 0) {
-      scp->sc_function(chp, argc, argv);
-      return false;
+      return scp;
     }
     scp++;
   }
-  return true;
+  return NULL;
+}
+
+#if (SHELL_USE_HASH == TRUE) || defined(__DOXYGEN__)
+static unsigned hash_count(const ShellCommand *scp) {
+  unsigned n = 0U;
+
+  while (scp[n].sc_name != NULL) {
+    n++;
+  }
+  return n;
+}
+
+static const ShellCommand *hash_command(const shell_hash_t *hp, unsigned i) {
+
+  if (i < hp->nlocal) {
+    return &hp->local[i];
+  }
+  return &hp->user[i - hp->nlocal];
+}
+
+/*
+ * FNV-1a hash of the command name, the seed is mixed in the initial value.
+ */
+static unsigned hash_slot(const char *name, uint32_t seed) {
+  uint32_t h = 2166136261U ^ (seed * 0x9E3779B9U);
+
+  while (*name != '\0') {
+    h ^= (uint32_t)(uint8_t)*name++;
+    h *= 16777619U;
+  }
+  return (unsigned)(h ^ (h >> 16)) & (SHELL_HASH_SIZE - 1U);
+}
+
+/*
+ * Fills the table using the specified seed, collisions are resolved by
+ * linear probing. Returns the length of the longest probe sequence, one
+ * means that the table is collision-free.
+ */
+static unsigned hash_fill(shell_hash_t *hp, uint32_t seed, unsigned count) {
+  unsigned i, maxprobes = 1U;
+
+  memset(hp->slots, 0, sizeof (hp->slots));
+  for (i = 0U; i < count; i++) {
+    const char *name = hash_command(hp, i)->sc_name;
+    unsigned slot = hash_slot(name, seed);
+    unsigned probes = 1U;
+
+    while (hp->slots[slot] != 0U) {
+      /* Duplicated names, the first one hides the others as it happens
+         with the linear scan.*/
+      if (strcmp(hash_command(hp, hp->slots[slot] - 1U)->sc_name,
+                 name) == 0) {
+        break;
+      }
+      slot = (slot + 1U) & (SHELL_HASH_SIZE - 1U);
+      probes++;
+    }
+    if (hp->slots[slot] == 0U) {
+      hp->slots[slot] = (uint8_t)(i + 1U);
+    }
+    if (probes > maxprobes) {
+      maxprobes = probes;
+    }
+  }
+  return maxprobes;
+}
+
+/*
+ * Builds the commands table, a seed giving a collision-free table is
+ * searched, if none is found then the seed giving the shortest probe
+ * sequences is used.
+ */
+static void hash_init(shell_hash_t *hp, const ShellCommand *scp) {
+  unsigned count, probes, bestprobes = UINT_MAX;
+  uint32_t seed, bestseed = 0U;
+
+  hp->local  = shell_local_commands;
+  hp->user   = scp;
+  hp->nlocal = hash_count(shell_local_commands);
+  count      = hp->nlocal;
+  if (scp != NULL) {
+    count += hash_count(scp);
+  }
+
+  /* Keeping at least 1/4 of the slots empty, else the linear scan is
+     used.*/
+  hp->valid = count <= ((SHELL_HASH_SIZE * 3U) / 4U);
+  if (!hp->valid) {
+    return;
+  }
+
+  for (seed = 0U; seed < (uint32_t)SHELL_HASH_SEEDS; seed++) {
+    probes = hash_fill(hp, seed, count);
+    if (probes < bestprobes) {
+      bestprobes = probes;
+      bestseed   = seed;
+      if (probes == 1U) {
+        break;
+      }
+    }
+  }
+  if (bestprobes > 1U) {
+    (void) hash_fill(hp, bestseed, count);
+  }
+  hp->seed = bestseed;
+}
+
+static const ShellCommand *hash_find(const shell_hash_t *hp,
+                                     const char *name) {
+  unsigned slot = hash_slot(name, hp->seed);
+
+  while (hp->slots[slot] != 0U) {
+    const ShellCommand *scp = hash_command(hp, hp->slots[slot] - 1U);
+
+    if (strcmp(scp->sc_name, name) == 0) {
+      return scp;
+    }
+    slot = (slot + 1U) & (SHELL_HASH_SIZE - 1U);
+  }
+  return NULL;
+}
+#endif /* SHELL_USE_HASH == TRUE */
+
+#if (SHELL_USE_OUTPUT_BUFFER == TRUE) || defined(__DOXYGEN__)
+static size_t out_write(void *ip, const uint8_t *bp, size_t n) {
+
+  return oqWriteTimeout(&((shell_output_t *)ip)->queue, bp, n, TIME_INFINITE);
+}
+
+static size_t out_read(void *ip, uint8_t *bp, size_t n) {
+
+  return streamRead(((shell_output_t *)ip)->sink, bp, n);
+}
+
+static msg_t out_put(void *ip, uint8_t b) {
+
+  return oqPutTimeout(&((shell_output_t *)ip)->queue, b, TIME_INFINITE);
+}
+
+static msg_t out_get(void *ip) {
+
+  return streamGet(((shell_output_t *)ip)->sink);
+}
+
+static const struct BaseSequentialStreamVMT out_vmt = {
+  (size_t)0, out_write, out_read, out_put, out_get
+};
+
+static void out_notify(io_queue_t *qp) {
+  shell_output_t *outp = qGetLink(qp);
+
+  chBSemSignalI(&outp->sem);
+}
+
+/*
+ * Flush thread, the queue is emptied in small chunks so that the shell
+ * can keep writing while the channel is busy.
+ */
+static THD_FUNCTION(out_thread, p) {
+  shell_output_t *outp = p;
+  uint8_t buf[32];
+  size_t n;
+
+  chRegSetThreadName(SHELL_OUTPUT_THREAD_NAME);
+
+  while (true) {
+    (void) chBSemWait(&outp->sem);
+    do {
+      n = 0U;
+      chSysLock();
+      while (n < sizeof (buf)) {
+        msg_t msg = oqGetI(&outp->queue);
+        if (msg < MSG_OK) {
+          break;
+        }
+        buf[n++] = (uint8_t)msg;
+      }
+      chSchRescheduleS();
+      chSysUnlock();
+      if (n > 0U) {
+        (void) streamWrite(outp->sink, buf, n);
+      }
+    } while (n > 0U);
+
+    /* The stop request is posted after the last write so the queue is
+       empty at this point.*/
+    if (outp->stop) {
+      break;
+    }
+  }
+}
+
+/*
+ * Starts buffering the output of the calling shell thread, on failure the
+ * shell channel is returned and the output is not buffered.
+ */
+static BaseSequentialStream *out_start(shell_output_t *outp,
+                                       BaseSequentialStream *sink,
+                                       size_t size) {
+  tprio_t prio = chThdGetPriorityX();
+  uint8_t *bp;
+
+  bp = chHeapAlloc(NULL, size);
+  if (bp == NULL) {
+    return sink;
+  }
+
+  outp->vmt   = &out_vmt;
+  outp->owner = chThdGetSelfX();
+  outp->sink  = sink;
+  outp->stop  = false;
+  oqObjectInit(&outp->queue, bp, size, out_notify, outp);
+  chBSemObjectInit(&outp->sem, true);
+
+  /* The flush thread runs when the shell waits, commands are never delayed
+     by the channel unless the buffer is full.*/
+  outp->tp = chThdCreateFromHeap(NULL,
+                                 THD_WORKING_AREA_SIZE(SHELL_OUTPUT_STACK_SIZE),
+                                 SHELL_OUTPUT_THREAD_NAME,
+                                 prio > LOWPRIO ? prio - 1U : LOWPRIO,
+                                 out_thread, outp);
+  if (outp->tp == NULL) {
+    chHeapFree(bp);
+    return sink;
+  }
+
+  chSysLock();
+  outp->next    = shell_outputs;
+  shell_outputs = outp;
+  chSysUnlock();
+
+  return (BaseSequentialStream *)outp;
+}
+
+/*
+ * Flushes the buffered output and stops the flush thread.
+ */
+static void out_stop(shell_output_t *outp) {
+  shell_output_t **opp;
+
+  chSysLock();
+  opp = &shell_outputs;
+  while (*opp != outp) {
+    opp = &(*opp)->next;
+  }
+  *opp = outp->next;
+  outp->stop = true;
+  chBSemSignalI(&outp->sem);
+  chSchRescheduleS();
+  chSysUnlock();
+
+  (void) chThdWait(outp->tp);
+  chHeapFree(outp->queue.q_buffer);
 }
 
+static shell_output_t *out_find(thread_t *tp) {
+  shell_output_t *outp;
+
+  chSysLock();
+  outp = shell_outputs;
+  while ((outp != NULL) && (outp->owner != tp)) {
+    outp = outp->next;
+  }
+  chSysUnlock();
+
+  return outp;
+}
+#endif /* SHELL_USE_OUTPUT_BUFFER == TRUE */
+
 #if (SHELL_USE_HISTORY == TRUE) || defined(__DOXYGEN__)
 static void del_histbuff_entry(ShellHistory *shp) {
   int pos = shp->sh_beg + *(shp->sh_buffer + shp->sh_beg) + 1;
@@ -339,11 +653,32 @@ THD_FUNCTION(shellThread, p) {
   const ShellCommand *scp = scfg->sc_commands;
   char *lp, *cmd, *tokp, line[SHELL_MAX_LINE_LENGTH];
   char *args[SHELL_MAX_ARGUMENTS + 1];
+#if SHELL_USE_HASH == TRUE
+  shell_hash_t hash;
+#endif
+#if SHELL_USE_OUTPUT_BUFFER == TRUE
+  shell_output_t output;
+  ShellConfig lcfg = *scfg;
+#endif
 
 #if !defined(__CHIBIOS_NIL__)
   chRegSetThreadName(SHELL_THREAD_NAME);
 #endif
 
+#if SHELL_USE_HASH == TRUE
+  hash_init(&hash, scp);
+#endif
+
+#if SHELL_USE_OUTPUT_BUFFER == TRUE
+  /* The echo of the input line is buffered too, a local copy of the
+     configuration refers the buffered stream.*/
+  if (scfg->sc_outsize > 0U) {
+    chp = out_start(&output, chp, scfg->sc_outsize);
+    lcfg.sc_channel = chp;
+    scfg = &lcfg;
+  }
+#endif
+
 #if SHELL_USE_HISTORY == TRUE
   *(scfg->sc_histbuf) = 0;
   ShellHistory hist = {
@@ -402,10 +737,28 @@ THD_FUNCTION(shellThread, p) {
           list_commands(chp, scp);
         chprintf(chp, SHELL_NEWLINE_STR);
       }
-      else if (cmdexec(shell_local_commands, chp, cmd, n, args) &&
-          ((scp == NULL) || cmdexec(scp, chp, cmd, n, args))) {
-        chprintf(chp, "%s", cmd);
-        chprintf(chp, " ?" SHELL_NEWLINE_STR);
+      else {
+        const ShellCommand *fcp;
+
+#if SHELL_USE_HASH == TRUE
+        if (hash.valid) {
+          fcp = hash_find(&hash, cmd);
+        }
+        else
+#endif
+        {
+          fcp = cmdfind(shell_local_commands, cmd);
+          if ((fcp == NULL) && (scp != NULL)) {
+            fcp = cmdfind(scp, cmd);
+          }
+        }
+        if (fcp != NULL) {
+          fcp->sc_function(chp, n, args);
+        }
+        else {
+          chprintf(chp, "%s", cmd);
+          chprintf(chp, " ?" SHELL_NEWLINE_STR);
+        }
       }
     }
   }
@@ -437,6 +790,13 @@ void shellInit(void) {
  * @api
  */
 void shellExit(msg_t msg) {
+#if SHELL_USE_OUTPUT_BUFFER == TRUE
+  shell_output_t *outp = out_find(chThdGetSelfX());
+
+  if (outp != NULL) {
+    out_stop(outp);
+  }
+#endif
 
   /* Atomically broadcasting the event source and terminating the thread,
      there is not a chSysUnlock() because the thread terminates upon return.*/
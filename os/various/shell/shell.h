@@ -113,10 +113,92 @@
 #define SHELL_THREAD_NAME           "shell"
 #endif
 
+/**
+ * @brief   Enable hashed commands lookup.
+ * @details The built-in and user commands are indexed in a hash table when
+ *          the shell thread starts, commands are then found with a single
+ *          name comparison instead of a scan of both tables.
+ * @note    The table is allocated on the stack of each shell thread, about
+ *          @p SHELL_HASH_SIZE plus 20 bytes, size the shell working areas
+ *          accordingly when enabling this option.
+ */
+#if !defined(SHELL_USE_HASH) || defined(__DOXYGEN__)
+#define SHELL_USE_HASH              FALSE
+#endif
+
+/**
+ * @brief   Commands hash table size.
+ * @note    Must be a power of two, the table is allocated on the shell
+ *          thread stack, one byte per entry.
+ * @note    If there are more than 3/4 of this value commands then the
+ *          tables are scanned linearly.
+ */
+#if !defined(SHELL_HASH_SIZE) || defined(__DOXYGEN__)
+#define SHELL_HASH_SIZE             64
+#endif
+
+/**
+ * @brief   Number of hash seeds tried looking for a collision-free table.
+ */
+#if !defined(SHELL_HASH_SEEDS) || defined(__DOXYGEN__)
+#define SHELL_HASH_SEEDS            16
+#endif
+
+/**
+ * @brief   Enable shell output buffering.
+ * @details Shells with a non-zero @p sc_outsize field write their output in
+ *          a buffer, a thread running at a lower priority than the shell
+ *          flushes it to the shell channel.
+ * @note    Commands receive a buffered stream, they must not cast it to
+ *          a @p BaseChannel.
+ */
+#if !defined(SHELL_USE_OUTPUT_BUFFER) || defined(__DOXYGEN__)
+#define SHELL_USE_OUTPUT_BUFFER     FALSE
+#endif
+
+/**
+ * @brief   Output flush thread stack size.
+ */
+#if !defined(SHELL_OUTPUT_STACK_SIZE) || defined(__DOXYGEN__)
+#define SHELL_OUTPUT_STACK_SIZE     256
+#endif
+
+/**
+ * @brief   Output flush thread name.
+ */
+#if !defined(SHELL_OUTPUT_THREAD_NAME) || defined(__DOXYGEN__)
+#define SHELL_OUTPUT_THREAD_NAME    "shell_out"
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (SHELL_HASH_SIZE < 8) || (SHELL_HASH_SIZE > 256) ||                     \
+    ((SHELL_HASH_SIZE & (SHELL_HASH_SIZE - 1)) != 0)
+#error "invalid SHELL_HASH_SIZE value"
+#endif
+
+#if (SHELL_HASH_SEEDS < 1)
+#error "invalid SHELL_HASH_SEEDS value"
+#endif
+
+#if SHELL_USE_OUTPUT_BUFFER == TRUE
+#if defined(__CHIBIOS_NIL__)
+#error "SHELL_USE_OUTPUT_BUFFER requires ChibiOS/RT"
+#endif
+
+#if (CH_CFG_USE_HEAP != TRUE) || (CH_CFG_USE_DYNAMIC != TRUE)
+#error "SHELL_USE_OUTPUT_BUFFER requires CH_CFG_USE_HEAP and "              \
+       "CH_CFG_USE_DYNAMIC"
+#endif
+
+#if (CH_CFG_USE_SEMAPHORES != TRUE) || (CH_CFG_USE_WAITEXIT != TRUE)
+#error "SHELL_USE_OUTPUT_BUFFER requires CH_CFG_USE_SEMAPHORES and "        \
+       "CH_CFG_USE_WAITEXIT"
+#endif
+#endif /* SHELL_USE_OUTPUT_BUFFER == TRUE */
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -168,6 +250,11 @@ typedef struct {
   char                  **sc_completion;    /**< @brief Shell command completion
                                                  buffer.                    */
 #endif
+#if (SHELL_USE_OUTPUT_BUFFER == TRUE) || defined(__DOXYGEN__)
+  size_t                sc_outsize;         /**< @brief Output buffer size,
+                                                 zero for unbuffered
+                                                 output.                    */
+#endif
 } ShellConfig;
 
 /*===========================================================================*/
@@ -41,6 +41,32 @@
 #include "wolfssl_chibios.h"
 #include "user_settings.h"
 
+#if defined(SIMULATOR)
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/* The simulator takes random numbers from the host, a failure of the host
+   source halts the system, returning non-random values is not an option.*/
+unsigned int chibios_rand_generate(void)
+{
+  static int fd = -1;
+  unsigned int value = 0;
+  ssize_t n;
+
+  if (fd < 0) {
+    fd = open("/dev/urandom", O_RDONLY);
+    if (fd < 0)
+      chSysHalt("/dev/urandom not available");
+  }
+  do {
+    n = read(fd, &value, sizeof(value));
+    if ((n == 0) || ((n < 0) && (errno != EINTR)))
+      chSysHalt("/dev/urandom read failure");
+  } while (n != (ssize_t)sizeof(value));
+  return value;
+}
+#else
 unsigned int chibios_rand_generate(void)
 {
   static unsigned int last_value=0;
@@ -55,6 +81,7 @@ unsigned int chibios_rand_generate(void)
   last_value=new_value;
   return new_value;
 }
+#endif
 
 int custom_rand_generate_block(unsigned char* output, unsigned int sz)
 {
@@ -62,6 +62,8 @@ sslconn *sslconn_accept(sslconn *sk)
       return NULL;
   new->conn = newconn;
   new->ctx = sk->ctx;
+  new->rx_buf = NULL;
+  new->rx_off = 0;
   new->ssl = wolfSSL_new(new->ctx);
   wolfSSL_SetIOReadCtx(new->ssl, new);
   wolfSSL_SetIOWriteCtx(new->ssl, new);
@@ -72,11 +74,47 @@ sslconn *sslconn_accept(sslconn *sk)
     return new;
   } else {
     wolfSSL_free(new->ssl);
+    if (new->rx_buf)
+      netbuf_delete(new->rx_buf);
+    netconn_delete(newconn);
     chHeapFree(new);
     return NULL;
   }
 }
 
+sslconn *sslconn_connect(sslconn *sk, const ip_addr_t *addr, u16_t port)
+{
+  sslconn *new;
+  struct netconn *newconn;
+
+  newconn = netconn_new(NETCONNTYPE_GROUP(netconn_type(sk->conn)));
+  if (!newconn)
+      return NULL;
+  if (netconn_connect(newconn, addr, port) != ERR_OK) {
+      netconn_delete(newconn);
+      return NULL;
+  }
+  new = chHeapAlloc(NULL, sizeof(sslconn));
+  if (!new) {
+      netconn_delete(newconn);
+      return NULL;
+  }
+  new->conn = newconn;
+  new->ctx = sk->ctx;
+  new->rx_buf = NULL;
+  new->rx_off = 0;
+  new->ssl = wolfSSL_new(new->ctx);
+  wolfSSL_SetIOReadCtx(new->ssl, new);
+  wolfSSL_SetIOWriteCtx(new->ssl, new);
+
+  if (wolfSSL_connect(new->ssl) == SSL_SUCCESS) {
+    return new;
+  } else {
+    sslconn_close(new);
+    return NULL;
+  }
+}
+
 sslconn *sslconn_new(enum netconn_type t, WOLFSSL_METHOD* method)
 {
     sslconn *sk;
@@ -110,6 +148,8 @@ void sslconn_close(sslconn *sk)
 {
     netconn_delete(sk->conn);
     wolfSSL_free(sk->ssl);
+    if (sk->rx_buf)
+        netbuf_delete(sk->rx_buf);
     chHeapFree(sk);
 }
 
@@ -136,63 +176,55 @@ int wolfssl_send_cb(WOLFSSL* ssl, char *buf, int sz, void *ctx)
 }
 
 
-#define MAX_SSL_BUF 1460
-static uint8_t ssl_recv_buffer[MAX_SSL_BUF];
-static int ssl_rb_len = 0;
-static int ssl_rb_off = 0;
-
 int wolfssl_recv_cb(WOLFSSL *ssl, char *buf, int sz, void *ctx)
 {
     sslconn *sk = (sslconn *)ctx;
-    struct netbuf *inbuf = NULL;
     uint8_t *net_buf;
-    uint16_t buflen;
+    uint16_t buflen, n;
+    int len = 0;
     (void)ssl;
     err_t err;
 
-    if (ssl_rb_len > 0) {
-        if (sz > ssl_rb_len - ssl_rb_off)
-            sz = ssl_rb_len - ssl_rb_off;
-        memcpy(buf, ssl_recv_buffer + ssl_rb_off, sz);
-        ssl_rb_off += sz;
-        if (ssl_rb_off >= ssl_rb_len) {
-            ssl_rb_len = 0;
-            ssl_rb_off = 0;
+    /* Blocking only if there is no pending data.*/
+    if (sk->rx_buf == NULL) {
+        err = netconn_recv(sk->conn, &sk->rx_buf);
+        if (err != ERR_OK) {
+            sk->rx_buf = NULL;
+            if (err == ERR_CLSD || err == ERR_ABRT || err == ERR_CONN)
+                return WOLFSSL_CBIO_ERR_CONN_CLOSE;
+            else if (err == ERR_RST)
+                return WOLFSSL_CBIO_ERR_CONN_RST;
+            else if (err == ERR_MEM)
+                return WOLFSSL_CBIO_ERR_GENERAL;
+            else if (err == ERR_TIMEOUT)
+                return WOLFSSL_CBIO_ERR_TIMEOUT;
+            else
+                return 0;
+            //return WOLFSSL_CBIO_ERR_WANT_READ;
         }
-        return sz;
+        sk->rx_off = 0;
     }
 
-
-    err = netconn_recv(sk->conn, &inbuf);
-    if (err == ERR_OK) {
-        netbuf_data(inbuf, (void **)&net_buf, &buflen);
-        ssl_rb_len = buflen;
-        if (ssl_rb_len > MAX_SSL_BUF)
-            ssl_rb_len = MAX_SSL_BUF;
-        memcpy(ssl_recv_buffer, net_buf, ssl_rb_len);
-        ssl_rb_off = 0;
-        if (sz > ssl_rb_len)
-            sz = ssl_rb_len;
-        memcpy(buf, ssl_recv_buffer, sz);
-        ssl_rb_off += sz;
-        if (ssl_rb_off >= ssl_rb_len) {
-            ssl_rb_len = 0;
-            ssl_rb_off = 0;
+    /* Copying from the netbuf fragments, in place, until the request is
+       satisfied or the netbuf is exhausted.*/
+    while (len < sz) {
+        netbuf_data(sk->rx_buf, (void **)&net_buf, &buflen);
+        n = buflen - sk->rx_off;
+        if (n > sz - len)
+            n = sz - len;
+        memcpy(buf + len, net_buf + sk->rx_off, n);
+        len += n;
+        sk->rx_off += n;
+        if (sk->rx_off >= buflen) {
+            sk->rx_off = 0;
+            if (netbuf_next(sk->rx_buf) < 0) {
+                netbuf_delete(sk->rx_buf);
+                sk->rx_buf = NULL;
+                break;
+            }
         }
-        netbuf_delete(inbuf);
-        return sz;
     }
-    else if (err == ERR_CLSD || err == ERR_ABRT || err == ERR_CONN)
-        return WOLFSSL_CBIO_ERR_CONN_CLOSE;
-    else if (err == ERR_RST)
-        return WOLFSSL_CBIO_ERR_CONN_RST;
-    else if (err == ERR_MEM)
-        return WOLFSSL_CBIO_ERR_GENERAL;
-    else if (err == ERR_TIMEOUT)
-        return WOLFSSL_CBIO_ERR_TIMEOUT;
-    else
-        return 0;
-    //return WOLFSSL_CBIO_ERR_WANT_READ;
+    return len;
 }
 
 #ifndef ST2S
@@ -216,45 +248,6 @@ uint32_t TimeNowInMilliseconds(void)
     return ST2MS(t);
 }
 
-void *chHeapRealloc (void *addr, uint32_t size)
-{
-    union heap_header *hp;
-    uint32_t prev_size, new_size;
-
-    void *ptr;
-
-    if(addr == NULL) {
-        return chHeapAlloc(NULL, size);
-    }
-
-    /* previous allocated segment is preceded by an heap_header */
-    hp = addr - sizeof(union heap_header);
-    prev_size = hp->used.size; /* size is always multiple of 8 */
-
-    /* check new size memory alignment */
-    if(size % 8 == 0) {
-        new_size = size;
-    }
-    else {
-        new_size = ((int) (size / 8)) * 8 + 8;
-    }
-
-    if(prev_size >= new_size) {
-        return addr;
-    }
-
-    ptr = chHeapAlloc(NULL, size);
-    if(ptr == NULL) {
-        return NULL;
-    }
-
-    memcpy(ptr, addr, prev_size);
-
-    chHeapFree(addr);
-
-    return ptr;
-}
-
 void *chibios_alloc(void *heap, int size)
 {
     return chHeapAlloc(heap, size);
@@ -266,3 +259,16 @@ void chibios_free(void *ptr)
         chHeapFree(ptr);
 }
 
+void *chibios_realloc(void *ptr, int size)
+{
+    if (ptr == NULL)
+        return chHeapAlloc(NULL, size);
+    if (size == 0) {
+        chHeapFree(ptr);
+        return NULL;
+    }
+    /* Grows or shrinks in place when possible, wolfSSL buffers are often
+       extended right after being allocated.*/
+    return chHeapRealloc(ptr, size);
+}
+
@@ -52,11 +52,17 @@ struct sslconn {
     WOLFSSL_CTX *ctx;
     WOLFSSL *ssl;
     struct netconn *conn;
+    /* Received netbuf being consumed and offset in its current fragment,
+       data is copied from there directly into the wolfSSL buffers.*/
+    struct netbuf *rx_buf;
+    uint16_t rx_off;
 };
 
 typedef struct sslconn sslconn;
 
 sslconn *sslconn_accept(struct sslconn *sk);
+sslconn *sslconn_connect(struct sslconn *sk, const ip_addr_t *addr,
+                         u16_t port);
 sslconn *sslconn_new(enum netconn_type t, WOLFSSL_METHOD *method);
 void sslconn_close(sslconn *sk);
 
@@ -65,6 +71,7 @@ int wolfssl_recv_cb(WOLFSSL *ssl, char *buf, int sz, void *ctx);
 
 void *chibios_alloc(void *heap, int size);
 void chibios_free(void *ptr);
+void *chibios_realloc(void *ptr, int size);
 word32 LowResTimer(void);
 
 #endif
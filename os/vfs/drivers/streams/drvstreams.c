@@ -64,6 +64,16 @@ struct vfs_streams_driver_static_struct {
    * @brief       Static storage of file nodes.
    */
   vfs_streams_file_node_c   file_nodes[DRV_CFG_STREAMS_FILE_NODES_NUM];
+#if (DRV_CFG_STREAMS_PIPE_NODES_NUM > 0) || defined (__DOXYGEN__)
+  /**
+   * @brief       Pool of pipe nodes.
+   */
+  memory_pool_t             pipe_nodes_pool;
+  /**
+   * @brief       Static storage of pipe nodes.
+   */
+  vfs_streams_pipe_node_c   pipe_nodes[DRV_CFG_STREAMS_PIPE_NODES_NUM];
+#endif /* DRV_CFG_STREAMS_PIPE_NODES_NUM > 0 */
 };
 
 /*===========================================================================*/
@@ -55,6 +55,14 @@
 #if !defined(DRV_CFG_STREAMS_FILE_NODES_NUM) || defined(__DOXYGEN__)
 #define DRV_CFG_STREAMS_FILE_NODES_NUM      1
 #endif
+
+/**
+ * @brief       Number of pipe nodes pre-allocated in the pool.
+ * @note        Pipe nodes are disabled if zero.
+ */
+#if !defined(DRV_CFG_STREAMS_PIPE_NODES_NUM) || defined(__DOXYGEN__)
+#define DRV_CFG_STREAMS_PIPE_NODES_NUM      0
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -71,6 +79,15 @@
 #error "invalid DRV_CFG_STREAMS_FILE_NODES_NUM value"
 #endif
 
+/* Checks on DRV_CFG_STREAMS_PIPE_NODES_NUM configuration.*/
+#if DRV_CFG_STREAMS_PIPE_NODES_NUM < 0
+#error "invalid DRV_CFG_STREAMS_PIPE_NODES_NUM value"
+#endif
+
+#if (DRV_CFG_STREAMS_PIPE_NODES_NUM > 0) && (CH_CFG_USE_PIPES != TRUE)
+#error "DRV_CFG_STREAMS_PIPE_NODES_NUM requires CH_CFG_USE_PIPES"
+#endif
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -96,6 +113,13 @@ struct drv_streams_element {
    * @brief       Pointer to the stream.
    */
   sequential_stream_i       *stm;
+#if (DRV_CFG_STREAMS_PIPE_NODES_NUM > 0) || defined (__DOXYGEN__)
+  /**
+   * @brief       Pointer to the pipe, if not @p NULL then the file is a pipe
+   *              node and @p stm is ignored.
+   */
+  pipe_t                    *pipe;
+#endif /* DRV_CFG_STREAMS_PIPE_NODES_NUM > 0 */
 };
 
 /**
@@ -219,6 +243,76 @@ struct vfs_streams_file_node {
 };
 /** @} */
 
+#if (DRV_CFG_STREAMS_PIPE_NODES_NUM > 0) || defined (__DOXYGEN__)
+/**
+ * @class       vfs_streams_pipe_node_c
+ * @extends     base_object_c, referenced_object_c, vfs_node_c,
+ *              vfs_file_node_c.
+ *
+ * @brief       File node transferring data in bulk to and from an OSLIB
+ *              pipe.
+ *
+ * @name        Class @p vfs_streams_pipe_node_c structures
+ * @{
+ */
+
+/**
+ * @brief       Type of a VFS streams pipe node class.
+ */
+typedef struct vfs_streams_pipe_node vfs_streams_pipe_node_c;
+
+/**
+ * @brief       Class @p vfs_streams_pipe_node_c virtual methods table.
+ */
+struct vfs_streams_pipe_node_vmt {
+  /* From base_object_c.*/
+  void (*dispose)(void *ip);
+  /* From referenced_object_c.*/
+  void * (*addref)(void *ip);
+  object_references_t (*release)(void *ip);
+  /* From vfs_node_c.*/
+  msg_t (*stat)(void *ip, vfs_stat_t *sp);
+  /* From vfs_file_node_c.*/
+  ssize_t (*read)(void *ip, uint8_t *buf, size_t n);
+  ssize_t (*write)(void *ip, const uint8_t *buf, size_t n);
+  msg_t (*setpos)(void *ip, vfs_offset_t offset, vfs_seekmode_t whence);
+  vfs_offset_t (*getpos)(void *ip);
+  sequential_stream_i * (*getstream)(void *ip);
+  /* From vfs_streams_pipe_node_c.*/
+};
+
+/**
+ * @brief       Structure representing a VFS streams pipe node class.
+ */
+struct vfs_streams_pipe_node {
+  /**
+   * @brief       Virtual Methods Table.
+   */
+  const struct vfs_streams_pipe_node_vmt *vmt;
+  /**
+   * @brief       Number of references to the object.
+   */
+  object_references_t       references;
+  /**
+   * @brief       Driver handling this node.
+   */
+  vfs_driver_c              *driver;
+  /**
+   * @brief       Node mode information.
+   */
+  vfs_mode_t                mode;
+  /**
+   * @brief       Pipe associated to this file.
+   */
+  pipe_t                    *pipe;
+  /**
+   * @brief       File open flags.
+   */
+  int                       flags;
+};
+/** @} */
+#endif /* DRV_CFG_STREAMS_PIPE_NODES_NUM > 0 */
+
 /**
  * @class       vfs_streams_driver_c
  * @extends     base_object_c, vfs_driver_c.
@@ -292,6 +386,19 @@ extern "C" {
                               vfs_seekmode_t whence);
   vfs_offset_t __stmfile_getpos_impl(void *ip);
   sequential_stream_i *__stmfile_getstream_impl(void *ip);
+#if (DRV_CFG_STREAMS_PIPE_NODES_NUM > 0) || defined (__DOXYGEN__)
+  /* Methods of vfs_streams_pipe_node_c.*/
+  void *__stmpipe_objinit_impl(void *ip, const void *vmt, vfs_driver_c *driver,
+                               vfs_mode_t mode, pipe_t *pipe, int flags);
+  void __stmpipe_dispose_impl(void *ip);
+  msg_t __stmpipe_stat_impl(void *ip, vfs_stat_t *sp);
+  ssize_t __stmpipe_read_impl(void *ip, uint8_t *buf, size_t n);
+  ssize_t __stmpipe_write_impl(void *ip, const uint8_t *buf, size_t n);
+  msg_t __stmpipe_setpos_impl(void *ip, vfs_offset_t offset,
+                              vfs_seekmode_t whence);
+  vfs_offset_t __stmpipe_getpos_impl(void *ip);
+  sequential_stream_i *__stmpipe_getstream_impl(void *ip);
+#endif /* DRV_CFG_STREAMS_PIPE_NODES_NUM > 0 */
   /* Methods of vfs_streams_driver_c.*/
   void *__stmdrv_objinit_impl(void *ip, const void *vmt,
                               const drv_streams_element_t *streams);
@@ -375,6 +482,40 @@ static inline vfs_streams_file_node_c *stmfileObjectInit(vfs_streams_file_node_c
 }
 /** @} */
 
+#if (DRV_CFG_STREAMS_PIPE_NODES_NUM > 0) || defined (__DOXYGEN__)
+/**
+ * @name        Default constructor of vfs_streams_pipe_node_c
+ * @{
+ */
+/**
+ * @memberof    vfs_streams_pipe_node_c
+ *
+ * @brief       Default initialization function of @p vfs_streams_pipe_node_c.
+ *
+ * @param[out]    self          Pointer to a @p vfs_streams_pipe_node_c
+ *                              instance to be initialized.
+ * @param[in]     driver        Pointer to the controlling driver.
+ * @param[in]     mode          Node mode flags.
+ * @param[in]     pipe          Pipe to be associated.
+ * @param[in]     flags         File open flags.
+ * @return                      Pointer to the initialized object.
+ *
+ * @objinit
+ */
+CC_FORCE_INLINE
+static inline vfs_streams_pipe_node_c *stmpipeObjectInit(vfs_streams_pipe_node_c *self,
+                                                         vfs_driver_c *driver,
+                                                         vfs_mode_t mode,
+                                                         pipe_t *pipe,
+                                                         int flags) {
+  extern const struct vfs_streams_pipe_node_vmt __vfs_streams_pipe_node_vmt;
+
+  return __stmpipe_objinit_impl(self, &__vfs_streams_pipe_node_vmt, driver,
+                                mode, pipe, flags);
+}
+/** @} */
+#endif /* DRV_CFG_STREAMS_PIPE_NODES_NUM > 0 */
+
 /**
  * @name        Default constructor of vfs_streams_driver_c
  * @{
@@ -46,6 +46,7 @@
 #define VO_CREAT                            O_CREAT
 #define VO_TRUNC                            O_TRUNC
 #define VO_EXCL                             O_EXCL
+#define VO_NONBLOCK                         O_NONBLOCK
 /** @} */
 
 /*===========================================================================*/
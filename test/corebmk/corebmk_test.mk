@@ -1,5 +1,6 @@
 # List of all the core benchmarks test files.
 TESTSRC += ${CHIBIOS}/test/corebmk/source/test/ffbench_mod.c \
+           ${CHIBIOS}/test/corebmk/source/test/fft_fast.c \
            ${CHIBIOS}/test/corebmk/source/test/corebmk_test_root.c \
            ${CHIBIOS}/test/corebmk/source/test/corebmk_test_sequence_001.c
 
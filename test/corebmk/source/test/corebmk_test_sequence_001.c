@@ -45,6 +45,7 @@
  * <h2>Test Cases</h2>
  * - @subpage corebmk_test_001_001
  * - @subpage corebmk_test_001_002
+ * - @subpage corebmk_test_001_003
  * .
  */
 
@@ -59,6 +60,7 @@
 #include "ch.h"
 
 #include "ffbench_mod.h"
+#include "fft_fast.h"
 
 #define ASIZE       64              /* Array edge size.                     */
 #define NITERATIONS 10              /* Number of iterations.                */
@@ -69,6 +71,42 @@
 
 float *fdatas;
 double *fdatad;
+float *fdataf;
+fft_fast_plan_t *fplan;
+
+/* Cross-check input, a deterministic pattern with values between -8
+   and 8.*/
+static float check_value(int i, int part) {
+
+  return part == 0 ? (float)((i * 7) % 17) - 8.0f :
+                     (float)((i * 5) % 13) - 6.0f;
+}
+
+static void check_fill(float *mp, int edge) {
+  int i;
+
+  for (i = 0; i < edge * edge; i++) {
+    mp[i * 2]     = check_value(i, 0);
+    mp[i * 2 + 1] = check_value(i, 1);
+  }
+}
+
+/* Maximum error of the cross-check matrix after a forward and an inverse
+   transform, the transforms are not normalized.*/
+static float check_error(const float *mp, int edge) {
+  float scale = 1.0f / (float)(edge * edge);
+  float err = 0.0f;
+  int i;
+
+  for (i = 0; i < edge * edge * 2; i++) {
+    float d = (mp[i] * scale) - check_value(i / 2, i % 2);
+
+    d = d < 0.0f ? -d : d;
+    err = max(err, d);
+  }
+
+  return err;
+}
 
 /****************************************************************************
  * Test cases.
@@ -250,6 +288,147 @@ static const testcase_t corebmk_test_001_002 = {
   corebmk_test_001_002_execute
 };
 
+/**
+ * @page corebmk_test_001_003 [1.3] Two-dimensional FFT, optimized
+ *
+ * <h2>Description</h2>
+ * Same benchmark using the optimized radix-4 FFT, the results are
+ * cross-checked against the reference implementation then the execution
+ * time is reported.
+ *
+ * <h2>Test Steps</h2>
+ * - [1.3.1] Allocating memory for the work matrix and the plan.
+ * - [1.3.2] Printing setup.
+ * - [1.3.3] Cross-checking against the reference implementation, a
+ *   reference forward transform followed by an optimized inverse
+ *   transform and vice versa must return the input.
+ * - [1.3.4] Running single precision FFT iterations.
+ * - [1.3.5] Printing execution time.
+ * .
+ */
+
+static void corebmk_test_001_003_setup(void) {
+  fdataf = NULL;
+  fplan = NULL;
+}
+
+static void corebmk_test_001_003_teardown(void) {
+  if (fdataf != NULL) {
+    chHeapFree((void *)fdataf);
+  }
+  if (fplan != NULL) {
+    chHeapFree((void *)fplan);
+  }
+}
+
+static void corebmk_test_001_003_execute(void) {
+  time_msecs_t msecs;
+  size_t fasize;
+  int faedge;
+  int nsize[] = {0, 0, 0};
+
+  /* [1.3.1] Allocating memory for the work matrix and the plan.*/
+  test_set_step(1);
+  {
+    faedge = ASIZE;                                     /* FFT array edge size.*/
+    fasize = ((size_t)(faedge * faedge) * 2 + 4) * sizeof(float);
+    fdataf = (float *)chHeapAllocAligned(NULL, fasize, 16U);
+    fplan  = (fft_fast_plan_t *)chHeapAllocAligned(NULL,
+                                                   sizeof(fft_fast_plan_t),
+                                                   16U);
+    nsize[1] = nsize[2] = faedge;
+
+    test_assert((fdataf != NULL) && (fplan != NULL),
+                "optimized FFT memory allocation failed");
+    test_assert(fft_fast_init(fplan, (unsigned)faedge),
+                "unsupported matrix size");
+  }
+  test_end_step(1);
+
+  /* [1.3.2] Printing setup.*/
+  test_set_step(2);
+  {
+    test_print("--- Kernel: ");
+    test_println(FFT_FAST_BACKEND_NAME);
+  }
+  test_end_step(2);
+
+  /* [1.3.3] Cross-checking against the reference implementation, a
+     reference forward transform followed by an optimized inverse
+     transform and vice versa must return the input.*/
+  test_set_step(3);
+  {
+    /* The reference works on arrays starting from index one, the
+       matrix is placed so that it is aligned for both.*/
+    float *mp = fdataf + 4;
+
+    check_fill(mp, faedge);
+    fourn_float(mp - 1, nsize, 2, 1);
+    fft_fast_2d(fplan, mp, -1);
+    test_assert(check_error(mp, faedge) < 1e-4f,
+                "optimized inverse transform mismatch");
+
+    check_fill(mp, faedge);
+    fft_fast_2d(fplan, mp, 1);
+    fourn_float(mp - 1, nsize, 2, -1);
+    test_assert(check_error(mp, faedge) < 1e-4f,
+                "optimized forward transform mismatch");
+  }
+  test_end_step(3);
+
+  /* [1.3.4] Running single precision FFT iterations.*/
+  test_set_step(4);
+  {
+    systime_t start, end;
+    int i, j, k;
+
+    /* Time stamp for benchmark start.*/
+    start = chVTGetSystemTime();
+
+    for (k = 0; k < NITERATIONS; k++) {
+
+      /* Generate data array to process, same data of the reference.*/
+      memset(fdataf, 0, (size_t)(faedge * faedge) * 2 * sizeof(float));
+      for (i = 0; i < faedge; i++) {
+        for (j = 0; j < faedge; j++) {
+          if (((i & 15) == 8) || ((j & 15) == 8)) {
+            fdataf[((faedge * i) + j) * 2] = 128.0;
+          }
+        }
+      }
+
+      for (i = 0; i < NPASSES; i++) {
+        /* Transform image to frequency domain.*/
+        fft_fast_2d(fplan, fdataf, 1);
+
+        /* Back-transform to image.*/
+        fft_fast_2d(fplan, fdataf, -1);
+      }
+    }
+
+    /* Time stamp for benchmark end.*/
+    end = chVTGetSystemTime();
+    msecs = chTimeI2MS(chTimeDiffX(start, end));
+  }
+  test_end_step(4);
+
+  /* [1.3.5] Printing execution time.*/
+  test_set_step(5);
+  {
+    test_print("--- Time  : ");
+    test_printn(msecs);
+    test_println(" milliseconds");
+  }
+  test_end_step(5);
+}
+
+static const testcase_t corebmk_test_001_003 = {
+  "Two-dimensional FFT, optimized",
+  corebmk_test_001_003_setup,
+  corebmk_test_001_003_teardown,
+  corebmk_test_001_003_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -260,6 +439,7 @@ static const testcase_t corebmk_test_001_002 = {
 const testcase_t * const corebmk_test_sequence_001_array[] = {
   &corebmk_test_001_001,
   &corebmk_test_001_002,
+  &corebmk_test_001_003,
   NULL
 };
 
@@ -0,0 +1,324 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    fft_fast.c
+ * @brief   Optimized FFT code.
+ * @details The transform has the same sign convention of @p fourn_float()
+ *          and it is not normalized, a forward and inverse pair scales the
+ *          data by the number of points.
+ */
+
+#include <math.h>
+
+#include "fft_fast.h"
+
+/*===========================================================================*/
+/* Vectors backend.                                                          */
+/*===========================================================================*/
+
+#if (FFT_FAST_USE_VECTORS == TRUE) || defined(__DOXYGEN__)
+#if defined(__clang__)
+#define FV_SWAP(a)  __builtin_shufflevector(a, a, 1, 0, 3, 2)
+#else
+typedef int32_t fft_ivec_t __attribute__((vector_size(16)));
+#define FV_SWAP(a)  __builtin_shuffle(a, (fft_ivec_t){1, 0, 3, 2})
+#endif
+
+static inline fft_vec_t fv_add(fft_vec_t a, fft_vec_t b) {
+
+  return a + b;
+}
+
+static inline fft_vec_t fv_sub(fft_vec_t a, fft_vec_t b) {
+
+  return a - b;
+}
+
+static inline fft_vec_t fv_mul(fft_vec_t a, fft_vec_t b) {
+
+  return a * b;
+}
+
+/* Exchanges real and imaginary parts.*/
+static inline fft_vec_t fv_swap(fft_vec_t a) {
+
+  return FV_SWAP(a);
+}
+
+static inline fft_vec_t fv_make(float re, float im) {
+
+  return (fft_vec_t){re, im, re, im};
+}
+
+static inline fft_vec_t fv_load2(const float *p0, const float *p1) {
+
+  return (fft_vec_t){p0[0], p0[1], p1[0], p1[1]};
+}
+
+static inline void fv_store2(float *p0, float *p1, fft_vec_t a) {
+
+  p0[0] = a[0];
+  p0[1] = a[1];
+  p1[0] = a[2];
+  p1[1] = a[3];
+}
+
+#else /* FFT_FAST_USE_VECTORS == FALSE */
+static inline fft_vec_t fv_add(fft_vec_t a, fft_vec_t b) {
+  fft_vec_t r;
+
+  r.v[0] = a.v[0] + b.v[0];
+  r.v[1] = a.v[1] + b.v[1];
+  r.v[2] = a.v[2] + b.v[2];
+  r.v[3] = a.v[3] + b.v[3];
+  return r;
+}
+
+static inline fft_vec_t fv_sub(fft_vec_t a, fft_vec_t b) {
+  fft_vec_t r;
+
+  r.v[0] = a.v[0] - b.v[0];
+  r.v[1] = a.v[1] - b.v[1];
+  r.v[2] = a.v[2] - b.v[2];
+  r.v[3] = a.v[3] - b.v[3];
+  return r;
+}
+
+static inline fft_vec_t fv_mul(fft_vec_t a, fft_vec_t b) {
+  fft_vec_t r;
+
+  r.v[0] = a.v[0] * b.v[0];
+  r.v[1] = a.v[1] * b.v[1];
+  r.v[2] = a.v[2] * b.v[2];
+  r.v[3] = a.v[3] * b.v[3];
+  return r;
+}
+
+/* Exchanges real and imaginary parts.*/
+static inline fft_vec_t fv_swap(fft_vec_t a) {
+  fft_vec_t r;
+
+  r.v[0] = a.v[1];
+  r.v[1] = a.v[0];
+  r.v[2] = a.v[3];
+  r.v[3] = a.v[2];
+  return r;
+}
+
+static inline fft_vec_t fv_make(float re, float im) {
+  fft_vec_t r;
+
+  r.v[0] = re;
+  r.v[1] = im;
+  r.v[2] = re;
+  r.v[3] = im;
+  return r;
+}
+
+static inline fft_vec_t fv_load2(const float *p0, const float *p1) {
+  fft_vec_t r;
+
+  r.v[0] = p0[0];
+  r.v[1] = p0[1];
+  r.v[2] = p1[0];
+  r.v[3] = p1[1];
+  return r;
+}
+
+static inline void fv_store2(float *p0, float *p1, fft_vec_t a) {
+
+  p0[0] = a.v[0];
+  p0[1] = a.v[1];
+  p1[0] = a.v[2];
+  p1[1] = a.v[3];
+}
+#endif /* FFT_FAST_USE_VECTORS == FALSE */
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/*
+ * Complex multiplication by a twiddle factor, wr contains the real part
+ * and wi the imaginary part with alternated signs.
+ */
+static inline fft_vec_t fv_cmul(fft_vec_t a, fft_vec_t wr, fft_vec_t wi) {
+
+  return fv_add(fv_mul(a, wr), fv_mul(fv_swap(a), wi));
+}
+
+/*
+ * Bit reversal permutation of a strided sequence.
+ */
+static void fft_permute(const fft_fast_plan_t *pp,
+                        fft_vec_t *x, size_t stride) {
+  unsigned i;
+
+  for (i = 0U; i < pp->n; i++) {
+    unsigned r = pp->bitrev[i];
+
+    if (i < r) {
+      fft_vec_t t = x[i * stride];
+      x[i * stride] = x[r * stride];
+      x[r * stride] = t;
+    }
+  }
+}
+
+/*
+ * Butterflies on a strided sequence in bit reversed order, a radix-2 stage
+ * is performed first if the number of stages is odd then radix-4 stages
+ * follow.
+ */
+static void fft_butterflies(const fft_fast_plan_t *pp,
+                            fft_vec_t *x, size_t stride, int isign) {
+  const unsigned n = pp->n;
+  const float s = isign >= 0 ? 1.0f : -1.0f;
+  const fft_vec_t jmul = fv_make(-s, s);
+  unsigned j, k, m;
+
+  m = 1U;
+  if ((pp->log2n & 1U) != 0U) {
+    for (j = 0U; j < n; j += 2U) {
+      fft_vec_t *p0 = &x[j * stride];
+      fft_vec_t *p1 = p0 + stride;
+      fft_vec_t a = *p0, b = *p1;
+
+      *p0 = fv_add(a, b);
+      *p1 = fv_sub(a, b);
+    }
+    m = 2U;
+  }
+
+  while (m < n) {
+    const unsigned step = n / (4U * m);
+    const size_t qs = (size_t)m * stride;
+
+    for (k = 0U; k < m; k++) {
+      const float *w1 = pp->twiddles[k * step];
+      const float *w2 = pp->twiddles[2U * k * step];
+      const float *w3 = pp->twiddles[3U * k * step];
+      const fft_vec_t w1r = fv_make(w1[0], w1[0]);
+      const fft_vec_t w1i = fv_make(-s * w1[1], s * w1[1]);
+      const fft_vec_t w2r = fv_make(w2[0], w2[0]);
+      const fft_vec_t w2i = fv_make(-s * w2[1], s * w2[1]);
+      const fft_vec_t w3r = fv_make(w3[0], w3[0]);
+      const fft_vec_t w3i = fv_make(-s * w3[1], s * w3[1]);
+
+      for (j = k; j < n; j += 4U * m) {
+        fft_vec_t *p0 = &x[j * stride];
+        fft_vec_t a, b, c, d, t0, t1, t2, t3;
+
+        /* The four quarters hold the transforms of the samples with
+           index 4r, 4r+2, 4r+1 and 4r+3 in this order.*/
+        a  = p0[0];
+        b  = fv_cmul(p0[qs], w2r, w2i);
+        c  = fv_cmul(p0[2U * qs], w1r, w1i);
+        d  = fv_cmul(p0[3U * qs], w3r, w3i);
+        t0 = fv_add(a, b);
+        t1 = fv_sub(a, b);
+        t2 = fv_add(c, d);
+        t3 = fv_mul(fv_swap(fv_sub(c, d)), jmul);
+        p0[0]       = fv_add(t0, t2);
+        p0[qs]      = fv_add(t1, t3);
+        p0[2U * qs] = fv_sub(t0, t2);
+        p0[3U * qs] = fv_sub(t1, t3);
+      }
+    }
+    m *= 4U;
+  }
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a transform plan.
+ *
+ * @param[out] pp       pointer to the @p fft_fast_plan_t structure
+ * @param[in] n         number of points, a power of two between 4 and
+ *                      @p FFT_FAST_MAX_POINTS
+ * @return              The operation status.
+ * @retval false        if the number of points is not supported.
+ * @retval true         if the plan has been initialized.
+ */
+bool fft_fast_init(fft_fast_plan_t *pp, unsigned n) {
+  unsigned i, j;
+
+  if ((n < 4U) || (n > (unsigned)FFT_FAST_MAX_POINTS) ||
+      ((n & (n - 1U)) != 0U)) {
+    return false;
+  }
+
+  pp->n = n;
+  pp->log2n = 0U;
+  while ((1U << pp->log2n) < n) {
+    pp->log2n++;
+  }
+
+  for (i = 0U; i < n; i++) {
+    double theta = 6.28318530717958647692 * (double)i / (double)n;
+    unsigned r = 0U;
+
+    pp->twiddles[i][0] = (float)cos(theta);
+    pp->twiddles[i][1] = (float)sin(theta);
+
+    for (j = 0U; j < pp->log2n; j++) {
+      r |= ((i >> j) & 1U) << (pp->log2n - 1U - j);
+    }
+    pp->bitrev[i] = (uint16_t)r;
+  }
+
+  return true;
+}
+
+/**
+ * @brief   Two-dimensional FFT on a square matrix.
+ * @details Rows are transformed in pairs through the plan work buffer,
+ *          columns are transformed in place two at a time, adjacent
+ *          columns being contiguous in memory.
+ *
+ * @param[in] pp        pointer to an initialized @p fft_fast_plan_t
+ * @param[in,out] data  matrix of n by n complex values stored in row order
+ *                      as real and imaginary parts, it must be 16 bytes
+ *                      aligned
+ * @param[in] isign     1 for the forward transform, -1 for the inverse
+ */
+void fft_fast_2d(fft_fast_plan_t *pp, float data[], int isign) {
+  const unsigned n = pp->n;
+  fft_vec_t *vp = (fft_vec_t *)(void *)data;
+  unsigned r, k;
+
+  for (r = 0U; r < n; r += 2U) {
+    float *r0 = &data[r * n * 2U];
+    float *r1 = r0 + (n * 2U);
+
+    for (k = 0U; k < n; k++) {
+      pp->scratch[pp->bitrev[k]] = fv_load2(&r0[k * 2U], &r1[k * 2U]);
+    }
+    fft_butterflies(pp, pp->scratch, 1U, isign);
+    for (k = 0U; k < n; k++) {
+      fv_store2(&r0[k * 2U], &r1[k * 2U], pp->scratch[k]);
+    }
+  }
+
+  for (k = 0U; k < n / 2U; k++) {
+    fft_permute(pp, vp + k, n / 2U);
+    fft_butterflies(pp, vp + k, n / 2U, isign);
+  }
+}
@@ -0,0 +1,135 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    fft_fast.h
+ * @brief   Optimized FFT header.
+ * @details Radix-4 complex FFT with precomputed twiddle and bit reversal
+ *          tables, two independent transforms are computed at once using
+ *          128 bits vectors when the target has a floating point SIMD
+ *          unit, a scalar implementation of the same vectors is used on
+ *          other targets.
+ * @note    Only single precision is implemented, it is the replacement of
+ *          @p fourn_float(), the double precision benchmark keeps using
+ *          @p fourn_double() because most targets lack a double precision
+ *          SIMD or FPU unit.
+ */
+
+#ifndef FFT_FAST_H
+#define FFT_FAST_H
+
+#include "ch.h"
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Maximum number of points of a transform.
+ */
+#if !defined(FFT_FAST_MAX_POINTS) || defined(__DOXYGEN__)
+#define FFT_FAST_MAX_POINTS         128
+#endif
+
+/**
+ * @brief   Enables the vector backend.
+ * @details By default GCC vector extensions are used when the target has
+ *          128 bits floating point vectors: SSE, NEON or Helium.
+ */
+#if !defined(FFT_FAST_USE_VECTORS) || defined(__DOXYGEN__)
+#if defined(__GNUC__) &&                                                    \
+    (defined(__SSE__) || defined(__ARM_NEON) ||                             \
+     (defined(__ARM_FEATURE_MVE) && ((__ARM_FEATURE_MVE & 2) != 0)))
+#define FFT_FAST_USE_VECTORS        TRUE
+#else
+#define FFT_FAST_USE_VECTORS        FALSE
+#endif
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (FFT_FAST_MAX_POINTS < 4) || (FFT_FAST_MAX_POINTS > 65536) ||           \
+    ((FFT_FAST_MAX_POINTS & (FFT_FAST_MAX_POINTS - 1)) != 0)
+#error "invalid FFT_FAST_MAX_POINTS value"
+#endif
+
+/**
+ * @brief   Name of the selected backend.
+ */
+#if (FFT_FAST_USE_VECTORS == TRUE) || defined(__DOXYGEN__)
+#define FFT_FAST_BACKEND_NAME       "radix-4, vector"
+#else
+#define FFT_FAST_BACKEND_NAME       "radix-4, scalar"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Vector of two complex values.
+ */
+#if (FFT_FAST_USE_VECTORS == TRUE) || defined(__DOXYGEN__)
+typedef float fft_vec_t __attribute__((vector_size(16)));
+#else
+typedef struct {
+  float                     v[4];
+} fft_vec_t;
+#endif
+
+/**
+ * @brief   Type of a transform plan.
+ * @note    The structure contains vectors, it must be 16 bytes aligned.
+ */
+typedef struct {
+  /**
+   * @brief   Number of points.
+   */
+  unsigned                  n;
+  /**
+   * @brief   Base 2 logarithm of the number of points.
+   */
+  unsigned                  log2n;
+  /**
+   * @brief   Twiddle factors, cosine and sine of 2*pi*k/n.
+   */
+  float                     twiddles[FFT_FAST_MAX_POINTS][2];
+  /**
+   * @brief   Bit reversal permutation.
+   */
+  uint16_t                  bitrev[FFT_FAST_MAX_POINTS];
+  /**
+   * @brief   Rows work buffer.
+   */
+  fft_vec_t                 scratch[FFT_FAST_MAX_POINTS];
+} fft_fast_plan_t;
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  bool fft_fast_init(fft_fast_plan_t *pp, unsigned n);
+  void fft_fast_2d(fft_fast_plan_t *pp, float data[], int isign);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FFT_FAST_H */
@@ -0,0 +1,7 @@
+# List of all the RT coroutines test files.
+TESTSRC += ${CHIBIOS}/test/coroutines/source/test/co_test_root.c \
+           ${CHIBIOS}/test/coroutines/source/test/co_test_sequence_001.c \
+           ${CHIBIOS}/test/coroutines/source/test/co_test_sequence_002.c
+
+# Required include directories
+TESTINC += ${CHIBIOS}/test/coroutines/source/test
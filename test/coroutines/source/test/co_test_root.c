@@ -0,0 +1,99 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @mainpage Test Suite Specification
+ * Test suite for the ChibiOS/RT stackless coroutines. The purpose of
+ * this suite is to perform unit tests on the coroutines executor and on
+ * the coroutine synchronization objects.
+ *
+ * <h2>Test Sequences</h2>
+ * - @subpage co_test_sequence_001
+ * - @subpage co_test_sequence_002
+ * .
+ */
+
+/**
+ * @file    co_test_root.c
+ * @brief   Test Suite root structures code.
+ */
+
+#include "hal.h"
+#include "co_test_root.h"
+
+#if !defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Array of test sequences.
+ */
+const testsequence_t * const co_test_suite_array[] = {
+  &co_test_sequence_001,
+  &co_test_sequence_002,
+  NULL
+};
+
+/**
+ * @brief   Test suite root structure.
+ */
+const testsuite_t co_test_suite = {
+  "ChibiOS/RT Coroutines Test Suite",
+  co_test_suite_array
+};
+
+/*===========================================================================*/
+/* Shared code.                                                              */
+/*===========================================================================*/
+
+static THD_WORKING_AREA(wa_test, CO_TEST_STACK_SIZE);
+static thread_t *tp_test;
+
+/*
+ * Executor and tasks under test.
+ */
+co_executor_t executor;
+co_task_t tasks[CO_TEST_TASKS];
+
+/*
+ * Number of times each task function has been invoked.
+ */
+unsigned runs[CO_TEST_TASKS];
+
+/*
+ * Starts a thread with a priority lower than the test thread, it only runs
+ * while the executor is waiting.
+ */
+void test_start_thread(tfunc_t func, void *arg) {
+
+  tp_test = chThdCreateStatic(wa_test, sizeof (wa_test),
+                              chThdGetPriorityX() - 1, func, arg);
+}
+
+/*
+ * Waits for the completion of the thread started by test_start_thread().
+ */
+void test_wait_thread(void) {
+
+  if (tp_test != NULL) {
+    (void) chThdWait(tp_test);
+    tp_test = NULL;
+  }
+}
+
+#endif /* !defined(__DOXYGEN__) */
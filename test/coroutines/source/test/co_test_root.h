@@ -0,0 +1,78 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    co_test_root.h
+ * @brief   Test Suite root structures header.
+ */
+
+#ifndef CO_TEST_ROOT_H
+#define CO_TEST_ROOT_H
+
+#include "ch_test.h"
+
+#include "co_test_sequence_001.h"
+#include "co_test_sequence_002.h"
+
+#if !defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+extern const testsuite_t co_test_suite;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Shared definitions.                                                       */
+/*===========================================================================*/
+
+#include "coroutines.h"
+
+#define TEST_SUITE_NAME "ChibiOS/RT Coroutines Test Suite"
+
+/*
+ * Number of test tasks.
+ */
+#define CO_TEST_TASKS               2
+
+/*
+ * Stack size of the test thread.
+ */
+#if !defined(CO_TEST_STACK_SIZE)
+  #if defined(PORT__ARCHITECTURE_SIMIA32)
+    #define CO_TEST_STACK_SIZE      512
+  #else
+    #define CO_TEST_STACK_SIZE      256
+  #endif
+#endif
+
+extern co_executor_t executor;
+extern co_task_t tasks[CO_TEST_TASKS];
+extern unsigned runs[CO_TEST_TASKS];
+
+void test_start_thread(tfunc_t func, void *arg);
+void test_wait_thread(void);
+
+#endif /* !defined(__DOXYGEN__) */
+
+#endif /* CO_TEST_ROOT_H */
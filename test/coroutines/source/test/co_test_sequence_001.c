@@ -0,0 +1,245 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "co_test_root.h"
+
+/**
+ * @file    co_test_sequence_001.c
+ * @brief   Test Sequence 001 code.
+ *
+ * @page co_test_sequence_001 [1] Coroutine semaphores
+ *
+ * File: @ref co_test_sequence_001.c
+ *
+ * <h2>Description</h2>
+ * This sequence tests the coroutine semaphores, waiting tasks must be
+ * made ready by the semaphore signal without being polled.
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage co_test_001_001
+ * - @subpage co_test_001_002
+ * - @subpage co_test_001_003
+ * .
+ */
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+static co_semaphore_t sem1;
+
+static co_status_t waiter_task(co_task_t *ctp) {
+
+  runs[0]++;
+  CO_BEGIN(ctp);
+  test_emit_token('A');
+  CO_SEM_WAIT(ctp, &sem1);
+  test_emit_token('C');
+  CO_END(ctp);
+}
+
+static co_status_t signaler_task(co_task_t *ctp) {
+
+  runs[1]++;
+  CO_BEGIN(ctp);
+  test_emit_token('B');
+  coSemSignal(&sem1);
+  CO_END(ctp);
+}
+
+static co_status_t double_waiter_task(co_task_t *ctp) {
+
+  runs[0]++;
+  CO_BEGIN(ctp);
+  test_emit_token('A');
+  CO_SEM_WAIT(ctp, &sem1);
+  test_emit_token('C');
+  CO_SEM_WAIT(ctp, &sem1);
+  test_emit_token('E');
+  CO_END(ctp);
+}
+
+static THD_FUNCTION(signaler_thread, arg) {
+
+  (void)arg;
+
+  test_emit_token('B');
+  coSemSignal(&sem1);
+  test_emit_token('D');
+  coSemSignal(&sem1);
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page co_test_001_001 [1.1] Signaling between tasks
+ *
+ * <h2>Description</h2>
+ * A task waits on a semaphore with a zero counter and another task
+ * signals it. The waiting task must be resumed once, after the signal.
+ *
+ * <h2>Test Steps</h2>
+ * - [1.1.1] Starting the waiting task and the signaling task, the
+ *   waiting task must be resumed after the signal.
+ * .
+ */
+
+static void co_test_001_001_setup(void) {
+  coExecutorObjectInit(&executor);
+  coSemObjectInit(&sem1, 0);
+  runs[0] = 0U;
+  runs[1] = 0U;
+}
+
+static void co_test_001_001_execute(void) {
+
+  /* [1.1.1] Starting the waiting task and the signaling task, the
+     waiting task must be resumed after the signal.*/
+  test_set_step(1);
+  {
+    coTaskStart(&executor, &tasks[0], waiter_task, NULL);
+    coTaskStart(&executor, &tasks[1], signaler_task, NULL);
+    coExecutorRun(&executor);
+
+    test_assert_sequence("ABC", "invalid sequence");
+    test_assert(runs[0] == 2U, "waiting task polled");
+    test_assert(runs[1] == 1U, "signaling task run more than once");
+    test_assert_lock(coSemGetCounterI(&sem1) == 0, "counter not zero");
+  }
+  test_end_step(1);
+}
+
+static const testcase_t co_test_001_001 = {
+  "Signaling between tasks",
+  co_test_001_001_setup,
+  NULL,
+  co_test_001_001_execute
+};
+
+/**
+ * @page co_test_001_002 [1.2] Waiting on a positive counter
+ *
+ * <h2>Description</h2>
+ * A task waits twice on a semaphore with a counter of two, the task
+ * must never be suspended.
+ *
+ * <h2>Test Steps</h2>
+ * - [1.2.1] Starting the task, it must run to completion in a single
+ *   invocation.
+ * .
+ */
+
+static void co_test_001_002_setup(void) {
+  coExecutorObjectInit(&executor);
+  coSemObjectInit(&sem1, 2);
+  runs[0] = 0U;
+}
+
+static void co_test_001_002_execute(void) {
+
+  /* [1.2.1] Starting the task, it must run to completion in a single
+     invocation.*/
+  test_set_step(1);
+  {
+    coTaskStart(&executor, &tasks[0], double_waiter_task, NULL);
+    coExecutorRun(&executor);
+
+    test_assert_sequence("ACE", "invalid sequence");
+    test_assert(runs[0] == 1U, "task suspended");
+    test_assert_lock(coSemGetCounterI(&sem1) == 0, "counter not zero");
+  }
+  test_end_step(1);
+}
+
+static const testcase_t co_test_001_002 = {
+  "Waiting on a positive counter",
+  co_test_001_002_setup,
+  NULL,
+  co_test_001_002_execute
+};
+
+/**
+ * @page co_test_001_003 [1.3] Signaling from a thread
+ *
+ * <h2>Description</h2>
+ * A task waits twice on a semaphore signaled by a thread with lower
+ * priority than the executor. The thread only runs while the executor
+ * is waiting, the task must be resumed once for each signal.
+ *
+ * <h2>Test Steps</h2>
+ * - [1.3.1] Starting the task and the signaling thread, the task must
+ *   be resumed by each signal.
+ * .
+ */
+
+static void co_test_001_003_setup(void) {
+  coExecutorObjectInit(&executor);
+  coSemObjectInit(&sem1, 0);
+  runs[0] = 0U;
+}
+
+static void co_test_001_003_teardown(void) {
+  test_wait_thread();
+}
+
+static void co_test_001_003_execute(void) {
+
+  /* [1.3.1] Starting the task and the signaling thread, the task must
+     be resumed by each signal.*/
+  test_set_step(1);
+  {
+    coTaskStart(&executor, &tasks[0], double_waiter_task, NULL);
+    test_start_thread(signaler_thread, NULL);
+    coExecutorRun(&executor);
+
+    test_assert_sequence("ABCDE", "invalid sequence");
+    test_assert(runs[0] == 3U, "task polled");
+    test_assert_lock(coSemGetCounterI(&sem1) == 0, "counter not zero");
+  }
+  test_end_step(1);
+}
+
+static const testcase_t co_test_001_003 = {
+  "Signaling from a thread",
+  co_test_001_003_setup,
+  co_test_001_003_teardown,
+  co_test_001_003_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const co_test_sequence_001_array[] = {
+  &co_test_001_001,
+  &co_test_001_002,
+  &co_test_001_003,
+  NULL
+};
+
+/**
+ * @brief   Coroutine semaphores.
+ */
+const testsequence_t co_test_sequence_001 = {
+  "Coroutine semaphores",
+  co_test_sequence_001_array
+};
@@ -0,0 +1,329 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "co_test_root.h"
+
+/**
+ * @file    co_test_sequence_002.c
+ * @brief   Test Sequence 002 code.
+ *
+ * @page co_test_sequence_002 [2] Coroutine mailboxes
+ *
+ * File: @ref co_test_sequence_002.c
+ *
+ * <h2>Description</h2>
+ * This sequence tests the coroutine mailboxes, tasks blocked on a full
+ * or empty mailbox must be made ready by the opposite operation.
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage co_test_002_001
+ * - @subpage co_test_002_002
+ * - @subpage co_test_002_003
+ * - @subpage co_test_002_004
+ * .
+ */
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#define MB_SIZE 2
+#define MB_MESSAGES 6
+
+static co_mailbox_t mb1;
+static msg_t mb_buffer[MB_SIZE];
+static msg_t received[MB_MESSAGES];
+static unsigned nposted, nfetched;
+
+static co_status_t producer_task(co_task_t *ctp) {
+
+  runs[0]++;
+  CO_BEGIN(ctp);
+  while (nposted < (unsigned)MB_MESSAGES) {
+    CO_MB_POST(ctp, &mb1, (msg_t)('A' + nposted));
+    nposted++;
+  }
+  CO_END(ctp);
+}
+
+static co_status_t consumer_task(co_task_t *ctp) {
+
+  runs[1]++;
+  CO_BEGIN(ctp);
+  while (nfetched < (unsigned)MB_MESSAGES) {
+    CO_MB_FETCH(ctp, &mb1, &received[nfetched]);
+    test_emit_token((char)received[nfetched]);
+    nfetched++;
+  }
+  CO_END(ctp);
+}
+
+static THD_FUNCTION(poster_thread, arg) {
+  msg_t msg;
+
+  (void)arg;
+
+  for (msg = (msg_t)'A'; msg <= (msg_t)'C'; msg++) {
+    test_assert(coMBPost(&mb1, msg) == MSG_OK, "post failed");
+  }
+}
+
+static THD_FUNCTION(fetcher_thread, arg) {
+  msg_t msg;
+  unsigned i;
+
+  (void)arg;
+
+  for (i = 0U; i < 4U; i++) {
+    chSysLock();
+    msg = coMBFetchI(&mb1, &received[i]);
+    chSchRescheduleS();
+    chSysUnlock();
+    test_assert(msg == MSG_OK, "fetch failed");
+    test_emit_token((char)received[i]);
+  }
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page co_test_002_001 [2.1] Producer and consumer tasks
+ *
+ * <h2>Description</h2>
+ * A producer task posts more messages than the mailbox can hold and a
+ * consumer task fetches them, both tasks block on the mailbox. The
+ * messages must be received in order.
+ *
+ * <h2>Test Steps</h2>
+ * - [2.1.1] Starting the producer and the consumer, all the messages
+ *   must be received in order and the mailbox must be left empty.
+ * .
+ */
+
+static void co_test_002_001_setup(void) {
+  coExecutorObjectInit(&executor);
+  coMBObjectInit(&mb1, mb_buffer, MB_SIZE);
+  nposted  = 0U;
+  nfetched = 0U;
+  runs[0]  = 0U;
+  runs[1]  = 0U;
+}
+
+static void co_test_002_001_execute(void) {
+
+  /* [2.1.1] Starting the producer and the consumer, all the messages
+     must be received in order and the mailbox must be left empty.*/
+  test_set_step(1);
+  {
+    coTaskStart(&executor, &tasks[0], producer_task, NULL);
+    coTaskStart(&executor, &tasks[1], consumer_task, NULL);
+    coExecutorRun(&executor);
+
+    test_assert_sequence("ABCDEF", "invalid sequence");
+    test_assert(runs[0] > 1U, "producer not blocked");
+    test_assert(runs[1] > 1U, "consumer not blocked");
+    test_assert_lock(coMBGetUsedCountI(&mb1) == 0U, "mailbox not empty");
+    test_assert_lock(coSemGetCounterI(&mb1.emptysem) == MB_SIZE,
+                     "wrong free slots");
+  }
+  test_end_step(1);
+}
+
+static const testcase_t co_test_002_001 = {
+  "Producer and consumer tasks",
+  co_test_002_001_setup,
+  NULL,
+  co_test_002_001_execute
+};
+
+/**
+ * @page co_test_002_002 [2.2] Posting from a thread
+ *
+ * <h2>Description</h2>
+ * A task fetches messages from an empty mailbox, the messages are
+ * posted by a thread with lower priority than the executor. The task
+ * must be resumed once for each posted message.
+ *
+ * <h2>Test Steps</h2>
+ * - [2.2.1] Starting the consumer task and the posting thread, the
+ *   consumer must be resumed by each post.
+ * .
+ */
+
+static void co_test_002_002_setup(void) {
+  coExecutorObjectInit(&executor);
+  coMBObjectInit(&mb1, mb_buffer, MB_SIZE);
+  nfetched = 3U;
+  runs[1]  = 0U;
+}
+
+static void co_test_002_002_teardown(void) {
+  test_wait_thread();
+}
+
+static void co_test_002_002_execute(void) {
+
+  /* [2.2.1] Starting the consumer task and the posting thread, the
+     consumer must be resumed by each post.*/
+  test_set_step(1);
+  {
+    coTaskStart(&executor, &tasks[1], consumer_task, NULL);
+    test_start_thread(poster_thread, NULL);
+    coExecutorRun(&executor);
+
+    test_assert_sequence("ABC", "invalid sequence");
+    test_assert(runs[1] == 4U, "consumer polled");
+    test_assert_lock(coMBGetUsedCountI(&mb1) == 0U, "mailbox not empty");
+  }
+  test_end_step(1);
+}
+
+static const testcase_t co_test_002_002 = {
+  "Posting from a thread",
+  co_test_002_002_setup,
+  co_test_002_002_teardown,
+  co_test_002_002_execute
+};
+
+/**
+ * @page co_test_002_003 [2.3] Fetching from a thread
+ *
+ * <h2>Description</h2>
+ * A task posts messages into a single slot mailbox, the messages are
+ * fetched by a thread with lower priority than the executor. The task
+ * must be resumed once for each freed slot.
+ *
+ * <h2>Test Steps</h2>
+ * - [2.3.1] Starting the producer task and the fetching thread, the
+ *   producer must be resumed by each fetch.
+ * .
+ */
+
+static void co_test_002_003_setup(void) {
+  coExecutorObjectInit(&executor);
+  coMBObjectInit(&mb1, mb_buffer, 1U);
+  nposted = 2U;
+  runs[0] = 0U;
+}
+
+static void co_test_002_003_teardown(void) {
+  test_wait_thread();
+}
+
+static void co_test_002_003_execute(void) {
+
+  /* [2.3.1] Starting the producer task and the fetching thread, the
+     producer must be resumed by each fetch.*/
+  test_set_step(1);
+  {
+    coTaskStart(&executor, &tasks[0], producer_task, NULL);
+    test_start_thread(fetcher_thread, NULL);
+    coExecutorRun(&executor);
+    test_wait_thread();
+
+    test_assert_sequence("CDEF", "invalid sequence");
+    test_assert(runs[0] == 4U, "producer polled");
+    test_assert_lock(coMBGetUsedCountI(&mb1) == 0U, "mailbox not empty");
+  }
+  test_end_step(1);
+}
+
+static const testcase_t co_test_002_003 = {
+  "Fetching from a thread",
+  co_test_002_003_setup,
+  co_test_002_003_teardown,
+  co_test_002_003_execute
+};
+
+/**
+ * @page co_test_002_004 [2.4] Non-blocking operations
+ *
+ * <h2>Description</h2>
+ * The non-blocking post and fetch functions are tested on a full and
+ * on an empty mailbox.
+ *
+ * <h2>Test Steps</h2>
+ * - [2.4.1] Filling the mailbox, the last post must fail.
+ * - [2.4.2] Emptying the mailbox, the messages must be fetched in order
+ *   and the last fetch must fail.
+ * .
+ */
+
+static void co_test_002_004_setup(void) {
+  coMBObjectInit(&mb1, mb_buffer, MB_SIZE);
+}
+
+static void co_test_002_004_execute(void) {
+  msg_t msg;
+
+  /* [2.4.1] Filling the mailbox, the last post must fail.*/
+  test_set_step(1);
+  {
+    test_assert(coMBPost(&mb1, (msg_t)'A') == MSG_OK, "post failed");
+    test_assert(coMBPost(&mb1, (msg_t)'B') == MSG_OK, "post failed");
+    test_assert(coMBPost(&mb1, (msg_t)'C') == MSG_TIMEOUT,
+                "post on full mailbox");
+    test_assert_lock(coMBGetUsedCountI(&mb1) == MB_SIZE, "not full");
+  }
+  test_end_step(1);
+
+  /* [2.4.2] Emptying the mailbox, the messages must be fetched in order
+     and the last fetch must fail.*/
+  test_set_step(2);
+  {
+    test_assert_lock(coMBFetchI(&mb1, &msg) == MSG_OK, "fetch failed");
+    test_assert(msg == (msg_t)'A', "wrong message");
+    test_assert_lock(coMBFetchI(&mb1, &msg) == MSG_OK, "fetch failed");
+    test_assert(msg == (msg_t)'B', "wrong message");
+    test_assert_lock(coMBFetchI(&mb1, &msg) == MSG_TIMEOUT,
+                     "fetch on empty mailbox");
+    test_assert_lock(coMBGetUsedCountI(&mb1) == 0U, "not empty");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t co_test_002_004 = {
+  "Non-blocking operations",
+  co_test_002_004_setup,
+  NULL,
+  co_test_002_004_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const co_test_sequence_002_array[] = {
+  &co_test_002_001,
+  &co_test_002_002,
+  &co_test_002_003,
+  &co_test_002_004,
+  NULL
+};
+
+/**
+ * @brief   Coroutine mailboxes.
+ */
+const testsequence_t co_test_sequence_002 = {
+  "Coroutine mailboxes",
+  co_test_sequence_002_array
+};
@@ -30,6 +30,7 @@
  * - @subpage cry_test_sequence_007
  * - @subpage cry_test_sequence_008
  * - @subpage cry_test_sequence_009
+ * - @subpage cry_test_sequence_010
  * .
  */
 
@@ -55,11 +56,16 @@ const testsequence_t * const cry_test_suite_array[] = {
   &cry_test_sequence_002,
   &cry_test_sequence_003,
   &cry_test_sequence_004,
+#if (HAL_USE_TRNG == TRUE) || defined(__DOXYGEN__)
   &cry_test_sequence_005,
+#endif
   &cry_test_sequence_006,
   &cry_test_sequence_007,
   &cry_test_sequence_008,
   &cry_test_sequence_009,
+#if (CRY_TEST_USE_QUEUE == TRUE) || defined(__DOXYGEN__)
+  &cry_test_sequence_010,
+#endif
   NULL
 };
 
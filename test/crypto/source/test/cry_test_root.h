@@ -33,6 +33,7 @@
 #include "cry_test_sequence_007.h"
 #include "cry_test_sequence_008.h"
 #include "cry_test_sequence_009.h"
+#include "cry_test_sequence_010.h"
 
 #if !defined(__DOXYGEN__)
 
@@ -65,6 +66,22 @@ extern void cryptoTest_printArray32(bool isLE,const uint32_t *a,size_t len);
 #define SHOW_DATA(d,w)
 #endif
 
+/* Driver configurations used by the test cases, the default NULL is valid
+   for drivers without configuration, a specific configuration can be
+   defined in the test application makefile.*/
+#if !defined(CRY_TEST_CONFIG_POLLING)
+#define CRY_TEST_CONFIG_POLLING     NULL
+#endif
+#if !defined(CRY_TEST_CONFIG_DMA)
+#define CRY_TEST_CONFIG_DMA         NULL
+#endif
+
+/* The requests queue tests require the queue driver and the RT kernel
+   for the dispatcher thread, disabled by default.*/
+#if !defined(CRY_TEST_USE_QUEUE)
+#define CRY_TEST_USE_QUEUE          FALSE
+#endif
+
 #define TEST_DATA_BYTE_LEN 	640
 #define TEST_DATA_WORD_LEN		(TEST_DATA_BYTE_LEN / 4)
 
@@ -40,15 +40,7 @@
 
 #include <string.h>
 #include "ref_aes.h"
-static const CRYConfig config_Polling = {
-    TRANSFER_POLLING,
-    AES_CFBS_128       //cfbs
-};
 
-static const CRYConfig config_DMA = {
-    TRANSFER_DMA,
-    AES_CFBS_128       //cfbs
-};
 
 
 /****************************************************************************
@@ -78,7 +70,7 @@ static void cry_test_001_001_setup(void) {
   memcpy((char*) msg_clear, test_plain_data, TEST_DATA_BYTE_LEN);
   memset(msg_encrypted, 0xff, TEST_MSG_DATA_BYTE_LEN);
   memset(msg_decrypted, 0xff, TEST_MSG_DATA_BYTE_LEN);
-  cryStart(&CRYD1, &config_Polling);
+  cryStart(&CRYD1, CRY_TEST_CONFIG_POLLING);
 
 
 }
@@ -93,7 +85,7 @@ static void cry_test_001_001_execute(void) {
   /* [1.1.1] loading the key with 16 byte size.*/
   test_set_step(1);
   {
-    ret = cryLoadTransientKey(&CRYD1, (cryalgorithm_t) cry_algo_aes,16, (uint8_t *) test_keys);
+    ret = cryLoadAESTransientKey(&CRYD1, 16, (uint8_t *) test_keys);
 
     test_assert(ret == CRY_NOERROR, "failed load transient key");
   }
@@ -134,7 +126,7 @@ static void cry_test_001_001_execute(void) {
   /* [1.1.4] loading the key with 24 byte size.*/
   test_set_step(4);
   {
-    ret = cryLoadTransientKey(&CRYD1, (cryalgorithm_t) cry_algo_aes,24, (uint8_t *) test_keys);
+    ret = cryLoadAESTransientKey(&CRYD1, 24, (uint8_t *) test_keys);
 
     test_assert(ret == CRY_NOERROR, "failed load transient key");
   }
@@ -175,7 +167,7 @@ static void cry_test_001_001_execute(void) {
   /* [1.1.7] loading the key with 32 byte size.*/
   test_set_step(7);
   {
-    ret = cryLoadTransientKey(&CRYD1, (cryalgorithm_t) cry_algo_aes,32, (uint8_t *) test_keys);
+    ret = cryLoadAESTransientKey(&CRYD1, 32, (uint8_t *) test_keys);
 
     test_assert(ret == CRY_NOERROR, "failed load transient key");
   }
@@ -244,7 +236,7 @@ static void cry_test_001_002_setup(void) {
   memcpy((char*) msg_clear, test_plain_data, TEST_DATA_BYTE_LEN);
   memset(msg_encrypted, 0xff, TEST_MSG_DATA_BYTE_LEN);
   memset(msg_decrypted, 0xff, TEST_MSG_DATA_BYTE_LEN);
-  cryStart(&CRYD1, &config_DMA);
+  cryStart(&CRYD1, CRY_TEST_CONFIG_DMA);
 
 
 }
@@ -259,7 +251,7 @@ static void cry_test_001_002_execute(void) {
   /* [1.2.1] loading the key with 16 byte size.*/
   test_set_step(1);
   {
-    ret = cryLoadTransientKey(&CRYD1, (cryalgorithm_t) cry_algo_aes,16, (uint8_t *) test_keys);
+    ret = cryLoadAESTransientKey(&CRYD1, 16, (uint8_t *) test_keys);
 
     test_assert(ret == CRY_NOERROR, "failed load transient key");
   }
@@ -300,7 +292,7 @@ static void cry_test_001_002_execute(void) {
   /* [1.2.4] loading the key with 24 byte size.*/
   test_set_step(4);
   {
-    ret = cryLoadTransientKey(&CRYD1, (cryalgorithm_t) cry_algo_aes,24, (uint8_t *) test_keys);
+    ret = cryLoadAESTransientKey(&CRYD1, 24, (uint8_t *) test_keys);
 
     test_assert(ret == CRY_NOERROR, "failed load transient key");
   }
@@ -341,7 +333,7 @@ static void cry_test_001_002_execute(void) {
   /* [1.2.7] loading the key with 32 byte size.*/
   test_set_step(7);
   {
-    ret = cryLoadTransientKey(&CRYD1, (cryalgorithm_t) cry_algo_aes,32, (uint8_t *) test_keys);
+    ret = cryLoadAESTransientKey(&CRYD1, 32, (uint8_t *) test_keys);
 
     test_assert(ret == CRY_NOERROR, "failed load transient key");
   }
@@ -43,17 +43,7 @@
 
 #include <string.h>
 #include "ref_des.h"
-static const CRYConfig configDES_Polling=
-{
-		TRANSFER_POLLING,
-		0
-};
 
-static const CRYConfig configDES_DMA=
-{
-		TRANSFER_DMA,
-		0
-};
 
 
 
@@ -78,7 +68,7 @@ static void cry_test_004_001_setup(void) {
   memcpy((char*) msg_clear, test_plain_data, TEST_DATA_BYTE_LEN);
   memset(msg_encrypted, 0xff, TEST_MSG_DATA_BYTE_LEN);
   memset(msg_decrypted, 0xff, TEST_MSG_DATA_BYTE_LEN);
-  cryStart(&CRYD1, &configDES_Polling);
+  cryStart(&CRYD1, CRY_TEST_CONFIG_POLLING);
 
 
 }
@@ -93,7 +83,7 @@ static void cry_test_004_001_execute(void) {
   /* [4.1.1] loading the key with 8 byte size.*/
   test_set_step(1);
   {
-    ret = cryLoadTransientKey(&CRYD1, (cryalgorithm_t) cry_algo_des,8, (uint8_t *) test_keys);
+    ret = cryLoadDESTransientKey(&CRYD1, 8, (uint8_t *) test_keys);
 
     test_assert(ret == CRY_NOERROR, "failed load transient key");
   }
@@ -159,7 +149,7 @@ static void cry_test_004_002_setup(void) {
   memcpy((char*) msg_clear, test_plain_data, TEST_DATA_BYTE_LEN);
   memset(msg_encrypted, 0xff, TEST_MSG_DATA_BYTE_LEN);
   memset(msg_decrypted, 0xff, TEST_MSG_DATA_BYTE_LEN);
-  cryStart(&CRYD1, &configDES_Polling);
+  cryStart(&CRYD1, CRY_TEST_CONFIG_POLLING);
 
 
 }
@@ -174,7 +164,7 @@ static void cry_test_004_002_execute(void) {
   /* [4.2.1] loading the key with 16 byte size.*/
   test_set_step(1);
   {
-    ret = cryLoadTransientKey(&CRYD1, (cryalgorithm_t) cry_algo_des,16, (uint8_t *) test_keys);
+    ret = cryLoadDESTransientKey(&CRYD1, 16, (uint8_t *) test_keys);
 
     test_assert(ret == CRY_NOERROR, "failed load transient key");
   }
@@ -215,7 +205,7 @@ static void cry_test_004_002_execute(void) {
   /* [4.2.4] loading the key with 24 byte size.*/
   test_set_step(4);
   {
-    ret = cryLoadTransientKey(&CRYD1, (cryalgorithm_t) cry_algo_des,24, (uint8_t *) test_keys);
+    ret = cryLoadDESTransientKey(&CRYD1, 24, (uint8_t *) test_keys);
 
     test_assert(ret == CRY_NOERROR, "failed load transient key");
   }
@@ -281,7 +271,7 @@ static void cry_test_004_003_setup(void) {
   memcpy((char*) msg_clear, test_plain_data, TEST_DATA_BYTE_LEN);
   memset(msg_encrypted, 0xff, TEST_MSG_DATA_BYTE_LEN);
   memset(msg_decrypted, 0xff, TEST_MSG_DATA_BYTE_LEN);
-  cryStart(&CRYD1, &configDES_Polling);
+  cryStart(&CRYD1, CRY_TEST_CONFIG_POLLING);
 
 
 }
@@ -296,7 +286,7 @@ static void cry_test_004_003_execute(void) {
   /* [4.3.1] loading the key with 16 byte size.*/
   test_set_step(1);
   {
-    ret = cryLoadTransientKey(&CRYD1, (cryalgorithm_t) cry_algo_des,16, (uint8_t *) test_keys);
+    ret = cryLoadDESTransientKey(&CRYD1, 16, (uint8_t *) test_keys);
 
     test_assert(ret == CRY_NOERROR, "failed load transient key");
   }
@@ -337,7 +327,7 @@ static void cry_test_004_003_execute(void) {
   /* [4.3.4] loading the key with 24 byte size.*/
   test_set_step(4);
   {
-    ret = cryLoadTransientKey(&CRYD1, (cryalgorithm_t) cry_algo_des,24, (uint8_t *) test_keys);
+    ret = cryLoadDESTransientKey(&CRYD1, 24, (uint8_t *) test_keys);
 
     test_assert(ret == CRY_NOERROR, "failed load transient key");
   }
@@ -403,7 +393,7 @@ static void cry_test_004_004_setup(void) {
   memcpy((char*) msg_clear, test_plain_data, TEST_DATA_BYTE_LEN);
   memset(msg_encrypted, 0xff, TEST_MSG_DATA_BYTE_LEN);
   memset(msg_decrypted, 0xff, TEST_MSG_DATA_BYTE_LEN);
-  cryStart(&CRYD1, &configDES_DMA);
+  cryStart(&CRYD1, CRY_TEST_CONFIG_DMA);
 
 
 }
@@ -418,7 +408,7 @@ static void cry_test_004_004_execute(void) {
   /* [4.4.1] loading the key with 16 byte size.*/
   test_set_step(1);
   {
-    ret = cryLoadTransientKey(&CRYD1, (cryalgorithm_t) cry_algo_des,16, (uint8_t *) test_keys);
+    ret = cryLoadDESTransientKey(&CRYD1, 16, (uint8_t *) test_keys);
 
     test_assert(ret == CRY_NOERROR, "failed load transient key");
   }
@@ -459,7 +449,7 @@ static void cry_test_004_004_execute(void) {
   /* [4.4.4] loading the key with 24 byte size.*/
   test_set_step(4);
   {
-    ret = cryLoadTransientKey(&CRYD1, (cryalgorithm_t) cry_algo_des,24, (uint8_t *) test_keys);
+    ret = cryLoadDESTransientKey(&CRYD1, 24, (uint8_t *) test_keys);
 
     test_assert(ret == CRY_NOERROR, "failed load transient key");
   }
@@ -525,7 +515,7 @@ static void cry_test_004_005_setup(void) {
   memcpy((char*) msg_clear, test_plain_data, TEST_DATA_BYTE_LEN);
   memset(msg_encrypted, 0xff, TEST_MSG_DATA_BYTE_LEN);
   memset(msg_decrypted, 0xff, TEST_MSG_DATA_BYTE_LEN);
-  cryStart(&CRYD1, &configDES_DMA);
+  cryStart(&CRYD1, CRY_TEST_CONFIG_DMA);
 
 
 }
@@ -540,7 +530,7 @@ static void cry_test_004_005_execute(void) {
   /* [4.5.1] loading the key with 16 byte size.*/
   test_set_step(1);
   {
-    ret = cryLoadTransientKey(&CRYD1, (cryalgorithm_t) cry_algo_des,16, (uint8_t *) test_keys);
+    ret = cryLoadDESTransientKey(&CRYD1, 16, (uint8_t *) test_keys);
 
     test_assert(ret == CRY_NOERROR, "failed load transient key");
   }
@@ -581,7 +571,7 @@ static void cry_test_004_005_execute(void) {
   /* [4.5.4] loading the key with 24 byte size.*/
   test_set_step(4);
   {
-    ret = cryLoadTransientKey(&CRYD1, (cryalgorithm_t) cry_algo_des,24, (uint8_t *) test_keys);
+    ret = cryLoadDESTransientKey(&CRYD1, 24, (uint8_t *) test_keys);
 
     test_assert(ret == CRY_NOERROR, "failed load transient key");
   }
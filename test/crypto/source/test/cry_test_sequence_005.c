@@ -28,22 +28,25 @@
  * <h2>Description</h2>
  * TRNG testing.
  *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - HAL_USE_TRNG == TRUE
+ * .
+ *
  * <h2>Test Cases</h2>
  * - @subpage cry_test_005_001
  * .
  */
 
+#if (HAL_USE_TRNG == TRUE) || defined(__DOXYGEN__)
+
 /****************************************************************************
  * Shared code.
  ****************************************************************************/
 
 #include <string.h>
 
-static const CRYConfig configTRNG_Polling=
-{
-    TRANSFER_POLLING,
-    0
-};
 
 
 
@@ -63,17 +66,17 @@ static const CRYConfig configTRNG_Polling=
  */
 
 static void cry_test_005_001_setup(void) {
-  cryStart(&CRYD1, &configTRNG_Polling);
+  trngStart(&TRNGD1, NULL);
 
 
 }
 
 static void cry_test_005_001_teardown(void) {
-  cryStop(&CRYD1);
+  trngStop(&TRNGD1);
 }
 
 static void cry_test_005_001_execute(void) {
-    cryerror_t ret;
+  bool ret;
 
   /* [5.1.1] Random generation and test.*/
   test_set_step(1);
@@ -81,9 +84,9 @@ static void cry_test_005_001_execute(void) {
     uint32_t random[4];
     int i;
 
-    ret = cryTRNG(&CRYD1,(uint8_t*)&random);
+    ret = trngGenerate(&TRNGD1, sizeof random, (uint8_t*)&random);
 
-    test_assert(ret == CRY_NOERROR , "failed random");
+    test_assert(ret == false, "failed random");
 
     SHOW_DATA(&random[0],4);
 
@@ -126,3 +129,5 @@ const testsequence_t cry_test_sequence_005 = {
   "TRNG",
   cry_test_sequence_005_array
 };
+
+#endif /* HAL_USE_TRNG == TRUE */
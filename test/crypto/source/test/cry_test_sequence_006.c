@@ -56,11 +56,6 @@
 #define digest		msg_encrypted
 
 
-static const CRYConfig configSHA_Polling=
-{
-    TRANSFER_POLLING,
-    0
-};
 
 
 static cryerror_t crySHA1(CRYDriver *cryp, size_t size,const uint8_t *in, uint8_t *out) {
@@ -68,8 +63,6 @@ static cryerror_t crySHA1(CRYDriver *cryp, size_t size,const uint8_t *in, uint8_
 	cryerror_t ret;
 	SHA1Context shactxp;
 
-    shactxp.sha.sha_buffer = (uint8_t*)&shabuffer[0];
-	shactxp.sha.sha_buffer_size = MAX_SHA_BLOCK_SIZE;
 
 
 	ret = crySHA1Init(cryp,&shactxp);
@@ -87,8 +80,6 @@ static cryerror_t crySHA256(CRYDriver *cryp, size_t size,const uint8_t *in, uint
 	cryerror_t ret;
 	SHA256Context shactxp;
 
-    shactxp.sha.sha_buffer = (uint8_t*)&shabuffer[0];
-	shactxp.sha.sha_buffer_size = MAX_SHA_BLOCK_SIZE;
 
 
 	ret = crySHA256Init(cryp,&shactxp);
@@ -106,8 +97,6 @@ static cryerror_t crySHA512(CRYDriver *cryp, size_t size,const uint8_t *in, uint
 	cryerror_t ret;
 	SHA512Context shactxp;
 
-    shactxp.sha.sha_buffer = (uint8_t*)&shabuffer[0];
-	shactxp.sha.sha_buffer_size = MAX_SHA_BLOCK_SIZE;
 
 
 	ret = crySHA512Init(cryp,&shactxp);
@@ -141,7 +130,7 @@ static void cry_test_006_001_setup(void) {
   memset(msg_clear, 0, TEST_MSG_DATA_BYTE_LEN);
   memset(digest, 0, MAX_DIGEST_SIZE_INWORD);
   memcpy((char*) msg_clear, sha_msg0, SHA_LEN_0);
-  cryStart(&CRYD1, &configSHA_Polling);
+  cryStart(&CRYD1, CRY_TEST_CONFIG_POLLING);
 
 
 }
@@ -258,7 +247,7 @@ static void cry_test_006_002_setup(void) {
   memset(msg_clear, 0, TEST_MSG_DATA_BYTE_LEN);
   memset(digest, 0, MAX_DIGEST_SIZE_INWORD);
   memcpy((char*) msg_clear, sha_msg0, SHA_LEN_0);
-  cryStart(&CRYD1, &configSHA_Polling);
+  cryStart(&CRYD1, CRY_TEST_CONFIG_POLLING);
 
 
 }
@@ -361,7 +350,7 @@ static void cry_test_006_003_setup(void) {
   memset(msg_clear, 0, TEST_MSG_DATA_BYTE_LEN);
   memset(digest, 0, MAX_DIGEST_SIZE_INWORD);
   memcpy((char*) msg_clear, sha_msg0, SHA_LEN_0);
-  cryStart(&CRYD1, &configSHA_Polling);
+  cryStart(&CRYD1, CRY_TEST_CONFIG_POLLING);
 
 
 }
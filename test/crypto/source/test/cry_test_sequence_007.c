@@ -54,19 +54,12 @@
 #define MAX_DIGEST_SIZE_INWORD  (MAX_DIGEST_SIZE_INBYTE/4)
 
 #define digest		msg_encrypted
-static const CRYConfig configSHA_DMA=
-{
-    TRANSFER_DMA,
-    0
-};
 
 static cryerror_t crySHA1(CRYDriver *cryp, size_t size,const uint8_t *in, uint8_t *out) {
 
 	cryerror_t ret;
 	SHA1Context shactxp;
 
-    shactxp.sha.sha_buffer = (uint8_t*)&shabuffer[0];
-	shactxp.sha.sha_buffer_size = MAX_SHA_BLOCK_SIZE;
 
 	ret = crySHA1Init(cryp,&shactxp);
 
@@ -83,8 +76,6 @@ static cryerror_t crySHA256(CRYDriver *cryp, size_t size,const uint8_t *in, uint
 	cryerror_t ret;
 	SHA256Context shactxp;
 
-    shactxp.sha.sha_buffer = (uint8_t*)&shabuffer[0];
-	shactxp.sha.sha_buffer_size = MAX_SHA_BLOCK_SIZE;
 
 
 	ret = crySHA256Init(cryp,&shactxp);
@@ -102,8 +93,6 @@ static cryerror_t crySHA512(CRYDriver *cryp, size_t size,const uint8_t *in, uint
 	cryerror_t ret;
 	SHA512Context shactxp;
 
-    shactxp.sha.sha_buffer = (uint8_t*)&shabuffer[0];
-	shactxp.sha.sha_buffer_size = MAX_SHA_BLOCK_SIZE;
 
 	ret = crySHA512Init(cryp,&shactxp);
 
@@ -136,7 +125,7 @@ static void cry_test_007_001_setup(void) {
   memset(msg_clear, 0, TEST_MSG_DATA_BYTE_LEN);
   memset(digest, 0, MAX_DIGEST_SIZE_INWORD);
   memcpy((char*) msg_clear, sha_msg0, SHA_LEN_0);
-  cryStart(&CRYD1, &configSHA_DMA);
+  cryStart(&CRYD1, CRY_TEST_CONFIG_DMA);
 
 
 }
@@ -252,7 +241,7 @@ static void cry_test_007_002_setup(void) {
   memset(msg_clear, 0, TEST_MSG_DATA_BYTE_LEN);
   memset(digest, 0, MAX_DIGEST_SIZE_INWORD);
   memcpy((char*) msg_clear, sha_msg0, SHA_LEN_0);
-  cryStart(&CRYD1, &configSHA_DMA);
+  cryStart(&CRYD1, CRY_TEST_CONFIG_DMA);
 
 
 }
@@ -355,7 +344,7 @@ static void cry_test_007_003_setup(void) {
   memset(msg_clear, 0, TEST_MSG_DATA_BYTE_LEN);
   memset(digest, 0, MAX_DIGEST_SIZE_INWORD);
   memcpy((char*) msg_clear, sha_msg0, SHA_LEN_0);
-  cryStart(&CRYD1, &configSHA_DMA);
+  cryStart(&CRYD1, CRY_TEST_CONFIG_DMA);
 
 
 }
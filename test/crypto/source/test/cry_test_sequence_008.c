@@ -44,17 +44,7 @@
 #define cypher	  msg_encrypted
 #define authtag	  msg_decrypted
 
-static const CRYConfig config_Polling=
-{
-		TRANSFER_POLLING,
-		0
-};
 
-static const CRYConfig config_DMA=
-{
-		TRANSFER_DMA,
-		0
-};
 
 struct test_el_t
 {
@@ -103,7 +93,7 @@ const struct test_gcm_t test_gcm_k[TEST_GCM_LEN]={
 static void cry_test_008_001_setup(void) {
     memset(cypher, 0xff, TEST_MSG_DATA_BYTE_LEN);
     memset(authtag, 0xff, TEST_MSG_DATA_BYTE_LEN);
-    cryStart(&CRYD1, &config_Polling);
+    cryStart(&CRYD1, CRY_TEST_CONFIG_POLLING);
 
 
 }
@@ -128,7 +118,7 @@ static void cry_test_008_001_execute(void) {
     		/* loading the key .*/
 
     		{
-    			ret = cryLoadTransientKey(&CRYD1, (cryalgorithm_t) cry_algo_aes,test_gcm_k[i].key.size, (uint8_t *) test_gcm_k[i].key.data);
+    			ret = cryLoadAESTransientKey(&CRYD1, test_gcm_k[i].key.size, (uint8_t *) test_gcm_k[i].key.data);
 
     			test_assert(ret == CRY_NOERROR, "failed load transient key");
     		}
@@ -139,12 +129,13 @@ static void cry_test_008_001_execute(void) {
 
     			ret = cryEncryptAES_GCM(&CRYD1,
     									0,
+    									test_gcm_k[i].aad.size,
+    									test_gcm_k[i].aad.data,
     									test_gcm_k[i].p.size,
     									test_gcm_k[i].p.data,
     									(uint8_t*)cypher,
     									test_gcm_k[i].iv.data,
-    									test_gcm_k[i].aad.size,
-    									test_gcm_k[i].aad.data,
+    									test_gcm_k[i].t.size,
     									(uint8_t*)authtag);
 
     			test_assert(ret == CRY_NOERROR, "failed encryption");
@@ -178,12 +169,13 @@ static void cry_test_008_001_execute(void) {
 
     			ret = cryDecryptAES_GCM(&CRYD1,
     									0,
+    									test_gcm_k[i].aad.size,
+    									test_gcm_k[i].aad.data,
     									test_gcm_k[i].c.size,
     									(uint8_t*)cypher,
     									(uint8_t*)plaintext,
     									test_gcm_k[i].iv.data,
-    									test_gcm_k[i].aad.size,
-    									test_gcm_k[i].aad.data,
+    									test_gcm_k[i].t.size,
     									(uint8_t*)authtag);
 
     			test_assert(ret == CRY_NOERROR, "failed decryption");
@@ -227,7 +219,7 @@ static const testcase_t cry_test_008_001 = {
 static void cry_test_008_002_setup(void) {
     memset(cypher, 0xff, TEST_MSG_DATA_BYTE_LEN);
     memset(authtag, 0xff, TEST_MSG_DATA_BYTE_LEN);
-    cryStart(&CRYD1, &config_DMA);
+    cryStart(&CRYD1, CRY_TEST_CONFIG_DMA);
 
 
 }
@@ -252,7 +244,7 @@ static void cry_test_008_002_execute(void) {
     		/* loading the key .*/
 
     		{
-    			ret = cryLoadTransientKey(&CRYD1, (cryalgorithm_t) cry_algo_aes,test_gcm_k[i].key.size, (uint8_t *) test_gcm_k[i].key.data);
+    			ret = cryLoadAESTransientKey(&CRYD1, test_gcm_k[i].key.size, (uint8_t *) test_gcm_k[i].key.data);
 
     			test_assert(ret == CRY_NOERROR, "failed load transient key");
     		}
@@ -263,12 +255,13 @@ static void cry_test_008_002_execute(void) {
 
     			ret = cryEncryptAES_GCM(&CRYD1,
     									0,
+    									test_gcm_k[i].aad.size,
+    									test_gcm_k[i].aad.data,
     									test_gcm_k[i].p.size,
     									test_gcm_k[i].p.data,
     									(uint8_t*)cypher,
     									test_gcm_k[i].iv.data,
-    									test_gcm_k[i].aad.size,
-    									test_gcm_k[i].aad.data,
+    									test_gcm_k[i].t.size,
     									(uint8_t*)authtag);
 
     			test_assert(ret == CRY_NOERROR, "failed encryption");
@@ -302,12 +295,13 @@ static void cry_test_008_002_execute(void) {
 
     			ret = cryDecryptAES_GCM(&CRYD1,
     									0,
+    									test_gcm_k[i].aad.size,
+    									test_gcm_k[i].aad.data,
     									test_gcm_k[i].c.size,
     									(uint8_t*)cypher,
     									(uint8_t*)plaintext,
     									test_gcm_k[i].iv.data,
-    									test_gcm_k[i].aad.size,
-    									test_gcm_k[i].aad.data,
+    									test_gcm_k[i].t.size,
     									(uint8_t*)authtag);
 
     			test_assert(ret == CRY_NOERROR, "failed decryption");
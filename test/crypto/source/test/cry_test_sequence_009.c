@@ -47,17 +47,7 @@
 #define MAX_SHA_BLOCK_SIZE			TEST_MSG_DATA_BYTE_LEN
 #define MAX_SHA_BLOCK_SIZE_INWORD  (MAX_SHA_BLOCK_SIZE/4)
 
-static const CRYConfig config_Polling=
-{
-		TRANSFER_POLLING,
-		0
-};
 
-static const CRYConfig config_DMA=
-{
-		TRANSFER_DMA,
-		0
-};
 
 
 static const int hmackeys_size[]=
@@ -87,11 +77,9 @@ static void cryHMAC256(CRYDriver *cryp) {
     uint8_t *keyp;
 
 
-    hmacshactxp.shacontext.sha.sha_buffer = (uint8_t*)&shabuffer[0];
-    hmacshactxp.shacontext.sha.sha_buffer_size = MAX_SHA_BLOCK_SIZE;
 
     keyp =(uint8_t *)hmackey_1;
-    ret = cryLoadTransientKey(&CRYD1, (cryalgorithm_t) cry_algo_hmac,hmackeys_size[0], keyp);
+    ret = cryLoadHMACTransientKey(&CRYD1, hmackeys_size[0], keyp);
 
     test_assert(ret == CRY_NOERROR, "failed load transient key");
 
@@ -119,11 +107,9 @@ static void cryHMAC512(CRYDriver *cryp) {
     uint8_t *keyp;
 
 
-    hmacshactxp.shacontext.sha.sha_buffer = (uint8_t*)&shabuffer[0];
-    hmacshactxp.shacontext.sha.sha_buffer_size = MAX_SHA_BLOCK_SIZE;
 
     keyp =(uint8_t *)hmackey_1;
-    ret = cryLoadTransientKey(&CRYD1, (cryalgorithm_t) cry_algo_hmac,hmackeys_size[0], keyp);
+    ret = cryLoadHMACTransientKey(&CRYD1, hmackeys_size[0], keyp);
 
     test_assert(ret == CRY_NOERROR, "failed load transient key");
 
@@ -164,7 +150,7 @@ static void cryHMAC512(CRYDriver *cryp) {
 
 static void cry_test_009_001_setup(void) {
   memset(HMACOUT, 0xff, TEST_MSG_DATA_BYTE_LEN);
-  cryStart(&CRYD1, &config_Polling);
+  cryStart(&CRYD1, CRY_TEST_CONFIG_POLLING);
 
 
 }
@@ -219,7 +205,7 @@ static const testcase_t cry_test_009_001 = {
 
 static void cry_test_009_002_setup(void) {
   memset(HMACOUT, 0xff, TEST_MSG_DATA_BYTE_LEN);
-  cryStart(&CRYD1, &config_DMA);
+  cryStart(&CRYD1, CRY_TEST_CONFIG_DMA);
 
 
 }
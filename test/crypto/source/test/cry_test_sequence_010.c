@@ -0,0 +1,194 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "cry_test_root.h"
+
+/**
+ * @file    cry_test_sequence_010.c
+ * @brief   Test Sequence 010 code.
+ *
+ * @page cry_test_sequence_010 [10] Crypto requests queue
+ *
+ * File: @ref cry_test_sequence_010.c
+ *
+ * <h2>Description</h2>
+ * Crypto requests queue testing.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CRY_TEST_USE_QUEUE == TRUE
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage cry_test_010_001
+ * .
+ */
+
+#if (CRY_TEST_USE_QUEUE == TRUE) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include <string.h>
+#include "hal_crypto_queue.h"
+#include "ref_aes.h"
+
+static CRYQueueDriver cryq;
+static const CRYQueueConfig cryqcfg = {&CRYD1, 0U};
+static THD_WORKING_AREA(wa_dispatcher, 512);
+static thread_t *tp_dispatcher;
+static cryrequest_t req;
+static unsigned ncallbacks;
+static cryerror_t cb_results[2];
+static cryqreqstate_t cb_states[2];
+
+static THD_FUNCTION(dispatcher, arg) {
+
+  (void)arg;
+
+  cryqDispatch(&cryq);
+}
+
+/* The first completion fixes the key size and resubmits the request from
+   within the callback. The dispatcher has a lower priority than the test
+   thread so the request always completes while the test thread is waiting
+   for it.*/
+static void resubmit_cb(CRYQueueDriver *cqp, cryrequest_t *reqp) {
+
+  if (ncallbacks < 2U) {
+    cb_results[ncallbacks] = cryqGetResultX(reqp);
+    cb_states[ncallbacks]  = reqp->state;
+  }
+  ncallbacks++;
+  if (ncallbacks == 1U) {
+    cryqSetKeyX(reqp, 0, 16U, (const uint8_t *)test_keys);
+    cryqSubmitI(cqp, reqp);
+  }
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page cry_test_010_001 [10.1] Resubmission from callback
+ *
+ * <h2>Description</h2>
+ * An AES CBC request with an invalid key size is submitted, the
+ * callback corrects the key size and resubmits it. The waiting thread
+ * must receive the result of the first execution, the second execution
+ * must produce the reference output.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.1.1] Submitting a request with an invalid key size, the
+ *   callback resubmits it, the first result is expected.
+ * - [10.1.2] Waiting for the resubmitted request, the reference output
+ *   is expected.
+ * .
+ */
+
+static void cry_test_010_001_setup(void) {
+  memcpy((char*) msg_clear, test_plain_data, TEST_DATA_BYTE_LEN);
+  memset(msg_encrypted, 0xff, TEST_MSG_DATA_BYTE_LEN);
+  ncallbacks = 0U;
+  cryStart(&CRYD1, CRY_TEST_CONFIG_POLLING);
+  cryqObjectInit(&cryq);
+  cryqStart(&cryq, &cryqcfg);
+  tp_dispatcher = chThdCreateStatic(wa_dispatcher, sizeof (wa_dispatcher),
+                                    chThdGetPriorityX() - 1, dispatcher, NULL);
+}
+
+static void cry_test_010_001_teardown(void) {
+  cryqStop(&cryq);
+  (void) chThdWait(tp_dispatcher);
+  cryStop(&CRYD1);
+}
+
+static void cry_test_010_001_execute(void) {
+  cryerror_t ret;
+
+  /* [10.1.1] Submitting a request with an invalid key size, the
+     callback resubmits it, the first result is expected.*/
+  test_set_step(1);
+  {
+    cryqRequestObjectInit(&req, CRYQ_ENCRYPT_AES_CBC, resubmit_cb, NULL);
+    cryqSetKeyX(&req, 0, 15U, (const uint8_t *)test_keys);
+    cryqSetDataX(&req, TEST_DATA_BYTE_LEN, (const uint8_t *)msg_clear,
+                 (uint8_t *)msg_encrypted, (const uint8_t *)test_vectors);
+
+    ret = cryqExecute(&cryq, &req);
+
+    test_assert(ncallbacks == 1U, "wrong number of callbacks");
+    test_assert(cb_states[0] == CRYQ_REQ_DONE, "not completed before callback");
+    test_assert(ret != CRY_NOERROR, "invalid key size accepted");
+    test_assert(ret == cb_results[0], "wrong result");
+    test_assert(req.state == CRYQ_REQ_QUEUED, "not resubmitted");
+  }
+  test_end_step(1);
+
+  /* [10.1.2] Waiting for the resubmitted request, the reference output
+     is expected.*/
+  test_set_step(2);
+  {
+    ret = cryqWait(&req);
+
+    test_assert(ret == CRY_NOERROR, "encrypt failed");
+    test_assert(ncallbacks == 2U, "wrong number of callbacks");
+    test_assert(cb_states[1] == CRYQ_REQ_DONE, "not completed before callback");
+    test_assert(cb_results[1] == CRY_NOERROR, "wrong result");
+    test_assert(req.state == CRYQ_REQ_DONE, "not completed");
+    test_assert(cryq.completed == 2U, "wrong number of completions");
+
+    SHOW_ENCRYPDATA(TEST_DATA_WORD_LEN);
+
+    for (int i = 0; i < TEST_DATA_WORD_LEN; i++) {
+      test_assert(msg_encrypted[i] == ((uint32_t*) refAES_CBC_128)[i], "encrypt mismatch");
+    }
+  }
+  test_end_step(2);
+}
+
+static const testcase_t cry_test_010_001 = {
+  "Resubmission from callback",
+  cry_test_010_001_setup,
+  cry_test_010_001_teardown,
+  cry_test_010_001_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const cry_test_sequence_010_array[] = {
+  &cry_test_010_001,
+  NULL
+};
+
+/**
+ * @brief   Crypto requests queue.
+ */
+const testsequence_t cry_test_sequence_010 = {
+  "Crypto requests queue",
+  cry_test_sequence_010_array
+};
+
+#endif /* CRY_TEST_USE_QUEUE == TRUE */
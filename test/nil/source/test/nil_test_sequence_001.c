@@ -168,6 +168,9 @@ static void nil_test_001_003_execute(void) {
     test_print("--- CH_CFG_AUTOSTART_THREADS:           ");
     test_printn(CH_CFG_AUTOSTART_THREADS);
     test_println("");
+    test_print("--- CH_CFG_USE_FAST_SCHEDULER:          ");
+    test_printn(CH_CFG_USE_FAST_SCHEDULER);
+    test_println("");
     test_print("--- CH_CFG_ST_RESOLUTION:               ");
     test_printn(CH_CFG_ST_RESOLUTION);
     test_println("");
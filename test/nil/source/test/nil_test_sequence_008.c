@@ -41,6 +41,7 @@
  * - @subpage nil_test_008_005
  * - @subpage nil_test_008_006
  * - @subpage nil_test_008_007
+ * - @subpage nil_test_008_008
  * .
  */
 
@@ -104,6 +105,17 @@ static THD_FUNCTION(bmk_thread4, p) {
   chSysUnlock();
 }
 
+#if CH_CFG_USE_SEMAPHORES
+static THD_FUNCTION(bmk_thread5, p) {
+  msg_t msg;
+
+  (void)p;
+  do {
+    msg = chSemWaitTimeout(&sem1, TIME_MS2I(1000));
+  } while (msg == MSG_OK);
+}
+#endif
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -169,6 +181,8 @@ static void nil_test_008_001_execute(void) {
     test_print(" msgs/S, ");
     test_printn(n << 1);
     test_println(" ctxswc/S");
+    test_score(n, "msgs/S");
+    test_score(n << 1, "ctxswc/S");
   }
   test_end_step(3);
 }
@@ -242,6 +256,8 @@ static void nil_test_008_002_execute(void) {
     test_print(" msgs/S, ");
     test_printn(n << 1);
     test_println(" ctxswc/S");
+    test_score(n, "msgs/S");
+    test_score(n << 1, "ctxswc/S");
   }
   test_end_step(3);
 }
@@ -329,6 +345,7 @@ static void nil_test_008_003_execute(void) {
     test_print("--- Score : ");
     test_printn(n * 2);
     test_println(" ctxswc/S");
+    test_score(n * 2, "ctxswc/S");
   }
   test_end_step(4);
 }
@@ -392,6 +409,7 @@ static void nil_test_008_004_execute(void) {
     test_print("--- Score : ");
     test_printn(n);
     test_println(" threads/S");
+    test_score(n, "threads/S");
   }
   test_end_step(2);
 }
@@ -456,6 +474,7 @@ static void nil_test_008_005_execute(void) {
     test_print("--- Score : ");
     test_printn(n);
     test_println(" threads/S");
+    test_score(n, "threads/S");
   }
   test_end_step(2);
 }
@@ -529,6 +548,7 @@ static void nil_test_008_006_execute(void) {
     test_print("--- Score : ");
     test_printn(n * 4);
     test_println(" wait+signal/S");
+    test_score(n * 4, "wait+signal/S");
   }
   test_end_step(2);
 }
@@ -541,25 +561,123 @@ static const testcase_t nil_test_008_006 = {
 };
 #endif /* CH_CFG_USE_SEMAPHORES == TRUE */
 
+#if (CH_CFG_USE_SEMAPHORES == TRUE) || defined(__DOXYGEN__)
 /**
- * @page nil_test_008_007 [8.7] RAM Footprint
+ * @page nil_test_008_007 [8.7] Semaphores wait/signal performance with timeout
  *
  * <h2>Description</h2>
- * The memory size of the various kernel objects is printed.
+ * A thread is created that waits on a semaphore with a timeout into a
+ * loop, the semaphore is signaled as fast as possible by the tester
+ * thread. Each cycle arms and disarms the timeout of the
+ * thread.<br> The performance is calculated by measuring the number
+ * of iterations after a second of continuous operations.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_SEMAPHORES == TRUE
+ * .
  *
  * <h2>Test Steps</h2>
- * - [8.7.1] The size of the system area is printed.
- * - [8.7.2] The size of a thread structure is printed.
- * - [8.7.3] The size of a semaphore structure is printed.
- * - [8.7.4] The size of an event source is printed.
- * - [8.7.5] The size of an event listener is printed.
- * - [8.7.6] The size of a mailbox is printed.
+ * - [8.7.1] Starting the target thread at an higher priority level.
+ * - [8.7.2] Signaling the semaphore as fast as possible in a one
+ *   second time window.
+ * - [8.7.3] Stopping the target thread.
+ * - [8.7.4] The score is printed.
  * .
  */
 
+static void nil_test_008_007_setup(void) {
+  chSemObjectInit(&sem1, 0);
+}
+
 static void nil_test_008_007_execute(void) {
+  thread_t *tp;
+  uint32_t n;
+
+  /* [8.7.1] Starting the target thread at an higher priority level.*/
+  test_set_step(1);
+  {
+    thread_descriptor_t td = {
+      .name  = "waiter",
+      .wbase = wa_common,
+      .wend  = THD_WORKING_AREA_END(wa_common),
+      .prio  = chThdGetPriorityX() - 1,
+      .funcp = bmk_thread5,
+      .arg   = NULL
+    };
+    tp = chThdCreate(&td);
+  }
+  test_end_step(1);
+
+  /* [8.7.2] Signaling the semaphore as fast as possible in a one
+     second time window.*/
+  test_set_step(2);
+  {
+    systime_t start, end;
+
+    n = 0;
+    start = test_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      chSemSignal(&sem1);
+      chSemSignal(&sem1);
+      chSemSignal(&sem1);
+      chSemSignal(&sem1);
+      n += 4;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+  }
+  test_end_step(2);
 
-  /* [8.7.1] The size of the system area is printed.*/
+  /* [8.7.3] Stopping the target thread.*/
+  test_set_step(3);
+  {
+    chSemReset(&sem1, 0);
+    chThdWait(tp);
+  }
+  test_end_step(3);
+
+  /* [8.7.4] The score is printed.*/
+  test_set_step(4);
+  {
+    test_print("--- Score : ");
+    test_printn(n);
+    test_println(" wait+signal/S");
+    test_score(n, "wait+signal/S");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t nil_test_008_007 = {
+  "Semaphores wait/signal performance with timeout",
+  nil_test_008_007_setup,
+  NULL,
+  nil_test_008_007_execute
+};
+#endif /* CH_CFG_USE_SEMAPHORES == TRUE */
+
+/**
+ * @page nil_test_008_008 [8.8] RAM Footprint
+ *
+ * <h2>Description</h2>
+ * The memory size of the various kernel objects is printed.
+ *
+ * <h2>Test Steps</h2>
+ * - [8.8.1] The size of the system area is printed.
+ * - [8.8.2] The size of a thread structure is printed.
+ * - [8.8.3] The size of a semaphore structure is printed.
+ * - [8.8.4] The size of an event source is printed.
+ * - [8.8.5] The size of an event listener is printed.
+ * - [8.8.6] The size of a mailbox is printed.
+ * .
+ */
+
+static void nil_test_008_008_execute(void) {
+
+  /* [8.8.1] The size of the system area is printed.*/
   test_set_step(1);
   {
     test_print("--- OS    : ");
@@ -568,7 +686,7 @@ static void nil_test_008_007_execute(void) {
   }
   test_end_step(1);
 
-  /* [8.7.2] The size of a thread structure is printed.*/
+  /* [8.8.2] The size of a thread structure is printed.*/
   test_set_step(2);
   {
     test_print("--- Thread: ");
@@ -577,7 +695,7 @@ static void nil_test_008_007_execute(void) {
   }
   test_end_step(2);
 
-  /* [8.7.3] The size of a semaphore structure is printed.*/
+  /* [8.8.3] The size of a semaphore structure is printed.*/
   test_set_step(3);
   {
 #if CH_CFG_USE_SEMAPHORES || defined(__DOXYGEN__)
@@ -588,7 +706,7 @@ static void nil_test_008_007_execute(void) {
   }
   test_end_step(3);
 
-  /* [8.7.4] The size of an event source is printed.*/
+  /* [8.8.4] The size of an event source is printed.*/
   test_set_step(4);
   {
 #if CH_CFG_USE_EVENTS || defined(__DOXYGEN__)
@@ -599,7 +717,7 @@ static void nil_test_008_007_execute(void) {
   }
   test_end_step(4);
 
-  /* [8.7.5] The size of an event listener is printed.*/
+  /* [8.8.5] The size of an event listener is printed.*/
   test_set_step(5);
   {
 #if CH_CFG_USE_EVENTS || defined(__DOXYGEN__)
@@ -610,7 +728,7 @@ static void nil_test_008_007_execute(void) {
   }
   test_end_step(5);
 
-  /* [8.7.6] The size of a mailbox is printed.*/
+  /* [8.8.6] The size of a mailbox is printed.*/
   test_set_step(6);
   {
 #if CH_CFG_USE_MAILBOXES || defined(__DOXYGEN__)
@@ -622,11 +740,11 @@ static void nil_test_008_007_execute(void) {
   test_end_step(6);
 }
 
-static const testcase_t nil_test_008_007 = {
+static const testcase_t nil_test_008_008 = {
   "RAM Footprint",
   NULL,
   NULL,
-  nil_test_008_007_execute
+  nil_test_008_008_execute
 };
 
 /****************************************************************************
@@ -649,7 +767,10 @@ const testcase_t * const nil_test_sequence_008_array[] = {
 #if (CH_CFG_USE_SEMAPHORES == TRUE) || defined(__DOXYGEN__)
   &nil_test_008_006,
 #endif
+#if (CH_CFG_USE_SEMAPHORES == TRUE) || defined(__DOXYGEN__)
   &nil_test_008_007,
+#endif
+  &nil_test_008_008,
   NULL
 };
 
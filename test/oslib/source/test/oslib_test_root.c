@@ -30,6 +30,8 @@
  * - @subpage oslib_test_sequence_007
  * - @subpage oslib_test_sequence_008
  * - @subpage oslib_test_sequence_009
+ * - @subpage oslib_test_sequence_010
+ * - @subpage oslib_test_sequence_011
  * .
  */
 
@@ -76,6 +78,10 @@ const testsequence_t * const oslib_test_suite_array[] = {
 #if ((CH_CFG_USE_FACTORY == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE) && (CH_CFG_USE_HEAP == TRUE)) || defined(__DOXYGEN__)
   &oslib_test_sequence_009,
 #endif
+#if (CH_CFG_USE_RINGS == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_sequence_010,
+#endif
+  &oslib_test_sequence_011,
   NULL
 };
 
@@ -38,6 +38,7 @@
  * <h2>Test Cases</h2>
  * - @subpage oslib_test_008_001
  * - @subpage oslib_test_008_002
+ * - @subpage oslib_test_008_003
  * .
  */
 
@@ -296,6 +297,133 @@ static const testcase_t oslib_test_008_002 = {
   oslib_test_008_002_execute
 };
 
+/**
+ * @page oslib_test_008_003 [8.3] Reallocation
+ *
+ * <h2>Description</h2>
+ * Blocks are resized using chHeapRealloc(), the test verifies that
+ * blocks are resized in place when the following space is free, moved
+ * when it is not and left unchanged on failure. The test expects to
+ * find the heap back to the initial status at the end.
+ *
+ * <h2>Test Steps</h2>
+ * - [8.3.1] Testing initial conditions, the heap must not be
+ *   fragmented and one free block present, finally, integrity is
+ *   checked.
+ * - [8.3.2] Growing a block followed by free space, the block must not
+ *   be moved, finally, integrity is checked.
+ * - [8.3.3] Shrinking the block, the block must not be moved and the
+ *   excess space must be merged with the following free block,
+ *   finally, integrity is checked.
+ * - [8.3.4] Growing a block followed by an allocated block, the block
+ *   must be moved and its content preserved, finally, integrity is
+ *   checked.
+ * - [8.3.5] Trying to grow a block beyond the available space, an
+ *   error is expected and the block must be left unchanged, finally,
+ *   integrity is checked.
+ * - [8.3.6] Testing final conditions. The heap geometry must be the
+ *   same than the one registered at beginning, finally, integrity is
+ *   checked.
+ * .
+ */
+
+static void oslib_test_008_003_setup(void) {
+  chHeapObjectInit(&test_heap, test_heap_buffer, sizeof(test_heap_buffer));
+}
+
+static void oslib_test_008_003_execute(void) {
+  void *p1, *p2, *p3;
+  size_t n, sz;
+
+  /* [8.3.1] Testing initial conditions, the heap must not be
+     fragmented and one free block present, finally, integrity is
+     checked.*/
+  test_set_step(1);
+  {
+    test_assert(chHeapStatus(&test_heap, &sz, NULL) == 1, "heap fragmented");
+    test_assert(!chHeapIntegrityCheck(&test_heap), "integrity failure");
+  }
+  test_end_step(1);
+
+  /* [8.3.2] Growing a block followed by free space, the block must not
+     be moved, finally, integrity is checked.*/
+  test_set_step(2);
+  {
+    p1 = chHeapAlloc(&test_heap, ALLOC_SIZE);
+    test_assert(p1 != NULL, "allocation failed");
+    *(uint8_t *)p1 = 0x55U;
+    p2 = chHeapRealloc(p1, ALLOC_SIZE * 2);
+    test_assert(p2 == p1, "block moved");
+    test_assert(chHeapGetSize(p1) == ALLOC_SIZE * 2, "wrong size");
+    test_assert(chHeapStatus(&test_heap, NULL, NULL) == 1, "heap fragmented");
+    test_assert(!chHeapIntegrityCheck(&test_heap), "integrity failure");
+  }
+  test_end_step(2);
+
+  /* [8.3.3] Shrinking the block, the block must not be moved and the
+     excess space must be merged with the following free block,
+     finally, integrity is checked.*/
+  test_set_step(3);
+  {
+    p2 = chHeapRealloc(p1, ALLOC_SIZE);
+    test_assert(p2 == p1, "block moved");
+    test_assert(chHeapGetSize(p1) == ALLOC_SIZE, "wrong size");
+    test_assert(chHeapStatus(&test_heap, NULL, NULL) == 1, "heap fragmented");
+    test_assert(!chHeapIntegrityCheck(&test_heap), "integrity failure");
+  }
+  test_end_step(3);
+
+  /* [8.3.4] Growing a block followed by an allocated block, the block
+     must be moved and its content preserved, finally, integrity is
+     checked.*/
+  test_set_step(4);
+  {
+    p2 = chHeapAlloc(&test_heap, ALLOC_SIZE);
+    test_assert(p2 != NULL, "allocation failed");
+    p3 = chHeapRealloc(p1, ALLOC_SIZE * 2);
+    test_assert(p3 != NULL, "reallocation failed");
+    test_assert(p3 != p1, "block not moved");
+    test_assert(*(uint8_t *)p3 == 0x55U, "content not preserved");
+    test_assert(chHeapGetSize(p3) == ALLOC_SIZE * 2, "wrong size");
+    test_assert(!chHeapIntegrityCheck(&test_heap), "integrity failure");
+    p1 = p3;
+  }
+  test_end_step(4);
+
+  /* [8.3.5] Trying to grow a block beyond the available space, an
+     error is expected and the block must be left unchanged, finally,
+     integrity is checked.*/
+  test_set_step(5);
+  {
+    p3 = chHeapRealloc(p1, sizeof test_heap_buffer * 2);
+    test_assert(p3 == NULL, "reallocation not failed");
+    test_assert(*(uint8_t *)p1 == 0x55U, "content changed");
+    test_assert(chHeapGetSize(p1) == ALLOC_SIZE * 2, "size changed");
+    test_assert(!chHeapIntegrityCheck(&test_heap), "integrity failure");
+  }
+  test_end_step(5);
+
+  /* [8.3.6] Testing final conditions. The heap geometry must be the
+     same than the one registered at beginning, finally, integrity is
+     checked.*/
+  test_set_step(6);
+  {
+    chHeapFree(p1);
+    chHeapFree(p2);
+    test_assert(chHeapStatus(&test_heap, &n, NULL) == 1, "heap fragmented");
+    test_assert(n == sz, "size changed");
+    test_assert(!chHeapIntegrityCheck(&test_heap), "integrity failure");
+  }
+  test_end_step(6);
+}
+
+static const testcase_t oslib_test_008_003 = {
+  "Reallocation",
+  oslib_test_008_003_setup,
+  NULL,
+  oslib_test_008_003_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -306,6 +434,7 @@ static const testcase_t oslib_test_008_002 = {
 const testcase_t * const oslib_test_sequence_008_array[] = {
   &oslib_test_008_001,
   &oslib_test_008_002,
+  &oslib_test_008_003,
   NULL
 };
 
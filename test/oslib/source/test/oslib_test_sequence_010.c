@@ -0,0 +1,646 @@
+/*
+    ChibiOS - Copyright (C) 2006..2017 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "oslib_test_root.h"
+
+/**
+ * @file    oslib_test_sequence_010.c
+ * @brief   Test Sequence 010 code.
+ *
+ * @page oslib_test_sequence_010 [10] Lock-free Rings
+ *
+ * File: @ref oslib_test_sequence_010.c
+ *
+ * <h2>Description</h2>
+ * This sequence tests the ChibiOS library functionalities related to
+ * lock-free rings.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_RINGS == TRUE
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage oslib_test_010_001
+ * - @subpage oslib_test_010_002
+ * - @subpage oslib_test_010_003
+ * - @subpage oslib_test_010_004
+ * - @subpage oslib_test_010_005
+ * .
+ */
+
+#if (CH_CFG_USE_RINGS == TRUE) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#define RING_SIZE 4
+
+static msg_t ring_buffer[RING_SIZE];
+static ring_slot_t ring_slots[RING_SIZE];
+static spsc_ring_t spsc1;
+static mpsc_ring_t mpsc1;
+
+#if defined(__CHIBIOS_RT__) && (CH_CFG_USE_SEMAPHORES == TRUE)
+static ring_queue_t rq1;
+
+static THD_WORKING_AREA(waThread1, 256);
+static THD_FUNCTION(Thread1, arg) {
+
+  (void)arg;
+
+  chThdSleepMilliseconds(50);
+  (void)chRingQueuePostX(&rq1, 'A');
+  (void)chRingQueuePostX(&rq1, 'B');
+  chThdSleepMilliseconds(50);
+  (void)chRingQueuePostX(&rq1, 'C');
+}
+#endif
+
+#if CH_CFG_USE_OBJ_FIFOS == TRUE
+static msg_t fifo_msgs[RING_SIZE];
+static uintptr_t fifo_objs[RING_SIZE];
+static objects_fifo_t fifo1;
+
+static systime_t ring_wait_tick(void) {
+
+  chThdSleep((sysinterval_t)1);
+  return chVTGetSystemTimeX();
+}
+#endif
+
+#if defined(__CHIBIOS_RT__) && (CH_CFG_USE_SEMAPHORES == TRUE) &&           \
+    (CH_CFG_USE_OBJ_FIFOS == TRUE) && (PORT_SUPPORTS_RT == TRUE) &&         \
+    !defined(PORT_SIM_VIRTUAL_CLOCK)
+#define LATENCY_SAMPLES 64
+
+static rtcnt_t latency_start;
+static rtcnt_t latency_samples[LATENCY_SAMPLES];
+
+static THD_FUNCTION(rq_consumer, arg) {
+  msg_t msg;
+  unsigned i;
+
+  (void)arg;
+
+  for (i = 0; i < LATENCY_SAMPLES; i++) {
+    (void)chRingQueueFetchTimeout(&rq1, &msg, TIME_INFINITE);
+    latency_samples[i] = chSysGetRealtimeCounterX() - latency_start;
+  }
+}
+
+static THD_FUNCTION(fifo_consumer, arg) {
+  void *objp;
+  unsigned i;
+
+  (void)arg;
+
+  for (i = 0; i < LATENCY_SAMPLES; i++) {
+    (void)chFifoReceiveObjectTimeout(&fifo1, &objp, TIME_INFINITE);
+    latency_samples[i] = chSysGetRealtimeCounterX() - latency_start;
+    chFifoReturnObject(&fifo1, objp);
+  }
+}
+
+/* Sorts the samples and prints min, median and max, the unit is the port
+   realtime counter tick.*/
+static void latency_print(const char *name) {
+  unsigned i, j;
+
+  for (i = 1; i < LATENCY_SAMPLES; i++) {
+    rtcnt_t t = latency_samples[i];
+
+    for (j = i; (j > 0U) && (latency_samples[j - 1U] > t); j--) {
+      latency_samples[j] = latency_samples[j - 1U];
+    }
+    latency_samples[j] = t;
+  }
+  test_print("--- ");
+  test_print(name);
+  test_print(": ");
+  test_printn((uint32_t)latency_samples[0]);
+  test_print("/");
+  test_printn((uint32_t)latency_samples[LATENCY_SAMPLES / 2]);
+  test_print("/");
+  test_printn((uint32_t)latency_samples[LATENCY_SAMPLES - 1]);
+  test_println(" ticks (min/med/max)");
+}
+#endif
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page oslib_test_010_001 [10.1] SPSC ring normal API
+ *
+ * <h2>Description</h2>
+ * The SPSC ring API is tested by filling, overflowing and draining the
+ * ring, the messages order is checked.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.1.1] Initializing the ring, it must be empty.
+ * - [10.1.2] Filling the ring.
+ * - [10.1.3] Putting a message in a full ring, must fail.
+ * - [10.1.4] Draining the ring, the messages must be retrieved in
+ *   order.
+ * - [10.1.5] Getting a message from an empty ring, must fail.
+ * - [10.1.6] Putting and getting across the wrap-around point.
+ * .
+ */
+
+static void oslib_test_010_001_execute(void) {
+  msg_t msg1, msg2 = 0;
+  unsigned i;
+
+  /* [10.1.1] Initializing the ring, it must be empty.*/
+  test_set_step(1);
+  {
+    chSpscRingObjectInit(&spsc1, ring_buffer, RING_SIZE);
+    test_assert(chSpscRingGetUsedCountX(&spsc1) == 0U, "not empty");
+  }
+  test_end_step(1);
+
+  /* [10.1.2] Filling the ring.*/
+  test_set_step(2);
+  {
+    for (i = 0; i < RING_SIZE; i++) {
+      msg1 = chSpscRingPutX(&spsc1, 'A' + i);
+      test_assert(msg1 == MSG_OK, "wrong wake-up message");
+    }
+    test_assert(chSpscRingGetUsedCountX(&spsc1) == RING_SIZE, "not full");
+  }
+  test_end_step(2);
+
+  /* [10.1.3] Putting a message in a full ring, must fail.*/
+  test_set_step(3);
+  {
+    msg1 = chSpscRingPutX(&spsc1, 'X');
+    test_assert(msg1 == MSG_TIMEOUT, "wrong wake-up message");
+  }
+  test_end_step(3);
+
+  /* [10.1.4] Draining the ring, the messages must be retrieved in
+     order.*/
+  test_set_step(4);
+  {
+    for (i = 0; i < RING_SIZE; i++) {
+      msg1 = chSpscRingGetX(&spsc1, &msg2);
+      test_assert(msg1 == MSG_OK, "wrong wake-up message");
+      test_emit_token(msg2);
+    }
+    test_assert_sequence("ABCD", "wrong get sequence");
+  }
+  test_end_step(4);
+
+  /* [10.1.5] Getting a message from an empty ring, must fail.*/
+  test_set_step(5);
+  {
+    msg1 = chSpscRingGetX(&spsc1, &msg2);
+    test_assert(msg1 == MSG_TIMEOUT, "wrong wake-up message");
+    test_assert(chSpscRingGetUsedCountX(&spsc1) == 0U, "not empty");
+  }
+  test_end_step(5);
+
+  /* [10.1.6] Putting and getting across the wrap-around point.*/
+  test_set_step(6);
+  {
+    for (i = 0; i < RING_SIZE * 2; i++) {
+      msg1 = chSpscRingPutX(&spsc1, 'A' + i);
+      test_assert(msg1 == MSG_OK, "wrong wake-up message");
+      msg1 = chSpscRingGetX(&spsc1, &msg2);
+      test_assert(msg1 == MSG_OK, "wrong wake-up message");
+      test_emit_token(msg2);
+    }
+    test_assert_sequence("ABCDEFGH", "wrong get sequence");
+  }
+  test_end_step(6);
+}
+
+static const testcase_t oslib_test_010_001 = {
+  "SPSC ring normal API",
+  NULL,
+  NULL,
+  oslib_test_010_001_execute
+};
+
+/**
+ * @page oslib_test_010_002 [10.2] MPSC ring normal API
+ *
+ * <h2>Description</h2>
+ * The MPSC ring API is tested by filling, overflowing and draining the
+ * ring, the messages order is checked.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.2.1] Initializing the ring.
+ * - [10.2.2] Filling the ring.
+ * - [10.2.3] Putting a message in a full ring, must fail.
+ * - [10.2.4] Draining the ring, the messages must be retrieved in
+ *   order.
+ * - [10.2.5] Getting a message from an empty ring, must fail.
+ * - [10.2.6] Putting and getting across the wrap-around point.
+ * .
+ */
+
+static void oslib_test_010_002_execute(void) {
+  msg_t msg1, msg2 = 0;
+  unsigned i;
+
+  /* [10.2.1] Initializing the ring.*/
+  test_set_step(1);
+  {
+    chMpscRingObjectInit(&mpsc1, ring_slots, RING_SIZE);
+  }
+  test_end_step(1);
+
+  /* [10.2.2] Filling the ring.*/
+  test_set_step(2);
+  {
+    for (i = 0; i < RING_SIZE; i++) {
+      msg1 = chMpscRingPutX(&mpsc1, 'A' + i);
+      test_assert(msg1 == MSG_OK, "wrong wake-up message");
+    }
+  }
+  test_end_step(2);
+
+  /* [10.2.3] Putting a message in a full ring, must fail.*/
+  test_set_step(3);
+  {
+    msg1 = chMpscRingPutX(&mpsc1, 'X');
+    test_assert(msg1 == MSG_TIMEOUT, "wrong wake-up message");
+  }
+  test_end_step(3);
+
+  /* [10.2.4] Draining the ring, the messages must be retrieved in
+     order.*/
+  test_set_step(4);
+  {
+    for (i = 0; i < RING_SIZE; i++) {
+      msg1 = chMpscRingGetX(&mpsc1, &msg2);
+      test_assert(msg1 == MSG_OK, "wrong wake-up message");
+      test_emit_token(msg2);
+    }
+    test_assert_sequence("ABCD", "wrong get sequence");
+  }
+  test_end_step(4);
+
+  /* [10.2.5] Getting a message from an empty ring, must fail.*/
+  test_set_step(5);
+  {
+    msg1 = chMpscRingGetX(&mpsc1, &msg2);
+    test_assert(msg1 == MSG_TIMEOUT, "wrong wake-up message");
+  }
+  test_end_step(5);
+
+  /* [10.2.6] Putting and getting across the wrap-around point.*/
+  test_set_step(6);
+  {
+    for (i = 0; i < RING_SIZE * 2; i++) {
+      msg1 = chMpscRingPutX(&mpsc1, 'A' + i);
+      test_assert(msg1 == MSG_OK, "wrong wake-up message");
+      msg1 = chMpscRingGetX(&mpsc1, &msg2);
+      test_assert(msg1 == MSG_OK, "wrong wake-up message");
+      test_emit_token(msg2);
+    }
+    test_assert_sequence("ABCDEFGH", "wrong get sequence");
+  }
+  test_end_step(6);
+}
+
+static const testcase_t oslib_test_010_002 = {
+  "MPSC ring normal API",
+  NULL,
+  NULL,
+  oslib_test_010_002_execute
+};
+
+#if (defined(__CHIBIOS_RT__) && (CH_CFG_USE_SEMAPHORES == TRUE)) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_010_003 [10.3] Ring queue blocking fetch
+ *
+ * <h2>Description</h2>
+ * The ring queue fetch operation is tested with immediate and finite
+ * timeouts then a producer thread is started and the messages are
+ * fetched while the consumer is waiting.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - defined(__CHIBIOS_RT__) && (CH_CFG_USE_SEMAPHORES == TRUE)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [10.3.1] Fetching from an empty queue with immediate timeout, must
+ *   fail.
+ * - [10.3.2] Fetching from an empty queue with a finite timeout, must
+ *   fail.
+ * - [10.3.3] Posting and fetching without waiting.
+ * - [10.3.4] Starting the producer thread, messages are fetched while
+ *   the producer posts them, the order is checked.
+ * .
+ */
+
+static void oslib_test_010_003_setup(void) {
+  chRingQueueObjectInit(&rq1, ring_slots, RING_SIZE);
+}
+
+static void oslib_test_010_003_execute(void) {
+  msg_t msg1, msg2 = 0;
+  thread_t *tp;
+  unsigned i;
+
+  /* [10.3.1] Fetching from an empty queue with immediate timeout, must
+     fail.*/
+  test_set_step(1);
+  {
+    msg1 = chRingQueueFetchTimeout(&rq1, &msg2, TIME_IMMEDIATE);
+    test_assert(msg1 == MSG_TIMEOUT, "wrong wake-up message");
+  }
+  test_end_step(1);
+
+  /* [10.3.2] Fetching from an empty queue with a finite timeout, must
+     fail.*/
+  test_set_step(2);
+  {
+    msg1 = chRingQueueFetchTimeout(&rq1, &msg2, TIME_MS2I(10));
+    test_assert(msg1 == MSG_TIMEOUT, "wrong wake-up message");
+  }
+  test_end_step(2);
+
+  /* [10.3.3] Posting and fetching without waiting.*/
+  test_set_step(3);
+  {
+    msg1 = chRingQueuePostX(&rq1, 'Z');
+    test_assert(msg1 == MSG_OK, "wrong wake-up message");
+    msg1 = chRingQueueFetchTimeout(&rq1, &msg2, TIME_IMMEDIATE);
+    test_assert(msg1 == MSG_OK, "wrong wake-up message");
+    test_assert(msg2 == 'Z', "wrong message");
+  }
+  test_end_step(3);
+
+  /* [10.3.4] Starting the producer thread, messages are fetched while
+     the producer posts them, the order is checked.*/
+  test_set_step(4);
+  {
+    tp = chThdCreateStatic(waThread1, sizeof (waThread1),
+                           chThdGetPriorityX() - 1, Thread1, NULL);
+    for (i = 0; i < 3; i++) {
+      msg1 = chRingQueueFetchTimeout(&rq1, &msg2, TIME_MS2I(500));
+      test_assert(msg1 == MSG_OK, "wrong wake-up message");
+      test_emit_token(msg2);
+    }
+    (void)chThdWait(tp);
+    test_assert_sequence("ABC", "wrong get sequence");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t oslib_test_010_003 = {
+  "Ring queue blocking fetch",
+  oslib_test_010_003_setup,
+  NULL,
+  oslib_test_010_003_execute
+};
+#endif /* defined(__CHIBIOS_RT__) && (CH_CFG_USE_SEMAPHORES == TRUE) */
+
+#if (CH_CFG_USE_OBJ_FIFOS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_010_004 [10.4] Rings vs objects FIFOs performance
+ *
+ * <h2>Description</h2>
+ * The number of put/get pairs executed in a one second time window is
+ * measured for the SPSC ring, the MPSC ring and an objects FIFO, the
+ * results are printed on the output log.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_OBJ_FIFOS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [10.4.1] Measuring the SPSC ring.
+ * - [10.4.2] Measuring the MPSC ring.
+ * - [10.4.3] Measuring the objects FIFO.
+ * - [10.4.4] Scores are printed.
+ * .
+ */
+
+static void oslib_test_010_004_setup(void) {
+  chSpscRingObjectInit(&spsc1, ring_buffer, RING_SIZE);
+  chMpscRingObjectInit(&mpsc1, ring_slots, RING_SIZE);
+  chFifoObjectInit(&fifo1, sizeof (uintptr_t), RING_SIZE,
+                   fifo_objs, fifo_msgs);
+}
+
+static void oslib_test_010_004_execute(void) {
+  systime_t start, end;
+  uint32_t n1, n2, n3;
+  msg_t msg;
+
+  /* [10.4.1] Measuring the SPSC ring.*/
+  test_set_step(1);
+  {
+    n1 = 0;
+    start = ring_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      (void)chSpscRingPutX(&spsc1, (msg_t)n1);
+      (void)chSpscRingGetX(&spsc1, &msg);
+      n1++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+  }
+  test_end_step(1);
+
+  /* [10.4.2] Measuring the MPSC ring.*/
+  test_set_step(2);
+  {
+    n2 = 0;
+    start = ring_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      (void)chMpscRingPutX(&mpsc1, (msg_t)n2);
+      (void)chMpscRingGetX(&mpsc1, &msg);
+      n2++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+  }
+  test_end_step(2);
+
+  /* [10.4.3] Measuring the objects FIFO.*/
+  test_set_step(3);
+  {
+    n3 = 0;
+    start = ring_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      void *objp;
+
+      objp = chFifoTakeObjectTimeout(&fifo1, TIME_IMMEDIATE);
+      *(uint32_t *)objp = n3;
+      chFifoSendObject(&fifo1, objp);
+      (void)chFifoReceiveObjectTimeout(&fifo1, &objp, TIME_IMMEDIATE);
+      chFifoReturnObject(&fifo1, objp);
+      n3++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+  }
+  test_end_step(3);
+
+  /* [10.4.4] Scores are printed.*/
+  test_set_step(4);
+  {
+    test_print("--- SPSC  : ");
+    test_printn(n1);
+    test_println(" msgs/S");
+    test_print("--- MPSC  : ");
+    test_printn(n2);
+    test_println(" msgs/S");
+    test_print("--- FIFO  : ");
+    test_printn(n3);
+    test_println(" msgs/S");
+    test_score(n1, "SPSC msgs/S");
+    test_score(n2, "MPSC msgs/S");
+    test_score(n3, "FIFO msgs/S");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t oslib_test_010_004 = {
+  "Rings vs objects FIFOs performance",
+  oslib_test_010_004_setup,
+  NULL,
+  oslib_test_010_004_execute
+};
+#endif /* CH_CFG_USE_OBJ_FIFOS == TRUE */
+
+#if (defined(__CHIBIOS_RT__) && (CH_CFG_USE_SEMAPHORES == TRUE) && (CH_CFG_USE_OBJ_FIFOS == TRUE) && (PORT_SUPPORTS_RT == TRUE) && !defined(PORT_SIM_VIRTUAL_CLOCK)) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_010_005 [10.5] Ring queue vs objects FIFO wake-up latency
+ *
+ * <h2>Description</h2>
+ * The time between posting a message and the wake-up of a higher
+ * priority consumer thread is measured for a ring queue and for an
+ * objects FIFO, min, median and max are printed on the output log.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - defined(__CHIBIOS_RT__) && (CH_CFG_USE_SEMAPHORES == TRUE) && (CH_CFG_USE_OBJ_FIFOS == TRUE) && (PORT_SUPPORTS_RT == TRUE) && !defined(PORT_SIM_VIRTUAL_CLOCK)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [10.5.1] Measuring the ring queue, the message is posted then the
+ *   producer reschedules as an ISR epilogue would.
+ * - [10.5.2] Measuring the objects FIFO, the object is sent using the
+ *   normal API.
+ * .
+ */
+
+static void oslib_test_010_005_setup(void) {
+  chRingQueueObjectInit(&rq1, ring_slots, RING_SIZE);
+  chFifoObjectInit(&fifo1, sizeof (uintptr_t), RING_SIZE,
+                   fifo_objs, fifo_msgs);
+}
+
+static void oslib_test_010_005_execute(void) {
+  thread_t *tp;
+  void *objp;
+  unsigned i;
+
+  /* [10.5.1] Measuring the ring queue, the message is posted then the producer reschedules as an ISR epilogue would.*/
+  test_set_step(1);
+  {
+    tp = chThdCreateStatic(waThread1, sizeof (waThread1),
+                           chThdGetPriorityX() + 1, rq_consumer, NULL);
+    for (i = 0; i < LATENCY_SAMPLES; i++) {
+      latency_start = chSysGetRealtimeCounterX();
+      (void)chRingQueuePostX(&rq1, (msg_t)i);
+      chSysLock();
+      chSchRescheduleS();
+      chSysUnlock();
+    }
+    (void)chThdWait(tp);
+    latency_print("Ring  ");
+  }
+  test_end_step(1);
+
+  /* [10.5.2] Measuring the objects FIFO, the object is sent using the normal API.*/
+  test_set_step(2);
+  {
+    tp = chThdCreateStatic(waThread1, sizeof (waThread1),
+                           chThdGetPriorityX() + 1, fifo_consumer, NULL);
+    for (i = 0; i < LATENCY_SAMPLES; i++) {
+      objp = chFifoTakeObjectTimeout(&fifo1, TIME_IMMEDIATE);
+      test_assert(objp != NULL, "no object available");
+      latency_start = chSysGetRealtimeCounterX();
+      chFifoSendObject(&fifo1, objp);
+    }
+    (void)chThdWait(tp);
+    latency_print("FIFO  ");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t oslib_test_010_005 = {
+  "Ring queue vs objects FIFO wake-up latency",
+  oslib_test_010_005_setup,
+  NULL,
+  oslib_test_010_005_execute
+};
+#endif /* defined(__CHIBIOS_RT__) && (CH_CFG_USE_SEMAPHORES == TRUE) && (CH_CFG_USE_OBJ_FIFOS == TRUE) && (PORT_SUPPORTS_RT == TRUE) && !defined(PORT_SIM_VIRTUAL_CLOCK) */
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const oslib_test_sequence_010_array[] = {
+  &oslib_test_010_001,
+  &oslib_test_010_002,
+#if (defined(__CHIBIOS_RT__) && (CH_CFG_USE_SEMAPHORES == TRUE)) || defined(__DOXYGEN__)
+  &oslib_test_010_003,
+#endif
+#if (CH_CFG_USE_OBJ_FIFOS == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_010_004,
+#endif
+#if (defined(__CHIBIOS_RT__) && (CH_CFG_USE_SEMAPHORES == TRUE) && (CH_CFG_USE_OBJ_FIFOS == TRUE) && (PORT_SUPPORTS_RT == TRUE) && !defined(PORT_SIM_VIRTUAL_CLOCK)) || defined(__DOXYGEN__)
+  &oslib_test_010_005,
+#endif
+  NULL
+};
+
+/**
+ * @brief   Lock-free Rings.
+ */
+const testsequence_t oslib_test_sequence_010 = {
+  "Lock-free Rings",
+  oslib_test_sequence_010_array
+};
+
+#endif /* CH_CFG_USE_RINGS == TRUE */
@@ -0,0 +1,1405 @@
+/*
+    ChibiOS - Copyright (C) 2006..2017 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "oslib_test_root.h"
+
+/**
+ * @file    oslib_test_sequence_011.c
+ * @brief   Test Sequence 011 code.
+ *
+ * @page oslib_test_sequence_011 [11] Benchmarks
+ *
+ * File: @ref oslib_test_sequence_011.c
+ *
+ * <h2>Description</h2>
+ * This sequence measures the performance of the ChibiOS library
+ * primitives, single and multiple threads throughputs, allocation
+ * latencies and caches costs are measured. The results are printed on
+ * the output log and reported as benchmark scores.
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage oslib_test_011_001
+ * - @subpage oslib_test_011_002
+ * - @subpage oslib_test_011_003
+ * - @subpage oslib_test_011_004
+ * - @subpage oslib_test_011_005
+ * - @subpage oslib_test_011_006
+ * - @subpage oslib_test_011_007
+ * - @subpage oslib_test_011_008
+ * - @subpage oslib_test_011_009
+ * - @subpage oslib_test_011_010
+ * - @subpage oslib_test_011_011
+ * - @subpage oslib_test_011_012
+ * - @subpage oslib_test_011_013
+ * .
+ */
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include <string.h>
+
+#define BENCH_QUEUE_SIZE        4
+#define BENCH_PIPE_BLOCK        4
+#define BENCH_SAMPLES           64
+#define BENCH_STOP              0xFFFFFFFFU
+
+static systime_t bench_wait_tick(void) {
+
+  chThdSleep((sysinterval_t)1);
+  return chVTGetSystemTimeX();
+}
+
+#if defined(__CHIBIOS_RT__)
+static THD_WORKING_AREA(waBench, 256);
+
+static thread_t *bench_start(tfunc_t funcp, tprio_t prio) {
+  thread_descriptor_t td = {
+    .name  = "bench",
+    .wbase = waBench,
+    .wend  = THD_WORKING_AREA_END(waBench),
+    .prio  = prio,
+    .funcp = funcp,
+    .arg   = NULL
+  };
+
+  return chThdCreate(&td);
+}
+#endif
+
+#if (PORT_SUPPORTS_RT == TRUE) && !defined(PORT_SIM_VIRTUAL_CLOCK) &&       \
+    ((CH_CFG_USE_MEMPOOLS == TRUE) || (CH_CFG_USE_HEAP == TRUE))
+static void *bench_ptrs[BENCH_SAMPLES];
+static rtcnt_t bench_samples[BENCH_SAMPLES];
+static rtcnt_t bench_offset;
+
+/* Measures the cost of reading the realtime counter, it is subtracted
+   from all samples.*/
+static void bench_calibrate(void) {
+  unsigned i;
+
+  bench_offset = (rtcnt_t)-1;
+  for (i = 0; i < 16; i++) {
+    rtcnt_t start = chSysGetRealtimeCounterX();
+    rtcnt_t t = chSysGetRealtimeCounterX() - start;
+
+    if (t < bench_offset) {
+      bench_offset = t;
+    }
+  }
+}
+
+static void bench_sample(unsigned i, rtcnt_t start) {
+  rtcnt_t t = chSysGetRealtimeCounterX() - start;
+
+  bench_samples[i] = t > bench_offset ? t - bench_offset : (rtcnt_t)0;
+}
+
+/* Sorts the samples and prints min, median, p90 and max, the unit is
+   the port realtime counter tick, BENCH_SAMPLES is too small for a
+   meaningful p99.*/
+static void bench_print_samples(const char *name) {
+  unsigned i, j;
+
+  for (i = 1; i < BENCH_SAMPLES; i++) {
+    rtcnt_t t = bench_samples[i];
+
+    for (j = i; (j > 0U) && (bench_samples[j - 1U] > t); j--) {
+      bench_samples[j] = bench_samples[j - 1U];
+    }
+    bench_samples[j] = t;
+  }
+  test_print("--- ");
+  test_print(name);
+  test_print(": ");
+  test_printn((uint32_t)bench_samples[0]);
+  test_print("/");
+  test_printn((uint32_t)bench_samples[BENCH_SAMPLES / 2]);
+  test_print("/");
+  test_printn((uint32_t)bench_samples[(BENCH_SAMPLES * 90) / 100]);
+  test_print("/");
+  test_printn((uint32_t)bench_samples[BENCH_SAMPLES - 1]);
+  test_println(" ticks (min/med/p90/max)");
+}
+#endif
+
+#if CH_CFG_USE_MAILBOXES == TRUE
+static msg_t mb_buffer[BENCH_QUEUE_SIZE];
+static MAILBOX_DECL(mb1, mb_buffer, BENCH_QUEUE_SIZE);
+
+#if defined(__CHIBIOS_RT__)
+static THD_FUNCTION(mb_consumer, arg) {
+  msg_t msg;
+
+  (void)arg;
+
+  while (chMBFetchTimeout(&mb1, &msg, TIME_INFINITE) == MSG_OK) {
+  }
+}
+#endif
+#endif
+
+#if CH_CFG_USE_PIPES == TRUE
+static uint8_t pipe_buffer[BENCH_PIPE_BLOCK * BENCH_QUEUE_SIZE];
+static PIPE_DECL(pipe1, pipe_buffer, BENCH_PIPE_BLOCK * BENCH_QUEUE_SIZE);
+
+#if defined(__CHIBIOS_RT__)
+static THD_FUNCTION(pipe_consumer, arg) {
+  uint8_t buf[BENCH_PIPE_BLOCK];
+
+  (void)arg;
+
+  while (chPipeReadTimeout(&pipe1, buf, BENCH_PIPE_BLOCK,
+                           TIME_INFINITE) == BENCH_PIPE_BLOCK) {
+  }
+}
+#endif
+#endif
+
+#if (CH_CFG_USE_OBJ_FIFOS == TRUE) && defined(__CHIBIOS_RT__)
+static msg_t fifo_msgs[BENCH_QUEUE_SIZE];
+static uintptr_t fifo_objs[BENCH_QUEUE_SIZE];
+static objects_fifo_t fifo1;
+
+static THD_FUNCTION(fifo_consumer, arg) {
+  void *objp;
+  uint32_t value;
+
+  (void)arg;
+
+  do {
+    (void)chFifoReceiveObjectTimeout(&fifo1, &objp, TIME_INFINITE);
+    value = *(uint32_t *)objp;
+    chFifoReturnObject(&fifo1, objp);
+  } while (value != BENCH_STOP);
+}
+
+static void fifo_stop(thread_t *tp) {
+  void *objp;
+
+  objp = chFifoTakeObjectTimeout(&fifo1, TIME_INFINITE);
+  *(uint32_t *)objp = BENCH_STOP;
+  chFifoSendObject(&fifo1, objp);
+  (void)chThdWait(tp);
+}
+#endif
+
+#if CH_CFG_USE_MEMPOOLS == TRUE
+static uintptr_t pool_objects[BENCH_SAMPLES];
+static memory_pool_t mp1;
+#endif
+
+#if CH_CFG_USE_HEAP == TRUE
+#define BENCH_HEAP_SIZE         4096
+
+static memory_heap_t heap1;
+static CH_HEAP_AREA(heap_buffer, BENCH_HEAP_SIZE);
+#endif
+
+#if CH_CFG_USE_OBJ_CACHES == TRUE
+#define BENCH_CACHE_OBJECTS     4
+
+typedef struct {
+  oc_object_t       header;
+  uint8_t           data[16];
+} bench_object_t;
+
+static oc_hash_header_t cache_headers[BENCH_CACHE_OBJECTS * 2];
+static bench_object_t cache_objects[BENCH_CACHE_OBJECTS];
+static objects_cache_t cache1;
+
+static bool cache_read(objects_cache_t *ocp,
+                       oc_object_t *objp,
+                       bool async) {
+
+  objp->obj_flags &= ~OC_FLAG_NOTSYNC;
+
+  if (async) {
+    chCacheReleaseObject(ocp, objp);
+  }
+
+  return false;
+}
+
+static bool cache_write(objects_cache_t *ocp,
+                        oc_object_t *objp,
+                        bool async) {
+
+  (void)ocp;
+  (void)objp;
+  (void)async;
+
+  return false;
+}
+
+static uint32_t cache_access(uint32_t key) {
+  oc_object_t *objp;
+  uint32_t miss = 0U;
+
+  objp = chCacheGetObject(&cache1, 0U, key);
+  if ((objp->obj_flags & OC_FLAG_NOTSYNC) != 0U) {
+    (void)chCacheReadObject(&cache1, objp, false);
+    miss = 1U;
+  }
+  chCacheReleaseObject(&cache1, objp);
+
+  return miss;
+}
+#endif
+
+#if CH_CFG_USE_JOBS == TRUE
+static job_descriptor_t jobs[BENCH_QUEUE_SIZE];
+static msg_t jobs_msgs[BENCH_QUEUE_SIZE];
+static jobs_queue_t jq;
+
+static void bench_job(void *arg) {
+
+  (*(uint32_t *)arg)++;
+}
+#endif
+
+#if (CH_CFG_USE_DELEGATES == TRUE) && defined(__CHIBIOS_RT__)
+static bool dispatcher_exit;
+
+static msg_t bench_delegate(void) {
+
+  return MSG_OK;
+}
+
+static msg_t bench_delegate_end(void) {
+
+  dispatcher_exit = true;
+
+  return MSG_OK;
+}
+
+static THD_FUNCTION(dispatcher, arg) {
+
+  (void)arg;
+
+  dispatcher_exit = false;
+  do {
+    chDelegateDispatch();
+  } while (!dispatcher_exit);
+}
+#endif
+
+#if (CH_CFG_USE_FACTORY == TRUE) && (CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE)
+#define BENCH_FACTORY_OBJECTS   8
+
+static const char *factory_names[BENCH_FACTORY_OBJECTS] = {
+  "bench0", "bench1", "bench2", "bench3",
+  "bench4", "bench5", "bench6", "bench7"
+};
+static uint32_t factory_objects[BENCH_FACTORY_OBJECTS];
+#endif
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+#if (CH_CFG_USE_MAILBOXES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_011_001 [11.1] Mailboxes single thread throughput
+ *
+ * <h2>Description</h2>
+ * The number of post/fetch pairs executed by a single thread in a one
+ * second time window is measured.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MAILBOXES == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [11.1.1] Measuring post/fetch pairs.
+ * - [11.1.2] Scores are printed.
+ * .
+ */
+
+static void oslib_test_011_001_setup(void) {
+  chMBReset(&mb1);
+  chMBResumeX(&mb1);
+}
+
+static void oslib_test_011_001_execute(void) {
+  systime_t start, end;
+  uint32_t n;
+  msg_t msg;
+
+  /* [11.1.1] Measuring post/fetch pairs.*/
+  test_set_step(1);
+  {
+    n = 0;
+    start = bench_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      (void)chMBPostTimeout(&mb1, (msg_t)n, TIME_IMMEDIATE);
+      (void)chMBFetchTimeout(&mb1, &msg, TIME_IMMEDIATE);
+      n++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+  }
+  test_end_step(1);
+
+  /* [11.1.2] Scores are printed.*/
+  test_set_step(2);
+  {
+    test_print("--- Mailbox : ");
+    test_printn(n);
+    test_println(" msgs/S");
+    test_score(n, "Mailbox msgs/S");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t oslib_test_011_001 = {
+  "Mailboxes single thread throughput",
+  oslib_test_011_001_setup,
+  NULL,
+  oslib_test_011_001_execute
+};
+#endif /* CH_CFG_USE_MAILBOXES == TRUE */
+
+#if ((CH_CFG_USE_MAILBOXES == TRUE) && defined(__CHIBIOS_RT__)) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_011_002 [11.2] Mailboxes producer/consumer throughput
+ *
+ * <h2>Description</h2>
+ * The number of messages posted to a consumer thread in a one second
+ * time window is measured, the consumer runs first at higher then at
+ * lower priority than the producer.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (CH_CFG_USE_MAILBOXES == TRUE) && defined(__CHIBIOS_RT__)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [11.2.1] Measuring with the consumer at higher priority.
+ * - [11.2.2] Measuring with the consumer at lower priority.
+ * - [11.2.3] Scores are printed.
+ * .
+ */
+
+static void oslib_test_011_002_setup(void) {
+  chMBReset(&mb1);
+  chMBResumeX(&mb1);
+}
+
+static void oslib_test_011_002_execute(void) {
+  systime_t start, end;
+  uint32_t n1, n2;
+  thread_t *tp;
+
+  /* [11.2.1] Measuring with the consumer at higher priority.*/
+  test_set_step(1);
+  {
+    n1 = 0;
+    tp = bench_start(mb_consumer, chThdGetPriorityX() + 1);
+    start = bench_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      (void)chMBPostTimeout(&mb1, (msg_t)n1, TIME_INFINITE);
+      n1++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+    chMBReset(&mb1);
+    (void)chThdWait(tp);
+    chMBResumeX(&mb1);
+  }
+  test_end_step(1);
+
+  /* [11.2.2] Measuring with the consumer at lower priority.*/
+  test_set_step(2);
+  {
+    n2 = 0;
+    tp = bench_start(mb_consumer, chThdGetPriorityX() - 1);
+    start = bench_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      (void)chMBPostTimeout(&mb1, (msg_t)n2, TIME_INFINITE);
+      n2++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+    chMBReset(&mb1);
+    (void)chThdWait(tp);
+    chMBResumeX(&mb1);
+  }
+  test_end_step(2);
+
+  /* [11.2.3] Scores are printed.*/
+  test_set_step(3);
+  {
+    test_print("--- Hi prio : ");
+    test_printn(n1);
+    test_println(" msgs/S");
+    test_print("--- Lo prio : ");
+    test_printn(n2);
+    test_println(" msgs/S");
+    test_score(n1, "Mailbox hi msgs/S");
+    test_score(n2, "Mailbox lo msgs/S");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t oslib_test_011_002 = {
+  "Mailboxes producer/consumer throughput",
+  oslib_test_011_002_setup,
+  NULL,
+  oslib_test_011_002_execute
+};
+#endif /* (CH_CFG_USE_MAILBOXES == TRUE) && defined(__CHIBIOS_RT__) */
+
+#if (CH_CFG_USE_PIPES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_011_003 [11.3] Pipes single thread throughput
+ *
+ * <h2>Description</h2>
+ * The number of bytes written and read back by a single thread in a one
+ * second time window is measured, blocks of BENCH_PIPE_BLOCK bytes are
+ * transferred.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_PIPES == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [11.3.1] Measuring write/read pairs.
+ * - [11.3.2] Scores are printed.
+ * .
+ */
+
+static void oslib_test_011_003_setup(void) {
+  chPipeReset(&pipe1);
+  chPipeResume(&pipe1);
+}
+
+static void oslib_test_011_003_execute(void) {
+  systime_t start, end;
+  uint32_t n;
+  uint8_t buf[BENCH_PIPE_BLOCK];
+
+  /* [11.3.1] Measuring write/read pairs.*/
+  test_set_step(1);
+  {
+    n = 0;
+    memset(buf, 0x55, sizeof (buf));
+    start = bench_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      (void)chPipeWriteTimeout(&pipe1, buf, BENCH_PIPE_BLOCK,
+                               TIME_IMMEDIATE);
+      (void)chPipeReadTimeout(&pipe1, buf, BENCH_PIPE_BLOCK,
+                              TIME_IMMEDIATE);
+      n += BENCH_PIPE_BLOCK;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+  }
+  test_end_step(1);
+
+  /* [11.3.2] Scores are printed.*/
+  test_set_step(2);
+  {
+    test_print("--- Pipe    : ");
+    test_printn(n);
+    test_println(" bytes/S");
+    test_score(n, "Pipe bytes/S");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t oslib_test_011_003 = {
+  "Pipes single thread throughput",
+  oslib_test_011_003_setup,
+  NULL,
+  oslib_test_011_003_execute
+};
+#endif /* CH_CFG_USE_PIPES == TRUE */
+
+#if ((CH_CFG_USE_PIPES == TRUE) && defined(__CHIBIOS_RT__)) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_011_004 [11.4] Pipes producer/consumer throughput
+ *
+ * <h2>Description</h2>
+ * The number of bytes written to a consumer thread in a one second time
+ * window is measured, the consumer runs first at higher then at lower
+ * priority than the producer.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (CH_CFG_USE_PIPES == TRUE) && defined(__CHIBIOS_RT__)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [11.4.1] Measuring with the consumer at higher priority.
+ * - [11.4.2] Measuring with the consumer at lower priority.
+ * - [11.4.3] Scores are printed.
+ * .
+ */
+
+static void oslib_test_011_004_setup(void) {
+  chPipeReset(&pipe1);
+  chPipeResume(&pipe1);
+}
+
+static void oslib_test_011_004_execute(void) {
+  systime_t start, end;
+  uint32_t n1, n2;
+  uint8_t buf[BENCH_PIPE_BLOCK];
+  thread_t *tp;
+
+  /* [11.4.1] Measuring with the consumer at higher priority.*/
+  test_set_step(1);
+  {
+    memset(buf, 0x55, sizeof (buf));
+    n1 = 0;
+    tp = bench_start(pipe_consumer, chThdGetPriorityX() + 1);
+    start = bench_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      (void)chPipeWriteTimeout(&pipe1, buf, BENCH_PIPE_BLOCK,
+                               TIME_INFINITE);
+      n1 += BENCH_PIPE_BLOCK;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+    chPipeReset(&pipe1);
+    (void)chThdWait(tp);
+    chPipeResume(&pipe1);
+  }
+  test_end_step(1);
+
+  /* [11.4.2] Measuring with the consumer at lower priority.*/
+  test_set_step(2);
+  {
+    n2 = 0;
+    tp = bench_start(pipe_consumer, chThdGetPriorityX() - 1);
+    start = bench_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      (void)chPipeWriteTimeout(&pipe1, buf, BENCH_PIPE_BLOCK,
+                               TIME_INFINITE);
+      n2 += BENCH_PIPE_BLOCK;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+    chPipeReset(&pipe1);
+    (void)chThdWait(tp);
+    chPipeResume(&pipe1);
+  }
+  test_end_step(2);
+
+  /* [11.4.3] Scores are printed.*/
+  test_set_step(3);
+  {
+    test_print("--- Hi prio : ");
+    test_printn(n1);
+    test_println(" bytes/S");
+    test_print("--- Lo prio : ");
+    test_printn(n2);
+    test_println(" bytes/S");
+    test_score(n1, "Pipe hi bytes/S");
+    test_score(n2, "Pipe lo bytes/S");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t oslib_test_011_004 = {
+  "Pipes producer/consumer throughput",
+  oslib_test_011_004_setup,
+  NULL,
+  oslib_test_011_004_execute
+};
+#endif /* (CH_CFG_USE_PIPES == TRUE) && defined(__CHIBIOS_RT__) */
+
+#if ((CH_CFG_USE_OBJ_FIFOS == TRUE) && defined(__CHIBIOS_RT__)) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_011_005 [11.5] Objects FIFOs producer/consumer throughput
+ *
+ * <h2>Description</h2>
+ * The number of objects sent to a consumer thread in a one second time
+ * window is measured, the consumer runs first at higher then at lower
+ * priority than the producer.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (CH_CFG_USE_OBJ_FIFOS == TRUE) && defined(__CHIBIOS_RT__)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [11.5.1] Measuring with the consumer at higher priority.
+ * - [11.5.2] Measuring with the consumer at lower priority.
+ * - [11.5.3] Scores are printed.
+ * .
+ */
+
+static void oslib_test_011_005_setup(void) {
+  chFifoObjectInit(&fifo1, sizeof (uintptr_t), BENCH_QUEUE_SIZE,
+                   fifo_objs, fifo_msgs);
+}
+
+static void oslib_test_011_005_execute(void) {
+  systime_t start, end;
+  uint32_t n1, n2;
+  thread_t *tp;
+
+  /* [11.5.1] Measuring with the consumer at higher priority.*/
+  test_set_step(1);
+  {
+    n1 = 0;
+    tp = bench_start(fifo_consumer, chThdGetPriorityX() + 1);
+    start = bench_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      void *objp;
+
+      objp = chFifoTakeObjectTimeout(&fifo1, TIME_INFINITE);
+      *(uint32_t *)objp = n1;
+      chFifoSendObject(&fifo1, objp);
+      n1++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+    fifo_stop(tp);
+  }
+  test_end_step(1);
+
+  /* [11.5.2] Measuring with the consumer at lower priority.*/
+  test_set_step(2);
+  {
+    n2 = 0;
+    tp = bench_start(fifo_consumer, chThdGetPriorityX() - 1);
+    start = bench_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      void *objp;
+
+      objp = chFifoTakeObjectTimeout(&fifo1, TIME_INFINITE);
+      *(uint32_t *)objp = n2;
+      chFifoSendObject(&fifo1, objp);
+      n2++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+    fifo_stop(tp);
+  }
+  test_end_step(2);
+
+  /* [11.5.3] Scores are printed.*/
+  test_set_step(3);
+  {
+    test_print("--- Hi prio : ");
+    test_printn(n1);
+    test_println(" msgs/S");
+    test_print("--- Lo prio : ");
+    test_printn(n2);
+    test_println(" msgs/S");
+    test_score(n1, "FIFO hi msgs/S");
+    test_score(n2, "FIFO lo msgs/S");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t oslib_test_011_005 = {
+  "Objects FIFOs producer/consumer throughput",
+  oslib_test_011_005_setup,
+  NULL,
+  oslib_test_011_005_execute
+};
+#endif /* (CH_CFG_USE_OBJ_FIFOS == TRUE) && defined(__CHIBIOS_RT__) */
+
+#if (CH_CFG_USE_MEMPOOLS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_011_006 [11.6] Memory pools throughput
+ *
+ * <h2>Description</h2>
+ * The number of allocate/free pairs executed in a one second time
+ * window is measured.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MEMPOOLS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [11.6.1] Measuring allocate/free pairs.
+ * - [11.6.2] Scores are printed.
+ * .
+ */
+
+static void oslib_test_011_006_setup(void) {
+  chPoolObjectInit(&mp1, sizeof (uintptr_t), NULL);
+  chPoolLoadArray(&mp1, pool_objects, BENCH_SAMPLES);
+}
+
+static void oslib_test_011_006_execute(void) {
+  systime_t start, end;
+  uint32_t n;
+
+  /* [11.6.1] Measuring allocate/free pairs.*/
+  test_set_step(1);
+  {
+    n = 0;
+    start = bench_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      chPoolFree(&mp1, chPoolAlloc(&mp1));
+      n++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+  }
+  test_end_step(1);
+
+  /* [11.6.2] Scores are printed.*/
+  test_set_step(2);
+  {
+    test_print("--- Pool    : ");
+    test_printn(n);
+    test_println(" allocs/S");
+    test_score(n, "Pool allocs/S");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t oslib_test_011_006 = {
+  "Memory pools throughput",
+  oslib_test_011_006_setup,
+  NULL,
+  oslib_test_011_006_execute
+};
+#endif /* CH_CFG_USE_MEMPOOLS == TRUE */
+
+#if ((CH_CFG_USE_MEMPOOLS == TRUE) && (PORT_SUPPORTS_RT == TRUE) && !defined(PORT_SIM_VIRTUAL_CLOCK)) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_011_007 [11.7] Memory pools latency distribution
+ *
+ * <h2>Description</h2>
+ * The pool is emptied then filled again, the duration of each operation
+ * is measured using the realtime counter. Minimum, median, 90th
+ * percentile and maximum are printed.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (CH_CFG_USE_MEMPOOLS == TRUE) && (PORT_SUPPORTS_RT == TRUE) && !defined(PORT_SIM_VIRTUAL_CLOCK)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [11.7.1] Measuring allocations until the pool is empty.
+ * - [11.7.2] Measuring releases until the pool is full.
+ * .
+ */
+
+static void oslib_test_011_007_setup(void) {
+  chPoolObjectInit(&mp1, sizeof (uintptr_t), NULL);
+  chPoolLoadArray(&mp1, pool_objects, BENCH_SAMPLES);
+  bench_calibrate();
+}
+
+static void oslib_test_011_007_execute(void) {
+  rtcnt_t start;
+  unsigned i;
+
+  /* [11.7.1] Measuring allocations until the pool is empty.*/
+  test_set_step(1);
+  {
+    for (i = 0; i < BENCH_SAMPLES; i++) {
+      start = chSysGetRealtimeCounterX();
+      bench_ptrs[i] = chPoolAlloc(&mp1);
+      bench_sample(i, start);
+      test_assert(bench_ptrs[i] != NULL, "allocation failed");
+    }
+    test_assert(chPoolAlloc(&mp1) == NULL, "pool not empty");
+    bench_print_samples("Alloc   ");
+  }
+  test_end_step(1);
+
+  /* [11.7.2] Measuring releases until the pool is full.*/
+  test_set_step(2);
+  {
+    for (i = 0; i < BENCH_SAMPLES; i++) {
+      start = chSysGetRealtimeCounterX();
+      chPoolFree(&mp1, bench_ptrs[i]);
+      bench_sample(i, start);
+    }
+    bench_print_samples("Free    ");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t oslib_test_011_007 = {
+  "Memory pools latency distribution",
+  oslib_test_011_007_setup,
+  NULL,
+  oslib_test_011_007_execute
+};
+#endif /* (CH_CFG_USE_MEMPOOLS == TRUE) && (PORT_SUPPORTS_RT == TRUE) && !defined(PORT_SIM_VIRTUAL_CLOCK) */
+
+#if (CH_CFG_USE_HEAP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_011_008 [11.8] Heap throughput
+ *
+ * <h2>Description</h2>
+ * The number of allocate/free pairs executed in a one second time
+ * window is measured.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_HEAP == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [11.8.1] Measuring allocate/free pairs.
+ * - [11.8.2] Scores are printed.
+ * .
+ */
+
+static void oslib_test_011_008_setup(void) {
+  chHeapObjectInit(&heap1, heap_buffer, sizeof (heap_buffer));
+}
+
+static void oslib_test_011_008_execute(void) {
+  systime_t start, end;
+  uint32_t n;
+
+  /* [11.8.1] Measuring allocate/free pairs.*/
+  test_set_step(1);
+  {
+    n = 0;
+    start = bench_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      chHeapFree(chHeapAlloc(&heap1, 16));
+      n++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+  }
+  test_end_step(1);
+
+  /* [11.8.2] Scores are printed.*/
+  test_set_step(2);
+  {
+    test_print("--- Heap    : ");
+    test_printn(n);
+    test_println(" allocs/S");
+    test_score(n, "Heap allocs/S");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t oslib_test_011_008 = {
+  "Heap throughput",
+  oslib_test_011_008_setup,
+  NULL,
+  oslib_test_011_008_execute
+};
+#endif /* CH_CFG_USE_HEAP == TRUE */
+
+#if ((CH_CFG_USE_HEAP == TRUE) && (PORT_SUPPORTS_RT == TRUE) && !defined(PORT_SIM_VIRTUAL_CLOCK)) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_011_009 [11.9] Heap latency distribution
+ *
+ * <h2>Description</h2>
+ * Blocks of mixed sizes are allocated then released, even blocks first
+ * in order to fragment the heap. The duration of each operation is
+ * measured using the realtime counter. Minimum, median, 90th percentile
+ * and maximum are printed.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (CH_CFG_USE_HEAP == TRUE) && (PORT_SUPPORTS_RT == TRUE) && !defined(PORT_SIM_VIRTUAL_CLOCK)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [11.9.1] Measuring allocations of sizes between 4 and 32 bytes.
+ * - [11.9.2] Measuring releases, even blocks first.
+ * - [11.9.3] Checking that the heap is not fragmented.
+ * .
+ */
+
+static void oslib_test_011_009_setup(void) {
+  chHeapObjectInit(&heap1, heap_buffer, sizeof (heap_buffer));
+  bench_calibrate();
+}
+
+static void oslib_test_011_009_execute(void) {
+  rtcnt_t start;
+  size_t n, total;
+  unsigned i, j;
+
+  /* [11.9.1] Measuring allocations of sizes between 4 and 32 bytes.*/
+  test_set_step(1);
+  {
+    for (i = 0; i < BENCH_SAMPLES; i++) {
+      start = chSysGetRealtimeCounterX();
+      bench_ptrs[i] = chHeapAlloc(&heap1, (((i * 5U) % 8U) + 1U) * 4U);
+      bench_sample(i, start);
+      test_assert(bench_ptrs[i] != NULL, "allocation failed");
+    }
+    bench_print_samples("Alloc   ");
+  }
+  test_end_step(1);
+
+  /* [11.9.2] Measuring releases, even blocks first.*/
+  test_set_step(2);
+  {
+    for (i = 0; i < BENCH_SAMPLES; i++) {
+      if (i < (BENCH_SAMPLES / 2)) {
+        j = i * 2U;
+      }
+      else {
+        j = ((i - (BENCH_SAMPLES / 2)) * 2U) + 1U;
+      }
+      start = chSysGetRealtimeCounterX();
+      chHeapFree(bench_ptrs[j]);
+      bench_sample(i, start);
+    }
+    bench_print_samples("Free    ");
+  }
+  test_end_step(2);
+
+  /* [11.9.3] Checking that the heap is not fragmented.*/
+  test_set_step(3);
+  {
+    n = chHeapStatus(&heap1, &total, NULL);
+    test_assert(n == 1U, "heap fragmented");
+    test_assert(!chHeapIntegrityCheck(&heap1), "integrity check failed");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t oslib_test_011_009 = {
+  "Heap latency distribution",
+  oslib_test_011_009_setup,
+  NULL,
+  oslib_test_011_009_execute
+};
+#endif /* (CH_CFG_USE_HEAP == TRUE) && (PORT_SUPPORTS_RT == TRUE) && !defined(PORT_SIM_VIRTUAL_CLOCK) */
+
+#if (CH_CFG_USE_OBJ_CACHES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_011_010 [11.10] Objects caches hit and miss cost
+ *
+ * <h2>Description</h2>
+ * The number of cache accesses executed in a one second time window is
+ * measured when the object is always cached and when the accessed keys
+ * are twice the cached objects, in the second case each access recycles
+ * the least recently used object.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_OBJ_CACHES == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [11.10.1] Measuring cache hits.
+ * - [11.10.2] Measuring cache misses.
+ * - [11.10.3] Scores are printed.
+ * .
+ */
+
+static void oslib_test_011_010_setup(void) {
+  chCacheObjectInit(&cache1,
+                    BENCH_CACHE_OBJECTS * 2,
+                    cache_headers,
+                    BENCH_CACHE_OBJECTS,
+                    sizeof (bench_object_t),
+                    cache_objects,
+                    cache_read,
+                    cache_write);
+}
+
+static void oslib_test_011_010_execute(void) {
+  systime_t start, end;
+  uint32_t n1, n2, misses;
+
+  /* [11.10.1] Measuring cache hits.*/
+  test_set_step(1);
+  {
+    n1 = 0;
+    misses = 0;
+    start = bench_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      misses += cache_access(0U);
+      n1++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+    test_assert(misses == 1U, "unexpected misses");
+  }
+  test_end_step(1);
+
+  /* [11.10.2] Measuring cache misses.*/
+  test_set_step(2);
+  {
+    n2 = 0;
+    misses = 0;
+    start = bench_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      misses += cache_access(1U + (n2 % (BENCH_CACHE_OBJECTS * 2)));
+      n2++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+    test_assert(misses == n2, "unexpected hits");
+  }
+  test_end_step(2);
+
+  /* [11.10.3] Scores are printed.*/
+  test_set_step(3);
+  {
+    test_print("--- Hits    : ");
+    test_printn(n1);
+    test_println(" accesses/S");
+    test_print("--- Misses  : ");
+    test_printn(n2);
+    test_println(" accesses/S");
+    test_score(n1, "Cache hits/S");
+    test_score(n2, "Cache misses/S");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t oslib_test_011_010 = {
+  "Objects caches hit and miss cost",
+  oslib_test_011_010_setup,
+  NULL,
+  oslib_test_011_010_execute
+};
+#endif /* CH_CFG_USE_OBJ_CACHES == TRUE */
+
+#if (CH_CFG_USE_JOBS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_011_011 [11.11] Jobs dispatch throughput
+ *
+ * <h2>Description</h2>
+ * The number of jobs posted and dispatched by a single thread in a one
+ * second time window is measured, the jobs counter is incremented by
+ * the job function.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_JOBS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [11.11.1] Measuring post/dispatch pairs.
+ * - [11.11.2] Scores are printed.
+ * .
+ */
+
+static void oslib_test_011_011_setup(void) {
+  chJobObjectInit(&jq, BENCH_QUEUE_SIZE, jobs, jobs_msgs);
+}
+
+static void oslib_test_011_011_execute(void) {
+  systime_t start, end;
+  uint32_t n;
+
+  /* [11.11.1] Measuring post/dispatch pairs.*/
+  test_set_step(1);
+  {
+    n = 0;
+    start = bench_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      job_descriptor_t *jp = chJobGet(&jq);
+
+      jp->jobfunc = bench_job;
+      jp->jobarg  = (void *)&n;
+      chJobPost(&jq, jp);
+      (void)chJobDispatch(&jq);
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+  }
+  test_end_step(1);
+
+  /* [11.11.2] Scores are printed.*/
+  test_set_step(2);
+  {
+    test_print("--- Jobs    : ");
+    test_printn(n);
+    test_println(" jobs/S");
+    test_score(n, "Jobs/S");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t oslib_test_011_011 = {
+  "Jobs dispatch throughput",
+  oslib_test_011_011_setup,
+  NULL,
+  oslib_test_011_011_execute
+};
+#endif /* CH_CFG_USE_JOBS == TRUE */
+
+#if ((CH_CFG_USE_DELEGATES == TRUE) && defined(__CHIBIOS_RT__)) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_011_012 [11.12] Delegates call throughput
+ *
+ * <h2>Description</h2>
+ * The number of calls delegated to a dispatcher thread in a one second
+ * time window is measured.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (CH_CFG_USE_DELEGATES == TRUE) && defined(__CHIBIOS_RT__)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [11.12.1] Starting the dispatcher thread.
+ * - [11.12.2] Measuring delegated calls.
+ * - [11.12.3] Stopping the dispatcher thread.
+ * - [11.12.4] Scores are printed.
+ * .
+ */
+
+static void oslib_test_011_012_execute(void) {
+  systime_t start, end;
+  uint32_t n;
+  thread_t *tp;
+
+  /* [11.12.1] Starting the dispatcher thread.*/
+  test_set_step(1);
+  {
+    tp = bench_start(dispatcher, chThdGetPriorityX() + 1);
+  }
+  test_end_step(1);
+
+  /* [11.12.2] Measuring delegated calls.*/
+  test_set_step(2);
+  {
+    n = 0;
+    start = bench_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      (void)chDelegateCallDirect0(tp, bench_delegate);
+      n++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+  }
+  test_end_step(2);
+
+  /* [11.12.3] Stopping the dispatcher thread.*/
+  test_set_step(3);
+  {
+    (void)chDelegateCallDirect0(tp, bench_delegate_end);
+    (void)chThdWait(tp);
+  }
+  test_end_step(3);
+
+  /* [11.12.4] Scores are printed.*/
+  test_set_step(4);
+  {
+    test_print("--- Calls   : ");
+    test_printn(n);
+    test_println(" calls/S");
+    test_score(n, "Delegate calls/S");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t oslib_test_011_012 = {
+  "Delegates call throughput",
+  NULL,
+  NULL,
+  oslib_test_011_012_execute
+};
+#endif /* (CH_CFG_USE_DELEGATES == TRUE) && defined(__CHIBIOS_RT__) */
+
+#if ((CH_CFG_USE_FACTORY == TRUE) && (CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE)) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_011_013 [11.13] Factory lookup throughput
+ *
+ * <h2>Description</h2>
+ * BENCH_FACTORY_OBJECTS objects are registered then the number of
+ * find/release pairs executed in a one second time window is measured,
+ * the last registered object is looked up.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (CH_CFG_USE_FACTORY == TRUE) && (CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [11.13.1] Registering the objects.
+ * - [11.13.2] Measuring find/release pairs.
+ * - [11.13.3] Releasing the objects.
+ * - [11.13.4] Scores are printed.
+ * .
+ */
+
+static void oslib_test_011_013_execute(void) {
+  systime_t start, end;
+  uint32_t n;
+  unsigned i;
+  registered_object_t *rops[BENCH_FACTORY_OBJECTS];
+
+  /* [11.13.1] Registering the objects.*/
+  test_set_step(1);
+  {
+    for (i = 0; i < BENCH_FACTORY_OBJECTS; i++) {
+      rops[i] = chFactoryRegisterObject(factory_names[i],
+                                        (void *)&factory_objects[i]);
+      test_assert(rops[i] != NULL, "cannot register");
+    }
+  }
+  test_end_step(1);
+
+  /* [11.13.2] Measuring find/release pairs.*/
+  test_set_step(2);
+  {
+    n = 0;
+    start = bench_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      chFactoryReleaseObject(
+          chFactoryFindObject(factory_names[BENCH_FACTORY_OBJECTS - 1]));
+      n++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+  }
+  test_end_step(2);
+
+  /* [11.13.3] Releasing the objects.*/
+  test_set_step(3);
+  {
+    for (i = 0; i < BENCH_FACTORY_OBJECTS; i++) {
+      chFactoryReleaseObject(rops[i]);
+      test_assert(chFactoryFindObject(factory_names[i]) == NULL,
+                  "still registered");
+    }
+  }
+  test_end_step(3);
+
+  /* [11.13.4] Scores are printed.*/
+  test_set_step(4);
+  {
+    test_print("--- Lookups : ");
+    test_printn(n);
+    test_println(" lookups/S");
+    test_score(n, "Factory lookups/S");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t oslib_test_011_013 = {
+  "Factory lookup throughput",
+  NULL,
+  NULL,
+  oslib_test_011_013_execute
+};
+#endif /* (CH_CFG_USE_FACTORY == TRUE) && (CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE) */
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const oslib_test_sequence_011_array[] = {
+#if (CH_CFG_USE_MAILBOXES == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_011_001,
+#endif
+#if ((CH_CFG_USE_MAILBOXES == TRUE) && defined(__CHIBIOS_RT__)) || defined(__DOXYGEN__)
+  &oslib_test_011_002,
+#endif
+#if (CH_CFG_USE_PIPES == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_011_003,
+#endif
+#if ((CH_CFG_USE_PIPES == TRUE) && defined(__CHIBIOS_RT__)) || defined(__DOXYGEN__)
+  &oslib_test_011_004,
+#endif
+#if ((CH_CFG_USE_OBJ_FIFOS == TRUE) && defined(__CHIBIOS_RT__)) || defined(__DOXYGEN__)
+  &oslib_test_011_005,
+#endif
+#if (CH_CFG_USE_MEMPOOLS == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_011_006,
+#endif
+#if ((CH_CFG_USE_MEMPOOLS == TRUE) && (PORT_SUPPORTS_RT == TRUE) && !defined(PORT_SIM_VIRTUAL_CLOCK)) || defined(__DOXYGEN__)
+  &oslib_test_011_007,
+#endif
+#if (CH_CFG_USE_HEAP == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_011_008,
+#endif
+#if ((CH_CFG_USE_HEAP == TRUE) && (PORT_SUPPORTS_RT == TRUE) && !defined(PORT_SIM_VIRTUAL_CLOCK)) || defined(__DOXYGEN__)
+  &oslib_test_011_009,
+#endif
+#if (CH_CFG_USE_OBJ_CACHES == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_011_010,
+#endif
+#if (CH_CFG_USE_JOBS == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_011_011,
+#endif
+#if ((CH_CFG_USE_DELEGATES == TRUE) && defined(__CHIBIOS_RT__)) || defined(__DOXYGEN__)
+  &oslib_test_011_012,
+#endif
+#if ((CH_CFG_USE_FACTORY == TRUE) && (CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE)) || defined(__DOXYGEN__)
+  &oslib_test_011_013,
+#endif
+  NULL
+};
+
+/**
+ * @brief   Benchmarks.
+ */
+const testsequence_t oslib_test_sequence_011 = {
+  "Benchmarks",
+  oslib_test_sequence_011_array
+};
@@ -0,0 +1,336 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <time.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "hostbench.h"
+
+/*
+ * Number of virtual timers and of memory blocks kept in use by the
+ * benchmarks.
+ */
+#define BENCH_TIMERS                    16U
+#define BENCH_BLOCKS                    16U
+
+static THD_WORKING_AREA(waBench, 256);
+static volatile bool bench_stop;
+static virtual_timer_t bench_vts[BENCH_TIMERS];
+static uint32_t bench_fired;
+static uint32_t bench_seed;
+#if (CH_CFG_USE_HEAP == TRUE) || (CH_CFG_USE_MEMPOOLS == TRUE)
+static void *bench_blocks[BENCH_BLOCKS];
+#endif
+#if CH_CFG_USE_SEMAPHORES == TRUE
+static semaphore_t bench_sem;
+#endif
+#if CH_CFG_USE_HEAP == TRUE
+static memory_heap_t bench_heap;
+static CH_HEAP_AREA(bench_heap_buffer, 16384);
+#endif
+#if CH_CFG_USE_MEMPOOLS == TRUE
+static memory_pool_t bench_pool;
+static stkalign_t bench_pool_buffer[BENCH_BLOCKS][4];
+#endif
+
+/*===========================================================================*/
+/* Helpers.                                                                  */
+/*===========================================================================*/
+
+/*
+ * Host monotonic time in nanoseconds, the virtual time of the port is not
+ * related to the host time.
+ */
+static uint64_t bench_ns(void) {
+  struct timespec ts;
+
+  (void) clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ * Pseudo-random sequence, it is restarted by each benchmark so that the
+ * sequence of operations is reproducible.
+ */
+static uint32_t bench_rand(void) {
+
+  bench_seed = (bench_seed * 1103515245U) + 12345U;
+  return bench_seed >> 16;
+}
+
+static void bench_report(const char *name, uint32_t n, uint64_t start) {
+  uint64_t ns = bench_ns() - start;
+
+  if (ns == 0U) {
+    ns = 1U;
+  }
+  printf("--- %-14s %10llu ops/S %8.1f ns/op %10u ops\n", name,
+         (unsigned long long)(((uint64_t)n * 1000000000U) / ns),
+         (double)ns / (double)n, (unsigned)n);
+}
+
+/*===========================================================================*/
+/* Benchmarks.                                                               */
+/*===========================================================================*/
+
+static THD_FUNCTION(bench_yielder, arg) {
+
+  (void)arg;
+
+  while (!bench_stop) {
+    chThdYield();
+  }
+}
+
+/*
+ * Round robin between two threads at the same priority, each operation is
+ * a pair of context switches.
+ */
+static bool bench_yield(uint32_t n) {
+  thread_t *tp;
+  uint64_t start;
+  uint32_t i;
+
+  bench_stop = false;
+  tp = chThdCreateStatic(waBench, sizeof (waBench), chThdGetPriorityX(),
+                         bench_yielder, NULL);
+  start = bench_ns();
+  for (i = 0U; i < n; i++) {
+    chThdYield();
+  }
+  bench_report("Yield", n, start);
+  bench_stop = true;
+  (void) chThdWait(tp);
+
+  return true;
+}
+
+#if CH_CFG_USE_SEMAPHORES == TRUE
+static THD_FUNCTION(bench_waiter, arg) {
+  msg_t msg;
+
+  (void)arg;
+
+  do {
+    msg = chSemWait(&bench_sem);
+  } while (msg == MSG_OK);
+  chThdExit(msg);
+}
+
+/*
+ * Semaphore signaled to a higher priority thread, each operation is a
+ * wakeup, two context switches and a wait.
+ */
+static bool bench_semaphore(uint32_t n) {
+  thread_t *tp;
+  uint64_t start;
+  uint32_t i;
+
+  chSemObjectInit(&bench_sem, (cnt_t)0);
+  tp = chThdCreateStatic(waBench, sizeof (waBench), chThdGetPriorityX() + 1U,
+                         bench_waiter, NULL);
+  start = bench_ns();
+  for (i = 0U; i < n; i++) {
+    chSemSignal(&bench_sem);
+  }
+  bench_report("Semaphore", n, start);
+  chSemReset(&bench_sem, (cnt_t)0);
+
+  return chThdWait(tp) == MSG_RESET;
+}
+#endif /* CH_CFG_USE_SEMAPHORES == TRUE */
+
+static void bench_vt_cb(virtual_timer_t *vtp, void *p) {
+
+  (void)vtp;
+
+  (*(uint32_t *)p)++;
+}
+
+/*
+ * Timers re-armed with pseudo-random delays while the other timers are
+ * armed, each operation is a removal and an insertion in the timers list.
+ */
+static bool bench_timers_set(uint32_t n) {
+  uint64_t start;
+  uint32_t i;
+
+  bench_seed = 1U;
+  bench_fired = 0U;
+  for (i = 0U; i < BENCH_TIMERS; i++) {
+    chVTObjectInit(&bench_vts[i]);
+  }
+  start = bench_ns();
+  for (i = 0U; i < n; i++) {
+    sysinterval_t delay = (sysinterval_t)(1000U + (bench_rand() % 1000U));
+
+    chSysLock();
+    chVTSetI(&bench_vts[i % BENCH_TIMERS], delay, bench_vt_cb, &bench_fired);
+    chSysUnlock();
+  }
+  bench_report("Timers set", n, start);
+  chSysLock();
+  for (i = 0U; i < BENCH_TIMERS; i++) {
+    chVTResetI(&bench_vts[i]);
+  }
+  chSysUnlock();
+
+  return bench_fired == 0U;
+}
+
+/*
+ * Timers armed with consecutive delays then the virtual time is advanced
+ * until all of them expired, each operation is an insertion and a callback
+ * invoked by the system tick.
+ */
+static bool bench_timers_fire(uint32_t n) {
+  uint64_t start;
+  uint32_t i, j;
+
+  n = n - (n % BENCH_TIMERS);
+  bench_fired = 0U;
+  start = bench_ns();
+  for (i = 0U; i < n; i += BENCH_TIMERS) {
+    chSysLock();
+    for (j = 0U; j < BENCH_TIMERS; j++) {
+      chVTSetI(&bench_vts[j], (sysinterval_t)(j + 1U),
+               bench_vt_cb, &bench_fired);
+    }
+    chSysUnlock();
+    _sim_advance_time((sysinterval_t)(BENCH_TIMERS + 1U));
+  }
+  bench_report("Timers fire", n, start);
+
+  return bench_fired == n;
+}
+
+#if CH_CFG_USE_HEAP == TRUE
+/*
+ * Heap allocations of pseudo-random sizes, the oldest one of a set of
+ * live blocks is released before each allocation.
+ */
+static bool bench_heap_alloc(uint32_t n) {
+  uint64_t start;
+  uint32_t i;
+  bool result = true;
+
+  bench_seed = 1U;
+  chHeapObjectInit(&bench_heap, bench_heap_buffer, sizeof (bench_heap_buffer));
+  start = bench_ns();
+  for (i = 0U; i < n; i++) {
+    void **bpp = &bench_blocks[i % BENCH_BLOCKS];
+
+    if (*bpp != NULL) {
+      chHeapFree(*bpp);
+    }
+    *bpp = chHeapAlloc(&bench_heap, (size_t)(8U + (bench_rand() % 120U)));
+    if (*bpp == NULL) {
+      result = false;
+      break;
+    }
+  }
+  bench_report("Heap", n, start);
+  for (i = 0U; i < BENCH_BLOCKS; i++) {
+    if (bench_blocks[i] != NULL) {
+      chHeapFree(bench_blocks[i]);
+      bench_blocks[i] = NULL;
+    }
+  }
+
+  return result;
+}
+
+#endif /* CH_CFG_USE_HEAP == TRUE */
+
+#if CH_CFG_USE_MEMPOOLS == TRUE
+/*
+ * Pool allocations, the oldest one of a set of live objects is released
+ * before each allocation.
+ */
+static bool bench_pool_alloc(uint32_t n) {
+  uint64_t start;
+  uint32_t i;
+  bool result = true;
+
+  chPoolObjectInit(&bench_pool, sizeof (bench_pool_buffer[0]), NULL);
+  chPoolLoadArray(&bench_pool, bench_pool_buffer, BENCH_BLOCKS);
+  start = bench_ns();
+  for (i = 0U; i < n; i++) {
+    void **bpp = &bench_blocks[i % BENCH_BLOCKS];
+
+    if (*bpp != NULL) {
+      chPoolFree(&bench_pool, *bpp);
+    }
+    *bpp = chPoolAlloc(&bench_pool);
+    if (*bpp == NULL) {
+      result = false;
+      break;
+    }
+  }
+  bench_report("Pool", n, start);
+  for (i = 0U; i < BENCH_BLOCKS; i++) {
+    bench_blocks[i] = NULL;
+  }
+
+  return result;
+}
+#endif /* CH_CFG_USE_MEMPOOLS == TRUE */
+
+/*===========================================================================*/
+/* Interface.                                                                */
+/*===========================================================================*/
+
+/*
+ * Runs all the benchmarks, the virtual time at the end only depends on the
+ * number of iterations and is printed as a reproducibility check.
+ */
+bool hostbench_execute(uint32_t n) {
+  bool result = true;
+
+  if (n == 0U) {
+    n = 1U;
+  }
+
+  printf("*** ChibiOS/RT host benchmarks\n");
+  printf("*** Kernel:     %s\n", CH_KERNEL_VERSION);
+  printf("*** Port:       %s %s\n", PORT_ARCHITECTURE_NAME,
+         PORT_CORE_VARIANT_NAME);
+  printf("*** Iterations: %u\n\n", (unsigned)n);
+
+  result = result && bench_yield(n);
+#if CH_CFG_USE_SEMAPHORES == TRUE
+  result = result && bench_semaphore(n);
+#endif
+  result = result && bench_timers_set(n);
+  result = result && bench_timers_fire(n);
+#if CH_CFG_USE_HEAP == TRUE
+  result = result && bench_heap_alloc(n);
+#endif
+#if CH_CFG_USE_MEMPOOLS == TRUE
+  result = result && bench_pool_alloc(n);
+#endif
+
+  printf("\n*** Virtual time: %lu ticks\n",
+         (unsigned long)chVTGetSystemTimeX());
+  if (!result) {
+    printf("*** Benchmark failed\n");
+  }
+  fflush(stdout);
+
+  return result;
+}
@@ -0,0 +1,64 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "rt_test_root.h"
+#include "oslib_test_root.h"
+#include "console.h"
+#include "hostbench.h"
+
+/*
+ * Host main, the test suites are executed unless the "bench" argument is
+ * specified, an optional second argument is the number of iterations of
+ * each benchmark.
+ */
+int main(int argc, char *argv[]) {
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  conInit();
+  chSysInit();
+
+  if ((argc > 1) && (strcmp(argv[1], "bench") == 0)) {
+    uint32_t n = HOSTBENCH_ITERATIONS;
+
+    if (argc > 2) {
+      n = (uint32_t)strtoul(argv[2], NULL, 0);
+    }
+    if (!hostbench_execute(n))
+      exit(1);
+    else
+      exit(0);
+  }
+
+  test_execute((BaseSequentialStream *)&CD1, &rt_test_suite);
+  test_execute((BaseSequentialStream *)&CD1, &oslib_test_suite);
+  if (chtest.global_fail)
+    exit(1);
+  else
+    exit(0);
+}
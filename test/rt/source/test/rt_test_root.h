@@ -36,6 +36,7 @@
 #include "rt_test_sequence_010.h"
 #include "rt_test_sequence_011.h"
 #include "rt_test_sequence_012.h"
+#include "rt_test_sequence_013.h"
 
 #if !defined(__DOXYGEN__)
 
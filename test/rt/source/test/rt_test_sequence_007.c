@@ -42,6 +42,7 @@
  * - @subpage rt_test_007_004
  * - @subpage rt_test_007_005
  * - @subpage rt_test_007_006
+ * - @subpage rt_test_007_007
  * .
  */
 
@@ -83,6 +84,12 @@ static THD_FUNCTION(thread4, p) {
   chBSemSignal((binary_semaphore_t *)p);
 }
 
+static THD_FUNCTION(thread5, p) {
+
+  chThdSleepMilliseconds(50);
+  chFSemSignal((fast_semaphore_t *)p);
+}
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -507,6 +514,122 @@ static const testcase_t rt_test_007_006 = {
   rt_test_007_006_execute
 };
 
+/**
+ * @page rt_test_007_007 [7.7] Testing fast semaphores
+ *
+ * <h2>Description</h2>
+ * This test case tests the fast semaphores, both the uncontended path
+ * not involving the kernel and the contended path are exercised.
+ *
+ * <h2>Test Steps</h2>
+ * - [7.7.1] Initializing a fast semaphore with counter one, a wait
+ *   operation is performed, the counter and the returned message are
+ *   tested.
+ * - [7.7.2] Signaling the fast semaphore, the counter is expected to
+ *   return to one without involving the kernel semaphore.
+ * - [7.7.3] Taking the fast semaphore then testing the special case
+ *   TIME_IMMEDIATE, the counter must not change.
+ * - [7.7.4] Starting a signaler thread at a lower priority then waiting
+ *   on the fast semaphore, the contended path is tested.
+ * - [7.7.5] Testing timeout condition, the thread must be removed from
+ *   the counter after the timeout.
+ * - [7.7.6] Creating a fast binary semaphore in "taken" state then
+ *   signaling it twice, the counter must not grow above one.
+ * .
+ */
+
+static void rt_test_007_007_teardown(void) {
+  test_wait_threads();
+}
+
+static void rt_test_007_007_execute(void) {
+  fast_semaphore_t fsem;
+  fast_binary_semaphore_t fbsem;
+  msg_t msg;
+
+  /* [7.7.1] Initializing a fast semaphore with counter one, a wait
+     operation is performed, the counter and the returned message are
+     tested.*/
+  test_set_step(1);
+  {
+    chFSemObjectInit(&fsem, 1);
+    msg = chFSemWait(&fsem);
+    test_assert(msg == MSG_OK, "wrong returned message");
+    test_assert(chFSemGetCounterX(&fsem) == 0, "wrong counter value");
+  }
+  test_end_step(1);
+
+  /* [7.7.2] Signaling the fast semaphore, the counter is expected to
+     return to one without involving the kernel semaphore.*/
+  test_set_step(2);
+  {
+    chFSemSignal(&fsem);
+    test_assert(chFSemGetCounterX(&fsem) == 1, "wrong counter value");
+    test_assert(ch_queue_isempty(&fsem.sem.queue), "queue not empty");
+    test_assert(fsem.sem.cnt == 0, "kernel counter not zero");
+  }
+  test_end_step(2);
+
+  /* [7.7.3] Taking the fast semaphore then testing the special case
+     TIME_IMMEDIATE, the counter must not change.*/
+  test_set_step(3);
+  {
+    msg = chFSemWait(&fsem);
+    test_assert(msg == MSG_OK, "wrong returned message");
+    msg = chFSemWaitTimeout(&fsem, TIME_IMMEDIATE);
+    test_assert(msg == MSG_TIMEOUT, "wrong returned message");
+    test_assert(chFSemGetCounterX(&fsem) == 0, "wrong counter value");
+  }
+  test_end_step(3);
+
+  /* [7.7.4] Starting a signaler thread at a lower priority then waiting
+     on the fast semaphore, the contended path is tested.*/
+  test_set_step(4);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE,
+                                   chThdGetPriorityX()-1, thread5, &fsem);
+    msg = chFSemWaitTimeout(&fsem, TIME_MS2I(500));
+    test_wait_threads();
+    test_assert(msg == MSG_OK, "wrong wake-up message");
+    test_assert(chFSemGetCounterX(&fsem) == 0, "wrong counter value");
+    test_assert(ch_queue_isempty(&fsem.sem.queue), "queue not empty");
+    test_assert(fsem.sem.cnt == 0, "kernel counter not zero");
+  }
+  test_end_step(4);
+
+  /* [7.7.5] Testing timeout condition, the thread must be removed from
+     the counter after the timeout.*/
+  test_set_step(5);
+  {
+    msg = chFSemWaitTimeout(&fsem, TIME_MS2I(50));
+    test_assert(msg == MSG_TIMEOUT, "wrong wake-up message");
+    test_assert(chFSemGetCounterX(&fsem) == 0, "wrong counter value");
+    test_assert(ch_queue_isempty(&fsem.sem.queue), "queue not empty");
+    test_assert(fsem.sem.cnt == 0, "kernel counter not zero");
+  }
+  test_end_step(5);
+
+  /* [7.7.6] Creating a fast binary semaphore in "taken" state then
+     signaling it twice, the counter must not grow above one.*/
+  test_set_step(6);
+  {
+    chFBSemObjectInit(&fbsem, true);
+    test_assert(chFBSemGetStateX(&fbsem) == true, "not taken");
+    chFBSemSignal(&fbsem);
+    chFBSemSignal(&fbsem);
+    test_assert(chFBSemGetStateX(&fbsem) == false, "still taken");
+    test_assert(chFSemGetCounterX(&fbsem.fsem) == 1, "unexpected counter");
+  }
+  test_end_step(6);
+}
+
+static const testcase_t rt_test_007_007 = {
+  "Testing fast semaphores",
+  NULL,
+  rt_test_007_007_teardown,
+  rt_test_007_007_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -521,6 +644,7 @@ const testcase_t * const rt_test_sequence_007_array[] = {
   &rt_test_007_004,
   &rt_test_007_005,
   &rt_test_007_006,
+  &rt_test_007_007,
   NULL
 };
 
@@ -55,6 +55,7 @@
 
 #if CH_CFG_USE_SEMAPHORES || defined(__DOXYGEN__)
 static semaphore_t sem1;
+static fast_semaphore_t fsem1;
 #endif
 #if CH_CFG_USE_MUTEXES || defined(__DOXYGEN__)
 static mutex_t mtx1;
@@ -194,6 +195,8 @@ static void rt_test_012_001_execute(void) {
     test_print(" msgs/S, ");
     test_printn(n << 1);
     test_println(" ctxswc/S");
+    test_score(n, "msgs/S");
+    test_score(n << 1, "ctxswc/S");
   }
   test_end_step(3);
 }
@@ -258,6 +261,8 @@ static void rt_test_012_002_execute(void) {
     test_print(" msgs/S, ");
     test_printn(n << 1);
     test_println(" ctxswc/S");
+    test_score(n, "msgs/S");
+    test_score(n << 1, "ctxswc/S");
   }
   test_end_step(3);
 }
@@ -336,6 +341,8 @@ static void rt_test_012_003_execute(void) {
     test_print(" msgs/S, ");
     test_printn(n << 1);
     test_println(" ctxswc/S");
+    test_score(n, "msgs/S");
+    test_score(n << 1, "ctxswc/S");
   }
   test_end_step(4);
 }
@@ -419,6 +426,7 @@ static void rt_test_012_004_execute(void) {
     test_print("--- Score : ");
     test_printn(n * 2);
     test_println(" ctxswc/S");
+    test_score(n * 2, "ctxswc/S");
   }
   test_end_step(4);
 }
@@ -477,6 +485,7 @@ static void rt_test_012_005_execute(void) {
     test_print("--- Score : ");
     test_printn(n);
     test_println(" threads/S");
+    test_score(n, "threads/S");
   }
   test_end_step(2);
 }
@@ -540,6 +549,7 @@ static void rt_test_012_006_execute(void) {
     test_print("--- Score : ");
     test_printn(n);
     test_println(" threads/S");
+    test_score(n, "threads/S");
   }
   test_end_step(2);
 }
@@ -632,6 +642,8 @@ static void rt_test_012_007_execute(void) {
     test_print(" reschedules/S, ");
     test_printn(n * 6);
     test_println(" ctxswc/S");
+    test_score(n, "reschedules/S");
+    test_score(n * 6, "ctxswc/S");
   }
   test_end_step(4);
 }
@@ -695,6 +707,7 @@ static void rt_test_012_008_execute(void) {
     test_print("--- Score : ");
     test_printn(n);
     test_println(" ctxswc/S");
+    test_score(n, "ctxswc/S");
   }
   test_end_step(3);
 }
@@ -757,6 +770,7 @@ static void rt_test_012_009_execute(void) {
     test_print("--- Score : ");
     test_printn(n * 2);
     test_println(" timers/S");
+    test_score(n * 2, "timers/S");
   }
   test_end_step(2);
 }
@@ -775,8 +789,10 @@ static const testcase_t rt_test_012_009 = {
  * <h2>Description</h2>
  * A counting semaphore is taken/released into a continuous loop, no
  * Context Switch happens because the counter is always non
- * negative.<br> The performance is calculated by measuring the number
- * of iterations after a second of continuous operations.
+ * negative.<br> The same is done with a fast semaphore, in this case
+ * the kernel is never entered.<br> The performance is calculated by
+ * measuring the number of iterations after a second of continuous
+ * operations.
  *
  * <h2>Conditions</h2>
  * This test is only executed if the following preprocessor condition
@@ -788,11 +804,15 @@ static const testcase_t rt_test_012_009 = {
  * - [12.10.1] A semaphore is teken and released. The operation is
  *   repeated continuously in a one-second time window.
  * - [12.10.2] The score is printed.
+ * - [12.10.3] A fast semaphore is taken and released. The operation is
+ *   repeated continuously in a one-second time window.
+ * - [12.10.4] The score is printed.
  * .
  */
 
 static void rt_test_012_010_setup(void) {
   chSemObjectInit(&sem1, 1);
+  chFSemObjectInit(&fsem1, 1);
 }
 
 static void rt_test_012_010_execute(void) {
@@ -830,8 +850,45 @@ static void rt_test_012_010_execute(void) {
     test_print("--- Score : ");
     test_printn(n * 4);
     test_println(" wait+signal/S");
+    test_score(n * 4, "wait+signal/S");
   }
   test_end_step(2);
+
+  /* [12.10.3] A fast semaphore is taken and released. The operation is
+     repeated continuously in a one-second time window.*/
+  test_set_step(3);
+  {
+    systime_t start, end;
+
+    n = 0;
+    start = test_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      chFSemWait(&fsem1);
+      chFSemSignal(&fsem1);
+      chFSemWait(&fsem1);
+      chFSemSignal(&fsem1);
+      chFSemWait(&fsem1);
+      chFSemSignal(&fsem1);
+      chFSemWait(&fsem1);
+      chFSemSignal(&fsem1);
+      n++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+  }
+  test_end_step(3);
+
+  /* [12.10.4] The score is printed.*/
+  test_set_step(4);
+  {
+    test_print("--- Score : ");
+    test_printn(n * 4);
+    test_println(" fast wait+signal/S");
+    test_score(n * 4, "fast wait+signal/S");
+  }
+  test_end_step(4);
 }
 
 static const testcase_t rt_test_012_010 = {
@@ -904,6 +961,7 @@ static void rt_test_012_011_execute(void) {
     test_print("--- Score : ");
     test_printn(n * 4);
     test_println(" lock+unlock/S");
+    test_score(n * 4, "lock+unlock/S");
   }
   test_end_step(2);
 }
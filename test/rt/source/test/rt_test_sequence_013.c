@@ -0,0 +1,485 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "rt_test_root.h"
+
+/**
+ * @file    rt_test_sequence_013.c
+ * @brief   Test Sequence 013 code.
+ *
+ * @page rt_test_sequence_013 [13] Threads Migration
+ *
+ * File: @ref rt_test_sequence_013.c
+ *
+ * <h2>Description</h2>
+ * This sequence tests the ChibiOS/RT functionalities related to
+ * threads migration between OS instances and load balancing. The
+ * tests are executed by a thread of the first instance, the second
+ * instance must be already running.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MIGRATION == TRUE
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage rt_test_013_001
+ * - @subpage rt_test_013_002
+ * - @subpage rt_test_013_003
+ * - @subpage rt_test_013_004
+ * .
+ */
+
+#if (CH_CFG_USE_MIGRATION == TRUE) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include "ch.h"
+
+#define OIP0 ch_system.instances[0]
+#define OIP1 ch_system.instances[1]
+
+static semaphore_t sem1;
+static volatile bool stop;
+static os_instance_t * volatile owners[3];
+static volatile msg_t result;
+
+static THD_FUNCTION(thread1, p) {
+
+  (void)p;
+  owners[0] = currcore;
+}
+
+static THD_FUNCTION(thread2, p) {
+
+  owners[0] = currcore;
+  result = chThdMigrate(chThdGetSelfX(), (os_instance_t *)p);
+  owners[1] = currcore;
+}
+
+static THD_FUNCTION(thread3, p) {
+
+  (void)p;
+  owners[0] = currcore;
+  if (chSemWaitTimeout(&sem1, TIME_MS2I(1000)) == MSG_OK) {
+    owners[1] = currcore;
+    if (chSemWait(&sem1) == MSG_OK) {
+      owners[2] = currcore;
+    }
+  }
+}
+
+static THD_FUNCTION(thread4, p) {
+
+  (void)p;
+  while (!stop) {
+  }
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page rt_test_013_001 [13.1] Migration of ready threads
+ *
+ * <h2>Description</h2>
+ * A thread is created in the ready list of the first instance and
+ * migrated to the second one where it runs. A thread whose cores mask
+ * excludes the second core cannot be migrated.
+ *
+ * <h2>Test Steps</h2>
+ * - [13.1.1] Creating a thread with lower priority than the current
+ *   one, it stays in the ready list of the first instance.
+ * - [13.1.2] Migrating the thread to the second instance, it must run
+ *   there.
+ * - [13.1.3] Creating a thread restricted to the first core, migration
+ *   to the second instance must fail and the thread must run on the
+ *   first instance.
+ * .
+ */
+
+static void rt_test_013_001_setup(void) {
+  owners[0] = NULL;
+}
+
+static void rt_test_013_001_teardown(void) {
+  test_wait_threads();
+}
+
+static void rt_test_013_001_execute(void) {
+
+  /* [13.1.1] Creating a thread with lower priority than the current
+     one, it stays in the ready list of the first instance.*/
+  test_set_step(1);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX() - 1,
+                                   thread1, NULL);
+    test_assert(threads[0]->state == CH_STATE_READY, "not ready");
+    test_assert(threads[0]->owner == OIP0, "wrong instance");
+  }
+  test_end_step(1);
+
+  /* [13.1.2] Migrating the thread to the second instance, it must run
+     there.*/
+  test_set_step(2);
+  {
+    msg_t msg;
+
+    msg = chThdMigrate(threads[0], OIP1);
+    test_assert(msg == MSG_OK, "migration failed");
+    test_assert(threads[0]->owner == OIP1, "wrong instance");
+    test_wait_threads();
+    test_assert(owners[0] == OIP1, "not run on the second instance");
+  }
+  test_end_step(2);
+
+  /* [13.1.3] Creating a thread restricted to the first core, migration
+     to the second instance must fail and the thread must run on the
+     first instance.*/
+  test_set_step(3);
+  {
+    thread_descriptor_t td = THD_DESCRIPTOR_CORES("test",
+                                                  (stkalign_t *)wa[0],
+                                                  (stkalign_t *)((uint8_t *)wa[0] + WA_SIZE),
+                                                  chThdGetPriorityX() - 1,
+                                                  thread1,
+                                                  NULL,
+                                                  OIP0,
+                                                  THD_CORE(OIP0->core_id));
+    msg_t msg;
+
+    owners[0] = NULL;
+    threads[0] = chThdCreate(&td);
+    msg = chThdMigrate(threads[0], OIP1);
+    test_assert(msg == MSG_RESET, "migration not refused");
+    test_assert(threads[0]->owner == OIP0, "wrong instance");
+    test_wait_threads();
+    test_assert(owners[0] == OIP0, "not run on the first instance");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t rt_test_013_001 = {
+  "Migration of ready threads",
+  rt_test_013_001_setup,
+  rt_test_013_001_teardown,
+  rt_test_013_001_execute
+};
+
+/**
+ * @page rt_test_013_002 [13.2] Migration of the current thread
+ *
+ * <h2>Description</h2>
+ * A thread migrates itself to the second instance, the function
+ * returns when the thread runs on the target core. A thread whose
+ * cores mask excludes the second core cannot migrate itself.
+ *
+ * <h2>Test Steps</h2>
+ * - [13.2.1] Creating a thread with higher priority than the current
+ *   one, it migrates itself to the second instance.
+ * - [13.2.2] Creating a thread restricted to the first core, its
+ *   migration attempt must fail.
+ * .
+ */
+
+static void rt_test_013_002_setup(void) {
+  owners[0] = NULL;
+  owners[1] = NULL;
+  result = MSG_TIMEOUT;
+}
+
+static void rt_test_013_002_teardown(void) {
+  test_wait_threads();
+}
+
+static void rt_test_013_002_execute(void) {
+
+  /* [13.2.1] Creating a thread with higher priority than the current
+     one, it migrates itself to the second instance.*/
+  test_set_step(1);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX() + 1,
+                                   thread2, OIP1);
+    test_wait_threads();
+    test_assert(result == MSG_OK, "migration failed");
+    test_assert(owners[0] == OIP0, "not started on the first instance");
+    test_assert(owners[1] == OIP1, "not resumed on the second instance");
+  }
+  test_end_step(1);
+
+  /* [13.2.2] Creating a thread restricted to the first core, its
+     migration attempt must fail.*/
+  test_set_step(2);
+  {
+    thread_descriptor_t td = THD_DESCRIPTOR_CORES("test",
+                                                  (stkalign_t *)wa[0],
+                                                  (stkalign_t *)((uint8_t *)wa[0] + WA_SIZE),
+                                                  chThdGetPriorityX() + 1,
+                                                  thread2,
+                                                  OIP1,
+                                                  OIP0,
+                                                  THD_CORE(OIP0->core_id));
+
+    owners[0] = NULL;
+    owners[1] = NULL;
+    result = MSG_TIMEOUT;
+    threads[0] = chThdCreate(&td);
+    test_wait_threads();
+    test_assert(result == MSG_RESET, "migration not refused");
+    test_assert(owners[0] == OIP0, "not started on the first instance");
+    test_assert(owners[1] == OIP0, "not resumed on the first instance");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t rt_test_013_002 = {
+  "Migration of the current thread",
+  rt_test_013_002_setup,
+  rt_test_013_002_teardown,
+  rt_test_013_002_execute
+};
+
+/**
+ * @page rt_test_013_003 [13.3] Migration of waiting threads
+ *
+ * <h2>Description</h2>
+ * A thread waiting with a timeout is pinned to its instance because
+ * the timeout timer belongs to it, a thread waiting without a timeout
+ * can be migrated and it is made ready on the target instance when
+ * woken.
+ *
+ * <h2>Test Steps</h2>
+ * - [13.3.1] Creating a thread with higher priority than the current
+ *   one, it starts waiting on a semaphore with a timeout, migration
+ *   must fail.
+ * - [13.3.2] Signaling the semaphore, the thread runs on the first
+ *   instance then waits again without a timeout, migration must
+ *   succeed.
+ * - [13.3.3] Signaling the semaphore, the thread must run on the
+ *   second instance.
+ * .
+ */
+
+static void rt_test_013_003_setup(void) {
+  owners[0] = NULL;
+  owners[1] = NULL;
+  owners[2] = NULL;
+  chSemObjectInit(&sem1, 0);
+}
+
+static void rt_test_013_003_teardown(void) {
+  chSemReset(&sem1, 0);
+  test_wait_threads();
+}
+
+static void rt_test_013_003_execute(void) {
+
+  /* [13.3.1] Creating a thread with higher priority than the current
+     one, it starts waiting on a semaphore with a timeout, migration
+     must fail.*/
+  test_set_step(1);
+  {
+    msg_t msg;
+
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX() + 1,
+                                   thread3, NULL);
+    test_assert(threads[0]->state == CH_STATE_WTSEM, "not waiting");
+    test_assert((threads[0]->flags & CH_FLAG_PINNED) != (tmode_t)0,
+                "not pinned");
+    msg = chThdMigrate(threads[0], OIP1);
+    test_assert(msg == MSG_RESET, "migration not refused");
+    test_assert(threads[0]->owner == OIP0, "wrong instance");
+  }
+  test_end_step(1);
+
+  /* [13.3.2] Signaling the semaphore, the thread runs on the first
+     instance then waits again without a timeout, migration must
+     succeed.*/
+  test_set_step(2);
+  {
+    msg_t msg;
+
+    chSemSignal(&sem1);
+    test_assert(owners[1] == OIP0, "not run on the first instance");
+    test_assert(threads[0]->state == CH_STATE_WTSEM, "not waiting");
+    test_assert((threads[0]->flags & CH_FLAG_PINNED) == (tmode_t)0,
+                "still pinned");
+    msg = chThdMigrate(threads[0], OIP1);
+    test_assert(msg == MSG_OK, "migration failed");
+    test_assert(threads[0]->owner == OIP1, "wrong instance");
+  }
+  test_end_step(2);
+
+  /* [13.3.3] Signaling the semaphore, the thread must run on the
+     second instance.*/
+  test_set_step(3);
+  {
+    chSemSignal(&sem1);
+    test_wait_threads();
+    test_assert(owners[0] == OIP0, "not started on the first instance");
+    test_assert(owners[2] == OIP1, "not run on the second instance");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t rt_test_013_003 = {
+  "Migration of waiting threads",
+  rt_test_013_003_setup,
+  rt_test_013_003_teardown,
+  rt_test_013_003_execute
+};
+
+/**
+ * @page rt_test_013_004 [13.4] Load balancing
+ *
+ * <h2>Description</h2>
+ * The second instance is kept busy by a spinning thread so that
+ * threads migrated there stay in its ready list, four lower priority
+ * threads are ready on the first instance. Each balancing step must
+ * move the lowest priority eligible thread until the loads differ by
+ * less than two threads.
+ *
+ * <h2>Test Steps</h2>
+ * - [13.4.1] Creating a spinning thread on the second instance and
+ *   four threads in the ready list of the first instance, the lowest
+ *   priority one is restricted to the first core. The loads are 5/1.
+ * - [13.4.2] First balancing step, the restricted thread is skipped
+ *   and the next one is moved, the loads are 4/2.
+ * - [13.4.3] Second balancing step, the next thread is moved, the
+ *   loads are 3/3.
+ * - [13.4.4] Further balancing steps must not move threads.
+ * .
+ */
+
+static void rt_test_013_004_setup(void) {
+  stop = false;
+}
+
+static void rt_test_013_004_teardown(void) {
+  stop = true;
+  test_wait_threads();
+}
+
+static void rt_test_013_004_execute(void) {
+
+  /* [13.4.1] Creating a spinning thread on the second instance and
+     four threads in the ready list of the first instance, the lowest
+     priority one is restricted to the first core. The loads are 5/1.*/
+  test_set_step(1);
+  {
+    thread_descriptor_t td1 = THD_DESCRIPTOR_AFFINITY("spin",
+                                                      (stkalign_t *)wa[0],
+                                                      (stkalign_t *)((uint8_t *)wa[0] + WA_SIZE),
+                                                      chThdGetPriorityX(),
+                                                      thread4,
+                                                      NULL,
+                                                      OIP1);
+    thread_descriptor_t td2 = THD_DESCRIPTOR_CORES("test",
+                                                   (stkalign_t *)wa[1],
+                                                   (stkalign_t *)((uint8_t *)wa[1] + WA_SIZE),
+                                                   chThdGetPriorityX() - 4,
+                                                   thread4,
+                                                   NULL,
+                                                   OIP0,
+                                                   THD_CORE(OIP0->core_id));
+    tprio_t prio = chThdGetPriorityX();
+
+    threads[0] = chThdCreate(&td1);
+    threads[1] = chThdCreate(&td2);
+    threads[2] = chThdCreateStatic(wa[2], WA_SIZE, prio - 3, thread4, NULL);
+    threads[3] = chThdCreateStatic(wa[3], WA_SIZE, prio - 2, thread4, NULL);
+    threads[4] = chThdCreateStatic(wa[4], WA_SIZE, prio - 1, thread4, NULL);
+  }
+  test_end_step(1);
+
+  /* [13.4.2] First balancing step, the restricted thread is skipped
+     and the next one is moved, the loads are 4/2.*/
+  test_set_step(2);
+  {
+    chSysLock();
+    chSchBalanceI();
+    chSysUnlock();
+    test_assert(threads[1]->owner == OIP0, "restricted thread moved");
+    test_assert(threads[2]->owner == OIP1, "thread not moved");
+    test_assert(threads[3]->owner == OIP0, "wrong thread moved");
+    test_assert(threads[4]->owner == OIP0, "wrong thread moved");
+  }
+  test_end_step(2);
+
+  /* [13.4.3] Second balancing step, the next thread is moved, the
+     loads are 3/3.*/
+  test_set_step(3);
+  {
+    chSysLock();
+    chSchBalanceI();
+    chSysUnlock();
+    test_assert(threads[1]->owner == OIP0, "restricted thread moved");
+    test_assert(threads[3]->owner == OIP1, "thread not moved");
+    test_assert(threads[4]->owner == OIP0, "wrong thread moved");
+  }
+  test_end_step(3);
+
+  /* [13.4.4] Further balancing steps must not move threads.*/
+  test_set_step(4);
+  {
+    chSysLock();
+    chSchBalanceI();
+    chSchBalanceI();
+    chSysUnlock();
+    test_assert(threads[1]->owner == OIP0, "restricted thread moved");
+    test_assert(threads[2]->owner == OIP1, "thread moved back");
+    test_assert(threads[3]->owner == OIP1, "thread moved back");
+    test_assert(threads[4]->owner == OIP0, "thread moved");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t rt_test_013_004 = {
+  "Load balancing",
+  rt_test_013_004_setup,
+  rt_test_013_004_teardown,
+  rt_test_013_004_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const rt_test_sequence_013_array[] = {
+  &rt_test_013_001,
+  &rt_test_013_002,
+  &rt_test_013_003,
+  &rt_test_013_004,
+  NULL
+};
+
+/**
+ * @brief   Threads Migration.
+ */
+const testsequence_t rt_test_sequence_013 = {
+  "Threads Migration",
+  rt_test_sequence_013_array
+};
+
+#endif /* CH_CFG_USE_MIGRATION == TRUE */
@@ -0,0 +1,34 @@
+#!/bin/bash
+export XOPT XDEFS
+
+XOPT="-O2 -fomit-frame-pointer"
+XDEFS="-DTEST_CFG_DELAY_BETWEEN_TESTS=0 -DTEST_CFG_BENCH_FORMAT=TEST_BENCH_FORMAT_JSON"
+RESULTS="python3 ../../../os/test/tools/bench_results.py"
+
+mkdir reports 2> /dev/null
+
+echo -n "  * Building..."
+make clean > /dev/null
+if ! make > buildlog.txt
+then
+  echo "failed"
+  exit 1
+fi
+echo "OK"
+
+echo -n "  * Benchmarking..."
+./build/ch > benchlog.txt
+echo "OK"
+make clean > /dev/null
+
+if [ -f reports/bench_baseline.txt ]
+then
+  $RESULTS compare reports/bench_baseline.txt benchlog.txt
+  status=$?
+else
+  $RESULTS show benchlog.txt
+  status=0
+fi
+mv -f benchlog.txt reports/bench.txt
+rm buildlog.txt 2> /dev/null
+exit $status
@@ -0,0 +1,65 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    vfs_test_root.h
+ * @brief   Test Suite root structures header.
+ */
+
+#ifndef VFS_TEST_ROOT_H
+#define VFS_TEST_ROOT_H
+
+#include "ch_test.h"
+
+#include "vfs_test_sequence_001.h"
+
+#if !defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+extern const testsuite_t vfs_test_suite;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Shared definitions.                                                       */
+/*===========================================================================*/
+
+#include "vfs.h"
+
+#define TEST_SUITE_NAME "ChibiOS/VFS Test Suite"
+
+/*
+ * Stack size of the test threads.
+ */
+#if !defined(VFS_TEST_STACK_SIZE)
+  #if defined(PORT__ARCHITECTURE_SIMIA32)
+    #define VFS_TEST_STACK_SIZE     512
+  #else
+    #define VFS_TEST_STACK_SIZE     256
+  #endif
+#endif
+
+#endif /* !defined(__DOXYGEN__) */
+
+#endif /* VFS_TEST_ROOT_H */
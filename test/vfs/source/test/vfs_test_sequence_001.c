@@ -0,0 +1,551 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "vfs_test_root.h"
+
+/**
+ * @file    vfs_test_sequence_001.c
+ * @brief   Test Sequence 001 code.
+ *
+ * @page vfs_test_sequence_001 [1] Streams driver pipe nodes
+ *
+ * File: @ref vfs_test_sequence_001.c
+ *
+ * <h2>Description</h2>
+ * This sequence tests the pipe nodes of the streams driver, a pipe is
+ * exposed as the "/pipe" file and accessed through VFS file nodes.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - DRV_CFG_STREAMS_PIPE_NODES_NUM >= 2
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage vfs_test_001_001
+ * - @subpage vfs_test_001_002
+ * - @subpage vfs_test_001_003
+ * - @subpage vfs_test_001_004
+ * - @subpage vfs_test_001_005
+ * .
+ */
+
+#if (DRV_CFG_STREAMS_PIPE_NODES_NUM >= 2) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include <string.h>
+
+#define PIPE_SIZE 64
+
+static uint8_t pipe_buffer[PIPE_SIZE];
+static pipe_t pipe1;
+static const drv_streams_element_t streams[] = {
+  {"pipe", NULL, &pipe1},
+  {NULL, NULL, NULL}
+};
+static vfs_streams_driver_c drv;
+static vfs_file_node_c *rdfnp, *wrfnp;
+static uint8_t wrbuf[PIPE_SIZE * 2], rdbuf[PIPE_SIZE * 2];
+
+static THD_WORKING_AREA(wa_peer, VFS_TEST_STACK_SIZE);
+static vfs_file_node_c *peer_fnp;
+static uint8_t *peer_buf;
+static size_t peer_n;
+static ssize_t peer_result;
+
+static THD_FUNCTION(reader_thread, arg) {
+
+  (void)arg;
+
+  peer_result = vfsReadFile(peer_fnp, peer_buf, peer_n);
+}
+
+static THD_FUNCTION(writer_thread, arg) {
+
+  (void)arg;
+
+  peer_result = vfsWriteFile(peer_fnp, peer_buf, peer_n);
+}
+
+/* The peer thread has a priority higher than the test thread so it runs
+   until it blocks on the pipe.*/
+static thread_t *start_peer(tfunc_t func, vfs_file_node_c *fnp,
+                            uint8_t *buf, size_t n) {
+
+  peer_fnp    = fnp;
+  peer_buf    = buf;
+  peer_n      = n;
+  peer_result = (ssize_t)-1;
+
+  return chThdCreateStatic(wa_peer, sizeof (wa_peer),
+                           chThdGetPriorityX() + 1, func, NULL);
+}
+
+static msg_t open_pipe(int flags, vfs_file_node_c **vfnpp) {
+
+  return vfsDrvOpenFile((vfs_driver_c *)&drv, "/pipe", flags, vfnpp);
+}
+
+static void close_pipes(void) {
+
+  if (rdfnp != NULL) {
+    vfsClose((vfs_node_c *)rdfnp);
+    rdfnp = NULL;
+  }
+  if (wrfnp != NULL) {
+    vfsClose((vfs_node_c *)wrfnp);
+    wrfnp = NULL;
+  }
+}
+
+static void pipes_setup(void) {
+  unsigned i;
+
+  for (i = 0U; i < sizeof (wrbuf); i++) {
+    wrbuf[i] = (uint8_t)(i * 7U + 1U);
+  }
+  memset(rdbuf, 0, sizeof (rdbuf));
+  chPipeObjectInit(&pipe1, pipe_buffer, sizeof (pipe_buffer));
+  (void) stmdrvObjectInit(&drv, &streams[0]);
+  rdfnp = NULL;
+  wrfnp = NULL;
+}
+
+static void pipes_open(int flags) {
+
+  (void) open_pipe(VO_RDONLY | flags, &rdfnp);
+  (void) open_pipe(VO_WRONLY | flags, &wrfnp);
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page vfs_test_001_001 [1.1] Opening and closing pipe nodes
+ *
+ * <h2>Description</h2>
+ * Pipe nodes are opened and closed, the node type, the operations not
+ * allowed on pipes and the reuse of the preallocated nodes are tested.
+ *
+ * <h2>Test Steps</h2>
+ * - [1.1.1] Opening a reader and a writer node, the nodes must be FIFO
+ *   nodes with an empty pipe.
+ * - [1.1.2] Seeking and accessing the nodes against their open mode,
+ *   all operations must fail.
+ * - [1.1.3] Opening all the preallocated nodes, the opens must not
+ *   allocate core memory.
+ * - [1.1.4] Closing all the nodes and opening a node again, the last
+ *   closed node must be reused.
+ * .
+ */
+
+static void vfs_test_001_001_setup(void) {
+  pipes_setup();
+}
+
+static void vfs_test_001_001_teardown(void) {
+  close_pipes();
+}
+
+static void vfs_test_001_001_execute(void) {
+  vfs_file_node_c *fnps[DRV_CFG_STREAMS_PIPE_NODES_NUM];
+  vfs_file_node_c *fnp;
+  vfs_stat_t stat;
+  memory_area_t core1, core2;
+  unsigned i;
+  msg_t ret;
+
+  /* [1.1.1] Opening a reader and a writer node, the nodes must be FIFO
+     nodes with an empty pipe.*/
+  test_set_step(1);
+  {
+    ret = open_pipe(VO_RDONLY, &rdfnp);
+    test_assert(ret == CH_RET_SUCCESS, "open failed");
+    ret = open_pipe(VO_WRONLY, &wrfnp);
+    test_assert(ret == CH_RET_SUCCESS, "open failed");
+
+    ret = vfsGetNodeStat((vfs_node_c *)rdfnp, &stat);
+    test_assert(ret == CH_RET_SUCCESS, "stat failed");
+    test_assert((stat.mode & VFS_MODE_S_IFMT) == VFS_MODE_S_IFIFO,
+                "not a FIFO");
+    test_assert(stat.size == (vfs_offset_t)0, "pipe not empty");
+  }
+  test_end_step(1);
+
+  /* [1.1.2] Seeking and accessing the nodes against their open mode,
+     all operations must fail.*/
+  test_set_step(2);
+  {
+    ret = vfsSetFilePosition(rdfnp, (vfs_offset_t)0, VFS_SEEK_SET);
+    test_assert(ret == CH_RET_ESPIPE, "seek allowed");
+    test_assert(vfsReadFile(wrfnp, rdbuf, 1U) == CH_RET_EBADF,
+                "read from a write-only node");
+    test_assert(vfsWriteFile(rdfnp, wrbuf, 1U) == CH_RET_EBADF,
+                "write to a read-only node");
+  }
+  test_end_step(2);
+
+  /* [1.1.3] Opening all the preallocated nodes, the opens must not
+     allocate core memory.*/
+  test_set_step(3);
+  {
+    close_pipes();
+    chCoreGetStatusX(&core1);
+    for (i = 0U; i < DRV_CFG_STREAMS_PIPE_NODES_NUM; i++) {
+      ret = open_pipe(VO_RDWR, &fnps[i]);
+      test_assert(ret == CH_RET_SUCCESS, "open failed");
+    }
+    chCoreGetStatusX(&core2);
+    test_assert(core2.size == core1.size, "core memory allocated");
+  }
+  test_end_step(3);
+
+  /* [1.1.4] Closing all the nodes and opening a node again, the last
+     closed node must be reused.*/
+  test_set_step(4);
+  {
+    for (i = 0U; i < DRV_CFG_STREAMS_PIPE_NODES_NUM; i++) {
+      vfsClose((vfs_node_c *)fnps[i]);
+    }
+    ret = open_pipe(VO_RDWR, &fnp);
+    test_assert(ret == CH_RET_SUCCESS, "open failed");
+    test_assert(fnp == fnps[DRV_CFG_STREAMS_PIPE_NODES_NUM - 1],
+                "node not returned to the pool");
+    vfsClose((vfs_node_c *)fnp);
+  }
+  test_end_step(4);
+}
+
+static const testcase_t vfs_test_001_001 = {
+  "Opening and closing pipe nodes",
+  vfs_test_001_001_setup,
+  vfs_test_001_001_teardown,
+  vfs_test_001_001_execute
+};
+
+/**
+ * @page vfs_test_001_002 [1.2] Reading and writing
+ *
+ * <h2>Description</h2>
+ * Data is written and read back through two nodes on the same pipe,
+ * reads must return the available data without waiting for more.
+ *
+ * <h2>Test Steps</h2>
+ * - [1.2.1] Writing part of the pipe size, all data must be written
+ *   and reported by the node status.
+ * - [1.2.2] Reading more than the available data, only the available
+ *   data must be returned.
+ * .
+ */
+
+static void vfs_test_001_002_setup(void) {
+  pipes_setup();
+  pipes_open(0);
+}
+
+static void vfs_test_001_002_teardown(void) {
+  close_pipes();
+}
+
+static void vfs_test_001_002_execute(void) {
+  vfs_stat_t stat;
+
+  /* [1.2.1] Writing part of the pipe size, all data must be written
+     and reported by the node status.*/
+  test_set_step(1);
+  {
+    test_assert(vfsWriteFile(wrfnp, wrbuf, 48U) == 48, "write failed");
+    (void) vfsGetNodeStat((vfs_node_c *)rdfnp, &stat);
+    test_assert(stat.size == (vfs_offset_t)48, "wrong pipe size");
+  }
+  test_end_step(1);
+
+  /* [1.2.2] Reading more than the available data, only the available
+     data must be returned.*/
+  test_set_step(2);
+  {
+    test_assert(vfsReadFile(rdfnp, rdbuf, PIPE_SIZE) == 48, "read failed");
+    test_assert(memcmp(rdbuf, wrbuf, 48U) == 0, "data mismatch");
+    (void) vfsGetNodeStat((vfs_node_c *)rdfnp, &stat);
+    test_assert(stat.size == (vfs_offset_t)0, "pipe not empty");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t vfs_test_001_002 = {
+  "Reading and writing",
+  vfs_test_001_002_setup,
+  vfs_test_001_002_teardown,
+  vfs_test_001_002_execute
+};
+
+/**
+ * @page vfs_test_001_003 [1.3] Non-blocking operations
+ *
+ * <h2>Description</h2>
+ * Nodes opened with @p VO_NONBLOCK must transfer only what fits in the
+ * pipe and fail with @p CH_RET_EAGAIN instead of waiting.
+ *
+ * <h2>Test Steps</h2>
+ * - [1.3.1] Reading from the empty pipe, the read must fail.
+ * - [1.3.2] Writing more than the pipe size, only the free space must
+ *   be written, then writing to the full pipe must fail.
+ * - [1.3.3] Reading the pipe content back.
+ * .
+ */
+
+static void vfs_test_001_003_setup(void) {
+  pipes_setup();
+  pipes_open(VO_NONBLOCK);
+}
+
+static void vfs_test_001_003_teardown(void) {
+  close_pipes();
+}
+
+static void vfs_test_001_003_execute(void) {
+
+  /* [1.3.1] Reading from the empty pipe, the read must fail.*/
+  test_set_step(1);
+  {
+    test_assert(vfsReadFile(rdfnp, rdbuf, 1U) == CH_RET_EAGAIN,
+                "read from empty pipe");
+  }
+  test_end_step(1);
+
+  /* [1.3.2] Writing more than the pipe size, only the free space must
+     be written, then writing to the full pipe must fail.*/
+  test_set_step(2);
+  {
+    test_assert(vfsWriteFile(wrfnp, wrbuf, PIPE_SIZE + 16U) == PIPE_SIZE,
+                "wrong write size");
+    test_assert(vfsWriteFile(wrfnp, wrbuf, 1U) == CH_RET_EAGAIN,
+                "write to full pipe");
+  }
+  test_end_step(2);
+
+  /* [1.3.3] Reading the pipe content back.*/
+  test_set_step(3);
+  {
+    test_assert(vfsReadFile(rdfnp, rdbuf, sizeof (rdbuf)) == PIPE_SIZE,
+                "wrong read size");
+    test_assert(memcmp(rdbuf, wrbuf, PIPE_SIZE) == 0, "data mismatch");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t vfs_test_001_003 = {
+  "Non-blocking operations",
+  vfs_test_001_003_setup,
+  vfs_test_001_003_teardown,
+  vfs_test_001_003_execute
+};
+
+/**
+ * @page vfs_test_001_004 [1.4] Blocking operations
+ *
+ * <h2>Description</h2>
+ * A peer thread blocks reading from an empty pipe and writing to a full
+ * pipe, the operations on the other node must resume it.
+ *
+ * <h2>Test Steps</h2>
+ * - [1.4.1] A reader blocks on the empty pipe, writing must resume it
+ *   with the written data.
+ * - [1.4.2] A writer blocks on the full pipe, reading must resume it
+ *   until all data has been transferred.
+ * .
+ */
+
+static void vfs_test_001_004_setup(void) {
+  pipes_setup();
+  pipes_open(0);
+}
+
+static void vfs_test_001_004_teardown(void) {
+  close_pipes();
+}
+
+static void vfs_test_001_004_execute(void) {
+  thread_t *tp;
+  size_t n;
+  ssize_t ret;
+
+  /* [1.4.1] A reader blocks on the empty pipe, writing must resume it
+     with the written data.*/
+  test_set_step(1);
+  {
+    tp = start_peer(reader_thread, rdfnp, rdbuf, PIPE_SIZE);
+    test_assert(!chThdTerminatedX(tp), "reader not blocked");
+
+    test_assert(vfsWriteFile(wrfnp, wrbuf, 16U) == 16, "write failed");
+    (void) chThdWait(tp);
+    test_assert(peer_result == 16, "wrong read size");
+    test_assert(memcmp(rdbuf, wrbuf, 16U) == 0, "data mismatch");
+  }
+  test_end_step(1);
+
+  /* [1.4.2] A writer blocks on the full pipe, reading must resume it
+     until all data has been transferred.*/
+  test_set_step(2);
+  {
+    tp = start_peer(writer_thread, wrfnp, wrbuf, sizeof (wrbuf));
+    test_assert(!chThdTerminatedX(tp), "writer not blocked");
+    test_assert(chPipeGetUsedCount(&pipe1) == PIPE_SIZE, "pipe not full");
+
+    n = 0U;
+    while (n < sizeof (rdbuf)) {
+      ret = vfsReadFile(rdfnp, &rdbuf[n], sizeof (rdbuf) - n);
+      test_assert(ret > 0, "read failed");
+      n += (size_t)ret;
+    }
+    (void) chThdWait(tp);
+    test_assert(peer_result == (ssize_t)sizeof (wrbuf), "wrong write size");
+    test_assert(memcmp(rdbuf, wrbuf, sizeof (wrbuf)) == 0, "data mismatch");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t vfs_test_001_004 = {
+  "Blocking operations",
+  vfs_test_001_004_setup,
+  vfs_test_001_004_teardown,
+  vfs_test_001_004_execute
+};
+
+/**
+ * @page vfs_test_001_005 [1.5] Closing with a peer
+ *
+ * <h2>Description</h2>
+ * Closing a node does not affect the pipe or the other nodes, data
+ * written before closing must still be readable and a blocked reader
+ * must stay blocked until the pipe is reset, which is the end of stream
+ * condition.
+ *
+ * <h2>Test Steps</h2>
+ * - [1.5.1] Writing then closing the writer, the data must still be
+ *   readable by the peer.
+ * - [1.5.2] A reader blocks on the empty pipe, opening and closing a
+ *   writer must not resume it.
+ * - [1.5.3] Resetting the pipe, the blocked reader must be resumed with
+ *   zero bytes and writes must transfer nothing.
+ * - [1.5.4] Resuming the pipe, the reader node must work again.
+ * .
+ */
+
+static void vfs_test_001_005_setup(void) {
+  pipes_setup();
+  pipes_open(0);
+}
+
+static void vfs_test_001_005_teardown(void) {
+  chPipeResume(&pipe1);
+  close_pipes();
+}
+
+static void vfs_test_001_005_execute(void) {
+  thread_t *tp;
+  msg_t ret;
+
+  /* [1.5.1] Writing then closing the writer, the data must still be
+     readable by the peer.*/
+  test_set_step(1);
+  {
+    test_assert(vfsWriteFile(wrfnp, wrbuf, 16U) == 16, "write failed");
+    vfsClose((vfs_node_c *)wrfnp);
+    wrfnp = NULL;
+
+    test_assert(vfsReadFile(rdfnp, rdbuf, PIPE_SIZE) == 16, "read failed");
+    test_assert(memcmp(rdbuf, wrbuf, 16U) == 0, "data mismatch");
+  }
+  test_end_step(1);
+
+  /* [1.5.2] A reader blocks on the empty pipe, opening and closing a
+     writer must not resume it.*/
+  test_set_step(2);
+  {
+    tp = start_peer(reader_thread, rdfnp, rdbuf, PIPE_SIZE);
+    test_assert(!chThdTerminatedX(tp), "reader not blocked");
+
+    ret = open_pipe(VO_WRONLY, &wrfnp);
+    test_assert(ret == CH_RET_SUCCESS, "open failed");
+    vfsClose((vfs_node_c *)wrfnp);
+    wrfnp = NULL;
+    test_assert(!chThdTerminatedX(tp), "reader resumed");
+  }
+  test_end_step(2);
+
+  /* [1.5.3] Resetting the pipe, the blocked reader must be resumed with
+     zero bytes and writes must transfer nothing.*/
+  test_set_step(3);
+  {
+    chPipeReset(&pipe1);
+    (void) chThdWait(tp);
+    test_assert(peer_result == 0, "reader not at end of stream");
+
+    ret = open_pipe(VO_WRONLY, &wrfnp);
+    test_assert(ret == CH_RET_SUCCESS, "open failed");
+    test_assert(vfsWriteFile(wrfnp, wrbuf, 16U) == 0, "write in reset state");
+  }
+  test_end_step(3);
+
+  /* [1.5.4] Resuming the pipe, the reader node must work again.*/
+  test_set_step(4);
+  {
+    chPipeResume(&pipe1);
+    test_assert(vfsWriteFile(wrfnp, wrbuf, 8U) == 8, "write failed");
+    test_assert(vfsReadFile(rdfnp, rdbuf, PIPE_SIZE) == 8, "read failed");
+    test_assert(memcmp(rdbuf, wrbuf, 8U) == 0, "data mismatch");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t vfs_test_001_005 = {
+  "Closing with a peer",
+  vfs_test_001_005_setup,
+  vfs_test_001_005_teardown,
+  vfs_test_001_005_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const vfs_test_sequence_001_array[] = {
+  &vfs_test_001_001,
+  &vfs_test_001_002,
+  &vfs_test_001_003,
+  &vfs_test_001_004,
+  &vfs_test_001_005,
+  NULL
+};
+
+/**
+ * @brief   Streams driver pipe nodes.
+ */
+const testsequence_t vfs_test_sequence_001 = {
+  "Streams driver pipe nodes",
+  vfs_test_sequence_001_array
+};
+
+#endif /* DRV_CFG_STREAMS_PIPE_NODES_NUM >= 2 */
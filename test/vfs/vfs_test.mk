@@ -0,0 +1,6 @@
+# List of all the ChibiOS/VFS test files.
+TESTSRC += ${CHIBIOS}/test/vfs/source/test/vfs_test_root.c \
+           ${CHIBIOS}/test/vfs/source/test/vfs_test_sequence_001.c
+
+# Required include directories
+TESTINC += ${CHIBIOS}/test/vfs/source/test